@@ -685,29 +685,14 @@ zfindex ZFJsonItem::jsonItemCount(void) const
     return (zfindex)d->jsonItemMap.size();
 }
 
-static void _ZFP_ZFJsonItem_iteratorDeleteCallback(void *data)
-{
-    zfdelete(ZFCastStatic(zfstlsize *, data));
-}
-static void *_ZFP_ZFJsonItem_iteratorCopyCallback(void *data)
-{
-    return zfnew(zfstlsize,
-        *ZFCastStatic(zfstlsize *, data));
-}
 zfiterator ZFJsonItem::jsonItemIterator(void) const
 {
-    return zfiterator(
-        zfnew(zfstlsize, 0),
-        _ZFP_ZFJsonItem_iteratorDeleteCallback,
-        _ZFP_ZFJsonItem_iteratorCopyCallback);
+    return zfiterator::iteratorCreate((zfstlsize)0);
 }
 
 zfiterator ZFJsonItem::jsonItemIteratorForKey(ZF_IN const zfchar *key) const
 {
-    return zfiterator(
-        zfnew(zfstlsize, d->jsonItemIndex(key)),
-        _ZFP_ZFJsonItem_iteratorDeleteCallback,
-        _ZFP_ZFJsonItem_iteratorCopyCallback);
+    return zfiterator::iteratorCreate(d->jsonItemIndex(key));
 }
 
 zfbool ZFJsonItem::jsonItemIteratorIsValid(ZF_IN const zfiterator &it) const
@@ -43,7 +43,9 @@
 #include "ZFCore/ZFStyleLoad.h"
 #include "ZFCore/ZFThread.h"
 #include "ZFCore/ZFThread_execute.h"
+#include "ZFCore/ZFThread_future.h"
 #include "ZFCore/ZFThread_observerNotifyInMainThread.h"
+#include "ZFCore/ZFThread_parallel.h"
 #include "ZFCore/ZFThread_taskRequest.h"
 #include "ZFCore/ZFThread_zfautoRelease.h"
 #include "ZFCore/ZFTime.h"
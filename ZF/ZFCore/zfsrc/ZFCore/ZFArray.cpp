@@ -1,5 +1,6 @@
 #include "ZFArray.h"
-#include "ZFSTLWrapper/zfstl_deque.h"
+#include "ZFSTLWrapper/zfstl_vector.h"
+#include <algorithm>
 
 ZF_NAMESPACE_GLOBAL_BEGIN
 
@@ -8,7 +9,56 @@ ZF_NAMESPACE_GLOBAL_BEGIN
 zfclassNotPOD _ZFP_ZFArrayPrivate
 {
 public:
-    zfstldeque<ZFObject *> data;
+    zfstlvector<ZFObject *> data;
+
+public:
+    /*
+     * remove all matched elements in one pass,
+     * removed elements are stored to removed in original order
+     */
+    void removeMatched(ZF_OUT zfstlvector<ZFObject *> &removed,
+                       ZF_IN ZFObject *obj,
+                       ZF_IN ZFComparer<ZFObject *>::Comparer comparer)
+    {
+        zfstlsize dst = 0;
+        for(zfstlsize src = 0; src < this->data.size(); ++src)
+        {
+            ZFObject *element = this->data[src];
+            if(comparer(element, obj) == ZFCompareTheSame)
+            {
+                removed.push_back(element);
+            }
+            else
+            {
+                this->data[dst++] = element;
+            }
+        }
+        this->data.resize(dst);
+    }
+};
+
+static ZFCompareResult _ZFP_ZFArray_objectCompare(ZF_IN ZFObject * const &v0, ZF_IN ZFObject * const &v1)
+{
+    return v0->objectCompare(v1);
+}
+
+zfclassNotPOD _ZFP_ZFArraySortComparer
+{
+public:
+    ZFComparer<ZFObject *>::Comparer comparer;
+    ZFCompareResult token;
+
+public:
+    _ZFP_ZFArraySortComparer(ZF_IN ZFComparer<ZFObject *>::Comparer comparer,
+                             ZF_IN zfbool ascending)
+    : comparer(comparer)
+    , token(ascending ? ZFCompareSmaller : ZFCompareGreater)
+    {
+    }
+    inline zfbool operator () (ZF_IN ZFObject *v0, ZF_IN ZFObject *v1) const
+    {
+        return (this->comparer(v0, v1) == this->token);
+    }
 };
 
 // ============================================================
@@ -41,6 +91,19 @@ ZFMETHOD_DEFINE_0(ZFArray, zfbool, isEmpty)
 {
     return d->data.empty();
 }
+ZFMETHOD_DEFINE_1(ZFArray, void, capacity,
+                  ZFMP_IN(zfindex, newCapacity))
+{
+    d->data.reserve((zfstlsize)newCapacity);
+}
+ZFMETHOD_DEFINE_0(ZFArray, zfindex, capacity)
+{
+    return (zfindex)(d->data.capacity());
+}
+ZFObject * const *ZFArray::arrayBuf(void)
+{
+    return (d->data.empty() ? zfnull : &(d->data[0]));
+}
 ZFMETHOD_DEFINE_1(ZFArray, ZFObject *, get, ZFMP_IN(zfindex, index))
 {
     if(index >= d->data.size())
@@ -131,21 +194,10 @@ void ZFArray::addFrom(ZF_IN ZFContainer *another)
     {
         return ;
     }
-    if(this == another)
+    ZFArray *anotherArray = ZFCastZFObject(ZFArray *, another);
+    if(anotherArray != zfnull)
     {
-        zfstldeque<ZFObject *> tmp = d->data;
-        ZFObject *obj = zfnull;
-        for(zfstldeque<ZFObject *>::const_iterator it = tmp.begin(); it != tmp.end(); ++it)
-        {
-            obj = *it;
-            zfRetain(obj);
-            d->data.push_back(obj);
-            this->contentOnAdd(obj);
-        }
-        if(obj != zfnull)
-        {
-            this->contentOnChange();
-        }
+        this->addFromRange(anotherArray, 0);
     }
     else
     {
@@ -163,6 +215,37 @@ void ZFArray::addFrom(ZF_IN ZFContainer *another)
         }
     }
 }
+void ZFArray::addFromRange(ZF_IN ZFArray *another,
+                           ZF_IN zfindex start,
+                           ZF_IN_OPT zfindex count /* = zfindexMax() */)
+{
+    if(another == zfnull || start >= another->count())
+    {
+        return ;
+    }
+    if(count > another->count() - start)
+    {
+        count = another->count() - start;
+    }
+    if(count == 0)
+    {
+        return ;
+    }
+    // reserve first, so that adding from self won't reallocate while copying
+    d->data.reserve(d->data.size() + (zfstlsize)count);
+    const zfstlvector<ZFObject *> &src = another->d->data;
+    for(zfindex i = start, iEnd = start + count; i < iEnd; ++i)
+    {
+        ZFObject *obj = src[i];
+        zfRetain(obj);
+        d->data.push_back(obj);
+    }
+    for(zfindex i = d->data.size() - count; i < d->data.size(); ++i)
+    {
+        this->contentOnAdd(d->data[i]);
+    }
+    this->contentOnChange();
+}
 
 void ZFArray::set(ZF_IN zfindex index,
                   ZF_IN ZFObject *obj)
@@ -184,23 +267,7 @@ zfbool ZFArray::removeElement(ZF_IN ZFObject *obj)
 {
     if(obj)
     {
-        for(zfstldeque<ZFObject *>::iterator it = d->data.begin(); it != d->data.end(); )
-        {
-            if((*it)->objectCompare(obj) == ZFCompareTheSame)
-            {
-                ZFObject *toRelease = *it;
-                it = d->data.erase(it);
-                zfRelease(toRelease);
-
-                this->contentOnRemove(toRelease);
-                this->contentOnChange();
-                return zftrue;
-            }
-            else
-            {
-                ++it;
-            }
-        }
+        return zfself::removeElement(obj, _ZFP_ZFArray_objectCompare);
     }
     return zffalse;
 }
@@ -208,22 +275,18 @@ zfbool ZFArray::removeElement(ZF_IN ZFObject *obj, ZF_IN ZFComparer<ZFObject *>:
 {
     if(obj && comparer)
     {
-        for(zfstldeque<ZFObject *>::iterator it = d->data.begin(); it != d->data.end(); )
+        for(zfstlsize i = 0; i < d->data.size(); ++i)
         {
-            if(comparer(*it, obj) == ZFCompareTheSame)
+            if(comparer(d->data[i], obj) == ZFCompareTheSame)
             {
-                ZFObject *toRelease = *it;
-                it = d->data.erase(it);
+                ZFObject *toRelease = d->data[i];
+                d->data.erase(d->data.begin() + i);
                 zfRelease(toRelease);
 
                 this->contentOnRemove(toRelease);
                 this->contentOnChange();
                 return zftrue;
             }
-            else
-            {
-                ++it;
-            }
         }
     }
     return zffalse;
@@ -232,19 +295,7 @@ zfbool ZFArray::removeElementRevsersely(ZF_IN ZFObject *obj)
 {
     if(obj)
     {
-        for(zfstlsize i = d->data.size() - 1; i != (zfstlsize)-1; --i)
-        {
-            if(d->data[i]->objectCompare(obj) == ZFCompareTheSame)
-            {
-                ZFObject *toRelease = d->data[i];
-                d->data.erase(d->data.begin() + i);
-                zfRelease(toRelease);
-
-                this->contentOnRemove(toRelease);
-                this->contentOnChange();
-                return zftrue;
-            }
-        }
+        return zfself::removeElementRevsersely(obj, _ZFP_ZFArray_objectCompare);
     }
     return zffalse;
 }
@@ -270,59 +321,33 @@ zfbool ZFArray::removeElementRevsersely(ZF_IN ZFObject *obj, ZF_IN ZFComparer<ZF
 }
 zfindex ZFArray::removeElementAll(ZF_IN ZFObject *obj)
 {
-    zfindex removedCount = 0;
     if(obj)
     {
-        for(zfstldeque<ZFObject *>::iterator it = d->data.begin(); it != d->data.end(); )
-        {
-            if((*it)->objectCompare(obj) == ZFCompareTheSame)
-            {
-                ++removedCount;
-                ZFObject *toRelease = *it;
-                it = d->data.erase(it);
-                zfRelease(toRelease);
-
-                this->contentOnRemove(toRelease);
-            }
-            else
-            {
-                ++it;
-            }
-        }
-    }
-    if(removedCount > 0)
-    {
-        this->contentOnChange();
+        return zfself::removeElementAll(obj, _ZFP_ZFArray_objectCompare);
     }
-    return removedCount;
+    return 0;
 }
 zfindex ZFArray::removeElementAll(ZF_IN ZFObject *obj, ZF_IN ZFComparer<ZFObject *>::Comparer comparer)
 {
-    zfindex removedCount = 0;
-    if(obj && comparer)
+    if(obj == zfnull || comparer == zfnull)
     {
-        for(zfstldeque<ZFObject *>::iterator it = d->data.begin(); it != d->data.end(); )
-        {
-            if(comparer(*it, obj) == ZFCompareTheSame)
-            {
-                ++removedCount;
-                ZFObject *toRelease = *it;
-                it = d->data.erase(it);
-                zfRelease(toRelease);
-
-                this->contentOnRemove(toRelease);
-            }
-            else
-            {
-                ++it;
-            }
-        }
+        return 0;
     }
-    if(removedCount > 0)
+    zfstlvector<ZFObject *> removed;
+    d->removeMatched(removed, obj, comparer);
+    if(!removed.empty())
     {
+        for(zfstlsize i = 0; i < removed.size(); ++i)
+        {
+            this->contentOnRemove(removed[i]);
+        }
         this->contentOnChange();
+        for(zfstlsize i = 0; i < removed.size(); ++i)
+        {
+            zfRelease(removed[i]);
+        }
     }
-    return removedCount;
+    return (zfindex)removed.size();
 }
 
 void ZFArray::remove(ZF_IN zfindex index,
@@ -343,14 +368,14 @@ void ZFArray::remove(ZF_IN zfindex index,
         {
             count = this->count() - index;
         }
-        zfstldeque<ZFObject *> tmp(
+        zfstlvector<ZFObject *> tmp(
             d->data.begin() + index,
             d->data.begin() + (index + count));
         d->data.erase(d->data.begin() + index, d->data.begin() + (index + count));
-        for(zfstldeque<ZFObject *>::iterator it = tmp.begin(); it != tmp.end(); ++it)
+        for(zfstlsize i = 0; i < tmp.size(); ++i)
         {
-            this->contentOnRemove(*it);
-            zfRelease(*it);
+            this->contentOnRemove(tmp[i]);
+            zfRelease(tmp[i]);
         }
 
         if(!tmp.empty())
@@ -364,7 +389,7 @@ void ZFArray::removeFirst(void)
     if(!d->data.empty())
     {
         ZFObject *tmp = d->data[0];
-        d->data.pop_front();
+        d->data.erase(d->data.begin());
         zfRelease(tmp);
 
         this->contentOnRemove(tmp);
@@ -387,15 +412,15 @@ void ZFArray::removeAll(void)
 {
     if(!d->data.empty())
     {
-        zfstldeque<ZFObject *> tmp;
+        zfstlvector<ZFObject *> tmp;
         tmp.swap(d->data);
 
         this->contentOnChange();
 
-        for(zfstldeque<ZFObject *>::iterator it = tmp.begin(); it != tmp.end(); ++it)
+        for(zfstlsize i = 0; i < tmp.size(); ++i)
         {
-            this->contentOnRemove(*it);
-            zfRelease(*it);
+            this->contentOnRemove(tmp[i]);
+            zfRelease(tmp[i]);
         }
     }
 }
@@ -423,17 +448,11 @@ void ZFArray::move(ZF_IN zfindex fromIndex, ZF_IN zfindex toIndexOrIndexMax)
     ZFObject *t = d->data[fromIndex];
     if(fromIndex < toIndexOrIndexMax)
     {
-        for(zfindex i = fromIndex; i < toIndexOrIndexMax; ++i)
-        {
-            d->data[i] = d->data[i + 1];
-        }
+        zfmemmove(&(d->data[fromIndex]), &(d->data[fromIndex + 1]), sizeof(ZFObject *) * (toIndexOrIndexMax - fromIndex));
     }
     else
     {
-        for(zfindex i = fromIndex; i > toIndexOrIndexMax; --i)
-        {
-            d->data[i] = d->data[i - 1];
-        }
+        zfmemmove(&(d->data[toIndexOrIndexMax + 1]), &(d->data[toIndexOrIndexMax]), sizeof(ZFObject *) * (fromIndex - toIndexOrIndexMax));
     }
     d->data[toIndexOrIndexMax] = t;
 
@@ -445,35 +464,26 @@ void ZFArray::sort(ZF_IN_OPT zfbool ascending /* = zftrue */,
                    ZF_IN_OPT zfindex count /* = zfindexMax() */,
                    ZF_IN_OPT ZFComparer<ZFObject *>::Comparer comparer /* = ZFComparerCheckEqual */)
 {
-    if(d->data.size() > 0 && start + 1 < d->data.size() && count > 1)
+    if(d->data.size() > 0 && start + 1 < d->data.size() && count > 1 && comparer != zfnull)
     {
-        zfmSort<ZFObject *>(
-            d->data,
-            comparer,
-            start,
-            (count > d->data.size() - start) ? (d->data.size() - 1) : (start + count - 1),
-            ascending);
+        if(count > d->data.size() - start)
+        {
+            count = d->data.size() - start;
+        }
+        std::stable_sort(
+            d->data.begin() + start,
+            d->data.begin() + (start + count),
+            _ZFP_ZFArraySortComparer(comparer, ascending));
 
         this->contentOnChange();
     }
 }
 
 // ============================================================
-static void _ZFP_ZFArray_iteratorDeleteCallback(ZF_IN void *data)
-{
-    zfdelete((zfindex *)data);
-}
-static void *_ZFP_ZFArray_iteratorCopyCallback(ZF_IN void *data)
-{
-    return zfnew(zfindex, *(zfindex *)data);
-}
-
 ZFMETHOD_DEFINE_1(ZFArray, zfiterator, iteratorForIndex,
                   ZFMP_IN(zfindex, index))
 {
-    return zfiterator(zfnew(zfindex, index),
-        _ZFP_ZFArray_iteratorDeleteCallback,
-        _ZFP_ZFArray_iteratorCopyCallback);
+    return zfiterator::iteratorCreate(index);
 }
 ZFMETHOD_DEFINE_2(ZFArray, zfiterator, iteratorFind,
                   ZFMP_IN(ZFObject *, value),
@@ -490,9 +500,7 @@ ZFMETHOD_DEFINE_2(ZFArray, zfiterator, iteratorFindReversely,
 
 ZFMETHOD_DEFINE_0(ZFArray, zfiterator, iterator)
 {
-    return zfiterator(zfnew(zfindex, 0),
-        _ZFP_ZFArray_iteratorDeleteCallback,
-        _ZFP_ZFArray_iteratorCopyCallback);
+    return zfiterator::iteratorCreate((zfindex)0);
 }
 
 ZFMETHOD_DEFINE_1(ZFArray, zfiterator, iteratorFind,
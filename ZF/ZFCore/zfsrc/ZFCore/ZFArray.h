@@ -13,6 +13,12 @@ ZF_NAMESPACE_GLOBAL_BEGIN
 zfclassFwd _ZFP_ZFArrayPrivate;
 /**
  * @brief container of ZFObject, see #ZFContainer
+ *
+ * content are stored contiguously,
+ * batch operations such as #addFrom, #addFromRange, #remove with count,
+ * #removeElementAll, #removeAll and #sort
+ * would notify #ZFContainer::EventContentOnChange only once,
+ * use #capacity to reserve memory before bulk load
  */
 zfclass ZF_ENV_EXPORT ZFArray : zfextends ZFContainer
 {
@@ -46,6 +52,17 @@ public:
      */
     ZFMETHOD_DECLARE_0(zfbool, isEmpty)
 
+    /**
+     * @brief reserve memory for at least newCapacity elements,
+     *   do nothing if already enough
+     */
+    ZFMETHOD_DECLARE_1(void, capacity,
+                       ZFMP_IN(zfindex, newCapacity))
+    /**
+     * @brief number of elements that can be held without reallocation
+     */
+    ZFMETHOD_DECLARE_0(zfindex, capacity)
+
     /**
      * @brief return object at index, assert failure if out of range
      */
@@ -83,6 +100,14 @@ public:
                        ZFMP_IN_OPT(ZFComparer<ZFObject *>::Comparer, comparer, ZFComparerCheckEqual))
 
 public:
+    /**
+     * @brief direct access to the contiguous content, null if empty
+     *
+     * valid until this array changed,
+     * the elements are not retained
+     */
+    ZFObject * const *arrayBuf(void);
+
     /**
      * @brief util getter to get and cast to desired type
      */
@@ -124,6 +149,13 @@ protected:
      * @brief add objects from another container
      */
     virtual void addFrom(ZF_IN ZFContainer *another);
+    /**
+     * @brief add objects in range [start, start + count) from another array,
+     *   another can be this array itself
+     */
+    virtual void addFromRange(ZF_IN ZFArray *another,
+                              ZF_IN zfindex start,
+                              ZF_IN_OPT zfindex count = zfindexMax());
 
     /**
      * @brief replace object at index, assert fail if index out of range
@@ -157,7 +189,8 @@ protected:
     virtual zfindex removeElementAll(ZF_IN ZFObject *obj, ZF_IN ZFComparer<ZFObject *>::Comparer comparer);
 
     /**
-     * @brief remove object at index, assert failure if out of range
+     * @brief remove objects in range [index, index + count),
+     *   assert failure if index out of range
      */
     virtual void remove(ZF_IN zfindex index,
                         ZF_IN_OPT zfindex count = 1);
@@ -275,6 +308,13 @@ public:
     {
         zfsuper::addFrom(another);
     }
+    ZFMETHOD_INLINE_3(void, addFromRange,
+                      ZFMP_IN(ZFArray *, another),
+                      ZFMP_IN(zfindex, start),
+                      ZFMP_IN_OPT(zfindex, count, zfindexMax()))
+    {
+        zfsuper::addFromRange(another, start, count);
+    }
 
     ZFMETHOD_INLINE_2(void, set,
                       ZFMP_IN(zfindex, index),
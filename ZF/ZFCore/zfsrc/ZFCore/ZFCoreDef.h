@@ -11,6 +11,7 @@
 #include "ZFCoreDef/ZFComparer.h"
 #include "ZFCoreDef/ZFCoreArg.h"
 #include "ZFCoreDef/ZFCoreArray.h"
+#include "ZFCoreDef/ZFCoreAtomic.h"
 #include "ZFCoreDef/ZFCoreDataEncode.h"
 #include "ZFCoreDef/ZFCoreDataPairSplit.h"
 #include "ZFCoreDef/ZFCoreElementInfoGetter.h"
@@ -18,6 +19,7 @@
 #include "ZFCoreDef/ZFCoreEnvConfig.h"
 #include "ZFCoreDef/ZFCoreEnvDef.h"
 #include "ZFCoreDef/ZFCoreGlobalInitializer.h"
+#include "ZFCoreDef/ZFCoreHashMap.h"
 #include "ZFCoreDef/ZFCoreLog.h"
 #include "ZFCoreDef/ZFCoreLog_CommonLog.h"
 #include "ZFCoreDef/ZFCoreMap.h"
@@ -29,7 +31,9 @@
 #include "ZFCoreDef/ZFCoreStaticRegister.h"
 #include "ZFCoreDef/ZFCoreStatistic.h"
 #include "ZFCoreDef/ZFCoreString.h"
+#include "ZFCoreDef/ZFCoreStringAtom.h"
 #include "ZFCoreDef/ZFCoreStringConvert.h"
+#include "ZFCoreDef/ZFCoreStringShared.h"
 #include "ZFCoreDef/ZFCoreStringUtil.h"
 #include "ZFCoreDef/ZFCoreTypeDef.h"
 #include "ZFCoreDef/ZFCoreUtilMacro.h"
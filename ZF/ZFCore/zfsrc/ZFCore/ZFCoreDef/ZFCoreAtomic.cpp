@@ -0,0 +1,43 @@
+#include "ZFCoreAtomic.h"
+
+#if defined(_WIN32) || defined(WIN32)
+    #define _ZFP_zfAtomicYield_Windows 1
+    #include <windows.h>
+#elif defined(__unix__) || defined(__APPLE__) || defined(__linux)
+    #define _ZFP_zfAtomicYield_Posix 1
+    #include <sched.h>
+#endif
+
+ZF_NAMESPACE_GLOBAL_BEGIN
+
+void _ZFP_zfAtomicYield(void)
+{
+#if _ZFP_zfAtomicYield_Windows
+    SwitchToThread();
+#elif _ZFP_zfAtomicYield_Posix
+    sched_yield();
+#else
+    zfAtomicPause();
+#endif
+}
+
+#ifdef ZF_THREAD_LOCAL
+static zfatomicint _ZFP_zfThreadTokenGenerator = 0;
+static ZF_THREAD_LOCAL zfint _ZFP_zfThreadTokenValue = 0;
+zfint zfThreadToken(void)
+{
+    if(_ZFP_zfThreadTokenValue == 0)
+    {
+        _ZFP_zfThreadTokenValue = zfAtomicIncrease(_ZFP_zfThreadTokenGenerator);
+    }
+    return _ZFP_zfThreadTokenValue;
+}
+#else
+zfint zfThreadToken(void)
+{
+    return 1;
+}
+#endif
+
+ZF_NAMESPACE_GLOBAL_END
+
@@ -0,0 +1,371 @@
+/**
+ * @file ZFCoreAtomic.h
+ * @brief atomic operations for core types
+ */
+
+#ifndef _ZFI_ZFCoreAtomic_h_
+#define _ZFI_ZFCoreAtomic_h_
+
+#include "ZFCoreTypeDef.h"
+#include "ZFCoreMutex.h"
+
+#if defined(_MSC_VER)
+    #include <intrin.h>
+#endif
+
+ZF_NAMESPACE_GLOBAL_BEGIN
+
+/**
+ * @brief whether #zfAtomicIncrease series are implemented by native atomic instructions
+ *
+ * if not, they would fallback to #zfCoreMutexLock,
+ * which is thread-safe but much slower
+ */
+#ifndef ZF_ENV_ATOMIC_NATIVE
+    #if defined(__GNUC__) || defined(__clang__) || defined(_MSC_VER)
+        #define ZF_ENV_ATOMIC_NATIVE 1
+    #else
+        #define ZF_ENV_ATOMIC_NATIVE 0
+    #endif
+#endif
+
+/**
+ * @brief storage specifier for thread local POD variables
+ *
+ * not defined if not supported by the compiler,
+ * in this case, the thread local state must be held by other ways,
+ * or simply share one state with lock
+ */
+#ifndef ZF_THREAD_LOCAL
+    #if defined(__GNUC__) || defined(__clang__)
+        #define ZF_THREAD_LOCAL __thread
+    #elif defined(_MSC_VER)
+        #define ZF_THREAD_LOCAL __declspec(thread)
+    #endif
+#endif
+
+/**
+ * @brief atomic int type, must be accessed by #zfAtomicIncrease series only
+ */
+typedef zfint volatile zfatomicint;
+
+/**
+ * @brief a small positive number to identify current thread
+ *
+ * the token is assigned when first called in each thread,
+ * and won't be reused after thread exit\n
+ * if #ZF_THREAD_LOCAL not supported, always return 1
+ */
+extern ZF_ENV_EXPORT zfint zfThreadToken(void);
+
+/**
+ * @brief atomically load value
+ */
+inline zfint zfAtomicLoad(ZF_IN zfatomicint &v)
+{
+#if ZF_ENV_ATOMIC_NATIVE && (defined(__GNUC__) || defined(__clang__))
+    return __atomic_load_n(&v, __ATOMIC_ACQUIRE);
+#elif ZF_ENV_ATOMIC_NATIVE && defined(_MSC_VER)
+    return (zfint)_InterlockedCompareExchange((long volatile *)&v, 0, 0);
+#else
+    zfCoreMutexLocker();
+    return v;
+#endif
+}
+/**
+ * @brief atomically store value
+ */
+inline void zfAtomicStore(ZF_IN_OUT zfatomicint &v, ZF_IN zfint value)
+{
+#if ZF_ENV_ATOMIC_NATIVE && (defined(__GNUC__) || defined(__clang__))
+    __atomic_store_n(&v, value, __ATOMIC_RELEASE);
+#elif ZF_ENV_ATOMIC_NATIVE && defined(_MSC_VER)
+    _InterlockedExchange((long volatile *)&v, (long)value);
+#else
+    zfCoreMutexLocker();
+    v = value;
+#endif
+}
+/**
+ * @brief atomically increase value, return the increased value
+ */
+inline zfint zfAtomicIncrease(ZF_IN_OUT zfatomicint &v)
+{
+#if ZF_ENV_ATOMIC_NATIVE && (defined(__GNUC__) || defined(__clang__))
+    return __atomic_add_fetch(&v, 1, __ATOMIC_ACQ_REL);
+#elif ZF_ENV_ATOMIC_NATIVE && defined(_MSC_VER)
+    return (zfint)_InterlockedIncrement((long volatile *)&v);
+#else
+    zfCoreMutexLocker();
+    return ++v;
+#endif
+}
+/**
+ * @brief atomically decrease value, return the decreased value
+ */
+inline zfint zfAtomicDecrease(ZF_IN_OUT zfatomicint &v)
+{
+#if ZF_ENV_ATOMIC_NATIVE && (defined(__GNUC__) || defined(__clang__))
+    return __atomic_sub_fetch(&v, 1, __ATOMIC_ACQ_REL);
+#elif ZF_ENV_ATOMIC_NATIVE && defined(_MSC_VER)
+    return (zfint)_InterlockedDecrement((long volatile *)&v);
+#else
+    zfCoreMutexLocker();
+    return --v;
+#endif
+}
+/**
+ * @brief atomically change value to desired if it equals to expected,
+ *   return whether changed
+ */
+inline zfbool zfAtomicCompareAndSwap(ZF_IN_OUT zfatomicint &v,
+                                     ZF_IN zfint expected,
+                                     ZF_IN zfint desired)
+{
+#if ZF_ENV_ATOMIC_NATIVE && (defined(__GNUC__) || defined(__clang__))
+    return __atomic_compare_exchange_n(&v, &expected, desired, zffalse, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+#elif ZF_ENV_ATOMIC_NATIVE && defined(_MSC_VER)
+    return ((zfint)_InterlockedCompareExchange((long volatile *)&v, (long)desired, (long)expected) == expected);
+#else
+    zfCoreMutexLocker();
+    if(v == expected)
+    {
+        v = desired;
+        return zftrue;
+    }
+    else
+    {
+        return zffalse;
+    }
+#endif
+}
+/**
+ * @brief atomically set bits, see #ZFBitSet
+ */
+inline void zfAtomicBitSet(ZF_IN_OUT zfatomicint &v, ZF_IN zfint bit)
+{
+#if ZF_ENV_ATOMIC_NATIVE && (defined(__GNUC__) || defined(__clang__))
+    __atomic_fetch_or(&v, bit, __ATOMIC_ACQ_REL);
+#elif ZF_ENV_ATOMIC_NATIVE && defined(_MSC_VER)
+    _InterlockedOr((long volatile *)&v, (long)bit);
+#else
+    zfCoreMutexLocker();
+    v |= bit;
+#endif
+}
+/**
+ * @brief atomically unset bits, see #ZFBitUnset
+ */
+inline void zfAtomicBitUnset(ZF_IN_OUT zfatomicint &v, ZF_IN zfint bit)
+{
+#if ZF_ENV_ATOMIC_NATIVE && (defined(__GNUC__) || defined(__clang__))
+    __atomic_fetch_and(&v, ~bit, __ATOMIC_ACQ_REL);
+#elif ZF_ENV_ATOMIC_NATIVE && defined(_MSC_VER)
+    _InterlockedAnd((long volatile *)&v, (long)~bit);
+#else
+    zfCoreMutexLocker();
+    v &= ~bit;
+#endif
+}
+
+// ============================================================
+/**
+ * @brief hint the processor that current thread is spinning
+ *
+ * reduces power and the penalty when the spin ends,
+ * and gives the other hyper-thread of the same core a chance to run
+ */
+inline void zfAtomicPause(void)
+{
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__i386__) || defined(__x86_64__))
+    __asm__ __volatile__("pause");
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__aarch64__) || (defined(__ARM_ARCH) && __ARM_ARCH >= 7))
+    __asm__ __volatile__("yield");
+#elif defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+    _mm_pause();
+#elif defined(_MSC_VER) && (defined(_M_ARM) || defined(_M_ARM64))
+    __yield();
+#endif
+}
+/** @cond ZFPrivateDoc */
+extern ZF_ENV_EXPORT void _ZFP_zfAtomicYield(void);
+// pause with exponential backoff, and yield current thread after spinning for a while,
+// backoff must be initialized to 1
+#define _ZFP_zfAtomicBackoffMax 64
+inline void _ZFP_zfAtomicBackoff(ZF_IN_OUT zfindex &backoff)
+{
+    if(backoff <= _ZFP_zfAtomicBackoffMax)
+    {
+        for(zfindex i = 0; i < backoff; ++i)
+        {
+            zfAtomicPause();
+        }
+        backoff <<= 1;
+    }
+    else
+    {
+        _ZFP_zfAtomicYield();
+    }
+}
+// wait until lock value becomes 0
+inline void _ZFP_zfAtomicSpinWait(ZF_IN_OUT zfatomicint &lock)
+{
+    zfindex backoff = 1;
+    while(zfAtomicLoad(lock) != 0)
+    {
+        _ZFP_zfAtomicBackoff(backoff);
+    }
+}
+/** @endcond */
+
+/**
+ * @brief simple spin lock based on #zfAtomicCompareAndSwap
+ *
+ * the lock value must be initialized to 0,
+ * and the lock is not recursive\n
+ * use only to protect very short critical section
+ */
+inline void zfAtomicSpinLock(ZF_IN_OUT zfatomicint &lock)
+{
+    while(!zfAtomicCompareAndSwap(lock, 0, 1))
+    {
+        _ZFP_zfAtomicSpinWait(lock);
+    }
+}
+/** @brief see #zfAtomicSpinLock */
+inline void zfAtomicSpinUnlock(ZF_IN_OUT zfatomicint &lock)
+{
+    zfAtomicStore(lock, 0);
+}
+/**
+ * @brief util to lock a #zfAtomicSpinLock for current block
+ */
+zfclassLikePOD ZF_ENV_EXPORT zfAtomicSpinLockerHolder
+{
+public:
+    /** @cond ZFPrivateDoc */
+    zfAtomicSpinLockerHolder(ZF_IN_OUT zfatomicint &lock)
+    : lock(lock)
+    {
+        zfAtomicSpinLock(this->lock);
+    }
+    ~zfAtomicSpinLockerHolder(void)
+    {
+        zfAtomicSpinUnlock(this->lock);
+    }
+private:
+    zfatomicint &lock;
+    /** @endcond */
+};
+/** @brief see #zfAtomicSpinLockerHolder */
+#define zfAtomicSpinLocker(lock) zfAtomicSpinLockerHolder _ZFP_zfAtomicSpinLocker_hold(lock)
+
+// ============================================================
+/** @cond ZFPrivateDoc */
+#define _ZFP_zfAtomicWriterPending ((zfint)0x40000000)
+/** @endcond */
+/**
+ * @brief simple read write lock based on #zfAtomicCompareAndSwap
+ *
+ * the lock value must be initialized to 0,
+ * non-negative value holds reader count and a writer pending bit,
+ * and -1 means locked by writer\n
+ * any number of readers may hold the lock at the same time,
+ * while writer would wait until all readers released,
+ * once a writer is waiting, new readers would wait until the writer done,
+ * so that writers won't be starved by continuous readers\n
+ * the lock is not recursive, and a reader must not try to upgrade to writer
+ */
+inline void zfAtomicReadLock(ZF_IN_OUT zfatomicint &lock)
+{
+    zfindex backoff = 1;
+    for( ; ; )
+    {
+        zfint v = zfAtomicLoad(lock);
+        if(v >= 0 && (v & _ZFP_zfAtomicWriterPending) == 0 && zfAtomicCompareAndSwap(lock, v, v + 1))
+        {
+            return;
+        }
+        _ZFP_zfAtomicBackoff(backoff);
+    }
+}
+/** @brief see #zfAtomicReadLock */
+inline void zfAtomicReadUnlock(ZF_IN_OUT zfatomicint &lock)
+{
+    zfAtomicDecrease(lock);
+}
+/** @brief see #zfAtomicReadLock */
+inline void zfAtomicWriteLock(ZF_IN_OUT zfatomicint &lock)
+{
+    zfindex backoff = 1;
+    // mark pending to block new readers, only one writer can be pending
+    for( ; ; )
+    {
+        zfint v = zfAtomicLoad(lock);
+        if(v >= 0 && (v & _ZFP_zfAtomicWriterPending) == 0 && zfAtomicCompareAndSwap(lock, v, v | _ZFP_zfAtomicWriterPending))
+        {
+            break;
+        }
+        _ZFP_zfAtomicBackoff(backoff);
+    }
+    // wait for existing readers
+    while(!zfAtomicCompareAndSwap(lock, _ZFP_zfAtomicWriterPending, -1))
+    {
+        _ZFP_zfAtomicBackoff(backoff);
+    }
+}
+/** @brief see #zfAtomicReadLock */
+inline void zfAtomicWriteUnlock(ZF_IN_OUT zfatomicint &lock)
+{
+    zfAtomicStore(lock, 0);
+}
+
+/**
+ * @brief util to lock a #zfAtomicReadLock for current block
+ */
+zfclassLikePOD ZF_ENV_EXPORT zfAtomicReadLockerHolder
+{
+public:
+    /** @cond ZFPrivateDoc */
+    zfAtomicReadLockerHolder(ZF_IN_OUT zfatomicint &lock)
+    : lock(lock)
+    {
+        zfAtomicReadLock(this->lock);
+    }
+    ~zfAtomicReadLockerHolder(void)
+    {
+        zfAtomicReadUnlock(this->lock);
+    }
+private:
+    zfatomicint &lock;
+    /** @endcond */
+};
+/** @brief see #zfAtomicReadLockerHolder */
+#define zfAtomicReadLocker(lock) zfAtomicReadLockerHolder _ZFP_zfAtomicReadLocker_hold(lock)
+
+/**
+ * @brief util to lock a #zfAtomicWriteLock for current block
+ */
+zfclassLikePOD ZF_ENV_EXPORT zfAtomicWriteLockerHolder
+{
+public:
+    /** @cond ZFPrivateDoc */
+    zfAtomicWriteLockerHolder(ZF_IN_OUT zfatomicint &lock)
+    : lock(lock)
+    {
+        zfAtomicWriteLock(this->lock);
+    }
+    ~zfAtomicWriteLockerHolder(void)
+    {
+        zfAtomicWriteUnlock(this->lock);
+    }
+private:
+    zfatomicint &lock;
+    /** @endcond */
+};
+/** @brief see #zfAtomicWriteLockerHolder */
+#define zfAtomicWriteLocker(lock) zfAtomicWriteLockerHolder _ZFP_zfAtomicWriteLocker_hold(lock)
+
+ZF_NAMESPACE_GLOBAL_END
+#endif // #ifndef _ZFI_ZFCoreAtomic_h_
+
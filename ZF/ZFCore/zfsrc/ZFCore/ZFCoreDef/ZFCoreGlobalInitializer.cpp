@@ -3,6 +3,7 @@
 #include "ZFCorePointer.h"
 #include "ZFCoreArray.h"
 #include "ZFCoreMap.h"
+#include "ZFCoreAtomic.h"
 
 ZF_NAMESPACE_GLOBAL_BEGIN
 
@@ -17,6 +18,32 @@ ZFCoreArrayPOD<ZFFrameworkStateChangeCallback> &_ZFP_ZFFrameworkCleanupPrepareCa
     return d;
 }
 
+#if defined(__GNUC__) || defined(__clang__)
+    #define _ZFP_GI_threadLocal __thread
+#elif defined(_MSC_VER)
+    #define _ZFP_GI_threadLocal __declspec(thread)
+#endif
+
+static ZFFrameworkInitParallelImpl _ZFP_GI_parallelImpl = zfnull;
+static ZFFrameworkInitParallelWait _ZFP_GI_parallelWait = zfnull;
+static ZFFrameworkInitParallelNotify _ZFP_GI_parallelNotify = zfnull;
+void ZFFrameworkInitParallelImplSet(ZF_IN ZFFrameworkInitParallelImpl impl,
+                                    ZF_IN ZFFrameworkInitParallelWait implWait,
+                                    ZF_IN ZFFrameworkInitParallelNotify implNotify)
+{
+    _ZFP_GI_parallelImpl = impl;
+    _ZFP_GI_parallelWait = implWait;
+    _ZFP_GI_parallelNotify = implNotify;
+}
+ZFFrameworkInitParallelImpl ZFFrameworkInitParallelImplGet(void)
+{
+    return _ZFP_GI_parallelImpl;
+}
+
+// token of the thread that creating an initializer (see zfThreadToken),
+// 0 means not creating, and -1 means waiting to be created by parallel task
+#define _ZFP_GI_creatingTokenParallel (-1)
+
 zfclassNotPOD _ZFP_GI_Data
 {
 public:
@@ -25,9 +52,13 @@ public:
     ZFFrameworkState state;
     zfstring name;
     ZFLevel level;
-    void *instance;
+    zfuint flags;
+    ZFCoreArray<zfstring> dependency;
+    void *instance; // protected by _ZFP_GI_lock during parallel step
     _ZFP_GI_Constructor constructor;
     _ZFP_GI_Destructor destructor;
+    zfint creatingToken; // protected by _ZFP_GI_lock
+    zfindex createOrder; // instances are destroyed in reverse create order
 
 public:
     _ZFP_GI_Data(void)
@@ -36,9 +67,13 @@ public:
     , state(ZFFrameworkStateNotAvailable)
     , name()
     , level(ZFLevelAppLow)
+    , flags(ZFGlobalInitializerFlagDefault)
+    , dependency()
     , instance(zfnull)
     , constructor(zfnull)
     , destructor(zfnull)
+    , creatingToken(0)
+    , createOrder(0)
     {
     }
     ~_ZFP_GI_Data(void)
@@ -61,41 +96,328 @@ static void _ZFP_GI_keyForName(ZF_OUT zfstring &key,
     zfstringAppend(key, "%d_%s", (zfint)level, name);
 }
 
-static void _ZFP_GI_instanceInit(ZFCoreArrayPOD<_ZFP_GI_Data *> &list)
+/*
+ * creating state of all initializers,
+ * never held during constructor, so it's safe to be a spin lock
+ */
+static zfatomicint _ZFP_GI_lock = 0;
+// increased each time any instance attached, waiting threads would be notified
+static zfatomicint _ZFP_GI_attachSeq = 0;
+// whether parallel step is running, zfCoreMutex is not held during parallel step
+static zfatomicint _ZFP_GI_parallelRunning = 0;
+// thread that waiting for other thread to create an initializer
+zfclassPOD _ZFP_GI_Waiting
+{
+public:
+    zfint token;
+    _ZFP_GI_Data *data;
+};
+static ZFCoreArrayPOD<_ZFP_GI_Waiting> &_ZFP_GI_waitingList(void)
+{
+    static ZFCoreArrayPOD<_ZFP_GI_Waiting> d;
+    return d;
+}
+
+static zfbool _ZFP_GI_instanceExist(ZF_IN _ZFP_GI_Data *data)
+{
+    zfAtomicSpinLocker(_ZFP_GI_lock);
+    return (data->instance != zfnull);
+}
+
+static zfindex _ZFP_GI_createOrderGenerator = 0;
+static void _ZFP_GI_instanceAttach(ZF_IN _ZFP_GI_Data *data, ZF_IN void *instance)
+{
+    zfAtomicSpinLock(_ZFP_GI_lock);
+    data->instance = instance;
+    data->createOrder = ++_ZFP_GI_createOrderGenerator;
+    data->creatingToken = 0;
+    zfAtomicIncrease(_ZFP_GI_attachSeq);
+    zfbool needNotify = !_ZFP_GI_waitingList().isEmpty();
+    zfAtomicSpinUnlock(_ZFP_GI_lock);
+
+    if(needNotify && _ZFP_GI_parallelNotify != zfnull)
+    {
+        _ZFP_GI_parallelNotify(_ZFP_GI_attachSeq);
+    }
+}
+
+/*
+ * whether waiting for data would never end, must be called within _ZFP_GI_lock
+ *
+ * follow the thread creating data, the initializer that thread waiting for,
+ * and the thread creating that initializer...
+ * until reach current thread (cyclic), or a thread not waiting (not cyclic)
+ */
+static zfbool _ZFP_GI_cycleCheck(ZF_IN const _ZFP_GI_Data *data, ZF_IN zfint token)
+{
+    const ZFCoreArrayPOD<_ZFP_GI_Waiting> &waitingList = _ZFP_GI_waitingList();
+    zfint owner = data->creatingToken;
+    for(zfindex n = 0; n <= waitingList.count(); ++n)
+    {
+        if(owner == token)
+        {
+            return zftrue;
+        }
+        const _ZFP_GI_Data *ownerWaiting = zfnull;
+        for(zfindex i = 0; i < waitingList.count(); ++i)
+        {
+            if(waitingList[i].token == owner)
+            {
+                ownerWaiting = waitingList[i].data;
+                break;
+            }
+        }
+        if(ownerWaiting == zfnull)
+        {
+            return zffalse;
+        }
+        owner = ownerWaiting->creatingToken;
+        if(owner == 0 || owner == _ZFP_GI_creatingTokenParallel)
+        {
+            return zffalse;
+        }
+    }
+    return zffalse;
+}
+static void _ZFP_GI_waitForAttach(ZF_IN _ZFP_GI_Data *data, ZF_IN zfint token)
+{
+    // must be called within _ZFP_GI_lock, and the lock would be held again when return
+    _ZFP_GI_Waiting waiting;
+    waiting.token = token;
+    waiting.data = data;
+    ZFCoreArrayPOD<_ZFP_GI_Waiting> &waitingList = _ZFP_GI_waitingList();
+    waitingList.add(waiting);
+    zfint seq = zfAtomicLoad(_ZFP_GI_attachSeq);
+    zfAtomicSpinUnlock(_ZFP_GI_lock);
+
+    if(_ZFP_GI_parallelWait != zfnull)
+    {
+        _ZFP_GI_parallelWait(_ZFP_GI_attachSeq, seq);
+    }
+    else
+    {
+        while(zfAtomicLoad(_ZFP_GI_attachSeq) == seq)
+        {
+            zfAtomicPause();
+        }
+    }
+
+    zfAtomicSpinLock(_ZFP_GI_lock);
+    for(zfindex i = 0; i < waitingList.count(); ++i)
+    {
+        if(waitingList[i].token == token)
+        {
+            waitingList.remove(i);
+            break;
+        }
+    }
+}
+
+static ZFCoreMap &_ZFP_GI_dataMapForLevel(ZF_IN ZFLevel level);
+static zfbool _ZFP_GI_instanceCreate(ZF_IN _ZFP_GI_Data *data);
+/*
+ * create all dependency of data,
+ * when createParallel is false, parallel dependency are left to parallel task,
+ * and return false if any of them not created yet
+ */
+static zfbool _ZFP_GI_dependencyCreate(ZF_IN _ZFP_GI_Data *data,
+                                       ZF_IN zfbool createParallel)
+{
+    zfbool ret = zftrue;
+    for(zfindex i = 0; i < data->dependency.count(); ++i)
+    {
+        zfstring key;
+        _ZFP_GI_keyForName(key, data->dependency[i], data->level);
+        // dependency of other level is ensured by level order
+        _ZFP_GI_Data *dep = _ZFP_GI_dataMapForLevel(data->level).get<_ZFP_GI_Data *>(key.cString());
+        if(dep == zfnull)
+        {
+            zfCoreCriticalMessageTrim(
+                    "ZFGlobalInitializer %s depends on %s"
+                    ", which is not registered in the same level"
+                , data->name.cString(), data->dependency[i].cString());
+            ret = zffalse;
+            continue;
+        }
+        if(!createParallel
+            && ZFBitTest(dep->flags, ZFGlobalInitializerFlagParallel)
+            && !ZFBitTest(dep->flags, ZFGlobalInitializerFlagLazy)
+            )
+        {
+            if(!_ZFP_GI_instanceExist(dep))
+            {
+                ret = zffalse;
+            }
+        }
+        else if(!_ZFP_GI_instanceCreate(dep))
+        {
+            ret = zffalse;
+        }
+    }
+    return ret;
+}
+/*
+ * create instance in current thread, or wait until created by other thread,
+ * return false if unable to create
+ *
+ * item waiting for parallel task would be created directly,
+ * the parallel task would then be skipped
+ */
+static zfbool _ZFP_GI_instanceCreate(ZF_IN _ZFP_GI_Data *data)
+{
+    zfint token = zfThreadToken();
+    zfAtomicSpinLock(_ZFP_GI_lock);
+    while(data->instance == zfnull
+        && data->creatingToken != 0
+        && data->creatingToken != _ZFP_GI_creatingTokenParallel
+        )
+    {
+        if(_ZFP_GI_cycleCheck(data, token))
+        {
+            zfAtomicSpinUnlock(_ZFP_GI_lock);
+            zfCoreCriticalMessageTrim(
+                    "ZFGlobalInitializer %s accessed during its own creation"
+                    ", typically because of cyclic dependency"
+                , data->name.cString());
+            return zffalse;
+        }
+        // being created by other thread, wait for it
+        _ZFP_GI_waitForAttach(data, token);
+    }
+    if(data->instance != zfnull)
+    {
+        zfAtomicSpinUnlock(_ZFP_GI_lock);
+        return zftrue;
+    }
+    data->creatingToken = token;
+    zfAtomicSpinUnlock(_ZFP_GI_lock);
+
+    _ZFP_GI_dependencyCreate(data, zftrue);
+    _ZFP_GI_instanceAttach(data, data->constructor());
+    return zftrue;
+}
+
+static void _ZFP_GI_parallelTask(ZF_IN void *taskData)
+{
+    _ZFP_GI_Data *data = (_ZFP_GI_Data *)taskData;
+    zfAtomicSpinLock(_ZFP_GI_lock);
+    if(data->creatingToken != _ZFP_GI_creatingTokenParallel)
+    {
+        // already created by other task that accessed it
+        zfAtomicSpinUnlock(_ZFP_GI_lock);
+        return ;
+    }
+    data->creatingToken = zfThreadToken();
+    zfAtomicSpinUnlock(_ZFP_GI_lock);
+
+    _ZFP_GI_instanceAttach(data, data->constructor());
+}
+/*
+ * create parallel initializers by waves,
+ * each wave contains initializers whose dependencies are all created
+ */
+static void _ZFP_GI_instanceInitParallel(ZF_IN_OUT ZFCoreArrayPOD<_ZFP_GI_Data *> &list,
+                                         ZF_IN zfbool mutexLocked)
+{
+#ifdef _ZFP_GI_threadLocal
+    // zfCoreMutex is released during parallel step,
+    // the mutex impl may be registered by initializers of higher level,
+    // in this case, lock it only during parallel step
+    ZFFrameworkInitParallelImpl impl = _ZFP_GI_parallelImpl;
+    if(impl == zfnull
+        || _ZFP_GI_parallelWait == zfnull
+        || _ZFP_GI_parallelNotify == zfnull
+        || !ZFCoreMutexImplAvailable()
+        )
+    {
+        return ;
+    }
+    if(!mutexLocked)
+    {
+        zfCoreMutexLock();
+    }
+    ZFCoreArrayPOD<_ZFP_GI_Data *> wave;
+    do
+    {
+        wave.removeAll();
+        for(zfindex i = 0; i < list.count(); ++i)
+        {
+            _ZFP_GI_Data *data = list[i];
+            if(data->instance == zfnull
+                && data->creatingToken == 0
+                && ZFBitTest(data->flags, ZFGlobalInitializerFlagParallel)
+                && !ZFBitTest(data->flags, ZFGlobalInitializerFlagLazy)
+                && _ZFP_GI_dependencyCreate(data, zffalse)
+                )
+            {
+                wave.add(data);
+            }
+        }
+        if(wave.count() <= 1)
+        {
+            // remaining would be created one by one
+            break;
+        }
+
+        zfAtomicSpinLock(_ZFP_GI_lock);
+        for(zfindex i = 0; i < wave.count(); ++i)
+        {
+            wave[i]->creatingToken = _ZFP_GI_creatingTokenParallel;
+        }
+        zfAtomicSpinUnlock(_ZFP_GI_lock);
+        zfAtomicStore(_ZFP_GI_parallelRunning, 1);
+        zfCoreMutexUnlock();
+        impl(_ZFP_GI_parallelTask, (void * const *)wave.arrayBuf(), wave.count());
+        zfCoreMutexLock();
+        zfAtomicStore(_ZFP_GI_parallelRunning, 0);
+    } while(zftrue);
+    if(!mutexLocked)
+    {
+        zfCoreMutexUnlock();
+    }
+#endif
+}
+
+static void _ZFP_GI_instanceInit(ZFCoreArrayPOD<_ZFP_GI_Data *> &list,
+                                 ZF_IN zfbool mutexLocked)
 {
     if(!list.isEmpty())
     {
         // array may be changed during init step, copy it first
         ZFCoreArrayPOD<_ZFP_GI_Data *> tmp;
         tmp.copyFrom(list);
+        _ZFP_GI_instanceInitParallel(tmp, mutexLocked);
         for(zfindex i = 0; i < tmp.count(); ++i)
         {
             _ZFP_GI_Data *data = tmp.get(i);
-            if(data->instance == zfnull)
+            if(data->instance == zfnull && !ZFBitTest(data->flags, ZFGlobalInitializerFlagLazy))
             {
-                data->instance = data->constructor();
+                _ZFP_GI_instanceCreate(data);
             }
         }
     }
 }
 static void _ZFP_GI_instanceDealloc(ZFCoreArrayPOD<_ZFP_GI_Data *> &list)
 {
-    zfbool hasDataToClean = zftrue;
     do
     {
-        hasDataToClean = zffalse;
-        for(zfindex i = list.count() - 1; i != zfindexMax(); --i)
+        _ZFP_GI_Data *data = zfnull;
+        for(zfindex i = 0; i < list.count(); ++i)
         {
-            _ZFP_GI_Data *data = list.get(i);
-            if(data->instance != zfnull)
+            _ZFP_GI_Data *t = list.get(i);
+            if(t->instance != zfnull && (data == zfnull || t->createOrder > data->createOrder))
             {
-                hasDataToClean = zftrue;
-                void *tmp = data->instance;
-                data->instance = zfnull;
-                data->destructor(tmp);
+                data = t;
             }
         }
-    } while(hasDataToClean);
+        if(data == zfnull)
+        {
+            break;
+        }
+        void *tmp = data->instance;
+        data->instance = zfnull;
+        data->destructor(tmp);
+    } while(zftrue);
 }
 
 zfclassNotPOD _ZFP_GI_DataContainer
@@ -286,6 +608,10 @@ static _ZFP_GI_DataContainer &_ZFP_GI_dataContainerInstance_(void)
     return _instance;
 }
 #define _ZFP_GI_dataContainerInstance (_ZFP_GI_dataContainerInstance_())
+static ZFCoreMap &_ZFP_GI_dataMapForLevel(ZF_IN ZFLevel level)
+{
+    return _ZFP_GI_dataContainerInstance.dataMapForLevel(level);
+}
 
 zfclassLikePOD _ZFP_ZFFrameworkAutoCleanupHolder
 {
@@ -310,61 +636,61 @@ void ZFFrameworkInit(void)
         d.state = ZFFrameworkStateInitProcessing;
 
         d.stateZFFrameworkStatic = ZFFrameworkStateInitProcessing;
-        _ZFP_GI_instanceInit(d.dataLevelZFFrameworkStatic);
+        _ZFP_GI_instanceInit(d.dataLevelZFFrameworkStatic, mutexAvailable);
         d.stateZFFrameworkStatic = ZFFrameworkStateAvailable;
 
         d.stateZFFrameworkEssential = ZFFrameworkStateInitProcessing;
-        _ZFP_GI_instanceInit(d.dataLevelZFFrameworkEssential);
+        _ZFP_GI_instanceInit(d.dataLevelZFFrameworkEssential, mutexAvailable);
         d.stateZFFrameworkEssential = ZFFrameworkStateAvailable;
 
         d.stateZFFrameworkHigh = ZFFrameworkStateInitProcessing;
-        _ZFP_GI_instanceInit(d.dataLevelZFFrameworkHigh);
+        _ZFP_GI_instanceInit(d.dataLevelZFFrameworkHigh, mutexAvailable);
         d.stateZFFrameworkHigh = ZFFrameworkStateAvailable;
 
         d.stateZFFrameworkNormal = ZFFrameworkStateInitProcessing;
-        _ZFP_GI_instanceInit(d.dataLevelZFFrameworkNormal);
+        _ZFP_GI_instanceInit(d.dataLevelZFFrameworkNormal, mutexAvailable);
         d.stateZFFrameworkNormal = ZFFrameworkStateAvailable;
 
         d.stateZFFrameworkLow = ZFFrameworkStateInitProcessing;
-        _ZFP_GI_instanceInit(d.dataLevelZFFrameworkLow);
+        _ZFP_GI_instanceInit(d.dataLevelZFFrameworkLow, mutexAvailable);
         d.stateZFFrameworkLow = ZFFrameworkStateAvailable;
 
 
         d.stateAppEssential = ZFFrameworkStateInitProcessing;
-        _ZFP_GI_instanceInit(d.dataLevelAppEssential);
+        _ZFP_GI_instanceInit(d.dataLevelAppEssential, mutexAvailable);
         d.stateAppEssential = ZFFrameworkStateAvailable;
 
         d.stateAppHigh = ZFFrameworkStateInitProcessing;
-        _ZFP_GI_instanceInit(d.dataLevelAppHigh);
+        _ZFP_GI_instanceInit(d.dataLevelAppHigh, mutexAvailable);
         d.stateAppHigh = ZFFrameworkStateAvailable;
 
         d.stateAppNormal = ZFFrameworkStateInitProcessing;
-        _ZFP_GI_instanceInit(d.dataLevelAppNormal);
+        _ZFP_GI_instanceInit(d.dataLevelAppNormal, mutexAvailable);
         d.stateAppNormal = ZFFrameworkStateAvailable;
 
         d.stateAppLow = ZFFrameworkStateInitProcessing;
-        _ZFP_GI_instanceInit(d.dataLevelAppLow);
+        _ZFP_GI_instanceInit(d.dataLevelAppLow, mutexAvailable);
         d.stateAppLow = ZFFrameworkStateAvailable;
 
 
         d.stateZFFrameworkPostLow = ZFFrameworkStateInitProcessing;
-        _ZFP_GI_instanceInit(d.dataLevelZFFrameworkPostLow);
+        _ZFP_GI_instanceInit(d.dataLevelZFFrameworkPostLow, mutexAvailable);
         d.stateZFFrameworkPostLow = ZFFrameworkStateAvailable;
 
         d.stateZFFrameworkPostNormal = ZFFrameworkStateInitProcessing;
-        _ZFP_GI_instanceInit(d.dataLevelZFFrameworkPostNormal);
+        _ZFP_GI_instanceInit(d.dataLevelZFFrameworkPostNormal, mutexAvailable);
         d.stateZFFrameworkPostNormal = ZFFrameworkStateAvailable;
 
         d.stateZFFrameworkPostHigh = ZFFrameworkStateInitProcessing;
-        _ZFP_GI_instanceInit(d.dataLevelZFFrameworkPostHigh);
+        _ZFP_GI_instanceInit(d.dataLevelZFFrameworkPostHigh, mutexAvailable);
         d.stateZFFrameworkPostHigh = ZFFrameworkStateAvailable;
 
         d.stateZFFrameworkPostEssential = ZFFrameworkStateInitProcessing;
-        _ZFP_GI_instanceInit(d.dataLevelZFFrameworkPostEssential);
+        _ZFP_GI_instanceInit(d.dataLevelZFFrameworkPostEssential, mutexAvailable);
         d.stateZFFrameworkPostEssential = ZFFrameworkStateAvailable;
 
         d.stateZFFrameworkPostStatic = ZFFrameworkStateInitProcessing;
-        _ZFP_GI_instanceInit(d.dataLevelZFFrameworkPostStatic);
+        _ZFP_GI_instanceInit(d.dataLevelZFFrameworkPostStatic, mutexAvailable);
         d.stateZFFrameworkPostStatic = ZFFrameworkStateAvailable;
 
 
@@ -378,22 +704,22 @@ void ZFFrameworkInit(void)
     }
     else
     {
-        _ZFP_GI_instanceInit(d.dataLevelZFFrameworkStatic);
-        _ZFP_GI_instanceInit(d.dataLevelZFFrameworkEssential);
-        _ZFP_GI_instanceInit(d.dataLevelZFFrameworkHigh);
-        _ZFP_GI_instanceInit(d.dataLevelZFFrameworkNormal);
-        _ZFP_GI_instanceInit(d.dataLevelZFFrameworkLow);
-
-        _ZFP_GI_instanceInit(d.dataLevelAppEssential);
-        _ZFP_GI_instanceInit(d.dataLevelAppHigh);
-        _ZFP_GI_instanceInit(d.dataLevelAppNormal);
-        _ZFP_GI_instanceInit(d.dataLevelAppLow);
-
-        _ZFP_GI_instanceInit(d.dataLevelZFFrameworkPostLow);
-        _ZFP_GI_instanceInit(d.dataLevelZFFrameworkPostNormal);
-        _ZFP_GI_instanceInit(d.dataLevelZFFrameworkPostHigh);
-        _ZFP_GI_instanceInit(d.dataLevelZFFrameworkPostEssential);
-        _ZFP_GI_instanceInit(d.dataLevelZFFrameworkPostStatic);
+        _ZFP_GI_instanceInit(d.dataLevelZFFrameworkStatic, mutexAvailable);
+        _ZFP_GI_instanceInit(d.dataLevelZFFrameworkEssential, mutexAvailable);
+        _ZFP_GI_instanceInit(d.dataLevelZFFrameworkHigh, mutexAvailable);
+        _ZFP_GI_instanceInit(d.dataLevelZFFrameworkNormal, mutexAvailable);
+        _ZFP_GI_instanceInit(d.dataLevelZFFrameworkLow, mutexAvailable);
+
+        _ZFP_GI_instanceInit(d.dataLevelAppEssential, mutexAvailable);
+        _ZFP_GI_instanceInit(d.dataLevelAppHigh, mutexAvailable);
+        _ZFP_GI_instanceInit(d.dataLevelAppNormal, mutexAvailable);
+        _ZFP_GI_instanceInit(d.dataLevelAppLow, mutexAvailable);
+
+        _ZFP_GI_instanceInit(d.dataLevelZFFrameworkPostLow, mutexAvailable);
+        _ZFP_GI_instanceInit(d.dataLevelZFFrameworkPostNormal, mutexAvailable);
+        _ZFP_GI_instanceInit(d.dataLevelZFFrameworkPostHigh, mutexAvailable);
+        _ZFP_GI_instanceInit(d.dataLevelZFFrameworkPostEssential, mutexAvailable);
+        _ZFP_GI_instanceInit(d.dataLevelZFFrameworkPostStatic, mutexAvailable);
     }
 
     if(mutexAvailable)
@@ -532,7 +858,8 @@ static void _ZFP_GI_dataRegister(ZF_IN zfbool *ZFCoreLibDestroyFlag,
                                  ZF_IN const zfchar *name,
                                  ZF_IN ZFLevel level,
                                  ZF_IN _ZFP_GI_Constructor constructor,
-                                 ZF_IN _ZFP_GI_Destructor destructor)
+                                 ZF_IN _ZFP_GI_Destructor destructor,
+                                 ZF_IN zfuint flags)
 {
     _ZFP_GI_DataContainer &holder = _ZFP_GI_dataContainerInstance;
     ZFCoreArrayPOD<_ZFP_GI_Data *> &dataList = holder.dataListForLevel(level);
@@ -550,6 +877,7 @@ static void _ZFP_GI_dataRegister(ZF_IN zfbool *ZFCoreLibDestroyFlag,
         data = zfnew(_ZFP_GI_Data);
         data->name = name;
         data->level = level;
+        data->flags = flags;
         data->constructor = constructor;
         data->destructor = destructor;
 
@@ -572,7 +900,10 @@ static void _ZFP_GI_dataRegister(ZF_IN zfbool *ZFCoreLibDestroyFlag,
             break;
         case ZFFrameworkStateAvailable:
             // registered after init finish, manually load it
-            _ZFP_GI_instanceAccess(name, level);
+            if(!ZFBitTest(data->flags, ZFGlobalInitializerFlagLazy))
+            {
+                _ZFP_GI_instanceAccess(name, level);
+            }
             break;
         case ZFFrameworkStateCleanupProcessing:
             // static register during cleanup processing,
@@ -622,41 +953,90 @@ static void _ZFP_GI_dataUnregister(ZF_IN zfbool *ZFCoreLibDestroyFlag,
         dataMap.iteratorRemove(it);
     }
 }
+static void _ZFP_GI_dataDependencyAdd(ZF_IN const zfchar *name,
+                                      ZF_IN ZFLevel level,
+                                      ZF_IN const zfchar *dependencyName)
+{
+    zfCoreMutexLocker();
+    zfstring key;
+    _ZFP_GI_keyForName(key, name, level);
+    _ZFP_GI_Data *data = _ZFP_GI_dataMapForLevel(level).get<_ZFP_GI_Data *>(key.cString());
+    if(data == zfnull)
+    {
+        zfCoreCriticalShouldNotGoHere();
+        return ;
+    }
+    if(zfscmpTheSame(name, dependencyName))
+    {
+        zfCoreCriticalMessageTrim(
+                "ZFGlobalInitializer %s depends on itself"
+            , name);
+        return ;
+    }
+    for(zfindex i = 0; i < data->dependency.count(); ++i)
+    {
+        if(zfscmpTheSame(data->dependency[i].cString(), dependencyName))
+        {
+            return ;
+        }
+    }
+    data->dependency.add(dependencyName);
+}
 
 static void _ZFP_GI_notifyInstanceCreated(ZF_IN const _ZFP_GI_Data *data);
 static void **_ZFP_GI_instanceAccess(ZF_IN const zfchar *name,
                                      ZF_IN ZFLevel level)
 {
     static void *dummy = zfnull;
-    zfCoreMutexLocker();
-
-    if(ZFFrameworkStateCheck(level) == ZFFrameworkStateCleanupProcessing)
+    /*
+     * during parallel step, zfCoreMutex must not be held while creating,
+     * otherwise the thread that we are waiting for may be blocked by the mutex,
+     * the creating state is protected by _ZFP_GI_lock instead
+     */
+    zfbool parallelRunning = (zfAtomicLoad(_ZFP_GI_parallelRunning) != 0);
+    _ZFP_GI_Data *data = zfnull;
+    zfCoreMutexLock();
+    do
     {
-        zfCoreCriticalMessageTrim(
-            "try to reenter global initializer during ZFFrameworkCleanup, name: %s, "
-            "typically due to invalid global initializer dependency",
-            name);
-        return &dummy;
-    }
+        if(ZFFrameworkStateCheck(level) == ZFFrameworkStateCleanupProcessing)
+        {
+            zfCoreCriticalMessageTrim(
+                "try to reenter global initializer during ZFFrameworkCleanup, name: %s, "
+                "typically due to invalid global initializer dependency",
+                name);
+            break;
+        }
 
-    _ZFP_GI_DataContainer &holder = _ZFP_GI_dataContainerInstance;
-    ZFCoreMap &dataMap = holder.dataMapForLevel(level);
-    zfstring key;
-    _ZFP_GI_keyForName(key, name, level);
+        _ZFP_GI_DataContainer &holder = _ZFP_GI_dataContainerInstance;
+        ZFCoreMap &dataMap = holder.dataMapForLevel(level);
+        zfstring key;
+        _ZFP_GI_keyForName(key, name, level);
 
-    _ZFP_GI_Data *data = dataMap.get<_ZFP_GI_Data *>(key.cString());
+        data = dataMap.get<_ZFP_GI_Data *>(key.cString());
+        if(data == zfnull)
+        {
+            zfCoreCriticalShouldNotGoHere();
+        }
+    } while(zffalse);
     if(data == zfnull)
     {
-        zfCoreCriticalShouldNotGoHere();
+        zfCoreMutexUnlock();
         return &dummy;
     }
+    if(parallelRunning)
+    {
+        zfCoreMutexUnlock();
+    }
 
-    if(data->instance == zfnull)
+    if(!_ZFP_GI_instanceExist(data) && _ZFP_GI_instanceCreate(data))
     {
-        data->instance = data->constructor();
         _ZFP_GI_notifyInstanceCreated(data);
     }
 
+    if(!parallelRunning)
+    {
+        zfCoreMutexUnlock();
+    }
     return &(data->instance);
 }
 
@@ -664,7 +1044,7 @@ static const _ZFP_GI_Data *_ZFP_GI_dependencyCheck(ZFCoreArrayPOD<_ZFP_GI_Data *
 {
     for(zfindex i = 0; i < data.count(); ++i)
     {
-        if(data[i]->instance == zfnull)
+        if(data[i]->instance == zfnull && !ZFBitTest(data[i]->flags, ZFGlobalInitializerFlagLazy))
         {
             return data[i];
         }
@@ -754,25 +1134,6 @@ void _ZFP_GI_notifyInstanceCreated(ZF_IN const _ZFP_GI_Data *data)
         return ;
     }
 
-    // reorder in same level
-    ZFCoreArrayPOD<_ZFP_GI_Data *> &dataList = d.dataListForLevel(data->level);
-    zfindex prevNull = zfindexMax();
-    zfindex self = 0;
-    for(zfindex i = 0; i < dataList.count(); ++i)
-    {
-        if(dataList[i] == data)
-        {
-            self = i;
-        }
-        else if(prevNull == zfindexMax() && dataList[i]->instance == zfnull)
-        {
-            prevNull = i;
-        }
-    }
-    if(prevNull < self)
-    {
-        dataList.move(self, prevNull);
-    }
 }
 
 // ============================================================
@@ -795,10 +1156,11 @@ public:
 _ZFP_GI_Reg::_ZFP_GI_Reg(ZF_IN const zfchar *name,
                          ZF_IN ZFLevel level,
                          ZF_IN _ZFP_GI_Constructor constructor,
-                         ZF_IN _ZFP_GI_Destructor destructor)
+                         ZF_IN _ZFP_GI_Destructor destructor,
+                         ZF_IN_OPT zfuint flags /* = ZFGlobalInitializerFlagDefault */)
 : d(zfnew(_ZFP_GI_RegPrivate, name, level))
 {
-    _ZFP_GI_dataRegister(&(d->ZFCoreLibDestroyFlag), name, level, constructor, destructor);
+    _ZFP_GI_dataRegister(&(d->ZFCoreLibDestroyFlag), name, level, constructor, destructor, flags);
 }
 _ZFP_GI_Reg::~_ZFP_GI_Reg(void)
 {
@@ -813,6 +1175,10 @@ void *_ZFP_GI_Reg::instanceAccess(void)
     }
     return *(d->instance);
 }
+void _ZFP_GI_Reg::dependencyAdd(ZF_IN const zfchar *dependencyName)
+{
+    _ZFP_GI_dataDependencyAdd(d->name, d->level, dependencyName);
+}
 
 ZF_NAMESPACE_GLOBAL_END
 
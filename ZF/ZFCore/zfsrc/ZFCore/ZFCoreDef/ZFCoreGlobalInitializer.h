@@ -8,6 +8,7 @@
 #include "ZFLevel.h"
 #include "ZFCoreStaticRegister.h"
 #include "ZFCoreArray.h"
+#include "ZFCoreAtomic.h"
 
 ZF_NAMESPACE_GLOBAL_BEGIN
 
@@ -74,6 +75,68 @@ extern ZF_ENV_EXPORT ZFFrameworkState ZFFrameworkStateCheck(void);
  */
 extern ZF_ENV_EXPORT ZFFrameworkState ZFFrameworkStateCheck(ZF_IN ZFLevel level);
 
+// ============================================================
+/**
+ * @brief flags for #ZF_GLOBAL_INITIALIZER_INIT_WITH_LEVEL_AND_FLAGS
+ */
+typedef enum {
+    ZFGlobalInitializerFlagDefault = 0, /**< @brief created one by one during #ZFFrameworkInit */
+    /**
+     * @brief not created during #ZFFrameworkInit,
+     *   but created on first #ZF_GLOBAL_INITIALIZER_INSTANCE
+     *
+     * useful for costly initializers that are rarely used,
+     * the level rule still applies,
+     * it's not allowed to access lazy initializer from initializers of higher level
+     */
+    ZFGlobalInitializerFlagLazy = 1 << 0,
+    /**
+     * @brief may be created concurrently with other parallel initializers of the same level,
+     *   see #ZFFrameworkInitParallelImplSet
+     *
+     * parallel initializers would be created in worker threads,
+     * after all of its dependencies (see #ZF_GLOBAL_INITIALIZER_DEPENDENCY) created\n
+     * the initializer must be thread-safe,
+     * and should declare other initializers of the same level it accesses
+     * by #ZF_GLOBAL_INITIALIZER_DEPENDENCY,
+     * undeclared ones would be created or waited on first access,
+     * which serializes the parallel step\n
+     * accessing an initializer that is waiting for current thread,
+     * directly or through other threads, is treated as cyclic dependency
+     */
+    ZFGlobalInitializerFlagParallel = 1 << 1,
+} ZFGlobalInitializerFlag;
+
+/** @brief see #ZFFrameworkInitParallelImplSet */
+typedef void (*ZFFrameworkInitParallelTask)(ZF_IN void *taskData);
+/** @brief see #ZFFrameworkInitParallelImplSet */
+typedef void (*ZFFrameworkInitParallelImpl)(ZF_IN ZFFrameworkInitParallelTask task,
+                                            ZF_IN void * const *taskDataList,
+                                            ZF_IN zfindex taskCount);
+/** @brief see #ZFFrameworkInitParallelImplSet */
+typedef void (*ZFFrameworkInitParallelWait)(ZF_IN zfatomicint &value,
+                                            ZF_IN zfint expected);
+/** @brief see #ZFFrameworkInitParallelImplSet */
+typedef void (*ZFFrameworkInitParallelNotify)(ZF_IN zfatomicint &value);
+/**
+ * @brief set the impl to create #ZFGlobalInitializerFlagParallel initializers concurrently
+ *
+ * impl must run task with each item of taskDataList concurrently,
+ * and return only after all of them finished,
+ * it's allowed to run some or all of the tasks in current thread\n
+ * implWait must block current thread until value is not equal to expected,
+ * and implNotify must wake up all threads blocked by implWait for the value,
+ * they are used when an initializer is accessed while being created by other thread\n
+ * if any of them not set, thread local storage not supported by the compiler,
+ * or #ZFCoreMutexImplAvailable is false,
+ * all initializers would be created one by one in current thread
+ */
+extern ZF_ENV_EXPORT void ZFFrameworkInitParallelImplSet(ZF_IN ZFFrameworkInitParallelImpl impl,
+                                                         ZF_IN ZFFrameworkInitParallelWait implWait,
+                                                         ZF_IN ZFFrameworkInitParallelNotify implNotify);
+/** @brief see #ZFFrameworkInitParallelImplSet */
+extern ZF_ENV_EXPORT ZFFrameworkInitParallelImpl ZFFrameworkInitParallelImplGet(void);
+
 // ============================================================
 typedef void *(*_ZFP_GI_Constructor)(void);
 typedef void (*_ZFP_GI_Destructor)(ZF_IN void *p);
@@ -84,21 +147,26 @@ public:
     _ZFP_GI_Reg(ZF_IN const zfchar *name,
                 ZF_IN ZFLevel level,
                 ZF_IN _ZFP_GI_Constructor constructor,
-                ZF_IN _ZFP_GI_Destructor destructor);
+                ZF_IN _ZFP_GI_Destructor destructor,
+                ZF_IN_OPT zfuint flags = ZFGlobalInitializerFlagDefault);
     ~_ZFP_GI_Reg(void);
 public:
     void *instanceAccess(void);
+    void dependencyAdd(ZF_IN const zfchar *dependencyName);
 private:
     _ZFP_GI_RegPrivate *d;
 };
 
 #define _ZFP_ZF_GLOBAL_INITIALIZER_INIT_WITH_LEVEL(Name, ZFLevel_) \
+    _ZFP_ZF_GLOBAL_INITIALIZER_INIT_WITH_LEVEL_AND_FLAGS(Name, ZFLevel_, ZFGlobalInitializerFlagDefault)
+#define _ZFP_ZF_GLOBAL_INITIALIZER_INIT_WITH_LEVEL_AND_FLAGS(Name, ZFLevel_, flags_) \
     static void *_ZFP_GI_ctor_##Name(void); \
     static void _ZFP_GI_dtor_##Name(ZF_IN void *p); \
     static _ZFP_GI_Reg _ZFP_GI_reg_##Name(ZFM_TOSTRING(Name), \
             ZFLevel_, \
             _ZFP_GI_ctor_##Name, \
-            _ZFP_GI_dtor_##Name \
+            _ZFP_GI_dtor_##Name, \
+            flags_ \
         ); \
     zfclassNotPOD _ZFP_GI_##Name \
     { \
@@ -133,7 +201,8 @@ private:
  * @endcode
  * \n
  * @warning if you have more than one initializer with same level,
- *   the execute order of the code block is not ensured
+ *   the execute order of the code block is not ensured,
+ *   unless declared by #ZF_GLOBAL_INITIALIZER_DEPENDENCY
  * @warning init and destroy step is not one time,
  *   they'll be called each time ZFFrameworkInit/ZFFrameworkCleanup is called
  * @note see #ZF_STATIC_REGISTER_INIT for recommended usage
@@ -147,6 +216,12 @@ private:
 #define ZF_GLOBAL_INITIALIZER_INIT(Name) \
     _ZFP_ZF_GLOBAL_INITIALIZER_INIT_WITH_LEVEL(Name, ZFLevelAppNormal)
 
+/**
+ * @brief see #ZF_GLOBAL_INITIALIZER_INIT_WITH_LEVEL, flags are #ZFGlobalInitializerFlag
+ */
+#define ZF_GLOBAL_INITIALIZER_INIT_WITH_LEVEL_AND_FLAGS(Name, ZFLevel_, flags_) \
+    _ZFP_ZF_GLOBAL_INITIALIZER_INIT_WITH_LEVEL_AND_FLAGS(Name, ZFLevel_, flags_)
+
 #define _ZFP_ZF_GLOBAL_INITIALIZER_DESTROY(Name) \
     public: \
         ~_ZFP_GI_##Name(void)
@@ -172,6 +247,34 @@ private:
 #define ZF_GLOBAL_INITIALIZER_END(Name) \
     _ZFP_ZF_GLOBAL_INITIALIZER_END(Name)
 
+#define _ZFP_ZF_GLOBAL_INITIALIZER_DEPENDENCY(Name, DependencyName) \
+    ZF_STATIC_REGISTER_INIT(GI_dep_##Name##_##DependencyName) \
+    { \
+        _ZFP_GI_reg_##Name.dependencyAdd(ZFM_TOSTRING(DependencyName)); \
+    } \
+    ZF_STATIC_REGISTER_END(GI_dep_##Name##_##DependencyName)
+/**
+ * @brief declare that initializer Name must be created after DependencyName
+ *
+ * usage:
+ * @code
+ *   ZF_GLOBAL_INITIALIZER_INIT_WITH_LEVEL_AND_FLAGS(MyInit, ZFLevelAppNormal, ZFGlobalInitializerFlagParallel)
+ *   {
+ *   }
+ *   ZF_GLOBAL_INITIALIZER_END(MyInit)
+ *   ZF_GLOBAL_INITIALIZER_DEPENDENCY(MyInit, OtherInit)
+ * @endcode
+ * must be placed after #ZF_GLOBAL_INITIALIZER_END of Name in the same cpp file,
+ * DependencyName is only looked up in the same level of Name,
+ * since initializers of higher level are always created earlier\n
+ * dependencies would be created before the initializer during #ZFFrameworkInit,
+ * and destroyed after the initializer during #ZFFrameworkCleanup\n
+ * it's an error if DependencyName is not registered
+ * when the initializer is created
+ */
+#define ZF_GLOBAL_INITIALIZER_DEPENDENCY(Name, DependencyName) \
+    _ZFP_ZF_GLOBAL_INITIALIZER_DEPENDENCY(Name, DependencyName)
+
 #define _ZFP_ZF_GLOBAL_INITIALIZER_INSTANCE(Name) \
     (_ZFP_GI_##Name::_ZFP_GI_instance())
 /**
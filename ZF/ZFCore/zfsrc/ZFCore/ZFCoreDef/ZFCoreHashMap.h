@@ -0,0 +1,332 @@
+/**
+ * @file ZFCoreHashMap.h
+ * @brief open addressing hash map with string key, for private use only
+ */
+
+#ifndef _ZFI_ZFCoreHashMap_h_
+#define _ZFI_ZFCoreHashMap_h_
+
+#include "ZFCoreTypeDef.h"
+#include "ZFCoreStringUtil.h"
+#include "ZFIdentityUtil.h"
+
+ZF_NAMESPACE_GLOBAL_BEGIN
+
+/**
+ * @brief open addressing hash map with string key, for private use only
+ *
+ * designed for process-wide registries that are looked up frequently:
+ * -  all slots are stored in one contiguous array with linear probing,
+ *   each slot stores the key's hash,
+ *   so a lookup typically touches one slot and one key string
+ * -  key would be copied and owned by the map,
+ *   null key is considered same as empty string
+ * -  T_Value must be POD type, such as pointer or integer
+ *
+ * elements are accessed by slot index:
+ * @code
+ *   for(zfindex i = m.indexFirst(); i != zfindexMax(); i = m.indexNext(i))
+ *   {
+ *       m.keyAt(i);
+ *       m.valueAt(i);
+ *   }
+ * @endcode
+ * removing by #removeAt keeps other slot index unchanged,
+ * adding new key may rehash and invalidate all slot index
+ */
+template<typename T_Value>
+zffinal zfclassNotPOD ZFCoreHashMap
+{
+    ZFCLASS_DISALLOW_COPY_CONSTRUCTOR(ZFCoreHashMap)
+
+private:
+    /*
+     * key not null: in use
+     * key null, hash 0: empty
+     * key null, hash 1: removed
+     */
+    zfclassPOD _Slot
+    {
+    public:
+        zfidentity hash;
+        zfchar *key;
+        T_Value value;
+    };
+
+public:
+    /** @brief construct an empty map */
+    ZFCoreHashMap(void)
+    : _slots(zfnull)
+    , _capacity(0)
+    , _count(0)
+    , _used(0)
+    {
+    }
+    ~ZFCoreHashMap(void)
+    {
+        this->removeAll();
+    }
+
+public:
+    /** @brief element count */
+    inline zfindex count(void) const
+    {
+        return _count;
+    }
+    /** @brief true if empty */
+    inline zfbool isEmpty(void) const
+    {
+        return (_count == 0);
+    }
+
+    /** @brief true if contains the key */
+    inline zfbool isContain(ZF_IN const zfchar *key) const
+    {
+        return (this->indexForKey(key) != zfindexMax());
+    }
+    /** @brief get value pointer or null if not exist */
+    T_Value *get(ZF_IN const zfchar *key) const
+    {
+        zfindex index = this->indexForKey(key);
+        return (index != zfindexMax()) ? &(_slots[index].value) : zfnull;
+    }
+    /** @brief change value or create if not exist */
+    inline void set(ZF_IN const zfchar *key,
+                    ZF_IN T_Value const &value)
+    {
+        zfindex index = this->indexForAdd(key);
+        _slots[index].value = value;
+    }
+    /** @brief remove or do nothing if not exist, return whether removed */
+    zfbool remove(ZF_IN const zfchar *key)
+    {
+        zfindex index = this->indexForKey(key);
+        if(index != zfindexMax())
+        {
+            this->removeAt(index);
+            return zftrue;
+        }
+        return zffalse;
+    }
+    /** @brief swap content with ref */
+    void swap(ZF_IN_OUT ZFCoreHashMap<T_Value> &ref)
+    {
+        _Slot *slots = _slots;
+        zfindex capacity = _capacity;
+        zfindex count = _count;
+        zfindex used = _used;
+        _slots = ref._slots;
+        _capacity = ref._capacity;
+        _count = ref._count;
+        _used = ref._used;
+        ref._slots = slots;
+        ref._capacity = capacity;
+        ref._count = count;
+        ref._used = used;
+    }
+    /** @brief remove all content and free memory */
+    void removeAll(void)
+    {
+        if(_slots != zfnull)
+        {
+            for(zfindex i = 0; i < _capacity; ++i)
+            {
+                zffree(_slots[i].key);
+            }
+            zffree(_slots);
+            _slots = zfnull;
+            _capacity = 0;
+            _count = 0;
+            _used = 0;
+        }
+    }
+
+public:
+    /** @brief slot index of key, or zfindexMax() if not exist */
+    zfindex indexForKey(ZF_IN const zfchar *key) const
+    {
+        if(key == zfnull)
+        {
+            key = "";
+        }
+        return this->_indexForHash(_hashFor(key), key);
+    }
+    /**
+     * @brief slot index of key, create with zero value if not exist
+     *
+     * isNew would be set to whether the key is newly created\n
+     * only creating new key may rehash,
+     * existing key's slot index and iteration are not affected
+     */
+    zfindex indexForAdd(ZF_IN const zfchar *key,
+                        ZF_OUT_OPT zfbool *isNew = zfnull)
+    {
+        if(key == zfnull)
+        {
+            key = "";
+        }
+        zfidentity hash = _hashFor(key);
+        zfindex i = this->_indexForHash(hash, key);
+        if(i != zfindexMax())
+        {
+            if(isNew != zfnull)
+            {
+                *isNew = zffalse;
+            }
+            return i;
+        }
+
+        if((_used + 1) * 4 > _capacity * 3)
+        {
+            this->_rehash((_count + 1) * 2);
+        }
+        // key not exist, reuse first removed slot if any
+        zfindex mask = _capacity - 1;
+        i = (zfindex)hash & mask;
+        while(_slots[i].key != zfnull)
+        {
+            i = (i + 1) & mask;
+        }
+        _Slot &slot = _slots[i];
+        if(slot.hash == 0)
+        {
+            ++_used;
+        }
+        slot.hash = hash;
+        slot.key = zfsCopy(key);
+        zfmemset(&(slot.value), 0, sizeof(T_Value));
+        ++_count;
+        if(isNew != zfnull)
+        {
+            *isNew = zftrue;
+        }
+        return i;
+    }
+    /** @brief remove element at slot index */
+    void removeAt(ZF_IN zfindex index)
+    {
+        _Slot &slot = _slots[index];
+        zffree(slot.key);
+        slot.key = zfnull;
+        slot.hash = 1;
+        --_count;
+    }
+
+    /** @brief key at slot index */
+    inline const zfchar *keyAt(ZF_IN zfindex index) const
+    {
+        return _slots[index].key;
+    }
+    /** @brief value at slot index */
+    inline T_Value &valueAt(ZF_IN zfindex index) const
+    {
+        return _slots[index].value;
+    }
+
+    /** @brief first slot index in use, or zfindexMax() if empty */
+    inline zfindex indexFirst(void) const
+    {
+        return this->indexNext(zfindexMax());
+    }
+    /** @brief next slot index in use, or zfindexMax() if none */
+    zfindex indexNext(ZF_IN zfindex index) const
+    {
+        for(++index; index < _capacity; ++index)
+        {
+            if(_slots[index].key != zfnull)
+            {
+                return index;
+            }
+        }
+        return zfindexMax();
+    }
+    /** @brief last slot index in use, or zfindexMax() if empty */
+    inline zfindex indexLast(void) const
+    {
+        return this->indexPrev(_capacity);
+    }
+    /** @brief previous slot index in use, or zfindexMax() if none */
+    zfindex indexPrev(ZF_IN zfindex index) const
+    {
+        while(index > 0 && index != zfindexMax())
+        {
+            --index;
+            if(_slots[index].key != zfnull)
+            {
+                return index;
+            }
+        }
+        return zfindexMax();
+    }
+
+private:
+    static inline zfidentity _hashFor(ZF_IN const zfchar *key)
+    {
+        zfidentity hash = zfidentityCalcString(key);
+        // 0 and 1 are reserved to mark empty and removed slots
+        return (hash > (zfidentity)1) ? hash : (zfidentity)(hash + 2);
+    }
+    zfindex _indexForHash(ZF_IN zfidentity hash,
+                          ZF_IN const zfchar *key) const
+    {
+        if(_count == 0)
+        {
+            return zfindexMax();
+        }
+        zfindex mask = _capacity - 1;
+        for(zfindex i = (zfindex)hash & mask; ; i = (i + 1) & mask)
+        {
+            const _Slot &slot = _slots[i];
+            if(slot.key == zfnull)
+            {
+                if(slot.hash == 0)
+                {
+                    return zfindexMax();
+                }
+            }
+            else if(slot.hash == hash && zfscmpTheSame(slot.key, key))
+            {
+                return i;
+            }
+        }
+    }
+    void _rehash(ZF_IN zfindex minCapacity)
+    {
+        zfindex capacity = 8;
+        while(capacity < minCapacity)
+        {
+            capacity *= 2;
+        }
+        _Slot *slotsOld = _slots;
+        zfindex capacityOld = _capacity;
+        _slots = (_Slot *)zfmallocZero(sizeof(_Slot) * capacity);
+        _capacity = capacity;
+        _used = _count;
+        zfindex mask = capacity - 1;
+        for(zfindex iOld = 0; iOld < capacityOld; ++iOld)
+        {
+            const _Slot &slotOld = slotsOld[iOld];
+            if(slotOld.key != zfnull)
+            {
+                zfindex i = (zfindex)slotOld.hash & mask;
+                while(_slots[i].key != zfnull)
+                {
+                    i = (i + 1) & mask;
+                }
+                _slots[i] = slotOld;
+            }
+        }
+        zffree(slotsOld);
+    }
+
+private:
+    _Slot *_slots;
+    zfindex _capacity; // always power of 2
+    zfindex _count; // slots in use
+    zfindex _used; // slots in use or removed
+};
+
+ZF_NAMESPACE_GLOBAL_END
+
+#endif // #ifndef _ZFI_ZFCoreHashMap_h_
+
@@ -1,16 +1,5 @@
 #include "ZFCoreMap.h"
-
-#include "ZFCore/ZFSTLWrapper/zfstl_string.h"
-
-#ifndef ZF_ENV_ZFCOREMAP_USE_HASHMAP
-    #define ZF_ENV_ZFCOREMAP_USE_HASHMAP 1
-#endif
-
-#if ZF_ENV_ZFCOREMAP_USE_HASHMAP
-    #include "ZFCore/ZFSTLWrapper/zfstl_hashmap.h"
-#else
-    #include "ZFCore/ZFSTLWrapper/zfstl_map.h"
-#endif
+#include "ZFCoreHashMap.h"
 
 ZF_NAMESPACE_GLOBAL_BEGIN
 
@@ -20,11 +9,7 @@ const ZFCoreMapPair ZFCoreMapPairZero = {0, 0};
 zfclassNotPOD _ZFP_ZFCoreMapPrivate
 {
 public:
-#if ZF_ENV_ZFCOREMAP_USE_HASHMAP
-    typedef zfstlhashmap<zfstlstringZ, ZFCorePointerBase *> MapType;
-#else
-    typedef zfstlmap<zfstlstringZ, ZFCorePointerBase *> MapType;
-#endif
+    typedef ZFCoreHashMap<ZFCorePointerBase *> MapType;
 
 public:
     zfuint refCount;
@@ -33,13 +18,13 @@ public:
 public:
     void removeAll(void)
     {
-        if(!this->m.empty())
+        if(!this->m.isEmpty())
         {
             _ZFP_ZFCoreMapPrivate::MapType tmp;
             tmp.swap(this->m);
-            for(_ZFP_ZFCoreMapPrivate::MapType::iterator it = tmp.begin(); it != tmp.end(); ++it)
+            for(zfindex i = tmp.indexFirst(); i != zfindexMax(); i = tmp.indexNext(i))
             {
-                zfdelete(it->second);
+                tmp.valueAt(i)->refDelete();
             }
         }
     }
@@ -161,21 +146,17 @@ zfindex ZFCoreMap::objectRetainCount(void) const
 
 zfindex ZFCoreMap::count(void) const
 {
-    return d->m.size();
+    return d->m.count();
 }
 
 zfbool ZFCoreMap::isEmpty(void) const
 {
-    return d->m.empty();
+    return d->m.isEmpty();
 }
 
 zfbool ZFCoreMap::isContain(ZF_IN const zfchar *key) const
 {
-    if(key == zfnull)
-    {
-        key = "";
-    }
-    return (d->m.find(key) != d->m.end());
+    return d->m.isContain(key);
 }
 
 void ZFCoreMap::addFrom(ZF_IN const ZFCoreMap &ref)
@@ -192,82 +173,56 @@ void ZFCoreMap::addFrom(ZF_IN const ZFCoreMap &ref)
 void ZFCoreMap::set(ZF_IN const zfchar *key,
                     ZF_IN const ZFCorePointerBase &value)
 {
-    if(key == zfnull)
-    {
-        key = "";
-    }
-
-    _ZFP_ZFCoreMapPrivate::MapType::iterator it = d->m.find(key);
-    if(it == d->m.end())
+    zfbool isNew = zffalse;
+    ZFCorePointerBase *&v = d->m.valueAt(d->m.indexForAdd(key, &isNew));
+    ZFCorePointerBase *toDelete = (isNew ? zfnull : v);
+    v = value.refNew();
+    if(toDelete != zfnull)
     {
-        d->m[key] = value.refNew();
-    }
-    else
-    {
-        ZFCorePointerBase *toDelete = it->second;
-        it->second = value.refNew();
         toDelete->refDelete();
     }
 }
 ZFCorePointerBase *ZFCoreMap::get(ZF_IN const zfchar *key) const
 {
-    if(key == zfnull)
-    {
-        key = "";
-    }
-    _ZFP_ZFCoreMapPrivate::MapType::iterator it = d->m.find(key);
-    if(it == d->m.end())
-    {
-        return zfnull;
-    }
-    return it->second;
+    ZFCorePointerBase **v = d->m.get(key);
+    return ((v != zfnull) ? *v : zfnull);
 }
 
 void ZFCoreMap::allKeyT(ZF_IN_OUT ZFCoreArray<const zfchar *> &ret) const
 {
     ret.capacity(ret.count() + this->count());
-    for(_ZFP_ZFCoreMapPrivate::MapType::const_iterator it = d->m.begin();
-        it != d->m.end();
-        ++it)
+    for(zfindex i = d->m.indexFirst(); i != zfindexMax(); i = d->m.indexNext(i))
     {
-        ret.add(it->first.c_str());
+        ret.add(d->m.keyAt(i));
     }
 }
 void ZFCoreMap::allValueT(ZF_IN_OUT ZFCoreArray<ZFCorePointerBase *> &ret) const
 {
     ret.capacity(ret.count() + this->count());
-    for(_ZFP_ZFCoreMapPrivate::MapType::const_iterator it = d->m.begin();
-        it != d->m.end();
-        ++it)
+    for(zfindex i = d->m.indexFirst(); i != zfindexMax(); i = d->m.indexNext(i))
     {
-        ret.add(it->second);
+        ret.add(d->m.valueAt(i));
     }
 }
 void ZFCoreMap::allPairT(ZF_IN_OUT ZFCoreArray<ZFCoreMapPair> &ret) const
 {
     ret.capacity(ret.count() + this->count());
     ZFCoreMapPair tmp;
-    for(_ZFP_ZFCoreMapPrivate::MapType::const_iterator it = d->m.begin();
-        it != d->m.end();
-        ++it)
+    for(zfindex i = d->m.indexFirst(); i != zfindexMax(); i = d->m.indexNext(i))
     {
-        tmp.key = it->first.c_str();
-        tmp.value = it->second;
+        tmp.key = d->m.keyAt(i);
+        tmp.value = d->m.valueAt(i);
         ret.add(tmp);
     }
 }
 
 void ZFCoreMap::remove(ZF_IN const zfchar *key)
 {
-    if(key == zfnull)
-    {
-        key = "";
-    }
-    _ZFP_ZFCoreMapPrivate::MapType::iterator it = d->m.find(key);
-    if(it != d->m.end())
+    zfindex index = d->m.indexForKey(key);
+    if(index != zfindexMax())
     {
-        ZFCorePointerBase *savedValue = it->second;
-        d->m.erase(it);
+        ZFCorePointerBase *savedValue = d->m.valueAt(index);
+        d->m.removeAt(index);
         savedValue->refDelete();
     }
 }
@@ -279,169 +234,117 @@ void ZFCoreMap::removeAll(void)
 
 // ============================================================
 // iterator
-static void _ZFP_ZFCoreMap_iteratorDeleteCallback(void *data)
-{
-    zfdelete(ZFCastStatic(_ZFP_ZFCoreMapPrivate::MapType::iterator *, data));
-}
-static void *_ZFP_ZFCoreMap_iteratorCopyCallback(void *data)
-{
-    return zfnew(_ZFP_ZFCoreMapPrivate::MapType::iterator,
-        *ZFCastStatic(_ZFP_ZFCoreMapPrivate::MapType::iterator *, data));
-}
+// iterator holds slot index of ZFCoreHashMap, zfindexMax() for end
 zfiterator ZFCoreMap::iterator(void) const
 {
-    return zfiterator(
-        zfnew(_ZFP_ZFCoreMapPrivate::MapType::iterator, d->m.begin()),
-        _ZFP_ZFCoreMap_iteratorDeleteCallback,
-        _ZFP_ZFCoreMap_iteratorCopyCallback);
+    return zfiterator::iteratorCreate(d->m.indexFirst());
 }
 
 zfiterator ZFCoreMap::iteratorForKey(ZF_IN const zfchar *key) const
 {
-    if(key == zfnull)
-    {
-        key = "";
-    }
-    return zfiterator(
-        zfnew(_ZFP_ZFCoreMapPrivate::MapType::iterator, d->m.find(key)),
-        _ZFP_ZFCoreMap_iteratorDeleteCallback,
-        _ZFP_ZFCoreMap_iteratorCopyCallback);
+    return zfiterator::iteratorCreate(d->m.indexForKey(key));
 }
 
 zfbool ZFCoreMap::iteratorIsValid(ZF_IN const zfiterator &it) const
 {
-    _ZFP_ZFCoreMapPrivate::MapType::iterator *data = it.data<_ZFP_ZFCoreMapPrivate::MapType::iterator *>();
-    return (data != zfnull && *data != d->m.end());
+    zfindex *data = it.data<zfindex *>();
+    return (data != zfnull && *data != zfindexMax());
 }
 zfbool ZFCoreMap::iteratorIsEqual(ZF_IN const zfiterator &it0,
                                   ZF_IN const zfiterator &it1) const
 {
-    return zfiterator::iteratorIsEqual<_ZFP_ZFCoreMapPrivate::MapType::iterator *>(it0, it1);
+    return zfiterator::iteratorIsEqual<zfindex *>(it0, it1);
 }
 
 void ZFCoreMap::iteratorValue(ZF_IN_OUT zfiterator &it,
                               ZF_IN const ZFCorePointerBase &newValue)
 {
-    _ZFP_ZFCoreMapPrivate::MapType::iterator *data = it.data<_ZFP_ZFCoreMapPrivate::MapType::iterator *>();
-    if(data)
+    zfindex *data = it.data<zfindex *>();
+    if(data && *data != zfindexMax())
     {
-        ZFCorePointerBase *toDelete = (*data)->second;
-        (*data)->second = newValue.refNew();
+        ZFCorePointerBase *&v = d->m.valueAt(*data);
+        ZFCorePointerBase *toDelete = v;
+        v = newValue.refNew();
         toDelete->refDelete();
     }
 }
 void ZFCoreMap::iteratorRemove(ZF_IN_OUT zfiterator &it)
 {
-    _ZFP_ZFCoreMapPrivate::MapType::iterator *data = it.data<_ZFP_ZFCoreMapPrivate::MapType::iterator *>();
-    if(data != zfnull)
+    zfindex *data = it.data<zfindex *>();
+    if(data != zfnull && *data != zfindexMax())
     {
-        ZFCorePointerBase *savedValue = (*data)->second;
-        d->m.erase((*data)++);
+        ZFCorePointerBase *savedValue = d->m.valueAt(*data);
+        d->m.removeAt(*data);
+        *data = d->m.indexNext(*data);
         savedValue->refDelete();
     }
 }
 
 const zfchar *ZFCoreMap::iteratorKey(ZF_IN const zfiterator &it) const
 {
-    _ZFP_ZFCoreMapPrivate::MapType::iterator *data = it.data<_ZFP_ZFCoreMapPrivate::MapType::iterator *>();
-    return ((data != zfnull) ? (*data)->first.c_str() : zfnull);
+    zfindex *data = it.data<zfindex *>();
+    return ((data != zfnull && *data != zfindexMax()) ? d->m.keyAt(*data) : zfnull);
 }
 ZFCorePointerBase *ZFCoreMap::iteratorValue(ZF_IN const zfiterator &it) const
 {
-    _ZFP_ZFCoreMapPrivate::MapType::iterator *data = it.data<_ZFP_ZFCoreMapPrivate::MapType::iterator *>();
-    return ((data != zfnull) ? (*data)->second : zfnull);
+    zfindex *data = it.data<zfindex *>();
+    return ((data != zfnull && *data != zfindexMax()) ? d->m.valueAt(*data) : zfnull);
 }
 ZFCoreMapPair ZFCoreMap::iteratorPair(ZF_IN const zfiterator &it) const
 {
-    _ZFP_ZFCoreMapPrivate::MapType::iterator *data = it.data<_ZFP_ZFCoreMapPrivate::MapType::iterator *>();
+    zfindex *data = it.data<zfindex *>();
     ZFCoreMapPair ret = ZFCoreMapPairZero;
-    if(data)
+    if(data != zfnull && *data != zfindexMax())
     {
-        ret.key = (*data)->first.c_str();
-        ret.value = (*data)->second;
+        ret.key = d->m.keyAt(*data);
+        ret.value = d->m.valueAt(*data);
     }
     return ret;
 }
 
 const zfchar *ZFCoreMap::iteratorNextKey(ZF_IN_OUT zfiterator &it) const
 {
-    _ZFP_ZFCoreMapPrivate::MapType::iterator *data = it.data<_ZFP_ZFCoreMapPrivate::MapType::iterator *>();
-    if(data)
-    {
-        const zfchar *ret = (*data)->first.c_str();
-        data->operator ++ ();
-        return ret;
-    }
-    return zfnull;
+    ZFCoreMapPair ret = this->iteratorNextPair(it);
+    return ret.key;
 }
 ZFCorePointerBase *ZFCoreMap::iteratorNextValue(ZF_IN_OUT zfiterator &it) const
 {
-    _ZFP_ZFCoreMapPrivate::MapType::iterator *data = it.data<_ZFP_ZFCoreMapPrivate::MapType::iterator *>();
-    if(data)
-    {
-        ZFCorePointerBase *ret = (*data)->second;
-        data->operator ++ ();
-        return ret;
-    }
-    return zfnull;
+    ZFCoreMapPair ret = this->iteratorNextPair(it);
+    return ret.value;
 }
 ZFCoreMapPair ZFCoreMap::iteratorNextPair(ZF_IN_OUT zfiterator &it) const
 {
     ZFCoreMapPair ret = ZFCoreMapPairZero;
-    _ZFP_ZFCoreMapPrivate::MapType::iterator *data = it.data<_ZFP_ZFCoreMapPrivate::MapType::iterator *>();
-    if(data)
+    zfindex *data = it.data<zfindex *>();
+    if(data != zfnull && *data != zfindexMax())
     {
-        ret.key = (*data)->first.c_str();
-        ret.value = (*data)->second;
-        data->operator ++ ();
+        ret.key = d->m.keyAt(*data);
+        ret.value = d->m.valueAt(*data);
+        *data = d->m.indexNext(*data);
     }
     return ret;
 }
 
 const zfchar *ZFCoreMap::iteratorPrevKey(ZF_IN_OUT zfiterator &it) const
 {
-#if ZF_ENV_ZFCOREMAP_USE_HASHMAP
-    zfCoreCriticalNotSupported();
-#else
-    _ZFP_ZFCoreMapPrivate::MapType::iterator *data = it.data<_ZFP_ZFCoreMapPrivate::MapType::iterator *>();
-    if(data)
-    {
-        const zfchar *ret = (*data)->first;
-        data->operator -- ();
-        return ret;
-    }
-#endif
-    return zfnull;
+    ZFCoreMapPair ret = this->iteratorPrevPair(it);
+    return ret.key;
 }
 ZFCorePointerBase *ZFCoreMap::iteratorPrevValue(ZF_IN_OUT zfiterator &it) const
 {
-#if ZF_ENV_ZFCOREMAP_USE_HASHMAP
-    zfCoreCriticalNotSupported();
-#else
-    _ZFP_ZFCoreMapPrivate::MapType::iterator *data = it.data<_ZFP_ZFCoreMapPrivate::MapType::iterator *>();
-    if(data)
-    {
-        ZFCorePointerBase *ret = (*data)->second;
-        data->operator -- ();
-        return ret;
-    }
-#endif
-    return zfnull;
+    ZFCoreMapPair ret = this->iteratorPrevPair(it);
+    return ret.value;
 }
 ZFCoreMapPair ZFCoreMap::iteratorPrevPair(ZF_IN_OUT zfiterator &it) const
 {
     ZFCoreMapPair ret = ZFCoreMapPairZero;
-#if ZF_ENV_ZFCOREMAP_USE_HASHMAP
-    zfCoreCriticalNotSupported();
-#else
-    _ZFP_ZFCoreMapPrivate::MapType::iterator *data = it.data<_ZFP_ZFCoreMapPrivate::MapType::iterator *>();
-    if(data)
+    zfindex *data = it.data<zfindex *>();
+    if(data != zfnull && *data != zfindexMax())
     {
-        ret.key = (*data)->first;
-        ret.value = (*data)->second;
-        data->operator -- ();
+        ret.key = d->m.keyAt(*data);
+        ret.value = d->m.valueAt(*data);
+        *data = d->m.indexPrev(*data);
     }
-#endif
     return ret;
 }
 
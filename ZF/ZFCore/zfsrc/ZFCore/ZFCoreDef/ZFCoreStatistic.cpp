@@ -1,42 +1,666 @@
 #include "ZFCoreStatistic.h"
 #include "ZFCoreStringUtil.h"
-#include "ZFCoreMap.h"
+#include "ZFCoreArray.h"
+#include "ZFCoreAtomic.h"
+#include "ZFCoreSPrintf.h"
+#include "ZFCoreHashMap.h"
 #include "ZFNamespaceImpl.h"
 
 ZF_NAMESPACE_GLOBAL_BEGIN
 ZF_NAMESPACE_BEGIN(ZFCoreStatistic)
 
-static ZFCoreMap &_ZFP_ZFCoreStatisticDataMap(void)
+#if defined(__GNUC__) || defined(__clang__)
+    #define _ZFP_ZFCoreStatistic_threadLocal __thread
+#elif defined(_MSC_VER)
+    #define _ZFP_ZFCoreStatistic_threadLocal __declspec(thread)
+#endif
+
+// ============================================================
+/*
+ * log-linear buckets:
+ * * value less than (1 << (subBits + 1)) has its own bucket
+ * * others are split into (1 << subBits) buckets for each power of two
+ */
+#define _ZFP_ZFCoreStatistic_subBits 3
+#define _ZFP_ZFCoreStatistic_subCount (1 << _ZFP_ZFCoreStatistic_subBits)
+#define _ZFP_ZFCoreStatistic_linearCount (_ZFP_ZFCoreStatistic_subCount * 2)
+#define _ZFP_ZFCoreStatistic_bucketCount \
+    (_ZFP_ZFCoreStatistic_linearCount + (sizeof(zfindex) * 8 - _ZFP_ZFCoreStatistic_subBits - 1) * _ZFP_ZFCoreStatistic_subCount)
+
+#define _ZFP_ZFCoreStatistic_counterChunkSize 256
+#define _ZFP_ZFCoreStatistic_counterChunkMax 64
+#define _ZFP_ZFCoreStatistic_counterMax (_ZFP_ZFCoreStatistic_counterChunkSize * _ZFP_ZFCoreStatistic_counterChunkMax)
+#define _ZFP_ZFCoreStatistic_histogramMax 1024
+
+static zfindex _ZFP_ZFCoreStatistic_bucketForValue(ZF_IN zfindex v)
+{
+    if(v < _ZFP_ZFCoreStatistic_linearCount)
+    {
+        return v;
+    }
+    zfindex e = 0;
+    for(zfindex t = v; t > 1; t >>= 1)
+    {
+        ++e;
+    }
+    zfindex shift = e - _ZFP_ZFCoreStatistic_subBits;
+    return _ZFP_ZFCoreStatistic_linearCount
+        + (e - _ZFP_ZFCoreStatistic_subBits - 1) * _ZFP_ZFCoreStatistic_subCount
+        + ((v >> shift) & (_ZFP_ZFCoreStatistic_subCount - 1));
+}
+// return the max value that falls into the bucket
+static zfindex _ZFP_ZFCoreStatistic_bucketValue(ZF_IN zfindex bucket)
+{
+    if(bucket < _ZFP_ZFCoreStatistic_linearCount)
+    {
+        return bucket;
+    }
+    zfindex e = (bucket - _ZFP_ZFCoreStatistic_linearCount) / _ZFP_ZFCoreStatistic_subCount + _ZFP_ZFCoreStatistic_subBits + 1;
+    zfindex sub = (bucket - _ZFP_ZFCoreStatistic_linearCount) % _ZFP_ZFCoreStatistic_subCount;
+    zfindex shift = e - _ZFP_ZFCoreStatistic_subBits;
+    return ((_ZFP_ZFCoreStatistic_subCount + sub + 1) << shift) - 1;
+}
+
+// ============================================================
+/*
+ * reset never touches the shards, which would race with the owner thread,
+ * instead, reset increases the epoch of the slot,
+ * shard value with old epoch would be ignored when read,
+ * and cleared by the owner thread when next updated
+ */
+zfclassPOD _ZFP_ZFCoreStatisticCounterShard
+{
+public:
+    zfindex volatile value;
+    zfatomicint epoch;
+};
+zfclassPOD _ZFP_ZFCoreStatisticHistogramShard
+{
+public:
+    zfatomicint epoch;
+    zfindex volatile count;
+    zfindex volatile sum;
+    zfindex volatile min;
+    zfindex volatile max;
+    zfindex volatile buckets[_ZFP_ZFCoreStatistic_bucketCount];
+};
+/*
+ * each thread owns one shard and is the only writer,
+ * readers merge all shards under the global lock,
+ * chunks are lazily allocated and published under the global lock
+ */
+zfclassPOD _ZFP_ZFCoreStatisticShard
+{
+public:
+    _ZFP_ZFCoreStatisticCounterShard *counterChunk[_ZFP_ZFCoreStatistic_counterChunkMax];
+    _ZFP_ZFCoreStatisticHistogramShard *histogram[_ZFP_ZFCoreStatistic_histogramMax];
+};
+
+/*
+ * keys of each namespace, slots of all namespaces are allocated from the same storage,
+ * slot is zfindexMax if the namespace has no such slot type
+ */
+zfclassNotPOD _ZFP_ZFCoreStatisticRegistry
+{
+public:
+    ZFCoreHashMap<zfindex> map; // key to index of keys
+    ZFCoreArray<zfstring> keys;
+    ZFCoreArrayPOD<zfindex> counters;
+    ZFCoreArrayPOD<zfindex> histograms;
+};
+
+zfclassNotPOD _ZFP_ZFCoreStatisticGlobal
 {
-    static ZFCoreMap d;
+public:
+    zfatomicint lock;
+    _ZFP_ZFCoreStatisticRegistry counterRegistry;
+    _ZFP_ZFCoreStatisticRegistry histogramRegistry;
+    _ZFP_ZFCoreStatisticRegistry invokeTimeRegistry;
+    zfindex counterCount;
+    zfindex histogramCount;
+    zfatomicint counterEpoch[_ZFP_ZFCoreStatistic_counterMax];
+    zfatomicint histogramEpoch[_ZFP_ZFCoreStatistic_histogramMax];
+    ZFCoreArrayPOD<_ZFP_ZFCoreStatisticShard *> shards;
+
+public:
+    _ZFP_ZFCoreStatisticGlobal(void)
+    : lock(0)
+    , counterRegistry()
+    , histogramRegistry()
+    , invokeTimeRegistry()
+    , counterCount(0)
+    , histogramCount(0)
+    , shards()
+    {
+        zfmemset((void *)this->counterEpoch, 0, sizeof(this->counterEpoch));
+        zfmemset((void *)this->histogramEpoch, 0, sizeof(this->histogramEpoch));
+    }
+    ~_ZFP_ZFCoreStatisticGlobal(void)
+    {
+        for(zfindex iShard = 0; iShard < this->shards.count(); ++iShard)
+        {
+            _ZFP_ZFCoreStatisticShard *shard = this->shards[iShard];
+            for(zfindex i = 0; i < _ZFP_ZFCoreStatistic_counterChunkMax; ++i)
+            {
+                zffree((void *)shard->counterChunk[i]);
+            }
+            for(zfindex i = 0; i < _ZFP_ZFCoreStatistic_histogramMax; ++i)
+            {
+                zffree(shard->histogram[i]);
+            }
+            zffree(shard);
+        }
+    }
+
+public:
+    _ZFP_ZFCoreStatisticShard *shardCreate(void)
+    {
+        _ZFP_ZFCoreStatisticShard *shard = (_ZFP_ZFCoreStatisticShard *)zfmallocZero(sizeof(_ZFP_ZFCoreStatisticShard));
+        zfAtomicSpinLocker(this->lock);
+        this->shards.add(shard);
+        return shard;
+    }
+    _ZFP_ZFCoreStatisticCounterShard *counterChunkCreate(ZF_IN_OUT _ZFP_ZFCoreStatisticShard *shard, ZF_IN zfindex chunk)
+    {
+        _ZFP_ZFCoreStatisticCounterShard *p = (_ZFP_ZFCoreStatisticCounterShard *)zfmallocZero(sizeof(_ZFP_ZFCoreStatisticCounterShard) * _ZFP_ZFCoreStatistic_counterChunkSize);
+        zfAtomicSpinLocker(this->lock);
+        shard->counterChunk[chunk] = p;
+        return p;
+    }
+    _ZFP_ZFCoreStatisticHistogramShard *histogramCreate(ZF_IN_OUT _ZFP_ZFCoreStatisticShard *shard, ZF_IN zfindex histogram)
+    {
+        _ZFP_ZFCoreStatisticHistogramShard *p = (_ZFP_ZFCoreStatisticHistogramShard *)zfmallocZero(sizeof(_ZFP_ZFCoreStatisticHistogramShard));
+        p->min = zfindexMax();
+        zfAtomicSpinLocker(this->lock);
+        shard->histogram[histogram] = p;
+        return p;
+    }
+
+public:
+    // must be called with lock, return index in registry, or zfindexMax if too many registered
+    zfindex registryAdd(ZF_IN_OUT _ZFP_ZFCoreStatisticRegistry &registry,
+                        ZF_IN const zfchar *key,
+                        ZF_IN zfbool needCounter,
+                        ZF_IN zfbool needHistogram)
+    {
+        zfindex *exist = registry.map.get(key);
+        if(exist != zfnull)
+        {
+            return *exist;
+        }
+        if((needCounter && this->counterCount >= _ZFP_ZFCoreStatistic_counterMax)
+            || (needHistogram && this->histogramCount >= _ZFP_ZFCoreStatistic_histogramMax))
+        {
+            return zfindexMax();
+        }
+        zfindex ret = registry.keys.count();
+        registry.keys.add(key);
+        registry.counters.add(needCounter ? this->counterCount++ : zfindexMax());
+        registry.histograms.add(needHistogram ? this->histogramCount++ : zfindexMax());
+        registry.map.set(key, ret);
+        return ret;
+    }
+
+public:
+    // must be called with lock
+    zfindex counterGet(ZF_IN zfindex counter)
+    {
+        zfindex chunk = counter / _ZFP_ZFCoreStatistic_counterChunkSize;
+        zfindex offset = counter % _ZFP_ZFCoreStatistic_counterChunkSize;
+        zfint epoch = zfAtomicLoad(this->counterEpoch[counter]);
+        zfindex ret = 0;
+        for(zfindex i = 0; i < this->shards.count(); ++i)
+        {
+            _ZFP_ZFCoreStatisticCounterShard *p = this->shards[i]->counterChunk[chunk];
+            if(p != zfnull && zfAtomicLoad(p[offset].epoch) == epoch)
+            {
+                ret += p[offset].value;
+            }
+        }
+        return ret;
+    }
+    // must be called with lock
+    void counterReset(ZF_IN zfindex counter)
+    {
+        zfAtomicIncrease(this->counterEpoch[counter]);
+    }
+    // must be called with lock
+    void histogramGet(ZF_OUT HistogramState &ret, ZF_IN zfindex histogram)
+    {
+        zfmemset(&ret, 0, sizeof(HistogramState));
+        ret.min = zfindexMax();
+        zfindex buckets[_ZFP_ZFCoreStatistic_bucketCount] = {0};
+        zfint epoch = zfAtomicLoad(this->histogramEpoch[histogram]);
+        for(zfindex iShard = 0; iShard < this->shards.count(); ++iShard)
+        {
+            _ZFP_ZFCoreStatisticHistogramShard *p = this->shards[iShard]->histogram[histogram];
+            if(p == zfnull || zfAtomicLoad(p->epoch) != epoch || p->count == 0)
+            {
+                continue;
+            }
+            ret.count += p->count;
+            ret.sum += p->sum;
+            if(p->min < ret.min)
+            {
+                ret.min = p->min;
+            }
+            if(p->max > ret.max)
+            {
+                ret.max = p->max;
+            }
+            for(zfindex i = 0; i < _ZFP_ZFCoreStatistic_bucketCount; ++i)
+            {
+                buckets[i] += p->buckets[i];
+            }
+        }
+        if(ret.count == 0)
+        {
+            ret.min = 0;
+            return;
+        }
+        zfindex *percentiles[] = {&ret.p50, &ret.p90, &ret.p99};
+        zfindex percents[] = {50, 90, 99};
+        zfindex iPercentile = 0;
+        zfindex sum = 0;
+        for(zfindex i = 0; i < _ZFP_ZFCoreStatistic_bucketCount && iPercentile < ZFM_ARRAY_SIZE(percents); ++i)
+        {
+            sum += buckets[i];
+            while(iPercentile < ZFM_ARRAY_SIZE(percents)
+                && sum * 100 >= ret.count * percents[iPercentile]
+                && sum > 0)
+            {
+                zfindex v = _ZFP_ZFCoreStatistic_bucketValue(i);
+                if(v > ret.max)
+                {
+                    v = ret.max;
+                }
+                if(v < ret.min)
+                {
+                    v = ret.min;
+                }
+                *(percentiles[iPercentile]) = v;
+                ++iPercentile;
+            }
+        }
+        for( ; iPercentile < ZFM_ARRAY_SIZE(percents); ++iPercentile)
+        {
+            *(percentiles[iPercentile]) = ret.max;
+        }
+    }
+    // must be called with lock
+    void histogramReset(ZF_IN zfindex histogram)
+    {
+        zfAtomicIncrease(this->histogramEpoch[histogram]);
+    }
+};
+static _ZFP_ZFCoreStatisticGlobal &_ZFP_ZFCoreStatisticGlobalData(void)
+{
+    static _ZFP_ZFCoreStatisticGlobal d;
     return d;
 }
 
-void invokeCountLog(ZF_IN const zfchar *key)
+#ifdef _ZFP_ZFCoreStatistic_threadLocal
+static _ZFP_ZFCoreStatistic_threadLocal _ZFP_ZFCoreStatisticShard *_ZFP_ZFCoreStatisticShardLocal = zfnull;
+static inline _ZFP_ZFCoreStatisticShard *_ZFP_ZFCoreStatisticShardForCurrentThread(void)
+{
+    if(_ZFP_ZFCoreStatisticShardLocal == zfnull)
+    {
+        _ZFP_ZFCoreStatisticShardLocal = _ZFP_ZFCoreStatisticGlobalData().shardCreate();
+    }
+    return _ZFP_ZFCoreStatisticShardLocal;
+}
+#define _ZFP_ZFCoreStatisticShardLocker()
+#else
+// no thread local storage, all threads share one shard and update it with lock
+static _ZFP_ZFCoreStatisticShard *_ZFP_ZFCoreStatisticShardForCurrentThread(void)
+{
+    static _ZFP_ZFCoreStatisticShard *shard = _ZFP_ZFCoreStatisticGlobalData().shardCreate();
+    return shard;
+}
+static zfatomicint _ZFP_ZFCoreStatisticShardLock = 0;
+#define _ZFP_ZFCoreStatisticShardLocker() zfAtomicSpinLocker(_ZFP_ZFCoreStatisticShardLock)
+#endif
+
+// ============================================================
+// register key to counter or histogram registry, return the slot
+static zfindex _ZFP_ZFCoreStatisticRegister(ZF_IN_OUT _ZFP_ZFCoreStatisticRegistry &registry,
+                                            ZF_IN zfbool isCounter,
+                                            ZF_IN const zfchar *key)
+{
+    if(key == zfnull)
+    {
+        key = "";
+    }
+    _ZFP_ZFCoreStatisticGlobal &d = _ZFP_ZFCoreStatisticGlobalData();
+    zfAtomicSpinLocker(d.lock);
+    zfindex index = d.registryAdd(registry, key, isCounter, !isCounter);
+    if(index == zfindexMax())
+    {
+        return zfindexMax();
+    }
+    return (isCounter ? registry.counters[index] : registry.histograms[index]);
+}
+static zfindex _ZFP_ZFCoreStatisticFind(ZF_IN _ZFP_ZFCoreStatisticRegistry &registry,
+                                        ZF_IN zfbool isCounter,
+                                        ZF_IN const zfchar *key)
 {
-    ZFCoreMap &m = _ZFP_ZFCoreStatisticDataMap();
-    zfindex *count = m.get<zfindex *>(key);
-    if(count != zfnull)
+    if(key == zfnull)
     {
-        ++(*count);
+        key = "";
     }
-    else
+    zfAtomicSpinLocker(_ZFP_ZFCoreStatisticGlobalData().lock);
+    zfindex *index = registry.map.get(key);
+    if(index == zfnull)
     {
-        m.set(key, ZFCorePointerForObject<zfindex *>(zfnew(zfindex, 1)));
+        return zfindexMax();
     }
+    return (isCounter ? registry.counters[*index] : registry.histograms[*index]);
+}
+
+// ============================================================
+zfindex counterRegister(ZF_IN const zfchar *key)
+{
+    return _ZFP_ZFCoreStatisticRegister(_ZFP_ZFCoreStatisticGlobalData().counterRegistry, zftrue, key);
+}
+zfindex counterFind(ZF_IN const zfchar *key)
+{
+    return _ZFP_ZFCoreStatisticFind(_ZFP_ZFCoreStatisticGlobalData().counterRegistry, zftrue, key);
+}
+void counterAdd(ZF_IN zfindex counter,
+                ZF_IN_OPT zfindex value /* = 1 */)
+{
+    if(counter >= _ZFP_ZFCoreStatistic_counterMax)
+    {
+        return;
+    }
+    _ZFP_ZFCoreStatisticGlobal &d = _ZFP_ZFCoreStatisticGlobalData();
+    _ZFP_ZFCoreStatisticShard *shard = _ZFP_ZFCoreStatisticShardForCurrentThread();
+    zfindex chunk = counter / _ZFP_ZFCoreStatistic_counterChunkSize;
+    _ZFP_ZFCoreStatisticCounterShard *p = shard->counterChunk[chunk];
+    if(p == zfnull)
+    {
+        p = d.counterChunkCreate(shard, chunk);
+    }
+    zfint epoch = zfAtomicLoad(d.counterEpoch[counter]);
+    _ZFP_ZFCoreStatisticShardLocker();
+    p += counter % _ZFP_ZFCoreStatistic_counterChunkSize;
+    if(p->epoch != epoch)
+    {
+        // reset since last update, clear before publishing the new epoch
+        p->value = 0;
+        zfAtomicStore(p->epoch, epoch);
+    }
+    p->value += value;
+}
+zfindex counterGet(ZF_IN zfindex counter)
+{
+    if(counter >= _ZFP_ZFCoreStatistic_counterMax)
+    {
+        return 0;
+    }
+    _ZFP_ZFCoreStatisticGlobal &d = _ZFP_ZFCoreStatisticGlobalData();
+    zfAtomicSpinLocker(d.lock);
+    return d.counterGet(counter);
+}
+void counterReset(ZF_IN zfindex counter)
+{
+    if(counter >= _ZFP_ZFCoreStatistic_counterMax)
+    {
+        return;
+    }
+    _ZFP_ZFCoreStatisticGlobal &d = _ZFP_ZFCoreStatisticGlobalData();
+    zfAtomicSpinLocker(d.lock);
+    d.counterReset(counter);
+}
+
+// ============================================================
+zfindex histogramRegister(ZF_IN const zfchar *key)
+{
+    return _ZFP_ZFCoreStatisticRegister(_ZFP_ZFCoreStatisticGlobalData().histogramRegistry, zffalse, key);
+}
+zfindex histogramFind(ZF_IN const zfchar *key)
+{
+    return _ZFP_ZFCoreStatisticFind(_ZFP_ZFCoreStatisticGlobalData().histogramRegistry, zffalse, key);
+}
+void histogramRecord(ZF_IN zfindex histogram,
+                     ZF_IN zfindex value)
+{
+    if(histogram >= _ZFP_ZFCoreStatistic_histogramMax)
+    {
+        return;
+    }
+    _ZFP_ZFCoreStatisticGlobal &d = _ZFP_ZFCoreStatisticGlobalData();
+    _ZFP_ZFCoreStatisticShard *shard = _ZFP_ZFCoreStatisticShardForCurrentThread();
+    _ZFP_ZFCoreStatisticHistogramShard *p = shard->histogram[histogram];
+    if(p == zfnull)
+    {
+        p = d.histogramCreate(shard, histogram);
+    }
+    zfint epoch = zfAtomicLoad(d.histogramEpoch[histogram]);
+    _ZFP_ZFCoreStatisticShardLocker();
+    if(p->epoch != epoch)
+    {
+        // reset since last update, clear before publishing the new epoch
+        p->count = 0;
+        p->sum = 0;
+        p->min = zfindexMax();
+        p->max = 0;
+        for(zfindex i = 0; i < _ZFP_ZFCoreStatistic_bucketCount; ++i)
+        {
+            p->buckets[i] = 0;
+        }
+        zfAtomicStore(p->epoch, epoch);
+    }
+    ++(p->count);
+    p->sum += value;
+    if(value < p->min)
+    {
+        p->min = value;
+    }
+    if(value > p->max)
+    {
+        p->max = value;
+    }
+    ++(p->buckets[_ZFP_ZFCoreStatistic_bucketForValue(value)]);
+}
+void histogramGet(ZF_OUT HistogramState &ret,
+                  ZF_IN zfindex histogram)
+{
+    if(histogram >= _ZFP_ZFCoreStatistic_histogramMax)
+    {
+        zfmemset(&ret, 0, sizeof(HistogramState));
+        return;
+    }
+    _ZFP_ZFCoreStatisticGlobal &d = _ZFP_ZFCoreStatisticGlobalData();
+    zfAtomicSpinLocker(d.lock);
+    d.histogramGet(ret, histogram);
+}
+void histogramReset(ZF_IN zfindex histogram)
+{
+    if(histogram >= _ZFP_ZFCoreStatistic_histogramMax)
+    {
+        return;
+    }
+    _ZFP_ZFCoreStatisticGlobal &d = _ZFP_ZFCoreStatisticGlobalData();
+    zfAtomicSpinLocker(d.lock);
+    d.histogramReset(histogram);
+}
+
+// ============================================================
+void statisticResetAll(void)
+{
+    _ZFP_ZFCoreStatisticGlobal &d = _ZFP_ZFCoreStatisticGlobalData();
+    zfAtomicSpinLocker(d.lock);
+    for(zfindex i = 0; i < d.counterCount; ++i)
+    {
+        d.counterReset(i);
+    }
+    for(zfindex i = 0; i < d.histogramCount; ++i)
+    {
+        d.histogramReset(i);
+    }
+}
+
+static void _ZFP_ZFCoreStatisticExportKey(ZF_IN_OUT zfstring &ret, ZF_IN const zfchar *key)
+{
+    ret += '"';
+    for(const zfchar *p = key; *p != '\0'; ++p)
+    {
+        switch(*p)
+        {
+            case '"':
+                ret += "\\\"";
+                break;
+            case '\\':
+                ret += "\\\\";
+                break;
+            case '\n':
+                ret += "\\n";
+                break;
+            case '\r':
+                ret += "\\r";
+                break;
+            case '\t':
+                ret += "\\t";
+                break;
+            default:
+                if((zfbyte)*p < 0x20)
+                {
+                    zfstringAppend(ret, "\\u%04x", (zfuint)(zfbyte)*p);
+                }
+                else
+                {
+                    ret += *p;
+                }
+                break;
+        }
+    }
+    ret += '"';
+}
+static void _ZFP_ZFCoreStatisticExportHistogram(ZF_IN_OUT zfstring &ret, ZF_IN const HistogramState &state)
+{
+    zfstringAppend(ret, "\"count\": %zi, \"sum\": %zi, \"min\": %zi, \"max\": %zi, \"p50\": %zi, \"p90\": %zi, \"p99\": %zi}",
+        state.count,
+        state.sum,
+        state.min,
+        state.max,
+        state.p50,
+        state.p90,
+        state.p99);
+}
+void statisticExport(ZF_IN_OUT zfstring &ret)
+{
+    _ZFP_ZFCoreStatisticGlobal &d = _ZFP_ZFCoreStatisticGlobalData();
+    zfAtomicSpinLocker(d.lock);
+    HistogramState state;
+
+    const _ZFP_ZFCoreStatisticRegistry &counters = d.counterRegistry;
+    ret += "{\n    \"counters\": {";
+    for(zfindex i = 0; i < counters.keys.count(); ++i)
+    {
+        ret += ((i == 0) ? "\n        " : ",\n        ");
+        _ZFP_ZFCoreStatisticExportKey(ret, counters.keys[i]);
+        zfstringAppend(ret, ": %zi", d.counterGet(counters.counters[i]));
+    }
+    ret += ((counters.keys.count() == 0) ? "},\n" : "\n    },\n");
+
+    const _ZFP_ZFCoreStatisticRegistry &histograms = d.histogramRegistry;
+    ret += "    \"histograms\": {";
+    for(zfindex i = 0; i < histograms.keys.count(); ++i)
+    {
+        d.histogramGet(state, histograms.histograms[i]);
+        ret += ((i == 0) ? "\n        " : ",\n        ");
+        _ZFP_ZFCoreStatisticExportKey(ret, histograms.keys[i]);
+        ret += ": {";
+        _ZFP_ZFCoreStatisticExportHistogram(ret, state);
+    }
+    ret += ((histograms.keys.count() == 0) ? "},\n" : "\n    },\n");
+
+    const _ZFP_ZFCoreStatisticRegistry &invokeTimes = d.invokeTimeRegistry;
+    ret += "    \"invokeTimes\": {";
+    for(zfindex i = 0; i < invokeTimes.keys.count(); ++i)
+    {
+        d.histogramGet(state, invokeTimes.histograms[i]);
+        ret += ((i == 0) ? "\n        " : ",\n        ");
+        _ZFP_ZFCoreStatisticExportKey(ret, invokeTimes.keys[i]);
+        zfstringAppend(ret, ": {\"invokeCount\": %zi, ", d.counterGet(invokeTimes.counters[i]));
+        _ZFP_ZFCoreStatisticExportHistogram(ret, state);
+    }
+    ret += ((invokeTimes.keys.count() == 0) ? "}\n" : "\n    }\n");
+    ret += "}";
+}
+
+// ============================================================
+void invokeCountLog(ZF_IN const zfchar *key)
+{
+    counterAdd(counterRegister(key));
 }
 void invokeCountRemove(ZF_IN const zfchar *key)
 {
-    _ZFP_ZFCoreStatisticDataMap().remove(key);
+    counterReset(counterFind(key));
 }
 void invokeCountRemoveAll(void)
 {
-    _ZFP_ZFCoreStatisticDataMap().removeAll();
+    _ZFP_ZFCoreStatisticGlobal &d = _ZFP_ZFCoreStatisticGlobalData();
+    zfAtomicSpinLocker(d.lock);
+    for(zfindex i = 0; i < d.counterRegistry.counters.count(); ++i)
+    {
+        d.counterReset(d.counterRegistry.counters[i]);
+    }
 }
 zfindex invokeCountGet(ZF_IN const zfchar *key)
 {
-    zfindex *count = _ZFP_ZFCoreStatisticDataMap().get<zfindex *>(key);
-    return ((count != zfnull) ? *count : 0);
+    return counterGet(counterFind(key));
+}
+
+// ============================================================
+zfbool _ZFP_ZFCoreStatisticInvokeTimeRegister(ZF_OUT zfindex &counter,
+                                              ZF_OUT zfindex &histogram,
+                                              ZF_IN const zfchar *key)
+{
+    if(key == zfnull)
+    {
+        key = "";
+    }
+    _ZFP_ZFCoreStatisticGlobal &d = _ZFP_ZFCoreStatisticGlobalData();
+    zfAtomicSpinLocker(d.lock);
+    zfindex index = d.registryAdd(d.invokeTimeRegistry, key, zftrue, zftrue);
+    if(index == zfindexMax())
+    {
+        return zffalse;
+    }
+    counter = d.invokeTimeRegistry.counters[index];
+    histogram = d.invokeTimeRegistry.histograms[index];
+    return zftrue;
+}
+zfbool _ZFP_ZFCoreStatisticInvokeTimeFind(ZF_OUT zfindex &counter,
+                                          ZF_OUT zfindex &histogram,
+                                          ZF_IN const zfchar *key)
+{
+    if(key == zfnull)
+    {
+        key = "";
+    }
+    _ZFP_ZFCoreStatisticGlobal &d = _ZFP_ZFCoreStatisticGlobalData();
+    zfAtomicSpinLocker(d.lock);
+    zfindex *index = d.invokeTimeRegistry.map.get(key);
+    if(index == zfnull)
+    {
+        return zffalse;
+    }
+    counter = d.invokeTimeRegistry.counters[*index];
+    histogram = d.invokeTimeRegistry.histograms[*index];
+    return zftrue;
+}
+void _ZFP_ZFCoreStatisticInvokeTimeResetAll(void)
+{
+    _ZFP_ZFCoreStatisticGlobal &d = _ZFP_ZFCoreStatisticGlobalData();
+    zfAtomicSpinLocker(d.lock);
+    for(zfindex i = 0; i < d.invokeTimeRegistry.keys.count(); ++i)
+    {
+        d.counterReset(d.invokeTimeRegistry.counters[i]);
+        d.histogramReset(d.invokeTimeRegistry.histograms[i]);
+    }
 }
 
 ZF_NAMESPACE_END_WITH_REGISTER(ZFCoreStatistic, ZF_NAMESPACE_GLOBAL)
@@ -11,6 +11,125 @@
 ZF_NAMESPACE_GLOBAL_BEGIN
 ZF_NAMESPACE_BEGIN(ZFCoreStatistic)
 
+// ============================================================
+// counter
+/**
+ * @brief register a counter and return its handle
+ *
+ * counters and histograms are designed for hot path statistic,
+ * which can be used in production build, usage:
+ * @code
+ *   // register once, typically as static or global
+ *   static zfindex counter = ZFCoreStatistic::counterRegister("yourKey");
+ *
+ *   // in hot path, lock free and thread-safe
+ *   ZFCoreStatistic::counterAdd(counter);
+ *
+ *   // read or export at any time
+ *   zfindex count = ZFCoreStatistic::counterGet(counter);
+ * @endcode
+ *
+ * registering the same key more than once results the same handle,
+ * handles remain valid until the app terminates\n
+ * \n
+ * each thread updates its own shard without any lock,
+ * shards would be merged when read,
+ * null key would be treated as empty string,
+ * return zfindexMax() if too many counters registered
+ */
+extern ZF_ENV_EXPORT zfindex counterRegister(ZF_IN const zfchar *key);
+/** @brief find counter registered by #counterRegister, return zfindexMax() if not found */
+extern ZF_ENV_EXPORT zfindex counterFind(ZF_IN const zfchar *key);
+/** @brief see #counterRegister */
+extern ZF_ENV_EXPORT void counterAdd(ZF_IN zfindex counter,
+                                     ZF_IN_OPT zfindex value = 1);
+/** @brief see #counterRegister */
+extern ZF_ENV_EXPORT zfindex counterGet(ZF_IN zfindex counter);
+/**
+ * @brief reset the counter to 0
+ *
+ * reset never writes to other thread's shard,
+ * values added by other threads during reset may be lost
+ */
+extern ZF_ENV_EXPORT void counterReset(ZF_IN zfindex counter);
+
+// ============================================================
+// histogram
+/**
+ * @brief summary of #histogramRecord
+ *
+ * percentiles are calculated from log-linear buckets,
+ * values less than 16 are exact,
+ * others have a relative error less than 1/8
+ */
+zfclassPOD ZF_ENV_EXPORT HistogramState
+{
+public:
+    zfindex count; /**< @brief recorded count */
+    zfindex sum; /**< @brief sum of all recorded value */
+    zfindex min; /**< @brief min recorded value, 0 if empty */
+    zfindex max; /**< @brief max recorded value, 0 if empty */
+    zfindex p50; /**< @brief 50th percentile */
+    zfindex p90; /**< @brief 90th percentile */
+    zfindex p99; /**< @brief 99th percentile */
+};
+/**
+ * @brief register a histogram and return its handle, see #counterRegister
+ *
+ * the unit of recorded value is decided by the caller,
+ * typically micro seconds for latency
+ */
+extern ZF_ENV_EXPORT zfindex histogramRegister(ZF_IN const zfchar *key);
+/** @brief find histogram registered by #histogramRegister, return zfindexMax() if not found */
+extern ZF_ENV_EXPORT zfindex histogramFind(ZF_IN const zfchar *key);
+/** @brief see #histogramRegister */
+extern ZF_ENV_EXPORT void histogramRecord(ZF_IN zfindex histogram,
+                                          ZF_IN zfindex value);
+/** @brief see #histogramRegister */
+extern ZF_ENV_EXPORT void histogramGet(ZF_OUT HistogramState &ret,
+                                       ZF_IN zfindex histogram);
+/** @brief see #histogramRegister */
+inline HistogramState histogramGet(ZF_IN zfindex histogram)
+{
+    HistogramState ret;
+    ZFCoreStatistic::histogramGet(ret, histogram);
+    return ret;
+}
+/** @brief reset the histogram, see #counterReset */
+extern ZF_ENV_EXPORT void histogramReset(ZF_IN zfindex histogram);
+
+// ============================================================
+/** @brief reset all counters and histograms, including those of #ZFCoreStatistic::invokeTimeLogBegin */
+extern ZF_ENV_EXPORT void statisticResetAll(void);
+/**
+ * @brief export all counters, histograms and invoke times as JSON
+ *
+ * format:
+ * @code
+ *   {
+ *       "counters": {
+ *           "key": 123
+ *       },
+ *       "histograms": {
+ *           "key": {"count": 1, "sum": 2, "min": 2, "max": 2, "p50": 2, "p90": 2, "p99": 2}
+ *       },
+ *       "invokeTimes": {
+ *           "key": {"invokeCount": 2, "count": 1, "sum": 2, "min": 2, "max": 2, "p50": 2, "p90": 2, "p99": 2}
+ *       }
+ *   }
+ * @endcode
+ */
+extern ZF_ENV_EXPORT void statisticExport(ZF_IN_OUT zfstring &ret);
+/** @brief see #statisticExport */
+inline zfstring statisticExport(void)
+{
+    zfstring ret;
+    ZFCoreStatistic::statisticExport(ret);
+    return ret;
+}
+
+// ============================================================
+// invoke count
 /** @brief see #ZFCoreStatistic::invokeCountGet */
 extern ZF_ENV_EXPORT void invokeCountLog(ZF_IN const zfchar *key);
 /** @brief see #ZFCoreStatistic::invokeCountGet */
@@ -34,10 +153,22 @@ extern ZF_ENV_EXPORT void invokeCountRemoveAll(void);
  *       ZFCoreStatistic::invokeCountReset(yourKeyOrNull);
  *   }
  * @endcode
- * @note this method is not thread-safe
+ * @note this method is thread-safe, but looks up the key each time,
+ *   use #counterRegister for hot path
  */
 extern ZF_ENV_EXPORT zfindex invokeCountGet(ZF_IN const zfchar *key);
 
+/** @cond ZFPrivateDoc */
+// invoke time log has its own keys, separated from counters and histograms
+extern ZF_ENV_EXPORT zfbool _ZFP_ZFCoreStatisticInvokeTimeRegister(ZF_OUT zfindex &counter,
+                                                                   ZF_OUT zfindex &histogram,
+                                                                   ZF_IN const zfchar *key);
+extern ZF_ENV_EXPORT zfbool _ZFP_ZFCoreStatisticInvokeTimeFind(ZF_OUT zfindex &counter,
+                                                               ZF_OUT zfindex &histogram,
+                                                               ZF_IN const zfchar *key);
+extern ZF_ENV_EXPORT void _ZFP_ZFCoreStatisticInvokeTimeResetAll(void);
+/** @endcond */
+
 ZF_NAMESPACE_END(ZFCoreStatistic)
 ZF_NAMESPACE_GLOBAL_END
 
@@ -16,6 +16,154 @@ enum {
 };
 #define _ZFP_zfstr_dynamicBuf ((zfuint)-1)
 
+// ============================================================
+// ============================================================
+template<typename T_Char>
+zfclassFwd _zfstr;
+/**
+ * @brief non-owning string view, hold only pointer and length of another string
+ *
+ * designed for APIs that only read the string,
+ * the referenced string must be alive and not modified
+ * during the view's lifetime\n
+ * \n
+ * unlike #_zfstr, the view is not ensured to be null-terminated,
+ * use #data and #length to access its content
+ */
+template<typename T_Char>
+zfclassLikePOD ZF_ENV_EXPORT _zfstrView
+{
+public:
+    /** @brief construct an empty view */
+    _zfstrView(void)
+    : _s(zfnull)
+    , _len(0)
+    {
+    }
+    /** @brief view of a null-terminated string, null would be treated as empty */
+    _zfstrView(ZF_IN const T_Char *s)
+    : _s(s)
+    , _len(0)
+    {
+        if(s)
+        {
+            const T_Char *p = s;
+            while(*p) {++p;}
+            _len = p - s;
+        }
+    }
+    /** @brief view of part of string, len can be zfindexMax() to calculate automatically */
+    _zfstrView(ZF_IN const T_Char *s, ZF_IN zfindex len)
+    : _s(s)
+    , _len(0)
+    {
+        if(s)
+        {
+            if(len == zfindexMax())
+            {
+                const T_Char *p = s;
+                while(*p) {++p;}
+                len = p - s;
+            }
+            _len = len;
+        }
+    }
+    /** @brief view of a #_zfstr */
+    _zfstrView(ZF_IN const _zfstr<T_Char> &s);
+
+public:
+    /** @cond ZFPrivateDoc */
+    template<typename T_Index>
+    inline const T_Char &operator [] (ZF_IN T_Index const &pos) const
+    {
+        return _s[pos];
+    }
+    zfbool operator == (ZF_IN const _zfstrView &ref) const
+    {
+        return (_len == ref._len && this->compare(ref) == 0);
+    }
+    zfbool operator != (ZF_IN const _zfstrView &ref) const
+    {
+        return !this->operator == (ref);
+    }
+    zfbool operator < (ZF_IN const _zfstrView &ref) const
+    {
+        return (this->compare(ref) < 0);
+    }
+    /** @endcond */
+
+public:
+    /** @brief pointer to the string, not ensured to be null-terminated */
+    inline const T_Char *data(void) const
+    {
+        return _s;
+    }
+    /** @brief length of the string */
+    inline zfindex length(void) const
+    {
+        return _len;
+    }
+    /** @brief true if empty */
+    inline zfbool isEmpty(void) const
+    {
+        return _len == 0;
+    }
+
+public:
+    /** @brief compare with another string */
+    zfint compare(ZF_IN const _zfstrView &ref) const
+    {
+        zfindex len = (_len < ref._len) ? _len : ref._len;
+        for(zfindex i = 0; i < len; ++i)
+        {
+            if(_s[i] != ref._s[i])
+            {
+                return (zfint)_s[i] - (zfint)ref._s[i];
+            }
+        }
+        return (_len == ref._len) ? 0 : ((_len < ref._len) ? -1 : 1);
+    }
+    /** @brief part of the view, no copy would be performed */
+    _zfstrView subView(ZF_IN zfindex pos, ZF_IN_OPT zfindex len = zfindexMax()) const
+    {
+        if(pos >= _len)
+        {
+            return _zfstrView();
+        }
+        if(len > _len - pos)
+        {
+            len = _len - pos;
+        }
+        return _zfstrView(_s + pos, len);
+    }
+    /** @brief find char, return zfindexMax() if not found */
+    zfindex find(ZF_IN T_Char c, ZF_IN_OPT zfindex pos = 0) const
+    {
+        for( ; pos < _len; ++pos)
+        {
+            if(_s[pos] == c)
+            {
+                return pos;
+            }
+        }
+        return zfindexMax();
+    }
+    /** @brief whether begin with the string */
+    zfbool beginWith(ZF_IN const _zfstrView &ref) const
+    {
+        return (ref._len <= _len && this->subView(0, ref._len).compare(ref) == 0);
+    }
+    /** @brief whether end with the string */
+    zfbool endWith(ZF_IN const _zfstrView &ref) const
+    {
+        return (ref._len <= _len && this->subView(_len - ref._len).compare(ref) == 0);
+    }
+
+private:
+    const T_Char *_s;
+    zfindex _len;
+};
+
 // ============================================================
 /** @cond ZFPrivateDoc */
 template<typename T_Char>
@@ -149,6 +297,15 @@ public:
             _updateLength(len);
         }
     }
+    /** @brief copy content from string view */
+    _zfstr(ZF_IN const _zfstrView<T_Char> &s)
+    : d()
+    {
+        T_Char *buf = _capacityRequire(s.length());
+        zfmemcpy(buf, s.data(), s.length() * sizeof(T_Char));
+        buf[s.length()] = '\0';
+        _updateLength(s.length());
+    }
     ~_zfstr(void)
     {
         if(d.length == _ZFP_zfstr_dynamicBuf)
@@ -251,6 +408,8 @@ public:
     /** @brief append string */
     inline _zfstr &append(ZF_IN const T_Char *s) {return this->append(s, zfindexMax());}
     /** @brief append string */
+    inline _zfstr &append(ZF_IN const _zfstrView<T_Char> &s) {return this->append(s.data(), s.length());}
+    /** @brief append string */
     _zfstr &append(ZF_IN const T_Char *s, ZF_IN zfindex len)
     {
         if(s)
@@ -275,6 +434,8 @@ public:
     /** @brief replace all content of the string */
     inline _zfstr &assign(ZF_IN const T_Char *s) {return this->assign(s, zfindexMax());}
     /** @brief replace all content of the string */
+    inline _zfstr &assign(ZF_IN const _zfstrView<T_Char> &s) {return this->assign(s.data(), s.length());}
+    /** @brief replace all content of the string */
     _zfstr &assign(ZF_IN const T_Char *s, ZF_IN zfindex len)
     {
         if(s)
@@ -540,6 +701,16 @@ private:
     }
 };
 
+// ============================================================
+/** @cond ZFPrivateDoc */
+template<typename T_Char>
+inline _zfstrView<T_Char>::_zfstrView(ZF_IN const _zfstr<T_Char> &s)
+: _s(s.cString())
+, _len(s.length())
+{
+}
+/** @endcond */
+
 ZF_NAMESPACE_GLOBAL_END
 
 #endif // #ifndef _ZFI_ZFCoreString_h_
@@ -0,0 +1,186 @@
+#include "ZFCoreStringAtom.h"
+#include "ZFCoreAtomic.h"
+#include "ZFIdentityUtil.h"
+
+ZF_NAMESPACE_GLOBAL_BEGIN
+
+// ============================================================
+/*
+ * strings are split into shards by hash, each shard has its own lock and hash table,
+ * string data are allocated from chunks and never freed
+ */
+#define _ZFP_zfstringAtom_shardBits 5
+#define _ZFP_zfstringAtom_shardCount (1 << _ZFP_zfstringAtom_shardBits)
+#define _ZFP_zfstringAtom_bucketInit 64
+#define _ZFP_zfstringAtom_chunkSize 4096
+
+zfclassNotPOD _ZFP_zfstringAtomShard
+{
+public:
+    zfatomicint lock;
+    _ZFP_zfstringAtomData **buckets;
+    zfindex bucketCount;
+    zfindex count;
+    zfbyte *chunk;
+    zfindex chunkUsed;
+
+public:
+    _ZFP_zfstringAtomShard(void)
+    : lock(0)
+    , buckets((_ZFP_zfstringAtomData **)zfmallocZero(sizeof(_ZFP_zfstringAtomData *) * _ZFP_zfstringAtom_bucketInit))
+    , bucketCount(_ZFP_zfstringAtom_bucketInit)
+    , count(0)
+    , chunk(zfnull)
+    , chunkUsed(0)
+    {
+    }
+
+public:
+    // must be called with lock
+    _ZFP_zfstringAtomData *find(ZF_IN const zfchar *src,
+                                ZF_IN zfindex srcLen,
+                                ZF_IN zfidentity hash) const
+    {
+        for(_ZFP_zfstringAtomData *p = this->buckets[_bucketIndex(hash, this->bucketCount)]; p != zfnull; p = p->next)
+        {
+            if(p->hash == hash
+                && p->length == srcLen
+                && zfmemcmp(p + 1, src, srcLen * sizeof(zfchar)) == 0
+                )
+            {
+                return p;
+            }
+        }
+        return zfnull;
+    }
+    // must be called with lock
+    _ZFP_zfstringAtomData *add(ZF_IN const zfchar *src,
+                               ZF_IN zfindex srcLen,
+                               ZF_IN zfidentity hash)
+    {
+        if(this->count >= this->bucketCount)
+        {
+            this->rehash(this->bucketCount * 2);
+        }
+        _ZFP_zfstringAtomData *p = (_ZFP_zfstringAtomData *)this->alloc(sizeof(_ZFP_zfstringAtomData) + (srcLen + 1) * sizeof(zfchar));
+        p->hash = hash;
+        p->length = srcLen;
+        zfchar *buf = (zfchar *)(p + 1);
+        zfmemcpy(buf, src, srcLen * sizeof(zfchar));
+        buf[srcLen] = '\0';
+        _ZFP_zfstringAtomData *&head = this->buckets[_bucketIndex(hash, this->bucketCount)];
+        p->next = head;
+        head = p;
+        ++(this->count);
+        return p;
+    }
+
+private:
+    static inline zfindex _bucketIndex(ZF_IN zfidentity hash, ZF_IN zfindex bucketCount)
+    {
+        return (zfindex)(hash >> _ZFP_zfstringAtom_shardBits) & (bucketCount - 1);
+    }
+    void rehash(ZF_IN zfindex bucketCount)
+    {
+        _ZFP_zfstringAtomData **buckets = (_ZFP_zfstringAtomData **)zfmallocZero(sizeof(_ZFP_zfstringAtomData *) * bucketCount);
+        for(zfindex i = 0; i < this->bucketCount; ++i)
+        {
+            _ZFP_zfstringAtomData *p = this->buckets[i];
+            while(p != zfnull)
+            {
+                _ZFP_zfstringAtomData *next = p->next;
+                _ZFP_zfstringAtomData *&head = buckets[_bucketIndex(p->hash, bucketCount)];
+                p->next = head;
+                head = p;
+                p = next;
+            }
+        }
+        zffree(this->buckets);
+        this->buckets = buckets;
+        this->bucketCount = bucketCount;
+    }
+    void *alloc(ZF_IN zfindex size)
+    {
+        size = (size + sizeof(void *) - 1) & ~(sizeof(void *) - 1);
+        if(size > _ZFP_zfstringAtom_chunkSize / 4)
+        {
+            return zfmalloc(size);
+        }
+        if(this->chunk == zfnull || this->chunkUsed + size > _ZFP_zfstringAtom_chunkSize)
+        {
+            this->chunk = (zfbyte *)zfmalloc(_ZFP_zfstringAtom_chunkSize);
+            this->chunkUsed = 0;
+        }
+        void *ret = this->chunk + this->chunkUsed;
+        this->chunkUsed += size;
+        return ret;
+    }
+};
+
+// atoms must remain valid during static destruction, so the table is never freed
+static _ZFP_zfstringAtomShard *_ZFP_zfstringAtomShards(void)
+{
+    static _ZFP_zfstringAtomShard *d = zfnew(_ZFP_zfstringAtomShard[_ZFP_zfstringAtom_shardCount]);
+    return d;
+}
+static inline zfidentity _ZFP_zfstringAtomHash(ZF_IN const zfchar *src, ZF_IN zfindex srcLen)
+{
+    return zfidentityCalcString(src, srcLen);
+}
+static inline _ZFP_zfstringAtomShard &_ZFP_zfstringAtomShardFor(ZF_IN zfidentity hash)
+{
+    return _ZFP_zfstringAtomShards()[(hash ^ (hash >> 16)) & (_ZFP_zfstringAtom_shardCount - 1)];
+}
+
+// ============================================================
+zfstringAtom zfstringAtomFor(ZF_IN const zfchar *src,
+                             ZF_IN_OPT zfindex srcLen /* = zfindexMax() */)
+{
+    if(src == zfnull)
+    {
+        return zfstringAtom();
+    }
+    if(srcLen == zfindexMax())
+    {
+        srcLen = zfslen(src);
+    }
+    zfidentity hash = _ZFP_zfstringAtomHash(src, srcLen);
+    _ZFP_zfstringAtomShard &shard = _ZFP_zfstringAtomShardFor(hash);
+    zfAtomicSpinLocker(shard.lock);
+    _ZFP_zfstringAtomData *p = shard.find(src, srcLen, hash);
+    if(p == zfnull)
+    {
+        p = shard.add(src, srcLen, hash);
+    }
+    return zfstringAtom(p);
+}
+zfstringAtom zfstringAtomFind(ZF_IN const zfchar *src,
+                              ZF_IN_OPT zfindex srcLen /* = zfindexMax() */)
+{
+    if(src == zfnull)
+    {
+        return zfstringAtom();
+    }
+    if(srcLen == zfindexMax())
+    {
+        srcLen = zfslen(src);
+    }
+    zfidentity hash = _ZFP_zfstringAtomHash(src, srcLen);
+    _ZFP_zfstringAtomShard &shard = _ZFP_zfstringAtomShardFor(hash);
+    zfAtomicSpinLocker(shard.lock);
+    return zfstringAtom(shard.find(src, srcLen, hash));
+}
+zfindex zfstringAtomCount(void)
+{
+    _ZFP_zfstringAtomShard *shards = _ZFP_zfstringAtomShards();
+    zfindex ret = 0;
+    for(zfindex i = 0; i < _ZFP_zfstringAtom_shardCount; ++i)
+    {
+        zfAtomicSpinLocker(shards[i].lock);
+        ret += shards[i].count;
+    }
+    return ret;
+}
+
+ZF_NAMESPACE_GLOBAL_END
+
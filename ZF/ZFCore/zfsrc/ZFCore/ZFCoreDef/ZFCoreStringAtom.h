@@ -0,0 +1,116 @@
+/**
+ * @file ZFCoreStringAtom.h
+ * @brief global string interning table for identifiers
+ */
+
+#ifndef _ZFI_ZFCoreStringAtom_h_
+#define _ZFI_ZFCoreStringAtom_h_
+
+#include "ZFCoreTypeDef.h"
+
+ZF_NAMESPACE_GLOBAL_BEGIN
+
+/** @cond ZFPrivateDoc */
+zfclassPOD ZF_ENV_EXPORT _ZFP_zfstringAtomData
+{
+public:
+    _ZFP_zfstringAtomData *next;
+    zfidentity hash;
+    zfindex length;
+    /* string content follows */
+};
+/** @endcond */
+
+/**
+ * @brief interned string handle, see #zfstringAtomFor
+ *
+ * the same string content would always result the same atom,
+ * so equality and hashing only compare the handle itself,
+ * and the string content would remain valid until app terminates\n
+ * \n
+ * designed for identifiers such as class names, property names and event names,
+ * interned strings would never be removed,
+ * so do not intern strings with unbounded content
+ */
+zfclassLikePOD ZF_ENV_EXPORT zfstringAtom
+{
+public:
+    /** @brief construct a null atom */
+    zfstringAtom(void)
+    : d(zfnull)
+    {
+    }
+    /** @cond ZFPrivateDoc */
+    explicit zfstringAtom(ZF_IN const _ZFP_zfstringAtomData *d)
+    : d(d)
+    {
+    }
+    /** @endcond */
+
+public:
+    /** @cond ZFPrivateDoc */
+    inline zfbool operator == (ZF_IN const zfstringAtom &ref) const {return d == ref.d;}
+    inline zfbool operator != (ZF_IN const zfstringAtom &ref) const {return d != ref.d;}
+    /** @endcond */
+
+public:
+    /** @brief true if null atom */
+    inline zfbool isNull(void) const
+    {
+        return d == zfnull;
+    }
+    /** @brief the interned string, null if null atom */
+    inline const zfchar *cString(void) const
+    {
+        return d ? (const zfchar *)(d + 1) : zfnull;
+    }
+    /** @brief length of the interned string */
+    inline zfindex length(void) const
+    {
+        return d ? d->length : 0;
+    }
+    /** @brief hash of the string content, same as #zfidentityCalcString */
+    inline zfidentity hash(void) const
+    {
+        return d ? d->hash : zfidentityInvalid();
+    }
+    /** @brief compare string content, for sorting */
+    inline zfint compare(ZF_IN const zfstringAtom &ref) const
+    {
+        if(d == ref.d)
+        {
+            return 0;
+        }
+        else
+        {
+            return zfscmp(this->cString(), ref.cString());
+        }
+    }
+
+private:
+    const _ZFP_zfstringAtomData *d;
+};
+
+/**
+ * @brief intern the string and return its atom, return null atom if src is null
+ *
+ * thread-safe, srcLen can be zfindexMax() to calculate automatically
+ */
+extern ZF_ENV_EXPORT zfstringAtom zfstringAtomFor(ZF_IN const zfchar *src,
+                                                  ZF_IN_OPT zfindex srcLen = zfindexMax());
+/**
+ * @brief find atom of interned string without interning it,
+ *   return null atom if not interned
+ *
+ * useful for lookup, since a string that never interned
+ * can not be a key of any atom map
+ */
+extern ZF_ENV_EXPORT zfstringAtom zfstringAtomFind(ZF_IN const zfchar *src,
+                                                   ZF_IN_OPT zfindex srcLen = zfindexMax());
+/** @brief number of interned strings, for debug use only */
+extern ZF_ENV_EXPORT zfindex zfstringAtomCount(void);
+
+ZF_NAMESPACE_GLOBAL_END
+
+#endif // #ifndef _ZFI_ZFCoreStringAtom_h_
+
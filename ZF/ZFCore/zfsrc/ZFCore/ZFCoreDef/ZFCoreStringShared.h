@@ -0,0 +1,200 @@
+/**
+ * @file ZFCoreStringShared.h
+ * @brief refcounted immutable string
+ */
+
+#ifndef _ZFI_ZFCoreStringShared_h_
+#define _ZFI_ZFCoreStringShared_h_
+
+#include "ZFCoreTypeDef.h"
+#include "ZFCoreAtomic.h"
+
+ZF_NAMESPACE_GLOBAL_BEGIN
+
+/** @cond ZFPrivateDoc */
+zfclassPOD ZF_ENV_EXPORT _ZFP_zfstrSharedD
+{
+public:
+    zfatomicint refCount;
+    zfindex length;
+    /* string content follows */
+};
+/** @endcond */
+
+/**
+ * @brief refcounted immutable string
+ *
+ * content can not be changed after construct,
+ * copy or assign only increase the reference count, no deep copy would be performed,
+ * and it's thread-safe to copy the same instance from different threads\n
+ * \n
+ * designed to store strings that would be copied frequently but rarely changed,
+ * such as attribute values of #ZFSerializableData,
+ * for strings that only need to be read, use #zfstringView instead
+ */
+template<typename T_Char>
+zfclassLikePOD ZF_ENV_EXPORT _zfstrShared
+{
+public:
+    /** @brief construct an empty string */
+    _zfstrShared(void)
+    : d(zfnull)
+    {
+    }
+    /** @brief retain another string */
+    _zfstrShared(ZF_IN const _zfstrShared &ref)
+    : d(ref.d)
+    {
+        if(d)
+        {
+            zfAtomicIncrease(d->refCount);
+        }
+    }
+    /** @brief copy content from another string */
+    _zfstrShared(ZF_IN const T_Char *s)
+    : d(_create(s, zfindexMax()))
+    {
+    }
+    /** @brief copy content from another string */
+    _zfstrShared(ZF_IN const T_Char *s, ZF_IN zfindex len)
+    : d(_create(s, len))
+    {
+    }
+    /** @brief copy content from another string */
+    _zfstrShared(ZF_IN const _zfstr<T_Char> &s)
+    : d(_create(s.cString(), s.length()))
+    {
+    }
+    /** @brief copy content from another string */
+    _zfstrShared(ZF_IN const _zfstrView<T_Char> &s)
+    : d(_create(s.data(), s.length()))
+    {
+    }
+    ~_zfstrShared(void)
+    {
+        _release(d);
+    }
+
+public:
+    /** @cond ZFPrivateDoc */
+    inline operator const T_Char *(void) const {return this->cString();}
+    /** @endcond */
+
+public:
+    /** @cond ZFPrivateDoc */
+    _zfstrShared &operator = (ZF_IN const _zfstrShared &ref)
+    {
+        if(ref.d)
+        {
+            zfAtomicIncrease(ref.d->refCount);
+        }
+        _ZFP_zfstrSharedD *dTmp = d;
+        d = ref.d;
+        _release(dTmp);
+        return *this;
+    }
+    _zfstrShared &operator = (ZF_IN const T_Char *s)
+    {
+        _ZFP_zfstrSharedD *dTmp = d;
+        d = _create(s, zfindexMax());
+        _release(dTmp);
+        return *this;
+    }
+    zfbool operator == (ZF_IN const _zfstrShared &ref) const
+    {
+        return (d == ref.d || this->view() == ref.view());
+    }
+    zfbool operator != (ZF_IN const _zfstrShared &ref) const
+    {
+        return !this->operator == (ref);
+    }
+    zfbool operator == (ZF_IN const T_Char *ref) const
+    {
+        return (this->view() == _zfstrView<T_Char>(ref));
+    }
+    zfbool operator != (ZF_IN const T_Char *ref) const
+    {
+        return !this->operator == (ref);
+    }
+    /** @endcond */
+
+public:
+    /** @brief access string value, ensured not null */
+    inline const T_Char *cString(void) const
+    {
+        return d ? (const T_Char *)(d + 1) : _empty();
+    }
+    /** @brief length of the string */
+    inline zfindex length(void) const
+    {
+        return d ? d->length : 0;
+    }
+    /** @brief true if empty */
+    inline zfbool isEmpty(void) const
+    {
+        return d == zfnull;
+    }
+    /** @brief view of the string, valid until this string destroyed or reassigned */
+    inline _zfstrView<T_Char> view(void) const
+    {
+        return _zfstrView<T_Char>(this->cString(), this->length());
+    }
+    /** @brief reference count, 0 if empty, for debug use only */
+    inline zfindex refCount(void) const
+    {
+        return d ? (zfindex)zfAtomicLoad(d->refCount) : 0;
+    }
+    /** @brief compare with another string */
+    inline zfint compare(ZF_IN const _zfstrView<T_Char> &ref) const
+    {
+        return this->view().compare(ref);
+    }
+
+private:
+    _ZFP_zfstrSharedD *d;
+private:
+    static const T_Char *_empty(void)
+    {
+        static const T_Char buf[1] = {0};
+        return buf;
+    }
+    static _ZFP_zfstrSharedD *_create(ZF_IN const T_Char *s, ZF_IN zfindex len)
+    {
+        if(s == zfnull)
+        {
+            return zfnull;
+        }
+        if(len == zfindexMax())
+        {
+            const T_Char *p = s;
+            while(*p) {++p;}
+            len = p - s;
+        }
+        if(len == 0)
+        {
+            return zfnull;
+        }
+        _ZFP_zfstrSharedD *d = (_ZFP_zfstrSharedD *)zfmalloc(sizeof(_ZFP_zfstrSharedD) + (len + 1) * sizeof(T_Char));
+        d->refCount = 1;
+        d->length = len;
+        T_Char *buf = (T_Char *)(d + 1);
+        zfmemcpy(buf, s, len * sizeof(T_Char));
+        buf[len] = '\0';
+        return d;
+    }
+    static void _release(ZF_IN _ZFP_zfstrSharedD *d)
+    {
+        if(d && zfAtomicDecrease(d->refCount) == 0)
+        {
+            zffree(d);
+        }
+    }
+};
+
+/** @brief see #_zfstrShared */
+typedef _zfstrShared<zfchar> zfstringShared;
+
+ZF_NAMESPACE_GLOBAL_END
+
+#endif // #ifndef _ZFI_ZFCoreStringShared_h_
+
@@ -17,6 +17,9 @@ ZF_NAMESPACE_GLOBAL_BEGIN
     typedef _ZFT_zfstring zfstring;
 #endif
 
+/** @brief see #_zfstrView */
+typedef _zfstrView<zfchar> zfstringView;
+
 ZF_NAMESPACE_GLOBAL_END
 
 #endif // #ifndef _ZFI_ZFCoreTypeDef_StringType_h_
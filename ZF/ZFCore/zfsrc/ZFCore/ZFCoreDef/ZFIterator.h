@@ -10,6 +10,9 @@
 
 ZF_NAMESPACE_GLOBAL_BEGIN
 
+/** @brief size of inline storage of #zfiterator, see #zfiterator::iteratorCreate */
+#define ZFIteratorInlineSize (sizeof(void *) * 4)
+
 /**
  * @brief iterator for ZFFramework
  *
@@ -50,10 +53,25 @@ ZF_NAMESPACE_GLOBAL_BEGIN
  * @endcode
  * \n
  * for implementations,
- * you should construct a zfiterator with a void *pointer,
+ * you should create a zfiterator by #iteratorCreate with a position value,
+ * such as an index or an STL iterator,
+ * which would be stored inline without any memory allocation
+ * if not larger than #ZFIteratorInlineSize,
+ * then you may use #data to access the pointer to the stored value:
+ * @code
+ *   zfiterator MyContainer::iterator(void)
+ *   {
+ *       return zfiterator::iteratorCreate(d->data.begin());
+ *   }
+ *   zfbool MyContainer::iteratorIsValid(ZF_IN const zfiterator &it)
+ *   {
+ *       MapType::iterator *data = it.data<MapType::iterator *>();
+ *       return (data != zfnull && *data != d->data.end());
+ *   }
+ * @endcode
+ * alternatively, you may construct a zfiterator with a void *pointer,
  * a delete callback and a copy callback,
- * then you may use #data to access the stored void *pointer
- * to achieve your implementation
+ * to manage the data yourself
  */
 zffinal zfclassLikePOD ZF_ENV_EXPORT zfiterator
 {
@@ -79,21 +97,49 @@ public:
         return ((d0 == zfnull && d1 == zfnull) || (d0 != zfnull && d1 != zfnull && *d0 == *d1));
     }
 
+    /**
+     * @brief implementations of iterables should use this to create an iterator,
+     *   see #zfiterator
+     *
+     * the data would be copied and stored inline if not larger than #ZFIteratorInlineSize,
+     * or allocated otherwise,
+     * use #data with type T_Data * to access the stored data
+     */
+    template<typename T_Data>
+    static zfiterator iteratorCreate(ZF_IN T_Data const &data)
+    {
+        zfiterator ret;
+        if(sizeof(T_Data) <= ZFIteratorInlineSize)
+        {
+            zfnewPlacement((void *)&(ret._buf), T_Data, data);
+            ret._inlineImpl = _InlineImplT<T_Data>::impl();
+        }
+        else
+        {
+            ret.d.data = zfnew(T_Data, data);
+            ret.d.deleteCallback = _InlineImplT<T_Data>::heapDelete;
+            ret.d.copyCallback = _InlineImplT<T_Data>::heapCopy;
+        }
+        return ret;
+    }
+
 public:
     /**
      * @brief create a dummy iterator
      */
     zfiterator(void)
+    : _inlineImpl(zfnull)
     {
         zfmemset(&d, 0, sizeof(zfiterator::_Data));
     }
     /**
-     * @brief implementations of iterables must use this to create an iterator,
-     *   see #zfiterator
+     * @brief implementations of iterables may use this to create an iterator
+     *   with data managed by callbacks, see #zfiterator
      */
     zfiterator(ZF_IN void *data,
                ZF_IN zfiterator::DeleteCallback deleteCallback,
                ZF_IN zfiterator::CopyCallback copyCallback)
+    : _inlineImpl(zfnull)
     {
         d.data = data;
         d.deleteCallback = deleteCallback;
@@ -105,7 +151,7 @@ public:
      */
     inline void *data(void) const
     {
-        return d.data;
+        return (_inlineImpl != zfnull) ? (void *)&_buf : d.data;
     }
     /**
      * @brief see #data
@@ -113,25 +159,57 @@ public:
     template<typename T_Data>
     inline T_Data data(void) const
     {
-        return (T_Data)(d.data);
+        return (T_Data)(this->data());
     }
     /**
      * @brief for implementation to change the internal data
      */
     inline void iteratorImplDataChange(ZF_IN void *newData)
     {
-        if(d.data && d.deleteCallback)
-        {
-            d.deleteCallback(d.data);
-        }
+        this->_dataDestroy();
         d.data = newData;
     }
 
 public:
     /** @cond ZFPrivateDoc */
     zfiterator(ZF_IN const zfiterator &ref)
+    : _inlineImpl(zfnull)
+    {
+        this->_dataCopy(ref);
+    }
+    ~zfiterator(void)
+    {
+        this->_dataDestroy();
+    }
+    zfiterator &operator = (ZF_IN const zfiterator &ref)
+    {
+        if(this != &ref)
+        {
+            this->_dataDestroy();
+            this->_dataCopy(ref);
+        }
+        return *this;
+    }
+    zfbool operator == (ZF_IN const zfiterator &ref) const
     {
-        if(ref.d.data)
+        return (this->data() == ref.data()
+            && d.deleteCallback == ref.d.deleteCallback
+            && d.copyCallback == ref.d.copyCallback
+            );
+    }
+    inline zfbool operator != (ZF_IN const zfiterator &ref) const {return !this->operator == (ref);}
+    /** @endcond */
+
+private:
+    void _dataCopy(ZF_IN const zfiterator &ref)
+    {
+        if(ref._inlineImpl != zfnull)
+        {
+            ref._inlineImpl->copy((void *)&_buf, (const void *)&(ref._buf));
+            _inlineImpl = ref._inlineImpl;
+            zfmemset(&d, 0, sizeof(zfiterator::_Data));
+        }
+        else if(ref.d.data)
         {
             if(ref.d.copyCallback)
             {
@@ -149,50 +227,19 @@ public:
             zfmemset(&d, 0, sizeof(zfiterator::_Data));
         }
     }
-    ~zfiterator(void)
+    void _dataDestroy(void)
     {
-        if(d.data && d.deleteCallback)
+        if(_inlineImpl != zfnull)
         {
-            d.deleteCallback(d.data);
+            _inlineImpl->destroy((void *)&_buf);
+            _inlineImpl = zfnull;
         }
-    }
-    zfiterator &operator = (ZF_IN const zfiterator &ref)
-    {
-        if(this != &ref)
+        else if(d.data && d.deleteCallback)
         {
-            if(d.data && d.deleteCallback)
-            {
-                d.deleteCallback(d.data);
-            }
-            if(ref.d.data)
-            {
-                if(ref.d.copyCallback)
-                {
-                    d.data = ref.d.copyCallback(ref.d.data);
-                }
-                else
-                {
-                    d.data = ref.d.data;
-                }
-                d.deleteCallback = ref.d.deleteCallback;
-                d.copyCallback = ref.d.copyCallback;
-            }
-            else
-            {
-                zfmemset(&d, 0, sizeof(zfiterator::_Data));
-            }
+            d.deleteCallback(d.data);
         }
-        return *this;
-    }
-    zfbool operator == (ZF_IN const zfiterator &ref) const
-    {
-        return (d.data == ref.d.data
-            && d.deleteCallback == ref.d.deleteCallback
-            && d.copyCallback == ref.d.copyCallback
-            );
     }
-    inline zfbool operator != (ZF_IN const zfiterator &ref) const {return !this->operator == (ref);}
-    /** @endcond */
+
 private:
     zfclassPOD _Data
     {
@@ -201,7 +248,53 @@ private:
         zfiterator::DeleteCallback deleteCallback;
         zfiterator::CopyCallback copyCallback;
     };
+    zfclassPOD _InlineImpl
+    {
+    public:
+        void (*copy)(ZF_IN void *dst, ZF_IN const void *src);
+        void (*destroy)(ZF_IN void *data);
+    };
+    template<typename T_Data>
+    zfclassNotPOD _InlineImplT
+    {
+    public:
+        static void copy(ZF_IN void *dst, ZF_IN const void *src)
+        {
+            zfnewPlacement(dst, T_Data, *(const T_Data *)src);
+        }
+        static void destroy(ZF_IN void *data)
+        {
+            zfdeletePlacement((T_Data *)data);
+        }
+        static const _InlineImpl *impl(void)
+        {
+            static const _InlineImpl d = {copy, destroy};
+            return &d;
+        }
+        static void heapDelete(ZF_IN void *data)
+        {
+            zfdelete((T_Data *)data);
+        }
+        static void *heapCopy(ZF_IN void *data)
+        {
+            return zfnew(T_Data, *(T_Data *)data);
+        }
+    };
+    zfclassPOD _Buf
+    {
+    public:
+        union
+        {
+            void *p[ZFIteratorInlineSize / sizeof(void *)];
+            zft_zfint64 alignForInt64;
+            double alignForDouble;
+        } u;
+    };
+
+private:
     _Data d;
+    const _InlineImpl *_inlineImpl; // not null if data stored in _buf
+    _Buf _buf;
 };
 
 extern ZF_ENV_EXPORT const zfiterator _ZFP_zfiteratorInvalid;
@@ -0,0 +1,331 @@
+#include "ZFMemPool.h"
+#include "ZFCoreAtomic.h"
+
+/*
+ * ZF_THREAD_LOCAL has no destructor,
+ * thread cache is returned by native thread exit callback if available
+ */
+#ifdef ZF_THREAD_LOCAL
+    #if defined(_WIN32) || defined(WIN32)
+        #define _ZFP_zfpoolThreadExit_Fls 1
+        #include <windows.h>
+    #elif defined(__unix__) || defined(__APPLE__) || defined(__linux)
+        #define _ZFP_zfpoolThreadExit_pthread 1
+        #include <pthread.h>
+    #endif
+#endif
+
+ZF_NAMESPACE_GLOBAL_BEGIN
+
+// number of size class
+#define _ZFP_zfpoolClassCount (ZF_ENV_ZFMEMPOOL_SIZE_MAX / _ZFP_zfpoolSizeAlignMin)
+#define _ZFP_zfpoolClassIndex(size) ((size) / _ZFP_zfpoolSizeAlignMin - 1)
+// min size of each slab, would contain at least _ZFP_zfpoolSlabBlockMin blocks
+#define _ZFP_zfpoolSlabSizeMin (16 * 1024)
+#define _ZFP_zfpoolSlabBlockMin 16
+// thread cache would return _ZFP_zfpoolCacheBatch blocks to global pool
+// when exceeds _ZFP_zfpoolCacheMax,
+// and fetch _ZFP_zfpoolCacheBatch blocks from global pool when empty
+#define _ZFP_zfpoolCacheMax 128
+#define _ZFP_zfpoolCacheBatch 32
+
+// ============================================================
+zfclassPOD _ZFP_zfpoolBlock
+{
+public:
+    _ZFP_zfpoolBlock *next;
+};
+// slab header, blocks are placed right after the header
+zfclassPOD _ZFP_zfpoolSlab
+{
+public:
+    _ZFP_zfpoolSlab *next;
+};
+#define _ZFP_zfpoolSlabHeaderSize _ZFP_zfpoolSizeAlign(sizeof(_ZFP_zfpoolSlab))
+
+// global pool for each size class, protected by lock
+zfclassPOD _ZFP_zfpoolClass
+{
+public:
+    zfatomicint lock;
+    _ZFP_zfpoolBlock *available;
+    zfindex availableCount;
+    _ZFP_zfpoolSlab *slabList;
+    zfindex slabCount;
+    zfindex blockTotal;
+};
+// zero initialized, safe to use during static init
+static _ZFP_zfpoolClass _ZFP_zfpoolClassList[_ZFP_zfpoolClassCount];
+
+// thread local cache for each size class
+zfclassPOD _ZFP_zfpoolCache
+{
+public:
+    _ZFP_zfpoolBlock *available;
+    zfindex availableCount;
+};
+#ifdef ZF_THREAD_LOCAL
+static ZF_THREAD_LOCAL _ZFP_zfpoolCache _ZFP_zfpoolCacheList[_ZFP_zfpoolClassCount];
+// whether thread exit callback registered for current thread
+static ZF_THREAD_LOCAL zfbool _ZFP_zfpoolCacheAttached = zffalse;
+#endif
+
+// ============================================================
+// thread exit callback
+#if _ZFP_zfpoolThreadExit_pthread
+static pthread_key_t _ZFP_zfpoolThreadExitKey;
+static pthread_once_t _ZFP_zfpoolThreadExitKeyOnce = PTHREAD_ONCE_INIT;
+static void _ZFP_zfpoolThreadExitCallback(ZF_IN void *)
+{
+    // other thread exit callbacks may free blocks after this one,
+    // reset so that they would register again
+    _ZFP_zfpoolCacheAttached = zffalse;
+    zfpoolCacheCleanup();
+}
+static void _ZFP_zfpoolThreadExitKeyInit(void)
+{
+    pthread_key_create(&_ZFP_zfpoolThreadExitKey, _ZFP_zfpoolThreadExitCallback);
+}
+static void _ZFP_zfpoolThreadExitRegister(void)
+{
+    pthread_once(&_ZFP_zfpoolThreadExitKeyOnce, _ZFP_zfpoolThreadExitKeyInit);
+    // callback would be called only for non-null value
+    pthread_setspecific(_ZFP_zfpoolThreadExitKey, (void *)1);
+}
+#elif _ZFP_zfpoolThreadExit_Fls
+static DWORD _ZFP_zfpoolThreadExitKey = FLS_OUT_OF_INDEXES;
+static zfatomicint _ZFP_zfpoolThreadExitKeyLock = 0;
+static VOID WINAPI _ZFP_zfpoolThreadExitCallback(ZF_IN PVOID)
+{
+    _ZFP_zfpoolCacheAttached = zffalse;
+    zfpoolCacheCleanup();
+}
+static void _ZFP_zfpoolThreadExitRegister(void)
+{
+    zfAtomicSpinLock(_ZFP_zfpoolThreadExitKeyLock);
+    if(_ZFP_zfpoolThreadExitKey == FLS_OUT_OF_INDEXES)
+    {
+        _ZFP_zfpoolThreadExitKey = FlsAlloc(_ZFP_zfpoolThreadExitCallback);
+    }
+    zfAtomicSpinUnlock(_ZFP_zfpoolThreadExitKeyLock);
+    if(_ZFP_zfpoolThreadExitKey != FLS_OUT_OF_INDEXES)
+    {
+        // callback would be called only for non-null value
+        FlsSetValue(_ZFP_zfpoolThreadExitKey, (PVOID)1);
+    }
+}
+#else
+static void _ZFP_zfpoolThreadExitRegister(void)
+{
+}
+#endif
+#ifdef ZF_THREAD_LOCAL
+// called when current thread's cache may become not empty
+static inline void _ZFP_zfpoolCacheAttach(void)
+{
+    if(!_ZFP_zfpoolCacheAttached)
+    {
+        _ZFP_zfpoolCacheAttached = zftrue;
+        _ZFP_zfpoolThreadExitRegister();
+    }
+}
+#endif
+
+// ============================================================
+// must be called within lock
+static void _ZFP_zfpoolSlabAlloc(ZF_IN_OUT _ZFP_zfpoolClass &c, ZF_IN zfindex size)
+{
+    zfindex blockCount = (_ZFP_zfpoolSlabSizeMin - _ZFP_zfpoolSlabHeaderSize) / size;
+    if(blockCount < _ZFP_zfpoolSlabBlockMin)
+    {
+        blockCount = _ZFP_zfpoolSlabBlockMin;
+    }
+    _ZFP_zfpoolSlab *slab = (_ZFP_zfpoolSlab *)zfmalloc(_ZFP_zfpoolSlabHeaderSize + size * blockCount);
+    slab->next = c.slabList;
+    c.slabList = slab;
+    ++(c.slabCount);
+    c.blockTotal += blockCount;
+
+    zfbyte *p = (zfbyte *)slab + _ZFP_zfpoolSlabHeaderSize + size * (blockCount - 1);
+    for(zfindex i = 0; i < blockCount; ++i, p -= size)
+    {
+        _ZFP_zfpoolBlock *block = (_ZFP_zfpoolBlock *)p;
+        block->next = c.available;
+        c.available = block;
+    }
+    c.availableCount += blockCount;
+}
+// fetch at most maxCount blocks from global pool, return the fetched count
+static zfindex _ZFP_zfpoolFetch(ZF_OUT _ZFP_zfpoolBlock *&head,
+                                ZF_IN zfindex size,
+                                ZF_IN zfindex maxCount)
+{
+    _ZFP_zfpoolClass &c = _ZFP_zfpoolClassList[_ZFP_zfpoolClassIndex(size)];
+    zfAtomicSpinLock(c.lock);
+    if(c.available == zfnull)
+    {
+        _ZFP_zfpoolSlabAlloc(c, size);
+    }
+    head = c.available;
+    _ZFP_zfpoolBlock *tail = head;
+    zfindex count = 1;
+    while(count < maxCount && tail->next != zfnull)
+    {
+        tail = tail->next;
+        ++count;
+    }
+    c.available = tail->next;
+    c.availableCount -= count;
+    tail->next = zfnull;
+    zfAtomicSpinUnlock(c.lock);
+    return count;
+}
+// return a list of blocks to global pool
+static void _ZFP_zfpoolReturn(ZF_IN _ZFP_zfpoolBlock *head,
+                              ZF_IN _ZFP_zfpoolBlock *tail,
+                              ZF_IN zfindex count,
+                              ZF_IN zfindex size)
+{
+    _ZFP_zfpoolClass &c = _ZFP_zfpoolClassList[_ZFP_zfpoolClassIndex(size)];
+    zfAtomicSpinLock(c.lock);
+    tail->next = c.available;
+    c.available = head;
+    c.availableCount += count;
+    zfAtomicSpinUnlock(c.lock);
+}
+
+// ============================================================
+void *_ZFP_zfpoolMalloc(ZF_IN zfindex size)
+{
+#ifdef ZF_THREAD_LOCAL
+    _ZFP_zfpoolCache &cache = _ZFP_zfpoolCacheList[_ZFP_zfpoolClassIndex(size)];
+    if(cache.available == zfnull)
+    {
+        _ZFP_zfpoolCacheAttach();
+        cache.availableCount = _ZFP_zfpoolFetch(cache.available, size, _ZFP_zfpoolCacheBatch);
+    }
+    _ZFP_zfpoolBlock *block = cache.available;
+    cache.available = block->next;
+    --(cache.availableCount);
+    return block;
+#else
+    _ZFP_zfpoolBlock *block = zfnull;
+    _ZFP_zfpoolFetch(block, size, 1);
+    return block;
+#endif
+}
+void _ZFP_zfpoolFree(ZF_IN void *obj, ZF_IN zfindex size)
+{
+    _ZFP_zfpoolBlock *block = (_ZFP_zfpoolBlock *)obj;
+#ifdef ZF_THREAD_LOCAL
+    // block may be allocated by other thread,
+    // simply put to current thread's cache since all blocks of same size class are shared
+    _ZFP_zfpoolCache &cache = _ZFP_zfpoolCacheList[_ZFP_zfpoolClassIndex(size)];
+    if(cache.available == zfnull)
+    {
+        _ZFP_zfpoolCacheAttach();
+    }
+    block->next = cache.available;
+    cache.available = block;
+    ++(cache.availableCount);
+    if(cache.availableCount > _ZFP_zfpoolCacheMax)
+    {
+        _ZFP_zfpoolBlock *head = cache.available;
+        _ZFP_zfpoolBlock *tail = head;
+        for(zfindex i = 1; i < _ZFP_zfpoolCacheBatch; ++i)
+        {
+            tail = tail->next;
+        }
+        cache.available = tail->next;
+        cache.availableCount -= _ZFP_zfpoolCacheBatch;
+        _ZFP_zfpoolReturn(head, tail, _ZFP_zfpoolCacheBatch, size);
+    }
+#else
+    block->next = zfnull;
+    _ZFP_zfpoolReturn(block, block, 1, size);
+#endif
+}
+
+// ============================================================
+zfindex zfpoolStateGet(ZF_OUT zfpoolState *stateList,
+                       ZF_IN zfindex stateListCount)
+{
+    zfindex ret = 0;
+    for(zfindex i = 0; i < _ZFP_zfpoolClassCount && ret < stateListCount; ++i)
+    {
+        _ZFP_zfpoolClass &c = _ZFP_zfpoolClassList[i];
+        zfAtomicSpinLock(c.lock);
+        if(c.slabCount > 0)
+        {
+            zfpoolState &state = stateList[ret++];
+            state.blockSize = (i + 1) * _ZFP_zfpoolSizeAlignMin;
+            state.slabCount = c.slabCount;
+            state.blockTotal = c.blockTotal;
+            state.blockAvailable = c.availableCount;
+#ifdef ZF_THREAD_LOCAL
+            state.blockCached = _ZFP_zfpoolCacheList[i].availableCount;
+#else
+            state.blockCached = 0;
+#endif
+        }
+        zfAtomicSpinUnlock(c.lock);
+    }
+    return ret;
+}
+
+void zfpoolCacheCleanup(void)
+{
+#ifdef ZF_THREAD_LOCAL
+    for(zfindex i = 0; i < _ZFP_zfpoolClassCount; ++i)
+    {
+        _ZFP_zfpoolCache &cache = _ZFP_zfpoolCacheList[i];
+        if(cache.available == zfnull)
+        {
+            continue;
+        }
+        _ZFP_zfpoolBlock *tail = cache.available;
+        while(tail->next != zfnull)
+        {
+            tail = tail->next;
+        }
+        _ZFP_zfpoolReturn(cache.available, tail, cache.availableCount, (i + 1) * _ZFP_zfpoolSizeAlignMin);
+        cache.available = zfnull;
+        cache.availableCount = 0;
+    }
+#endif
+}
+
+// ============================================================
+// free slabs when all blocks returned,
+// otherwise keep them alive since they may still be accessed after static cleanup
+zfclassNotPOD _ZFP_zfpoolCleanupHolder
+{
+public:
+    ~_ZFP_zfpoolCleanupHolder(void)
+    {
+        zfpoolCacheCleanup();
+        for(zfindex i = 0; i < _ZFP_zfpoolClassCount; ++i)
+        {
+            _ZFP_zfpoolClass &c = _ZFP_zfpoolClassList[i];
+            zfAtomicSpinLock(c.lock);
+            if(c.slabCount > 0 && c.availableCount == c.blockTotal)
+            {
+                while(c.slabList != zfnull)
+                {
+                    _ZFP_zfpoolSlab *slab = c.slabList;
+                    c.slabList = slab->next;
+                    zffree(slab);
+                }
+                c.available = zfnull;
+                c.availableCount = 0;
+                c.slabCount = 0;
+                c.blockTotal = 0;
+            }
+            zfAtomicSpinUnlock(c.lock);
+        }
+    }
+};
+static _ZFP_zfpoolCleanupHolder _ZFP_zfpoolCleanupHolderInstance;
+
+ZF_NAMESPACE_GLOBAL_END
+
@@ -25,7 +25,12 @@ ZF_NAMESPACE_GLOBAL_BEGIN
  * @def zfpoolNew
  * @brief internal use only, for allocating internal types for performance
  *
- * @warning no thread-safe
+ * memory is allocated from size-classified slabs,
+ * each thread would keep a small cache of free blocks,
+ * so that it's thread-safe and usually lock free\n
+ * blocks freed by other threads would be put to the freeing thread's cache,
+ * and returned to the global pool when the cache grows too large\n
+ * types larger than #ZF_ENV_ZFMEMPOOL_SIZE_MAX would be allocated by #zfmalloc directly
  * @warning pointers passed to zfpoolDelete must be the same with the type you create
  * @def zfpoolDelete
  * @brief see #zfpoolNew
@@ -43,6 +48,50 @@ ZF_NAMESPACE_GLOBAL_BEGIN
     #define zfpoolDeclareFriend()
 #endif
 
+/**
+ * @brief max block size that would be managed by #zfpoolNew
+ */
+#ifndef ZF_ENV_ZFMEMPOOL_SIZE_MAX
+    #define ZF_ENV_ZFMEMPOOL_SIZE_MAX 1024
+#endif
+
+// ============================================================
+/**
+ * @brief usage state of #zfpoolNew, see #zfpoolStateGet
+ */
+zfclassPOD ZF_ENV_EXPORT zfpoolState
+{
+public:
+    zfindex blockSize; /**< @brief size of each block */
+    zfindex slabCount; /**< @brief number of slabs reserved */
+    zfindex blockTotal; /**< @brief number of blocks reserved */
+    zfindex blockAvailable; /**< @brief number of blocks available in global pool */
+    zfindex blockCached; /**< @brief number of blocks cached by current thread */
+};
+
+/**
+ * @brief get usage state of #zfpoolNew
+ *
+ * fill up to stateListCount items to stateList,
+ * only size class that has ever been used would be filled,
+ * return number of items filled\n
+ * blocks in use (or cached by other threads) can be calculated by:
+ * (blockTotal - blockAvailable - blockCached)
+ */
+extern ZF_ENV_EXPORT zfindex zfpoolStateGet(ZF_OUT zfpoolState *stateList,
+                                            ZF_IN zfindex stateListCount);
+
+/**
+ * @brief return current thread's cached blocks to global pool
+ *
+ * this is done automatically when a thread ends,
+ * by pthread key destructor or fiber local storage callback,
+ * and by ZFThread after each task run in new thread\n
+ * on other platforms, it must be called before a thread ends,
+ * otherwise the cached blocks would be leaked
+ */
+extern ZF_ENV_EXPORT void zfpoolCacheCleanup(void);
+
 // ============================================================
 // impl
 #define _ZFP_zfpoolSizeAlignMin (sizeof(void *) * 2)
@@ -52,71 +101,53 @@ ZF_NAMESPACE_GLOBAL_BEGIN
             ? (size) \
             : ((((size) / _ZFP_zfpoolSizeAlignMin) + 1) * _ZFP_zfpoolSizeAlignMin) \
     )
-template<int N>
-union ZF_ENV_EXPORT _ZFP_zfpoolObjectBlock
-{
-public:
-    zfbyte buf[N];
-    _ZFP_zfpoolObjectBlock<N> *next;
-};
-template<int N>
+extern ZF_ENV_EXPORT void *_ZFP_zfpoolMalloc(ZF_IN zfindex size);
+extern ZF_ENV_EXPORT void _ZFP_zfpoolFree(ZF_IN void *obj, ZF_IN zfindex size);
+
+template<int N, int pooled>
 zfclassNotPOD ZF_ENV_EXPORT _ZFP_zfpoolObject
 {
 public:
-    void *poolMalloc(void)
+    static inline void *poolMalloc(void)
     {
-        if(_available)
-        {
-            _ZFP_zfpoolObjectBlock<N> *t = _available;
-            _available = _available->next;
-            return t;
-        }
-        else
-        {
-            return zfmalloc(sizeof(_ZFP_zfpoolObjectBlock<N>));
-        }
+        return _ZFP_zfpoolMalloc(N);
     }
-    void poolFree(ZF_IN void *obj)
+    static inline void poolFree(ZF_IN void *obj)
     {
-        _ZFP_zfpoolObjectBlock<N> *t = _available;
-        _available = (_ZFP_zfpoolObjectBlock<N> *)obj;
-        _available->next = t;
+        _ZFP_zfpoolFree(obj, N);
     }
+};
+template<int N>
+zfclassNotPOD ZF_ENV_EXPORT _ZFP_zfpoolObject<N, 0>
+{
 public:
-    _ZFP_zfpoolObject(void)
-    : _available(zfnull)
+    static inline void *poolMalloc(void)
     {
+        return zfmalloc(N);
     }
-    ~_ZFP_zfpoolObject(void)
+    static inline void poolFree(ZF_IN void *obj)
     {
-        while(_available)
-        {
-            _ZFP_zfpoolObjectBlock<N> *t = _available;
-            _available = _available->next;
-            zffree(t);
-        }
+        zffree(obj);
     }
-    static _ZFP_zfpoolObject<N> &instance(void)
-    {
-        static _ZFP_zfpoolObject<N> d;
-        return d;
-    }
-private:
-    _ZFP_zfpoolObjectBlock<N> *_available;
 };
 
 template<typename T_Type>
 zfclassNotPOD _ZFP_zfpoolObjectHolder
 {
+private:
+    typedef _ZFP_zfpoolObject<
+            _ZFP_zfpoolSizeAlign(sizeof(T_Type)),
+            (_ZFP_zfpoolSizeAlign(sizeof(T_Type)) <= ZF_ENV_ZFMEMPOOL_SIZE_MAX)
+        > _Pool;
 public:
     static void *poolMalloc(void)
     {
-        return _ZFP_zfpoolObject<_ZFP_zfpoolSizeAlign(sizeof(T_Type))>::instance().poolMalloc();
+        return _Pool::poolMalloc();
     }
     static void poolDelete(ZF_IN T_Type *obj)
     {
         obj->~T_Type();
-        _ZFP_zfpoolObject<_ZFP_zfpoolSizeAlign(sizeof(T_Type))>::instance().poolFree(obj);
+        _Pool::poolFree(obj);
     }
 };
 template<typename T_Type>
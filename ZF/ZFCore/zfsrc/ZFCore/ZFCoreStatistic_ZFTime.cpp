@@ -3,119 +3,233 @@
 ZF_NAMESPACE_GLOBAL_BEGIN
 ZF_NAMESPACE_BEGIN(ZFCoreStatistic)
 
-zfclassPOD _ZFP_ZFCoreStatisticInvokeTimeData
+#if defined(__GNUC__) || defined(__clang__)
+    #define _ZFP_ZFCoreStatisticInvokeTime_threadLocal __thread
+#elif defined(_MSC_VER)
+    #define _ZFP_ZFCoreStatisticInvokeTime_threadLocal __declspec(thread)
+#endif
+
+zfclassPOD _ZFP_ZFCoreStatisticInvokeTimeHandle
 {
 public:
-    zfindex invokeCount;
-    ZFTimeValue invokeTotalTime;
+    zfindex counter; // zfindexMax if too many keys registered
+    zfindex histogram;
+};
+zfclassPOD _ZFP_ZFCoreStatisticInvokeTimeState
+{
+public:
+    zfindex histogram;
     ZFTimeValue invokeStartTime;
     zfindex reentrantCount;
 };
+// owned by one thread, no lock required
+zfclassNotPOD _ZFP_ZFCoreStatisticInvokeTimeThread
+{
+public:
+    ZFCoreHashMap<_ZFP_ZFCoreStatisticInvokeTimeHandle> handleMap;
+    ZFCoreArrayPOD<_ZFP_ZFCoreStatisticInvokeTimeState> pendingList; // begin without end, typically very few
+
+public:
+    const _ZFP_ZFCoreStatisticInvokeTimeHandle &handleForKey(ZF_IN const zfchar *key)
+    {
+        _ZFP_ZFCoreStatisticInvokeTimeHandle *exist = this->handleMap.get(key);
+        if(exist != zfnull)
+        {
+            return *exist;
+        }
+        _ZFP_ZFCoreStatisticInvokeTimeHandle handle;
+        if(!_ZFP_ZFCoreStatisticInvokeTimeRegister(handle.counter, handle.histogram, key))
+        {
+            handle.counter = zfindexMax();
+            handle.histogram = zfindexMax();
+        }
+        this->handleMap.set(key, handle);
+        return *(this->handleMap.get(key));
+    }
+    zfindex pendingIndex(ZF_IN zfindex histogram)
+    {
+        for(zfindex i = this->pendingList.count() - 1; i != zfindexMax(); --i)
+        {
+            if(this->pendingList[i].histogram == histogram)
+            {
+                return i;
+            }
+        }
+        return zfindexMax();
+    }
+};
+// thread states are kept until app terminates, same as the shards of counters
+zfclassNotPOD _ZFP_ZFCoreStatisticInvokeTimeThreadHolder
+{
+public:
+    zfatomicint lock;
+    ZFCoreArrayPOD<_ZFP_ZFCoreStatisticInvokeTimeThread *> threads;
 
-static ZFCoreMap &_ZFP_ZFCoreStatisticInvokeTimeDataMap(void)
+public:
+    _ZFP_ZFCoreStatisticInvokeTimeThreadHolder(void)
+    : lock(0)
+    , threads()
+    {
+    }
+    ~_ZFP_ZFCoreStatisticInvokeTimeThreadHolder(void)
+    {
+        for(zfindex i = 0; i < this->threads.count(); ++i)
+        {
+            zfdelete(this->threads[i]);
+        }
+    }
+
+public:
+    _ZFP_ZFCoreStatisticInvokeTimeThread *threadCreate(void)
+    {
+        _ZFP_ZFCoreStatisticInvokeTimeThread *thread = zfnew(_ZFP_ZFCoreStatisticInvokeTimeThread);
+        zfAtomicSpinLocker(this->lock);
+        this->threads.add(thread);
+        return thread;
+    }
+};
+static _ZFP_ZFCoreStatisticInvokeTimeThreadHolder &_ZFP_ZFCoreStatisticInvokeTimeThreadHolderData(void)
 {
-    static ZFCoreMap m; // _ZFP_ZFCoreStatisticInvokeTimeData
-    return m;
+    static _ZFP_ZFCoreStatisticInvokeTimeThreadHolder d;
+    return d;
 }
 
-void invokeTimeLogBegin(ZF_IN const zfchar *key)
+#ifdef _ZFP_ZFCoreStatisticInvokeTime_threadLocal
+static _ZFP_ZFCoreStatisticInvokeTime_threadLocal _ZFP_ZFCoreStatisticInvokeTimeThread *_ZFP_ZFCoreStatisticInvokeTimeThreadLocal = zfnull;
+static inline _ZFP_ZFCoreStatisticInvokeTimeThread *_ZFP_ZFCoreStatisticInvokeTimeThreadForCurrentThread(void)
 {
-    ZFCoreMap &m = _ZFP_ZFCoreStatisticInvokeTimeDataMap();
-    _ZFP_ZFCoreStatisticInvokeTimeData *data = m.get<_ZFP_ZFCoreStatisticInvokeTimeData *>(key);
-    if(data == zfnull)
+    if(_ZFP_ZFCoreStatisticInvokeTimeThreadLocal == zfnull)
     {
-        data = (_ZFP_ZFCoreStatisticInvokeTimeData *)zfmalloc(sizeof(_ZFP_ZFCoreStatisticInvokeTimeData));
-        zfmemset(data, 0, sizeof(_ZFP_ZFCoreStatisticInvokeTimeData));
-        m.set(key, ZFCorePointerForPOD<_ZFP_ZFCoreStatisticInvokeTimeData *>(data));
+        _ZFP_ZFCoreStatisticInvokeTimeThreadLocal = _ZFP_ZFCoreStatisticInvokeTimeThreadHolderData().threadCreate();
+    }
+    return _ZFP_ZFCoreStatisticInvokeTimeThreadLocal;
+}
+#define _ZFP_ZFCoreStatisticInvokeTimeThreadLocker()
+#else
+// no thread local storage, all threads share one state with lock,
+// begin and end are paired globally instead of within each thread
+static _ZFP_ZFCoreStatisticInvokeTimeThread *_ZFP_ZFCoreStatisticInvokeTimeThreadForCurrentThread(void)
+{
+    static _ZFP_ZFCoreStatisticInvokeTimeThread *thread = _ZFP_ZFCoreStatisticInvokeTimeThreadHolderData().threadCreate();
+    return thread;
+}
+static zfatomicint _ZFP_ZFCoreStatisticInvokeTimeThreadLock = 0;
+#define _ZFP_ZFCoreStatisticInvokeTimeThreadLocker() zfAtomicSpinLocker(_ZFP_ZFCoreStatisticInvokeTimeThreadLock)
+#endif
 
-        ++(data->invokeCount);
-        data->invokeStartTime = ZFTime::currentTimeValue();
+void invokeTimeLogBegin(ZF_IN const zfchar *key)
+{
+    _ZFP_ZFCoreStatisticInvokeTimeThread *thread = _ZFP_ZFCoreStatisticInvokeTimeThreadForCurrentThread();
+    _ZFP_ZFCoreStatisticInvokeTimeThreadLocker();
+    const _ZFP_ZFCoreStatisticInvokeTimeHandle &handle = thread->handleForKey((key == zfnull) ? "" : key);
+    if(handle.histogram == zfindexMax())
+    {
+        return;
+    }
+    counterAdd(handle.counter);
+    zfindex index = thread->pendingIndex(handle.histogram);
+    if(index != zfindexMax())
+    {
+        ++(thread->pendingList[index].reentrantCount);
     }
     else
     {
-        ++(data->invokeCount);
-
-        if(data->invokeStartTime != ZFTimeValueZero())
-        {
-            ++(data->reentrantCount);
-        }
-        else
-        {
-            data->invokeStartTime = ZFTime::currentTimeValue();
-        }
+        _ZFP_ZFCoreStatisticInvokeTimeState state;
+        state.histogram = handle.histogram;
+        state.reentrantCount = 0;
+        state.invokeStartTime = ZFTime::currentTimeValue();
+        thread->pendingList.add(state);
     }
 }
 void invokeTimeLogEnd(ZF_IN const zfchar *key)
 {
-    ZFCoreMap &m = _ZFP_ZFCoreStatisticInvokeTimeDataMap();
-    _ZFP_ZFCoreStatisticInvokeTimeData *data = m.get<_ZFP_ZFCoreStatisticInvokeTimeData *>(key);
-    if(data != zfnull)
+    ZFTimeValue invokeEndTime = ZFTime::currentTimeValue();
+    _ZFP_ZFCoreStatisticInvokeTimeThread *thread = _ZFP_ZFCoreStatisticInvokeTimeThreadForCurrentThread();
+    _ZFP_ZFCoreStatisticInvokeTimeThreadLocker();
+    _ZFP_ZFCoreStatisticInvokeTimeHandle *handle = thread->handleMap.get((key == zfnull) ? "" : key);
+    if(handle == zfnull)
     {
-        if(data->reentrantCount > 0)
-        {
-            --(data->reentrantCount);
-        }
-        else
-        {
-            data->invokeTotalTime += ZFTime::currentTimeValue() - data->invokeStartTime;
-            data->invokeStartTime = ZFTimeValueZero();
-        }
+        return;
+    }
+    zfindex index = thread->pendingIndex(handle->histogram);
+    if(index == zfindexMax())
+    {
+        return;
+    }
+    _ZFP_ZFCoreStatisticInvokeTimeState &state = thread->pendingList[index];
+    if(state.reentrantCount > 0)
+    {
+        --(state.reentrantCount);
+        return;
     }
+    ZFTimeValue invokeStartTime = state.invokeStartTime;
+    thread->pendingList.remove(index);
+    histogramRecordTime(handle->histogram, invokeEndTime - invokeStartTime);
 }
 void invokeTimeRemove(ZF_IN const zfchar *key)
 {
-    ZFCoreMap &m = _ZFP_ZFCoreStatisticInvokeTimeDataMap();
-    m.remove(key);
+    _ZFP_ZFCoreStatisticInvokeTimeHandle handle;
+    if(_ZFP_ZFCoreStatisticInvokeTimeFind(handle.counter, handle.histogram, key))
+    {
+        counterReset(handle.counter);
+        histogramReset(handle.histogram);
+    }
 }
 void invokeTimeRemoveAll(void)
 {
-    ZFCoreMap &m = _ZFP_ZFCoreStatisticInvokeTimeDataMap();
-    m.removeAll();
+    _ZFP_ZFCoreStatisticInvokeTimeResetAll();
 }
 zfindex invokeTimeGetInvokeCount(ZF_IN const zfchar *key)
 {
-    ZFCoreMap &m = _ZFP_ZFCoreStatisticInvokeTimeDataMap();
-    _ZFP_ZFCoreStatisticInvokeTimeData *data = m.get<_ZFP_ZFCoreStatisticInvokeTimeData *>(key);
-    if(data != zfnull)
+    _ZFP_ZFCoreStatisticInvokeTimeHandle handle;
+    if(_ZFP_ZFCoreStatisticInvokeTimeFind(handle.counter, handle.histogram, key))
     {
-        return data->invokeCount;
+        return counterGet(handle.counter);
     }
     return 0;
 }
-ZFTimeValue invokeTimeGetAverageTime(ZF_IN const zfchar *key)
+static void _ZFP_ZFCoreStatisticInvokeTimeHistogram(ZF_OUT HistogramState &ret, ZF_IN const zfchar *key)
 {
-    ZFCoreMap &m = _ZFP_ZFCoreStatisticInvokeTimeDataMap();
-    _ZFP_ZFCoreStatisticInvokeTimeData *data = m.get<_ZFP_ZFCoreStatisticInvokeTimeData *>(key);
-    if(data != zfnull && data->invokeCount > 0)
+    _ZFP_ZFCoreStatisticInvokeTimeHandle handle;
+    if(!_ZFP_ZFCoreStatisticInvokeTimeFind(handle.counter, handle.histogram, key))
     {
-        return data->invokeTotalTime / data->invokeCount;
+        handle.histogram = zfindexMax();
     }
-    return ZFTimeValueZero();
+    histogramGet(ret, handle.histogram);
 }
-ZFTimeValue invokeTimeGetTotalTime(ZF_IN const zfchar *key)
+ZFTimeValue invokeTimeGetAverageTime(ZF_IN const zfchar *key)
 {
-    ZFCoreMap &m = _ZFP_ZFCoreStatisticInvokeTimeDataMap();
-    _ZFP_ZFCoreStatisticInvokeTimeData *data = m.get<_ZFP_ZFCoreStatisticInvokeTimeData *>(key);
-    if(data != zfnull)
+    zfindex invokeCount = invokeTimeGetInvokeCount(key);
+    if(invokeCount > 0)
     {
-        return data->invokeTotalTime;
+        return invokeTimeGetTotalTime(key) / invokeCount;
     }
     return ZFTimeValueZero();
 }
+ZFTimeValue invokeTimeGetTotalTime(ZF_IN const zfchar *key)
+{
+    HistogramState state;
+    _ZFP_ZFCoreStatisticInvokeTimeHistogram(state, key);
+    ZFTimeValue ret = {(zftimet)(state.sum / 1000000), (zftimet)(state.sum % 1000000)};
+    return ret;
+}
 void invokeTimeGetSummary(ZF_OUT zfstring &ret, ZF_IN const zfchar *key)
 {
-    ZFCoreMap &m = _ZFP_ZFCoreStatisticInvokeTimeDataMap();
-    _ZFP_ZFCoreStatisticInvokeTimeData *data = m.get<_ZFP_ZFCoreStatisticInvokeTimeData *>(key);
-    zfindex invokeCount = ((data == zfnull) ? 0 : data->invokeCount);
-    ZFTimeValue invokeTotalTime = ((data == zfnull) ? ZFTimeValueZero() : data->invokeTotalTime);
+    zfindex invokeCount = invokeTimeGetInvokeCount(key);
+    HistogramState state;
+    _ZFP_ZFCoreStatisticInvokeTimeHistogram(state, key);
+    ZFTimeValue invokeTotalTime = {(zftimet)(state.sum / 1000000), (zftimet)(state.sum % 1000000)};
     if(invokeCount > 1)
     {
-        ZFTimeValue invokeAverageTime = ((invokeCount == 0) ? ZFTimeValueZero() : invokeTotalTime / invokeCount);
-        zfstringAppend(ret, "[%s] invoke count: %s, total: %s, average: %s",
+        ZFTimeValue invokeAverageTime = invokeTotalTime / invokeCount;
+        zfstringAppend(ret, "[%s] invoke count: %s, total: %s, average: %s, p50: %sus, p99: %sus, max: %sus",
             (key == zfnull) ? ZFTOKEN_zfnull : key,
             zfsFromInt(invokeCount).cString(),
             ZFTimeValueToStringFriendly(invokeTotalTime).cString(),
-            ZFTimeValueToStringFriendly(invokeAverageTime).cString());
+            ZFTimeValueToStringFriendly(invokeAverageTime).cString(),
+            zfsFromInt(state.p50).cString(),
+            zfsFromInt(state.p99).cString(),
+            zfsFromInt(state.max).cString());
     }
     else
     {
@@ -125,6 +239,14 @@ void invokeTimeGetSummary(ZF_OUT zfstring &ret, ZF_IN const zfchar *key)
     }
 }
 
+// ============================================================
+void histogramRecordTime(ZF_IN zfindex histogram,
+                         ZF_IN const ZFTimeValue &time)
+{
+    zftimet usec = time.sec * 1000000 + time.usec;
+    histogramRecord(histogram, (usec > 0) ? (zfindex)usec : 0);
+}
+
 ZF_NAMESPACE_END(ZFCoreStatistic)
 ZF_NAMESPACE_GLOBAL_END
 
@@ -32,13 +32,24 @@ ZF_NAMESPACE_BEGIN(ZFCoreStatistic)
  *       yourHeavyFunc();
  *   }
  * @endcode
+ *
+ * all of these are thread-safe, begin and end are paired within each thread,
+ * each begin would be counted as one invoke,
+ * and each outermost begin/end pair would be recorded in micro seconds,
+ * the keys are separated from #ZFCoreStatistic::counterRegister
+ * and #ZFCoreStatistic::histogramRegister,
+ * and exported as "invokeTimes" by #ZFCoreStatistic::statisticExport\n
+ * \n
+ * the key's handle would be cached by each thread, so begin and end take no lock after first call,
+ * but the key would still be hashed for each call,
+ * for hot path, use #ZFCoreStatisticHistogramTimeLogger instead
  */
 extern ZF_ENV_EXPORT void invokeTimeLogBegin(ZF_IN const zfchar *key);
 /** @brief see #ZFCoreStatistic::invokeTimeLogBegin */
 extern ZF_ENV_EXPORT void invokeTimeLogEnd(ZF_IN const zfchar *key);
 /** @brief see #ZFCoreStatistic::invokeTimeLogBegin */
 extern ZF_ENV_EXPORT void invokeTimeRemove(ZF_IN const zfchar *key);
-/** @brief see #ZFCoreStatistic::invokeTimeLogBegin */
+/** @brief reset all keys of #ZFCoreStatistic::invokeTimeLogBegin, other counters and histograms are not affected */
 extern ZF_ENV_EXPORT void invokeTimeRemoveAll(void);
 /** @brief see #ZFCoreStatistic::invokeTimeLogBegin */
 extern ZF_ENV_EXPORT zfindex invokeTimeGetInvokeCount(ZF_IN const zfchar *key);
@@ -102,6 +113,44 @@ private:
     ZFCoreStatistic::_ZFP_ZFCoreStatisticInvokeTimeLoggerOneTime \
         ZFUniqueName(ZFCoreStatisticInvokeTimeLoggerOneTime_v)(key, ##__VA_ARGS__)
 
+// ============================================================
+/**
+ * @brief record time to histogram in micro seconds, see #ZFCoreStatistic::histogramRegister
+ */
+extern ZF_ENV_EXPORT void histogramRecordTime(ZF_IN zfindex histogram,
+                                              ZF_IN const ZFTimeValue &time);
+
+zfclassLikePOD ZF_ENV_EXPORT _ZFP_ZFCoreStatisticHistogramTimeLogger
+{
+public:
+    _ZFP_ZFCoreStatisticHistogramTimeLogger(ZF_IN zfindex histogram)
+    : histogram(histogram)
+    , startTime(ZFTime::currentTimeValue())
+    {
+    }
+    ~_ZFP_ZFCoreStatisticHistogramTimeLogger(void)
+    {
+        ZFCoreStatistic::histogramRecordTime(histogram, ZFTime::currentTimeValue() - startTime);
+    }
+private:
+    zfindex histogram;
+    ZFTimeValue startTime;
+};
+/**
+ * @brief record the time of current scope to histogram in micro seconds
+ *
+ * usage:
+ * @code
+ *   static zfindex histogram = ZFCoreStatistic::histogramRegister(key);
+ *   {
+ *       ZFCoreStatisticHistogramTimeLogger(histogram);
+ *       yourHeavyFunc();
+ *   }
+ * @endcode
+ */
+#define ZFCoreStatisticHistogramTimeLogger(histogram) \
+    ZFCoreStatistic::_ZFP_ZFCoreStatisticHistogramTimeLogger ZFUniqueName(ZFCoreStatisticHistogramTimeLogger_v)(histogram)
+
 ZF_NAMESPACE_END(ZFCoreStatistic)
 ZF_NAMESPACE_GLOBAL_END
 #endif // #ifndef _ZFI_ZFCoreStatistic_ZFTime_h_
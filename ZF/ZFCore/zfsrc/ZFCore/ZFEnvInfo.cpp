@@ -122,7 +122,7 @@ ZFMETHOD_FUNC_DEFINE_0(zfstring, frameworkVersion)
 ZF_NAMESPACE_END_WITH_REGISTER(ZFEnvInfo, ZF_NAMESPACE_GLOBAL)
 
 // ============================================================
-ZF_GLOBAL_INITIALIZER_INIT_WITH_LEVEL(ZFEnvSummary_common, ZFLevelZFFrameworkNormal)
+ZF_GLOBAL_INITIALIZER_INIT_WITH_LEVEL_AND_FLAGS(ZFEnvSummary_common, ZFLevelZFFrameworkNormal, ZFGlobalInitializerFlagParallel)
 {
     ZFEnvInfo::envSummaryCallbackRegister("systemName", ZFEnvInfo::systemName);
     ZFEnvInfo::envSummaryCallbackRegister("systemVersion", ZFEnvInfo::systemVersion);
@@ -213,7 +213,7 @@ void ZFHashMap::set(ZF_IN ZFObject *pKey,
         zfRetain(pKey);
         zfRetain(pValue);
         (d->data)[pKey] = pValue;
-        this->contentOnAdd(it->first, it->second);
+        this->contentOnAdd(pKey, pValue);
     }
 
     this->contentOnChange();
@@ -303,20 +303,9 @@ void ZFHashMap::removeAll(void)
 }
 
 // ============================================================
-static void _ZFP_ZFHashMap_iteratorDeleteCallback(ZF_IN void *data)
-{
-    zfdelete(ZFCastStatic(_ZFP_ZFHashMapPrivate::MapType::iterator *, data));
-}
-static void *_ZFP_ZFHashMap_iteratorCopyCallback(ZF_IN void *data)
-{
-    return zfnew(_ZFP_ZFHashMapPrivate::MapType::iterator,
-        *ZFCastStatic(_ZFP_ZFHashMapPrivate::MapType::iterator *, data));
-}
 ZFMETHOD_DEFINE_0(ZFHashMap, zfiterator, iterator)
 {
-    return zfiterator(zfnew(_ZFP_ZFHashMapPrivate::MapType::iterator, d->data.begin()),
-        _ZFP_ZFHashMap_iteratorDeleteCallback,
-        _ZFP_ZFHashMap_iteratorCopyCallback);
+    return zfiterator::iteratorCreate(d->data.begin());
 }
 
 ZFMETHOD_DEFINE_1(ZFHashMap, zfbool, iteratorIsValid,
@@ -365,9 +354,7 @@ void ZFHashMap::iteratorRemove(ZF_IN_OUT zfiterator &it)
 ZFMETHOD_DEFINE_1(ZFHashMap, zfiterator, iteratorForKey,
                   ZFMP_IN(ZFObject *, key))
 {
-    return zfiterator(zfnew(_ZFP_ZFHashMapPrivate::MapType::iterator, d->data.find(key)),
-        _ZFP_ZFHashMap_iteratorDeleteCallback,
-        _ZFP_ZFHashMap_iteratorCopyCallback);
+    return zfiterator::iteratorCreate(d->data.find(key));
 }
 ZFMETHOD_DEFINE_1(ZFHashMap, ZFObject *, iteratorKey,
                   ZFMP_IN(const zfiterator &, it))
@@ -324,20 +324,9 @@ void ZFMap::removeAll(void)
 }
 
 // ============================================================
-static void _ZFP_ZFMap_iteratorDeleteCallback(ZF_IN void *data)
-{
-    zfdelete(ZFCastStatic(_ZFP_ZFMapPrivate::MapType::iterator *, data));
-}
-static void *_ZFP_ZFMap_iteratorCopyCallback(ZF_IN void *data)
-{
-    return zfnew(_ZFP_ZFMapPrivate::MapType::iterator,
-        *ZFCastStatic(_ZFP_ZFMapPrivate::MapType::iterator *, data));
-}
 ZFMETHOD_DEFINE_0(ZFMap, zfiterator, iterator)
 {
-    return zfiterator(zfnew(_ZFP_ZFMapPrivate::MapType::iterator, d->data.begin()),
-        _ZFP_ZFMap_iteratorDeleteCallback,
-        _ZFP_ZFMap_iteratorCopyCallback);
+    return zfiterator::iteratorCreate(d->data.begin());
 }
 
 ZFMETHOD_DEFINE_1(ZFMap, zfbool, iteratorIsValid,
@@ -389,9 +378,7 @@ void ZFMap::iteratorRemove(ZF_IN_OUT zfiterator &it)
 ZFMETHOD_DEFINE_1(ZFMap, zfiterator, iteratorForKey,
                   ZFMP_IN(ZFObject *, key))
 {
-    return zfiterator(zfnew(_ZFP_ZFMapPrivate::MapType::iterator, d->data.find(key)),
-        _ZFP_ZFMap_iteratorDeleteCallback,
-        _ZFP_ZFMap_iteratorCopyCallback);
+    return zfiterator::iteratorCreate(d->data.find(key));
 }
 ZFMETHOD_DEFINE_1(ZFMap, ZFObject *, iteratorKey,
                   ZFMP_IN(const zfiterator &, it))
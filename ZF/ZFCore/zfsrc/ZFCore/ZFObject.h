@@ -39,8 +39,10 @@
 #include "ZFObjectDef/ZFMethodFuncDeclare.h"
 #include "ZFObjectDef/ZFMethodFuncUserRegister.h"
 #include "ZFObjectDef/ZFMethodGenericInvoker.h"
+#include "ZFObjectDef/ZFMethodProfile.h"
 #include "ZFObjectDef/ZFMethodSerializable.h"
 #include "ZFObjectDef/ZFMethodUserRegister.h"
+#include "ZFObjectDef/ZFObjectAllocTrack.h"
 #include "ZFObjectDef/ZFObjectCast.h"
 #include "ZFObjectDef/ZFObjectClassTypeFwd.h"
 #include "ZFObjectDef/ZFObjectCore.h"
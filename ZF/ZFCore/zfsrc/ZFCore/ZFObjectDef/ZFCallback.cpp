@@ -15,78 +15,108 @@ void _ZFP_ZFCallback_executeNullCallback(void)
 // ============================================================
 // _ZFP_ZFCallbackPrivate
 typedef zfstlmap<zfstlstringZ, zfautoObject> _ZFP_ZFCallbackTagMap;
-zfclassNotPOD ZF_ENV_EXPORT _ZFP_ZFCallbackPrivate
+// metadata that most callbacks never have, allocated on first set
+zfclassNotPOD _ZFP_ZFCallbackPrivateExt
 {
 public:
-    zfuint refCount;
     zfchar *callbackId;
     _ZFP_ZFCallbackTagMap callbackTagMap;
+    zfchar *serializableCustomType;
+    ZFSerializableData *serializableCustomData;
+    ZFPathInfo *pathInfo;
 
+public:
+    _ZFP_ZFCallbackPrivateExt(void)
+    : callbackId(zfnull)
+    , callbackTagMap()
+    , serializableCustomType(zfnull)
+    , serializableCustomData(zfnull)
+    , pathInfo(zfnull)
+    {
+    }
+    ~_ZFP_ZFCallbackPrivateExt(void)
+    {
+        zffree(this->callbackId);
+        zffree(this->serializableCustomType);
+        zfdelete(this->serializableCustomData);
+        zfdelete(this->pathInfo);
+    }
+};
+zfclassNotPOD ZF_ENV_EXPORT _ZFP_ZFCallbackPrivate
+{
+public:
+    zfatomicint refCount;
     ZFCallbackType callbackType;
-    ZFObject *callbackOwnerObject; // assign only
     zfuint callbackOwnerObjectRetainFlag;
+    ZFObject *callbackOwnerObject; // assign only
     const ZFMethod *callbackMethod;
     ZFFuncAddrType callbackRawFunction;
     _ZFP_ZFCallbackLambda *callbackLambdaImpl;
     ZFFuncAddrType callbackLambdaInvoker;
     _ZFP_ZFCallbackLambda::DestroyCallback callbackLambdaImplDestroy;
-
-    zfchar *serializableCustomType;
-    ZFSerializableData *serializableCustomData;
-    ZFPathInfo *pathInfo;
+    _ZFP_ZFCallbackPrivateExt *ext; // null until first access by extAccess
 
 public:
     _ZFP_ZFCallbackPrivate(void)
     : refCount(1)
-    , callbackId(zfnull)
-    , callbackTagMap()
     , callbackType(ZFCallbackTypeDummy)
-    , callbackOwnerObject(zfnull)
     , callbackOwnerObjectRetainFlag(0)
+    , callbackOwnerObject(zfnull)
     , callbackMethod(zfnull)
     , callbackRawFunction(zfnull)
     , callbackLambdaImpl(zfnull)
     , callbackLambdaInvoker(zfnull)
     , callbackLambdaImplDestroy(zfnull)
-    , serializableCustomType(zfnull)
-    , serializableCustomData(zfnull)
-    , pathInfo(zfnull)
+    , ext(zfnull)
     {
     }
     ~_ZFP_ZFCallbackPrivate(void)
     {
-        zffree(this->callbackId);
         if(this->callbackOwnerObjectRetainFlag != 0)
         {
             zfRelease(this->callbackOwnerObject);
         }
-        zffree(this->serializableCustomType);
-        zfdelete(this->serializableCustomData);
-        zfdelete(this->pathInfo);
         if(this->callbackLambdaImplDestroy)
         {
             this->callbackLambdaImplDestroy(this->callbackLambdaImpl);
         }
+        if(this->ext != zfnull)
+        {
+            zfpoolDelete(this->ext);
+        }
+    }
+
+public:
+    _ZFP_ZFCallbackPrivateExt *extAccess(void)
+    {
+        if(this->ext == zfnull)
+        {
+            this->ext = zfpoolNew(_ZFP_ZFCallbackPrivateExt);
+        }
+        return this->ext;
     }
 };
 
 // ============================================================
 // global
+static void _ZFP_ZFCallbackPrivateRelease(ZF_IN _ZFP_ZFCallbackPrivate *d)
+{
+    if(zfAtomicDecrease(d->refCount) == 0)
+    {
+        zfpoolDelete(d);
+    }
+}
 static void _ZFP_ZFCallbackPrivateDataChange(_ZFP_ZFCallbackPrivate *&oldData, _ZFP_ZFCallbackPrivate *newData)
 {
     _ZFP_ZFCallbackPrivate *dTmp = oldData;
     oldData = newData;
     if(newData != zfnull)
     {
-        ++newData->refCount;
+        zfAtomicIncrease(newData->refCount);
     }
     if(dTmp != zfnull)
     {
-        --dTmp->refCount;
-        if(dTmp->refCount == 0)
-        {
-            zfdelete(dTmp);
-        }
+        _ZFP_ZFCallbackPrivateRelease(dTmp);
     }
 }
 
@@ -110,11 +140,7 @@ ZFCallback::~ZFCallback(void)
 {
     if(d != zfnull)
     {
-        --d->refCount;
-        if(d->refCount == 0)
-        {
-            zfdelete(d);
-        }
+        _ZFP_ZFCallbackPrivateRelease(d);
     }
 }
 ZFCallback ZFCallback::_ZFP_ZFCallbackCreate(ZF_IN ZFCallbackType callbackType,
@@ -125,7 +151,7 @@ ZFCallback ZFCallback::_ZFP_ZFCallbackCreate(ZF_IN ZFCallbackType callbackType,
                                              ZF_IN _ZFP_ZFCallbackLambda::DestroyCallback callbackLambdaImplDestroy)
 {
     ZFCallback callback;
-    callback.d = zfnew(_ZFP_ZFCallbackPrivate);
+    callback.d = zfpoolNew(_ZFP_ZFCallbackPrivate);
     switch(callbackType)
     {
         case ZFCallbackTypeDummy:
@@ -175,7 +201,7 @@ ZFCallback ZFCallback::_ZFP_ZFCallbackCreate(ZF_IN ZFCallbackType callbackType,
 
 zfindex ZFCallback::objectRetainCount(void) const
 {
-    return (d ? d->refCount : 1);
+    return (d ? (zfindex)zfAtomicLoad(d->refCount) : 1);
 }
 
 void ZFCallback::objectInfoT(ZF_IN_OUT zfstring &ret) const
@@ -204,10 +230,10 @@ void ZFCallback::objectInfoT(ZF_IN_OUT zfstring &ret) const
         ret += ", owner: ";
         this->callbackOwnerObject()->objectInfoT(ret);
     }
-    if(d != zfnull && !d->callbackTagMap.empty())
+    if(d != zfnull && d->ext != zfnull && !d->ext->callbackTagMap.empty())
     {
         ret += ", tags: ";
-        _ZFP_ZFCallbackTagMap &m = d->callbackTagMap;
+        _ZFP_ZFCallbackTagMap &m = d->ext->callbackTagMap;
         for(_ZFP_ZFCallbackTagMap::iterator it = m.begin(); it != m.end(); ++it)
         {
             if(it != m.begin())
@@ -238,17 +264,21 @@ void ZFCallback::callbackId(ZF_IN const zfchar *callbackId)
 {
     if(d == zfnull)
     {
-        d = zfnew(_ZFP_ZFCallbackPrivate);
+        d = zfpoolNew(_ZFP_ZFCallbackPrivate);
     }
     if(callbackId != zfnull && *callbackId == '\0')
     {
         callbackId = zfnull;
     }
-    zfsChange(d->callbackId, callbackId);
+    if(callbackId == zfnull && d->ext == zfnull)
+    {
+        return ;
+    }
+    zfsChange(d->extAccess()->callbackId, callbackId);
 }
 const zfchar *ZFCallback::callbackId(void) const
 {
-    return (d ? d->callbackId : zfnull);
+    return ((d && d->ext) ? d->ext->callbackId : zfnull);
 }
 
 void ZFCallback::callbackTag(ZF_IN const zfchar *key,
@@ -260,10 +290,15 @@ void ZFCallback::callbackTag(ZF_IN const zfchar *key,
     }
     if(d == zfnull)
     {
-        d = zfnew(_ZFP_ZFCallbackPrivate);
+        d = zfpoolNew(_ZFP_ZFCallbackPrivate);
     }
 
-    _ZFP_ZFCallbackTagMap &m = d->callbackTagMap;
+    if(tag == zfnull && d->ext == zfnull)
+    {
+        return ;
+    }
+
+    _ZFP_ZFCallbackTagMap &m = d->extAccess()->callbackTagMap;
     _ZFP_ZFCallbackTagMap::iterator it = m.find(key);
     if(it == m.end())
     {
@@ -290,9 +325,9 @@ void ZFCallback::callbackTag(ZF_IN const zfchar *key,
 }
 ZFObject *ZFCallback::callbackTag(ZF_IN const zfchar *key) const
 {
-    if(d != zfnull && key != zfnull)
+    if(d != zfnull && d->ext != zfnull && key != zfnull)
     {
-        _ZFP_ZFCallbackTagMap &m = d->callbackTagMap;
+        _ZFP_ZFCallbackTagMap &m = d->ext->callbackTagMap;
         _ZFP_ZFCallbackTagMap::iterator it = m.find(key);
         if(it != m.end())
         {
@@ -304,9 +339,9 @@ ZFObject *ZFCallback::callbackTag(ZF_IN const zfchar *key) const
 void ZFCallback::callbackTagGetAllKeyValue(ZF_IN_OUT ZFCoreArray<const zfchar *> &allKey,
                                            ZF_IN_OUT ZFCoreArray<ZFObject *> &allValue) const
 {
-    if(d != zfnull)
+    if(d != zfnull && d->ext != zfnull)
     {
-        _ZFP_ZFCallbackTagMap &m = d->callbackTagMap;
+        _ZFP_ZFCallbackTagMap &m = d->ext->callbackTagMap;
         allKey.capacity(allKey.count() + m.size());
         allValue.capacity(allValue.count() + m.size());
         for(_ZFP_ZFCallbackTagMap::iterator it = m.begin(); it != m.end(); ++it)
@@ -318,9 +353,9 @@ void ZFCallback::callbackTagGetAllKeyValue(ZF_IN_OUT ZFCoreArray<const zfchar *>
 }
 zfautoObject ZFCallback::callbackTagRemoveAndGet(ZF_IN const zfchar *key)
 {
-    if(d != zfnull && key != zfnull)
+    if(d != zfnull && d->ext != zfnull && key != zfnull)
     {
-        _ZFP_ZFCallbackTagMap &m = d->callbackTagMap;
+        _ZFP_ZFCallbackTagMap &m = d->ext->callbackTagMap;
         _ZFP_ZFCallbackTagMap::iterator it = m.find(key);
         if(it != m.end())
         {
@@ -333,10 +368,10 @@ zfautoObject ZFCallback::callbackTagRemoveAndGet(ZF_IN const zfchar *key)
 }
 void ZFCallback::callbackTagRemoveAll(void)
 {
-    if(d != zfnull && !d->callbackTagMap.empty())
+    if(d != zfnull && d->ext != zfnull && !d->ext->callbackTagMap.empty())
     {
         _ZFP_ZFCallbackTagMap tmp;
-        tmp.swap(d->callbackTagMap);
+        tmp.swap(d->ext->callbackTagMap);
     }
 }
 
@@ -389,72 +424,78 @@ void ZFCallback::callbackSerializeCustomType(ZF_IN const zfchar *customType)
 {
     if(d == zfnull)
     {
-        d = zfnew(_ZFP_ZFCallbackPrivate);
+        d = zfpoolNew(_ZFP_ZFCallbackPrivate);
+    }
+    if(customType == zfnull && d->ext == zfnull)
+    {
+        return ;
     }
-    zfsChange(d->serializableCustomType, customType);
+    zfsChange(d->extAccess()->serializableCustomType, customType);
 }
 const zfchar *ZFCallback::callbackSerializeCustomType(void) const
 {
-    return (d ? d->serializableCustomType : zfnull);
+    return ((d && d->ext) ? d->ext->serializableCustomType : zfnull);
 }
 void ZFCallback::callbackSerializeCustomData(ZF_IN const ZFSerializableData *customData)
 {
     if(d == zfnull)
     {
-        d = zfnew(_ZFP_ZFCallbackPrivate);
+        d = zfpoolNew(_ZFP_ZFCallbackPrivate);
     }
     if(customData == zfnull)
     {
-        if(d->serializableCustomData != zfnull)
+        if(d->ext != zfnull && d->ext->serializableCustomData != zfnull)
         {
-            zfdelete(d->serializableCustomData);
-            d->serializableCustomData = zfnull;
+            zfdelete(d->ext->serializableCustomData);
+            d->ext->serializableCustomData = zfnull;
         }
     }
     else
     {
-        if(d->serializableCustomData != zfnull)
+        _ZFP_ZFCallbackPrivateExt *ext = d->extAccess();
+        if(ext->serializableCustomData != zfnull)
         {
-            *(d->serializableCustomData) = *customData;
+            *(ext->serializableCustomData) = *customData;
         }
         else
         {
-            d->serializableCustomData = zfnew(ZFSerializableData, *customData);
+            ext->serializableCustomData = zfnew(ZFSerializableData, *customData);
         }
     }
 }
 const ZFSerializableData *ZFCallback::callbackSerializeCustomData(void) const
 {
-    return (d ? d->serializableCustomData : zfnull);
+    return ((d && d->ext) ? d->ext->serializableCustomData : zfnull);
 }
 
 const ZFPathInfo *ZFCallback::pathInfo(void) const
 {
-    return (d ? d->pathInfo : zfnull);
+    return ((d && d->ext) ? d->ext->pathInfo : zfnull);
 }
 void ZFCallback::pathInfo(ZF_IN const ZFPathInfo *pathInfo)
 {
     if(d == zfnull)
     {
-        d = zfnew(_ZFP_ZFCallbackPrivate);
+        d = zfpoolNew(_ZFP_ZFCallbackPrivate);
     }
     if(pathInfo != zfnull && !(pathInfo->pathType.isEmpty() && pathInfo->pathData.isEmpty()))
     {
-        if(d->pathInfo == zfnull)
+        _ZFP_ZFCallbackPrivateExt *ext = d->extAccess();
+        if(ext->pathInfo == zfnull)
         {
-            d->pathInfo = zfnew(ZFPathInfo, *pathInfo);
+            ext->pathInfo = zfnew(ZFPathInfo, *pathInfo);
         }
         else
         {
-            *(d->pathInfo) = *pathInfo;
+            *(ext->pathInfo) = *pathInfo;
         }
     }
     else
     {
-        if(d->pathInfo != zfnull)
+        if(d->ext != zfnull && d->ext->pathInfo != zfnull)
         {
-            zfdelete(d->pathInfo);
-            d->pathInfo = zfnull;
+            zfdelete(d->ext->pathInfo);
+            d->ext->pathInfo = zfnull;
         }
     }
 }
@@ -462,26 +503,27 @@ void ZFCallback::pathInfo(ZF_IN const zfchar *pathType, ZF_IN const zfchar *path
 {
     if(d == zfnull)
     {
-        d = zfnew(_ZFP_ZFCallbackPrivate);
+        d = zfpoolNew(_ZFP_ZFCallbackPrivate);
     }
     if(!zfsIsEmpty(pathType) || !zfsIsEmpty(pathData))
     {
-        if(d->pathInfo == zfnull)
+        _ZFP_ZFCallbackPrivateExt *ext = d->extAccess();
+        if(ext->pathInfo == zfnull)
         {
-            d->pathInfo = zfnew(ZFPathInfo, pathType, pathData);
+            ext->pathInfo = zfnew(ZFPathInfo, pathType, pathData);
         }
         else
         {
-            d->pathInfo->pathType = pathType;
-            d->pathInfo->pathData = pathData;
+            ext->pathInfo->pathType = pathType;
+            ext->pathInfo->pathData = pathData;
         }
     }
     else
     {
-        if(d->pathInfo != zfnull)
+        if(d->ext != zfnull && d->ext->pathInfo != zfnull)
         {
-            zfdelete(d->pathInfo);
-            d->pathInfo = zfnull;
+            zfdelete(d->ext->pathInfo);
+            d->ext->pathInfo = zfnull;
         }
     }
 }
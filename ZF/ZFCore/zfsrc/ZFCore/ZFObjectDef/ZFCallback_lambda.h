@@ -277,6 +277,15 @@ ZF_NAMESPACE_GLOBAL_BEGIN
 
 #define _ZFP_ZFLAMBDA_N_VA_EXPAND(...) , ##__VA_ARGS__
 
+// ============================================================
+// lambda impl is allocated from memory pool, and freed by zfpoolDelete in _ZFP_D,
+// capture list is appended as constructor params: _ZFP_ZFLambdaAlloc(T)(capture0, ...)
+#if ZF_ENV_ZFMEMPOOL_ENABLE
+    #define _ZFP_ZFLambdaAlloc(T_Type) new (_ZFP_zfpoolObjectHolder<T_Type>::poolMalloc()) T_Type
+#else
+    #define _ZFP_ZFLambdaAlloc(T_Type) new T_Type
+#endif
+
 // ============================================================
 #define _ZFP_ZFLambdaCapture_EXPAND(...) __VA_ARGS__
 #define _ZFP_ZFLambdaCapture_EMPTY(...)
@@ -301,7 +310,7 @@ ZF_NAMESPACE_GLOBAL_BEGIN
         typedef ReturnType _ZFP_Ret; \
         static void _ZFP_D(ZF_IN _ZFP_ZFCallbackLambda *impl) \
         { \
-            delete impl; \
+            zfpoolDelete((_ZFP_ZFLambdaI_##name *)impl); \
         } \
         static _ZFP_Ret _ZFP_I(ZF_IN _ZFP_ZFCallbackLambda *_ZFP_this \
             ParamExpandOrEmpty0(ZFM_COMMA() ParamType0 param0) \
@@ -386,7 +395,7 @@ ZF_NAMESPACE_GLOBAL_BEGIN
         zfnull, \
         zfnull, \
         zfnull, \
-        new _ZFP_ZFLambdaI_##name( \
+        _ZFP_ZFLambdaAlloc(_ZFP_ZFLambdaI_##name)( \
             CaptureExpandOrEmpty0(ZFM_EMPTY() capture0) \
             CaptureExpandOrEmpty1(ZFM_COMMA() capture1) \
             CaptureExpandOrEmpty2(ZFM_COMMA() capture2) \
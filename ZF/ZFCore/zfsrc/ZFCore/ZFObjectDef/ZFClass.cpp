@@ -1,30 +1,144 @@
 #include "ZFObjectCore.h"
 #include "ZFObjectImpl.h"
+#include "ZFObjectAllocTrack.h"
 
 #include "ZFCore/ZFSTLWrapper/zfstl_string.h"
 #include "ZFCore/ZFSTLWrapper/zfstl_vector.h"
 #include "ZFCore/ZFSTLWrapper/zfstl_deque.h"
 #include "ZFCore/ZFSTLWrapper/zfstl_map.h"
+#include "ZFCore/ZFSTLWrapper/zfstl_hashmap.h"
+#include <algorithm>
 
 ZF_NAMESPACE_GLOBAL_BEGIN
 
+/*
+ * class lookup table, keyed by ZFClass::classNameFull,
+ * open addressing with stored hash, so lookup won't construct any temp string
+ * and typically touches only one slot
+ */
+typedef ZFCoreHashMap<ZFClass *> _ZFP_ZFClassMapType;
+
+/*
+ * method and property lookup tables,
+ * registering only appends to ZFClass's methodList or propertyList,
+ * tables are rebuilt at once when first accessed after change
+ *
+ * list is sorted by name, to keep methodGetAll and propertyGetAll stable,
+ * index is keyed by the name string owned by the member in list,
+ * so lookup won't construct any temp string
+ */
+zfclassPOD _ZFP_ZFClassMemberRange
+{
+public:
+    zfindex index;
+    zfindex count;
+};
+zfclassNotPOD _ZFP_ZFClassMethodTableType
+{
+public:
+    zfstlvector<const ZFMethod *> list;
+    zfstlhashmap<const zfchar *, _ZFP_ZFClassMemberRange, zfcharConst_zfstlHasher, zfcharConst_zfstlHashComparer> index;
+};
+zfclassNotPOD _ZFP_ZFClassPropertyTableType
+{
+public:
+    zfstlvector<const ZFProperty *> list;
+    zfstlhashmap<const zfchar *, const ZFProperty *, zfcharConst_zfstlHasher, zfcharConst_zfstlHashComparer> index;
+};
+
+static zfbool _ZFP_ZFClassMethodSortByName(ZF_IN const ZFMethod *m0, ZF_IN const ZFMethod *m1)
+{
+    return (zfscmp(m0->methodName(), m1->methodName()) < 0);
+}
+static zfbool _ZFP_ZFClassPropertySortByName(ZF_IN const ZFProperty *p0, ZF_IN const ZFProperty *p1)
+{
+    return (zfscmp(p0->propertyName(), p1->propertyName()) < 0);
+}
+// t.list must be filled, method of same name would keep the original order
+static void _ZFP_ZFClassMethodTableBuild(ZF_IN_OUT _ZFP_ZFClassMethodTableType &t)
+{
+    zfstl::stable_sort(t.list.begin(), t.list.end(), _ZFP_ZFClassMethodSortByName);
+    t.index.clear();
+    for(zfstlsize i = 0; i < t.list.size(); )
+    {
+        _ZFP_ZFClassMemberRange &range = t.index[t.list[i]->methodName()];
+        range.index = (zfindex)i;
+        range.count = 1;
+        for(++i; i < t.list.size() && zfscmpTheSame(t.list[i]->methodName(), t.list[range.index]->methodName()); ++i)
+        {
+            ++range.count;
+        }
+    }
+}
+// t.list must be filled, return false if duplicated name exists
+static zfbool _ZFP_ZFClassPropertyTableBuild(ZF_IN_OUT _ZFP_ZFClassPropertyTableType &t,
+                                             ZF_OUT_OPT const zfchar **duplicatedName = zfnull)
+{
+    zfstl::sort(t.list.begin(), t.list.end(), _ZFP_ZFClassPropertySortByName);
+    t.index.clear();
+    for(zfstlsize i = 0; i < t.list.size(); ++i)
+    {
+        const ZFProperty *&p = t.index[t.list[i]->propertyName()];
+        if(p != zfnull)
+        {
+            if(duplicatedName != zfnull)
+            {
+                *duplicatedName = p->propertyName();
+            }
+            return zffalse;
+        }
+        p = t.list[i];
+    }
+    return zftrue;
+}
+// return first index with the name, and store count of method with the name to count
+static zfindex _ZFP_ZFClassMethodTableFind(ZF_IN const _ZFP_ZFClassMethodTableType &t,
+                                           ZF_IN const zfchar *name,
+                                           ZF_OUT zfindex &count)
+{
+    zfstlhashmap<const zfchar *, _ZFP_ZFClassMemberRange, zfcharConst_zfstlHasher, zfcharConst_zfstlHashComparer>::const_iterator it = t.index.find(name);
+    if(it == t.index.end())
+    {
+        count = 0;
+        return 0;
+    }
+    count = it->second.count;
+    return it->second.index;
+}
+static const ZFProperty *_ZFP_ZFClassPropertyTableFind(ZF_IN const _ZFP_ZFClassPropertyTableType &t,
+                                                       ZF_IN const zfchar *name)
+{
+    zfstlhashmap<const zfchar *, const ZFProperty *, zfcharConst_zfstlHasher, zfcharConst_zfstlHashComparer>::const_iterator it = t.index.find(name);
+    return (it != t.index.end() ? it->second : zfnull);
+}
+
 // ============================================================
 // ZFClass's global data
 ZF_STATIC_INITIALIZER_INIT(ZFClassDataHolder)
 {
+    this->classMapLock = 0;
+    this->interfaceIdGenerator = 0;
 }
 ZF_STATIC_INITIALIZER_DESTROY(ZFClassDataHolder)
 {
-    ZFCoreMap classMapTmp = this->classMap;
-    ZFCoreMap delayDeleteMapTmp = this->delayDeleteMap;
-    this->classMap = ZFCoreMap();
-    this->delayDeleteMap = ZFCoreMap();
+    _ZFP_ZFClassMapType classMapTmp;
+    zfstldeque<ZFClass *> delayDeleteListTmp;
+    classMapTmp.swap(this->classMap);
+    delayDeleteListTmp.swap(this->delayDeleteList);
 
-    delayDeleteMapTmp.removeAll();
-    classMapTmp.removeAll();
+    for(zfstlsize i = 0; i < delayDeleteListTmp.size(); ++i)
+    {
+        zfdelete(delayDeleteListTmp[i]);
+    }
+    for(zfindex i = classMapTmp.indexFirst(); i != zfindexMax(); i = classMapTmp.indexNext(i))
+    {
+        zfdelete(classMapTmp.valueAt(i));
+    }
 }
-ZFCoreMap classMap; // <classNameFull, ZFClass *>
-ZFCoreMap delayDeleteMap; // <classNameFull, ZFClass *>
+zfatomicint classMapLock; // read write lock for classMap only
+_ZFP_ZFClassMapType classMap; // <classNameFull, ZFClass *>
+zfstldeque<ZFClass *> delayDeleteList;
+zfindex interfaceIdGenerator; // see _ZFP_ZFClassPrivate::interfaceId
 /*
  * delay delete a class
  * ZFClass may be registered by different module,
@@ -39,8 +153,10 @@ ZFCoreMap delayDeleteMap; // <classNameFull, ZFClass *>
  * but did resolve most cases
  */
 ZF_STATIC_INITIALIZER_END(ZFClassDataHolder)
+#define _ZFP_ZFClassMapLock (ZF_STATIC_INITIALIZER_INSTANCE(ZFClassDataHolder)->classMapLock)
 #define _ZFP_ZFClassMap (ZF_STATIC_INITIALIZER_INSTANCE(ZFClassDataHolder)->classMap)
-#define _ZFP_ZFClassDelayDeleteMap (ZF_STATIC_INITIALIZER_INSTANCE(ZFClassDataHolder)->delayDeleteMap)
+#define _ZFP_ZFClassInterfaceIdGenerator (ZF_STATIC_INITIALIZER_INSTANCE(ZFClassDataHolder)->interfaceIdGenerator)
+#define _ZFP_ZFClassDelayDeleteList (ZF_STATIC_INITIALIZER_INSTANCE(ZFClassDataHolder)->delayDeleteList)
 
 // ============================================================
 // _ZFP_ZFClassPrivate
@@ -83,6 +199,7 @@ public:
     _ZFP_zfAllocWithCacheCallback objectAllocWithCacheCallback;
     _ZFP_ZFObjectConstructor constructor;
     _ZFP_ZFObjectDestructor destructor;
+    zfindex objectSize; // sizeof the object's C++ type, 0 for abstract class or interface
     zfstring classNamespace;
     zfstring className;
     zfstring classNameFull;
@@ -96,10 +213,14 @@ public:
     zfbool internalTypesNeedAutoRegister; // used to register ZFMethod and ZFProperty
     zfbool needFinalInit;
     ZFCoreArrayPOD<const ZFClass *> implementedInterface;
-    zfstlmap<zfstlstringZ, zfstlvector<const ZFMethod *> > methodMap;
-    ZFCoreArrayPOD<const ZFMethod *> methodList;
-    ZFCoreArrayPOD<const ZFProperty *> propertyList;
-    ZFCoreMap propertyMap; // map to const ZFProperty *
+    ZFCoreArrayPOD<const ZFMethod *> methodList; // in register order
+    ZFCoreArrayPOD<const ZFProperty *> propertyList; // in register order
+    /*
+     * true during batch register of the class's members,
+     * see _ZFP_ZFClass_methodAndPropertyAutoRegister
+     */
+    zfbool memberBatchRegister;
+    zfbool memberBatchChanged;
     /*
      * store all property that has override parent's OnInit step by #ZFPROPERTY_OVERRIDE_ON_INIT_DECLARE
      * including self and all parent
@@ -124,9 +245,23 @@ public:
 public:
     zfstlmap<zfstlstringZ, zfbool> classDataChangeAutoRemoveTagList;
 
+public:
+    _ZFP_ZFObjectAllocTrackData allocTrack;
+
 public:
     const ZFClass **parentListCache; // all parent including self
     const ZFClass **parentInterfaceListCache; // all parent interface, count may differ from interfaceCastListCache
+    /*
+     * for classIsTypeOf, to achieve constant time check:
+     * * for class, parentListCache ordered from self to root,
+     *   parentListCache[classDepth - cls->classDepth] is cls if this is type of cls
+     * * for interface, each interface has an unique id,
+     *   and interfaceBitSet stores all id of parentInterfaceListCache
+     */
+    zfindex classDepth; // 0 for root class
+    zfindex interfaceId; // zfindexMax() if not interface
+    zfuint *interfaceBitSet;
+    zfindex interfaceBitSetSize; // count of zfuint in interfaceBitSet
     const ZFClass **interfaceCastListCache; // all parent implemented interface, for interface cast
     _ZFP_ZFObjectToInterfaceCastCallback *interfaceCastCallbackListCache;
 
@@ -145,14 +280,19 @@ public:
      */
     zfstlvector<const ZFClass *> methodAndPropertyFindCache;
     /*
-     * cache for propertyForName, recursively from child to parent
+     * built from methodList and propertyList, for IgnoreParent series
      */
-    zfstlmap<zfstlstringZ, const ZFProperty *> propertyMapCache;
+    _ZFP_ZFClassMethodTableType methodTable;
+    _ZFP_ZFClassPropertyTableType propertyTable;
     /*
-     * cache for methodForName, child one would override parent
+     * built from all class in methodAndPropertyFindCache,
+     * method of same name are ordered from child to parent,
+     * property of same name is not allowed
      */
-    zfstlmap<zfstlstringZ, zfstlvector<const ZFMethod *> > methodMapCache;
-    zfbool methodMapCacheNeedUpdate;
+    _ZFP_ZFClassMethodTableType methodTableCache;
+    _ZFP_ZFClassPropertyTableType propertyTableCache;
+    zfbool memberTableNeedUpdate; // methodTable and propertyTable
+    zfbool memberTableCacheNeedUpdate; // methodTableCache and propertyTableCache
 
 public:
     zfclassLikePOD InstanceObserverData
@@ -250,6 +390,7 @@ public:
     , classDynamicRegisterObjectInstanceMap()
     , constructor(zfnull)
     , destructor(zfnull)
+    , objectSize(0)
     , classNamespace()
     , className()
     , classNameFull()
@@ -261,24 +402,31 @@ public:
     , internalTypesNeedAutoRegister(zftrue)
     , needFinalInit(zftrue)
     , implementedInterface()
-    , methodMap()
     , methodList()
     , propertyList()
-    , propertyMap()
+    , memberBatchRegister(zffalse)
+    , memberBatchChanged(zffalse)
     , propertyAutoInitMap()
     , propertyInitStepMap()
     , classTagMap()
     , classDataChangeAutoRemoveTagList()
     , parentListCache(zfnull)
     , parentInterfaceListCache(zfnull)
+    , classDepth(0)
+    , interfaceId(zfindexMax())
+    , interfaceBitSet(zfnull)
+    , interfaceBitSetSize(0)
     , interfaceCastListCache(zfnull)
     , interfaceCastCallbackListCache(zfnull)
     , allParent()
     , allChildren()
     , methodAndPropertyFindCache()
-    , propertyMapCache()
-    , methodMapCache()
-    , methodMapCacheNeedUpdate(zftrue)
+    , methodTable()
+    , propertyTable()
+    , methodTableCache()
+    , propertyTableCache()
+    , memberTableNeedUpdate(zftrue)
+    , memberTableCacheNeedUpdate(zftrue)
     , instanceObserver()
     , instanceObserverCached()
     {
@@ -293,6 +441,8 @@ public:
         this->parentListCache = zfnull;
         zffree(this->parentInterfaceListCache);
         this->parentInterfaceListCache = zfnull;
+        zffree(this->interfaceBitSet);
+        this->interfaceBitSet = zfnull;
         zffree(this->interfaceCastListCache);
         this->interfaceCastListCache = zfnull;
         zffree(this->interfaceCastCallbackListCache);
@@ -305,7 +455,13 @@ public:
 static void _ZFP_ZFClass_classTagClear(void)
 {
     ZFCoreArrayPOD<const ZFClass *> allClass;
-    _ZFP_ZFClassMap.allValueT(allClass);
+    {
+        zfAtomicReadLocker(_ZFP_ZFClassMapLock);
+        for(zfindex i = _ZFP_ZFClassMap.indexFirst(); i != zfindexMax(); i = _ZFP_ZFClassMap.indexNext(i))
+        {
+            allClass.add(_ZFP_ZFClassMap.valueAt(i));
+        }
+    }
     for(zfindex i = 0; i < allClass.count(); ++i)
     {
         allClass.get(i)->classTagRemoveAll();
@@ -330,9 +486,19 @@ ZF_GLOBAL_INITIALIZER_END(ZFClassTagClearLevelHigh)
 
 // ============================================================
 // static methods
+static const ZFClass *_ZFP_ZFClassForName(ZF_IN const zfchar *classNameFull)
+{
+    if(classNameFull == zfnull)
+    {
+        return zfnull;
+    }
+    zfAtomicReadLocker(_ZFP_ZFClassMapLock);
+    ZFClass **cls = _ZFP_ZFClassMap.get(classNameFull);
+    return ((cls != zfnull) ? *cls : zfnull);
+}
 const ZFClass *ZFClass::classForName(ZF_IN const zfchar *className)
 {
-    return _ZFP_ZFClassMap.get<const ZFClass *>(ZFNamespaceSkipGlobal(className));
+    return _ZFP_ZFClassForName(ZFNamespaceSkipGlobal(className));
 }
 const ZFClass *ZFClass::classForName(ZF_IN const zfchar *className,
                                      ZF_IN const zfchar *classNamespace)
@@ -344,11 +510,11 @@ const ZFClass *ZFClass::classForName(ZF_IN const zfchar *className,
         classNameFull += classNamespace;
         classNameFull += ZFNamespaceSeparator();
         classNameFull += className;
-        return _ZFP_ZFClassMap.get<const ZFClass *>(classNameFull);
+        return _ZFP_ZFClassForName(classNameFull);
     }
     else
     {
-        return _ZFP_ZFClassMap.get<const ZFClass *>(className);
+        return _ZFP_ZFClassForName(className);
     }
 }
 
@@ -522,18 +688,21 @@ void ZFClass::objectInfoOfInheritTreeT(ZF_IN_OUT zfstring &ret) const
     }
 }
 
+#define _ZFP_ZFClassInterfaceBitSetBits (sizeof(zfuint) * 8)
 zfbool ZFClass::classIsTypeOf(ZF_IN const ZFClass *cls) const
 {
-    const ZFClass **p = (cls->d->isInterface ? d->parentInterfaceListCache : d->parentListCache);
-    do
+    if(cls->d->isInterface)
     {
-        if(*p == cls)
-        {
-            return zftrue;
-        }
-        ++p;
-    } while(*p);
-    return zffalse;
+        zfindex interfaceId = cls->d->interfaceId;
+        zfindex index = interfaceId / _ZFP_ZFClassInterfaceBitSetBits;
+        return (index < d->interfaceBitSetSize
+            && (d->interfaceBitSet[index] & ((zfuint)1 << (interfaceId % _ZFP_ZFClassInterfaceBitSetBits))) != 0);
+    }
+    else
+    {
+        return (cls->d->classDepth <= d->classDepth
+            && d->parentListCache[d->classDepth - cls->d->classDepth] == cls);
+    }
 }
 
 zfbool ZFClass::classIsDynamicRegister(void) const
@@ -714,12 +883,10 @@ const ZFMethod *ZFClass::methodAtIndex(ZF_IN zfindex index) const
 void ZFClass::methodGetAllT(ZF_IN_OUT ZFCoreArray<const ZFMethod *> &ret) const
 {
     this->_ZFP_ZFClass_methodAndPropertyAutoRegister();
-    for(zfstlmap<zfstlstringZ, zfstlvector<const ZFMethod *> >::iterator it = d->methodMapCache.begin(); it != d->methodMapCache.end(); ++it)
+    this->_ZFP_ZFClass_memberTableCacheUpdate();
+    if(!d->methodTableCache.list.empty())
     {
-        for(zfstlsize i = 0; i < it->second.size(); ++i)
-        {
-            ret.add(it->second[i]);
-        }
+        ret.addFrom(&(d->methodTableCache.list[0]), (zfindex)d->methodTableCache.list.size());
     }
 }
 
@@ -735,48 +902,44 @@ const ZFMethod *ZFClass::methodForNameIgnoreParent(ZF_IN const zfchar *methodNam
                                                    , ZF_IN_OPT const zfchar *methodParamTypeId7 /* = zfnull */
                                                    ) const
 {
-    this->_ZFP_ZFClass_methodAndPropertyAutoRegister();
-
-    if(!d->methodMap.empty())
+    if(methodName == zfnull)
     {
-        zfstlmap<zfstlstringZ, zfstlvector<const ZFMethod *> >::iterator itName = d->methodMap.find(methodName);
-        if(itName != d->methodMap.end())
+        return zfnull;
+    }
+    this->_ZFP_ZFClass_methodAndPropertyAutoRegister();
+    this->_ZFP_ZFClass_memberTableUpdate();
+    zfindex count = 0;
+    zfindex index = _ZFP_ZFClassMethodTableFind(d->methodTable, methodName, count);
+    for(zfindex i = index; i < index + count; ++i)
+    {
+        const ZFMethod *m = d->methodTable.list[i];
+        if(m->methodParamTypeIdIsMatch(
+                  methodParamTypeId0
+                , methodParamTypeId1
+                , methodParamTypeId2
+                , methodParamTypeId3
+                , methodParamTypeId4
+                , methodParamTypeId5
+                , methodParamTypeId6
+                , methodParamTypeId7
+            ))
         {
-            zfstlvector<const ZFMethod *> &l = itName->second;
-            for(zfstlsize i = 0; i < l.size(); ++i)
-            {
-                const ZFMethod *m = l[i];
-                if(m->methodParamTypeIdIsMatch(
-                          methodParamTypeId0
-                        , methodParamTypeId1
-                        , methodParamTypeId2
-                        , methodParamTypeId3
-                        , methodParamTypeId4
-                        , methodParamTypeId5
-                        , methodParamTypeId6
-                        , methodParamTypeId7
-                    ))
-                {
-                    return m;
-                }
-            }
+            return m;
         }
     }
     return zfnull;
 }
 const ZFMethod *ZFClass::methodForNameIgnoreParent(ZF_IN const zfchar *methodName) const
 {
-    this->_ZFP_ZFClass_methodAndPropertyAutoRegister();
-
-    if(!d->methodMap.empty())
+    if(methodName == zfnull)
     {
-        zfstlmap<zfstlstringZ, zfstlvector<const ZFMethod *> >::iterator itName = d->methodMap.find(methodName);
-        if(itName != d->methodMap.end())
-        {
-            return itName->second[0];
-        }
+        return zfnull;
     }
-    return zfnull;
+    this->_ZFP_ZFClass_methodAndPropertyAutoRegister();
+    this->_ZFP_ZFClass_memberTableUpdate();
+    zfindex count = 0;
+    zfindex index = _ZFP_ZFClassMethodTableFind(d->methodTable, methodName, count);
+    return (count > 0 ? d->methodTable.list[index] : zfnull);
 }
 const ZFMethod *ZFClass::methodForName(ZF_IN const zfchar *methodName
                                        , ZF_IN const zfchar *methodParamTypeId0
@@ -794,15 +957,13 @@ const ZFMethod *ZFClass::methodForName(ZF_IN const zfchar *methodName
         return zfnull;
     }
     this->_ZFP_ZFClass_methodAndPropertyAutoRegister();
-    this->_ZFP_ZFClass_methodMapCacheUpdate();
-    zfstlmap<zfstlstringZ, zfstlvector<const ZFMethod *> >::iterator it = d->methodMapCache.find(methodName);
-    if(it == d->methodMapCache.end())
-    {
-        return zfnull;
-    }
-    for(zfindex i = 0; i < it->second.size(); ++i)
+    this->_ZFP_ZFClass_memberTableCacheUpdate();
+    zfindex count = 0;
+    zfindex index = _ZFP_ZFClassMethodTableFind(d->methodTableCache, methodName, count);
+    for(zfindex i = index; i < index + count; ++i)
     {
-        if(it->second[i]->methodParamTypeIdIsMatch(
+        const ZFMethod *m = d->methodTableCache.list[i];
+        if(m->methodParamTypeIdIsMatch(
                 methodParamTypeId0
                 , methodParamTypeId1
                 , methodParamTypeId2
@@ -813,7 +974,7 @@ const ZFMethod *ZFClass::methodForName(ZF_IN const zfchar *methodName
                 , methodParamTypeId7
             ))
         {
-            return it->second[i];
+            return m;
         }
     }
     return zfnull;
@@ -825,16 +986,10 @@ const ZFMethod *ZFClass::methodForName(ZF_IN const zfchar *methodName) const
         return zfnull;
     }
     this->_ZFP_ZFClass_methodAndPropertyAutoRegister();
-    this->_ZFP_ZFClass_methodMapCacheUpdate();
-    zfstlmap<zfstlstringZ, zfstlvector<const ZFMethod *> >::iterator it = d->methodMapCache.find(methodName);
-    if(it == d->methodMapCache.end())
-    {
-        return zfnull;
-    }
-    else
-    {
-        return it->second[0];
-    }
+    this->_ZFP_ZFClass_memberTableCacheUpdate();
+    zfindex count = 0;
+    zfindex index = _ZFP_ZFClassMethodTableFind(d->methodTableCache, methodName, count);
+    return (count > 0 ? d->methodTableCache.list[index] : zfnull);
 }
 void ZFClass::methodForNameGetAllT(ZF_IN_OUT ZFCoreArray<const ZFMethod *> &ret,
                                    ZF_IN const zfchar *methodName) const
@@ -844,11 +999,12 @@ void ZFClass::methodForNameGetAllT(ZF_IN_OUT ZFCoreArray<const ZFMethod *> &ret,
         return ;
     }
     this->_ZFP_ZFClass_methodAndPropertyAutoRegister();
-    this->_ZFP_ZFClass_methodMapCacheUpdate();
-    zfstlmap<zfstlstringZ, zfstlvector<const ZFMethod *> >::iterator it = d->methodMapCache.find(methodName);
-    if(it != d->methodMapCache.end())
+    this->_ZFP_ZFClass_memberTableCacheUpdate();
+    zfindex count = 0;
+    zfindex index = _ZFP_ZFClassMethodTableFind(d->methodTableCache, methodName, count);
+    if(count > 0)
     {
-        ret.addFrom(&(it->second[0]), (zfindex)it->second.size());
+        ret.addFrom(&(d->methodTableCache.list[index]), count);
     }
 }
 
@@ -873,21 +1029,22 @@ const ZFProperty *ZFClass::propertyAtIndex(ZF_IN zfindex index) const
 void ZFClass::propertyGetAllT(ZF_IN_OUT ZFCoreArray<const ZFProperty *> &ret) const
 {
     this->_ZFP_ZFClass_methodAndPropertyAutoRegister();
-    for(zfstlmap<zfstlstringZ, const ZFProperty *>::iterator it = d->propertyMapCache.begin(); it != d->propertyMapCache.end(); ++it)
+    this->_ZFP_ZFClass_memberTableCacheUpdate();
+    if(!d->propertyTableCache.list.empty())
     {
-        ret.add(it->second);
+        ret.addFrom(&(d->propertyTableCache.list[0]), (zfindex)d->propertyTableCache.list.size());
     }
 }
 
 const ZFProperty *ZFClass::propertyForNameIgnoreParent(const zfchar *propertyName) const
 {
-    this->_ZFP_ZFClass_methodAndPropertyAutoRegister();
-    if(!d->propertyMap.isEmpty())
+    if(propertyName == zfnull)
     {
-        const ZFProperty *t = d->propertyMap.get<const ZFProperty *>(propertyName);
-        return t;
+        return zfnull;
     }
-    return zfnull;
+    this->_ZFP_ZFClass_methodAndPropertyAutoRegister();
+    this->_ZFP_ZFClass_memberTableUpdate();
+    return _ZFP_ZFClassPropertyTableFind(d->propertyTable, propertyName);
 }
 const ZFProperty *ZFClass::propertyForName(const zfchar *propertyName) const
 {
@@ -896,82 +1053,54 @@ const ZFProperty *ZFClass::propertyForName(const zfchar *propertyName) const
         return zfnull;
     }
     this->_ZFP_ZFClass_methodAndPropertyAutoRegister();
-    zfstlmap<zfstlstringZ, const ZFProperty *>::iterator it = d->propertyMapCache.find(propertyName);
-    if(it == d->propertyMapCache.end())
-    {
-        return zfnull;
-    }
-    else
-    {
-        return it->second;
-    }
+    this->_ZFP_ZFClass_memberTableCacheUpdate();
+    return _ZFP_ZFClassPropertyTableFind(d->propertyTableCache, propertyName);
 }
 
-const ZFMethod *ZFClass::propertySetterForNameIgnoreParent(const zfchar *propertyName) const
+static const ZFMethod *_ZFP_ZFClassPropertyAccessorFind(ZF_IN const _ZFP_ZFClassMethodTableType &t,
+                                                        ZF_IN const zfchar *propertyName,
+                                                        ZF_IN zfindex paramCountMin)
 {
-    this->_ZFP_ZFClass_methodAndPropertyAutoRegister();
-
-    if(!d->methodMap.empty())
+    zfindex count = 0;
+    zfindex index = _ZFP_ZFClassMethodTableFind(t, propertyName, count);
+    for(zfindex i = index; i < index + count; ++i)
     {
-        zfstlmap<zfstlstringZ, zfstlvector<const ZFMethod *> >::iterator itName = d->methodMap.find(propertyName);
-        if(itName != d->methodMap.end())
+        if(t.list[i]->methodParamCountMin() == paramCountMin)
         {
-            zfstlvector<const ZFMethod *> &l = itName->second;
-            for(zfstlsize i = 0; i < l.size(); ++i)
-            {
-                const ZFMethod *m = l[i];
-                if(m->methodParamCountMin() == 1)
-                {
-                    return m;
-                }
-            }
+            return t.list[i];
         }
     }
     return zfnull;
 }
-const ZFMethod *ZFClass::propertySetterForName(const zfchar *propertyName) const
+const ZFMethod *ZFClass::propertySetterForNameIgnoreParent(const zfchar *propertyName) const
 {
     if(propertyName == zfnull)
     {
         return zfnull;
     }
     this->_ZFP_ZFClass_methodAndPropertyAutoRegister();
-    this->_ZFP_ZFClass_methodMapCacheUpdate();
-    zfstlmap<zfstlstringZ, zfstlvector<const ZFMethod *> >::iterator it = d->methodMapCache.find(propertyName);
-    if(it == d->methodMapCache.end())
+    this->_ZFP_ZFClass_memberTableUpdate();
+    return _ZFP_ZFClassPropertyAccessorFind(d->methodTable, propertyName, 1);
+}
+const ZFMethod *ZFClass::propertySetterForName(const zfchar *propertyName) const
+{
+    if(propertyName == zfnull)
     {
         return zfnull;
     }
-    for(zfindex i = 0; i < it->second.size(); ++i)
-    {
-        if(it->second[i]->methodParamCountMin() == 1)
-        {
-            return it->second[i];
-        }
-    }
-    return zfnull;
+    this->_ZFP_ZFClass_methodAndPropertyAutoRegister();
+    this->_ZFP_ZFClass_memberTableCacheUpdate();
+    return _ZFP_ZFClassPropertyAccessorFind(d->methodTableCache, propertyName, 1);
 }
 const ZFMethod *ZFClass::propertyGetterForNameIgnoreParent(const zfchar *propertyName) const
 {
-    this->_ZFP_ZFClass_methodAndPropertyAutoRegister();
-
-    if(!d->methodMap.empty())
+    if(propertyName == zfnull)
     {
-        zfstlmap<zfstlstringZ, zfstlvector<const ZFMethod *> >::iterator itName = d->methodMap.find(propertyName);
-        if(itName != d->methodMap.end())
-        {
-            zfstlvector<const ZFMethod *> &l = itName->second;
-            for(zfstlsize i = 0; i < l.size(); ++i)
-            {
-                const ZFMethod *m = l[i];
-                if(m->methodParamCountMin() == 0)
-                {
-                    return m;
-                }
-            }
-        }
+        return zfnull;
     }
-    return zfnull;
+    this->_ZFP_ZFClass_methodAndPropertyAutoRegister();
+    this->_ZFP_ZFClass_memberTableUpdate();
+    return _ZFP_ZFClassPropertyAccessorFind(d->methodTable, propertyName, 0);
 }
 const ZFMethod *ZFClass::propertyGetterForName(const zfchar *propertyName) const
 {
@@ -980,20 +1109,8 @@ const ZFMethod *ZFClass::propertyGetterForName(const zfchar *propertyName) const
         return zfnull;
     }
     this->_ZFP_ZFClass_methodAndPropertyAutoRegister();
-    this->_ZFP_ZFClass_methodMapCacheUpdate();
-    zfstlmap<zfstlstringZ, zfstlvector<const ZFMethod *> >::iterator it = d->methodMapCache.find(propertyName);
-    if(it == d->methodMapCache.end())
-    {
-        return zfnull;
-    }
-    for(zfindex i = 0; i < it->second.size(); ++i)
-    {
-        if(it->second[i]->methodParamCountMin() == 0)
-        {
-            return it->second[i];
-        }
-    }
-    return zfnull;
+    this->_ZFP_ZFClass_memberTableCacheUpdate();
+    return _ZFP_ZFClassPropertyAccessorFind(d->methodTableCache, propertyName, 0);
 }
 
 zfbool ZFClass::propertyHasOverrideInitStep(void) const
@@ -1122,6 +1239,7 @@ ZFClass *ZFClass::_ZFP_ZFClassRegister(ZF_IN zfbool *ZFCoreLibDestroyFlag,
                                        ZF_IN _ZFP_zfAllocWithCacheCallback objectAllocWithCacheCallback,
                                        ZF_IN _ZFP_ZFObjectConstructor constructor,
                                        ZF_IN _ZFP_ZFObjectDestructor destructor,
+                                       ZF_IN zfindex objectSize,
                                        ZF_IN _ZFP_ZFObjectCheckInitImplementationListCallback checkInitImplListCallback,
                                        ZF_IN zfbool isInterface,
                                        ZF_IN zfbool classIsDynamicRegister,
@@ -1142,11 +1260,12 @@ ZFClass *ZFClass::_ZFP_ZFClassRegister(ZF_IN zfbool *ZFCoreLibDestroyFlag,
     }
     classNameFull += className;
 
-    ZFCorePointerBase *d = _ZFP_ZFClassMap.get(classNameFull);
+    // writer always hold zfCoreMutex, no read lock necessary
+    ZFClass **clsExist = _ZFP_ZFClassMap.get(classNameFull.cString());
     ZFClass *cls = zfnull;
-    if(d != zfnull)
+    if(clsExist != zfnull)
     {
-        cls = d->pointerValueT<ZFClass *>();
+        cls = *clsExist;
         if(cls->d->isInterface != isInterface || cls->d->classParent != parent)
         {
             zfCoreCriticalMessageTrim("[ZFClass] register a class that already registered: %s", className);
@@ -1157,7 +1276,6 @@ ZFClass *ZFClass::_ZFP_ZFClassRegister(ZF_IN zfbool *ZFCoreLibDestroyFlag,
     else
     {
         cls = zfnew(ZFClass);
-        _ZFP_ZFClassMap.set(classNameFull, ZFCorePointerForObject<ZFClass *>(cls));
 
         if(ZFCoreLibDestroyFlag)
         {
@@ -1169,6 +1287,7 @@ ZFClass *ZFClass::_ZFP_ZFClassRegister(ZF_IN zfbool *ZFCoreLibDestroyFlag,
         cls->d->objectAllocWithCacheCallback = objectAllocWithCacheCallback;
         cls->d->constructor = constructor;
         cls->d->destructor = destructor;
+        cls->d->objectSize = objectSize;
 
         cls->d->classNamespace = classNamespace;
         cls->d->className = className;
@@ -1181,6 +1300,10 @@ ZFClass *ZFClass::_ZFP_ZFClassRegister(ZF_IN zfbool *ZFCoreLibDestroyFlag,
         cls->classParentCache = parent;
 
         cls->d->isInterface = isInterface;
+        if(isInterface)
+        {
+            cls->d->interfaceId = _ZFP_ZFClassInterfaceIdGenerator++;
+        }
 
         {
             const zfchar *filter = "_ZFP_";
@@ -1192,6 +1315,10 @@ ZFClass *ZFClass::_ZFP_ZFClassRegister(ZF_IN zfbool *ZFCoreLibDestroyFlag,
             const zfindex filterLen = zfslen(filter);
             cls->d->isInternalClass = (zfsncmp(className, filter, filterLen) == 0);
         }
+        {
+            zfAtomicWriteLocker(_ZFP_ZFClassMapLock);
+            _ZFP_ZFClassMap.set(cls->classNameFull(), cls);
+        }
     }
 
     if(checkInitImplListCallback)
@@ -1219,8 +1346,8 @@ void ZFClass::_ZFP_ZFClassUnregister(ZF_IN zfbool *ZFCoreLibDestroyFlag, ZF_IN c
         cls->d->classDynamicRegisterObjectInstanceMap.clear();
     }
 
-    zfiterator itClass = _ZFP_ZFClassMap.iteratorForKey(cls->classNameFull());
-    if(!_ZFP_ZFClassMap.iteratorIsValid(itClass))
+    zfindex itClass = _ZFP_ZFClassMap.indexForKey(cls->classNameFull());
+    if(itClass == zfindexMax())
     {
         zfCoreCriticalShouldNotGoHere();
         return ;
@@ -1236,9 +1363,11 @@ void ZFClass::_ZFP_ZFClassUnregister(ZF_IN zfbool *ZFCoreLibDestroyFlag, ZF_IN c
         return ;
     }
 
-    _ZFP_ZFClassDelayDeleteMap.set(cls->classNameFull(),
-        *_ZFP_ZFClassMap.iteratorValue(itClass));
-    _ZFP_ZFClassMap.iteratorRemove(itClass);
+    _ZFP_ZFClassDelayDeleteList.push_back(_ZFP_ZFClassMap.valueAt(itClass));
+    {
+        zfAtomicWriteLocker(_ZFP_ZFClassMapLock);
+        _ZFP_ZFClassMap.removeAt(itClass);
+    }
 
     if(!d->internalTypesNeedAutoRegister)
     {
@@ -1358,6 +1487,7 @@ void ZFClass::_ZFP_ZFClassInitFinish_parentListCache(ZF_IN ZFClass *cls)
     cls->d->parentListCache = (const ZFClass **)zfmalloc(sizeof(const ZFClass *) * (parentList.count() + 1));
     zfmemcpy(cls->d->parentListCache, parentList.arrayBuf(), sizeof(const ZFClass *) * parentList.count());
     cls->d->parentListCache[parentList.count()] = zfnull;
+    cls->d->classDepth = parentList.count() - 1;
 }
 void ZFClass::_ZFP_ZFClassInitFinish_parentInterfaceListCache(ZF_IN ZFClass *cls)
 { // init parent type list for better search performance
@@ -1392,6 +1522,25 @@ void ZFClass::_ZFP_ZFClassInitFinish_parentInterfaceListCache(ZF_IN ZFClass *cls
     cls->d->parentInterfaceListCache = (const ZFClass **)zfmalloc(sizeof(const ZFClass *) * (parentList.count() + 1));
     zfmemcpy(cls->d->parentInterfaceListCache, parentList.arrayBuf(), sizeof(const ZFClass *) * parentList.count());
     cls->d->parentInterfaceListCache[parentList.count()] = zfnull;
+
+    zfindex interfaceIdMax = 0;
+    for(zfindex i = 0; i < parentList.count(); ++i)
+    {
+        if(parentList[i]->d->interfaceId + 1 > interfaceIdMax)
+        {
+            interfaceIdMax = parentList[i]->d->interfaceId + 1;
+        }
+    }
+    cls->d->interfaceBitSetSize = (interfaceIdMax + _ZFP_ZFClassInterfaceBitSetBits - 1) / _ZFP_ZFClassInterfaceBitSetBits;
+    if(cls->d->interfaceBitSetSize > 0)
+    {
+        cls->d->interfaceBitSet = (zfuint *)zfmallocZero(sizeof(zfuint) * cls->d->interfaceBitSetSize);
+        for(zfindex i = 0; i < parentList.count(); ++i)
+        {
+            zfindex interfaceId = parentList[i]->d->interfaceId;
+            cls->d->interfaceBitSet[interfaceId / _ZFP_ZFClassInterfaceBitSetBits] |= ((zfuint)1 << (interfaceId % _ZFP_ZFClassInterfaceBitSetBits));
+        }
+    }
 }
 void ZFClass::_ZFP_ZFClassInitFinish_interfaceCastListCache(ZF_IN ZFClass *cls)
 { // copy parent's interface cast datas
@@ -1486,11 +1635,6 @@ void ZFClass::_ZFP_ZFClassInitFinish_methodAndPropertyFindCache(ZF_IN ZFClass *c
         alreadyChecked[clsTmp] = zftrue;
 
         cls->d->methodAndPropertyFindCache.push_back(clsTmp);
-        for(zfiterator it = clsTmp->d->propertyMap.iterator(); clsTmp->d->propertyMap.iteratorIsValid(it); )
-        {
-            const ZFProperty *zfproperty = clsTmp->d->propertyMap.iteratorNextValue<const ZFProperty *>(it);
-            cls->d->propertyMapCache[zfproperty->propertyName()] = zfproperty;
-        }
 
         for(zfindex i = clsTmp->implementedInterfaceCount() - 1; i != zfindexMax(); --i)
         {
@@ -1544,6 +1688,11 @@ void ZFClass::_ZFP_ZFClass_methodAndPropertyAutoRegister(void) const
         {
             d->internalTypesNeedAutoRegister = zffalse;
 
+            // register all members as one batch,
+            // member tables and change notify would be updated only once after batch
+            d->memberBatchRegister = zftrue;
+            d->memberBatchChanged = zffalse;
+
             // ClassData() registered here instead of ZFOBJECT_REGISTER,
             // to reduce output executable size and runtime memory usage,
             // unregistered during class unregister
@@ -1560,113 +1709,102 @@ void ZFClass::_ZFP_ZFClass_methodAndPropertyAutoRegister(void) const
                     d->destructor(d->constructor());
                 }
             }
+
+            d->memberBatchRegister = zffalse;
+            if(d->memberBatchChanged)
+            {
+                d->memberBatchChanged = zffalse;
+                this->_ZFP_ZFClass_memberChanged();
+                _ZFP_ZFClassDataChangeNotify(ZFClassDataChangeTypeUpdate, this, zfnull, zfnull);
+            }
         }
     }
 }
 
-void ZFClass::_ZFP_ZFClass_methodRegister(ZF_IN const ZFMethod *method) const
+zfbool ZFClass::_ZFP_ZFClass_memberBatchRegister(void) const
 {
-    zfstlvector<const ZFMethod *> &methodList = d->methodMap[method->methodName()];
-    methodList.push_back(method);
-    d->methodList.add(method);
-
-    if(!d->methodMapCacheNeedUpdate)
-    {
-        d->methodMapCache[method->methodName()].push_back(method);
-        for(zfstlmap<const ZFClass *, zfbool>::iterator itChild = d->allChildren.begin(); itChild != d->allChildren.end(); ++itChild)
-        {
-            itChild->first->d->methodMapCacheNeedUpdate = zftrue;
-        }
-    }
+    return d->memberBatchRegister;
 }
-void ZFClass::_ZFP_ZFClass_methodUnregister(ZF_IN const ZFMethod *method) const
+void ZFClass::_ZFP_ZFClass_memberChanged(void) const
 {
-    zfstlmap<zfstlstringZ, zfstlvector<const ZFMethod *> >::iterator itName = d->methodMap.find(method->methodName());
-    if(itName != d->methodMap.end())
+    if(d->memberBatchRegister)
     {
-        zfstlvector<const ZFMethod *> &l = itName->second;
-        for(zfstlsize i = 0; i < l.size(); ++i)
-        {
-            if(method == l[i])
-            {
-                l.erase(l.begin() + i);
-                if(l.empty())
-                {
-                    d->methodMap.erase(itName);
-                    break;
-                }
-                d->methodList.removeElement(method);
-            }
-        }
+        d->memberBatchChanged = zftrue;
+        return ;
     }
-
-    if(!d->methodMapCacheNeedUpdate)
+    d->memberTableNeedUpdate = zftrue;
+    d->memberTableCacheNeedUpdate = zftrue;
+    for(zfstlmap<const ZFClass *, zfbool>::iterator itChild = d->allChildren.begin(); itChild != d->allChildren.end(); ++itChild)
     {
-        zfstlmap<zfstlstringZ, zfstlvector<const ZFMethod *> >::iterator it = d->methodMapCache.find(method->methodName());
-        if(it != d->methodMapCache.end())
-        {
-            for(zfstlvector<const ZFMethod *>::iterator itTmp = it->second.begin(); itTmp != it->second.end(); ++itTmp)
-            {
-                if(*itTmp == method)
-                {
-                    it->second.erase(itTmp);
-                    break;
-                }
-            }
-        }
-        for(zfstlmap<const ZFClass *, zfbool>::iterator itChild = d->allChildren.begin(); itChild != d->allChildren.end(); ++itChild)
+        itChild->first->d->memberTableCacheNeedUpdate = zftrue;
+    }
+}
+void ZFClass::_ZFP_ZFClass_memberTableUpdate(void) const
+{
+    if(d->memberTableNeedUpdate)
+    {
+        zfCoreMutexLocker();
+        if(d->memberTableNeedUpdate)
         {
-            itChild->first->d->methodMapCacheNeedUpdate = zftrue;
+            d->methodTable.list.assign(d->methodList.arrayBuf(), d->methodList.arrayBuf() + d->methodList.count());
+            _ZFP_ZFClassMethodTableBuild(d->methodTable);
+            d->propertyTable.list.assign(d->propertyList.arrayBuf(), d->propertyList.arrayBuf() + d->propertyList.count());
+            _ZFP_ZFClassPropertyTableBuild(d->propertyTable);
+            d->memberTableNeedUpdate = zffalse;
         }
     }
 }
-
-void ZFClass::_ZFP_ZFClass_methodMapCacheUpdate(void) const
+void ZFClass::_ZFP_ZFClass_memberTableCacheUpdate(void) const
 {
-    if(d->methodMapCacheNeedUpdate)
+    if(d->memberTableCacheNeedUpdate)
     {
         zfCoreMutexLocker();
-        d->methodMapCacheNeedUpdate = zffalse;
-
-        d->methodMapCache.clear();
-        for(zfstlsize iCls = 0; iCls < d->methodAndPropertyFindCache.size(); ++iCls)
+        if(d->memberTableCacheNeedUpdate)
         {
-            const ZFCoreArrayPOD<const ZFMethod *> &methodList = d->methodAndPropertyFindCache[iCls]->d->methodList;
-            for(zfindex i = 0; i < methodList.count(); ++i)
+            d->methodTableCache.list.clear();
+            d->propertyTableCache.list.clear();
+            for(zfstlsize iCls = 0; iCls < d->methodAndPropertyFindCache.size(); ++iCls)
+            {
+                const _ZFP_ZFClassPrivate *clsData = d->methodAndPropertyFindCache[iCls]->d;
+                d->methodTableCache.list.insert(d->methodTableCache.list.end(),
+                    clsData->methodList.arrayBuf(), clsData->methodList.arrayBuf() + clsData->methodList.count());
+                d->propertyTableCache.list.insert(d->propertyTableCache.list.end(),
+                    clsData->propertyList.arrayBuf(), clsData->propertyList.arrayBuf() + clsData->propertyList.count());
+            }
+            // stable, so that child's method would be placed before parent's
+            _ZFP_ZFClassMethodTableBuild(d->methodTableCache);
+            const zfchar *duplicatedName = zfnull;
+            if(!_ZFP_ZFClassPropertyTableBuild(d->propertyTableCache, &duplicatedName))
             {
-                const ZFMethod *method = methodList[i];
-                d->methodMapCache[method->methodName()].push_back(method);
+                zfCoreCriticalMessageTrim("class %s already has property named %s",
+                    this->className(),
+                    duplicatedName);
             }
+            d->memberTableCacheNeedUpdate = zffalse;
         }
     }
 }
 
-void ZFClass::_ZFP_ZFClass_propertyRegister(ZF_IN const ZFProperty *zfproperty) const
+void ZFClass::_ZFP_ZFClass_methodRegister(ZF_IN const ZFMethod *method) const
 {
-    zfCoreAssertWithMessageTrim(d->propertyMapCache.find(zfproperty->propertyName()) == d->propertyMapCache.end(),
-        "class %s already has property named %s",
-        this->className(),
-        zfproperty->propertyName());
+    d->methodList.add(method);
+    this->_ZFP_ZFClass_memberChanged();
+}
+void ZFClass::_ZFP_ZFClass_methodUnregister(ZF_IN const ZFMethod *method) const
+{
+    d->methodList.removeElement(method);
+    this->_ZFP_ZFClass_memberChanged();
+}
 
-    d->propertyMap.set(zfproperty->propertyName(), ZFCorePointerForPointerRef<const ZFProperty *>(zfproperty));
+void ZFClass::_ZFP_ZFClass_propertyRegister(ZF_IN const ZFProperty *zfproperty) const
+{
     d->propertyList.add(zfproperty);
-    d->propertyMapCache[zfproperty->propertyName()] = zfproperty;
-
-    for(zfstlmap<const ZFClass *, zfbool>::iterator it = d->allChildren.begin(); it != d->allChildren.end(); ++it)
-    {
-        it->first->d->propertyMapCache[zfproperty->propertyName()] = zfproperty;
-    }
+    this->_ZFP_ZFClass_memberChanged();
 }
 void ZFClass::_ZFP_ZFClass_propertyUnregister(ZF_IN const ZFProperty *zfproperty) const
 {
-    d->propertyMapCache.erase(zfproperty->propertyName());
-    d->propertyMap.remove(zfproperty->propertyName());
     d->propertyList.removeElement(zfproperty);
-
-    for(zfstlmap<const ZFClass *, zfbool>::iterator it = d->allChildren.begin(); it != d->allChildren.end(); ++it)
-    {
-        it->first->d->propertyMapCache.erase(zfproperty->propertyName());
-    }
+    this->_ZFP_ZFClass_memberChanged();
 }
 
 void ZFClass::_ZFP_ZFClass_propertyAutoInitRegister(ZF_IN const ZFProperty *property) const
@@ -1761,10 +1899,18 @@ _ZFP_ZFObjectDestructor ZFClass::_ZFP_objectDestructor(void) const
 {
     return d->destructor;
 }
+zfindex ZFClass::_ZFP_objectSize(void) const
+{
+    return d->objectSize;
+}
 void ZFClass::_ZFP_classDynamicRegisterObjectInstanceDetach(ZF_IN ZFObject *obj) const
 {
     d->classDynamicRegisterObjectInstanceMap.erase(obj);
 }
+_ZFP_ZFObjectAllocTrackData &ZFClass::_ZFP_ZFClass_allocTrackData(void) const
+{
+    return d->allocTrack;
+}
 
 // ============================================================
 _ZFP_ZFClassRegisterHolder::_ZFP_ZFClassRegisterHolder(ZF_IN const zfchar *classNamespace,
@@ -1773,6 +1919,7 @@ _ZFP_ZFClassRegisterHolder::_ZFP_ZFClassRegisterHolder(ZF_IN const zfchar *class
                                                        ZF_IN _ZFP_zfAllocWithCacheCallback objectAllocWithCacheCallback,
                                                        ZF_IN _ZFP_ZFObjectConstructor constructor,
                                                        ZF_IN _ZFP_ZFObjectDestructor destructor,
+                                                       ZF_IN zfindex objectSize,
                                                        ZF_IN _ZFP_ZFObjectCheckInitImplementationListCallback checkInitImplListCallback,
                                                        ZF_IN_OPT zfbool isInterface /* = zffalse */,
                                                        ZF_IN_OPT zfbool classIsDynamicRegister /* = zffalse */,
@@ -1788,6 +1935,7 @@ _ZFP_ZFClassRegisterHolder::_ZFP_ZFClassRegisterHolder(ZF_IN const zfchar *class
         objectAllocWithCacheCallback,
         constructor,
         destructor,
+        objectSize,
         checkInitImplListCallback,
         isInterface,
         classIsDynamicRegister,
@@ -1802,20 +1950,30 @@ _ZFP_ZFClassRegisterHolder::~_ZFP_ZFClassRegisterHolder(void)
 void ZFClassGetAllT(ZF_IN_OUT ZFCoreArray<const ZFClass *> &ret,
                     ZF_IN_OPT const ZFFilterForZFClass *classFilter /* = zfnull */)
 {
-    zfCoreMutexLocker();
     if(classFilter == zfnull)
     {
-        _ZFP_ZFClassMap.allValueT(ret);
+        zfAtomicReadLocker(_ZFP_ZFClassMapLock);
+        for(zfindex i = _ZFP_ZFClassMap.indexFirst(); i != zfindexMax(); i = _ZFP_ZFClassMap.indexNext(i))
+        {
+            ret.add(_ZFP_ZFClassMap.valueAt(i));
+        }
     }
     else
     {
-        const ZFCoreMap &m = _ZFP_ZFClassMap;
-        for(zfiterator it = m.iterator(); m.iteratorIsValid(it); )
+        // filter may access the class map, check outside of the lock
+        ZFCoreArrayPOD<ZFClass *> all;
         {
-            ZFClass *v = m.iteratorNextValue<ZFClass *>(it);
-            if(classFilter->filterCheckActive(v))
+            zfAtomicReadLocker(_ZFP_ZFClassMapLock);
+            for(zfindex i = _ZFP_ZFClassMap.indexFirst(); i != zfindexMax(); i = _ZFP_ZFClassMap.indexNext(i))
             {
-                ret.add(v);
+                all.add(_ZFP_ZFClassMap.valueAt(i));
+            }
+        }
+        for(zfindex i = 0; i < all.count(); ++i)
+        {
+            if(classFilter->filterCheckActive(all[i]))
+            {
+                ret.add(all[i]);
             }
         }
     }
@@ -1831,15 +1989,39 @@ ZFObserverHolder &_ZFP_ZFClassDataChangeObserverRef(void)
     static ZFObserverHolder d;
     return d;
 }
+static zfatomicint _ZFP_ZFClassDataChangeVersionValue = 0;
+zfint _ZFP_ZFClassDataChangeVersion(void)
+{
+    return zfAtomicLoad(_ZFP_ZFClassDataChangeVersionValue);
+}
 void _ZFP_ZFClassDataChangeNotify(ZF_IN ZFClassDataChangeType changeType,
                                   ZF_IN const ZFClass *changedClass,
                                   ZF_IN const ZFProperty *changedProperty,
                                   ZF_IN const ZFMethod *changedMethod)
 {
+    zfAtomicIncrease(_ZFP_ZFClassDataChangeVersionValue);
     zfCoreMutexLocker();
+    if(changedClass == zfnull)
+    {
+        // member of class registered in batch, notified once by the batch
+        const ZFClass *ownerClass = (changedProperty != zfnull)
+            ? changedProperty->propertyOwnerClass()
+            : (changedMethod != zfnull ? changedMethod->methodOwnerClass() : zfnull);
+        if(ownerClass != zfnull && ownerClass->_ZFP_ZFClass_memberBatchRegister())
+        {
+            return ;
+        }
+    }
     if(ZFFrameworkStateCheck(ZFLevelZFFrameworkLow) == ZFFrameworkStateAvailable)
     {
-        if(changedProperty != zfnull)
+        if(changedClass != zfnull)
+        {
+            if(changeType == ZFClassDataChangeTypeUpdate)
+            {
+                changedClass->_ZFP_ZFClass_classDataChangeNotify();
+            }
+        }
+        else if(changedProperty != zfnull)
         {
             changedProperty->propertyOwnerClass()->_ZFP_ZFClass_classDataChangeNotify();
         }
@@ -64,6 +64,7 @@ public:
 
 // ============================================================
 zfclassFwd _ZFP_ZFClassPrivate;
+zfclassFwd _ZFP_ZFObjectAllocTrackData;
 /**
  * @brief ZFObject's class info
  * @see ZFObject
@@ -586,6 +587,7 @@ public:
                                          ZF_IN _ZFP_zfAllocWithCacheCallback objectAllocWithCacheCallback,
                                          ZF_IN _ZFP_ZFObjectConstructor constructor,
                                          ZF_IN _ZFP_ZFObjectDestructor destructor,
+                                         ZF_IN zfindex objectSize,
                                          ZF_IN _ZFP_ZFObjectCheckInitImplementationListCallback checkInitImplListCallback,
                                          ZF_IN zfbool isInterface,
                                          ZF_IN zfbool classIsDynamicRegister,
@@ -621,7 +623,10 @@ public:
     void _ZFP_ZFClass_methodAndPropertyAutoRegister(void) const;
     void _ZFP_ZFClass_methodRegister(ZF_IN const ZFMethod *method) const;
     void _ZFP_ZFClass_methodUnregister(ZF_IN const ZFMethod *method) const;
-    void _ZFP_ZFClass_methodMapCacheUpdate(void) const;
+    void _ZFP_ZFClass_memberChanged(void) const;
+    void _ZFP_ZFClass_memberTableUpdate(void) const;
+    void _ZFP_ZFClass_memberTableCacheUpdate(void) const;
+    zfbool _ZFP_ZFClass_memberBatchRegister(void) const;
     void _ZFP_ZFClass_propertyRegister(ZF_IN const ZFProperty *zfproperty) const;
     void _ZFP_ZFClass_propertyUnregister(ZF_IN const ZFProperty *zfproperty) const;
     void _ZFP_ZFClass_propertyAutoInitRegister(ZF_IN const ZFProperty *property) const;
@@ -632,7 +637,9 @@ public:
     _ZFP_zfAllocWithCacheCallback _ZFP_objectAllocWithCacheCallback(void) const;
     _ZFP_ZFObjectConstructor _ZFP_objectConstructor(void) const;
     _ZFP_ZFObjectDestructor _ZFP_objectDestructor(void) const;
+    zfindex _ZFP_objectSize(void) const;
     void _ZFP_classDynamicRegisterObjectInstanceDetach(ZF_IN ZFObject *obj) const;
+    _ZFP_ZFObjectAllocTrackData &_ZFP_ZFClass_allocTrackData(void) const;
 
 public:
     zfbool _ZFP_ZFClassNeedInitImplementationList;
@@ -655,6 +662,7 @@ public:
                                ZF_IN _ZFP_zfAllocWithCacheCallback objectAllocWithCacheCallback,
                                ZF_IN _ZFP_ZFObjectConstructor constructor,
                                ZF_IN _ZFP_ZFObjectDestructor destructor,
+                               ZF_IN zfindex objectSize,
                                ZF_IN _ZFP_ZFObjectCheckInitImplementationListCallback checkInitImplListCallback,
                                ZF_IN_OPT zfbool isInterface = zffalse,
                                ZF_IN_OPT zfbool classIsDynamicRegister = zffalse,
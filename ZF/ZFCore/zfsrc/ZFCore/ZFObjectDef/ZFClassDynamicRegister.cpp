@@ -70,6 +70,7 @@ const ZFClass *ZFClassDynamicRegister(ZF_IN const zfchar *classNameFull,
         parent->_ZFP_objectAllocWithCacheCallback(),
         parent->_ZFP_objectConstructor(),
         parent->_ZFP_objectDestructor(),
+        parent->_ZFP_objectSize(),
         zfnull,
         zffalse,
         zftrue,
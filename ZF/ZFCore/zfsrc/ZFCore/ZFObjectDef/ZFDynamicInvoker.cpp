@@ -128,45 +128,220 @@ static void _ZFP_ZFDI_paramCount(ZF_IN_OUT zfindex &paramCount,
         ++paramCount;
     }
 }
-zfbool ZFDI_invoke(ZF_OUT zfautoObject &ret
-                   , ZF_OUT_OPT zfstring *errorHint
-                   , ZF_IN_OPT ZFObject *obj
-                   , ZF_IN_OPT const zfchar *NS
-                   , ZF_IN ZFObject *type
-                   , ZF_IN zfindex paramCount
-                   , ZF_IN_OUT zfautoObject (&paramList)[ZFMETHOD_MAX_PARAM]
-                   )
+// invoke by ZFMethod::methodGenericInvokerUnboxed, return value would be boxed to ret,
+// return false without invoking if not available, param count must be checked by caller
+static zfbool _ZFP_ZFDI_methodInvokeUnboxed(ZF_OUT zfautoObject &ret,
+                                            ZF_IN ZFObject *obj,
+                                            ZF_IN const ZFMethod *method,
+                                            ZF_IN zfindex paramCount,
+                                            ZF_IN const ZFMethodGenericValue *paramList)
 {
-    if(type == zfnull)
+    ZFMethodGenericInvokerUnboxed invoker = method->methodGenericInvokerUnboxed();
+    if(invoker == zfnull)
+    {
+        return zffalse;
+    }
+    ZFMethodGenericValue retUnboxed;
+    {
+        _ZFP_ZFMethodProfileScope profileScope(method);
+        if(!invoker(method, obj, zfnull, retUnboxed, &ret, paramCount, paramList))
+        {
+            return zffalse;
+        }
+    }
+    if(zfscmpTheSame(method->methodReturnTypeId(), ZFTypeId_void()))
+    {
+        ret = obj;
+    }
+    return zftrue;
+}
+// take ZFDI_WrapperBase as string and others as object, without allocating any param holder
+static zfbool _ZFP_ZFDI_paramUnbox(ZF_OUT ZFMethodGenericValue *ret,
+                                   ZF_IN zfindex paramCount,
+                                   ZF_IN zfautoObject (&paramList)[ZFMETHOD_MAX_PARAM])
+{
+    for(zfindex iParam = 0; iParam < paramCount; ++iParam)
+    {
+        ZFObject *param = paramList[iParam];
+        if(param == ZFMethodGenericInvokerDefaultParam())
+        {
+            return zffalse;
+        }
+        ZFDI_WrapperBase *wrapper = ZFCastZFObject(ZFDI_WrapperBase *, param);
+        if(wrapper != zfnull)
+        {
+            ret[iParam].type = ZFMethodGenericValueTypeString;
+            ret[iParam].v.vString = wrapper->zfv();
+        }
+        else
+        {
+            ret[iParam].type = ZFMethodGenericValueTypeObject;
+            ret[iParam].v.vObject = param;
+        }
+    }
+    return zftrue;
+}
+// check param count and convert ZFDI_WrapperBase params in place, then invoke,
+// converted params would be restored if failed,
+// errorHint would be written only if failed
+static zfbool _ZFP_ZFDI_methodInvoke(ZF_OUT zfautoObject &ret,
+                                     ZF_OUT_OPT zfstring *errorHint,
+                                     ZF_IN ZFObject *obj,
+                                     ZF_IN const ZFMethod *method,
+                                     ZF_IN zfindex paramCount,
+                                     ZF_IN_OUT zfautoObject (&paramList)[ZFMETHOD_MAX_PARAM])
+{
+    if(paramCount < method->methodParamCountMin() || paramCount > method->methodParamCount())
     {
         if(errorHint != zfnull)
         {
-            zfstringAppend(errorHint, "null methodName or ClassName");
+            zfstringAppend(errorHint, "expect %s param, got %zi",
+                ((method->methodParamCountMin() == method->methodParamCount())
+                    ? zfindexToString(method->methodParamCount()).cString()
+                    : zfstringWithFormat("%zi~%zi", method->methodParamCountMin(), method->methodParamCount()).cString()),
+                paramCount);
         }
         return zffalse;
     }
+    if(method->methodGenericInvokerUnboxed() != zfnull)
+    {
+        // primitive params can be converted from ZFDI_WrapperBase directly,
+        // fallback to boxed conversion if not able to
+        ZFMethodGenericValue paramUnboxed[ZFMETHOD_MAX_PARAM];
+        if(_ZFP_ZFDI_paramUnbox(paramUnboxed, paramCount, paramList)
+            && _ZFP_ZFDI_methodInvokeUnboxed(ret, obj, method, paramCount, paramUnboxed))
+        {
+            return zftrue;
+        }
+    }
+    zfautoObject paramConvertCache[ZFMETHOD_MAX_PARAM];
+    zfbool success = zftrue;
+    for(zfindex iParam = 0; iParam < paramCount; ++iParam)
+    {
+        ZFDI_WrapperBase *wrapper = ZFCastZFObject(ZFDI_WrapperBase *, paramList[iParam]);
+        if(wrapper != zfnull)
+        {
+            paramConvertCache[iParam].zflockfree_assign(paramList[iParam]);
+            if(!ZFDI_paramConvert(
+                paramList[iParam], method->methodParamTypeIdAtIndex(iParam), wrapper, errorHint))
+            {
+                success = zffalse;
+                break;
+            }
+        }
+    }
+    if(success)
+    {
+        _ZFP_ZFMethodProfileScope profileScope(method);
+        success = method->methodGenericInvoker()(method, obj, errorHint, ret, paramList);
+    }
+    if(success)
+    {
+        if(zfscmpTheSame(method->methodReturnTypeId(), ZFTypeId_void()))
+        {
+            ret = obj;
+        }
+        return zftrue;
+    }
+    for(zfindex iParam = 0; iParam < paramCount; ++iParam)
+    {
+        if(paramConvertCache[iParam] != zfnull)
+        {
+            paramList[iParam].zflockfree_assign(paramConvertCache[iParam]);
+        }
+    }
+    return zffalse;
+}
+static void _ZFP_ZFDI_invokeErrorHint(ZF_IN_OUT zfstring &errorHint,
+                                      ZF_IN const zfstring &errorHintTmp,
+                                      ZF_IN const ZFMethod * const *methodList,
+                                      ZF_IN zfindex methodCount,
+                                      ZF_IN zfindex paramCount,
+                                      ZF_IN_OUT zfautoObject (&paramList)[ZFMETHOD_MAX_PARAM])
+{
+    errorHint += "no matching method to call";
+    errorHint += ", error hint:\n    ";
+    errorHint += errorHintTmp;
+    errorHint += "\n  candidate methods:";
+    for(zfindex i = 0; i < methodCount; ++i)
+    {
+        errorHint += "\n    ";
+        methodList[i]->objectInfoT(errorHint);
+    }
 
-    if(obj == zfnull)
+    if(paramCount > 0)
+    {
+        errorHint += "\n  with params: ";
+        ZFDI_paramInfo(errorHint
+                , paramList[0]
+                , paramList[1]
+                , paramList[2]
+                , paramList[3]
+                , paramList[4]
+                , paramList[5]
+                , paramList[6]
+                , paramList[7]
+            );
+    }
+}
+/*
+ * methodName would be used if not null, otherwise resolved from type
+ *
+ * methodResolved and methodUnique would be set when invoked by method,
+ * methodUnique means it's the only candidate method that accepts paramCount,
+ * so the resolved method would not be affected by param values
+ */
+static zfbool _ZFP_ZFDI_invoke(ZF_OUT zfautoObject &ret
+                               , ZF_OUT_OPT zfstring *errorHint
+                               , ZF_IN_OPT ZFObject *obj
+                               , ZF_IN_OPT const zfchar *NS
+                               , ZF_IN_OPT ZFObject *type
+                               , ZF_IN_OPT const zfchar *methodName
+                               , ZF_IN zfindex paramCount
+                               , ZF_IN_OUT zfautoObject (&paramList)[ZFMETHOD_MAX_PARAM]
+                               , ZF_OUT_OPT const ZFMethod **methodResolved
+                               , ZF_OUT_OPT zfbool *methodUnique
+                               , ZF_IN_OPT const ZFMethodGenericValue *paramUnboxed
+                               )
+{
+    if(methodName == zfnull)
     {
-        v_ZFClass *clsWrapper = ZFCastZFObject(v_ZFClass *, type);
-        if(clsWrapper != zfnull)
+        if(type == zfnull)
         {
-            if(clsWrapper->zfv == zfnull)
+            if(errorHint != zfnull)
             {
-                if(errorHint != zfnull)
-                {
-                    zfstringAppend(errorHint, "null class");
-                }
-                return zffalse;
+                zfstringAppend(errorHint, "null methodName or ClassName");
             }
-            else
+            return zffalse;
+        }
+
+        if(obj == zfnull)
+        {
+            v_ZFClass *clsWrapper = ZFCastZFObject(v_ZFClass *, type);
+            if(clsWrapper != zfnull)
             {
-                return ZFDI_alloc(ret, errorHint, clsWrapper->zfv, paramCount, paramList);
+                if(clsWrapper->zfv == zfnull)
+                {
+                    if(errorHint != zfnull)
+                    {
+                        zfstringAppend(errorHint, "null class");
+                    }
+                    return zffalse;
+                }
+                else if(paramUnboxed != zfnull)
+                {
+                    return zffalse;
+                }
+                else
+                {
+                    return ZFDI_alloc(ret, errorHint, clsWrapper->zfv, paramCount, paramList);
+                }
             }
         }
+
+        methodName = ZFDI_toString(type);
     }
 
-    const zfchar *methodName = ZFDI_toString(type);
     zfstring NSHolder;
     if(methodName != zfnull && ZFNamespaceSkipGlobal(NS) == zfnull)
     {
@@ -183,7 +358,7 @@ zfbool ZFDI_invoke(ZF_OUT zfautoObject &ret
         const ZFClass *cls = ZFDI_classForName(methodName, NS);
         if(cls != zfnull)
         {
-            return ZFDI_alloc(ret, errorHint, cls, paramCount, paramList);
+            return (paramUnboxed == zfnull && ZFDI_alloc(ret, errorHint, cls, paramCount, paramList));
         }
     }
 
@@ -242,145 +417,260 @@ zfbool ZFDI_invoke(ZF_OUT zfautoObject &ret
         }
     }
 
-    if(paramCount == zfindexMax())
-    {
-        _ZFP_ZFDI_paramCount(paramCount, paramList);
-    }
-
-    // try to invoke each method
-    zfstring _errorHintTmp;
-    zfstring *errorHintTmp = errorHint ? &_errorHintTmp : zfnull;
-    if(methodList.count() == 1)
+    if(paramUnboxed != zfnull)
     {
-        do {
-            const ZFMethod *method = methodList[0];
-            if(paramCount < method->methodParamCountMin() || paramCount > method->methodParamCount())
-            {
-                if(errorHintTmp != zfnull)
-                {
-                    zfstringAppend(_errorHintTmp, "expect %s param, got %zi",
-                        ((method->methodParamCountMin() == method->methodParamCount())
-                            ? zfindexToString(method->methodParamCount()).cString()
-                            : zfstringWithFormat("%zi~%zi", method->methodParamCountMin(), method->methodParamCount()).cString()),
-                        paramCount);
-                }
-                break;
-            }
-            zfbool paramConvertSuccess = zftrue;
-            zfautoObject paramConvertCache;
-            for(zfindex iParam = 0; iParam < paramCount; ++iParam)
-            {
-                ZFDI_WrapperBase *wrapper = ZFCastZFObject(ZFDI_WrapperBase *, paramList[iParam]);
-                if(wrapper != zfnull)
-                {
-                    paramConvertCache.zflockfree_assign(paramList[iParam]);
-                    if(!ZFDI_paramConvert(
-                        paramList[iParam], method->methodParamTypeIdAtIndex(iParam), wrapper, errorHintTmp))
-                    {
-                        paramList[iParam].zflockfree_assign(paramConvertCache);
-                        paramConvertSuccess = zffalse;
-                        break;
-                    }
-                }
-            }
-            if(!paramConvertSuccess)
-            {
-                break;
-            }
-            if(method->methodGenericInvoker()(method, obj, errorHintTmp, ret, paramList))
+        if(paramCount == zfindexMax())
+        {
+            paramCount = 0;
+            while(paramCount < ZFMETHOD_MAX_PARAM && paramUnboxed[paramCount].type != ZFMethodGenericValueTypeDefault)
             {
-                if(zfscmpTheSame(method->methodReturnTypeId(), ZFTypeId_void()))
-                {
-                    ret = obj;
-                }
-                return zftrue;
+                ++paramCount;
             }
-        } while(zffalse);
-    }
-    else
-    {
-        zfautoObject paramListTmp[ZFMETHOD_MAX_PARAM];
+        }
+        // keep the same method order as boxed invoke,
+        // stop at first method that can not be invoked unboxed
         for(zfindex iMethod = 0; iMethod < methodList.count(); ++iMethod)
         {
             const ZFMethod *method = methodList[iMethod];
-            if(paramCount < method->methodParamCountMin() || paramCount > method->methodParamCount())
+            if(paramCount >= method->methodParamCountMin() && paramCount <= method->methodParamCount())
             {
-                if(errorHintTmp != zfnull)
-                {
-                    zfstringAppend(_errorHintTmp, "expect %s param, got %zi",
-                        ((method->methodParamCountMin() == method->methodParamCount())
-                            ? zfindexToString(method->methodParamCount()).cString()
-                            : zfstringWithFormat("%zi~%zi", method->methodParamCountMin(), method->methodParamCount()).cString()),
-                        paramCount);
-                }
-                continue;
-            }
-            if(!_errorHintTmp.isEmpty())
-            {
-                _errorHintTmp += "\n    ";
+                return _ZFP_ZFDI_methodInvokeUnboxed(ret, obj, method, paramCount, paramUnboxed);
             }
+        }
+        return zffalse;
+    }
+    if(paramCount == zfindexMax())
+    {
+        _ZFP_ZFDI_paramCount(paramCount, paramList);
+    }
 
-            for(zfindex i = 0; i < ZFMETHOD_MAX_PARAM; ++i)
+    // try to invoke each method,
+    // error hint of each method would be generated only when it fails
+    zfstring _errorHintTmp;
+    zfstring *errorHintTmp = errorHint ? &_errorHintTmp : zfnull;
+    for(zfindex iMethod = 0; iMethod < methodList.count(); ++iMethod)
+    {
+        if(!_errorHintTmp.isEmpty())
+        {
+            _errorHintTmp += "\n    ";
+        }
+        const ZFMethod *method = methodList[iMethod];
+        if(_ZFP_ZFDI_methodInvoke(ret, errorHintTmp, obj, method, paramCount, paramList))
+        {
+            if(methodResolved != zfnull)
             {
-                paramListTmp[i].zflockfree_assign(paramList[i]);
+                *methodResolved = method;
             }
-
-            zfbool paramConvertSuccess = zftrue;
-            for(zfindex iParam = 0; iParam < paramCount; ++iParam)
+            if(methodUnique != zfnull)
             {
-                ZFDI_WrapperBase *wrapper = ZFCastZFObject(ZFDI_WrapperBase *, paramListTmp[iParam]);
-                if(wrapper != zfnull)
+                *methodUnique = zftrue;
+                for(zfindex i = 0; i < methodList.count(); ++i)
                 {
-                    if(!ZFDI_paramConvert(
-                        paramListTmp[iParam], method->methodParamTypeIdAtIndex(iParam), wrapper, errorHintTmp))
+                    if(i != iMethod
+                        && paramCount >= methodList[i]->methodParamCountMin()
+                        && paramCount <= methodList[i]->methodParamCount())
                     {
-                        paramConvertSuccess = zffalse;
+                        *methodUnique = zffalse;
                         break;
                     }
                 }
             }
-            if(!paramConvertSuccess)
-            {
-                continue;
-            }
-            if(method->methodGenericInvoker()(method, obj, errorHintTmp, ret, paramListTmp))
-            {
-                if(zfscmpTheSame(method->methodReturnTypeId(), ZFTypeId_void()))
-                {
-                    ret = obj;
-                }
-                return zftrue;
-            }
+            return zftrue;
         }
     }
     if(errorHint != zfnull)
     {
-        *errorHint += "no matching method to call";
-        *errorHint += ", error hint:\n    ";
-        *errorHint += _errorHintTmp;
-        *errorHint += "\n  candidate methods:";
-        for(zfindex i = 0; i < methodList.count(); ++i)
+        _ZFP_ZFDI_invokeErrorHint(*errorHint, _errorHintTmp, methodList.arrayBuf(), methodList.count(), paramCount, paramList);
+    }
+    return zffalse;
+}
+zfbool ZFDI_invoke(ZF_OUT zfautoObject &ret
+                   , ZF_OUT_OPT zfstring *errorHint
+                   , ZF_IN_OPT ZFObject *obj
+                   , ZF_IN_OPT const zfchar *NS
+                   , ZF_IN ZFObject *type
+                   , ZF_IN zfindex paramCount
+                   , ZF_IN_OUT zfautoObject (&paramList)[ZFMETHOD_MAX_PARAM]
+                   )
+{
+    return _ZFP_ZFDI_invoke(ret, errorHint, obj, NS, type, zfnull, paramCount, paramList, zfnull, zfnull, zfnull);
+}
+zfbool ZFDI_invokeUnboxed(ZF_OUT zfautoObject &ret
+                          , ZF_IN_OPT ZFObject *obj
+                          , ZF_IN_OPT const zfchar *NS
+                          , ZF_IN ZFObject *type
+                          , ZF_IN_OPT zfindex paramCount
+                          , ZF_IN const ZFMethodGenericValue *paramList
+                          )
+{
+    zfautoObject paramListDummy[ZFMETHOD_MAX_PARAM];
+    return _ZFP_ZFDI_invoke(ret, zfnull, obj, NS, type, zfnull, paramCount, paramListDummy, zfnull, zfnull, paramList);
+}
+
+// ============================================================
+// call site cache
+static zfbool _ZFP_ZFDI_cacheMatch(ZF_IN const _ZFP_ZFDI_CacheEntry &entry,
+                                   ZF_IN zfint version,
+                                   ZF_IN const ZFClass *cls,
+                                   ZF_IN zfindex paramCount,
+                                   ZF_IN zfautoObject (&paramList)[ZFMETHOD_MAX_PARAM])
+{
+    if(entry.method == zfnull
+        || entry.version != version
+        || entry.cls != cls
+        || entry.paramCount != paramCount)
+    {
+        return zffalse;
+    }
+    for(zfindex i = 0; i < paramCount; ++i)
+    {
+        if(entry.paramClass[i] != (paramList[i] == zfnull ? zfnull : paramList[i].toObject()->classData()))
         {
-            *errorHint += "\n    ";
-            methodList[i]->objectInfoT(*errorHint);
+            return zffalse;
         }
+    }
+    return zftrue;
+}
+static void _ZFP_ZFDI_cacheUpdate(ZF_OUT _ZFP_ZFDI_CacheEntry &entry,
+                                  ZF_IN zfint version,
+                                  ZF_IN const ZFClass *cls,
+                                  ZF_IN const ZFMethod *method,
+                                  ZF_IN zfindex paramCount,
+                                  ZF_IN zfautoObject (&paramList)[ZFMETHOD_MAX_PARAM])
+{
+    entry.version = version;
+    entry.cls = cls;
+    entry.method = method;
+    entry.paramCount = paramCount;
+    for(zfindex i = 0; i < paramCount; ++i)
+    {
+        entry.paramClass[i] = (paramList[i] == zfnull ? zfnull : paramList[i].toObject()->classData());
+    }
+}
+// invoke by cache entry, the cached method is the only candidate,
+// so there's no need to fallback to other methods even if failed
+static zfbool _ZFP_ZFDI_cacheInvoke(ZF_OUT zfautoObject &ret,
+                                    ZF_OUT_OPT zfstring *errorHint,
+                                    ZF_IN ZFObject *obj,
+                                    ZF_IN const _ZFP_ZFDI_CacheEntry &entry,
+                                    ZF_IN zfindex paramCount,
+                                    ZF_IN_OUT zfautoObject (&paramList)[ZFMETHOD_MAX_PARAM])
+{
+    const ZFMethod *method = entry.method;
+    zfstring _errorHintTmp;
+    zfbool success = _ZFP_ZFDI_methodInvoke(ret, errorHint ? &_errorHintTmp : zfnull, obj, method, paramCount, paramList);
+    if(!success && errorHint != zfnull)
+    {
+        _ZFP_ZFDI_invokeErrorHint(*errorHint, _errorHintTmp, &method, 1, paramCount, paramList);
+    }
+    return success;
+}
 
-        if(paramCount > 0)
+ZFDI_Cache::ZFDI_Cache(ZF_IN const zfchar *methodName,
+                       ZF_IN_OPT const zfchar *NS /* = zfnull */)
+: _methodName(methodName)
+, _NS(NS)
+, _cacheNext(0)
+{
+    this->cacheReset();
+}
+zfbool ZFDI_Cache::invoke(ZF_OUT zfautoObject &ret
+                          , ZF_OUT_OPT zfstring *errorHint
+                          , ZF_IN_OPT ZFObject *obj
+                          , ZF_IN_OPT zfindex paramCount
+                          , ZF_IN_OUT zfautoObject (&paramList)[ZFMETHOD_MAX_PARAM]
+                          )
+{
+    if(paramCount == zfindexMax())
+    {
+        _ZFP_ZFDI_paramCount(paramCount, paramList);
+    }
+    zfint version = _ZFP_ZFClassDataChangeVersion();
+    const ZFClass *cls = (obj != zfnull ? obj->classData() : zfnull);
+    for(zfindex i = 0; i < _ZFP_ZFDI_CacheSize; ++i)
+    {
+        if(_ZFP_ZFDI_cacheMatch(_cache[i], version, cls, paramCount, paramList))
         {
-            *errorHint += "\n  with params: ";
-            ZFDI_paramInfo(*errorHint
-                    , paramList[0]
-                    , paramList[1]
-                    , paramList[2]
-                    , paramList[3]
-                    , paramList[4]
-                    , paramList[5]
-                    , paramList[6]
-                    , paramList[7]
-                );
+            return _ZFP_ZFDI_cacheInvoke(ret, errorHint, obj, _cache[i], paramCount, paramList);
         }
     }
-    return zffalse;
+
+    const ZFMethod *methodResolved = zfnull;
+    zfbool methodUnique = zffalse;
+    if(!_ZFP_ZFDI_invoke(ret, errorHint, obj, _NS, zfnull, _methodName, paramCount, paramList, &methodResolved, &methodUnique, zfnull))
+    {
+        return zffalse;
+    }
+    if(methodResolved != zfnull && methodUnique)
+    {
+        _ZFP_ZFDI_cacheUpdate(_cache[_cacheNext], version, cls, methodResolved, paramCount, paramList);
+        _cacheNext = (_cacheNext + 1) % _ZFP_ZFDI_CacheSize;
+    }
+    return zftrue;
+}
+void ZFDI_Cache::cacheReset(void)
+{
+    zfmemset(_cache, 0, sizeof(_cache));
+    _cacheNext = 0;
+}
+
+// direct mapped thread local cache for ZFObject::invoke,
+// indexed by class and method name
+#if defined(__GNUC__) || defined(__clang__)
+    #define _ZFP_ZFDI_threadLocal __thread
+#elif defined(_MSC_VER)
+    #define _ZFP_ZFDI_threadLocal __declspec(thread)
+#endif
+#define _ZFP_ZFDI_invokeCacheSize 64
+#ifdef _ZFP_ZFDI_threadLocal
+static _ZFP_ZFDI_threadLocal _ZFP_ZFDI_CacheEntry _ZFP_ZFDI_invokeCache[_ZFP_ZFDI_invokeCacheSize];
+#endif
+zfbool _ZFP_ZFDI_invokeByName(ZF_OUT zfautoObject &ret
+                              , ZF_OUT_OPT zfstring *errorHint
+                              , ZF_IN ZFObject *obj
+                              , ZF_IN const zfchar *methodName
+                              , ZF_IN zfindex paramCount
+                              , ZF_IN_OUT zfautoObject (&paramList)[ZFMETHOD_MAX_PARAM]
+                              )
+{
+#ifdef _ZFP_ZFDI_threadLocal
+    if(methodName == zfnull)
+    {
+        return _ZFP_ZFDI_invoke(ret, errorHint, obj, zfnull, zfnull, zfnull, paramCount, paramList, zfnull, zfnull, zfnull);
+    }
+    if(paramCount == zfindexMax())
+    {
+        _ZFP_ZFDI_paramCount(paramCount, paramList);
+    }
+    zfint version = _ZFP_ZFClassDataChangeVersion();
+    const ZFClass *cls = obj->classData();
+    zfuint hash = 2166136261U;
+    for(const zfchar *p = methodName; *p; ++p)
+    {
+        hash = (hash ^ (zfbyte)*p) * 16777619U;
+    }
+    hash ^= (zfuint)(((zfindex)cls) >> 4);
+    _ZFP_ZFDI_CacheEntry &entry = _ZFP_ZFDI_invokeCache[hash % _ZFP_ZFDI_invokeCacheSize];
+    if(_ZFP_ZFDI_cacheMatch(entry, version, cls, paramCount, paramList)
+        && zfscmpTheSame(entry.method->methodName(), methodName))
+    {
+        return _ZFP_ZFDI_cacheInvoke(ret, errorHint, obj, entry, paramCount, paramList);
+    }
+
+    const ZFMethod *methodResolved = zfnull;
+    zfbool methodUnique = zffalse;
+    if(!_ZFP_ZFDI_invoke(ret, errorHint, obj, zfnull, zfnull, methodName, paramCount, paramList, &methodResolved, &methodUnique, zfnull))
+    {
+        return zffalse;
+    }
+    if(methodResolved != zfnull && methodUnique)
+    {
+        _ZFP_ZFDI_cacheUpdate(entry, version, cls, methodResolved, paramCount, paramList);
+    }
+    return zftrue;
+#else
+    return _ZFP_ZFDI_invoke(ret, errorHint, obj, zfnull, zfnull, methodName, paramCount, paramList, zfnull, zfnull, zfnull);
+#endif
 }
 
 zfbool ZFDI_alloc(ZF_OUT zfautoObject &ret
@@ -177,6 +177,25 @@ extern ZF_ENV_EXPORT zfbool ZFDI_invoke(ZF_OUT zfautoObject &ret
                                         , ZF_IN_OPT zfindex paramCount
                                         , ZF_IN_OUT zfautoObject (&paramList)[ZFMETHOD_MAX_PARAM]
                                         );
+/**
+ * @brief #ZFDI_invoke with unboxed params, see #ZFMethodGenericInvokerUnboxed
+ *
+ * methods are resolved the same as #ZFDI_invoke,
+ * the first method that matches the param count would be invoked
+ * by #ZFMethod::methodGenericInvokerUnboxed,
+ * and the return value would be boxed to ret\n
+ * return false without invoking anything if the method can not be invoked unboxed,
+ * or type refers to a class,
+ * in this case, caller should fallback to #ZFDI_invoke
+ * so that all methods can be tried in the same order
+ */
+extern ZF_ENV_EXPORT zfbool ZFDI_invokeUnboxed(ZF_OUT zfautoObject &ret
+                                               , ZF_IN_OPT ZFObject *obj
+                                               , ZF_IN_OPT const zfchar *NS
+                                               , ZF_IN ZFObject *type
+                                               , ZF_IN_OPT zfindex paramCount
+                                               , ZF_IN const ZFMethodGenericValue *paramList
+                                               );
 
 /**
  * @brief perform advanced dynamic invoke
@@ -210,6 +229,89 @@ extern ZF_ENV_EXPORT zfbool ZFDI_alloc(ZF_OUT zfautoObject &ret
                                        , ZF_IN_OUT zfautoObject (&paramList)[ZFMETHOD_MAX_PARAM]
                                        );
 
+// ============================================================
+zfclassPOD ZF_ENV_EXPORT _ZFP_ZFDI_CacheEntry
+{
+public:
+    zfint version;
+    const ZFClass *cls;
+    const ZFMethod *method;
+    zfindex paramCount;
+    const ZFClass *paramClass[ZFMETHOD_MAX_PARAM];
+};
+#define _ZFP_ZFDI_CacheSize 4
+/**
+ * @brief call site cache for #ZFDI_invoke
+ *
+ * #ZFDI_invoke would resolve the method by name each time it's called,
+ * which is expensive for frequently called code such as script bindings
+ *
+ * a ZFDI_Cache hold a fixed method name and remember the resolved methods
+ * for the last few object classes and param types,
+ * so that later invoke with the same class and param types
+ * can call the method directly
+ *
+ * cached methods would be discarded automatically when any class data changed
+ * (see #ZFGlobalEvent::EventClassDataChange)
+ *
+ * the cache itself is not thread-safe,
+ * each thread should have its own cache
+ */
+zffinal zfclassNotPOD ZF_ENV_EXPORT ZFDI_Cache
+{
+public:
+    /**
+     * @brief construct with method name and namespace,
+     *   see #ZFDI_invoke for the format
+     */
+    explicit ZFDI_Cache(ZF_IN const zfchar *methodName,
+                        ZF_IN_OPT const zfchar *NS = zfnull);
+
+public:
+    /**
+     * @brief invoke the method, see #ZFDI_invoke
+     */
+    zfbool invoke(ZF_OUT zfautoObject &ret
+                  , ZF_OUT_OPT zfstring *errorHint
+                  , ZF_IN_OPT ZFObject *obj
+                  , ZF_IN_OPT zfindex paramCount
+                  , ZF_IN_OUT zfautoObject (&paramList)[ZFMETHOD_MAX_PARAM]
+                  );
+    /**
+     * @brief remove all cached methods
+     */
+    void cacheReset(void);
+
+    /** @brief method name */
+    inline const zfchar *methodName(void) const
+    {
+        return _methodName;
+    }
+    /** @brief namespace */
+    inline const zfchar *methodNamespace(void) const
+    {
+        return _NS;
+    }
+
+private:
+    zfstring _methodName;
+    zfstring _NS;
+    _ZFP_ZFDI_CacheEntry _cache[_ZFP_ZFDI_CacheSize];
+    zfindex _cacheNext;
+private:
+    ZFDI_Cache(ZF_IN const ZFDI_Cache &ref);
+    ZFDI_Cache &operator = (ZF_IN const ZFDI_Cache &ref);
+};
+
+// invoke by method name, with thread local cache, used by ZFObject::invoke
+extern ZF_ENV_EXPORT zfbool _ZFP_ZFDI_invokeByName(ZF_OUT zfautoObject &ret
+                                                   , ZF_OUT_OPT zfstring *errorHint
+                                                   , ZF_IN ZFObject *obj
+                                                   , ZF_IN const zfchar *methodName
+                                                   , ZF_IN zfindex paramCount
+                                                   , ZF_IN_OUT zfautoObject (&paramList)[ZFMETHOD_MAX_PARAM]
+                                                   );
+
 // ============================================================
 /**
  * @brief util method to convert param type from
@@ -2,14 +2,14 @@
 #include "ZFObjectImpl.h"
 
 #include "ZFCore/ZFSTLWrapper/zfstl_map.h"
-#include "ZFCore/ZFSTLWrapper/zfstl_string.h"
+#include "ZFCore/ZFSTLWrapper/zfstl_hashmap.h"
 
 ZF_NAMESPACE_GLOBAL_BEGIN
 
 // ============================================================
 _ZFP_ZFIdMapHolder::_ZFP_ZFIdMapHolder(ZF_IN const zfchar *idName)
 : ZFCoreLibDestroyFlag(zffalse)
-, idName(idName)
+, idName(zfstringAtomFor(idName).cString())
 , idValue(_ZFP_ZFIdMapRegister(&ZFCoreLibDestroyFlag, idName))
 {
 }
@@ -24,7 +24,7 @@ zfclassLikePOD _ZFP_ZFIdMapData
 public:
     zfuint refCount;
     zfidentity idValue;
-    zfstring idName;
+    zfstringAtom idName;
     zfbool isDynamicRegister;
     ZFCoreArrayPOD<zfbool *> ZFCoreLibDestroyFlag;
 
@@ -46,7 +46,7 @@ public:
     }
 };
 typedef zfstlmap<zfidentity, _ZFP_ZFIdMapData *> _ZFP_ZFIdMapDataIdMapType;
-typedef zfstlmap<const zfchar *, _ZFP_ZFIdMapData *, zfcharConst_zfstlComparer> _ZFP_ZFIdMapDataNameMapType;
+typedef zfstlhashmap<zfstringAtom, _ZFP_ZFIdMapData *, zfstringAtom_zfstlHasher, zfpointer_zfstlHashComparer<zfstringAtom> > _ZFP_ZFIdMapDataNameMapType;
 
 zfclassLikePOD _ZFP_ZFIdMapModuleData
 {
@@ -76,8 +76,9 @@ const zfidentity *_ZFP_ZFIdMapRegister(ZF_IN zfbool *ZFCoreLibDestroyFlag,
     _ZFP_ZFIdMapDataIdMapType &dataIdMap = moduleData.dataIdMap;
     _ZFP_ZFIdMapDataNameMapType &dataNameMap = moduleData.dataNameMap;
 
+    zfstringAtom idNameAtom = zfstringAtomFor(idName);
     _ZFP_ZFIdMapData *data = zfnull;
-    _ZFP_ZFIdMapDataNameMapType::iterator itName = dataNameMap.find(idName);
+    _ZFP_ZFIdMapDataNameMapType::iterator itName = dataNameMap.find(idNameAtom);
     if(itName != dataNameMap.end())
     {
         data = itName->second;
@@ -94,11 +95,11 @@ const zfidentity *_ZFP_ZFIdMapRegister(ZF_IN zfbool *ZFCoreLibDestroyFlag,
     {
         data = zfnew(_ZFP_ZFIdMapData);
         data->idValue = moduleData.idValueGenerator.idAcquire();
-        data->idName = idName;
+        data->idName = idNameAtom;
         data->isDynamicRegister = isDynamicRegister;
 
         dataIdMap[data->idValue] = data;
-        dataNameMap[data->idName.cString()] = data;
+        dataNameMap[data->idName] = data;
     }
     if(ZFCoreLibDestroyFlag != zfnull)
     {
@@ -142,7 +143,7 @@ void _ZFP_ZFIdMapUnregister(ZF_IN zfbool *ZFCoreLibDestroyFlag,
     if(data->refCount == 0)
     {
         dataIdMap.erase(data->idValue);
-        dataNameMap.erase(data->idName.cString());
+        dataNameMap.erase(data->idName);
         zfdelete(data);
     }
 }
@@ -165,7 +166,12 @@ zfidentity ZFIdMapIdForName(ZF_IN const zfchar *idName)
     _ZFP_ZFIdMapModuleData &moduleData = _ZFP_ZFIdMapModuleDataRef();
     _ZFP_ZFIdMapDataNameMapType &dataNameMap = moduleData.dataNameMap;
 
-    _ZFP_ZFIdMapDataNameMapType::const_iterator it = dataNameMap.find(idName);
+    zfstringAtom idNameAtom = zfstringAtomFind(idName);
+    if(idNameAtom.isNull())
+    {
+        return zfidentityInvalid();
+    }
+    _ZFP_ZFIdMapDataNameMapType::const_iterator it = dataNameMap.find(idNameAtom);
     if(it != dataNameMap.end())
     {
         return it->second->idValue;
@@ -182,7 +188,7 @@ void ZFIdMapGetAll(ZF_IN_OUT ZFCoreArrayPOD<zfidentity> &idValues, ZF_IN_OUT ZFC
     for(_ZFP_ZFIdMapDataIdMapType::iterator it = moduleData.dataIdMap.begin(); it != moduleData.dataIdMap.end(); ++it)
     {
         idValues.add(it->second->idValue);
-        idNames.add(it->second->idName);
+        idNames.add(it->second->idName.cString());
     }
 }
 
@@ -62,7 +62,7 @@ public:
 
 public:
     zfbool ZFCoreLibDestroyFlag;
-    zfstring idName;
+    const zfchar *idName;
     const zfidentity *idValue;
 };
 /**
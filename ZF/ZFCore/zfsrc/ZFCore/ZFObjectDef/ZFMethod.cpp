@@ -15,6 +15,7 @@ void ZFMethod::_ZFP_ZFMethod_init(ZF_IN zfbool methodIsUserRegister,
                                   ZF_IN ZFObject *methodDynamicRegisterUserData,
                                   ZF_IN ZFFuncAddrType invoker,
                                   ZF_IN ZFMethodGenericInvoker methodGenericInvoker,
+                                  ZF_IN ZFMethodGenericInvokerUnboxed methodGenericInvokerUnboxed,
                                   ZF_IN const zfchar *methodType,
                                   ZF_IN const zfchar *methodName,
                                   ZF_IN const zfchar *returnTypeId,
@@ -30,6 +31,7 @@ void ZFMethod::_ZFP_ZFMethod_init(ZF_IN zfbool methodIsUserRegister,
     this->_ZFP_ZFMethod_invokerOrg = invoker;
     this->_ZFP_ZFMethod_methodGenericInvoker = methodGenericInvoker;
     this->_ZFP_ZFMethod_methodGenericInvokerOrg = methodGenericInvoker;
+    this->_ZFP_ZFMethod_methodGenericInvokerUnboxed = methodGenericInvokerUnboxed;
     this->_ZFP_ZFMethod_methodName = methodName;
     this->_ZFP_ZFMethod_returnTypeId = returnTypeId;
     this->_ZFP_ZFMethod_returnTypeName = returnTypeName;
@@ -110,6 +112,7 @@ ZFMethod::ZFMethod(void)
 , _ZFP_ZFMethod_invokerOrg(zfnull)
 , _ZFP_ZFMethod_methodGenericInvoker(zfnull)
 , _ZFP_ZFMethod_methodGenericInvokerOrg(zfnull)
+, _ZFP_ZFMethod_methodGenericInvokerUnboxed(zfnull)
 , _ZFP_ZFMethod_methodName()
 , _ZFP_ZFMethod_returnTypeId()
 , _ZFP_ZFMethod_returnTypeName()
@@ -276,6 +279,7 @@ zfautoObject ZFMethod::methodGenericInvoke(ZF_IN_OPT ZFObject *ownerObjOrNull /*
     paramList[6].zflockfree_assign(param6);
     paramList[7].zflockfree_assign(param7);
 
+    _ZFP_ZFMethodProfileScope profileScope(this);
     zfbool t = this->methodGenericInvoker()(this, ownerObjOrNull, errorHint, ret, paramList);
     if(success != zfnull)
     {
@@ -284,6 +288,23 @@ zfautoObject ZFMethod::methodGenericInvoke(ZF_IN_OPT ZFObject *ownerObjOrNull /*
     return ret;
 }
 
+zfbool ZFMethod::methodGenericInvokeUnboxed(ZF_IN ZFObject *ownerObjOrNull
+                                           , ZF_OUT ZFMethodGenericValue &ret
+                                           , ZF_IN zfindex paramCount
+                                           , ZF_IN const ZFMethodGenericValue *paramList
+                                           , ZF_OUT_OPT zfstring *errorHint /* = zfnull */
+                                           , ZF_OUT_OPT zfautoObject *retBoxed /* = zfnull */
+                                           ) const
+{
+    ZFMethodGenericInvokerUnboxed invoker = this->methodGenericInvokerUnboxed();
+    if(invoker == zfnull || paramCount > this->methodParamCount())
+    {
+        return zffalse;
+    }
+    _ZFP_ZFMethodProfileScope profileScope(this);
+    return invoker(this, ownerObjOrNull, errorHint, ret, retBoxed, paramCount, paramList);
+}
+
 void ZFMethod::methodGenericInvoker(ZF_IN ZFMethodGenericInvoker methodGenericInvoker) const
 {
     zfCoreMutexLocker();
@@ -389,6 +410,7 @@ ZFMethod *_ZFP_ZFMethodRegister(ZF_IN zfbool methodIsUserRegister
                                 , ZF_IN ZFObject *methodDynamicRegisterUserData
                                 , ZF_IN ZFFuncAddrType methodInvoker
                                 , ZF_IN ZFMethodGenericInvoker methodGenericInvoker
+                                , ZF_IN ZFMethodGenericInvokerUnboxed methodGenericInvokerUnboxed
                                 , ZF_IN const zfchar *methodType
                                 , ZF_IN const ZFClass *methodOwnerClass
                                 , ZF_IN ZFMethodPrivilegeType methodPrivilegeType
@@ -407,6 +429,7 @@ ZFMethod *_ZFP_ZFMethodRegister(ZF_IN zfbool methodIsUserRegister
             , methodDynamicRegisterUserData
             , methodInvoker
             , methodGenericInvoker
+            , methodGenericInvokerUnboxed
             , methodType
             , methodOwnerClass
             , methodPrivilegeType
@@ -424,6 +447,7 @@ ZFMethod *_ZFP_ZFMethodRegisterV(ZF_IN zfbool methodIsUserRegister
                                  , ZF_IN ZFObject *methodDynamicRegisterUserData
                                  , ZF_IN ZFFuncAddrType methodInvoker
                                  , ZF_IN ZFMethodGenericInvoker methodGenericInvoker
+                                 , ZF_IN ZFMethodGenericInvokerUnboxed methodGenericInvokerUnboxed
                                  , ZF_IN const zfchar *methodType
                                  , ZF_IN const ZFClass *methodOwnerClass
                                  , ZF_IN ZFMethodPrivilegeType methodPrivilegeType
@@ -550,6 +574,7 @@ ZFMethod *_ZFP_ZFMethodRegisterV(ZF_IN zfbool methodIsUserRegister
                 , methodDynamicRegisterUserData
                 , methodInvoker
                 , methodGenericInvoker
+                , methodGenericInvokerUnboxed
                 , methodType
                 , methodName
                 , returnTypeId
@@ -601,10 +626,9 @@ void _ZFP_ZFMethodUnregister(ZF_IN const ZFMethod *method)
     }
     else
     {
-        if(method->methodIsUserRegister() || method->methodIsDynamicRegister())
-        {
-            method->methodOwnerClass()->_ZFP_ZFClass_removeConst()->_ZFP_ZFClass_methodUnregister(method);
-        }
+        // also for methods declared by ZFMETHOD_INLINE series,
+        // since class's member table would access all registered methods when rebuilt
+        method->methodOwnerClass()->_ZFP_ZFClass_removeConst()->_ZFP_ZFClass_methodUnregister(method);
     }
     _ZFP_ZFClassDataChangeNotify(ZFClassDataChangeTypeDetach, zfnull, zfnull, method);
 
@@ -616,6 +640,7 @@ _ZFP_ZFMethodRegisterHolder::_ZFP_ZFMethodRegisterHolder(ZF_IN zfbool methodIsUs
                                                          , ZF_IN ZFObject *methodDynamicRegisterUserData
                                                          , ZF_IN ZFFuncAddrType methodInvoker
                                                          , ZF_IN ZFMethodGenericInvoker methodGenericInvoker
+                                                         , ZF_IN ZFMethodGenericInvokerUnboxed methodGenericInvokerUnboxed
                                                          , ZF_IN const zfchar *methodType
                                                          , ZF_IN const ZFClass *methodOwnerClass
                                                          , ZF_IN ZFMethodPrivilegeType methodPrivilegeType
@@ -635,6 +660,7 @@ _ZFP_ZFMethodRegisterHolder::_ZFP_ZFMethodRegisterHolder(ZF_IN zfbool methodIsUs
             , methodDynamicRegisterUserData
             , methodInvoker
             , methodGenericInvoker
+            , methodGenericInvokerUnboxed
             , methodType
             , methodOwnerClass
             , methodPrivilegeType
@@ -652,6 +678,7 @@ _ZFP_ZFMethodRegisterHolder::_ZFP_ZFMethodRegisterHolder(ZF_IN zfbool dummy
                                                          , ZF_IN ZFObject *methodDynamicRegisterUserData
                                                          , ZF_IN ZFFuncAddrType methodInvoker
                                                          , ZF_IN ZFMethodGenericInvoker methodGenericInvoker
+                                                         , ZF_IN ZFMethodGenericInvokerUnboxed methodGenericInvokerUnboxed
                                                          , ZF_IN const zfchar *methodType
                                                          , ZF_IN const ZFClass *methodOwnerClass
                                                          , ZF_IN ZFMethodPrivilegeType methodPrivilegeType
@@ -667,6 +694,7 @@ _ZFP_ZFMethodRegisterHolder::_ZFP_ZFMethodRegisterHolder(ZF_IN zfbool dummy
         , methodDynamicRegisterUserData
         , methodInvoker
         , methodGenericInvoker
+        , methodGenericInvokerUnboxed
         , methodType
         , methodOwnerClass
         , methodPrivilegeType
@@ -54,11 +54,44 @@ typedef enum {
 // ============================================================
 zfclassFwd ZFObject;
 zfclassFwd ZFClass;
+zfclassFwd ZFMethod;
+
+// method profiler, see ZFMethodProfileEnable
+extern ZF_ENV_EXPORT zfbool _ZFP_ZFMethodProfileEnableFlag;
+extern ZF_ENV_EXPORT zftimet _ZFP_ZFMethodProfileBegin(void);
+extern ZF_ENV_EXPORT void _ZFP_ZFMethodProfileEnd(ZF_IN const ZFMethod *method,
+                                                  ZF_IN zftimet beginTime);
+zfclassNotPOD ZF_ENV_EXPORT _ZFP_ZFMethodProfileScope
+{
+public:
+    explicit _ZFP_ZFMethodProfileScope(ZF_IN const ZFMethod *method)
+    : method(zfnull)
+    , beginTime(zftimetZero())
+    {
+        if(_ZFP_ZFMethodProfileEnableFlag)
+        {
+            this->method = method;
+            this->beginTime = _ZFP_ZFMethodProfileBegin();
+        }
+    }
+    ~_ZFP_ZFMethodProfileScope(void)
+    {
+        if(this->method != zfnull)
+        {
+            _ZFP_ZFMethodProfileEnd(this->method, this->beginTime);
+        }
+    }
+private:
+    const ZFMethod *method;
+    zftimet beginTime;
+};
+
 #define _ZFP_ZFMETHOD_INVOKER(N) \
     /** @brief see #ZFMethod */ \
     template<typename T_ReturnType ZFM_REPEAT(N, ZFM_REPEAT_TEMPLATE, ZFM_COMMA, ZFM_COMMA)> \
     inline T_ReturnType execute(ZFObject *obj ZFM_REPEAT(N, ZFM_REPEAT_PARAM, ZFM_COMMA, ZFM_COMMA)) const \
     { \
+        _ZFP_ZFMethodProfileScope _ZFP_profileScope(this); \
         if(this->_ZFP_ZFMethod_invoker) \
         { \
             return ZFCastReinterpret( \
@@ -249,6 +282,7 @@ public:
                             ZF_IN ZFObject *methodDynamicRegisterUserData,
                             ZF_IN ZFFuncAddrType invoker,
                             ZF_IN ZFMethodGenericInvoker methodGenericInvoker,
+                            ZF_IN ZFMethodGenericInvokerUnboxed methodGenericInvokerUnboxed,
                             ZF_IN const zfchar *methodType,
                             ZF_IN const zfchar *methodName,
                             ZF_IN const zfchar *returnTypeId,
@@ -544,6 +578,35 @@ public:
      */
     void methodGenericInvoker(ZF_IN ZFMethodGenericInvoker methodGenericInvoker) const;
 
+    /**
+     * @brief unboxed version of #methodGenericInvoker,
+     *   see #ZFMethodGenericInvokerUnboxed
+     *
+     * null if any of param or return type can not be unboxed,
+     * or #methodGenericInvoker has been changed
+     */
+    inline ZFMethodGenericInvokerUnboxed methodGenericInvokerUnboxed(void) const
+    {
+        return ((this->_ZFP_ZFMethod_methodGenericInvoker == this->_ZFP_ZFMethod_methodGenericInvokerOrg)
+            ? this->_ZFP_ZFMethod_methodGenericInvokerUnboxed
+            : zfnull);
+    }
+    /**
+     * @brief util method to invoke #methodGenericInvokerUnboxed
+     *
+     * return false without invoking the method if not available for the params,
+     * caller should fallback to #methodGenericInvoke\n
+     * if retBoxed is not null, the return value would be boxed to it
+     * instead of ret, see #ZFMethodGenericInvokerUnboxed
+     */
+    zfbool methodGenericInvokeUnboxed(ZF_IN ZFObject *ownerObjOrNull
+                                      , ZF_OUT ZFMethodGenericValue &ret
+                                      , ZF_IN zfindex paramCount
+                                      , ZF_IN const ZFMethodGenericValue *paramList
+                                      , ZF_OUT_OPT zfstring *errorHint = zfnull
+                                      , ZF_OUT_OPT zfautoObject *retBoxed = zfnull
+                                      ) const;
+
     // ============================================================
     // class member type
 public:
@@ -613,6 +676,7 @@ public:
     ZFFuncAddrType _ZFP_ZFMethod_invokerOrg;
     ZFMethodGenericInvoker _ZFP_ZFMethod_methodGenericInvoker;
     ZFMethodGenericInvoker _ZFP_ZFMethod_methodGenericInvokerOrg;
+    ZFMethodGenericInvokerUnboxed _ZFP_ZFMethod_methodGenericInvokerUnboxed;
     zfstring _ZFP_ZFMethod_methodName;
     zfstring _ZFP_ZFMethod_returnTypeId;
     zfstring _ZFP_ZFMethod_returnTypeName;
@@ -640,6 +704,7 @@ extern ZF_ENV_EXPORT ZFMethod *_ZFP_ZFMethodRegister(ZF_IN zfbool methodIsUserRe
                                                      , ZF_IN ZFObject *methodDynamicRegisterUserData
                                                      , ZF_IN ZFFuncAddrType methodInvoker
                                                      , ZF_IN ZFMethodGenericInvoker methodGenericInvoker
+                                                     , ZF_IN ZFMethodGenericInvokerUnboxed methodGenericInvokerUnboxed
                                                      , ZF_IN const zfchar *methodType
                                                      , ZF_IN const ZFClass *methodOwnerClass
                                                      , ZF_IN ZFMethodPrivilegeType methodPrivilegeType
@@ -655,6 +720,7 @@ extern ZF_ENV_EXPORT ZFMethod *_ZFP_ZFMethodRegisterV(ZF_IN zfbool methodIsUserR
                                                       , ZF_IN ZFObject *methodDynamicRegisterUserData
                                                       , ZF_IN ZFFuncAddrType methodInvoker
                                                       , ZF_IN ZFMethodGenericInvoker methodGenericInvoker
+                                                      , ZF_IN ZFMethodGenericInvokerUnboxed methodGenericInvokerUnboxed
                                                       , ZF_IN const zfchar *methodType
                                                       , ZF_IN const ZFClass *methodOwnerClass
                                                       , ZF_IN ZFMethodPrivilegeType methodPrivilegeType
@@ -675,6 +741,7 @@ public:
                                 , ZF_IN ZFObject *methodDynamicRegisterUserData
                                 , ZF_IN ZFFuncAddrType methodInvoker
                                 , ZF_IN ZFMethodGenericInvoker methodGenericInvoker
+                                , ZF_IN ZFMethodGenericInvokerUnboxed methodGenericInvokerUnboxed
                                 , ZF_IN const zfchar *methodType
                                 , ZF_IN const ZFClass *methodOwnerClass
                                 , ZF_IN ZFMethodPrivilegeType methodPrivilegeType
@@ -691,6 +758,7 @@ public:
                                 , ZF_IN ZFObject *methodDynamicRegisterUserData
                                 , ZF_IN ZFFuncAddrType methodInvoker
                                 , ZF_IN ZFMethodGenericInvoker methodGenericInvoker
+                                , ZF_IN ZFMethodGenericInvokerUnboxed methodGenericInvokerUnboxed
                                 , ZF_IN const zfchar *methodType
                                 , ZF_IN const ZFClass *methodOwnerClass
                                 , ZF_IN ZFMethodPrivilegeType methodPrivilegeType
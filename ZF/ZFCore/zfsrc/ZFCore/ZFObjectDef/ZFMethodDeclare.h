@@ -343,6 +343,7 @@ ZF_NAMESPACE_GLOBAL_BEGIN
                     , zfnull \
                     , ZFCastReinterpret(ZFFuncAddrType, &zfself::_ZFP_MtdI_##MethodName##_##RegSig) \
                     , _ZFP_ZFMETHOD_GENERIC_INVOKER_ADDR(_ZFP_MtdH_##MethodName##_##RegSig) \
+                    , _ZFP_ZFMETHOD_GENERIC_INVOKER_UNBOXED_ADDR(_ZFP_MtdH_##MethodName##_##RegSig) \
                     , _ZFP_ZFMethodTypeText(ZFMethodType_) \
                     , zfself::ClassData() \
                     , _ZFP_ZFMethod_initClassMemberType_privilege(PublicOrProtectedOrPrivate) \
@@ -547,6 +548,7 @@ ZF_NAMESPACE_GLOBAL_BEGIN
                 , zfnull \
                 , invokerAddr \
                 , _ZFP_ZFMETHOD_GENERIC_INVOKER_ADDR(_ZFP_MtdH_##OwnerClass##_##MethodName##_##RegSig) \
+                , _ZFP_ZFMETHOD_GENERIC_INVOKER_UNBOXED_ADDR(_ZFP_MtdH_##OwnerClass##_##MethodName##_##RegSig) \
                 , methodTypeText \
                 , zfself::ClassData() \
                 , privilegeType \
@@ -140,6 +140,7 @@ const ZFMethod *ZFMethodDynamicRegister(ZF_IN const ZFMethodDynamicRegisterParam
             , param.methodDynamicRegisterUserData()
             , zfnull
             , param.methodGenericInvoker()
+            , zfnull
             , methodType
             , param.methodOwnerClass()
             , param.methodPrivilegeType()
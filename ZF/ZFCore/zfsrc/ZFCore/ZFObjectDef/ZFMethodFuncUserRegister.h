@@ -32,6 +32,7 @@ extern ZF_ENV_EXPORT void ZFMethodFuncUserUnregister(ZF_IN const ZFMethod *metho
         , zfnull \
         , ZFCastReinterpret(ZFFuncAddrType, methodInvoker) \
         , _ZFP_ZFMETHOD_GENERIC_INVOKER_ADDR(GenericInvokerOwner) \
+        , _ZFP_ZFMETHOD_GENERIC_INVOKER_UNBOXED_ADDR(GenericInvokerOwner) \
         , _ZFP_ZFMethodTypeText(ZFMethodTypeStatic) \
         , zfnull \
         , ZFMethodPrivilegeTypePublic \
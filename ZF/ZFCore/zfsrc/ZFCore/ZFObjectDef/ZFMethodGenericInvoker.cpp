@@ -59,6 +59,52 @@ void _ZFP_MtdGIRetError(ZF_OUT_OPT zfstring *errorHint,
         returnValueInfo);
 }
 
+#define _ZFP_MtdGIUFromStringDefine(TypeName) \
+    zfbool _ZFP_MtdGIUFromString(ZF_OUT TypeName &r, ZF_IN const zfchar *src) \
+    { \
+        return TypeName##FromString(r, src); \
+    }
+_ZFP_MtdGIUFromStringDefine(zfbool)
+_ZFP_MtdGIUFromStringDefine(zfbyte)
+_ZFP_MtdGIUFromStringDefine(zfint)
+_ZFP_MtdGIUFromStringDefine(zfuint)
+_ZFP_MtdGIUFromStringDefine(zfindex)
+_ZFP_MtdGIUFromStringDefine(zffloat)
+_ZFP_MtdGIUFromStringDefine(zfdouble)
+_ZFP_MtdGIUFromStringDefine(zftimet)
+_ZFP_MtdGIUFromStringDefine(zfflags)
+_ZFP_MtdGIUFromStringDefine(zfidentity)
+#undef _ZFP_MtdGIUFromStringDefine
+
+void _ZFP_MtdGIUParamError(ZF_OUT_OPT zfstring *errorHint,
+                           ZF_IN const ZFMethod *invokerMethod,
+                           ZF_IN zfindex paramIndex,
+                           ZF_IN const ZFMethodGenericValue &param)
+{
+    if(errorHint == zfnull)
+    {
+        return ;
+    }
+    const zfchar *valueType = zfnull;
+    switch(param.type)
+    {
+        case ZFMethodGenericValueTypeBool: valueType = ZFTypeId_zfbool(); break;
+        case ZFMethodGenericValueTypeInt: valueType = ZFTypeId_zfint(); break;
+        case ZFMethodGenericValueTypeUInt: valueType = ZFTypeId_zfuint(); break;
+        case ZFMethodGenericValueTypeIndex: valueType = ZFTypeId_zfindex(); break;
+        case ZFMethodGenericValueTypeFloat: valueType = ZFTypeId_zffloat(); break;
+        case ZFMethodGenericValueTypeDouble: valueType = ZFTypeId_zfdouble(); break;
+        case ZFMethodGenericValueTypeString: valueType = ZFTypeId_zfstring(); break;
+        case ZFMethodGenericValueTypeObject: valueType = ZFObject::ClassData()->classNameFull(); break;
+        default: valueType = ZFTOKEN_zfnull; break;
+    }
+    zfstringAppend(errorHint,
+        "[ZFMethodGenericInvoker] unable to access param%zi as type (%s) from unboxed value of type %s",
+        paramIndex,
+        invokerMethod->methodParamTypeNameAtIndex(paramIndex),
+        valueType);
+}
+
 // ============================================================
 zfbool _ZFP_ZFMethodGenericInvoke(ZF_IN const ZFMethod *invokerMethod
                                   , ZF_IN ZFObject *invokerObject
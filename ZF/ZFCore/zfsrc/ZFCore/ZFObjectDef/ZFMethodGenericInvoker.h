@@ -49,6 +49,82 @@ extern ZF_ENV_EXPORT zfautoObject _ZFP_ZFMethodGenericInvokerDefaultParamHolderR
  */
 #define ZFMethodGenericInvokerDefaultParamHolder() ((zfautoObject const &)_ZFP_ZFMethodGenericInvokerDefaultParamHolderRef)
 
+// ============================================================
+/**
+ * @brief value type of #ZFMethodGenericValue
+ */
+typedef enum
+{
+    ZFMethodGenericValueTypeDefault, /**< @brief not set, use default param or no return value */
+    ZFMethodGenericValueTypeBool, /**< @brief zfbool */
+    ZFMethodGenericValueTypeInt, /**< @brief zfint */
+    ZFMethodGenericValueTypeUInt, /**< @brief zfuint */
+    ZFMethodGenericValueTypeIndex, /**< @brief zfindex */
+    ZFMethodGenericValueTypeFloat, /**< @brief zffloat */
+    ZFMethodGenericValueTypeDouble, /**< @brief zfdouble */
+    ZFMethodGenericValueTypeString, /**< @brief const zfchar *, not owned */
+    ZFMethodGenericValueTypeObject, /**< @brief ZFObject *, not retained */
+} ZFMethodGenericValueType;
+/**
+ * @brief typed value slot for #ZFMethodGenericInvokerUnboxed
+ *
+ * numeric values can be converted to any numeric param type,
+ * as long as the value can be represented by the param type
+ * (e.g. 1.5 or -1 can not be converted to zfuint)\n
+ * strings can be converted to primitive param types,
+ * by the same string converter of #ZFTypeIdWrapper::wrappedValueFromString\n
+ * strings and objects are not owned by the slot,
+ * the caller must keep them alive during the invoke
+ */
+zfclassPOD ZF_ENV_EXPORT ZFMethodGenericValue
+{
+public:
+    ZFMethodGenericValueType type; /**< @brief value type */
+    /** @brief the value, see #type */
+    union {
+        zfbool vBool; /**< @brief #ZFMethodGenericValueTypeBool */
+        zfint vInt; /**< @brief #ZFMethodGenericValueTypeInt */
+        zfuint vUInt; /**< @brief #ZFMethodGenericValueTypeUInt */
+        zfindex vIndex; /**< @brief #ZFMethodGenericValueTypeIndex */
+        zffloat vFloat; /**< @brief #ZFMethodGenericValueTypeFloat */
+        zft_zfdouble vDouble; /**< @brief #ZFMethodGenericValueTypeDouble */
+        const zfchar *vString; /**< @brief #ZFMethodGenericValueTypeString */
+        ZFObject *vObject; /**< @brief #ZFMethodGenericValueTypeObject */
+    } v;
+};
+
+/**
+ * @brief unboxed version of #ZFMethodGenericInvoker
+ *
+ * params and return value are passed by #ZFMethodGenericValue,
+ * no object would be allocated during the invoke\n
+ * only available when all params and return value are primitive types
+ * (zfbool, zfbyte, zfint, zfuint, zfindex, zffloat, zfdouble, zftimet, zfflags, zfidentity),
+ * const zfchar *, #zfstring (param only) or #ZFObject pointers,
+ * passed by value or const reference,
+ * see #ZFMethod::methodGenericInvokerUnboxed\n
+ * \n
+ * return false without invoking the method if params can not be converted,
+ * or params with default value are not supplied,
+ * in this case, caller should fallback to #ZFMethod::methodGenericInvoker\n
+ * object returned by ret is not retained,
+ * which has the same lifetime as the original C++ method\n
+ * \n
+ * if retBoxed is not null, the return value would be stored to retBoxed
+ * by #ZFTypeId::ValueStore, exactly the same as #ZFMethodGenericInvoker,
+ * and ret would be set to #ZFMethodGenericValueTypeDefault,
+ * this is useful for callers that must return objects,
+ * while still benefit from the unboxed params
+ */
+typedef zfbool (*ZFMethodGenericInvokerUnboxed)(ZF_IN const ZFMethod *invokerMethod
+                                                , ZF_IN ZFObject *invokerObject
+                                                , ZF_OUT_OPT zfstring *errorHint
+                                                , ZF_OUT ZFMethodGenericValue &ret
+                                                , ZF_OUT_OPT zfautoObject *retBoxed
+                                                , ZF_IN zfindex paramCount
+                                                , ZF_IN const ZFMethodGenericValue *paramList
+                                                );
+
 // ============================================================
 template<typename T_Dummy, int n>
 zfclassNotPOD _ZFP_MtdGICk
@@ -244,6 +320,312 @@ public:
     }
 };
 
+// ============================================================
+// unboxed generic invoker
+extern ZF_ENV_EXPORT void _ZFP_MtdGIUParamError(ZF_OUT_OPT zfstring *errorHint,
+                                                ZF_IN const ZFMethod *invokerMethod,
+                                                ZF_IN zfindex paramIndex,
+                                                ZF_IN const ZFMethodGenericValue &param);
+// convert from string, by the same converter of ZFTypeIdWrapper::wrappedValueFromString
+extern ZF_ENV_EXPORT zfbool _ZFP_MtdGIUFromString(ZF_OUT zfbool &r, ZF_IN const zfchar *src);
+extern ZF_ENV_EXPORT zfbool _ZFP_MtdGIUFromString(ZF_OUT zfbyte &r, ZF_IN const zfchar *src);
+extern ZF_ENV_EXPORT zfbool _ZFP_MtdGIUFromString(ZF_OUT zfint &r, ZF_IN const zfchar *src);
+extern ZF_ENV_EXPORT zfbool _ZFP_MtdGIUFromString(ZF_OUT zfuint &r, ZF_IN const zfchar *src);
+extern ZF_ENV_EXPORT zfbool _ZFP_MtdGIUFromString(ZF_OUT zfindex &r, ZF_IN const zfchar *src);
+extern ZF_ENV_EXPORT zfbool _ZFP_MtdGIUFromString(ZF_OUT zffloat &r, ZF_IN const zfchar *src);
+extern ZF_ENV_EXPORT zfbool _ZFP_MtdGIUFromString(ZF_OUT zfdouble &r, ZF_IN const zfchar *src);
+extern ZF_ENV_EXPORT zfbool _ZFP_MtdGIUFromString(ZF_OUT zftimet &r, ZF_IN const zfchar *src);
+extern ZF_ENV_EXPORT zfbool _ZFP_MtdGIUFromString(ZF_OUT zfflags &r, ZF_IN const zfchar *src);
+extern ZF_ENV_EXPORT zfbool _ZFP_MtdGIUFromString(ZF_OUT zfidentity &r, ZF_IN const zfchar *src);
+/*
+ * isInt : whether T_Type is integer type, only integral values are accepted
+ * isUnsigned : whether T_Type is unsigned, only non-negative values are accepted
+ */
+template<typename T_Type, int isInt, int isUnsigned>
+inline zfbool _ZFP_MtdGIUNum(ZF_OUT T_Type &r, ZF_IN const ZFMethodGenericValue &v)
+{
+    switch(v.type)
+    {
+        case ZFMethodGenericValueTypeInt:
+            if(isUnsigned && v.v.vInt < 0) {return zffalse;}
+            r = (T_Type)v.v.vInt;
+            return zftrue;
+        case ZFMethodGenericValueTypeUInt:
+            r = (T_Type)v.v.vUInt;
+            return zftrue;
+        case ZFMethodGenericValueTypeIndex:
+            r = (T_Type)v.v.vIndex;
+            return zftrue;
+        case ZFMethodGenericValueTypeFloat:
+            if((isUnsigned && v.v.vFloat < 0) || (isInt && (zffloat)(zft_zfint64)v.v.vFloat != v.v.vFloat)) {return zffalse;}
+            r = (T_Type)v.v.vFloat;
+            return zftrue;
+        case ZFMethodGenericValueTypeDouble:
+            if((isUnsigned && v.v.vDouble < 0) || (isInt && (zft_zfdouble)(zft_zfint64)v.v.vDouble != v.v.vDouble)) {return zffalse;}
+            r = (T_Type)v.v.vDouble;
+            return zftrue;
+        case ZFMethodGenericValueTypeString:
+            return (v.v.vString != zfnull && _ZFP_MtdGIUFromString(r, v.v.vString));
+        default:
+            return zffalse;
+    }
+}
+/*
+ * A : whether available as param
+ * R : whether available as return value
+ * g : get from value slot
+ * s : store to value slot
+ */
+template<typename T_Type, typename T_Fix = void>
+zfclassNotPOD _ZFP_MtdGIUT
+{
+public:
+    enum {A = 0, R = 0};
+};
+#define _ZFP_MtdGIUT_NUM(T_Type, valueType, valueField, isInt, isUnsigned) \
+    template<> \
+    zfclassNotPOD _ZFP_MtdGIUT<T_Type> \
+    { \
+    public: \
+        enum {A = 1, R = 1}; \
+        static inline zfbool g(ZF_OUT T_Type &r, ZF_IN const ZFMethodGenericValue &v) \
+        { \
+            return _ZFP_MtdGIUNum<T_Type, isInt, isUnsigned>(r, v); \
+        } \
+        static inline void s(ZF_OUT ZFMethodGenericValue &r, ZF_IN T_Type const &v) \
+        { \
+            r.type = valueType; \
+            r.v.valueField = v; \
+        } \
+    };
+_ZFP_MtdGIUT_NUM(zfbyte, ZFMethodGenericValueTypeUInt, vUInt, 1, 1)
+_ZFP_MtdGIUT_NUM(zfint, ZFMethodGenericValueTypeInt, vInt, 1, 0)
+_ZFP_MtdGIUT_NUM(zfuint, ZFMethodGenericValueTypeUInt, vUInt, 1, 1)
+_ZFP_MtdGIUT_NUM(zfindex, ZFMethodGenericValueTypeIndex, vIndex, 1, 1)
+_ZFP_MtdGIUT_NUM(zffloat, ZFMethodGenericValueTypeFloat, vFloat, 0, 0)
+_ZFP_MtdGIUT_NUM(zfdouble, ZFMethodGenericValueTypeDouble, vDouble, 0, 0)
+_ZFP_MtdGIUT_NUM(zftimet, ZFMethodGenericValueTypeDouble, vDouble, 1, 0)
+_ZFP_MtdGIUT_NUM(zfflags, ZFMethodGenericValueTypeIndex, vIndex, 1, 1)
+_ZFP_MtdGIUT_NUM(zfidentity, ZFMethodGenericValueTypeIndex, vIndex, 1, 1)
+#undef _ZFP_MtdGIUT_NUM
+template<>
+zfclassNotPOD _ZFP_MtdGIUT<zfbool>
+{
+public:
+    enum {A = 1, R = 1};
+    static inline zfbool g(ZF_OUT zfbool &r, ZF_IN const ZFMethodGenericValue &v)
+    {
+        switch(v.type)
+        {
+            case ZFMethodGenericValueTypeBool:
+                r = v.v.vBool;
+                return zftrue;
+            case ZFMethodGenericValueTypeString:
+                return (v.v.vString != zfnull && _ZFP_MtdGIUFromString(r, v.v.vString));
+            default:
+                return zffalse;
+        }
+    }
+    static inline void s(ZF_OUT ZFMethodGenericValue &r, ZF_IN zfbool const &v)
+    {
+        r.type = ZFMethodGenericValueTypeBool;
+        r.v.vBool = v;
+    }
+};
+template<>
+zfclassNotPOD _ZFP_MtdGIUT<const zfchar *>
+{
+public:
+    enum {A = 1, R = 1};
+    static inline zfbool g(ZF_OUT const zfchar *&r, ZF_IN const ZFMethodGenericValue &v)
+    {
+        if(v.type != ZFMethodGenericValueTypeString) {return zffalse;}
+        r = v.v.vString;
+        return zftrue;
+    }
+    static inline void s(ZF_OUT ZFMethodGenericValue &r, ZF_IN const zfchar * const &v)
+    {
+        r.type = ZFMethodGenericValueTypeString;
+        r.v.vString = v;
+    }
+};
+template<>
+zfclassNotPOD _ZFP_MtdGIUT<zfstring>
+{
+public:
+    enum {A = 1, R = 0};
+    static inline zfbool g(ZF_OUT zfstring &r, ZF_IN const ZFMethodGenericValue &v)
+    {
+        if(v.type != ZFMethodGenericValueTypeString) {return zffalse;}
+        r = v.v.vString;
+        return zftrue;
+    }
+};
+template<typename T_Type>
+zfclassNotPOD _ZFP_MtdGIUT<T_Type *, typename zftEnableIf<zftIsZFObject(T_Type)>::EnableIf>
+{
+public:
+    enum {A = 1, R = 1};
+    static inline zfbool g(ZF_OUT T_Type *&r, ZF_IN const ZFMethodGenericValue &v)
+    {
+        if(v.type != ZFMethodGenericValueTypeObject) {return zffalse;}
+        r = ZFCastZFObject(T_Type *, v.v.vObject);
+        return (r != zfnull || v.v.vObject == zfnull);
+    }
+    static inline void s(ZF_OUT ZFMethodGenericValue &r, ZF_IN T_Type * const &v)
+    {
+        r.type = ZFMethodGenericValueTypeObject;
+        r.v.vObject = ZFCastZFObjectUnchecked(ZFObject *, v);
+    }
+};
+
+// holder for params that can not be unboxed, never actually accessed
+zfclassNotPOD _ZFP_MtdGIUDummy
+{
+public:
+    template<typename T_Type>
+    operator T_Type & (void) const
+    {
+        return *(T_Type *)zfnull;
+    }
+};
+/*
+ * whether the type modifier (zftTraits::TrModifier) can be unboxed
+ * A : as param, by value or const reference
+ * R : as return value, by value only,
+ *   reference may refer to the invoker object itself, which must be handled by boxed invoker
+ */
+template<int modifier>
+zfclassNotPOD _ZFP_MtdGIUM
+{
+public:
+    enum {A = 0, R = 0};
+};
+template<> zfclassNotPOD _ZFP_MtdGIUM<zftTraitsModifier_N> {public: enum {A = 1, R = 1};};
+template<> zfclassNotPOD _ZFP_MtdGIUM<zftTraitsModifier_CR> {public: enum {A = 1, R = 0};};
+template<> zfclassNotPOD _ZFP_MtdGIUM<zftTraitsModifier_P> {public: enum {A = 1, R = 1};};
+template<> zfclassNotPOD _ZFP_MtdGIUM<zftTraitsModifier_PCR> {public: enum {A = 1, R = 0};};
+template<> zfclassNotPOD _ZFP_MtdGIUM<zftTraitsModifier_CP> {public: enum {A = 1, R = 1};};
+template<> zfclassNotPOD _ZFP_MtdGIUM<zftTraitsModifier_CPCR> {public: enum {A = 1, R = 0};};
+template<typename T_ParamType, int available = (_ZFP_MtdGIUM<zftTraits<T_ParamType>::TrModifier>::A
+        && _ZFP_MtdGIUT<typename zftTraits<T_ParamType>::TrNoRef>::A)>
+zfclassNotPOD _ZFP_MtdGIUP
+{
+public:
+    enum {A = 0};
+    typedef _ZFP_MtdGIUDummy H;
+    static inline zfbool p(ZF_OUT H &
+                           , ZF_OUT_OPT zfstring *
+                           , ZF_IN const ZFMethod *
+                           , ZF_IN zfindex
+                           , ZF_IN zfindex
+                           , ZF_IN const ZFMethodGenericValue *
+                           )
+    {
+        return zffalse;
+    }
+};
+template<typename T_ParamType>
+zfclassNotPOD _ZFP_MtdGIUP<T_ParamType, 1>
+{
+public:
+    enum {A = 1};
+    typedef typename zftTraits<T_ParamType>::TrNoRef H;
+    static zfbool p(ZF_OUT H &h
+                    , ZF_OUT_OPT zfstring *errorHint
+                    , ZF_IN const ZFMethod *invokerMethod
+                    , ZF_IN zfindex paramIndex
+                    , ZF_IN zfindex paramCount
+                    , ZF_IN const ZFMethodGenericValue *paramList
+                    )
+    {
+        if(paramIndex >= paramCount || paramList[paramIndex].type == ZFMethodGenericValueTypeDefault)
+        {
+            return zffalse;
+        }
+        if(!_ZFP_MtdGIUT<H>::g(h, paramList[paramIndex]))
+        {
+            _ZFP_MtdGIUParamError(errorHint, invokerMethod, paramIndex, paramList[paramIndex]);
+            return zffalse;
+        }
+        return zftrue;
+    }
+};
+template<typename T_ReturnType, int available = (_ZFP_MtdGIUM<zftTraits<T_ReturnType>::TrModifier>::R
+        && _ZFP_MtdGIUT<typename zftTraits<T_ReturnType>::TrNoRef>::R)>
+zfclassNotPOD _ZFP_MtdGIUR
+{
+public:
+    enum {A = 0};
+    typedef T_ReturnType (*Ivk)(ZF_IN const ZFMethod *invokerMethod
+                                , ZF_IN ZFObject *invokerObject
+                                , ZF_IN_OUT void *paramHolder
+                                );
+    static inline void a(ZF_IN Ivk
+                         , ZF_IN const ZFMethod *
+                         , ZF_IN ZFObject *
+                         , ZF_OUT ZFMethodGenericValue &
+                         , ZF_OUT_OPT zfautoObject *
+                         , ZF_IN_OUT void *
+                         )
+    {
+    }
+};
+template<typename T_ReturnType>
+zfclassNotPOD _ZFP_MtdGIUR<T_ReturnType, 1>
+{
+public:
+    enum {A = 1};
+    typedef T_ReturnType (*Ivk)(ZF_IN const ZFMethod *invokerMethod
+                                , ZF_IN ZFObject *invokerObject
+                                , ZF_IN_OUT void *paramHolder
+                                );
+    static inline void a(ZF_IN Ivk invoke
+                         , ZF_IN const ZFMethod *invokerMethod
+                         , ZF_IN ZFObject *invokerObject
+                         , ZF_OUT ZFMethodGenericValue &ret
+                         , ZF_OUT_OPT zfautoObject *retBoxed
+                         , ZF_IN_OUT void *paramHolder
+                         )
+    {
+        typedef typename zftTraits<T_ReturnType>::TrNoRef T_ReturnTypeTmp;
+        if(retBoxed == zfnull)
+        {
+            _ZFP_MtdGIUT<T_ReturnTypeTmp>::s(ret, invoke(invokerMethod, invokerObject, paramHolder));
+        }
+        else
+        {
+            T_ReturnType retTmp = invoke(invokerMethod, invokerObject, paramHolder);
+            ret.type = ZFMethodGenericValueTypeDefault;
+            zfCoreMutexLocker();
+            ZFTypeId<T_ReturnTypeTmp>::ValueStore(*retBoxed, retTmp);
+        }
+    }
+};
+template<>
+zfclassNotPOD _ZFP_MtdGIUR<void, 0>
+{
+public:
+    enum {A = 1};
+    typedef void (*Ivk)(ZF_IN const ZFMethod *invokerMethod
+                        , ZF_IN ZFObject *invokerObject
+                        , ZF_IN_OUT void *paramHolder
+                        );
+    static inline void a(ZF_IN Ivk invoke
+                         , ZF_IN const ZFMethod *invokerMethod
+                         , ZF_IN ZFObject *invokerObject
+                         , ZF_OUT ZFMethodGenericValue &ret
+                         , ZF_OUT_OPT zfautoObject *
+                         , ZF_IN_OUT void *paramHolder
+                         )
+    {
+        invoke(invokerMethod, invokerObject, paramHolder);
+        ret.type = ZFMethodGenericValueTypeDefault;
+    }
+};
+#define _ZFP_ZFMETHOD_GENERIC_INVOKER_UNBOXED_PREPARE_EXPAND(N) \
+    || !_ZFP_MtdGIUP<_T##N>::p(_p.p##N, errorHint, invokerMethod, N, paramCount, paramList)
+
 // ============================================================
 #define _ZFP_ZFMETHOD_GENERIC_INVOKER_DECLARE( \
         ReturnType \
@@ -325,9 +707,94 @@ public:
                     ParamExpandOrEmpty7(ZFM_COMMA() _ZFP_ZFMETHOD_GENERIC_INVOKER_PARAM_ACCESS_EXPAND(7, DefaultExpandOrEmpty7, ParamType7, paramList[7])) \
                 ); \
         } \
+    private: \
+        zfclassNotPOD PU \
+        { \
+        public: \
+            ParamExpandOrEmpty0(_ZFP_MtdGIUP<_T0>::H p0;) \
+            ParamExpandOrEmpty1(_ZFP_MtdGIUP<_T1>::H p1;) \
+            ParamExpandOrEmpty2(_ZFP_MtdGIUP<_T2>::H p2;) \
+            ParamExpandOrEmpty3(_ZFP_MtdGIUP<_T3>::H p3;) \
+            ParamExpandOrEmpty4(_ZFP_MtdGIUP<_T4>::H p4;) \
+            ParamExpandOrEmpty5(_ZFP_MtdGIUP<_T5>::H p5;) \
+            ParamExpandOrEmpty6(_ZFP_MtdGIUP<_T6>::H p6;) \
+            ParamExpandOrEmpty7(_ZFP_MtdGIUP<_T7>::H p7;) \
+        }; \
+    public: \
+        enum { \
+            GIUA = (_ZFP_MtdGIUR<ReturnType>::A \
+                ParamExpandOrEmpty0(&& _ZFP_MtdGIUP<_T0>::A) \
+                ParamExpandOrEmpty1(&& _ZFP_MtdGIUP<_T1>::A) \
+                ParamExpandOrEmpty2(&& _ZFP_MtdGIUP<_T2>::A) \
+                ParamExpandOrEmpty3(&& _ZFP_MtdGIUP<_T3>::A) \
+                ParamExpandOrEmpty4(&& _ZFP_MtdGIUP<_T4>::A) \
+                ParamExpandOrEmpty5(&& _ZFP_MtdGIUP<_T5>::A) \
+                ParamExpandOrEmpty6(&& _ZFP_MtdGIUP<_T6>::A) \
+                ParamExpandOrEmpty7(&& _ZFP_MtdGIUP<_T7>::A) \
+                ), \
+        }; \
+        static zfbool GIU(ZF_IN const ZFMethod *invokerMethod \
+                          , ZF_IN ZFObject *invokerObject \
+                          , ZF_OUT_OPT zfstring *errorHint \
+                          , ZF_OUT ZFMethodGenericValue &ret \
+                          , ZF_OUT_OPT zfautoObject *retBoxed \
+                          , ZF_IN zfindex paramCount \
+                          , ZF_IN const ZFMethodGenericValue *paramList \
+                          ) \
+        { \
+            ZFUNUSED(errorHint); \
+            ZFUNUSED(paramCount); \
+            ZFUNUSED(paramList); \
+            PU _p; \
+            if(!GIUA \
+                ParamExpandOrEmpty0(_ZFP_ZFMETHOD_GENERIC_INVOKER_UNBOXED_PREPARE_EXPAND(0)) \
+                ParamExpandOrEmpty1(_ZFP_ZFMETHOD_GENERIC_INVOKER_UNBOXED_PREPARE_EXPAND(1)) \
+                ParamExpandOrEmpty2(_ZFP_ZFMETHOD_GENERIC_INVOKER_UNBOXED_PREPARE_EXPAND(2)) \
+                ParamExpandOrEmpty3(_ZFP_ZFMETHOD_GENERIC_INVOKER_UNBOXED_PREPARE_EXPAND(3)) \
+                ParamExpandOrEmpty4(_ZFP_ZFMETHOD_GENERIC_INVOKER_UNBOXED_PREPARE_EXPAND(4)) \
+                ParamExpandOrEmpty5(_ZFP_ZFMETHOD_GENERIC_INVOKER_UNBOXED_PREPARE_EXPAND(5)) \
+                ParamExpandOrEmpty6(_ZFP_ZFMETHOD_GENERIC_INVOKER_UNBOXED_PREPARE_EXPAND(6)) \
+                ParamExpandOrEmpty7(_ZFP_ZFMETHOD_GENERIC_INVOKER_UNBOXED_PREPARE_EXPAND(7)) \
+                ) \
+            { \
+                return zffalse; \
+            } \
+            _ZFP_MtdGIUR<ReturnType>::a(IU, invokerMethod, invokerObject, ret, retBoxed, &_p); \
+            return zftrue; \
+        } \
+    private: \
+        static ReturnType IU(ZF_IN const ZFMethod *invokerMethod \
+                             , ZF_IN ZFObject *invokerObject \
+                             , ZF_IN_OUT void *paramHolder \
+                             ) \
+        { \
+            PU &_p = *(PU *)paramHolder; \
+            ZFUNUSED(_p); \
+            return invokerMethod->_ZFP_execute<ReturnType \
+                    ParamExpandOrEmpty0(ZFM_COMMA() ParamType0) \
+                    ParamExpandOrEmpty1(ZFM_COMMA() ParamType1) \
+                    ParamExpandOrEmpty2(ZFM_COMMA() ParamType2) \
+                    ParamExpandOrEmpty3(ZFM_COMMA() ParamType3) \
+                    ParamExpandOrEmpty4(ZFM_COMMA() ParamType4) \
+                    ParamExpandOrEmpty5(ZFM_COMMA() ParamType5) \
+                    ParamExpandOrEmpty6(ZFM_COMMA() ParamType6) \
+                    ParamExpandOrEmpty7(ZFM_COMMA() ParamType7) \
+                >(invokerObject \
+                    ParamExpandOrEmpty0(ZFM_COMMA() _p.p0) \
+                    ParamExpandOrEmpty1(ZFM_COMMA() _p.p1) \
+                    ParamExpandOrEmpty2(ZFM_COMMA() _p.p2) \
+                    ParamExpandOrEmpty3(ZFM_COMMA() _p.p3) \
+                    ParamExpandOrEmpty4(ZFM_COMMA() _p.p4) \
+                    ParamExpandOrEmpty5(ZFM_COMMA() _p.p5) \
+                    ParamExpandOrEmpty6(ZFM_COMMA() _p.p6) \
+                    ParamExpandOrEmpty7(ZFM_COMMA() _p.p7) \
+                ); \
+        } \
     public:
 #define _ZFP_ZFMETHOD_GENERIC_INVOKER_ADDR(owner) \
     owner::GI
+#define _ZFP_ZFMETHOD_GENERIC_INVOKER_UNBOXED_ADDR(owner) \
+    (owner::GIUA ? owner::GIU : (ZFMethodGenericInvokerUnboxed)zfnull)
 #define _ZFP_ZFMETHOD_GENERIC_PARAM_DEFAULT_ACCESS_ADDR(owner, DefaultExpandOrEmpty, N) \
     (zfnull DefaultExpandOrEmpty(ZFM_EMPTY(), owner::pDef##N))
 
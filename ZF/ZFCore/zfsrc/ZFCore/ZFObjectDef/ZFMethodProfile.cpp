@@ -0,0 +1,513 @@
+#include "ZFMethodProfile.h"
+#include "ZFObjectImpl.h"
+#include "ZFListenerDeclare.h"
+#include "ZFCore/ZFSTLWrapper/zfstl_map.h"
+
+ZF_NAMESPACE_GLOBAL_BEGIN
+
+#if defined(__GNUC__) || defined(__clang__)
+    #define _ZFP_ZFMethodProfile_threadLocal __thread
+#elif defined(_MSC_VER)
+    #define _ZFP_ZFMethodProfile_threadLocal __declspec(thread)
+#endif
+
+// ============================================================
+zfclassPOD _ZFP_ZFMethodProfileStat
+{
+public:
+    zfindex callCount;
+    zftimet totalTime;
+    zftimet maxTime;
+};
+zfclassPOD _ZFP_ZFMethodProfileEvent
+{
+public:
+    const ZFMethod *method; // null if method detached
+    zftimet beginTime;
+    zftimet duration;
+};
+zfclassNotPOD _ZFP_ZFMethodProfileThreadData
+{
+public:
+    zfatomicint lock;
+    zfindex tid;
+    zfstlmap<const ZFMethod *, _ZFP_ZFMethodProfileStat> stats;
+    ZFCoreArrayPOD<_ZFP_ZFMethodProfileEvent> events;
+public:
+    _ZFP_ZFMethodProfileThreadData(void)
+    : lock(0)
+    , tid(0)
+    , stats()
+    , events()
+    {
+    }
+};
+
+zfclassNotPOD _ZFP_ZFMethodProfileGlobal
+{
+public:
+    zfatomicint lock;
+    ZFCoreArrayPOD<_ZFP_ZFMethodProfileThreadData *> threads;
+    ZFMethodProfileTimestampImpl timestampImpl;
+    zftimet beginTime;
+    zfint traceEventMax;
+    zfatomicint traceEventCount;
+public:
+    _ZFP_ZFMethodProfileGlobal(void)
+    : lock(0)
+    , threads()
+    , timestampImpl(zfnull)
+    , beginTime(zftimetZero())
+    , traceEventMax(0)
+    , traceEventCount(0)
+    {
+    }
+    ~_ZFP_ZFMethodProfileGlobal(void)
+    {
+        for(zfindex i = 0; i < this->threads.count(); ++i)
+        {
+            zfdelete(this->threads[i]);
+        }
+    }
+public:
+    _ZFP_ZFMethodProfileThreadData *threadDataCreate(void)
+    {
+        _ZFP_ZFMethodProfileThreadData *d = zfnew(_ZFP_ZFMethodProfileThreadData);
+        zfAtomicSpinLocker(this->lock);
+        this->threads.add(d);
+        d->tid = this->threads.count();
+        return d;
+    }
+    zftimet timestamp(void)
+    {
+        return (this->timestampImpl != zfnull) ? this->timestampImpl() : zftimetZero();
+    }
+};
+static _ZFP_ZFMethodProfileGlobal &_ZFP_ZFMethodProfileGlobalData(void)
+{
+    static _ZFP_ZFMethodProfileGlobal d;
+    return d;
+}
+
+#ifdef _ZFP_ZFMethodProfile_threadLocal
+static _ZFP_ZFMethodProfile_threadLocal _ZFP_ZFMethodProfileThreadData *_ZFP_ZFMethodProfileThreadDataLocal = zfnull;
+static inline _ZFP_ZFMethodProfileThreadData *_ZFP_ZFMethodProfileThreadDataForCurrentThread(void)
+{
+    if(_ZFP_ZFMethodProfileThreadDataLocal == zfnull)
+    {
+        _ZFP_ZFMethodProfileThreadDataLocal = _ZFP_ZFMethodProfileGlobalData().threadDataCreate();
+    }
+    return _ZFP_ZFMethodProfileThreadDataLocal;
+}
+#else
+// no thread local storage, all threads share one buffer, guarded by its own lock
+static _ZFP_ZFMethodProfileThreadData *_ZFP_ZFMethodProfileThreadDataForCurrentThread(void)
+{
+    static _ZFP_ZFMethodProfileThreadData *d = _ZFP_ZFMethodProfileGlobalData().threadDataCreate();
+    return d;
+}
+#endif
+
+// ============================================================
+zfbool _ZFP_ZFMethodProfileEnableFlag = zffalse;
+
+zftimet _ZFP_ZFMethodProfileBegin(void)
+{
+    return _ZFP_ZFMethodProfileGlobalData().timestamp();
+}
+void _ZFP_ZFMethodProfileEnd(ZF_IN const ZFMethod *method,
+                             ZF_IN zftimet beginTime)
+{
+    _ZFP_ZFMethodProfileGlobal &g = _ZFP_ZFMethodProfileGlobalData();
+    zftimet duration = g.timestamp() - beginTime;
+    if(duration < 0)
+    {
+        duration = zftimetZero();
+    }
+    _ZFP_ZFMethodProfileThreadData *d = _ZFP_ZFMethodProfileThreadDataForCurrentThread();
+    zfAtomicSpinLocker(d->lock);
+    zfstlmap<const ZFMethod *, _ZFP_ZFMethodProfileStat>::iterator it = d->stats.find(method);
+    if(it == d->stats.end())
+    {
+        _ZFP_ZFMethodProfileStat stat;
+        stat.callCount = 1;
+        stat.totalTime = duration;
+        stat.maxTime = duration;
+        d->stats[method] = stat;
+    }
+    else
+    {
+        _ZFP_ZFMethodProfileStat &stat = it->second;
+        ++(stat.callCount);
+        stat.totalTime += duration;
+        if(duration > stat.maxTime)
+        {
+            stat.maxTime = duration;
+        }
+    }
+    if(g.traceEventMax > 0 && zfAtomicLoad(g.traceEventCount) < g.traceEventMax)
+    {
+        if(zfAtomicIncrease(g.traceEventCount) <= g.traceEventMax)
+        {
+            _ZFP_ZFMethodProfileEvent event;
+            event.method = method;
+            event.beginTime = beginTime;
+            event.duration = duration;
+            d->events.add(event);
+        }
+    }
+}
+
+// ============================================================
+// remove detached method from recorded data
+ZF_GLOBAL_INITIALIZER_INIT_WITH_LEVEL_AND_FLAGS(ZFMethodProfileDataHolder, ZFLevelZFFrameworkEssential, ZFGlobalInitializerFlagLazy)
+{
+}
+ZF_GLOBAL_INITIALIZER_DESTROY(ZFMethodProfileDataHolder)
+{
+    _ZFP_ZFMethodProfileEnableFlag = zffalse;
+    if(this->classOnChangeListener.callbackIsValid())
+    {
+        ZFClassDataChangeObserver.observerRemove(
+            ZFGlobalEvent::EventClassDataChange(),
+            this->classOnChangeListener);
+    }
+}
+ZFListener classOnChangeListener;
+void checkAttach(void)
+{
+    if(!this->classOnChangeListener.callbackIsValid())
+    {
+        this->classOnChangeListener = ZFCallbackForFunc(zfself::classOnChange);
+        ZFClassDataChangeObserver.observerAdd(
+            ZFGlobalEvent::EventClassDataChange(),
+            this->classOnChangeListener);
+    }
+}
+static ZFLISTENER_PROTOTYPE_EXPAND(classOnChange)
+{
+    const ZFClassDataChangeData *data = listenerData.param0<ZFPointerHolder *>()->holdedDataPointer<const ZFClassDataChangeData *>();
+    if(data->changeType != ZFClassDataChangeTypeDetach || data->changedMethod == zfnull)
+    {
+        return;
+    }
+    _ZFP_ZFMethodProfileGlobal &g = _ZFP_ZFMethodProfileGlobalData();
+    zfAtomicSpinLocker(g.lock);
+    for(zfindex iThread = 0; iThread < g.threads.count(); ++iThread)
+    {
+        _ZFP_ZFMethodProfileThreadData *d = g.threads[iThread];
+        zfAtomicSpinLocker(d->lock);
+        d->stats.erase(data->changedMethod);
+        for(zfindex i = 0; i < d->events.count(); ++i)
+        {
+            if(d->events[i].method == data->changedMethod)
+            {
+                d->events[i].method = zfnull;
+            }
+        }
+    }
+}
+ZF_GLOBAL_INITIALIZER_END(ZFMethodProfileDataHolder)
+
+void ZFMethodProfileEnable(ZF_IN zfbool enable,
+                           ZF_IN_OPT zfindex traceEventMax /* = 0 */)
+{
+    zfCoreMutexLocker();
+    _ZFP_ZFMethodProfileGlobal &g = _ZFP_ZFMethodProfileGlobalData();
+    if(enable)
+    {
+        ZF_GLOBAL_INITIALIZER_INSTANCE(ZFMethodProfileDataHolder)->checkAttach();
+        if(!_ZFP_ZFMethodProfileEnableFlag && g.beginTime == zftimetZero())
+        {
+            g.beginTime = g.timestamp();
+        }
+        g.traceEventMax = (zfint)zfmMin<zfindex>(traceEventMax, (zfindex)0x7FFFFFFF);
+    }
+    _ZFP_ZFMethodProfileEnableFlag = enable;
+}
+zfbool ZFMethodProfileEnabled(void)
+{
+    return _ZFP_ZFMethodProfileEnableFlag;
+}
+void ZFMethodProfileReset(void)
+{
+    zfCoreMutexLocker();
+    _ZFP_ZFMethodProfileGlobal &g = _ZFP_ZFMethodProfileGlobalData();
+    zfAtomicSpinLocker(g.lock);
+    for(zfindex iThread = 0; iThread < g.threads.count(); ++iThread)
+    {
+        _ZFP_ZFMethodProfileThreadData *d = g.threads[iThread];
+        zfAtomicSpinLocker(d->lock);
+        d->stats.clear();
+        d->events.removeAll();
+    }
+    zfAtomicStore(g.traceEventCount, 0);
+    g.beginTime = g.timestamp();
+}
+
+// ============================================================
+// must be called with global lock
+static void _ZFP_ZFMethodProfileStateMerge(ZF_IN_OUT zfstlmap<const ZFMethod *, _ZFP_ZFMethodProfileStat> &ret,
+                                           ZF_IN_OPT const ZFMethod *method = zfnull)
+{
+    _ZFP_ZFMethodProfileGlobal &g = _ZFP_ZFMethodProfileGlobalData();
+    for(zfindex iThread = 0; iThread < g.threads.count(); ++iThread)
+    {
+        _ZFP_ZFMethodProfileThreadData *d = g.threads[iThread];
+        zfAtomicSpinLocker(d->lock);
+        zfstlmap<const ZFMethod *, _ZFP_ZFMethodProfileStat>::iterator it = (method != zfnull)
+            ? d->stats.find(method)
+            : d->stats.begin();
+        for( ; it != d->stats.end(); ++it)
+        {
+            zfstlmap<const ZFMethod *, _ZFP_ZFMethodProfileStat>::iterator itRet = ret.find(it->first);
+            if(itRet == ret.end())
+            {
+                ret[it->first] = it->second;
+            }
+            else
+            {
+                _ZFP_ZFMethodProfileStat &stat = itRet->second;
+                stat.callCount += it->second.callCount;
+                stat.totalTime += it->second.totalTime;
+                if(it->second.maxTime > stat.maxTime)
+                {
+                    stat.maxTime = it->second.maxTime;
+                }
+            }
+            if(method != zfnull)
+            {
+                break;
+            }
+        }
+    }
+}
+static void _ZFP_ZFMethodProfileStateCopy(ZF_OUT ZFMethodProfileState &ret,
+                                          ZF_IN const ZFMethod *method,
+                                          ZF_IN const _ZFP_ZFMethodProfileStat &stat)
+{
+    ret.method = method;
+    ret.callCount = stat.callCount;
+    ret.totalTime = stat.totalTime;
+    ret.maxTime = stat.maxTime;
+}
+
+zfbool ZFMethodProfileStateGet(ZF_OUT ZFMethodProfileState &ret,
+                               ZF_IN const ZFMethod *method)
+{
+    if(method == zfnull)
+    {
+        return zffalse;
+    }
+    zfstlmap<const ZFMethod *, _ZFP_ZFMethodProfileStat> m;
+    {
+        zfAtomicSpinLocker(_ZFP_ZFMethodProfileGlobalData().lock);
+        _ZFP_ZFMethodProfileStateMerge(m, method);
+    }
+    if(m.empty())
+    {
+        return zffalse;
+    }
+    _ZFP_ZFMethodProfileStateCopy(ret, method, m.begin()->second);
+    return zftrue;
+}
+
+static ZFCompareResult _ZFP_ZFMethodProfileStateCompare(ZF_IN ZFMethodProfileState const &e0,
+                                                        ZF_IN ZFMethodProfileState const &e1)
+{
+    if(e0.totalTime != e1.totalTime)
+    {
+        return (e0.totalTime > e1.totalTime) ? ZFCompareSmaller : ZFCompareGreater;
+    }
+    if(e0.callCount != e1.callCount)
+    {
+        return (e0.callCount > e1.callCount) ? ZFCompareSmaller : ZFCompareGreater;
+    }
+    return ZFCompareTheSame;
+}
+void ZFMethodProfileStateGetAllT(ZF_IN_OUT ZFCoreArray<ZFMethodProfileState> &ret)
+{
+    zfstlmap<const ZFMethod *, _ZFP_ZFMethodProfileStat> m;
+    {
+        zfAtomicSpinLocker(_ZFP_ZFMethodProfileGlobalData().lock);
+        _ZFP_ZFMethodProfileStateMerge(m);
+    }
+    zfindex start = ret.count();
+    ret.capacity(ret.count() + m.size());
+    for(zfstlmap<const ZFMethod *, _ZFP_ZFMethodProfileStat>::iterator it = m.begin(); it != m.end(); ++it)
+    {
+        ZFMethodProfileState state;
+        _ZFP_ZFMethodProfileStateCopy(state, it->first, it->second);
+        ret.add(state);
+    }
+    ret.sort(_ZFP_ZFMethodProfileStateCompare, zftrue, start);
+}
+
+static void _ZFP_ZFMethodProfileMethodName(ZF_IN_OUT zfstring &ret, ZF_IN const ZFMethod *method)
+{
+    if(method->methodIsFunctionType())
+    {
+        if(method->methodNamespace() != zfnull)
+        {
+            ret += method->methodNamespace();
+            ret += "::";
+        }
+    }
+    else
+    {
+        ret += method->methodOwnerClass()->classNameFull();
+        ret += "::";
+    }
+    ret += method->methodName();
+}
+
+void ZFMethodProfilePrint(ZF_IN const ZFOutput &output,
+                          ZF_IN_OPT zfindex maxCount /* = zfindexMax() */)
+{
+    if(!output.callbackIsValid())
+    {
+        return;
+    }
+    ZFCoreArrayPOD<ZFMethodProfileState> states;
+    ZFMethodProfileStateGetAllT(states);
+    zfstring s;
+    zfstringAppend(s, "[ZFMethodProfile] %zi methods called\n", states.count());
+    zfstringAppend(s, "  %10s %12s %10s %10s  %s\n",
+        "count", "total(us)", "avg(us)", "max(us)", "method");
+    output.execute(s.cString(), s.length());
+    for(zfindex i = 0; i < states.count() && i < maxCount; ++i)
+    {
+        const ZFMethodProfileState &state = states[i];
+        s.removeAll();
+        zfstringAppend(s, "  %10zi %12s %10s %10s  ",
+            state.callCount,
+            zfsFromInt(state.totalTime).cString(),
+            zfsFromInt(state.averageTime()).cString(),
+            zfsFromInt(state.maxTime).cString());
+        _ZFP_ZFMethodProfileMethodName(s, state.method);
+        s += "\n";
+        output.execute(s.cString(), s.length());
+    }
+}
+
+// ============================================================
+zfindex ZFMethodProfileTraceEventCount(void)
+{
+    _ZFP_ZFMethodProfileGlobal &g = _ZFP_ZFMethodProfileGlobalData();
+    zfindex ret = 0;
+    zfAtomicSpinLocker(g.lock);
+    for(zfindex iThread = 0; iThread < g.threads.count(); ++iThread)
+    {
+        _ZFP_ZFMethodProfileThreadData *d = g.threads[iThread];
+        zfAtomicSpinLocker(d->lock);
+        ret += d->events.count();
+    }
+    return ret;
+}
+
+static void _ZFP_ZFMethodProfileJsonEscape(ZF_IN_OUT zfstring &ret, ZF_IN const zfchar *src)
+{
+    for(const zfchar *p = src; *p != '\0'; ++p)
+    {
+        switch(*p)
+        {
+            case '"':
+            case '\\':
+                ret += '\\';
+                ret += *p;
+                break;
+            default:
+                if((unsigned char)*p >= 0x20)
+                {
+                    ret += *p;
+                }
+                break;
+        }
+    }
+}
+zfclassPOD _ZFP_ZFMethodProfileTraceEvent
+{
+public:
+    const ZFMethod *method;
+    zftimet ts;
+    zftimet duration;
+    zfindex tid;
+};
+void ZFMethodProfileTraceOutput(ZF_IN const ZFOutput &output)
+{
+    if(!output.callbackIsValid())
+    {
+        return;
+    }
+
+    // output may be a reflective method which would be profiled,
+    // copy all events and method names, then write without lock
+    ZFCoreArrayPOD<_ZFP_ZFMethodProfileTraceEvent> events;
+    zfstlmap<const ZFMethod *, zfstring> names;
+    {
+        _ZFP_ZFMethodProfileGlobal &g = _ZFP_ZFMethodProfileGlobalData();
+        zfAtomicSpinLocker(g.lock);
+        for(zfindex iThread = 0; iThread < g.threads.count(); ++iThread)
+        {
+            _ZFP_ZFMethodProfileThreadData *d = g.threads[iThread];
+            zfAtomicSpinLocker(d->lock);
+            events.capacity(events.count() + d->events.count());
+            for(zfindex i = 0; i < d->events.count(); ++i)
+            {
+                const _ZFP_ZFMethodProfileEvent &event = d->events[i];
+                if(event.method == zfnull)
+                {
+                    continue;
+                }
+                _ZFP_ZFMethodProfileTraceEvent e;
+                e.method = event.method;
+                e.ts = event.beginTime - g.beginTime;
+                e.duration = event.duration;
+                e.tid = d->tid;
+                events.add(e);
+                zfstring &name = names[event.method];
+                if(name.isEmpty())
+                {
+                    _ZFP_ZFMethodProfileMethodName(name, event.method);
+                }
+            }
+        }
+    }
+
+    const zfchar *header = "{\"traceEvents\":[";
+    output.execute(header, zfslen(header));
+    zfstring s;
+    for(zfindex i = 0; i < events.count(); ++i)
+    {
+        const _ZFP_ZFMethodProfileTraceEvent &e = events[i];
+        s.removeAll();
+        s += (i == 0 ? "\n" : ",\n");
+        s += "{\"name\":\"";
+        _ZFP_ZFMethodProfileJsonEscape(s, names[e.method].cString());
+        zfstringAppend(s, "\",\"cat\":\"ZFMethod\",\"ph\":\"X\",\"ts\":%s,\"dur\":%s,\"pid\":1,\"tid\":%zi}",
+            zfsFromInt((e.ts > 0) ? e.ts : zftimetZero()).cString(),
+            zfsFromInt(e.duration).cString(),
+            e.tid);
+        output.execute(s.cString(), s.length());
+    }
+    const zfchar *footer = "\n]}\n";
+    output.execute(footer, zfslen(footer));
+}
+
+// ============================================================
+void ZFMethodProfileTimestampImplSet(ZF_IN ZFMethodProfileTimestampImpl impl)
+{
+    zfCoreMutexLocker();
+    _ZFP_ZFMethodProfileGlobal &g = _ZFP_ZFMethodProfileGlobalData();
+    g.timestampImpl = impl;
+    g.beginTime = (impl != zfnull && _ZFP_ZFMethodProfileEnableFlag)
+        ? impl()
+        : zftimetZero();
+}
+ZFMethodProfileTimestampImpl ZFMethodProfileTimestampImplGet(void)
+{
+    return _ZFP_ZFMethodProfileGlobalData().timestampImpl;
+}
+
+ZF_NAMESPACE_GLOBAL_END
+
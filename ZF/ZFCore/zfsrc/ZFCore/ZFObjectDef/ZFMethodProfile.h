@@ -0,0 +1,141 @@
+/**
+ * @file ZFMethodProfile.h
+ * @brief call count and time profiler for reflective method call
+ */
+
+#ifndef _ZFI_ZFMethodProfile_h_
+#define _ZFI_ZFMethodProfile_h_
+
+#include "ZFObjectCore.h"
+#include "ZFIOCallback.h"
+
+ZF_NAMESPACE_GLOBAL_BEGIN
+
+// ============================================================
+/**
+ * @brief profile state of a method, see #ZFMethodProfileEnable
+ */
+zfclassPOD ZF_ENV_EXPORT ZFMethodProfileState
+{
+public:
+    const ZFMethod *method; /**< @brief the method */
+    zfindex callCount; /**< @brief call count since last #ZFMethodProfileReset */
+    zftimet totalTime; /**< @brief inclusive time in micro seconds */
+    zftimet maxTime; /**< @brief max inclusive time of single call in micro seconds */
+
+public:
+    /** @brief average inclusive time of single call in micro seconds */
+    zftimet averageTime(void) const
+    {
+        return (this->callCount > 0)
+            ? (zftimet)(this->totalTime / (zftimet)this->callCount)
+            : zftimetZero();
+    }
+};
+
+// ============================================================
+/**
+ * @brief enable or disable the method profiler, disabled by default
+ *
+ * when enabled, each call to #ZFMethod::execute, #ZFMethod::methodGenericInvoke,
+ * #ZFMethod::methodGenericInvokeUnboxed and #ZFDI_invoke
+ * (which is also used by script bridges such as lua)
+ * would be accounted to the method,
+ * with call count and inclusive time\n
+ * \n
+ * when disabled, each call costs only one flag check\n
+ * \n
+ * traceEventMax can be used to record each call as trace event,
+ * which can be exported as Chrome trace event format by #ZFMethodProfileTraceOutput,
+ * events exceeds traceEventMax would be dropped,
+ * while call count and time would still be accounted\n
+ * \n
+ * each thread records to its own buffer,
+ * so the profiler can be used with multiple threads,
+ * typical usage:
+ * @code
+ *   ZFMethodProfileEnable(zftrue, 100000);
+ *   yourHeavyFunc();
+ *   ZFMethodProfileEnable(zffalse);
+ *   ZFMethodProfilePrint(ZFOutputDefault(), 20);
+ *   ZFMethodProfileTraceOutput(ZFOutputForFile("trace.json"));
+ * @endcode
+ */
+extern ZF_ENV_EXPORT void ZFMethodProfileEnable(ZF_IN zfbool enable,
+                                                ZF_IN_OPT zfindex traceEventMax = 0);
+/** @brief see #ZFMethodProfileEnable */
+extern ZF_ENV_EXPORT zfbool ZFMethodProfileEnabled(void);
+/**
+ * @brief remove all recorded states and trace events
+ *
+ * calls that not finished during reset would still be accounted when finished
+ */
+extern ZF_ENV_EXPORT void ZFMethodProfileReset(void);
+
+/**
+ * @brief get profile state of method, return false if never called since last #ZFMethodProfileReset
+ */
+extern ZF_ENV_EXPORT zfbool ZFMethodProfileStateGet(ZF_OUT ZFMethodProfileState &ret,
+                                                    ZF_IN const ZFMethod *method);
+/**
+ * @brief get profile state of all called methods,
+ *   sorted by #ZFMethodProfileState::totalTime then #ZFMethodProfileState::callCount, descending
+ */
+extern ZF_ENV_EXPORT void ZFMethodProfileStateGetAllT(ZF_IN_OUT ZFCoreArray<ZFMethodProfileState> &ret);
+/** @brief see #ZFMethodProfileStateGetAllT */
+inline ZFCoreArrayPOD<ZFMethodProfileState> ZFMethodProfileStateGetAll(void)
+{
+    ZFCoreArrayPOD<ZFMethodProfileState> ret;
+    ZFMethodProfileStateGetAllT(ret);
+    return ret;
+}
+
+/**
+ * @brief print profile state of all called methods, see #ZFMethodProfileStateGetAll
+ *
+ * maxCount can be used to print only the top N methods
+ */
+extern ZF_ENV_EXPORT void ZFMethodProfilePrint(ZF_IN const ZFOutput &output,
+                                               ZF_IN_OPT zfindex maxCount = zfindexMax());
+
+/** @brief recorded trace event count, see #ZFMethodProfileEnable */
+extern ZF_ENV_EXPORT zfindex ZFMethodProfileTraceEventCount(void);
+/**
+ * @brief output recorded trace events as Chrome trace event format,
+ *   which can be opened by chrome://tracing or Perfetto
+ *
+ * format:
+ * @code
+ *   {"traceEvents":[
+ *   {"name":"ClassName::methodName","cat":"ZFMethod","ph":"X","ts":123,"dur":4,"pid":1,"tid":1},
+ *   ...
+ *   ]}
+ * @endcode
+ * ts is micro seconds since #ZFMethodProfileEnable or #ZFMethodProfileReset,
+ * tid is a sequence id of thread which called the method\n
+ * \n
+ * recorded events are copied before written to output,
+ * so it's safe to be called while profiler is enabled,
+ * calls made by output itself would be recorded but not written
+ */
+extern ZF_ENV_EXPORT void ZFMethodProfileTraceOutput(ZF_IN const ZFOutput &output);
+
+// ============================================================
+/**
+ * @brief timestamp in micro seconds used by #ZFMethodProfileEnable,
+ *   see #ZFMethodProfileTimestampImplSet
+ */
+typedef zftimet (*ZFMethodProfileTimestampImpl)(void);
+/**
+ * @brief set timestamp impl for #ZFMethodProfileEnable,
+ *   by default, it would be set to #ZFTime::currentTimeValue
+ *
+ * if no impl available, only call count would be accounted
+ */
+extern ZF_ENV_EXPORT void ZFMethodProfileTimestampImplSet(ZF_IN ZFMethodProfileTimestampImpl impl);
+/** @brief see #ZFMethodProfileTimestampImplSet */
+extern ZF_ENV_EXPORT ZFMethodProfileTimestampImpl ZFMethodProfileTimestampImplGet(void);
+
+ZF_NAMESPACE_GLOBAL_END
+#endif // #ifndef _ZFI_ZFMethodProfile_h_
+
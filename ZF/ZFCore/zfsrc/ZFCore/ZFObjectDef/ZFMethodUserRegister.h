@@ -33,6 +33,7 @@ extern ZF_ENV_EXPORT void ZFMethodUserUnregister(ZF_IN const ZFMethod *method);
         , zfnull \
         , ZFCastReinterpret(ZFFuncAddrType, methodInvoker) \
         , _ZFP_ZFMETHOD_GENERIC_INVOKER_ADDR(GenericInvokerOwner) \
+        , _ZFP_ZFMETHOD_GENERIC_INVOKER_UNBOXED_ADDR(GenericInvokerOwner) \
         , _ZFP_ZFMethodTypeText(ZFMethodType_) \
         , ownerClass \
         , _ZFP_ZFMethod_initClassMemberType_privilege(PublicOrProtectedOrPrivate) \
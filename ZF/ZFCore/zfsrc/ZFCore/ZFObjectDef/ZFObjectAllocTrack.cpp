@@ -0,0 +1,218 @@
+#include "ZFObjectAllocTrack.h"
+#include "ZFObjectImpl.h"
+
+ZF_NAMESPACE_GLOBAL_BEGIN
+
+// ============================================================
+zfbool _ZFP_ZFObjectAllocTrackEnableFlag = zffalse;
+static ZFObjectAllocTrackTimestampImpl _ZFP_ZFObjectAllocTrackTimestamp = zfnull;
+static zftimet _ZFP_ZFObjectAllocTrackBeginTime = zftimetZero();
+
+static void _ZFP_ZFObjectAllocTrackPeakUpdate(ZF_IN_OUT _ZFP_ZFObjectAllocTrackData &data, ZF_IN zfint liveCount)
+{
+    do {
+        zfint peakCount = zfAtomicLoad(data.peakCount);
+        if(liveCount <= peakCount
+            || zfAtomicCompareAndSwap(data.peakCount, peakCount, liveCount))
+        {
+            break;
+        }
+    } while(zftrue);
+}
+
+void _ZFP_ZFObjectAllocTrackAlloc(ZF_IN const ZFClass *cls)
+{
+    _ZFP_ZFObjectAllocTrackData &data = cls->_ZFP_ZFClass_allocTrackData();
+    if(zfAtomicLoad(data.tracked) == 0)
+    {
+        zfAtomicStore(data.tracked, 1);
+    }
+    zfAtomicIncrease(data.allocCount);
+    _ZFP_ZFObjectAllocTrackPeakUpdate(data, zfAtomicIncrease(data.liveCount));
+}
+void _ZFP_ZFObjectAllocTrackDealloc(ZF_IN const ZFClass *cls)
+{
+    _ZFP_ZFObjectAllocTrackData &data = cls->_ZFP_ZFClass_allocTrackData();
+    zfAtomicIncrease(data.deallocCount);
+    zfAtomicDecrease(data.liveCount);
+}
+void _ZFP_ZFObjectAllocTrackCacheHit(ZF_IN ZFObject *obj)
+{
+    zfAtomicIncrease(obj->classData()->_ZFP_ZFClass_allocTrackData().cacheHitCount);
+}
+void _ZFP_ZFObjectAllocTrackCacheStore(ZF_IN ZFObject *obj)
+{
+    zfAtomicIncrease(obj->classData()->_ZFP_ZFClass_allocTrackData().cacheStoreCount);
+}
+
+// ============================================================
+void ZFObjectAllocTrackEnable(ZF_IN zfbool enable)
+{
+    zfCoreMutexLocker();
+    if(enable
+        && _ZFP_ZFObjectAllocTrackBeginTime == zftimetZero()
+        && _ZFP_ZFObjectAllocTrackTimestamp != zfnull)
+    {
+        _ZFP_ZFObjectAllocTrackBeginTime = _ZFP_ZFObjectAllocTrackTimestamp();
+    }
+    _ZFP_ZFObjectAllocTrackEnableFlag = enable;
+}
+zfbool ZFObjectAllocTrackEnabled(void)
+{
+    return _ZFP_ZFObjectAllocTrackEnableFlag;
+}
+void ZFObjectAllocTrackReset(void)
+{
+    zfCoreMutexLocker();
+    ZFCoreArrayPOD<const ZFClass *> allClass;
+    ZFClassGetAllT(allClass);
+    for(zfindex i = 0; i < allClass.count(); ++i)
+    {
+        _ZFP_ZFObjectAllocTrackData &data = allClass[i]->_ZFP_ZFClass_allocTrackData();
+        if(zfAtomicLoad(data.tracked) == 0)
+        {
+            continue;
+        }
+        zfAtomicStore(data.allocCount, 0);
+        zfAtomicStore(data.deallocCount, 0);
+        zfAtomicStore(data.cacheHitCount, 0);
+        zfAtomicStore(data.cacheStoreCount, 0);
+        zfAtomicStore(data.peakCount, zfAtomicLoad(data.liveCount));
+    }
+    _ZFP_ZFObjectAllocTrackBeginTime = (_ZFP_ZFObjectAllocTrackTimestamp != zfnull)
+        ? _ZFP_ZFObjectAllocTrackTimestamp()
+        : zftimetZero();
+}
+
+static void _ZFP_ZFObjectAllocTrackStateCopy(ZF_OUT ZFObjectAllocTrackState &ret,
+                                             ZF_IN const ZFClass *cls,
+                                             ZF_IN _ZFP_ZFObjectAllocTrackData &data,
+                                             ZF_IN zftimet duration)
+{
+    ret.cls = cls;
+    ret.allocCount = (zfindex)zfAtomicLoad(data.allocCount);
+    ret.deallocCount = (zfindex)zfAtomicLoad(data.deallocCount);
+    zfint liveCount = zfAtomicLoad(data.liveCount);
+    ret.liveCount = (liveCount > 0) ? (zfindex)liveCount : 0;
+    ret.peakCount = (zfindex)zfAtomicLoad(data.peakCount);
+    ret.cacheHitCount = (zfindex)zfAtomicLoad(data.cacheHitCount);
+    ret.cacheStoreCount = (zfindex)zfAtomicLoad(data.cacheStoreCount);
+    ret.objectSize = cls->_ZFP_objectSize();
+    ret.liveBytes = ret.liveCount * ret.objectSize;
+    ret.peakBytes = ret.peakCount * ret.objectSize;
+    ret.duration = duration;
+}
+static zftimet _ZFP_ZFObjectAllocTrackDuration(void)
+{
+    if(_ZFP_ZFObjectAllocTrackTimestamp == zfnull || _ZFP_ZFObjectAllocTrackBeginTime == zftimetZero())
+    {
+        return zftimetZero();
+    }
+    zftimet duration = _ZFP_ZFObjectAllocTrackTimestamp() - _ZFP_ZFObjectAllocTrackBeginTime;
+    return (duration > 0) ? duration : zftimetZero();
+}
+
+zfbool ZFObjectAllocTrackStateGet(ZF_OUT ZFObjectAllocTrackState &ret,
+                                  ZF_IN const ZFClass *cls)
+{
+    if(cls == zfnull)
+    {
+        return zffalse;
+    }
+    _ZFP_ZFObjectAllocTrackData &data = cls->_ZFP_ZFClass_allocTrackData();
+    if(zfAtomicLoad(data.tracked) == 0)
+    {
+        return zffalse;
+    }
+    _ZFP_ZFObjectAllocTrackStateCopy(ret, cls, data, _ZFP_ZFObjectAllocTrackDuration());
+    return zftrue;
+}
+
+static ZFCompareResult _ZFP_ZFObjectAllocTrackStateCompare(ZF_IN ZFObjectAllocTrackState const &e0,
+                                                          ZF_IN ZFObjectAllocTrackState const &e1)
+{
+    if(e0.liveBytes != e1.liveBytes)
+    {
+        return (e0.liveBytes > e1.liveBytes) ? ZFCompareSmaller : ZFCompareGreater;
+    }
+    if(e0.liveCount != e1.liveCount)
+    {
+        return (e0.liveCount > e1.liveCount) ? ZFCompareSmaller : ZFCompareGreater;
+    }
+    if(e0.allocCount != e1.allocCount)
+    {
+        return (e0.allocCount > e1.allocCount) ? ZFCompareSmaller : ZFCompareGreater;
+    }
+    zfint cmp = zfscmp(e0.cls->classNameFull(), e1.cls->classNameFull());
+    return (cmp < 0) ? ZFCompareSmaller : ((cmp > 0) ? ZFCompareGreater : ZFCompareTheSame);
+}
+void ZFObjectAllocTrackStateGetAllT(ZF_IN_OUT ZFCoreArray<ZFObjectAllocTrackState> &ret)
+{
+    zftimet duration = _ZFP_ZFObjectAllocTrackDuration();
+    ZFCoreArrayPOD<const ZFClass *> allClass;
+    ZFClassGetAllT(allClass);
+    zfindex start = ret.count();
+    for(zfindex i = 0; i < allClass.count(); ++i)
+    {
+        const ZFClass *cls = allClass[i];
+        _ZFP_ZFObjectAllocTrackData &data = cls->_ZFP_ZFClass_allocTrackData();
+        if(zfAtomicLoad(data.tracked) == 0)
+        {
+            continue;
+        }
+        ZFObjectAllocTrackState state;
+        _ZFP_ZFObjectAllocTrackStateCopy(state, cls, data, duration);
+        ret.add(state);
+    }
+    ret.sort(_ZFP_ZFObjectAllocTrackStateCompare, zftrue, start);
+}
+
+void ZFObjectAllocTrackPrint(ZF_IN const ZFOutput &output,
+                             ZF_IN_OPT zfindex maxCount /* = zfindexMax() */)
+{
+    if(!output.callbackIsValid())
+    {
+        return;
+    }
+    ZFCoreArrayPOD<ZFObjectAllocTrackState> states;
+    ZFObjectAllocTrackStateGetAllT(states);
+    zfstring s;
+    zfstringAppend(s, "[ZFObjectAllocTrack] %zi classes tracked, %s ms\n",
+        states.count(),
+        zfsFromInt(_ZFP_ZFObjectAllocTrackDuration()).cString());
+    zfstringAppend(s, "  %8s %8s %10s %8s %8s %8s %8s %10s  %s\n",
+        "live", "peak", "liveBytes", "alloc", "dealloc", "cacheHit", "cacheSet", "alloc/s", "class");
+    output.execute(s.cString(), s.length());
+    for(zfindex i = 0; i < states.count() && i < maxCount; ++i)
+    {
+        const ZFObjectAllocTrackState &state = states[i];
+        s.removeAll();
+        zfstringAppend(s, "  %8zi %8zi %10zi %8zi %8zi %8zi %8zi %10.2f  %s\n",
+            state.liveCount,
+            state.peakCount,
+            state.liveBytes,
+            state.allocCount,
+            state.deallocCount,
+            state.cacheHitCount,
+            state.cacheStoreCount,
+            state.allocRate(),
+            state.cls->classNameFull());
+        output.execute(s.cString(), s.length());
+    }
+}
+
+// ============================================================
+void ZFObjectAllocTrackTimestampImplSet(ZF_IN ZFObjectAllocTrackTimestampImpl impl)
+{
+    zfCoreMutexLocker();
+    _ZFP_ZFObjectAllocTrackTimestamp = impl;
+    _ZFP_ZFObjectAllocTrackBeginTime = (impl != zfnull && _ZFP_ZFObjectAllocTrackEnableFlag)
+        ? impl()
+        : zftimetZero();
+}
+ZFObjectAllocTrackTimestampImpl ZFObjectAllocTrackTimestampImplGet(void)
+{
+    return _ZFP_ZFObjectAllocTrackTimestamp;
+}
+
+ZF_NAMESPACE_GLOBAL_END
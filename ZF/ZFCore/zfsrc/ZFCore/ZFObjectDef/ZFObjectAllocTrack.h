@@ -0,0 +1,154 @@
+/**
+ * @file ZFObjectAllocTrack.h
+ * @brief per class allocation and lifetime accounting
+ */
+
+#ifndef _ZFI_ZFObjectAllocTrack_h_
+#define _ZFI_ZFObjectAllocTrack_h_
+
+#include "ZFObjectCore.h"
+#include "ZFIOCallback.h"
+
+ZF_NAMESPACE_GLOBAL_BEGIN
+
+// ============================================================
+/**
+ * @brief allocation state of a class, see #ZFObjectAllocTrackEnable
+ */
+zfclassPOD ZF_ENV_EXPORT ZFObjectAllocTrackState
+{
+public:
+    const ZFClass *cls; /**< @brief the class */
+    zfindex allocCount; /**< @brief object allocated since last #ZFObjectAllocTrackReset */
+    zfindex deallocCount; /**< @brief object deallocated since last #ZFObjectAllocTrackReset */
+    zfindex liveCount; /**< @brief tracked object currently alive (including those held by #zfAllocWithCache's cache) */
+    zfindex peakCount; /**< @brief max #liveCount since last #ZFObjectAllocTrackReset */
+    zfindex cacheHitCount; /**< @brief #zfAllocWithCache that reused cached object */
+    zfindex cacheStoreCount; /**< @brief #zfAllocWithCache's object that returned to cache instead of dealloc */
+    /**
+     * @brief size in bytes of each object of the class
+     *
+     * only the object itself is accounted,
+     * memory allocated by the object (private data, containers, etc) is not included
+     */
+    zfindex objectSize;
+    zfindex liveBytes; /**< @brief #liveCount * #objectSize */
+    zfindex peakBytes; /**< @brief #peakCount * #objectSize */
+    zftimet duration; /**< @brief time in mili seconds since last #ZFObjectAllocTrackReset, 0 if no #ZFObjectAllocTrackTimestampImplSet */
+
+public:
+    /**
+     * @brief allocation per second since last #ZFObjectAllocTrackReset,
+     *   cache hit would also be treated as allocation
+     */
+    zffloat allocRate(void) const
+    {
+        return (this->duration > 0)
+            ? (zffloat)(this->allocCount + this->cacheHitCount) * 1000 / (zffloat)this->duration
+            : (zffloat)0;
+    }
+};
+
+// ============================================================
+/**
+ * @brief enable or disable the per class allocation tracker, disabled by default
+ *
+ * when enabled, each #ZFObject allocated by #zfAlloc, #zfAllocWithCache or #ZFClass::newInstance
+ * would be accounted to its class, and the counters would be updated when the object deallocated,
+ * all counters are updated by atomic operations without any lock\n
+ * \n
+ * objects allocated before enable would not be tracked,
+ * objects allocated while enabled would always be accounted when deallocated even if disabled later,
+ * so #ZFObjectAllocTrackState::liveCount would always keep consistent\n
+ * \n
+ * typical usage:
+ * @code
+ *   ZFObjectAllocTrackEnable(zftrue);
+ *   yourHeavyFunc();
+ *   ZFObjectAllocTrackPrint(ZFOutputDefault());
+ *   ZFObjectAllocTrackEnable(zffalse);
+ * @endcode
+ */
+extern ZF_ENV_EXPORT void ZFObjectAllocTrackEnable(ZF_IN zfbool enable);
+/** @brief see #ZFObjectAllocTrackEnable */
+extern ZF_ENV_EXPORT zfbool ZFObjectAllocTrackEnabled(void);
+/**
+ * @brief reset all counters except #ZFObjectAllocTrackState::liveCount,
+ *   #ZFObjectAllocTrackState::peakCount would be reset to current live count
+ *
+ * reset while other thread allocating objects may lose some counts,
+ * which would only affect the statistic result
+ */
+extern ZF_ENV_EXPORT void ZFObjectAllocTrackReset(void);
+
+/**
+ * @brief get allocation state of class, return false if never tracked
+ */
+extern ZF_ENV_EXPORT zfbool ZFObjectAllocTrackStateGet(ZF_OUT ZFObjectAllocTrackState &ret,
+                                                       ZF_IN const ZFClass *cls);
+/**
+ * @brief get allocation state of all tracked classes,
+ *   sorted by #ZFObjectAllocTrackState::liveBytes, #ZFObjectAllocTrackState::liveCount
+ *   then #ZFObjectAllocTrackState::allocCount, descending
+ */
+extern ZF_ENV_EXPORT void ZFObjectAllocTrackStateGetAllT(ZF_IN_OUT ZFCoreArray<ZFObjectAllocTrackState> &ret);
+/** @brief see #ZFObjectAllocTrackStateGetAllT */
+inline ZFCoreArrayPOD<ZFObjectAllocTrackState> ZFObjectAllocTrackStateGetAll(void)
+{
+    ZFCoreArrayPOD<ZFObjectAllocTrackState> ret;
+    ZFObjectAllocTrackStateGetAllT(ret);
+    return ret;
+}
+
+/**
+ * @brief print allocation state of all tracked classes, see #ZFObjectAllocTrackStateGetAll
+ *
+ * maxCount can be used to print only the top N classes
+ */
+extern ZF_ENV_EXPORT void ZFObjectAllocTrackPrint(ZF_IN const ZFOutput &output,
+                                                  ZF_IN_OPT zfindex maxCount = zfindexMax());
+
+// ============================================================
+/**
+ * @brief timestamp in mili seconds used to calculate #ZFObjectAllocTrackState::allocRate,
+ *   see #ZFObjectAllocTrackTimestampImplSet
+ */
+typedef zftimet (*ZFObjectAllocTrackTimestampImpl)(void);
+/**
+ * @brief set timestamp impl for #ZFObjectAllocTrackState::duration,
+ *   by default, it would be set to #ZFTime::timestamp
+ */
+extern ZF_ENV_EXPORT void ZFObjectAllocTrackTimestampImplSet(ZF_IN ZFObjectAllocTrackTimestampImpl impl);
+/** @brief see #ZFObjectAllocTrackTimestampImplSet */
+extern ZF_ENV_EXPORT ZFObjectAllocTrackTimestampImpl ZFObjectAllocTrackTimestampImplGet(void);
+
+// ============================================================
+zfclassNotPOD ZF_ENV_EXPORT _ZFP_ZFObjectAllocTrackData
+{
+public:
+    zfatomicint allocCount;
+    zfatomicint deallocCount;
+    zfatomicint liveCount;
+    zfatomicint peakCount;
+    zfatomicint cacheHitCount;
+    zfatomicint cacheStoreCount;
+    zfatomicint tracked;
+public:
+    _ZFP_ZFObjectAllocTrackData(void)
+    : allocCount(0)
+    , deallocCount(0)
+    , liveCount(0)
+    , peakCount(0)
+    , cacheHitCount(0)
+    , cacheStoreCount(0)
+    , tracked(0)
+    {
+    }
+};
+
+extern ZF_ENV_EXPORT void _ZFP_ZFObjectAllocTrackAlloc(ZF_IN const ZFClass *cls);
+extern ZF_ENV_EXPORT void _ZFP_ZFObjectAllocTrackDealloc(ZF_IN const ZFClass *cls);
+
+ZF_NAMESPACE_GLOBAL_END
+#endif // #ifndef _ZFI_ZFObjectAllocTrack_h_
+
@@ -209,6 +209,11 @@ extern ZF_ENV_EXPORT void _ZFP_ZFClassDataChangeNotify(ZF_IN ZFClassDataChangeTy
                                                        ZF_IN const ZFClass *changedClass,
                                                        ZF_IN const ZFProperty *changedProperty,
                                                        ZF_IN const ZFMethod *changedMethod);
+/*
+ * increased each time class data changed,
+ * used to invalidate caches of resolved class, method or property
+ */
+extern ZF_ENV_EXPORT zfint _ZFP_ZFClassDataChangeVersion(void);
 
 ZF_NAMESPACE_GLOBAL_END
 
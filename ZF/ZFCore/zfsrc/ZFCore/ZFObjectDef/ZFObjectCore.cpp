@@ -2,43 +2,153 @@
 #include "ZFObjectImpl.h"
 #include "zfsynchronize.h"
 #include "ZFDynamicInvoker.h"
+#include "ZFObjectAllocTrack.h"
 
-#include "ZFCore/ZFSTLWrapper/zfstl_string.h"
-#include "ZFCore/ZFSTLWrapper/zfstl_map.h"
 #include "ZFCore/ZFSTLWrapper/zfstl_vector.h"
 
 ZF_NAMESPACE_GLOBAL_BEGIN
 
 // ============================================================
 // _ZFP_ZFObjectPrivate
-typedef zfstlmap<zfstlstringZ, zfautoObject> _ZFP_ZFObjectTagMapType;
-zfclassNotPOD _ZFP_ZFObjectPrivate
+// most object never have tags, and have only one or two tags when have,
+// so the first few tags are stored inline without extra allocation
+#define _ZFP_ZFObjectTagInlineCount 2
+zfclassNotPOD _ZFP_ZFObjectTagItem
+{
+public:
+    zfstring key;
+    zfautoObject value;
+};
+zfclassNotPOD _ZFP_ZFObjectTagList
+{
+public:
+    _ZFP_ZFObjectTagItem inlineItem[_ZFP_ZFObjectTagInlineCount];
+    zfindex inlineCount;
+    zfstlvector<_ZFP_ZFObjectTagItem> moreItem;
+
+public:
+    _ZFP_ZFObjectTagList(void)
+    : inlineCount(0)
+    , moreItem()
+    {
+    }
+
+public:
+    inline zfindex count(void) const
+    {
+        return this->inlineCount + (zfindex)this->moreItem.size();
+    }
+    inline _ZFP_ZFObjectTagItem &itemAt(ZF_IN zfindex index)
+    {
+        return ((index < this->inlineCount)
+            ? this->inlineItem[index]
+            : this->moreItem[index - this->inlineCount]);
+    }
+    zfindex find(ZF_IN const zfchar *key)
+    {
+        for(zfindex i = 0; i < this->inlineCount; ++i)
+        {
+            if(zfscmpTheSame(this->inlineItem[i].key.cString(), key))
+            {
+                return i;
+            }
+        }
+        for(zfstlsize i = 0; i < this->moreItem.size(); ++i)
+        {
+            if(zfscmpTheSame(this->moreItem[i].key.cString(), key))
+            {
+                return this->inlineCount + (zfindex)i;
+            }
+        }
+        return zfindexMax();
+    }
+    _ZFP_ZFObjectTagItem &add(ZF_IN const zfchar *key)
+    {
+        if(this->inlineCount < _ZFP_ZFObjectTagInlineCount)
+        {
+            _ZFP_ZFObjectTagItem &item = this->inlineItem[this->inlineCount++];
+            item.key = key;
+            return item;
+        }
+        else
+        {
+            this->moreItem.push_back(_ZFP_ZFObjectTagItem());
+            _ZFP_ZFObjectTagItem &item = this->moreItem.back();
+            item.key = key;
+            return item;
+        }
+    }
+    /*
+     * remove by moving the last item to the removed position,
+     * return the removed value which has been retained,
+     * caller must release it after the list is in stable state
+     */
+    ZFObject *remove(ZF_IN zfindex index)
+    {
+        zfindex last = this->count() - 1;
+        _ZFP_ZFObjectTagItem &item = this->itemAt(index);
+        ZFObject *ret = zflockfree_zfRetain(item.value.toObject());
+        if(index != last)
+        {
+            _ZFP_ZFObjectTagItem &lastItem = this->itemAt(last);
+            item.key = lastItem.key;
+            item.value.zflockfree_assign(lastItem.value);
+        }
+        if(this->moreItem.empty())
+        {
+            _ZFP_ZFObjectTagItem &lastItem = this->inlineItem[--(this->inlineCount)];
+            lastItem.key.removeAll();
+            lastItem.value.zflockfree_assign(zfnull);
+        }
+        else
+        {
+            this->moreItem.pop_back();
+        }
+        return ret;
+    }
+};
+
+// rarely used state, allocated on first access
+zfclassNotPOD _ZFP_ZFObjectPrivateExt
 {
 public:
-    zfuint objectRetainCount;
-    ZFObjectInstanceState objectInstanceState;
     ZFObjectHolder *objectHolder;
     void *mutexImpl;
-    _ZFP_ZFObjectTagMapType objectTagMap;
+    _ZFP_ZFObjectTagList tagList;
     zfstlvector<const ZFProperty *> propertyAccessed;
+
+public:
+    _ZFP_ZFObjectPrivateExt(void)
+    : objectHolder(zfnull)
+    , mutexImpl(zfnull)
+    , tagList()
+    , propertyAccessed()
+    {
+    }
+};
+
+zfclassNotPOD _ZFP_ZFObjectPrivate
+{
+public:
+    zfatomicint objectRetainCount;
+    ZFObjectInstanceState objectInstanceState;
     enum {
         stateFlag_objectIsPrivate = 1 << 0,
         stateFlag_objectIsInternal = 1 << 1,
         stateFlag_observerHasAddFlag_objectAfterAlloc = 1 << 2,
         stateFlag_observerHasAddFlag_objectBeforeDealloc = 1 << 3,
         stateFlag_observerHasAddFlag_objectPropertyValueOnUpdate = 1 << 4,
+        stateFlag_allocTracked = 1 << 5,
     };
-    zfuint stateFlags;
+    zfatomicint stateFlags; // may be updated by observerOnAdd/observerOnRemove from any thread
+    _ZFP_ZFObjectPrivateExt *ext; // null until first access by extAccess
 
 public:
     _ZFP_ZFObjectPrivate(ZF_IN const ZFClass *cls)
     : objectRetainCount(1)
     , objectInstanceState(ZFObjectInstanceStateOnInit)
-    , objectHolder(zfnull)
-    , mutexImpl(zfnull)
-    , objectTagMap()
-    , propertyAccessed()
     , stateFlags(0)
+    , ext(zfnull)
     {
         if(cls->classIsPrivate())
         {
@@ -49,6 +159,41 @@ public:
             ZFBitSet(this->stateFlags, _ZFP_ZFObjectPrivate::stateFlag_objectIsInternal);
         }
     }
+    ~_ZFP_ZFObjectPrivate(void)
+    {
+        if(this->ext != zfnull)
+        {
+            zfpoolDelete(this->ext);
+        }
+    }
+
+public:
+    void stateFlagSet(ZF_IN zfint flag)
+    {
+        zfAtomicBitSet(this->stateFlags, flag);
+    }
+    void stateFlagUnset(ZF_IN zfint flag)
+    {
+        zfAtomicBitUnset(this->stateFlags, flag);
+    }
+    zfbool stateFlagTest(ZF_IN zfint flag)
+    {
+        return ZFBitTest(zfAtomicLoad(this->stateFlags), flag);
+    }
+
+public:
+    _ZFP_ZFObjectPrivateExt *extAccess(void)
+    {
+        if(this->ext == zfnull)
+        {
+            zfCoreMutexLocker();
+            if(this->ext == zfnull)
+            {
+                this->ext = zfpoolNew(_ZFP_ZFObjectPrivateExt);
+            }
+        }
+        return this->ext;
+    }
 };
 
 // ============================================================
@@ -76,21 +221,22 @@ ZF_GLOBAL_INITIALIZER_END(ZFObject_stateFlags)
 
 zfindex ZFObject::objectRetainCount(void)
 {
-    return (zfindex)d->objectRetainCount;
+    return (zfindex)zfAtomicLoad(d->objectRetainCount);
 }
 
 ZFObjectHolder *ZFObject::objectHolder(void)
 {
-    if(d->objectHolder == zfnull)
+    _ZFP_ZFObjectPrivateExt *ext = d->extAccess();
+    if(ext->objectHolder == zfnull)
     {
         zfCoreMutexLocker();
-        if(d->objectHolder == zfnull)
+        if(ext->objectHolder == zfnull)
         {
-            d->objectHolder = zflockfree_zfAllocWithCache(ZFObjectHolder);
-            d->objectHolder->objectHolded(this);
+            ext->objectHolder = zflockfree_zfAllocWithCache(ZFObjectHolder);
+            ext->objectHolder->objectHolded(this);
         }
     }
-    return d->objectHolder;
+    return ext->objectHolder;
 }
 ZFAny ZFObject::objectHolded(void)
 {
@@ -137,7 +283,6 @@ zfautoObject ZFObject::invoke(ZF_IN const zfchar *methodName
                               , ZF_OUT_OPT zfstring *errorHint /* = zfnull */
                               )
 {
-    zfCoreMutexLock();
     zfautoObject paramList[ZFMETHOD_MAX_PARAM];
     paramList[0].zflockfree_assign(param0);
     paramList[1].zflockfree_assign(param1);
@@ -147,17 +292,13 @@ zfautoObject ZFObject::invoke(ZF_IN const zfchar *methodName
     paramList[5].zflockfree_assign(param5);
     paramList[6].zflockfree_assign(param6);
     paramList[7].zflockfree_assign(param7);
-    zflockfree_zfblockedAllocWithCache(v_zfstring, methodNameHolder);
-    methodNameHolder->zfv = methodName;
-    zfCoreMutexUnlock();
 
     zfautoObject ret;
-    if(ZFDI_invoke(
+    if(_ZFP_ZFDI_invokeByName(
         ret
         , errorHint
         , this
-        , zfnull
-        , methodNameHolder
+        , methodName
         , zfindexMax()
         , paramList
     )) {
@@ -183,30 +324,25 @@ zfautoObject ZFObject::invoke(ZF_IN const zfchar *methodName
                               , ZF_OUT_OPT zfstring *errorHint /* = zfnull */
                               )
 {
-    zfCoreMutexLock();
     zfautoObject paramList[ZFMETHOD_MAX_PARAM];
     zfindex paramCount = 0;
     do {
-        if(param0 == zfnull) {paramCount = 0; break;} else {paramList[0] = zflockfree_zflineAlloc(ZFDI_Wrapper, param0);}
-        if(param1 == zfnull) {paramCount = 1; break;} else {paramList[1] = zflockfree_zflineAlloc(ZFDI_Wrapper, param1);}
-        if(param2 == zfnull) {paramCount = 2; break;} else {paramList[2] = zflockfree_zflineAlloc(ZFDI_Wrapper, param2);}
-        if(param3 == zfnull) {paramCount = 3; break;} else {paramList[3] = zflockfree_zflineAlloc(ZFDI_Wrapper, param3);}
-        if(param4 == zfnull) {paramCount = 4; break;} else {paramList[4] = zflockfree_zflineAlloc(ZFDI_Wrapper, param4);}
-        if(param5 == zfnull) {paramCount = 5; break;} else {paramList[5] = zflockfree_zflineAlloc(ZFDI_Wrapper, param5);}
-        if(param6 == zfnull) {paramCount = 6; break;} else {paramList[6] = zflockfree_zflineAlloc(ZFDI_Wrapper, param6);}
-        if(param7 == zfnull) {paramCount = 7; break;} else {paramList[7] = zflockfree_zflineAlloc(ZFDI_Wrapper, param7);}
+        if(param0 == zfnull) {paramCount = 0; break;} else {paramList[0] = zflineAlloc(ZFDI_Wrapper, param0);}
+        if(param1 == zfnull) {paramCount = 1; break;} else {paramList[1] = zflineAlloc(ZFDI_Wrapper, param1);}
+        if(param2 == zfnull) {paramCount = 2; break;} else {paramList[2] = zflineAlloc(ZFDI_Wrapper, param2);}
+        if(param3 == zfnull) {paramCount = 3; break;} else {paramList[3] = zflineAlloc(ZFDI_Wrapper, param3);}
+        if(param4 == zfnull) {paramCount = 4; break;} else {paramList[4] = zflineAlloc(ZFDI_Wrapper, param4);}
+        if(param5 == zfnull) {paramCount = 5; break;} else {paramList[5] = zflineAlloc(ZFDI_Wrapper, param5);}
+        if(param6 == zfnull) {paramCount = 6; break;} else {paramList[6] = zflineAlloc(ZFDI_Wrapper, param6);}
+        if(param7 == zfnull) {paramCount = 7; break;} else {paramList[7] = zflineAlloc(ZFDI_Wrapper, param7);}
     } while(zffalse);
-    zflockfree_zfblockedAllocWithCache(v_zfstring, methodNameHolder);
-    methodNameHolder->zfv = methodName;
-    zfCoreMutexUnlock();
 
     zfautoObject ret;
-    if(ZFDI_invoke(
+    if(_ZFP_ZFDI_invokeByName(
         ret
         , errorHint
         , this
-        , zfnull
-        , methodNameHolder
+        , methodName
         , paramCount
         , paramList
     )) {
@@ -222,7 +358,7 @@ zfautoObject ZFObject::invoke(ZF_IN const zfchar *methodName
 
 zfbool ZFObject::objectTagExist(void)
 {
-    return !(d->objectTagMap.empty());
+    return (d->ext != zfnull && d->ext->tagList.count() > 0);
 }
 void ZFObject::objectTag(ZF_IN const zfchar *key,
                          ZF_IN ZFObject *tag)
@@ -235,43 +371,45 @@ void ZFObject::objectTag(ZF_IN const zfchar *key,
             key);
         return ;
     }
-    if(key == zfnull)
+    if(key == zfnull || (tag == zfnull && d->ext == zfnull))
     {
         return ;
     }
 
-    _ZFP_ZFObjectTagMapType &m = d->objectTagMap;
-    _ZFP_ZFObjectTagMapType::iterator it = m.find(key);
-    if(it == m.end())
+    _ZFP_ZFObjectTagList &m = d->extAccess()->tagList;
+    zfindex index = m.find(key);
+    if(index == zfindexMax())
     {
         if(tag != zfnull)
         {
-            m[key].zflockfree_assign(tag);
+            m.add(key).value.zflockfree_assign(tag);
         }
     }
     else
     {
-        ZFObject *obj = zflockfree_zfRetain(it->second);
         if(tag == zfnull)
         {
-            m.erase(it);
+            zflockfree_zfRelease(m.remove(index));
         }
         else
         {
-            it->second.zflockfree_assign(tag);
+            _ZFP_ZFObjectTagItem &item = m.itemAt(index);
+            ZFObject *obj = zflockfree_zfRetain(item.value.toObject());
+            item.value.zflockfree_assign(tag);
+            zflockfree_zfRelease(obj);
         }
-        zflockfree_zfRelease(obj);
     }
 }
 ZFObject *ZFObject::objectTag(ZF_IN const zfchar *key)
 {
-    if(key != zfnull)
+    if(key != zfnull && d->ext != zfnull)
     {
         zfCoreMutexLocker();
-        _ZFP_ZFObjectTagMapType::iterator it = d->objectTagMap.find(key);
-        if(it != d->objectTagMap.end())
+        _ZFP_ZFObjectTagList &m = d->ext->tagList;
+        zfindex index = m.find(key);
+        if(index != zfindexMax())
         {
-            return it->second.toObject();
+            return m.itemAt(index).value.toObject();
         }
     }
     return zfnull;
@@ -279,27 +417,35 @@ ZFObject *ZFObject::objectTag(ZF_IN const zfchar *key)
 void ZFObject::objectTagGetAllKeyValue(ZF_IN_OUT ZFCoreArray<const zfchar *> &allKey,
                                        ZF_IN_OUT ZFCoreArray<ZFObject *> &allValue)
 {
+    if(d->ext == zfnull)
+    {
+        return ;
+    }
     zfCoreMutexLocker();
-    _ZFP_ZFObjectTagMapType &m = d->objectTagMap;
-    allKey.capacity(allKey.count() + m.size());
-    allValue.capacity(allValue.count() + m.size());
-    for(_ZFP_ZFObjectTagMapType::iterator it = m.begin(); it != m.end(); ++it)
+    _ZFP_ZFObjectTagList &m = d->ext->tagList;
+    zfindex count = m.count();
+    allKey.capacity(allKey.count() + count);
+    allValue.capacity(allValue.count() + count);
+    for(zfindex i = 0; i < count; ++i)
     {
-        allKey.add(it->first.c_str());
-        allValue.add(it->second.toObject());
+        _ZFP_ZFObjectTagItem &item = m.itemAt(i);
+        allKey.add(item.key.cString());
+        allValue.add(item.value.toObject());
     }
 }
 zfautoObject ZFObject::objectTagRemoveAndGet(ZF_IN const zfchar *key)
 {
-    if(key != zfnull)
+    if(key != zfnull && d->ext != zfnull)
     {
         zfCoreMutexLocker();
-        _ZFP_ZFObjectTagMapType::iterator it = d->objectTagMap.find(key);
-        if(it != d->objectTagMap.end())
+        _ZFP_ZFObjectTagList &m = d->ext->tagList;
+        zfindex index = m.find(key);
+        if(index != zfindexMax())
         {
+            ZFObject *obj = m.remove(index);
             zfautoObject ret;
-            ret.zflockfree_assign(it->second);
-            d->objectTagMap.erase(it);
+            ret.zflockfree_assign(obj);
+            zflockfree_zfRelease(obj);
             return ret;
         }
     }
@@ -307,11 +453,14 @@ zfautoObject ZFObject::objectTagRemoveAndGet(ZF_IN const zfchar *key)
 }
 void ZFObject::objectTagRemoveAll(void)
 {
-    if(!d->objectTagMap.empty())
+    if(d->ext != zfnull && d->ext->tagList.count() > 0)
     {
         zfCoreMutexLocker();
-        _ZFP_ZFObjectTagMapType tmp;
-        tmp.swap(d->objectTagMap);
+        _ZFP_ZFObjectTagList &m = d->ext->tagList;
+        while(m.count() > 0)
+        {
+            zflockfree_zfRelease(m.remove(m.count() - 1));
+        }
     }
 }
 
@@ -323,86 +472,100 @@ void ZFObject::observerOnAdd(ZF_IN zfidentity eventId)
     }
     else if(eventId == ZFObject::EventObjectAfterAlloc())
     {
-        ZFBitSet(d->stateFlags, _ZFP_ZFObjectPrivate::stateFlag_observerHasAddFlag_objectAfterAlloc);
+        d->stateFlagSet(_ZFP_ZFObjectPrivate::stateFlag_observerHasAddFlag_objectAfterAlloc);
     }
     else if(eventId == ZFObject::EventObjectBeforeDealloc())
     {
-        ZFBitSet(d->stateFlags, _ZFP_ZFObjectPrivate::stateFlag_observerHasAddFlag_objectBeforeDealloc);
+        d->stateFlagSet(_ZFP_ZFObjectPrivate::stateFlag_observerHasAddFlag_objectBeforeDealloc);
     }
     else if(eventId == ZFObject::EventObjectPropertyValueOnUpdate())
     {
-        ZFBitSet(d->stateFlags, _ZFP_ZFObjectPrivate::stateFlag_observerHasAddFlag_objectPropertyValueOnUpdate);
+        d->stateFlagSet(_ZFP_ZFObjectPrivate::stateFlag_observerHasAddFlag_objectPropertyValueOnUpdate);
     }
 }
 void ZFObject::observerOnRemove(ZF_IN zfidentity eventId)
 {
+    zfint flag = 0;
     if(zffalse)
     {
     }
     else if(eventId == ZFObject::EventObjectAfterAlloc())
     {
-        ZFBitUnset(d->stateFlags, _ZFP_ZFObjectPrivate::stateFlag_observerHasAddFlag_objectAfterAlloc);
+        flag = _ZFP_ZFObjectPrivate::stateFlag_observerHasAddFlag_objectAfterAlloc;
     }
     else if(eventId == ZFObject::EventObjectBeforeDealloc())
     {
-        ZFBitUnset(d->stateFlags, _ZFP_ZFObjectPrivate::stateFlag_observerHasAddFlag_objectBeforeDealloc);
+        flag = _ZFP_ZFObjectPrivate::stateFlag_observerHasAddFlag_objectBeforeDealloc;
     }
     else if(eventId == ZFObject::EventObjectPropertyValueOnUpdate())
     {
-        ZFBitUnset(d->stateFlags, _ZFP_ZFObjectPrivate::stateFlag_observerHasAddFlag_objectPropertyValueOnUpdate);
+        flag = _ZFP_ZFObjectPrivate::stateFlag_observerHasAddFlag_objectPropertyValueOnUpdate;
+    }
+    if(flag != 0)
+    {
+        // observerOnAdd/observerOnRemove are called outside of observer holder's lock,
+        // another thread may have added the same event after our removal and set the flag before we unset it,
+        // check again after unset, the flag would be set by either of us
+        d->stateFlagUnset(flag);
+        if(this->observerHolder().observerHasAdd(eventId))
+        {
+            d->stateFlagSet(flag);
+        }
     }
 }
 
 void ZFObject::_ZFP_ZFObjectLock(void)
 {
-    if(d->mutexImpl)
+    _ZFP_ZFObjectPrivateExt *ext = d->extAccess();
+    if(ext->mutexImpl)
     {
-        _ZFP_ZFObjectMutexImplLock(d->mutexImpl);
+        _ZFP_ZFObjectMutexImplLock(ext->mutexImpl);
     }
     else
     {
         zfCoreMutexLock();
         if(_ZFP_ZFObjectMutexImplInit)
         {
-            if(d->mutexImpl == zfnull)
+            if(ext->mutexImpl == zfnull)
             {
-                d->mutexImpl = _ZFP_ZFObjectMutexImplInit();
+                ext->mutexImpl = _ZFP_ZFObjectMutexImplInit();
             }
         }
         zfCoreMutexUnlock();
-        if(d->mutexImpl)
+        if(ext->mutexImpl)
         {
-            _ZFP_ZFObjectMutexImplLock(d->mutexImpl);
+            _ZFP_ZFObjectMutexImplLock(ext->mutexImpl);
         }
     }
 }
 void ZFObject::_ZFP_ZFObjectUnlock(void)
 {
-    if(d->mutexImpl)
+    if(d->ext != zfnull && d->ext->mutexImpl)
     {
-        _ZFP_ZFObjectMutexImplUnlock(d->mutexImpl);
+        _ZFP_ZFObjectMutexImplUnlock(d->ext->mutexImpl);
     }
 }
 zfbool ZFObject::_ZFP_ZFObjectTryLock(void)
 {
-    if(d->mutexImpl)
+    _ZFP_ZFObjectPrivateExt *ext = d->extAccess();
+    if(ext->mutexImpl)
     {
-        return _ZFP_ZFObjectMutexImplTryLock(d->mutexImpl);
+        return _ZFP_ZFObjectMutexImplTryLock(ext->mutexImpl);
     }
     else
     {
         zfCoreMutexLock();
         if(_ZFP_ZFObjectMutexImplInit)
         {
-            if(d->mutexImpl == zfnull)
+            if(ext->mutexImpl == zfnull)
             {
-                d->mutexImpl = _ZFP_ZFObjectMutexImplInit();
+                ext->mutexImpl = _ZFP_ZFObjectMutexImplInit();
             }
         }
         zfCoreMutexUnlock();
-        if(d->mutexImpl)
+        if(ext->mutexImpl)
         {
-            return _ZFP_ZFObjectMutexImplTryLock(d->mutexImpl);
+            return _ZFP_ZFObjectMutexImplTryLock(ext->mutexImpl);
         }
         else
         {
@@ -425,10 +588,16 @@ ZFObject *ZFObject::_ZFP_ZFObjectCheckOnInit(void)
     this->objectOnInitFinish();
     d->objectInstanceState = ZFObjectInstanceStateIdle;
 
+    if(_ZFP_ZFObjectAllocTrackEnableFlag)
+    {
+        d->stateFlagSet(_ZFP_ZFObjectPrivate::stateFlag_allocTracked);
+        _ZFP_ZFObjectAllocTrackAlloc(this->classData());
+    }
+
     if(!this->objectIsInternal())
     {
         this->classData()->_ZFP_ZFClass_instanceObserverNotify(this);
-        if(ZFBitTest(d->stateFlags, _ZFP_ZFObjectPrivate::stateFlag_observerHasAddFlag_objectAfterAlloc)
+        if(d->stateFlagTest(_ZFP_ZFObjectPrivate::stateFlag_observerHasAddFlag_objectAfterAlloc)
             || ZFBitTest(_ZFP_ZFObject_stateFlags, _ZFP_ZFObjectPrivate::stateFlag_observerHasAddFlag_objectAfterAlloc))
         {
             this->observerNotify(ZFObject::EventObjectAfterAlloc());
@@ -437,36 +606,69 @@ ZFObject *ZFObject::_ZFP_ZFObjectCheckOnInit(void)
 
     return this;
 }
+/*
+ * retain and release order:
+ * -  objectOnRetain is called after the retain count increased,
+ *   objectOnRelease is called before the retain count decreased,
+ *   so the object is always alive when the hooks called
+ * -  retain and non-last release never lock,
+ *   the hooks may run concurrently in different threads,
+ *   and objectRetainCount may already be changed by other threads when hooks called
+ * -  only the last release (and the one held by zfAllocWithCache) locks zfCoreMutex,
+ *   and is the only place to notify EventObjectBeforeDealloc and to dealloc
+ */
 void ZFObject::_ZFP_ZFObjectCheckRelease(void)
 {
-    if(ZFBitTest(d->stateFlags, _ZFP_ZFObjectPrivate::stateFlag_observerHasAddFlag_objectBeforeDealloc)
+    // called while the reference is still held,
+    // the object may be deallocated by other threads right after the decrease
+    this->objectOnRelease();
+
+    // fast path, lock free if not the last reference
+    // last reference (or the reference held by zfAllocWithCache) goes to the slow path
+    zfint retainCountMin = (this->_ZFP_ZFObject_zfAllocCacheRelease ? 2 : 1);
+    do {
+        zfint retainCount = zfAtomicLoad(d->objectRetainCount);
+        if(retainCount <= retainCountMin)
+        {
+            break;
+        }
+        if(zfAtomicCompareAndSwap(d->objectRetainCount, retainCount, retainCount - 1))
+        {
+            return ;
+        }
+    } while(zftrue);
+
+    zfCoreMutexLocker();
+    if(d->stateFlagTest(_ZFP_ZFObjectPrivate::stateFlag_observerHasAddFlag_objectBeforeDealloc)
         || ZFBitTest(_ZFP_ZFObject_stateFlags, _ZFP_ZFObjectPrivate::stateFlag_observerHasAddFlag_objectBeforeDealloc))
     {
-        if(d->objectRetainCount == 1)
+        if(zfAtomicLoad(d->objectRetainCount) == 1)
         {
             this->observerNotify(ZFObject::EventObjectBeforeDealloc());
-            if(d->objectRetainCount > 1)
+            if(zfAtomicLoad(d->objectRetainCount) > 1)
             {
-                this->objectOnRelease();
+                zfAtomicDecrease(d->objectRetainCount);
                 this->observerRemoveAll(ZFObject::EventObjectBeforeDealloc());
                 return ;
             }
         }
     }
 
-    this->objectOnRelease();
-    if(d->objectRetainCount > 0)
+    zfint retainCount = zfAtomicDecrease(d->objectRetainCount);
+    if(retainCount > 0)
     {
         // check to save cache
-        if(this->_ZFP_ZFObject_zfAllocCacheRelease && d->objectRetainCount == 1)
+        if(this->_ZFP_ZFObject_zfAllocCacheRelease && retainCount == 1)
         {
-            if(ZFBitTest(d->stateFlags, _ZFP_ZFObjectPrivate::stateFlag_observerHasAddFlag_objectBeforeDealloc)
+            if(d->stateFlagTest(_ZFP_ZFObjectPrivate::stateFlag_observerHasAddFlag_objectBeforeDealloc)
                 || ZFBitTest(_ZFP_ZFObject_stateFlags, _ZFP_ZFObjectPrivate::stateFlag_observerHasAddFlag_objectBeforeDealloc))
             {
                 this->observerNotify(ZFObject::EventObjectBeforeDealloc());
-                if(d->objectRetainCount > 1)
+                if(zfAtomicLoad(d->objectRetainCount) > 1)
                 {
+                    // release the reference held by zfAllocWithCache
                     this->objectOnRelease();
+                    zfAtomicDecrease(d->objectRetainCount);
                     this->observerRemoveAll(ZFObject::EventObjectBeforeDealloc());
                     return ;
                 }
@@ -477,13 +679,21 @@ void ZFObject::_ZFP_ZFObjectCheckRelease(void)
         return ;
     }
 
+    if(d->stateFlagTest(_ZFP_ZFObjectPrivate::stateFlag_allocTracked))
+    {
+        _ZFP_ZFObjectAllocTrackDealloc(this->classData());
+    }
     d->objectInstanceState = ZFObjectInstanceStateOnDeallocPrepare;
     this->objectOnDeallocPrepare();
     this->_ZFP_ObjI_onDeallocIvk();
-    for(zfstlsize i = d->propertyAccessed.size() - 1; i != (zfstlsize)-1; --i)
+    if(d->ext != zfnull)
     {
-        const ZFProperty *property = d->propertyAccessed[i];
-        property->_ZFP_ZFProperty_callbackDealloc(property, this);
+        zfstlvector<const ZFProperty *> &propertyAccessed = d->ext->propertyAccessed;
+        for(zfstlsize i = propertyAccessed.size() - 1; i != (zfstlsize)-1; --i)
+        {
+            const ZFProperty *property = propertyAccessed[i];
+            property->_ZFP_ZFProperty_callbackDealloc(property, this);
+        }
     }
     d->objectInstanceState = ZFObjectInstanceStateOnDealloc;
     this->objectOnDealloc();
@@ -520,16 +730,19 @@ void ZFObject::objectOnDealloc(void)
         this->_ZFP_ZFObject_classData->_ZFP_classDynamicRegisterObjectInstanceDetach(this);
     }
 
-    if(d->mutexImpl)
+    if(d->ext != zfnull)
     {
-        _ZFP_ZFObjectMutexImplDealloc(d->mutexImpl);
-        d->mutexImpl = zfnull;
-    }
+        if(d->ext->mutexImpl)
+        {
+            _ZFP_ZFObjectMutexImplDealloc(d->ext->mutexImpl);
+            d->ext->mutexImpl = zfnull;
+        }
 
-    if(d->objectHolder)
-    {
-        d->objectHolder->objectHolded(zfnull);
-        zfRelease(d->objectHolder);
+        if(d->ext->objectHolder)
+        {
+            d->ext->objectHolder->objectHolded(zfnull);
+            zfRelease(d->ext->objectHolder);
+        }
     }
 
     zfpoolDelete(d);
@@ -544,15 +757,18 @@ void ZFObject::objectOnDeallocPrepare(void)
     this->objectTagRemoveAll();
     this->observerRemoveAll();
 }
-void ZFObject::objectOnRetain(void)
+void ZFObject::_ZFP_ZFObjectCheckRetain(void)
 {
-    zfCoreAssertWithMessageTrim(d->objectRetainCount > 0,
+    zfint retainCount = zfAtomicIncrease(d->objectRetainCount);
+    zfCoreAssertWithMessageTrim(retainCount > 1,
         "[ZFObject] retain an object while deallocating: %s", this->objectInfoOfInstance().cString());
-    ++(d->objectRetainCount);
+    this->objectOnRetain();
+}
+void ZFObject::objectOnRetain(void)
+{
 }
 void ZFObject::objectOnRelease(void)
 {
-    --(d->objectRetainCount);
 }
 
 ZFObjectInstanceState ZFObject::objectInstanceState(void)
@@ -562,25 +778,30 @@ ZFObjectInstanceState ZFObject::objectInstanceState(void)
 
 zfbool ZFObject::objectIsPrivate(void)
 {
-    return ZFBitTest(d->stateFlags, _ZFP_ZFObjectPrivate::stateFlag_objectIsPrivate)
-        || ZFBitTest(d->stateFlags, _ZFP_ZFObjectPrivate::stateFlag_objectIsInternal);
+    return d->stateFlagTest(_ZFP_ZFObjectPrivate::stateFlag_objectIsPrivate)
+        || d->stateFlagTest(_ZFP_ZFObjectPrivate::stateFlag_objectIsInternal);
 }
 zfbool ZFObject::objectIsInternal(void)
 {
-    return ZFBitTest(d->stateFlags, _ZFP_ZFObjectPrivate::stateFlag_objectIsInternal);
+    return d->stateFlagTest(_ZFP_ZFObjectPrivate::stateFlag_objectIsInternal);
 }
 
 void ZFObject::_ZFP_ZFObject_objectPropertyValueAttach(ZF_IN const ZFProperty *property)
 {
-    d->propertyAccessed.push_back(property);
+    d->extAccess()->propertyAccessed.push_back(property);
 }
 void ZFObject::_ZFP_ZFObject_objectPropertyValueDetach(ZF_IN const ZFProperty *property)
 {
-    for(zfstlsize i = d->propertyAccessed.size() - 1; i != (zfstlsize)-1; --i)
+    if(d->ext == zfnull)
+    {
+        return ;
+    }
+    zfstlvector<const ZFProperty *> &propertyAccessed = d->ext->propertyAccessed;
+    for(zfstlsize i = propertyAccessed.size() - 1; i != (zfstlsize)-1; --i)
     {
-        if(d->propertyAccessed[i] == property)
+        if(propertyAccessed[i] == property)
         {
-            d->propertyAccessed.erase(d->propertyAccessed.begin() + i);
+            propertyAccessed.erase(propertyAccessed.begin() + i);
         }
     }
 }
@@ -588,7 +809,7 @@ void ZFObject::_ZFP_ZFObject_objectPropertyValueDetach(ZF_IN const ZFProperty *p
 void ZFObject::objectPropertyValueOnUpdate(ZF_IN const ZFProperty *property, ZF_IN const void *oldValue)
 {
     if(!this->objectIsInternal()
-        && (ZFBitTest(d->stateFlags, _ZFP_ZFObjectPrivate::stateFlag_observerHasAddFlag_objectPropertyValueOnUpdate)
+        && (d->stateFlagTest(_ZFP_ZFObjectPrivate::stateFlag_observerHasAddFlag_objectPropertyValueOnUpdate)
             || ZFBitTest(_ZFP_ZFObject_stateFlags, _ZFP_ZFObjectPrivate::stateFlag_observerHasAddFlag_objectPropertyValueOnUpdate)))
     {
         v_ZFProperty *param0 = zflockfree_zfAllocWithCache(v_ZFProperty);
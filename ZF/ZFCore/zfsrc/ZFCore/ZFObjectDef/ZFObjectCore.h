@@ -446,6 +446,9 @@ public:
     }
     /**
      * @brief get all key value
+     *
+     * in the order the tags were added,
+     * except that removing a tag moves the last one to its position
      */
     zffinal void objectTagGetAllKeyValue(ZF_IN_OUT ZFCoreArray<const zfchar *> &allKey,
                                          ZF_IN_OUT ZFCoreArray<ZFObject *> &allValue);
@@ -663,6 +666,7 @@ public:
     zfbool _ZFP_ZFObjectTryLock(void);
 
     ZFObject *_ZFP_ZFObjectCheckOnInit(void);
+    void _ZFP_ZFObjectCheckRetain(void);
     void _ZFP_ZFObjectCheckRelease(void);
 
 protected:
@@ -751,16 +755,25 @@ protected:
     virtual void objectOnDealloc(void);
 
     /**
-     * @brief called to retain object
+     * @brief called after object retained
      *
      * subclass must call superclass's objectOnRetain before any other code if override\n
+     * the retain count is changed atomically before this method is called,
+     * and it may be called without any lock,
+     * so it may be called concurrently in different threads,
+     * and #objectRetainCount may already be changed again by other threads,
      * usually you should not override this method
      */
     virtual void objectOnRetain(void);
     /**
-     * @brief called to release object
+     * @brief called before object released
      *
-     * subclass must call superclass's onRelase after any other code if override\n
+     * subclass must call superclass's objectOnRelease after any other code if override\n
+     * this method is called before the retain count is changed atomically,
+     * so the object is still alive during this method,
+     * and it may be called without any lock,
+     * so it may be called concurrently in different threads,
+     * and #objectRetainCount may already be changed by other threads,
      * usually you should not override this method
      */
     virtual void objectOnRelease(void);
@@ -115,6 +115,7 @@ public:
                             : &zfself::_ZFP_zfAllocWithCache, \
                     &zfself::_ZFP_Obj_ctor, \
                     &zfself::_ZFP_Obj_dtor, \
+                    sizeof(zfself), \
                     &zfself::_ZFP_Obj_initImplCk \
                 ); \
             return _holder.cls; \
@@ -133,6 +134,7 @@ public:
                     zfnull, \
                     zfnull, \
                     zfnull, \
+                    0, \
                     &zfself::_ZFP_Obj_initImplCk \
                 ); \
             return _holder.cls; \
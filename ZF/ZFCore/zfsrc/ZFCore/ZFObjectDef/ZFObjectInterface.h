@@ -68,6 +68,7 @@ public:
                     zfnull, \
                     zfnull, \
                     zfnull, \
+                    0, \
                     &zfself::_ZFP_Obj_initImplCk, \
                     zftrue \
                 ); \
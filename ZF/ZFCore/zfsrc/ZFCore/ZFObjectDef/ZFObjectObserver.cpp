@@ -47,6 +47,8 @@ void ZFListenerData::objectInfoT(ZF_IN_OUT zfstring &ret) const
 zfclassLikePOD _ZFP_ZFObserverData
 {
 public:
+    zfatomicint refCount; // retained by holder and each snapshot that contains it
+    zfatomicint activated; // for autoRemoveAfterActivate, ensure activated only once
     zfidentity taskId;
     zfidentity eventId;
     ZFListener observer;
@@ -65,7 +67,9 @@ public:
                                  ZF_IN ZFObject *owner,
                                  ZF_IN ZFLevel observerLevel,
                                  ZF_IN zfbool autoRemoveAfterActivate)
-    : taskId(taskId)
+    : refCount(1)
+    , activated(0)
+    , taskId(taskId)
     , eventId(eventId)
     , observer(observer)
     , userData(userData)
@@ -84,6 +88,81 @@ private:
     _ZFP_ZFObserverData(ZF_IN const _ZFP_ZFObserverData &ref);
     _ZFP_ZFObserverData &operator = (ZF_IN const _ZFP_ZFObserverData &ref);
 };
+// may invoke user code, must be called outside of holder's lock
+static void _ZFP_ZFObserverDataRelease(ZF_IN _ZFP_ZFObserverData *p)
+{
+    if(zfAtomicDecrease(p->refCount) == 0)
+    {
+        zfpoolDelete(p);
+    }
+}
+
+/*
+ * immutable snapshot of all observers of a holder,
+ * rebuilt and swapped each time observers changed,
+ * so that notify can iterate without building temp list or holding lock
+ *
+ * memory layout (single block):
+ *   _ZFP_ZFObserverSnapshot
+ *   _ZFP_ZFObserverSnapshotEvent[eventCount] (sorted by eventId)
+ *   _ZFP_ZFObserverData *[dataCount]
+ */
+zfclassPOD _ZFP_ZFObserverSnapshotEvent
+{
+public:
+    zfidentity eventId;
+    zfindex dataOffset;
+    zfindex dataCount;
+    zfbool hasAutoRemove;
+};
+zfclassPOD _ZFP_ZFObserverSnapshot
+{
+public:
+    zfatomicint refCount;
+    zfindex eventCount;
+    zfindex dataCount;
+public:
+    _ZFP_ZFObserverSnapshotEvent *eventList(void)
+    {
+        return (_ZFP_ZFObserverSnapshotEvent *)(this + 1);
+    }
+    _ZFP_ZFObserverData **dataList(void)
+    {
+        return (_ZFP_ZFObserverData **)(this->eventList() + this->eventCount);
+    }
+    const _ZFP_ZFObserverSnapshotEvent *eventFind(ZF_IN zfidentity eventId)
+    {
+        _ZFP_ZFObserverSnapshotEvent *eventList = this->eventList();
+        zfindex l = 0;
+        zfindex r = this->eventCount;
+        while(l < r)
+        {
+            zfindex m = l + (r - l) / 2;
+            if(eventList[m].eventId < eventId)
+            {
+                l = m + 1;
+            }
+            else
+            {
+                r = m;
+            }
+        }
+        return ((l < this->eventCount && eventList[l].eventId == eventId) ? &eventList[l] : zfnull);
+    }
+};
+// may invoke user code, must be called outside of holder's lock
+static void _ZFP_ZFObserverSnapshotRelease(ZF_IN _ZFP_ZFObserverSnapshot *snapshot)
+{
+    if(snapshot != zfnull && zfAtomicDecrease(snapshot->refCount) == 0)
+    {
+        _ZFP_ZFObserverData **dataList = snapshot->dataList();
+        for(zfindex i = 0; i < snapshot->dataCount; ++i)
+        {
+            _ZFP_ZFObserverDataRelease(dataList[i]);
+        }
+        zffree(snapshot);
+    }
+}
 
 zfclassPOD _ZFP_ZFObserverHolderAttachState
 {
@@ -93,10 +172,23 @@ public:
 };
 typedef zfstlmap<zfidentity, zfstldeque<_ZFP_ZFObserverHolderAttachState> > _ZFP_ZFObserverHolderAttachStateMapType;
 
+/*
+ * each holder has its own lock, which protects the holder's data only
+ *
+ * the lock is not recursive and may be acquired while zfCoreMutex is locked,
+ * so any user code (observerOnAdd/observerOnRemove/observerOnEvent,
+ * listener execution, observer data or snapshot release)
+ * or anything that may lock zfCoreMutex
+ * must be called outside of the lock,
+ * except userDataComparer of observerRemove, which must not access the same holder
+ */
 zfclassNotPOD _ZFP_ZFObserverHolderPrivate
 {
 public:
-    zfuint refCount;
+    zfatomicint refCount;
+    zfatomicint lock;
+    _ZFP_ZFObserverSnapshot *snapshot; // null if no observer, must be accessed within lock
+    zfatomicint snapshotExist; // whether snapshot is not null, can be checked without lock
     zfstlmap<zfidentity, _ZFP_ZFObserverData *> observerMap; // <eventId, pList>
     zfstlmap<zfidentity, _ZFP_ZFObserverData *> observerTaskIdMap; // <taskId, p>
     zfstlmap<ZFObject *, zfstlmap<_ZFP_ZFObserverData *, zfidentity> > observerOwnerMap; // <owner, <p, eventId> >
@@ -105,6 +197,9 @@ public:
 public:
     _ZFP_ZFObserverHolderPrivate(void)
     : refCount(1)
+    , lock(0)
+    , snapshot(zfnull)
+    , snapshotExist(0)
     , observerMap()
     , observerTaskIdMap()
     , observerOwnerMap()
@@ -112,8 +207,85 @@ public:
     , attachMap()
     {
     }
+    ~_ZFP_ZFObserverHolderPrivate(void)
+    {
+        _ZFP_ZFObserverSnapshotRelease(this->snapshot);
+    }
+
+public:
+    /*
+     * retain current snapshot, or return null if no observer
+     *
+     * the unlocked check is only a hint to skip the lock when no observer,
+     * which has the same effect as adding observer after notify
+     */
+    _ZFP_ZFObserverSnapshot *snapshotRetain(void)
+    {
+        if(!zfAtomicLoad(this->snapshotExist))
+        {
+            return zfnull;
+        }
+        zfAtomicSpinLocker(this->lock);
+        _ZFP_ZFObserverSnapshot *ret = this->snapshot;
+        if(ret != zfnull)
+        {
+            zfAtomicIncrease(ret->refCount);
+        }
+        return ret;
+    }
+    /*
+     * must be called within lock, rebuild snapshot from observerMap,
+     * return old snapshot which must be released by _ZFP_ZFObserverSnapshotRelease outside of the lock
+     */
+    _ZFP_ZFObserverSnapshot *snapshotUpdate(void)
+    {
+        _ZFP_ZFObserverSnapshot *old = this->snapshot;
+        if(this->observerMap.empty())
+        {
+            this->snapshot = zfnull;
+            zfAtomicStore(this->snapshotExist, 0);
+            return old;
+        }
+
+        zfindex eventCount = (zfindex)this->observerMap.size();
+        zfindex dataCount = (zfindex)this->observerTaskIdMap.size();
+        _ZFP_ZFObserverSnapshot *snapshot = (_ZFP_ZFObserverSnapshot *)zfmalloc(
+            sizeof(_ZFP_ZFObserverSnapshot)
+            + sizeof(_ZFP_ZFObserverSnapshotEvent) * eventCount
+            + sizeof(_ZFP_ZFObserverData *) * dataCount);
+        snapshot->refCount = 1;
+        snapshot->eventCount = eventCount;
+        snapshot->dataCount = dataCount;
+
+        _ZFP_ZFObserverSnapshotEvent *event = snapshot->eventList();
+        _ZFP_ZFObserverData **dataList = snapshot->dataList();
+        zfindex dataIndex = 0;
+        for(zfstlmap<zfidentity, _ZFP_ZFObserverData *>::iterator it = this->observerMap.begin();
+            it != this->observerMap.end();
+            ++it, ++event)
+        {
+            event->eventId = it->first;
+            event->dataOffset = dataIndex;
+            event->hasAutoRemove = zffalse;
+            for(_ZFP_ZFObserverData *p = it->second; p != zfnull; p = p->pNext)
+            {
+                zfAtomicIncrease(p->refCount);
+                dataList[dataIndex++] = p;
+                if(p->autoRemoveAfterActivate)
+                {
+                    event->hasAutoRemove = zftrue;
+                }
+            }
+            event->dataCount = dataIndex - event->dataOffset;
+        }
+
+        this->snapshot = snapshot;
+        zfAtomicStore(this->snapshotExist, 1);
+        return old;
+    }
 
 public:
+    // flags may be shared by holders with different locks, so update them atomically
     void attachMapAttach(ZF_IN zfidentity eventId)
     {
         _ZFP_ZFObserverHolderAttachStateMapType::iterator it = this->attachMap.find(eventId);
@@ -122,7 +294,7 @@ public:
             for(zfstlsize i = 0; i < it->second.size(); ++i)
             {
                 _ZFP_ZFObserverHolderAttachState &state = it->second[i];
-                ZFBitSet(*state.flag, state.flagBit);
+                zfAtomicBitSet(*(zfatomicint *)state.flag, (zfint)state.flagBit);
             }
         }
     }
@@ -134,53 +306,97 @@ public:
             for(zfstlsize i = 0; i < it->second.size(); ++i)
             {
                 _ZFP_ZFObserverHolderAttachState &state = it->second[i];
-                ZFBitUnset(*state.flag, state.flagBit);
+                zfAtomicBitUnset(*(zfatomicint *)state.flag, (zfint)state.flagBit);
             }
         }
     }
-    void observerNotifyPrepare(ZF_IN_OUT zfstldeque<_ZFP_ZFObserverData *> &toNotify,
-                               ZF_IN_OUT _ZFP_ZFObserverData *&toDelete,
-                               ZF_IN zfidentity eventId,
-                               ZF_IN ZFObject *observerOwner)
+    /*
+     * notify observers in snapshot,
+     * auto remove observers would be detached before any observer being activated
+     */
+    void observerNotify(ZF_IN _ZFP_ZFObserverSnapshot *snapshot,
+                        ZF_IN_OUT ZFListenerData &listenerData,
+                        ZF_IN ZFObject *observerOwner)
     {
-        zfstlmap<zfidentity, _ZFP_ZFObserverData *>::iterator it = this->observerMap.find(eventId);
-        if(it != this->observerMap.end())
+        const _ZFP_ZFObserverSnapshotEvent *event = snapshot->eventFind(listenerData.eventId());
+        if(event == zfnull)
         {
-            _ZFP_ZFObserverData *p = it->second;
-            do
-            {
-                toNotify.push_back(p);
-                if(p->autoRemoveAfterActivate)
-                {
-                    this->observerDetach(it, p);
+            return ;
+        }
+        _ZFP_ZFObserverData **dataList = snapshot->dataList() + event->dataOffset;
 
-                    if(toDelete == zfnull)
-                    {
-                        toDelete = p;
-                        toDelete->pPrev = toDelete->pNext = zfnull;
-                    }
-                    else
-                    {
-                        p->pPrev = zfnull;
-                        p->pNext = toDelete;
-                        toDelete->pPrev = p;
-                        toDelete = p;
-                    }
-                }
-                p = p->pNext;
-            } while(p != zfnull);
+        if(event->hasAutoRemove)
+        {
+            this->observerNotifyAutoRemove(dataList, event->dataCount, listenerData.eventId(), observerOwner);
+        }
 
-            if(it->second == zfnull)
+        for(zfindex i = 0; i < event->dataCount && !listenerData.eventFiltered(); ++i)
+        {
+            const _ZFP_ZFObserverData &observerData = *(dataList[i]);
+            if(observerData.autoRemoveAfterActivate
+                && !zfAtomicCompareAndSwap(dataList[i]->activated, 0, 1))
+            {
+                continue;
+            }
+            observerData.observer.execute(listenerData, observerData.userData);
+        }
+    }
+private:
+    void observerNotifyAutoRemove(ZF_IN _ZFP_ZFObserverData **dataList,
+                                  ZF_IN zfindex dataCount,
+                                  ZF_IN zfidentity eventId,
+                                  ZF_IN ZFObject *observerOwner)
+    {
+        _ZFP_ZFObserverData *toRelease = zfnull;
+        _ZFP_ZFObserverSnapshot *snapshotOld = zfnull;
+        zfbool notifyOnRemove = zffalse;
+        {
+            zfAtomicSpinLocker(this->lock);
+            zfstlmap<zfidentity, _ZFP_ZFObserverData *>::iterator it = this->observerMap.find(eventId);
+            for(zfindex i = 0; i < dataCount && it != this->observerMap.end(); ++i)
             {
-                this->observerMap.erase(it);
-                this->attachMapDetach(eventId);
-                if(observerOwner)
+                _ZFP_ZFObserverData *p = dataList[i];
+                if(!p->autoRemoveAfterActivate)
+                {
+                    continue;
+                }
+                // may already removed by other notify or observerRemove
+                zfstlmap<zfidentity, _ZFP_ZFObserverData *>::iterator itTaskId = this->observerTaskIdMap.find(p->taskId);
+                if(itTaskId == this->observerTaskIdMap.end() || itTaskId->second != p)
                 {
-                    observerOwner->observerOnRemove(eventId);
+                    continue;
                 }
+                this->observerDetach(it, p);
+                p->pPrev = zfnull;
+                p->pNext = toRelease;
+                toRelease = p;
+                if(it->second == zfnull)
+                {
+                    this->observerMap.erase(it);
+                    it = this->observerMap.end();
+                    this->attachMapDetach(eventId);
+                    notifyOnRemove = zftrue;
+                }
+            }
+            if(toRelease != zfnull)
+            {
+                snapshotOld = this->snapshotUpdate();
             }
         }
+
+        if(notifyOnRemove && observerOwner != zfnull)
+        {
+            observerOwner->observerOnRemove(eventId);
+        }
+        _ZFP_ZFObserverSnapshotRelease(snapshotOld);
+        while(toRelease != zfnull)
+        {
+            _ZFP_ZFObserverData *t = toRelease;
+            toRelease = toRelease->pNext;
+            _ZFP_ZFObserverDataRelease(t);
+        }
     }
+public:
     void observerDetach(ZF_IN_OUT _ZFP_ZFObserverData *p)
     {
         this->taskIdGenerator.idRelease(p->taskId);
@@ -226,18 +442,20 @@ ZFObserverHolder::ZFObserverHolder(void)
 ZFObserverHolder::ZFObserverHolder(ZF_IN ZFObserverHolder const &ref)
 {
     d = ref.d;
-    ++(d->refCount);
+    zfAtomicIncrease(d->refCount);
     _observerOwner = ref._observerOwner;
 }
 ZFObserverHolder::~ZFObserverHolder(void)
 {
-    zfpoolDelete(d);
+    if(zfAtomicDecrease(d->refCount) == 0)
+    {
+        zfpoolDelete(d);
+    }
 }
 ZFObserverHolder &ZFObserverHolder::operator = (ZF_IN ZFObserverHolder const &ref)
 {
-    ++(ref.d->refCount);
-    --(d->refCount);
-    if(d->refCount == 0)
+    zfAtomicIncrease(ref.d->refCount);
+    if(zfAtomicDecrease(d->refCount) == 0)
     {
         zfpoolDelete(d);
     }
@@ -257,8 +475,6 @@ zfidentity ZFObserverHolder::observerAdd(ZF_IN zfidentity eventId,
                                          ZF_IN_OPT zfbool autoRemoveAfterActivate /* = zffalse */,
                                          ZF_IN_OPT ZFLevel observerLevel /* = ZFLevelAppNormal */) const
 {
-    zfCoreMutexLocker();
-
     if(eventId == zfidentityInvalid()
         || !observer.callbackIsValid())
     {
@@ -272,11 +488,8 @@ zfidentity ZFObserverHolder::observerAdd(ZF_IN zfidentity eventId,
         return zfidentityInvalid();
     }
 
-    d->attachMapAttach(eventId);
-
-    zfidentity taskId = d->taskIdGenerator.idAcquire();
     _ZFP_ZFObserverData *t = zfpoolNew(_ZFP_ZFObserverData
-            , taskId
+            , zfidentityInvalid()
             , eventId
             , observer
             , zflockfree_zfRetain(userData)
@@ -284,42 +497,55 @@ zfidentity ZFObserverHolder::observerAdd(ZF_IN zfidentity eventId,
             , observerLevel
             , autoRemoveAfterActivate
         );
-    d->observerTaskIdMap[taskId] = t;
-    if(owner != zfnull)
+    zfidentity taskId = zfidentityInvalid();
+    zfbool notifyOnAdd = zffalse;
+    _ZFP_ZFObserverSnapshot *snapshotOld = zfnull;
     {
-        d->observerOwnerMap[owner][t] = eventId;
-    }
+        zfAtomicSpinLocker(d->lock);
+        d->attachMapAttach(eventId);
 
-    _ZFP_ZFObserverData *&head = d->observerMap[eventId];
-    if(head == zfnull || head->observerLevel > observerLevel)
-    {
-        t->pNext = head;
-        if(head != zfnull)
-        {
-            head->pPrev = t;
-        }
-        head = t;
-        if(this->observerOwner() != zfnull)
+        taskId = d->taskIdGenerator.idAcquire();
+        t->taskId = taskId;
+        d->observerTaskIdMap[taskId] = t;
+        if(owner != zfnull)
         {
-            this->observerOwner()->observerOnAdd(eventId);
+            d->observerOwnerMap[owner][t] = eventId;
         }
-    }
-    else
-    {
-        _ZFP_ZFObserverData *p = head;
-        while(p->pNext != zfnull && p->pNext->observerLevel <= observerLevel)
+
+        _ZFP_ZFObserverData *&head = d->observerMap[eventId];
+        if(head == zfnull || head->observerLevel > observerLevel)
         {
-            p = p->pNext;
+            t->pNext = head;
+            if(head != zfnull)
+            {
+                head->pPrev = t;
+            }
+            head = t;
+            notifyOnAdd = zftrue;
         }
-        if(p->pNext != zfnull)
+        else
         {
-            p->pNext->pPrev = t;
+            _ZFP_ZFObserverData *p = head;
+            while(p->pNext != zfnull && p->pNext->observerLevel <= observerLevel)
+            {
+                p = p->pNext;
+            }
+            if(p->pNext != zfnull)
+            {
+                p->pNext->pPrev = t;
+            }
+            t->pNext = p->pNext;
+            t->pPrev = p;
+            p->pNext = t;
         }
-        t->pNext = p->pNext;
-        t->pPrev = p;
-        p->pNext = t;
+        snapshotOld = d->snapshotUpdate();
     }
 
+    _ZFP_ZFObserverSnapshotRelease(snapshotOld);
+    if(notifyOnAdd && this->observerOwner() != zfnull)
+    {
+        this->observerOwner()->observerOnAdd(eventId);
+    }
     return taskId;
 }
 zfidentity ZFObserverHolder::observerAdd(ZF_IN const ZFObserverAddParam &param) const
@@ -334,192 +560,245 @@ zfidentity ZFObserverHolder::observerAdd(ZF_IN const ZFObserverAddParam &param)
 }
 void ZFObserverHolder::observerMoveToFirst(ZF_IN zfidentity taskId) const
 {
-    zfCoreMutexLocker();
-    zfstlmap<zfidentity, _ZFP_ZFObserverData *>::iterator itTaskId = d->observerTaskIdMap.find(taskId);
-    if(itTaskId == d->observerTaskIdMap.end())
+    _ZFP_ZFObserverSnapshot *snapshotOld = zfnull;
     {
-        return ;
-    }
+        zfAtomicSpinLocker(d->lock);
+        zfstlmap<zfidentity, _ZFP_ZFObserverData *>::iterator itTaskId = d->observerTaskIdMap.find(taskId);
+        if(itTaskId == d->observerTaskIdMap.end())
+        {
+            return ;
+        }
 
-    _ZFP_ZFObserverData *p = itTaskId->second;
-    _ZFP_ZFObserverData *pos = p;
-    while(pos->pPrev != zfnull)
-    {
-        if(pos->pPrev->observerLevel == p->observerLevel)
+        _ZFP_ZFObserverData *p = itTaskId->second;
+        _ZFP_ZFObserverData *pos = p;
+        while(pos->pPrev != zfnull)
         {
-            pos = pos->pPrev;
+            if(pos->pPrev->observerLevel == p->observerLevel)
+            {
+                pos = pos->pPrev;
+            }
+            else
+            {
+                break;
+            }
+        }
+        if(pos == p)
+        {
+            return ;
+        }
+        p->pPrev->pNext = p->pNext;
+        if(p->pNext != zfnull)
+        {
+            p->pNext->pPrev = p->pPrev;
+        }
+        if(pos->pPrev != zfnull)
+        {
+            pos->pPrev->pNext = p;
         }
         else
         {
-            break;
+            d->observerMap[p->eventId] = p;
         }
+        p->pPrev = pos->pPrev;
+        pos->pPrev = p;
+        p->pNext = pos;
+        snapshotOld = d->snapshotUpdate();
     }
-    if(pos == p)
-    {
-        return ;
-    }
-    p->pPrev->pNext = p->pNext;
-    if(p->pNext != zfnull)
-    {
-        p->pNext->pPrev = p->pPrev;
-    }
-    if(pos->pPrev != zfnull)
-    {
-        pos->pPrev->pNext = p;
-    }
-    p->pPrev = pos->pPrev;
-    pos->pPrev = p;
-    p->pNext = pos;
+    _ZFP_ZFObserverSnapshotRelease(snapshotOld);
 }
 void ZFObserverHolder::observerRemove(ZF_IN zfidentity eventId,
                                       ZF_IN const ZFListener &callback,
                                       ZF_IN_OPT ZFObject *userData /* = zfnull */,
                                       ZF_IN_OPT ZFComparer<ZFObject *>::Comparer userDataComparer /* = ZFComparerCheckEqual */) const
 {
-    zfCoreMutexLocker();
-
-    zfstlmap<zfidentity, _ZFP_ZFObserverData *>::iterator it = d->observerMap.find(eventId);
-    if(it != d->observerMap.end())
+    _ZFP_ZFObserverData *toRelease = zfnull;
+    _ZFP_ZFObserverSnapshot *snapshotOld = zfnull;
+    zfbool notifyOnRemove = zffalse;
     {
-        _ZFP_ZFObserverData *p = it->second;
-        do
+        zfAtomicSpinLocker(d->lock);
+        zfstlmap<zfidentity, _ZFP_ZFObserverData *>::iterator it = d->observerMap.find(eventId);
+        if(it != d->observerMap.end())
         {
-            if(p->observer.objectCompareByInstance(callback) == ZFCompareTheSame
-                && (userData == zfnull || userDataComparer(userData, p->userData) == ZFCompareTheSame))
+            _ZFP_ZFObserverData *p = it->second;
+            do
             {
-                d->observerDetach(it, p);
-
-                if(it->second == zfnull)
+                if(p->observer.objectCompareByInstance(callback) == ZFCompareTheSame
+                    && (userData == zfnull || userDataComparer(userData, p->userData) == ZFCompareTheSame))
                 {
-                    d->observerMap.erase(it);
-                    d->attachMapDetach(eventId);
-                    if(this->observerOwner())
+                    d->observerDetach(it, p);
+
+                    if(it->second == zfnull)
                     {
-                        this->observerOwner()->observerOnRemove(eventId);
+                        d->observerMap.erase(it);
+                        d->attachMapDetach(eventId);
+                        notifyOnRemove = zftrue;
                     }
+                    toRelease = p;
+                    snapshotOld = d->snapshotUpdate();
+                    break;
                 }
-                zfpoolDelete(p);
-                break;
-            }
-            p = p->pNext;
-        } while(p != zfnull);
+                p = p->pNext;
+            } while(p != zfnull);
+        }
+    }
+
+    if(notifyOnRemove && this->observerOwner())
+    {
+        this->observerOwner()->observerOnRemove(eventId);
+    }
+    _ZFP_ZFObserverSnapshotRelease(snapshotOld);
+    if(toRelease != zfnull)
+    {
+        _ZFP_ZFObserverDataRelease(toRelease);
     }
 }
 void ZFObserverHolder::observerRemoveByTaskId(ZF_IN zfidentity taskId) const
 {
-    zfCoreMutexLocker();
-    zfstlmap<zfidentity, _ZFP_ZFObserverData *>::iterator itTaskId = d->observerTaskIdMap.find(taskId);
-    if(itTaskId == d->observerTaskIdMap.end())
+    _ZFP_ZFObserverData *p = zfnull;
+    _ZFP_ZFObserverSnapshot *snapshotOld = zfnull;
+    zfbool notifyOnRemove = zffalse;
     {
-        return ;
-    }
+        zfAtomicSpinLocker(d->lock);
+        zfstlmap<zfidentity, _ZFP_ZFObserverData *>::iterator itTaskId = d->observerTaskIdMap.find(taskId);
+        if(itTaskId == d->observerTaskIdMap.end())
+        {
+            return ;
+        }
 
-    _ZFP_ZFObserverData *p = itTaskId->second;
-    zfstlmap<zfidentity, _ZFP_ZFObserverData *>::iterator it = d->observerMap.find(p->eventId);
-    d->observerDetach(it, p);
-    if(it->second == zfnull)
-    {
-        d->observerMap.erase(it);
-        d->attachMapDetach(p->eventId);
-        if(this->observerOwner())
+        p = itTaskId->second;
+        zfstlmap<zfidentity, _ZFP_ZFObserverData *>::iterator it = d->observerMap.find(p->eventId);
+        d->observerDetach(it, p);
+        if(it->second == zfnull)
         {
-            this->observerOwner()->observerOnRemove(p->taskId);
+            d->observerMap.erase(it);
+            d->attachMapDetach(p->eventId);
+            notifyOnRemove = zftrue;
         }
+        snapshotOld = d->snapshotUpdate();
     }
-    zfpoolDelete(p);
+
+    if(notifyOnRemove && this->observerOwner())
+    {
+        this->observerOwner()->observerOnRemove(p->eventId);
+    }
+    _ZFP_ZFObserverSnapshotRelease(snapshotOld);
+    _ZFP_ZFObserverDataRelease(p);
 }
 void ZFObserverHolder::observerRemoveByOwner(ZF_IN ZFObject *owner) const
 {
-    zfCoreMutexLocker();
-    zfstlmap<ZFObject *, zfstlmap<_ZFP_ZFObserverData *, zfidentity> >::iterator itOwner = d->observerOwnerMap.find(owner);
-    if(itOwner == d->observerOwnerMap.end())
+    zfstlmap<_ZFP_ZFObserverData *, zfidentity> toRemove;
+    zfstldeque<zfidentity> toNotifyOnRemove;
+    _ZFP_ZFObserverSnapshot *snapshotOld = zfnull;
     {
-        return ;
-    }
+        zfAtomicSpinLocker(d->lock);
+        zfstlmap<ZFObject *, zfstlmap<_ZFP_ZFObserverData *, zfidentity> >::iterator itOwner = d->observerOwnerMap.find(owner);
+        if(itOwner == d->observerOwnerMap.end())
+        {
+            return ;
+        }
 
-    zfstlmap<_ZFP_ZFObserverData *, zfidentity> toRemove = itOwner->second;
-    for(zfstlmap<_ZFP_ZFObserverData *, zfidentity>::iterator itToRemove = toRemove.begin(); itToRemove != toRemove.end(); ++itToRemove)
-    {
-        zfidentity eventId = itToRemove->second;
-        _ZFP_ZFObserverData *p = itToRemove->first;
-        zfstlmap<zfidentity, _ZFP_ZFObserverData *>::iterator it = d->observerMap.find(eventId);
-        if(it != d->observerMap.end())
+        toRemove = itOwner->second;
+        for(zfstlmap<_ZFP_ZFObserverData *, zfidentity>::iterator itToRemove = toRemove.begin(); itToRemove != toRemove.end(); ++itToRemove)
         {
-            d->observerDetach(it, p);
-            if(it->second == zfnull)
+            zfidentity eventId = itToRemove->second;
+            _ZFP_ZFObserverData *p = itToRemove->first;
+            zfstlmap<zfidentity, _ZFP_ZFObserverData *>::iterator it = d->observerMap.find(eventId);
+            if(it != d->observerMap.end())
             {
-                d->observerMap.erase(it);
-                if(this->observerOwner())
+                d->observerDetach(it, p);
+                if(it->second == zfnull)
                 {
-                    d->attachMapDetach(eventId);
-                    this->observerOwner()->observerOnRemove(eventId);
+                    d->observerMap.erase(it);
+                    if(this->observerOwner())
+                    {
+                        d->attachMapDetach(eventId);
+                        toNotifyOnRemove.push_back(eventId);
+                    }
                 }
             }
         }
-        zfpoolDelete(p);
+        snapshotOld = d->snapshotUpdate();
+    }
+
+    for(zfstlsize i = 0; i < toNotifyOnRemove.size(); ++i)
+    {
+        this->observerOwner()->observerOnRemove(toNotifyOnRemove[i]);
+    }
+    _ZFP_ZFObserverSnapshotRelease(snapshotOld);
+    for(zfstlmap<_ZFP_ZFObserverData *, zfidentity>::iterator itToRemove = toRemove.begin(); itToRemove != toRemove.end(); ++itToRemove)
+    {
+        _ZFP_ZFObserverDataRelease(itToRemove->first);
     }
 }
 void ZFObserverHolder::observerRemoveAll(ZF_IN zfidentity eventId) const
 {
-    zfCoreMutexLocker();
-    zfstlmap<zfidentity, _ZFP_ZFObserverData *>::iterator it = d->observerMap.find(eventId);
-    if(it == d->observerMap.end())
+    zfstldeque<_ZFP_ZFObserverData *> toRelease;
+    _ZFP_ZFObserverSnapshot *snapshotOld = zfnull;
     {
-        return ;
-    }
-    zfstldeque<_ZFP_ZFObserverData *> toDelete;
-    while(it->second != zfnull)
-    {
-        toDelete.push_back(it->second);
-        d->observerDetach(it, it->second);
+        zfAtomicSpinLocker(d->lock);
+        zfstlmap<zfidentity, _ZFP_ZFObserverData *>::iterator it = d->observerMap.find(eventId);
+        if(it == d->observerMap.end())
+        {
+            return ;
+        }
+        while(it->second != zfnull)
+        {
+            toRelease.push_back(it->second);
+            d->observerDetach(it, it->second);
+        }
+        d->observerMap.erase(it);
+
+        d->attachMapDetach(eventId);
+        snapshotOld = d->snapshotUpdate();
     }
-    d->observerMap.erase(it);
 
-    d->attachMapDetach(eventId);
     if(this->observerOwner())
     {
         this->observerOwner()->observerOnRemove(eventId);
     }
 
-    for(zfstlsize i = toDelete.size() - 1; i != (zfstlsize)-1; --i)
+    _ZFP_ZFObserverSnapshotRelease(snapshotOld);
+    for(zfstlsize i = toRelease.size() - 1; i != (zfstlsize)-1; --i)
     {
-        zfpoolDelete(toDelete[i]);
+        _ZFP_ZFObserverDataRelease(toRelease[i]);
     }
 }
 void ZFObserverHolder::observerRemoveAll(void) const
 {
-    if(d->observerMap.empty())
+    if(!zfAtomicLoad(d->snapshotExist))
     {
         return ;
     }
 
-    zfCoreMutexLocker();
     zfstlmap<zfidentity, _ZFP_ZFObserverData *> tmp;
-    tmp.swap(d->observerMap);
-    d->observerMap.clear();
-    d->observerTaskIdMap.clear();
-    d->observerOwnerMap.clear();
-
-    if(this->observerOwner())
+    _ZFP_ZFObserverSnapshot *snapshotOld = zfnull;
     {
+        zfAtomicSpinLocker(d->lock);
+        tmp.swap(d->observerMap);
+        d->observerMap.clear();
+        d->observerTaskIdMap.clear();
+        d->observerOwnerMap.clear();
+
         for(zfstlmap<zfidentity, _ZFP_ZFObserverData *>::iterator it = tmp.begin();
             it != tmp.end();
             ++it)
         {
             d->attachMapDetach(it->first);
-            this->observerOwner()->observerOnRemove(it->first);
         }
+        snapshotOld = d->snapshotUpdate();
     }
-    else
+
+    if(this->observerOwner())
     {
         for(zfstlmap<zfidentity, _ZFP_ZFObserverData *>::iterator it = tmp.begin();
             it != tmp.end();
             ++it)
         {
-            d->attachMapDetach(it->first);
+            this->observerOwner()->observerOnRemove(it->first);
         }
     }
 
+    _ZFP_ZFObserverSnapshotRelease(snapshotOld);
     for(zfstlmap<zfidentity, _ZFP_ZFObserverData *>::iterator it = tmp.begin();
         it != tmp.end();
         ++it)
@@ -529,7 +808,7 @@ void ZFObserverHolder::observerRemoveAll(void) const
         {
             _ZFP_ZFObserverData *t = p;
             p = p->pNext;
-            zfpoolDelete(t);
+            _ZFP_ZFObserverDataRelease(t);
         } while(p != zfnull);
     }
 }
@@ -537,26 +816,33 @@ zfbool ZFObserverHolder::observerHasAdd(void) const
 {
     if(this->observerOwner() != zfnull)
     {
-        return !d->observerMap.empty()
-            || !ZFObjectGlobalEventObserver().d->observerMap.empty();
+        return zfAtomicLoad(d->snapshotExist) != 0
+            || zfAtomicLoad(ZFObjectGlobalEventObserver().d->snapshotExist) != 0;
     }
     else
     {
-        return !d->observerMap.empty();
+        return zfAtomicLoad(d->snapshotExist) != 0;
     }
 }
 zfbool ZFObserverHolder::observerHasAdd(ZF_IN zfidentity eventId) const
 {
-    if(this->observerOwner() != zfnull)
+    zfbool ret = zffalse;
+    _ZFP_ZFObserverSnapshot *snapshot = d->snapshotRetain();
+    if(snapshot != zfnull)
     {
-        zfstlmap<zfidentity, _ZFP_ZFObserverData *> &g = ZFObjectGlobalEventObserver().d->observerMap;
-        return (d->observerMap.find(eventId) != d->observerMap.end())
-            || (g.find(eventId) != g.end());
+        ret = (snapshot->eventFind(eventId) != zfnull);
+        _ZFP_ZFObserverSnapshotRelease(snapshot);
     }
-    else
+    if(!ret && this->observerOwner() != zfnull)
     {
-        return (d->observerMap.find(eventId) != d->observerMap.end());
+        snapshot = ZFObjectGlobalEventObserver().d->snapshotRetain();
+        if(snapshot != zfnull)
+        {
+            ret = (snapshot->eventFind(eventId) != zfnull);
+            _ZFP_ZFObserverSnapshotRelease(snapshot);
+        }
     }
+    return ret;
 }
 
 void ZFObserverHolder::observerNotifyWithCustomSender(ZF_IN ZFObject *customSender,
@@ -569,38 +855,30 @@ void ZFObserverHolder::observerNotifyWithCustomSender(ZF_IN ZFObject *customSend
         return ;
     }
 
-    zfCoreMutexLock();
-    zfstldeque<_ZFP_ZFObserverData *> toNotify;
-    _ZFP_ZFObserverData *toDelete = zfnull;
-
-    d->observerNotifyPrepare(toNotify, toDelete, eventId, this->observerOwner());
     ZFListenerData listenerData(eventId, customSender, param0, param1);
-    if(this->observerOwner() != zfnull)
-    {
-        this->observerOwner()->observerOnEvent(listenerData);
-        ZFObjectGlobalEventObserver().d->observerNotifyPrepare(toNotify, toDelete, eventId, this->observerOwner());
-    }
-    zfCoreMutexUnlock();
-
-    if(!toNotify.empty())
+    _ZFP_ZFObserverSnapshot *snapshot = d->snapshotRetain();
+    if(this->observerOwner() == zfnull)
     {
-        for(zfstlsize i = 0; i < toNotify.size() && !listenerData.eventFiltered(); ++i)
+        if(snapshot != zfnull)
         {
-            const _ZFP_ZFObserverData &observerData = *(toNotify[i]);
-            observerData.observer.execute(listenerData, observerData.userData);
+            d->observerNotify(snapshot, listenerData, zfnull);
+            _ZFP_ZFObserverSnapshotRelease(snapshot);
         }
+        return ;
     }
 
-    if(toDelete != zfnull)
+    this->observerOwner()->observerOnEvent(listenerData);
+    _ZFP_ZFObserverHolderPrivate *g = ZFObjectGlobalEventObserver().d;
+    _ZFP_ZFObserverSnapshot *snapshotGlobal = g->snapshotRetain();
+    if(snapshot != zfnull)
     {
-        zfCoreMutexLock();
-        do
-        {
-            _ZFP_ZFObserverData *t = toDelete;
-            toDelete = toDelete->pNext;
-            zfpoolDelete(t);
-        } while(toDelete != zfnull);
-        zfCoreMutexUnlock();
+        d->observerNotify(snapshot, listenerData, this->observerOwner());
+        _ZFP_ZFObserverSnapshotRelease(snapshot);
+    }
+    if(snapshotGlobal != zfnull)
+    {
+        g->observerNotify(snapshotGlobal, listenerData, this->observerOwner());
+        _ZFP_ZFObserverSnapshotRelease(snapshotGlobal);
     }
 }
 
@@ -611,12 +889,14 @@ void ZFObserverHolder::observerHasAddStateAttach(ZF_IN zfidentity eventId,
     _ZFP_ZFObserverHolderAttachState state;
     state.flag = flag;
     state.flagBit = flagBit;
+    zfAtomicSpinLocker(d->lock);
     d->attachMap[eventId].push_back(state);
 }
 void ZFObserverHolder::observerHasAddStateDetach(ZF_IN zfidentity eventId,
                                                  ZF_IN_OUT zfuint *flag,
                                                  ZF_IN_OUT zfuint flagBit)
 {
+    zfAtomicSpinLocker(d->lock);
     _ZFP_ZFObserverHolderAttachStateMapType::iterator it = d->attachMap.find(eventId);
     if(it != d->attachMap.end())
     {
@@ -634,7 +914,6 @@ void ZFObserverHolder::observerHasAddStateDetach(ZF_IN zfidentity eventId,
 
 void ZFObserverHolder::objectInfoT(ZF_OUT zfstring &ret) const
 {
-    zfCoreMutexLocker();
     ret += "<ZFObserverHolder";
 
     if(this->observerOwner() != zfnull)
@@ -643,27 +922,41 @@ void ZFObserverHolder::objectInfoT(ZF_OUT zfstring &ret) const
         this->observerOwner()->objectInfoT(ret);
     }
 
-    if(d->observerMap.empty())
+    // copy first, ZFIdMapNameForId and objectInfo may lock zfCoreMutex
+    zfstldeque<zfidentity> eventIdList;
+    zfstldeque<zfstldeque<ZFListener> > observerList;
+    {
+        zfAtomicSpinLocker(d->lock);
+        for(zfstlmap<zfidentity, _ZFP_ZFObserverData *>::iterator it = d->observerMap.begin();
+            it != d->observerMap.end();
+            ++it)
+        {
+            eventIdList.push_back(it->first);
+            observerList.push_back(zfstldeque<ZFListener>());
+            for(_ZFP_ZFObserverData *p = it->second; p != zfnull; p = p->pNext)
+            {
+                observerList.back().push_back(p->observer);
+            }
+        }
+    }
+
+    if(eventIdList.empty())
     {
         ret += ">";
     }
     else
     {
-        for(zfstlmap<zfidentity, _ZFP_ZFObserverData *>::iterator it = d->observerMap.begin();
-            it != d->observerMap.end();
-            ++it)
+        for(zfstlsize i = 0; i < eventIdList.size(); ++i)
         {
             ret += "\n  ";
-            ret += ZFIdMapNameForId(it->first);
+            ret += ZFIdMapNameForId(eventIdList[i]);
             ret += ":";
 
-            _ZFP_ZFObserverData *p = it->second;
-            do
+            for(zfstlsize j = 0; j < observerList[i].size(); ++j)
             {
                 ret += "\n    ";
-                ret += p->observer.objectInfo();
-                p = p->pNext;
-            } while(p != zfnull);
+                ret += observerList[i][j].objectInfo();
+            }
         }
 
         ret += "\n  >";
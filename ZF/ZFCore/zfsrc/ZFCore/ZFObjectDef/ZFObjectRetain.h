@@ -104,7 +104,7 @@ inline void _ZFP_zfRetainAction(ZF_IN ZFObject *obj)
 {
     if(obj)
     {
-        obj->objectOnRetain();
+        obj->_ZFP_ZFObjectCheckRetain();
     }
 }
 template<typename T_ZFObject>
@@ -115,9 +115,11 @@ inline T_ZFObject _ZFP_zfRetain(ZF_IN T_ZFObject obj)
 }
 /**
  * @brief retain an object, see #ZFObject
+ *
+ * retain count is changed atomically, no lock is required
  */
 #define zfRetain(obj) \
-    (zfCoreMutexLockerHolder(), zflockfree_zfRetain(obj))
+    zflockfree_zfRetain(obj)
 /** @brief no lock version of #zfRetain, use with caution */
 #define zflockfree_zfRetain(obj) \
     _ZFP_zfRetain(obj)
@@ -138,9 +140,13 @@ inline void _ZFP_zfRelease(ZF_IN T_ZFObject obj)
 }
 /**
  * @brief release an object, see #ZFObject
+ *
+ * retain count is changed atomically,
+ * lock is only required when releasing the last reference,
+ * which would be done internally
  */
 #define zfRelease(obj) \
-    (zfCoreMutexLockerHolder(), zflockfree_zfRelease(obj))
+    zflockfree_zfRelease(obj)
 /** @brief no lock version of #zfRelease, use with caution */
 #define zflockfree_zfRelease(obj) \
     _ZFP_zfRelease(obj)
@@ -247,6 +253,9 @@ extern ZF_ENV_EXPORT void _ZFP_zfAllocWithCache_register(ZF_IN_OUT zfbool &enabl
                                                          ZF_IN_OUT ZFObject **cache,
                                                          ZF_IN_OUT zfindex &cacheCount);
 extern ZF_ENV_EXPORT void _ZFP_zfAllocWithCache_unregister(ZF_IN_OUT zfbool &enableFlag);
+extern ZF_ENV_EXPORT zfbool _ZFP_ZFObjectAllocTrackEnableFlag;
+extern ZF_ENV_EXPORT void _ZFP_ZFObjectAllocTrackCacheHit(ZF_IN ZFObject *obj);
+extern ZF_ENV_EXPORT void _ZFP_ZFObjectAllocTrackCacheStore(ZF_IN ZFObject *obj);
 template<typename T_ZFObject, typename T_Cleanup = T_ZFObject, int T_MaxCache = 16>
 zfclassNotPOD ZF_ENV_EXPORT _ZFP_Obj_AllocCache
 {
@@ -261,6 +270,10 @@ public:
             {
                 ZFObject *ret = zflockfree_zfRetain(cache()[--(cacheCount())]);
                 ret->_ZFP_ZFObject_zfAllocCacheRelease = zfAllocCacheRelease;
+                if(_ZFP_ZFObjectAllocTrackEnableFlag)
+                {
+                    _ZFP_ZFObjectAllocTrackCacheHit(ret);
+                }
                 return ZFCastZFObjectUnchecked(T_ZFObject *, ret);
             }
             else
@@ -282,6 +295,10 @@ public:
         {
             T_Cleanup::zfAllocCacheRelease(obj);
             cache()[cacheCount()++] = obj;
+            if(_ZFP_ZFObjectAllocTrackEnableFlag)
+            {
+                _ZFP_ZFObjectAllocTrackCacheStore(obj);
+            }
         }
         else
         {
@@ -306,6 +306,11 @@ void _ZFP_ZFPropertyUnregister(ZF_IN const ZFProperty *propertyInfo)
         }
         zfRetainChange(propertyInfo->_ZFP_ZFProperty_removeConst()->_ZFP_ZFProperty_propertyDynamicRegisterUserData, zfnull);
     }
+    else
+    {
+        // class's member table would access all registered properties when rebuilt
+        propertyInfo->propertyOwnerClass()->_ZFP_ZFClass_propertyUnregister(propertyInfo);
+    }
 
     _ZFP_ZFPropertyInstanceCleanup(propertyInfo);
 }
@@ -16,7 +16,7 @@ zfbool ZFSerializableDataResolveCheckEnable = zftrue;
 zfclassNotPOD _ZFP_ZFSerializableDataAttributeData
 {
 public:
-    zfstlstringZ attrValue;
+    zfstringShared attrValue;
     zfbool resolved;
 public:
     _ZFP_ZFSerializableDataAttributeData(void)
@@ -31,14 +31,54 @@ public:
     {
     }
 };
-typedef zfstlmap<zfstlstringZ, _ZFP_ZFSerializableDataAttributeData> _ZFP_ZFSerializableDataAttributeMapType;
+/*
+ * attribute names are typically property names, which have already been interned,
+ * share the atom if so, otherwise store an owned copy,
+ * never intern here, since names may come from arbitrary documents
+ */
+zfclassNotPOD _ZFP_ZFSerializableDataAttributeName
+{
+public:
+    zfstringAtom atom; // set if name has already been interned
+    zfstringShared owned; // copy of name if not interned
+    const zfchar *lookup; // caller's string, for lookup only
+public:
+    _ZFP_ZFSerializableDataAttributeName(void)
+    : atom()
+    , owned()
+    , lookup(zfnull)
+    {
+    }
+public:
+    const zfchar *cString(void) const
+    {
+        if(this->lookup != zfnull)
+        {
+            return this->lookup;
+        }
+        return this->atom.isNull() ? this->owned.cString() : this->atom.cString();
+    }
+};
+zfclassNotPOD _ZFP_ZFSerializableDataAttributeName_zfstlComparer
+{
+public:
+    inline zfbool operator () (const _ZFP_ZFSerializableDataAttributeName &k1, const _ZFP_ZFSerializableDataAttributeName &k2) const
+    {
+        if(!k1.atom.isNull() && k1.atom == k2.atom)
+        {
+            return zffalse;
+        }
+        return (zfscmp(k1.cString(), k2.cString()) < 0);
+    }
+};
+typedef zfstlmap<_ZFP_ZFSerializableDataAttributeName, _ZFP_ZFSerializableDataAttributeData, _ZFP_ZFSerializableDataAttributeName_zfstlComparer> _ZFP_ZFSerializableDataAttributeMapType;
 typedef zfstlmap<zfstlstringZ, zfautoObject> _ZFP_ZFSerializableDataTagMapType;
 zfclassNotPOD _ZFP_ZFSerializableDataPrivate
 {
 public:
     zfuint refCount;
     _ZFP_ZFSerializableDataPrivate *serializableDataParent;
-    zfstlstringZ classNameFull;
+    zfstringShared classNameFull;
     zfbool resolved;
     ZFPathInfo *pathInfo;
     _ZFP_ZFSerializableDataAttributeMapType attributes;
@@ -48,7 +88,7 @@ public:
 public:
     void removeAll(void)
     {
-        this->classNameFull.clear();
+        this->classNameFull = zfstringShared();
         this->attributes.clear();
         if(!this->elements.empty())
         {
@@ -259,7 +299,7 @@ void ZFSerializableData::itemClass(ZF_IN const zfchar *classNameFull)
 {
     if(classNameFull == zfnull)
     {
-        d->classNameFull.clear();
+        d->classNameFull = zfstringShared();
     }
     else
     {
@@ -268,7 +308,7 @@ void ZFSerializableData::itemClass(ZF_IN const zfchar *classNameFull)
 }
 const zfchar *ZFSerializableData::itemClass(void) const
 {
-    return d->classNameFull.empty() ? zfnull : d->classNameFull.c_str();
+    return d->classNameFull.isEmpty() ? zfnull : d->classNameFull.cString();
 }
 
 // ============================================================
@@ -375,6 +415,13 @@ void ZFSerializableData::serializableDataTagRemoveAll(void)
 
 // ============================================================
 // attribute
+static _ZFP_ZFSerializableDataAttributeMapType::iterator _ZFP_ZFSerializableDataAttributeFind(ZF_IN _ZFP_ZFSerializableDataAttributeMapType &attributes,
+                                                                                            ZF_IN const zfchar *name)
+{
+    _ZFP_ZFSerializableDataAttributeName key;
+    key.lookup = name;
+    return attributes.find(key);
+}
 void ZFSerializableData::attributeForName(ZF_IN const zfchar *name,
                                           ZF_IN const zfchar *value)
 {
@@ -382,19 +429,25 @@ void ZFSerializableData::attributeForName(ZF_IN const zfchar *name,
     {
         if(value != zfnull)
         {
-            _ZFP_ZFSerializableDataAttributeMapType::iterator it = d->attributes.find(name);
+            _ZFP_ZFSerializableDataAttributeMapType::iterator it = _ZFP_ZFSerializableDataAttributeFind(d->attributes, name);
             if(it != d->attributes.end())
             {
                 it->second = _ZFP_ZFSerializableDataAttributeData(value);
             }
             else
             {
-                d->attributes[name] = _ZFP_ZFSerializableDataAttributeData(value);
+                _ZFP_ZFSerializableDataAttributeName key;
+                key.atom = zfstringAtomFind(name);
+                if(key.atom.isNull())
+                {
+                    key.owned = name;
+                }
+                d->attributes[key] = _ZFP_ZFSerializableDataAttributeData(value);
             }
         }
         else
         {
-            d->attributes.erase(name);
+            this->attributeRemove(name);
         }
     }
 }
@@ -402,10 +455,10 @@ const zfchar *ZFSerializableData::attributeForName(ZF_IN const zfchar *name) con
 {
     if(name != zfnull)
     {
-        _ZFP_ZFSerializableDataAttributeMapType::iterator it = d->attributes.find(name);
+        _ZFP_ZFSerializableDataAttributeMapType::iterator it = _ZFP_ZFSerializableDataAttributeFind(d->attributes, name);
         if(it != d->attributes.end())
         {
-            return it->second.attrValue.c_str();
+            return it->second.attrValue.cString();
         }
     }
     return zfnull;
@@ -417,9 +470,10 @@ zfindex ZFSerializableData::attributeCount(void) const
 }
 void ZFSerializableData::attributeRemove(ZF_IN const zfchar *name)
 {
-    if(name != zfnull)
+    _ZFP_ZFSerializableDataAttributeMapType::iterator it = _ZFP_ZFSerializableDataAttributeFind(d->attributes, name);
+    if(it != d->attributes.end())
     {
-        d->attributes.erase(name);
+        d->attributes.erase(it);
     }
 }
 void ZFSerializableData::attributeRemoveAll(void)
@@ -427,28 +481,13 @@ void ZFSerializableData::attributeRemoveAll(void)
     d->attributes.clear();
 }
 
-static void _ZFP_ZFSerializableData_iteratorDeleteCallback(void *data)
-{
-    zfdelete(ZFCastStatic(_ZFP_ZFSerializableDataAttributeMapType::iterator *, data));
-}
-static void *_ZFP_ZFSerializableData_iteratorCopyCallback(void *data)
-{
-    return zfnew(_ZFP_ZFSerializableDataAttributeMapType::iterator,
-        *ZFCastStatic(_ZFP_ZFSerializableDataAttributeMapType::iterator *, data));
-}
 zfiterator ZFSerializableData::attributeIteratorForName(ZF_IN const zfchar *name) const
 {
-    return zfiterator(
-        zfnew(_ZFP_ZFSerializableDataAttributeMapType::iterator, name ? d->attributes.find(name) : d->attributes.end()),
-        _ZFP_ZFSerializableData_iteratorDeleteCallback,
-        _ZFP_ZFSerializableData_iteratorCopyCallback);
+    return zfiterator::iteratorCreate(_ZFP_ZFSerializableDataAttributeFind(d->attributes, name));
 }
 zfiterator ZFSerializableData::attributeIterator(void) const
 {
-    return zfiterator(
-        zfnew(_ZFP_ZFSerializableDataAttributeMapType::iterator, d->attributes.begin()),
-        _ZFP_ZFSerializableData_iteratorDeleteCallback,
-        _ZFP_ZFSerializableData_iteratorCopyCallback);
+    return zfiterator::iteratorCreate(d->attributes.begin());
 }
 zfbool ZFSerializableData::attributeIteratorIsValid(ZF_IN const zfiterator &it) const
 {
@@ -487,7 +526,7 @@ const zfchar *ZFSerializableData::attributeIteratorKey(ZF_IN const zfiterator &i
     _ZFP_ZFSerializableDataAttributeMapType::iterator *data = it.data<_ZFP_ZFSerializableDataAttributeMapType::iterator *>();
     if(data != zfnull)
     {
-        return (*data)->first.c_str();
+        return (*data)->first.cString();
     }
     return zfnull;
 }
@@ -496,7 +535,7 @@ const zfchar *ZFSerializableData::attributeIteratorValue(ZF_IN const zfiterator
     _ZFP_ZFSerializableDataAttributeMapType::iterator *data = it.data<_ZFP_ZFSerializableDataAttributeMapType::iterator *>();
     if(data != zfnull)
     {
-        return (*data)->second.attrValue.c_str();
+        return (*data)->second.attrValue.cString();
     }
     return zfnull;
 }
@@ -505,7 +544,7 @@ const zfchar *ZFSerializableData::attributeIteratorNextKey(ZF_IN_OUT zfiterator
     _ZFP_ZFSerializableDataAttributeMapType::iterator *data = it.data<_ZFP_ZFSerializableDataAttributeMapType::iterator *>();
     if(data != zfnull)
     {
-        const zfchar *ret = (*data)->first.c_str();
+        const zfchar *ret = (*data)->first.cString();
         ++(*data);
         return ret;
     }
@@ -518,7 +557,7 @@ const zfchar *ZFSerializableData::attributeIteratorNextValue(ZF_IN_OUT zfiterato
     {
         _ZFP_ZFSerializableDataAttributeData &ret = (*data)->second;
         ++(*data);
-        return ret.attrValue.c_str();
+        return ret.attrValue.cString();
     }
     return zfnull;
 }
@@ -678,7 +717,7 @@ zfbool ZFSerializableData::resolvedAttribute(ZF_IN const zfchar *name) const
 {
     if(ZFSerializableDataResolveCheckEnable && name != zfnull)
     {
-        _ZFP_ZFSerializableDataAttributeMapType::iterator it = d->attributes.find(name);
+        _ZFP_ZFSerializableDataAttributeMapType::iterator it = _ZFP_ZFSerializableDataAttributeFind(d->attributes, name);
         if(it != d->attributes.end())
         {
             return it->second.resolved;
@@ -690,7 +729,7 @@ void ZFSerializableData::resolveAttributeMark(ZF_IN const zfchar *name) const
 {
     if(ZFSerializableDataResolveCheckEnable && name != zfnull)
     {
-        _ZFP_ZFSerializableDataAttributeMapType::iterator it = d->attributes.find(name);
+        _ZFP_ZFSerializableDataAttributeMapType::iterator it = _ZFP_ZFSerializableDataAttributeFind(d->attributes, name);
         if(it != d->attributes.end())
         {
             it->second.resolved = zftrue;
@@ -701,7 +740,7 @@ void ZFSerializableData::resolveAttributeUnmark(ZF_IN const zfchar *name) const
 {
     if(ZFSerializableDataResolveCheckEnable && name != zfnull)
     {
-        _ZFP_ZFSerializableDataAttributeMapType::iterator it = d->attributes.find(name);
+        _ZFP_ZFSerializableDataAttributeMapType::iterator it = _ZFP_ZFSerializableDataAttributeFind(d->attributes, name);
         if(it != d->attributes.end())
         {
             it->second.resolved = zffalse;
@@ -734,7 +773,7 @@ zfbool ZFSerializableData::resolvedAll(ZF_OUT_OPT const ZFSerializableData **fir
             }
             if(firstNotResolvedAttribute != zfnull)
             {
-                *firstNotResolvedAttribute += it->first.c_str();
+                *firstNotResolvedAttribute += it->first.cString();
             }
             return zffalse;
         }
@@ -835,7 +874,7 @@ ZFCompareResult ZFSerializableData::objectCompare(ZF_IN const ZFSerializableData
 zfbool ZFSerializableData::isEmpty(void) const
 {
     return (
-        d->classNameFull.empty()
+        d->classNameFull.isEmpty()
         && d->attributes.empty()
         && d->elements.empty()
         );
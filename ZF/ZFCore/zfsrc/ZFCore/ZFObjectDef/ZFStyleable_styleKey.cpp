@@ -4,16 +4,18 @@
 #include "ZFPropertyUtil.h"
 #include "ZFListenerDeclare.h"
 
-#include "../ZFSTLWrapper/zfstl_string.h"
 #include "../ZFSTLWrapper/zfstl_map.h"
 
 ZF_NAMESPACE_GLOBAL_BEGIN
 
+// property name and style key are identifiers, store them as atoms
+typedef zfstlmap<zfstringAtom, zfstringAtom, zfstringAtom_zfstlComparer> _ZFP_ZFStylePropertyKeyMapType;
+
 zfclassNotPOD _ZFP_ZFStyleKeyHolder
 {
 public:
     zfchar *styleKey;
-    zfstlmap<zfstlstringZ, zfstring> stylePropertyKeyMap;
+    _ZFP_ZFStylePropertyKeyMapType stylePropertyKeyMap;
 public:
     static ZFLISTENER_PROTOTYPE_EXPAND(styleOnChange);
     static ZFLISTENER_PROTOTYPE_EXPAND(stylePropertyOnChange);
@@ -153,10 +155,10 @@ void _ZFP_ZFStyleKeyHolder::stylePropertyOnChange(ZF_IN const ZFListenerData &li
     zfCoreMutexLocker();
     ZFObject *ownerObj = userData->objectHolded();
     ZFStyleable *owner = ownerObj->to<ZFStyleable *>();
-    zfstlmap<zfstlstringZ, zfstring> &m = owner->_ZFP_styleKey->stylePropertyKeyMap;
-    for(zfstlmap<zfstlstringZ, zfstring>::iterator it = m.begin(); it != m.end(); ++it)
+    _ZFP_ZFStylePropertyKeyMapType &m = owner->_ZFP_styleKey->stylePropertyKeyMap;
+    for(_ZFP_ZFStylePropertyKeyMapType::iterator it = m.begin(); it != m.end(); ++it)
     {
-        _ZFP_ZFStylePropertyCopy(ownerObj, it->first.c_str(), it->second);
+        _ZFP_ZFStylePropertyCopy(ownerObj, it->first.cString(), it->second.cString());
     }
 }
 void ZFStyleable::styleKeyForProperty(ZF_IN const zfchar *propertyName, ZF_IN const zfchar *styleKey)
@@ -170,7 +172,12 @@ void ZFStyleable::styleKeyForProperty(ZF_IN const zfchar *propertyName, ZF_IN co
     {
         if(_ZFP_styleKey != zfnull)
         {
-            _ZFP_styleKey->stylePropertyKeyMap.erase(propertyName);
+            zfstringAtom propertyNameAtom = zfstringAtomFind(propertyName);
+            if(propertyNameAtom.isNull())
+            {
+                return;
+            }
+            _ZFP_styleKey->stylePropertyKeyMap.erase(propertyNameAtom);
             if(_ZFP_styleKey->stylePropertyKeyMap.empty())
             {
                 ZFObjectGlobalEventObserver().observerRemove(
@@ -186,8 +193,9 @@ void ZFStyleable::styleKeyForProperty(ZF_IN const zfchar *propertyName, ZF_IN co
         {
             _ZFP_styleKey = zfpoolNew(_ZFP_ZFStyleKeyHolder);
         }
+        zfstringAtom propertyNameAtom = zfstringAtomFor(propertyName);
         zfbool oldEmpty = _ZFP_styleKey->stylePropertyKeyMap.empty();
-        _ZFP_styleKey->stylePropertyKeyMap[propertyName] = styleKey;
+        _ZFP_styleKey->stylePropertyKeyMap[propertyNameAtom] = zfstringAtomFor(styleKey);
         if(oldEmpty)
         {
             ZFObjectGlobalEventObserver().observerAdd(
@@ -197,7 +205,7 @@ void ZFStyleable::styleKeyForProperty(ZF_IN const zfchar *propertyName, ZF_IN co
         }
         if(!_ZFP_ZFStylePropertyCopy(this->toObject(), propertyName, styleKey))
         {
-            _ZFP_styleKey->stylePropertyKeyMap.erase(propertyName);
+            _ZFP_styleKey->stylePropertyKeyMap.erase(propertyNameAtom);
             if(_ZFP_styleKey->stylePropertyKeyMap.empty())
             {
                 ZFObjectGlobalEventObserver().observerRemove(
@@ -226,12 +234,13 @@ const zfchar *ZFStyleable::styleKeyForProperty(ZF_IN const zfchar *propertyName)
         return zfnull;
     }
     zfCoreMutexLocker();
-    if(_ZFP_styleKey != zfnull)
+    zfstringAtom propertyNameAtom = zfstringAtomFind(propertyName);
+    if(_ZFP_styleKey != zfnull && !propertyNameAtom.isNull())
     {
-        zfstlmap<zfstlstringZ, zfstring>::iterator it = _ZFP_styleKey->stylePropertyKeyMap.find(propertyName);
+        _ZFP_ZFStylePropertyKeyMapType::iterator it = _ZFP_styleKey->stylePropertyKeyMap.find(propertyNameAtom);
         if(it != _ZFP_styleKey->stylePropertyKeyMap.end())
         {
-            return it->second;
+            return it->second.cString();
         }
         else
         {
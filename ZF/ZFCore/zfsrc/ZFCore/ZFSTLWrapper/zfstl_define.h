@@ -78,6 +78,23 @@ public:
     /** @endcond */
 };
 
+/**
+ * @brief key comparer by #zfstringAtom's string content, used in STL
+ *
+ * keeps the same order as string key,
+ * while equal atoms would be compared by handle only
+ */
+zfclassNotPOD ZF_ENV_EXPORT zfstringAtom_zfstlComparer
+{
+public:
+    /** @cond ZFPrivateDoc */
+    inline zfbool operator () (const zfstringAtom &k1, const zfstringAtom &k2) const
+    {
+        return (k1.compare(k2) < 0);
+    }
+    /** @endcond */
+};
+
 // ============================================================
 /**
  * @brief key hasher by string value hash, used in STL
@@ -120,6 +137,20 @@ public:
     /** @endcond */
 };
 
+/**
+ * @brief key hasher by #zfstringAtom, used in STL
+ */
+zfclassNotPOD ZF_ENV_EXPORT zfstringAtom_zfstlHasher
+{
+public:
+    /** @cond ZFPrivateDoc */
+    zfstlsize operator () (zfstringAtom const &v) const
+    {
+        return (zfstlsize)v.hash();
+    }
+    /** @endcond */
+};
+
 /**
  * @brief key hasher by pointer value hash, used in STL
  */
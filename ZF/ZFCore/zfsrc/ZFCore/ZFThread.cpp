@@ -239,7 +239,15 @@ static ZFLISTENER_PROTOTYPE_EXPAND(_ZFP_ZFThreadCallback)
         zfsynchronizeUnlock(_ZFP_ZFThread_mutex);
     }
 
+    zfbool isNewThread = (runnableData->runnableType == _ZFP_ZFThreadRunnableTypeExecuteInNewThread);
     _ZFP_ZFThreadRunnableCleanup(runnableData);
+
+    // native thread may end or be reused by impl after this,
+    // return cached blocks here so that no impl needs to care about it
+    if(isNewThread)
+    {
+        zfpoolCacheCleanup();
+    }
 }
 static void _ZFP_ZFThreadRunnableCleanup(ZF_IN _ZFP_I_ZFThreadRunnableData *runnableData)
 {
@@ -386,6 +394,7 @@ ZFMETHOD_DEFINE_1(ZFThread, void, nativeThreadUnregister,
         zfRelease(zfThread->_ZFP_ZFThread_d->semaWaitHolder);
         zfThread->_ZFP_ZFThread_d->semaWaitHolder = zfnull;
         zfRelease(zfThread);
+        zfpoolCacheCleanup();
     }
 }
 
@@ -898,11 +907,17 @@ ZFMETHOD_FUNC_DEFINE_1(void, ZFThreadExecuteWait,
             {
                 if(runnableData->ownerZFThread != zfnull && !runnableData->ownerZFThread->isMainThread())
                 {
+                    // retain and lock before releasing the mutex,
+                    // otherwise the task may finish and release the semaphore before we wait
+                    ZFSemaphore *semaWait = zfRetain(runnableData->semaWait);
+                    semaWait->semaphoreLock();
                     if(lockAvailable)
                     {
                         zfsynchronizeUnlock(_ZFP_ZFThread_mutex);
                     }
-                    runnableData->semaWait->semaphoreWaitLocked();
+                    semaWait->semaphoreWait();
+                    semaWait->semaphoreUnlock();
+                    zfRelease(semaWait);
                     return ;
                 }
                 else
@@ -939,11 +954,17 @@ ZFMETHOD_FUNC_DEFINE_2(zfbool, ZFThreadExecuteWait,
             {
                 if(runnableData->ownerZFThread != zfnull && !runnableData->ownerZFThread->isMainThread())
                 {
+                    // see above
+                    ZFSemaphore *semaWait = zfRetain(runnableData->semaWait);
+                    semaWait->semaphoreLock();
                     if(lockAvailable)
                     {
                         zfsynchronizeUnlock(_ZFP_ZFThread_mutex);
                     }
-                    return runnableData->semaWait->semaphoreWaitLocked(miliSecs);
+                    zfbool ret = semaWait->semaphoreWait(miliSecs);
+                    semaWait->semaphoreUnlock();
+                    zfRelease(semaWait);
+                    return ret;
                 }
                 else
                 {
@@ -244,7 +244,9 @@ ZF_NAMESPACE_GLOBAL_END
 #endif // #ifndef _ZFI_ZFThread_h_
 
 #include "ZFThread_execute.h"
+#include "ZFThread_future.h"
 #include "ZFThread_observerNotifyInMainThread.h"
+#include "ZFThread_parallel.h"
 #include "ZFThread_taskRequest.h"
 #include "ZFThread_zfautoRelease.h"
 
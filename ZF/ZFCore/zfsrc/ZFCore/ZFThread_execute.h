@@ -47,6 +47,10 @@ ZFMETHOD_FUNC_INLINE_DECLARE_4(zfidentity, ZFThreadExecuteInMainThreadWaitUntilD
  * @note always try this method first to achieve thread processing,
  *   instead of create new ZFThread instance,
  *   since we may have thread pool for performance
+ * @note the thread pool may have limited workers
+ *   (the default impl keeps at most 16 workers per CPU, and at least 256),
+ *   further tasks would be queued until any running task finished,
+ *   so never start more tasks than that, which block and wait for each other
  */
 ZFMETHOD_FUNC_DECLARE_4(zfidentity, ZFThreadExecuteInNewThread,
                         ZFMP_IN(const ZFListener &, runnable),
@@ -0,0 +1,549 @@
+#include "ZFThread_future.h"
+#include "ZFSemaphore.h"
+#include "ZFTime.h"
+
+ZF_NAMESPACE_GLOBAL_BEGIN
+
+ZFENUM_DEFINE(ZFFutureState)
+ZFENUM_DEFINE(ZFFutureExecutor)
+
+// ============================================================
+// one lock shared by all futures, so settling or chaining never allocates a ZFSemaphore
+// created on first use, so that ZFSemaphore impl is not required during init,
+// null if no ZFSemaphore impl available, futureWait would fail in this case
+static ZFSemaphore *_ZFP_ZFFuture_sema = zfnull;
+// 0: not created yet, 1: created, unavailable or cleaned up
+static zfatomicint _ZFP_ZFFuture_semaState = 1;
+static ZFSemaphore *_ZFP_ZFFuture_semaAccess(void)
+{
+    if(zfAtomicLoad(_ZFP_ZFFuture_semaState) == 0)
+    {
+        zfbool available = ZFProtocolIsAvailable("ZFSemaphore");
+        zfCoreMutexLocker();
+        if(zfAtomicLoad(_ZFP_ZFFuture_semaState) == 0)
+        {
+            if(available)
+            {
+                _ZFP_ZFFuture_sema = zflockfree_zfAlloc(ZFSemaphore);
+            }
+            zfAtomicStore(_ZFP_ZFFuture_semaState, 1);
+        }
+    }
+    return _ZFP_ZFFuture_sema;
+}
+ZF_GLOBAL_INITIALIZER_INIT_WITH_LEVEL(ZFFutureDataHolder, ZFLevelZFFrameworkEssential)
+{
+    zfAtomicStore(_ZFP_ZFFuture_semaState, 0);
+}
+ZF_GLOBAL_INITIALIZER_DESTROY(ZFFutureDataHolder)
+{
+    ZFSemaphore *sema = zfnull;
+    {
+        zfCoreMutexLocker();
+        sema = _ZFP_ZFFuture_sema;
+        _ZFP_ZFFuture_sema = zfnull;
+        zfAtomicStore(_ZFP_ZFFuture_semaState, 1);
+    }
+    zfRelease(sema);
+}
+ZF_GLOBAL_INITIALIZER_END(ZFFutureDataHolder)
+
+zfclassNotPOD _ZFP_ZFFutureLocker
+{
+public:
+    ZFSemaphore *sema;
+
+public:
+    _ZFP_ZFFutureLocker(void)
+    : sema(_ZFP_ZFFuture_semaAccess())
+    {
+        if(this->sema != zfnull)
+        {
+            this->sema->semaphoreLock();
+        }
+    }
+    ~_ZFP_ZFFutureLocker(void)
+    {
+        if(this->sema != zfnull)
+        {
+            this->sema->semaphoreUnlock();
+        }
+    }
+};
+
+// ============================================================
+typedef enum {
+    _ZFP_ZFFutureTaskTypeExecute, // callback settles target
+    _ZFP_ZFFutureTaskTypeThen, // callback settles target when source resolved
+    _ZFP_ZFFutureTaskTypeOnDone, // callback observes source
+    _ZFP_ZFFutureTaskTypeForward, // target follows source
+    _ZFP_ZFFutureTaskTypeWhenAll, // userData is _ZFP_I_ZFFutureWhenAllData
+    _ZFP_ZFFutureTaskTypeWhenAny,
+} _ZFP_ZFFutureTaskType;
+zfclass _ZFP_I_ZFFutureTask : zfextends ZFObject
+{
+    ZFOBJECT_DECLARE_WITH_CUSTOM_CTOR(_ZFP_I_ZFFutureTask, ZFObject)
+
+public:
+    _ZFP_ZFFutureTaskType taskType;
+    ZFFutureExecutorEnum executor;
+    ZFListener callback;
+    ZFObject *userData; // auto-retain
+    ZFFuture *source; // auto-retain, set only when dispatched, to prevent retain cycle
+    ZFFuture *target; // auto-retain
+    zfindex index; // index in ZFFutureWhenAll
+
+protected:
+    zfoverride
+    virtual void objectOnDealloc(void)
+    {
+        zfRelease(this->userData);
+        zfRelease(this->source);
+        zfRelease(this->target);
+        zfsuper::objectOnDealloc();
+    }
+
+protected:
+    _ZFP_I_ZFFutureTask(void)
+    : taskType(_ZFP_ZFFutureTaskTypeExecute)
+    , executor(ZFFutureExecutor::e_Inline)
+    , callback()
+    , userData(zfnull)
+    , source(zfnull)
+    , target(zfnull)
+    , index(zfindexMax())
+    {
+    }
+};
+
+zfclass _ZFP_I_ZFFutureWhenAllData : zfextends ZFObject
+{
+    ZFOBJECT_DECLARE(_ZFP_I_ZFFutureWhenAllData, ZFObject)
+
+public:
+    // guarded by future lock
+    ZFCoreArrayPOD<ZFObject *> results; // auto-retain
+    zfindex remain;
+
+protected:
+    zfoverride
+    virtual void objectOnDealloc(void)
+    {
+        for(zfindex i = 0; i < this->results.count(); ++i)
+        {
+            zfRelease(this->results[i]);
+        }
+        zfsuper::objectOnDealloc();
+    }
+};
+
+static _ZFP_I_ZFFutureTask *_ZFP_ZFFutureTaskCreate(ZF_IN _ZFP_ZFFutureTaskType taskType,
+                                                    ZF_IN ZFFutureExecutorEnum executor,
+                                                    ZF_IN ZFFuture *target,
+                                                    ZF_IN_OPT const ZFListener &callback = ZFCallbackNull(),
+                                                    ZF_IN_OPT ZFObject *userData = zfnull)
+{
+    _ZFP_I_ZFFutureTask *task = zfAlloc(_ZFP_I_ZFFutureTask);
+    task->taskType = taskType;
+    task->executor = executor;
+    task->callback = callback;
+    task->userData = zfRetain(userData);
+    task->target = zfRetain(target);
+    return task;
+}
+
+// ============================================================
+static void _ZFP_ZFFutureTaskDispatch(ZF_IN _ZFP_I_ZFFutureTask *task, ZF_IN ZFFuture *source);
+static zfbool _ZFP_ZFFutureSettle(ZF_IN ZFFuture *future,
+                                  ZF_IN ZFFutureStateEnum state,
+                                  ZF_IN ZFObject *value)
+{
+    ZFCoreArrayPOD<ZFObject *> tasks;
+    {
+        _ZFP_ZFFutureLocker locker;
+        if(future->_ZFP_state != ZFFutureState::e_Pending)
+        {
+            return zffalse;
+        }
+        future->_ZFP_state = state;
+        future->_ZFP_value = zfRetain(value);
+        tasks.addFrom(future->_ZFP_tasks);
+        future->_ZFP_tasks.removeAll();
+        if(future->_ZFP_waiterCount > 0 && locker.sema != zfnull)
+        {
+            locker.sema->semaphoreBroadcast();
+        }
+    }
+    if(!tasks.isEmpty())
+    {
+        zfRetain(future);
+        for(zfindex i = 0; i < tasks.count(); ++i)
+        {
+            _ZFP_ZFFutureTaskDispatch(ZFCastZFObjectUnchecked(_ZFP_I_ZFFutureTask *, tasks[i]), future);
+            zfRelease(tasks[i]);
+        }
+        zfRelease(future);
+    }
+    return zftrue;
+}
+// settle by null result if the callback neither settled nor bound the future
+static void _ZFP_ZFFutureAutoResolve(ZF_IN ZFFuture *future)
+{
+    {
+        _ZFP_ZFFutureLocker locker;
+        if(future->_ZFP_state != ZFFutureState::e_Pending || future->_ZFP_bound)
+        {
+            return ;
+        }
+    }
+    _ZFP_ZFFutureSettle(future, ZFFutureState::e_Resolved, zfnull);
+}
+
+static void _ZFP_ZFFutureTaskRun(ZF_IN _ZFP_I_ZFFutureTask *task)
+{
+    // source's state and value never change once done, safe to access without lock
+    ZFFuture *source = task->source;
+    ZFFuture *target = task->target;
+    switch(task->taskType)
+    {
+        case _ZFP_ZFFutureTaskTypeExecute:
+            if(!target->futureIsDone())
+            {
+                task->callback.execute(ZFListenerData().param0(target), task->userData);
+                _ZFP_ZFFutureAutoResolve(target);
+            }
+            break;
+        case _ZFP_ZFFutureTaskTypeThen:
+            if(source->_ZFP_state == ZFFutureState::e_Resolved)
+            {
+                if(!target->futureIsDone())
+                {
+                    task->callback.execute(ZFListenerData().param0(target).param1(source), task->userData);
+                    _ZFP_ZFFutureAutoResolve(target);
+                }
+            }
+            else
+            {
+                _ZFP_ZFFutureSettle(target, source->_ZFP_state, source->_ZFP_value);
+            }
+            break;
+        case _ZFP_ZFFutureTaskTypeOnDone:
+            task->callback.execute(ZFListenerData().param0(source), task->userData);
+            break;
+        case _ZFP_ZFFutureTaskTypeForward:
+            _ZFP_ZFFutureSettle(target, source->_ZFP_state, source->_ZFP_value);
+            break;
+        case _ZFP_ZFFutureTaskTypeWhenAll:
+            if(source->_ZFP_state == ZFFutureState::e_Resolved)
+            {
+                _ZFP_I_ZFFutureWhenAllData *d = ZFCastZFObjectUnchecked(_ZFP_I_ZFFutureWhenAllData *, task->userData);
+                zfbool allDone = zffalse;
+                {
+                    _ZFP_ZFFutureLocker locker;
+                    d->results[task->index] = zfRetain(source->_ZFP_value != zfnull ? source->_ZFP_value : zfnullObject());
+                    --(d->remain);
+                    allDone = (d->remain == 0);
+                }
+                if(allDone)
+                {
+                    zfblockedAlloc(ZFArrayEditable, results);
+                    for(zfindex i = 0; i < d->results.count(); ++i)
+                    {
+                        results->add(d->results[i]);
+                    }
+                    _ZFP_ZFFutureSettle(target, ZFFutureState::e_Resolved, results);
+                }
+            }
+            else
+            {
+                _ZFP_ZFFutureSettle(target, source->_ZFP_state, source->_ZFP_value);
+            }
+            break;
+        case _ZFP_ZFFutureTaskTypeWhenAny:
+            _ZFP_ZFFutureSettle(target, ZFFutureState::e_Resolved, source);
+            break;
+        default:
+            zfCoreCriticalShouldNotGoHere();
+            break;
+    }
+}
+static ZFLISTENER_PROTOTYPE_EXPAND(_ZFP_ZFFutureTaskRunner)
+{
+    _ZFP_ZFFutureTaskRun(ZFCastZFObjectUnchecked(_ZFP_I_ZFFutureTask *, userData));
+}
+static void _ZFP_ZFFutureTaskDispatch(ZF_IN _ZFP_I_ZFFutureTask *task, ZF_IN ZFFuture *source)
+{
+    if(source != zfnull)
+    {
+        zfRetain(source);
+        zfRelease(task->source);
+        task->source = source;
+    }
+    zfidentity taskId = zfidentityInvalid();
+    switch(task->executor)
+    {
+        case ZFFutureExecutor::e_NewThread:
+            taskId = ZFThreadExecuteInNewThread(ZFCallbackForFunc(_ZFP_ZFFutureTaskRunner), task);
+            break;
+        case ZFFutureExecutor::e_MainThread:
+            taskId = ZFThreadExecuteInMainThread(ZFCallbackForFunc(_ZFP_ZFFutureTaskRunner), task);
+            break;
+        case ZFFutureExecutor::e_Inline:
+        default:
+            break;
+    }
+    if(taskId == zfidentityInvalid())
+    {
+        _ZFP_ZFFutureTaskRun(task);
+    }
+}
+static void _ZFP_ZFFutureTaskAdd(ZF_IN ZFFuture *source, ZF_IN _ZFP_I_ZFFutureTask *task)
+{
+    {
+        _ZFP_ZFFutureLocker locker;
+        if(source->_ZFP_state == ZFFutureState::e_Pending)
+        {
+            source->_ZFP_tasks.add(zfRetain(task));
+            return ;
+        }
+    }
+    _ZFP_ZFFutureTaskDispatch(task, source);
+}
+
+// ============================================================
+ZFOBJECT_REGISTER(ZFFuture)
+
+void ZFFuture::objectOnInit(void)
+{
+    zfsuper::objectOnInit();
+    this->_ZFP_state = ZFFutureState::e_Pending;
+    this->_ZFP_value = zfnull;
+    this->_ZFP_bound = zffalse;
+    this->_ZFP_waiterCount = 0;
+}
+void ZFFuture::objectOnDealloc(void)
+{
+    // nothing can settle this future anymore,
+    // futures that depend on it would never be done unless canceled
+    for(zfindex i = 0; i < this->_ZFP_tasks.count(); ++i)
+    {
+        _ZFP_I_ZFFutureTask *task = ZFCastZFObjectUnchecked(_ZFP_I_ZFFutureTask *, this->_ZFP_tasks[i]);
+        switch(task->taskType)
+        {
+            case _ZFP_ZFFutureTaskTypeThen:
+            case _ZFP_ZFFutureTaskTypeForward:
+            case _ZFP_ZFFutureTaskTypeWhenAll:
+                _ZFP_ZFFutureSettle(task->target, ZFFutureState::e_Canceled, zfnull);
+                break;
+            default:
+                break;
+        }
+        zfRelease(task);
+    }
+    this->_ZFP_tasks.removeAll();
+    zfRelease(this->_ZFP_value);
+    this->_ZFP_value = zfnull;
+    zfsuper::objectOnDealloc();
+}
+
+void ZFFuture::objectInfoOnAppend(ZF_IN_OUT zfstring &ret)
+{
+    zfsuper::objectInfoOnAppend(ret);
+    ret += " ";
+    ret += ZFFutureState::EnumNameForValue(this->futureState());
+}
+
+ZFMETHOD_DEFINE_0(ZFFuture, ZFFutureStateEnum, futureState)
+{
+    _ZFP_ZFFutureLocker locker;
+    return this->_ZFP_state;
+}
+ZFMETHOD_DEFINE_0(ZFFuture, zfbool, futureIsDone)
+{
+    return (this->futureState() != ZFFutureState::e_Pending);
+}
+ZFMETHOD_DEFINE_0(ZFFuture, ZFObject *, futureResult)
+{
+    _ZFP_ZFFutureLocker locker;
+    return (this->_ZFP_state == ZFFutureState::e_Resolved ? this->_ZFP_value : zfnull);
+}
+ZFMETHOD_DEFINE_0(ZFFuture, ZFObject *, futureError)
+{
+    _ZFP_ZFFutureLocker locker;
+    return (this->_ZFP_state == ZFFutureState::e_Rejected ? this->_ZFP_value : zfnull);
+}
+
+ZFMETHOD_DEFINE_1(ZFFuture, zfbool, futureResolve,
+                  ZFMP_IN_OPT(ZFObject *, result, zfnull))
+{
+    return _ZFP_ZFFutureSettle(this, ZFFutureState::e_Resolved, result);
+}
+ZFMETHOD_DEFINE_1(ZFFuture, zfbool, futureReject,
+                  ZFMP_IN_OPT(ZFObject *, error, zfnull))
+{
+    return _ZFP_ZFFutureSettle(this, ZFFutureState::e_Rejected, error);
+}
+ZFMETHOD_DEFINE_0(ZFFuture, zfbool, futureCancel)
+{
+    return _ZFP_ZFFutureSettle(this, ZFFutureState::e_Canceled, zfnull);
+}
+ZFMETHOD_DEFINE_1(ZFFuture, void, futureResolveBy,
+                  ZFMP_IN(ZFFuture *, another))
+{
+    if(another == zfnull || another == this)
+    {
+        return ;
+    }
+    {
+        _ZFP_ZFFutureLocker locker;
+        if(this->_ZFP_state != ZFFutureState::e_Pending || this->_ZFP_bound)
+        {
+            return ;
+        }
+        this->_ZFP_bound = zftrue;
+    }
+    _ZFP_I_ZFFutureTask *task = _ZFP_ZFFutureTaskCreate(_ZFP_ZFFutureTaskTypeForward, ZFFutureExecutor::e_Inline, this);
+    _ZFP_ZFFutureTaskAdd(another, task);
+    zfRelease(task);
+}
+
+static zfbool _ZFP_ZFFutureWait(ZF_IN ZFFuture *future, ZF_IN zftimet miliSecs)
+{
+    _ZFP_ZFFutureLocker locker;
+    if(future->_ZFP_state != ZFFutureState::e_Pending)
+    {
+        return zftrue;
+    }
+    if(locker.sema == zfnull)
+    {
+        return zffalse;
+    }
+    zftimet timeEnd = (zftimet)(ZFTime::timestamp() + miliSecs);
+    ++(future->_ZFP_waiterCount);
+    while(future->_ZFP_state == ZFFutureState::e_Pending)
+    {
+        if(miliSecs < 0)
+        {
+            locker.sema->semaphoreWait();
+        }
+        else
+        {
+            zftimet remain = (zftimet)(timeEnd - ZFTime::timestamp());
+            if(remain <= 0)
+            {
+                break;
+            }
+            locker.sema->semaphoreWait(remain);
+        }
+    }
+    --(future->_ZFP_waiterCount);
+    return (future->_ZFP_state != ZFFutureState::e_Pending);
+}
+ZFMETHOD_DEFINE_0(ZFFuture, void, futureWait)
+{
+    _ZFP_ZFFutureWait(this, -1);
+}
+ZFMETHOD_DEFINE_1(ZFFuture, zfbool, futureWait,
+                  ZFMP_IN(zftimet, miliSecs))
+{
+    return _ZFP_ZFFutureWait(this, zfmMax((zftimet)0, miliSecs));
+}
+
+ZFMETHOD_DEFINE_3(ZFFuture, zfautoObject, futureThen,
+                  ZFMP_IN(const ZFListener &, callback),
+                  ZFMP_IN_OPT(ZFFutureExecutorEnum, executor, ZFFutureExecutor::e_Inline),
+                  ZFMP_IN_OPT(ZFObject *, userData, zfnull))
+{
+    zfblockedAlloc(ZFFuture, ret);
+    if(callback.callbackIsValid())
+    {
+        _ZFP_I_ZFFutureTask *task = _ZFP_ZFFutureTaskCreate(_ZFP_ZFFutureTaskTypeThen, executor, ret, callback, userData);
+        _ZFP_ZFFutureTaskAdd(this, task);
+        zfRelease(task);
+    }
+    else
+    {
+        ret->futureResolveBy(this);
+    }
+    return ret;
+}
+ZFMETHOD_DEFINE_3(ZFFuture, void, futureOnDone,
+                  ZFMP_IN(const ZFListener &, callback),
+                  ZFMP_IN_OPT(ZFFutureExecutorEnum, executor, ZFFutureExecutor::e_Inline),
+                  ZFMP_IN_OPT(ZFObject *, userData, zfnull))
+{
+    if(callback.callbackIsValid())
+    {
+        _ZFP_I_ZFFutureTask *task = _ZFP_ZFFutureTaskCreate(_ZFP_ZFFutureTaskTypeOnDone, executor, zfnull, callback, userData);
+        _ZFP_ZFFutureTaskAdd(this, task);
+        zfRelease(task);
+    }
+}
+
+// ============================================================
+ZFMETHOD_FUNC_DEFINE_3(zfautoObject, ZFFutureExecute,
+                       ZFMP_IN(const ZFListener &, runnable),
+                       ZFMP_IN_OPT(ZFFutureExecutorEnum, executor, ZFFutureExecutor::e_NewThread),
+                       ZFMP_IN_OPT(ZFObject *, userData, zfnull))
+{
+    zfblockedAlloc(ZFFuture, ret);
+    if(runnable.callbackIsValid())
+    {
+        _ZFP_I_ZFFutureTask *task = _ZFP_ZFFutureTaskCreate(_ZFP_ZFFutureTaskTypeExecute, executor, ret, runnable, userData);
+        _ZFP_ZFFutureTaskDispatch(task, zfnull);
+        zfRelease(task);
+    }
+    else
+    {
+        ret->futureResolve();
+    }
+    return ret;
+}
+
+ZFMETHOD_FUNC_DEFINE_1(zfautoObject, ZFFutureWhenAll,
+                       ZFMP_IN(ZFArray *, futures))
+{
+    zfblockedAlloc(ZFFuture, ret);
+    zfindex count = (futures != zfnull ? futures->count() : 0);
+    if(count == 0)
+    {
+        zfblockedAlloc(ZFArrayEditable, results);
+        ret->futureResolve(results);
+        return ret;
+    }
+    zfblockedAlloc(_ZFP_I_ZFFutureWhenAllData, d);
+    d->results.capacity(count);
+    for(zfindex i = 0; i < count; ++i)
+    {
+        d->results.add(zfnull);
+    }
+    d->remain = count;
+    for(zfindex i = 0; i < count; ++i)
+    {
+        _ZFP_I_ZFFutureTask *task = _ZFP_ZFFutureTaskCreate(_ZFP_ZFFutureTaskTypeWhenAll, ZFFutureExecutor::e_Inline, ret, ZFCallbackNull(), d);
+        task->index = i;
+        _ZFP_ZFFutureTaskAdd(futures->get<ZFFuture *>(i), task);
+        zfRelease(task);
+    }
+    return ret;
+}
+ZFMETHOD_FUNC_DEFINE_1(zfautoObject, ZFFutureWhenAny,
+                       ZFMP_IN(ZFArray *, futures))
+{
+    zfblockedAlloc(ZFFuture, ret);
+    zfindex count = (futures != zfnull ? futures->count() : 0);
+    if(count == 0)
+    {
+        ret->futureResolve();
+        return ret;
+    }
+    for(zfindex i = 0; i < count && !ret->futureIsDone(); ++i)
+    {
+        _ZFP_I_ZFFutureTask *task = _ZFP_ZFFutureTaskCreate(_ZFP_ZFFutureTaskTypeWhenAny, ZFFutureExecutor::e_Inline, ret);
+        _ZFP_ZFFutureTaskAdd(futures->get<ZFFuture *>(i), task);
+        zfRelease(task);
+    }
+    return ret;
+}
+
+ZF_NAMESPACE_GLOBAL_END
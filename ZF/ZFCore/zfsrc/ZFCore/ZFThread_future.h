@@ -0,0 +1,249 @@
+/**
+ * @file ZFThread_future.h
+ * @brief thread utility
+ */
+
+#ifndef _ZFI_ZFThread_future_h_
+#define _ZFI_ZFThread_future_h_
+
+#include "ZFThread.h"
+#include "ZFArray.h"
+ZF_NAMESPACE_GLOBAL_BEGIN
+
+// ============================================================
+/**
+ * @brief state of #ZFFuture
+ */
+ZFENUM_BEGIN(ZFFutureState)
+    ZFENUM_VALUE(Pending) /**< @brief not done yet */
+    ZFENUM_VALUE(Resolved) /**< @brief done with #ZFFuture::futureResult */
+    ZFENUM_VALUE(Rejected) /**< @brief done with #ZFFuture::futureError */
+    ZFENUM_VALUE(Canceled) /**< @brief canceled by #ZFFuture::futureCancel */
+ZFENUM_SEPARATOR(ZFFutureState)
+    ZFENUM_VALUE_REGISTER(Pending)
+    ZFENUM_VALUE_REGISTER(Resolved)
+    ZFENUM_VALUE_REGISTER(Rejected)
+    ZFENUM_VALUE_REGISTER(Canceled)
+ZFENUM_END(ZFFutureState)
+
+/**
+ * @brief where to run callbacks of #ZFFuture
+ */
+ZFENUM_BEGIN(ZFFutureExecutor)
+    /**
+     * @brief run in the thread that settles the future,
+     *   or the thread that adds the callback if already settled
+     */
+    ZFENUM_VALUE(Inline)
+    ZFENUM_VALUE(NewThread) /**< @brief run by #ZFThreadExecuteInNewThread */
+    ZFENUM_VALUE(MainThread) /**< @brief run by #ZFThreadExecuteInMainThread */
+ZFENUM_SEPARATOR(ZFFutureExecutor)
+    ZFENUM_VALUE_REGISTER(Inline)
+    ZFENUM_VALUE_REGISTER(NewThread)
+    ZFENUM_VALUE_REGISTER(MainThread)
+ZFENUM_END(ZFFutureExecutor)
+
+// ============================================================
+/**
+ * @brief result of an async task, which can be chained without blocking threads
+ *
+ * a future starts as #ZFFutureState::e_Pending,
+ * and can be settled only once by #futureResolve, #futureReject or #futureCancel,
+ * any of them can be called from any thread,
+ * the one that settles the future is also the promise side of it\n
+ * \n
+ * typical usage:
+ * @code
+ *   ZFLISTENER_LOCAL(load, {
+ *       ZFFuture *future = listenerData.param0<ZFFuture *>();
+ *       // load in new thread
+ *       future->futureResolve(loadedData);
+ *   })
+ *   ZFLISTENER_LOCAL(parse, {
+ *       ZFFuture *future = listenerData.param0<ZFFuture *>();
+ *       ZFFuture *loaded = listenerData.param1<ZFFuture *>();
+ *       future->futureResolve(parse(loaded->futureResult()));
+ *   })
+ *   ZFLISTENER_LOCAL(show, {
+ *       ZFFuture *parsed = listenerData.param0<ZFFuture *>();
+ *       // show in main thread
+ *   })
+ *   ZFFutureExecute(load)
+ *       .to<ZFFuture *>()->futureThen(parse, ZFFutureExecutor::e_NewThread)
+ *       .to<ZFFuture *>()->futureOnDone(show, ZFFutureExecutor::e_MainThread);
+ * @endcode
+ *
+ * futures never block unless #futureWait is called,
+ * and a pending future with callbacks would be kept alive
+ * only by the ones that may settle it
+ */
+zfclass ZF_ENV_EXPORT ZFFuture : zfextends ZFObject
+{
+    ZFOBJECT_DECLARE(ZFFuture, ZFObject)
+
+public:
+    /**
+     * @brief current state
+     */
+    ZFMETHOD_DECLARE_0(ZFFutureStateEnum, futureState)
+    /**
+     * @brief whether state is not #ZFFutureState::e_Pending
+     */
+    ZFMETHOD_DECLARE_0(zfbool, futureIsDone)
+    /**
+     * @brief result passed to #futureResolve, or null if not resolved
+     */
+    ZFMETHOD_DECLARE_0(ZFObject *, futureResult)
+    /**
+     * @brief error passed to #futureReject, or null if not rejected
+     */
+    ZFMETHOD_DECLARE_0(ZFObject *, futureError)
+
+public:
+    /**
+     * @brief settle as #ZFFutureState::e_Resolved,
+     *   return false if already settled
+     *
+     * result would be retained until the future deallocated
+     */
+    ZFMETHOD_DECLARE_1(zfbool, futureResolve,
+                       ZFMP_IN_OPT(ZFObject *, result, zfnull))
+    /**
+     * @brief settle as #ZFFutureState::e_Rejected,
+     *   return false if already settled
+     */
+    ZFMETHOD_DECLARE_1(zfbool, futureReject,
+                       ZFMP_IN_OPT(ZFObject *, error, zfnull))
+    /**
+     * @brief settle as #ZFFutureState::e_Canceled,
+     *   return false if already settled
+     *
+     * canceled future would be passed to all of futures that chained by #futureThen,
+     * and pending task that should settle this future would be skipped,
+     * running task would not be interrupted,
+     * check #futureIsDone to stop it earlier
+     */
+    ZFMETHOD_DECLARE_0(zfbool, futureCancel)
+    /**
+     * @brief settle to the same state of another future when it's done
+     *
+     * useful to settle a future by another async task,
+     * see #futureThen
+     */
+    ZFMETHOD_DECLARE_1(void, futureResolveBy,
+                       ZFMP_IN(ZFFuture *, another))
+
+public:
+    /**
+     * @brief block current thread until done, see #futureWait
+     */
+    ZFMETHOD_DECLARE_0(void, futureWait)
+    /**
+     * @brief block current thread until done or timeout,
+     *   return whether done
+     *
+     * never wait in main thread for a callback that would be run by #ZFFutureExecutor::e_MainThread\n
+     * waiting requires ZFSemaphore impl,
+     * if not available, return false immediately if not done
+     */
+    ZFMETHOD_DECLARE_1(zfbool, futureWait,
+                       ZFMP_IN(zftimet, miliSecs))
+
+public:
+    /**
+     * @brief chain a callback that would be called when this future is resolved,
+     *   return a new #ZFFuture that would be settled by the callback
+     *
+     * callback's param0 is the new future,
+     * param1 is this future,
+     * and userData is the userData passed to this method\n
+     * \n
+     * callback should settle the new future,
+     * or pass it to #futureResolveBy to settle it by another async task,
+     * otherwise it would be resolved with null result after callback returned\n
+     * \n
+     * if this future is rejected or canceled,
+     * the callback would not be called,
+     * and the new future would be rejected with the same error or canceled\n
+     * if the new future has been canceled before the callback called,
+     * the callback would be skipped
+     */
+    ZFMETHOD_DECLARE_3(zfautoObject, futureThen,
+                       ZFMP_IN(const ZFListener &, callback),
+                       ZFMP_IN_OPT(ZFFutureExecutorEnum, executor, ZFFutureExecutor::e_Inline),
+                       ZFMP_IN_OPT(ZFObject *, userData, zfnull))
+    /**
+     * @brief add a callback that would be called when this future is done,
+     *   no matter which state it is
+     *
+     * callback's param0 is this future,
+     * and userData is the userData passed to this method
+     */
+    ZFMETHOD_DECLARE_3(void, futureOnDone,
+                       ZFMP_IN(const ZFListener &, callback),
+                       ZFMP_IN_OPT(ZFFutureExecutorEnum, executor, ZFFutureExecutor::e_Inline),
+                       ZFMP_IN_OPT(ZFObject *, userData, zfnull))
+
+protected:
+    zfoverride
+    virtual void objectOnInit(void);
+    zfoverride
+    virtual void objectOnDealloc(void);
+
+protected:
+    zfoverride
+    virtual void objectInfoOnAppend(ZF_IN_OUT zfstring &ret);
+
+    /** @cond ZFPrivateDoc */
+public:
+    ZFFutureStateEnum _ZFP_state;
+    ZFObject *_ZFP_value; // result or error, auto-retain
+    zfbool _ZFP_bound; // settled by futureResolveBy
+    zfindex _ZFP_waiterCount;
+    ZFCoreArrayPOD<ZFObject *> _ZFP_tasks; // auto-retain
+    /** @endcond */
+};
+
+// ============================================================
+/**
+ * @brief run runnable by executor, and return a #ZFFuture for its result
+ *
+ * runnable's param0 is the future to settle,
+ * and userData is the userData passed to this method\n
+ * \n
+ * runnable should settle the future,
+ * or pass it to #ZFFuture::futureResolveBy to settle it by another async task,
+ * otherwise it would be resolved with null result after runnable returned\n
+ * \n
+ * if the future is canceled before runnable started, the runnable would be skipped
+ */
+ZFMETHOD_FUNC_DECLARE_3(zfautoObject, ZFFutureExecute,
+                        ZFMP_IN(const ZFListener &, runnable),
+                        ZFMP_IN_OPT(ZFFutureExecutorEnum, executor, ZFFutureExecutor::e_NewThread),
+                        ZFMP_IN_OPT(ZFObject *, userData, zfnull))
+/**
+ * @brief return a #ZFFuture that would be resolved when all of futures resolved
+ *
+ * futures must contain #ZFFuture only,
+ * the result is a #ZFArray that contains each future's result in the same order,
+ * null result would be stored as #zfnullObject\n
+ * \n
+ * the returned future would be rejected or canceled
+ * as soon as any of futures is rejected or canceled,
+ * or resolved immediately if futures is null or empty
+ */
+ZFMETHOD_FUNC_DECLARE_1(zfautoObject, ZFFutureWhenAll,
+                        ZFMP_IN(ZFArray *, futures))
+/**
+ * @brief return a #ZFFuture that would be resolved when any of futures is done
+ *
+ * futures must contain #ZFFuture only,
+ * the result is the first future that is done, no matter which state it is,
+ * or null if futures is null or empty
+ */
+ZFMETHOD_FUNC_DECLARE_1(zfautoObject, ZFFutureWhenAny,
+                        ZFMP_IN(ZFArray *, futures))
+
+ZF_NAMESPACE_GLOBAL_END
+#endif // #ifndef _ZFI_ZFThread_future_h_
+
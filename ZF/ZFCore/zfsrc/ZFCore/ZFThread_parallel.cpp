@@ -0,0 +1,369 @@
+#include "ZFThread_parallel.h"
+#include "protocol/ZFProtocolZFThread.h"
+#include "ZFSemaphore.h"
+
+ZF_NAMESPACE_GLOBAL_BEGIN
+
+ZFOBJECT_REGISTER(ZFThreadParallelData)
+
+// ============================================================
+/*
+ * each participant owns a slot of index range,
+ * owner takes grainSize from slot's begin,
+ * thieves take half of the remaining from slot's end
+ */
+zfclassPOD _ZFP_ZFThreadParallelSlot
+{
+public:
+    zfatomicint lock;
+    zfindex begin;
+    zfindex end;
+    zfbyte _pad[64]; // prevent false sharing between slots
+};
+zfclassNotPOD _ZFP_ZFThreadParallelJob
+{
+public:
+    _ZFP_ZFThreadParallelCallback callback;
+    void *userData;
+    zfindex grainSize;
+    _ZFP_ZFThreadParallelSlot *slots;
+    zfindex slotCount;
+    // guarded by semaphore lock
+    zfindex slotJoined; // slot 0 is always the caller
+    zfindex workerRunning;
+};
+
+static zfbool _ZFP_ZFThreadParallelJobHasWork(ZF_IN _ZFP_ZFThreadParallelJob *job)
+{
+    for(zfindex i = 0; i < job->slotCount; ++i)
+    {
+        _ZFP_ZFThreadParallelSlot &slot = job->slots[i];
+        zfAtomicSpinLocker(slot.lock);
+        if(slot.begin < slot.end)
+        {
+            return zftrue;
+        }
+    }
+    return zffalse;
+}
+static void _ZFP_ZFThreadParallelJobRun(ZF_IN _ZFP_ZFThreadParallelJob *job,
+                                        ZF_IN zfindex participant)
+{
+    _ZFP_ZFThreadParallelSlot &own = job->slots[participant];
+    do
+    {
+        // own range first
+        zfAtomicSpinLock(own.lock);
+        if(own.begin < own.end)
+        {
+            zfindex start = own.begin;
+            zfindex count = zfmMin(job->grainSize, own.end - own.begin);
+            own.begin += count;
+            zfAtomicSpinUnlock(own.lock);
+            job->callback(job->userData, participant, start, count);
+            continue;
+        }
+        zfAtomicSpinUnlock(own.lock);
+
+        // steal from the largest one
+        zfindex victim = zfindexMax();
+        zfindex victimRemain = 0;
+        for(zfindex i = 0; i < job->slotCount; ++i)
+        {
+            if(i == participant)
+            {
+                continue;
+            }
+            _ZFP_ZFThreadParallelSlot &slot = job->slots[i];
+            zfAtomicSpinLock(slot.lock);
+            zfindex remain = slot.end - slot.begin;
+            zfAtomicSpinUnlock(slot.lock);
+            if(remain > victimRemain)
+            {
+                victim = i;
+                victimRemain = remain;
+            }
+        }
+        if(victim == zfindexMax())
+        {
+            break;
+        }
+        _ZFP_ZFThreadParallelSlot &slot = job->slots[victim];
+        zfAtomicSpinLock(slot.lock);
+        zfindex remain = slot.end - slot.begin;
+        zfindex stealCount = (remain > job->grainSize ? remain / 2 : remain);
+        zfindex stealEnd = slot.end;
+        slot.end -= stealCount;
+        zfAtomicSpinUnlock(slot.lock);
+        if(stealCount > 0)
+        {
+            // only owner can grow its own range, so it's safe to reset here
+            zfAtomicSpinLock(own.lock);
+            own.begin = stealEnd - stealCount;
+            own.end = stealEnd;
+            zfAtomicSpinUnlock(own.lock);
+        }
+    } while(zftrue);
+}
+
+// ============================================================
+zfclassNotPOD _ZFP_ZFThreadParallelData
+{
+public:
+    ZFSemaphore *sema;
+    zfbool shutdown;
+    zfindex processorCount;
+    // guarded by sema's lock
+    zfbool workerStarted;
+    ZFCoreArrayPOD<zfidentity> workerTaskIds;
+    ZFCoreArrayPOD<_ZFP_ZFThreadParallelJob *> jobs;
+};
+// workers would access it until they exit, so not accessed by ZF_GLOBAL_INITIALIZER_INSTANCE
+static _ZFP_ZFThreadParallelData *_ZFP_ZFThreadParallel_d = zfnull;
+static ZFLISTENER_PROTOTYPE_EXPAND(_ZFP_ZFThreadParallelWorker);
+ZF_GLOBAL_INITIALIZER_INIT_WITH_LEVEL_AND_FLAGS(ZFThreadParallelDataHolder, ZFLevelZFFrameworkNormal, ZFGlobalInitializerFlagParallel)
+{
+    // run in caller thread if not available
+    if(!ZFProtocolIsAvailable("ZFThread") || !ZFProtocolIsAvailable("ZFSemaphore"))
+    {
+        return;
+    }
+    _ZFP_ZFThreadParallel_d = zfnew(_ZFP_ZFThreadParallelData);
+    _ZFP_ZFThreadParallel_d->sema = zfAlloc(ZFSemaphore);
+    _ZFP_ZFThreadParallel_d->shutdown = zffalse;
+    _ZFP_ZFThreadParallel_d->processorCount = zfmMax((zfindex)1, ZFPROTOCOL_ACCESS(ZFThread)->processorCount());
+    _ZFP_ZFThreadParallel_d->workerStarted = zffalse;
+}
+ZF_GLOBAL_INITIALIZER_DESTROY(ZFThreadParallelDataHolder)
+{
+    _ZFP_ZFThreadParallelData *d = _ZFP_ZFThreadParallel_d;
+    if(d == zfnull)
+    {
+        return;
+    }
+    d->sema->semaphoreLock();
+    d->shutdown = zftrue;
+    d->sema->semaphoreBroadcast();
+    d->sema->semaphoreUnlock();
+    for(zfindex i = 0; i < d->workerTaskIds.count(); ++i)
+    {
+        ZFThreadExecuteWait(d->workerTaskIds[i]);
+    }
+    _ZFP_ZFThreadParallel_d = zfnull;
+    zfRelease(d->sema);
+    zfdelete(d);
+}
+ZF_GLOBAL_INITIALIZER_END(ZFThreadParallelDataHolder)
+
+static ZFLISTENER_PROTOTYPE_EXPAND(_ZFP_ZFThreadParallelWorker)
+{
+    _ZFP_ZFThreadParallelData *d = _ZFP_ZFThreadParallel_d;
+    ZFSemaphore *sema = d->sema;
+    const ZFCoreArrayPOD<_ZFP_ZFThreadParallelJob *> &jobs = d->jobs;
+    sema->semaphoreLock();
+    while(!d->shutdown)
+    {
+        _ZFP_ZFThreadParallelJob *job = zfnull;
+        zfindex participant = 0;
+        for(zfindex i = 0; i < jobs.count(); ++i)
+        {
+            if(jobs[i]->slotJoined < jobs[i]->slotCount && _ZFP_ZFThreadParallelJobHasWork(jobs[i]))
+            {
+                job = jobs[i];
+                participant = job->slotJoined;
+                ++(job->slotJoined);
+                ++(job->workerRunning);
+                break;
+            }
+        }
+        if(job == zfnull)
+        {
+            sema->semaphoreWait();
+            continue;
+        }
+
+        sema->semaphoreUnlock();
+        _ZFP_ZFThreadParallelJobRun(job, participant);
+        sema->semaphoreLock();
+
+        --(job->workerRunning);
+        if(job->workerRunning == 0)
+        {
+            // notify the caller waiting for the job
+            sema->semaphoreBroadcast();
+        }
+    }
+    sema->semaphoreUnlock();
+}
+
+void _ZFP_ZFThreadParallelRun(ZF_IN zfindex start,
+                              ZF_IN zfindex count,
+                              ZF_IN zfindex grainSize,
+                              ZF_IN zfindex participantCount,
+                              ZF_IN _ZFP_ZFThreadParallelCallback callback,
+                              ZF_IN void *userData)
+{
+    if(count == 0 || count == zfindexMax())
+    {
+        return ;
+    }
+    _ZFP_ZFThreadParallelData *d = _ZFP_ZFThreadParallel_d;
+    zfindex slotCount = (d != zfnull ? zfmMin(participantCount, d->processorCount) : 1);
+    if(grainSize == 0)
+    {
+        grainSize = zfmMax((zfindex)1, count / (slotCount * 8));
+    }
+    slotCount = zfmMin(slotCount, count / grainSize + (count % grainSize != 0 ? 1 : 0));
+    if(slotCount <= 1)
+    {
+        callback(userData, 0, start, count);
+        return ;
+    }
+
+    ZFSemaphore *sema = d->sema;
+    _ZFP_ZFThreadParallelJob job;
+    job.callback = callback;
+    job.userData = userData;
+    job.grainSize = grainSize;
+    job.slots = (_ZFP_ZFThreadParallelSlot *)zfmallocZero(sizeof(_ZFP_ZFThreadParallelSlot) * slotCount);
+    job.slotCount = slotCount;
+    job.slotJoined = 1;
+    job.workerRunning = 0;
+    {
+        zfindex each = count / slotCount;
+        zfindex extra = count % slotCount;
+        zfindex pos = start;
+        for(zfindex i = 0; i < slotCount; ++i)
+        {
+            job.slots[i].begin = pos;
+            pos += each + (i < extra ? 1 : 0);
+            job.slots[i].end = pos;
+        }
+    }
+
+    sema->semaphoreLock();
+    if(!d->workerStarted)
+    {
+        // caller takes part in the job, so only (processorCount - 1) workers required
+        d->workerStarted = zftrue;
+        for(zfindex i = 1; i < d->processorCount; ++i)
+        {
+            d->workerTaskIds.add(ZFThreadExecuteInNewThread(ZFCallbackForFunc(_ZFP_ZFThreadParallelWorker)));
+        }
+    }
+    d->jobs.add(&job);
+    sema->semaphoreBroadcast();
+    sema->semaphoreUnlock();
+
+    _ZFP_ZFThreadParallelJobRun(&job, 0);
+
+    sema->semaphoreLock();
+    d->jobs.removeElement(&job);
+    while(job.workerRunning > 0)
+    {
+        sema->semaphoreWait();
+    }
+    sema->semaphoreUnlock();
+
+    zffree(job.slots);
+}
+
+// ============================================================
+ZFMETHOD_FUNC_DEFINE_0(zfindex, ZFThreadParallelConcurrency)
+{
+    return (_ZFP_ZFThreadParallel_d != zfnull ? _ZFP_ZFThreadParallel_d->processorCount : 1);
+}
+
+static void _ZFP_ZFThreadParallelForAction(ZF_IN void *userData,
+                                           ZF_IN zfindex participant,
+                                           ZF_IN zfindex start,
+                                           ZF_IN zfindex count)
+{
+    zfblockedAlloc(ZFThreadParallelData, data);
+    data->rangeStart(start);
+    data->rangeCount(count);
+    ((const ZFListener *)userData)->execute(ZFListenerData().param0(data));
+}
+ZFMETHOD_FUNC_DEFINE_4(void, ZFThreadParallelFor,
+                       ZFMP_IN(zfindex, start),
+                       ZFMP_IN(zfindex, count),
+                       ZFMP_IN(const ZFListener &, callback),
+                       ZFMP_IN_OPT(zfindex, grainSize, 0))
+{
+    if(callback.callbackIsValid())
+    {
+        _ZFP_ZFThreadParallelRun(start, count, grainSize, zfindexMax(),
+            _ZFP_ZFThreadParallelForAction, (void *)&callback);
+    }
+}
+
+zfclassNotPOD _ZFP_ZFThreadParallelReduceData
+{
+public:
+    const ZFListener *mapCallback;
+    const ZFListener *reduceCallback;
+    ZFCoreArray<zfautoObject> values;
+};
+static zfautoObject _ZFP_ZFThreadParallelReduceValue(ZF_IN const ZFListener &reduceCallback,
+                                                     ZF_IN ZFObject *v0,
+                                                     ZF_IN ZFObject *v1)
+{
+    if(v0 == zfnull)
+    {
+        return v1;
+    }
+    else if(v1 == zfnull)
+    {
+        return v0;
+    }
+    zfblockedAlloc(ZFThreadParallelData, data);
+    data->reduceValue0(v0);
+    data->reduceValue1(v1);
+    reduceCallback.execute(ZFListenerData().param0(data));
+    return data->result();
+}
+static void _ZFP_ZFThreadParallelReduceAction(ZF_IN void *userData,
+                                              ZF_IN zfindex participant,
+                                              ZF_IN zfindex start,
+                                              ZF_IN zfindex count)
+{
+    _ZFP_ZFThreadParallelReduceData *d = (_ZFP_ZFThreadParallelReduceData *)userData;
+    zfblockedAlloc(ZFThreadParallelData, data);
+    data->rangeStart(start);
+    data->rangeCount(count);
+    d->mapCallback->execute(ZFListenerData().param0(data));
+    zfautoObject &value = d->values[participant];
+    value = _ZFP_ZFThreadParallelReduceValue(*(d->reduceCallback), value, data->result());
+}
+ZFMETHOD_FUNC_DEFINE_5(zfautoObject, ZFThreadParallelReduce,
+                       ZFMP_IN(zfindex, start),
+                       ZFMP_IN(zfindex, count),
+                       ZFMP_IN(const ZFListener &, mapCallback),
+                       ZFMP_IN(const ZFListener &, reduceCallback),
+                       ZFMP_IN_OPT(zfindex, grainSize, 0))
+{
+    if(!mapCallback.callbackIsValid() || !reduceCallback.callbackIsValid())
+    {
+        return zfnull;
+    }
+    _ZFP_ZFThreadParallelReduceData d;
+    d.mapCallback = &mapCallback;
+    d.reduceCallback = &reduceCallback;
+    zfindex participantCount = ZFThreadParallelConcurrency();
+    d.values.capacity(participantCount);
+    for(zfindex i = 0; i < participantCount; ++i)
+    {
+        d.values.add(zfnull);
+    }
+    _ZFP_ZFThreadParallelRun(start, count, grainSize, participantCount,
+        _ZFP_ZFThreadParallelReduceAction, &d);
+    zfautoObject ret;
+    for(zfindex i = 0; i < participantCount; ++i)
+    {
+        ret = _ZFP_ZFThreadParallelReduceValue(reduceCallback, ret, d.values[i]);
+    }
+    return ret;
+}
+
+ZF_NAMESPACE_GLOBAL_END
+
@@ -0,0 +1,224 @@
+/**
+ * @file ZFThread_parallel.h
+ * @brief thread utility
+ */
+
+#ifndef _ZFI_ZFThread_parallel_h_
+#define _ZFI_ZFThread_parallel_h_
+
+#include "ZFThread.h"
+ZF_NAMESPACE_GLOBAL_BEGIN
+
+// ============================================================
+/** @brief see #ZFThreadParallelFor */
+zfclass ZF_ENV_EXPORT ZFThreadParallelData : zfextends ZFObject
+{
+    ZFOBJECT_DECLARE(ZFThreadParallelData, ZFObject)
+
+public:
+    /** @brief start index of the range to process, see #ZFThreadParallelFor */
+    ZFPROPERTY_ASSIGN(zfindex, rangeStart)
+    /** @brief count of the range to process, see #ZFThreadParallelFor */
+    ZFPROPERTY_ASSIGN(zfindex, rangeCount)
+    /** @brief left value to reduce, see #ZFThreadParallelReduce */
+    ZFPROPERTY_RETAIN(ZFObject *, reduceValue0)
+    /** @brief right value to reduce, see #ZFThreadParallelReduce */
+    ZFPROPERTY_RETAIN(ZFObject *, reduceValue1)
+    /** @brief result of map or reduce, see #ZFThreadParallelReduce */
+    ZFPROPERTY_RETAIN(ZFObject *, result)
+};
+
+// ============================================================
+/**
+ * @brief max number of threads that may take part in #ZFThreadParallelFor,
+ *   including the caller thread
+ *
+ * typically same as processor count,
+ * or 1 if not supported by #ZFThread's implementation
+ */
+ZFMETHOD_FUNC_DECLARE_0(zfindex, ZFThreadParallelConcurrency)
+
+/**
+ * @brief process [start, start + count) by all processors, and wait until done
+ *
+ * the index range would be split into ranges no smaller than grainSize,
+ * each range would be passed to callback as param0 (#ZFThreadParallelData),
+ * in caller thread or worker threads\n
+ * \n
+ * each worker owns a range and process it from front,
+ * and steals half of the largest remaining range from other workers when its own range is done,
+ * so uneven work load would still be spread to all workers\n
+ * \n
+ * grainSize can be 0 to decide automatically,
+ * set a larger one if each index is cheap to process\n
+ * \n
+ * callback may run concurrently in different threads,
+ * and may call #ZFThreadParallelFor recursively,
+ * the caller thread always takes part in the work,
+ * so nested calls never wait for an available worker\n
+ * \n
+ * for C++ code, use #ZFThreadParallelForT with any callable to prevent object allocation
+ */
+ZFMETHOD_FUNC_DECLARE_4(void, ZFThreadParallelFor,
+                        ZFMP_IN(zfindex, start),
+                        ZFMP_IN(zfindex, count),
+                        ZFMP_IN(const ZFListener &, callback),
+                        ZFMP_IN_OPT(zfindex, grainSize, 0))
+/**
+ * @brief map ranges of [start, start + count) by all processors, then reduce the results
+ *
+ * ranges are split the same as #ZFThreadParallelFor,
+ * mapCallback's param0 is a #ZFThreadParallelData,
+ * which should store result of the range to #ZFThreadParallelData::result\n
+ * reduceCallback's param0 is a #ZFThreadParallelData,
+ * which should combine #ZFThreadParallelData::reduceValue0 and #ZFThreadParallelData::reduceValue1
+ * and store to #ZFThreadParallelData::result\n
+ * \n
+ * null result would be ignored when reduce,
+ * and results may be reduced in any order,
+ * so reduceCallback must be associative and commutative\n
+ * \n
+ * return null if count is 0 or all map result is null
+ */
+ZFMETHOD_FUNC_DECLARE_5(zfautoObject, ZFThreadParallelReduce,
+                        ZFMP_IN(zfindex, start),
+                        ZFMP_IN(zfindex, count),
+                        ZFMP_IN(const ZFListener &, mapCallback),
+                        ZFMP_IN(const ZFListener &, reduceCallback),
+                        ZFMP_IN_OPT(zfindex, grainSize, 0))
+
+// ============================================================
+/** @cond ZFPrivateDoc */
+typedef void (*_ZFP_ZFThreadParallelCallback)(ZF_IN void *userData,
+                                              ZF_IN zfindex participant,
+                                              ZF_IN zfindex start,
+                                              ZF_IN zfindex count);
+/*
+ * participant is ensured in range [0, participantCount),
+ * and one participant would never run concurrently
+ */
+extern ZF_ENV_EXPORT void _ZFP_ZFThreadParallelRun(ZF_IN zfindex start,
+                                                   ZF_IN zfindex count,
+                                                   ZF_IN zfindex grainSize,
+                                                   ZF_IN zfindex participantCount,
+                                                   ZF_IN _ZFP_ZFThreadParallelCallback callback,
+                                                   ZF_IN void *userData);
+
+template<typename T_Func>
+zfclassNotPOD _ZFP_ZFThreadParallelForT
+{
+public:
+    static void action(ZF_IN void *userData,
+                       ZF_IN zfindex participant,
+                       ZF_IN zfindex start,
+                       ZF_IN zfindex count)
+    {
+        (*(const T_Func *)userData)(start, count);
+    }
+};
+template<typename T_Value, typename T_Map, typename T_Reduce>
+zfclassNotPOD _ZFP_ZFThreadParallelReduceT
+{
+public:
+    const T_Map &map;
+    const T_Reduce &reduce;
+    ZFCoreArray<T_Value> values;
+
+public:
+    _ZFP_ZFThreadParallelReduceT(ZF_IN const T_Map &map,
+                                 ZF_IN const T_Reduce &reduce)
+    : map(map)
+    , reduce(reduce)
+    , values()
+    {
+    }
+
+public:
+    static void action(ZF_IN void *userData,
+                       ZF_IN zfindex participant,
+                       ZF_IN zfindex start,
+                       ZF_IN zfindex count)
+    {
+        _ZFP_ZFThreadParallelReduceT<T_Value, T_Map, T_Reduce> *d = (_ZFP_ZFThreadParallelReduceT<T_Value, T_Map, T_Reduce> *)userData;
+        T_Value &value = d->values[participant];
+        value = d->reduce(value, d->map(start, count));
+    }
+};
+/** @endcond */
+
+/**
+ * @brief C++ version of #ZFThreadParallelFor
+ *
+ * func can be any callable that can be called as:
+ * @code
+ *   void func(zfindex start, zfindex count);
+ * @endcode
+ * for example:
+ * @code
+ *   zfclassNotPOD MyFunc
+ *   {
+ *   public:
+ *       zfbyte *buf;
+ *       void operator () (ZF_IN zfindex start, ZF_IN zfindex count) const
+ *       {
+ *           for(zfindex i = start; i < start + count; ++i)
+ *           {
+ *               process(buf[i]);
+ *           }
+ *       }
+ *   };
+ *   MyFunc func;
+ *   func.buf = buf;
+ *   ZFThreadParallelForT(0, bufSize, func);
+ * @endcode
+ */
+template<typename T_Func>
+inline void ZFThreadParallelForT(ZF_IN zfindex start,
+                                 ZF_IN zfindex count,
+                                 ZF_IN T_Func const &func,
+                                 ZF_IN_OPT zfindex grainSize = 0)
+{
+    _ZFP_ZFThreadParallelRun(start, count, grainSize, zfindexMax(),
+        _ZFP_ZFThreadParallelForT<T_Func>::action, (void *)&func);
+}
+/**
+ * @brief C++ version of #ZFThreadParallelReduce
+ *
+ * map and reduce can be any callable that can be called as:
+ * @code
+ *   T_Value map(zfindex start, zfindex count);
+ *   T_Value reduce(T_Value const &v0, T_Value const &v1);
+ * @endcode
+ * identity is used as initial value for each worker,
+ * and must not change the result when reduced with any value,
+ * such as 0 for sum or 1 for product\n
+ * reduce must be associative and commutative
+ */
+template<typename T_Value, typename T_Map, typename T_Reduce>
+T_Value ZFThreadParallelReduceT(ZF_IN zfindex start,
+                                ZF_IN zfindex count,
+                                ZF_IN T_Value const &identity,
+                                ZF_IN T_Map const &map,
+                                ZF_IN T_Reduce const &reduce,
+                                ZF_IN_OPT zfindex grainSize = 0)
+{
+    _ZFP_ZFThreadParallelReduceT<T_Value, T_Map, T_Reduce> d(map, reduce);
+    zfindex participantCount = ZFThreadParallelConcurrency();
+    d.values.capacity(participantCount);
+    for(zfindex i = 0; i < participantCount; ++i)
+    {
+        d.values.add(identity);
+    }
+    _ZFP_ZFThreadParallelRun(start, count, grainSize, participantCount,
+        _ZFP_ZFThreadParallelReduceT<T_Value, T_Map, T_Reduce>::action, &d);
+    T_Value ret = identity;
+    for(zfindex i = 0; i < participantCount; ++i)
+    {
+        ret = reduce(ret, d.values[i]);
+    }
+    return ret;
+}
+
+ZF_NAMESPACE_GLOBAL_END
+#endif // #ifndef _ZFI_ZFThread_parallel_h_
+
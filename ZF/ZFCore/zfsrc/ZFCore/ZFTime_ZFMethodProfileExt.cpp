@@ -0,0 +1,32 @@
+#include "ZFTime.h"
+#include "protocol/ZFProtocolZFTime.h"
+
+ZF_NAMESPACE_GLOBAL_BEGIN
+
+static zftimet _ZFP_ZFTime_ZFMethodProfileExt(void)
+{
+    ZFPROTOCOL_INTERFACE_CLASS(ZFTime) *impl = ZFPROTOCOL_TRY_ACCESS(ZFTime);
+    if(impl == zfnull)
+    {
+        return zftimetZero();
+    }
+    ZFTimeValue tv;
+    impl->currentTimeValue(tv);
+    return tv.sec * 1000000 + tv.usec;
+}
+
+ZF_GLOBAL_INITIALIZER_INIT_WITH_LEVEL(ZFTime_ZFMethodProfileExt, ZFLevelZFFrameworkEssential)
+{
+    ZFMethodProfileTimestampImplSet(_ZFP_ZFTime_ZFMethodProfileExt);
+}
+ZF_GLOBAL_INITIALIZER_DESTROY(ZFTime_ZFMethodProfileExt)
+{
+    if(ZFMethodProfileTimestampImplGet() == _ZFP_ZFTime_ZFMethodProfileExt)
+    {
+        ZFMethodProfileTimestampImplSet(zfnull);
+    }
+}
+ZF_GLOBAL_INITIALIZER_END(ZFTime_ZFMethodProfileExt)
+
+ZF_NAMESPACE_GLOBAL_END
+
@@ -0,0 +1,26 @@
+#include "ZFTime.h"
+#include "protocol/ZFProtocolZFTime.h"
+
+ZF_NAMESPACE_GLOBAL_BEGIN
+
+static zftimet _ZFP_ZFTime_ZFObjectAllocTrackExt(void)
+{
+    ZFPROTOCOL_INTERFACE_CLASS(ZFTime) *impl = ZFPROTOCOL_TRY_ACCESS(ZFTime);
+    return (impl != zfnull) ? impl->timestamp() : zftimetZero();
+}
+
+ZF_GLOBAL_INITIALIZER_INIT_WITH_LEVEL(ZFTime_ZFObjectAllocTrackExt, ZFLevelZFFrameworkEssential)
+{
+    ZFObjectAllocTrackTimestampImplSet(_ZFP_ZFTime_ZFObjectAllocTrackExt);
+}
+ZF_GLOBAL_INITIALIZER_DESTROY(ZFTime_ZFObjectAllocTrackExt)
+{
+    if(ZFObjectAllocTrackTimestampImplGet() == _ZFP_ZFTime_ZFObjectAllocTrackExt)
+    {
+        ZFObjectAllocTrackTimestampImplSet(zfnull);
+    }
+}
+ZF_GLOBAL_INITIALIZER_END(ZFTime_ZFObjectAllocTrackExt)
+
+ZF_NAMESPACE_GLOBAL_END
+
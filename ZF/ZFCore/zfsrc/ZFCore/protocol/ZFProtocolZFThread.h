@@ -47,6 +47,15 @@ public:
      */
     virtual void sleep(ZF_IN zftimet miliSecs) zfpurevirtual;
 
+    /**
+     * @brief number of processors that can run threads concurrently,
+     *   used by #ZFThreadParallelFor
+     */
+    virtual zfindex processorCount(void)
+    {
+        return 1;
+    }
+
     /**
      * @brief see #ZFThreadExecuteInMainThread
      *
@@ -7,6 +7,69 @@
 
 ZF_NAMESPACE_GLOBAL_BEGIN
 
+// ============================================================
+// main thread run loop for default ZFThread impl
+/**
+ * @brief run main thread tasks queued by the default #ZFThread implementation
+ *
+ * the default #ZFThread implementation has no native event loop,
+ * tasks queued by #ZFThreadExecuteInMainThread
+ * or #ZFThreadExecuteInMainThreadAfterDelay
+ * would be run only when the run loop is driven,
+ * the default main entry (#ZFMAIN_ENTRY) would drive it automatically
+ * after #ZFMainExecute returned 0, until #ZFFrameworkCleanup (e.g. by #ZFApp::appExit),
+ * otherwise the host process should drive it manually:
+ * @code
+ *   int main(int argc, char **argv)
+ *   {
+ *       ZFFrameworkInit();
+ *       // start your work here,
+ *       // and call ZFImpl_default_mainThreadQuit when done
+ *       ZFImpl_default_mainThreadRun();
+ *       ZFFrameworkCleanup();
+ *       return 0;
+ *   }
+ * @endcode
+ * \n
+ * each call would take all tasks that are ready as one batch and run them,
+ * if no task is ready, block at most timeout miliseconds until any task is ready,
+ * timeout can be 0 to return immediately, or -1 to wait infinitely
+ * until any task is ready or #ZFImpl_default_mainThreadWakeup is called\n
+ * \n
+ * must be called in the thread that called #ZFFrameworkInit,
+ * return number of tasks that have been run
+ */
+extern ZF_ENV_EXPORT zfindex ZFImpl_default_mainThreadRunOnce(ZF_IN_OPT zftimet timeout = 0);
+/**
+ * @brief keep running #ZFImpl_default_mainThreadRunOnce until #ZFImpl_default_mainThreadQuit
+ */
+extern ZF_ENV_EXPORT void ZFImpl_default_mainThreadRun(void);
+/**
+ * @brief stop #ZFImpl_default_mainThreadRun, can be called in any thread
+ */
+extern ZF_ENV_EXPORT void ZFImpl_default_mainThreadQuit(void);
+/**
+ * @brief interrupt a blocking #ZFImpl_default_mainThreadRunOnce, can be called in any thread
+ */
+extern ZF_ENV_EXPORT void ZFImpl_default_mainThreadWakeup(void);
+/**
+ * @brief miliseconds until next task ready, 0 if any task is ready now, or -1 if no task queued
+ *
+ * useful to drive the run loop by the host's own poll loop,
+ * see also #ZFImpl_default_mainThreadWakeupCallback
+ */
+extern ZF_ENV_EXPORT zftimet ZFImpl_default_mainThreadNextTimeout(void);
+/** @brief see #ZFImpl_default_mainThreadWakeupCallback */
+typedef void (*ZFImpl_default_MainThreadWakeupCallback)(void);
+/**
+ * @brief callback to notify the host that #ZFImpl_default_mainThreadNextTimeout changed
+ *
+ * called in the thread that queued the task, without any lock held,
+ * typically used to wake up the host's own poll loop,
+ * set null to remove
+ */
+extern ZF_ENV_EXPORT void ZFImpl_default_mainThreadWakeupCallback(ZF_IN ZFImpl_default_MainThreadWakeupCallback callback);
+
 ZF_NAMESPACE_GLOBAL_END
 #endif // #ifndef _ZFI_ZFImpl_default_ZFCore_impl_h_
 
@@ -7,6 +7,8 @@
 #elif ZF_ENV_sys_Posix || ZF_ENV_sys_unknown
     #include <pthread.h>
     #include <unistd.h>
+    #include <time.h>
+    #include <errno.h>
 #endif
 
 ZF_NAMESPACE_GLOBAL_BEGIN
@@ -16,17 +18,22 @@ ZF_NAMESPACE_GLOBAL_BEGIN
 zfclassNotPOD _ZFP_ZFThreadImpl_default_ExecuteData
 {
 public:
+    _ZFP_ZFThreadImpl_default_ExecuteData *next; // next pending task in worker pool
+    zfidentity taskId;
     ZFThread *ownerZFThread;
     ZFListener runnable;
     ZFObject *param0;
     ZFObject *param1;
 
 public:
-    _ZFP_ZFThreadImpl_default_ExecuteData(ZF_IN ZFThread *ownerZFThread,
+    _ZFP_ZFThreadImpl_default_ExecuteData(ZF_IN zfidentity taskId,
+                                          ZF_IN ZFThread *ownerZFThread,
                                           ZF_IN ZFListener runnable,
                                           ZF_IN ZFObject *param0,
                                           ZF_IN ZFObject *param1)
-    : ownerZFThread(ownerZFThread)
+    : next(zfnull)
+    , taskId(taskId)
+    , ownerZFThread(ownerZFThread)
     , runnable(runnable)
     , param0(param0)
     , param1(param1)
@@ -46,16 +53,53 @@ static void _ZFP_ZFThreadImpl_default_sleep(zftimet miliSecs)
 {
     Sleep((DWORD)miliSecs);
 }
-static void _ZFP_ZFThreadImpl_default_threadCallback(_ZFP_ZFThreadImpl_default_ExecuteData *data);
+static zftimet _ZFP_ZFThreadImpl_default_timestamp(void)
+{
+    return (zftimet)GetTickCount64();
+}
+static void _ZFP_ZFThreadImpl_default_workerRun(void);
 static DWORD WINAPI _ZFP_ZFThreadImpl_default_nativeCallback(LPVOID param)
 {
-    _ZFP_ZFThreadImpl_default_threadCallback(ZFCastStatic(_ZFP_ZFThreadImpl_default_ExecuteData *, param));
+    _ZFP_ZFThreadImpl_default_workerRun();
     return 0;
 }
-static void _ZFP_ZFThreadImpl_default_startNativeThread(_ZFP_ZFThreadImpl_default_ExecuteData *data)
+static zfbool _ZFP_ZFThreadImpl_default_startNativeThread(void)
 {
-    CreateThread(NULL, 0, _ZFP_ZFThreadImpl_default_nativeCallback, data, 0, NULL);
+    HANDLE worker = CreateThread(NULL, 0, _ZFP_ZFThreadImpl_default_nativeCallback, NULL, 0, NULL);
+    if(worker == NULL)
+    {
+        return zffalse;
+    }
+    CloseHandle(worker);
+    return zftrue;
 }
+zfclassNotPOD _ZFP_ZFThreadImpl_default_Lock
+{
+public:
+    _ZFP_ZFThreadImpl_default_Lock(void)
+    {
+        InitializeCriticalSection(&this->m);
+        InitializeConditionVariable(&this->c);
+    }
+    ~_ZFP_ZFThreadImpl_default_Lock(void)
+    {
+        DeleteCriticalSection(&this->m);
+    }
+public:
+    inline void lock(void) {EnterCriticalSection(&this->m);}
+    inline void unlock(void) {LeaveCriticalSection(&this->m);}
+    inline void notifyOne(void) {WakeConditionVariable(&this->c);}
+    inline void notifyAll(void) {WakeAllConditionVariable(&this->c);}
+    inline void wait(void) {SleepConditionVariableCS(&this->c, &this->m, INFINITE);}
+    // return false if timeout
+    inline zfbool wait(ZF_IN zftimet miliSecs)
+    {
+        return (SleepConditionVariableCS(&this->c, &this->m, (DWORD)miliSecs) || GetLastError() != ERROR_TIMEOUT);
+    }
+private:
+    CRITICAL_SECTION m;
+    CONDITION_VARIABLE c;
+};
 #elif ZF_ENV_sys_Posix || ZF_ENV_sys_unknown
 typedef pthread_t _ZFP_ZFThreadImpl_default_NativeThreadIdType;
 static _ZFP_ZFThreadImpl_default_NativeThreadIdType _ZFP_ZFThreadImpl_default_getNativeThreadId(void)
@@ -66,54 +110,804 @@ static void _ZFP_ZFThreadImpl_default_sleep(zftimet miliSecs)
 {
     usleep((unsigned int)(miliSecs * 1000));
 }
-static void _ZFP_ZFThreadImpl_default_threadCallback(_ZFP_ZFThreadImpl_default_ExecuteData *data);
+static zftimet _ZFP_ZFThreadImpl_default_timestamp(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((zftimet)ts.tv_sec * 1000 + (zftimet)(ts.tv_nsec / 1000000));
+}
+static void _ZFP_ZFThreadImpl_default_workerRun(void);
 static void *_ZFP_ZFThreadImpl_default_nativeCallback(void *param)
 {
-    _ZFP_ZFThreadImpl_default_threadCallback(ZFCastStatic(_ZFP_ZFThreadImpl_default_ExecuteData *, param));
+    _ZFP_ZFThreadImpl_default_workerRun();
     return zfnull;
 }
-static void _ZFP_ZFThreadImpl_default_startNativeThread(_ZFP_ZFThreadImpl_default_ExecuteData *data)
+static zfbool _ZFP_ZFThreadImpl_default_startNativeThread(void)
 {
     pthread_t tid = 0;
-    pthread_create(&tid, NULL, _ZFP_ZFThreadImpl_default_nativeCallback, data);
+    if(pthread_create(&tid, NULL, _ZFP_ZFThreadImpl_default_nativeCallback, NULL) != 0)
+    {
+        return zffalse;
+    }
+    pthread_detach(tid);
+    return zftrue;
+}
+zfclassNotPOD _ZFP_ZFThreadImpl_default_Lock
+{
+public:
+    _ZFP_ZFThreadImpl_default_Lock(void)
+    {
+        pthread_mutex_init(&this->m, NULL);
+        pthread_cond_init(&this->c, NULL);
+    }
+    ~_ZFP_ZFThreadImpl_default_Lock(void)
+    {
+        pthread_cond_destroy(&this->c);
+        pthread_mutex_destroy(&this->m);
+    }
+public:
+    inline void lock(void) {pthread_mutex_lock(&this->m);}
+    inline void unlock(void) {pthread_mutex_unlock(&this->m);}
+    inline void notifyOne(void) {pthread_cond_signal(&this->c);}
+    inline void notifyAll(void) {pthread_cond_broadcast(&this->c);}
+    inline void wait(void) {pthread_cond_wait(&this->c, &this->m);}
+    // return false if timeout
+    zfbool wait(ZF_IN zftimet miliSecs)
+    {
+        struct timespec ts;
+        clock_gettime(CLOCK_REALTIME, &ts);
+        ts.tv_sec += (time_t)(miliSecs / 1000);
+        ts.tv_nsec += (long)((miliSecs % 1000) * 1000000);
+        if(ts.tv_nsec >= 1000000000)
+        {
+            ++ts.tv_sec;
+            ts.tv_nsec -= 1000000000;
+        }
+        return (pthread_cond_timedwait(&this->c, &this->m, &ts) != ETIMEDOUT);
+    }
+private:
+    pthread_mutex_t m;
+    pthread_cond_t c;
+};
+#endif
+
+// ============================================================
+// parallel runner for ZFFrameworkInit,
+// worker threads are plain native threads and not registered to ZFThread
+zfclassNotPOD _ZFP_ZFThreadImpl_default_ParallelData
+{
+public:
+    ZFFrameworkInitParallelTask task;
+    void * const *taskDataList;
+    zfindex taskCount;
+    zfatomicint taskIndex;
+};
+static void _ZFP_ZFThreadImpl_default_parallelRun(ZF_IN _ZFP_ZFThreadImpl_default_ParallelData *d)
+{
+    do
+    {
+        zfindex index = (zfindex)(zfAtomicIncrease(d->taskIndex) - 1);
+        if(index >= d->taskCount)
+        {
+            break;
+        }
+        d->task(d->taskDataList[index]);
+    } while(zftrue);
+}
+#if ZF_ENV_sys_Windows
+static DWORD WINAPI _ZFP_ZFThreadImpl_default_parallelCallback(LPVOID param)
+{
+    _ZFP_ZFThreadImpl_default_parallelRun(ZFCastStatic(_ZFP_ZFThreadImpl_default_ParallelData *, param));
+    zfpoolCacheCleanup();
+    return 0;
+}
+static zfindex _ZFP_ZFThreadImpl_default_cpuCount(void)
+{
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (zfindex)info.dwNumberOfProcessors;
+}
+#elif ZF_ENV_sys_Posix || ZF_ENV_sys_unknown
+static void *_ZFP_ZFThreadImpl_default_parallelCallback(void *param)
+{
+    _ZFP_ZFThreadImpl_default_parallelRun(ZFCastStatic(_ZFP_ZFThreadImpl_default_ParallelData *, param));
+    zfpoolCacheCleanup();
+    return zfnull;
 }
+static zfindex _ZFP_ZFThreadImpl_default_cpuCount(void)
+{
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return (n > 0 ? (zfindex)n : 1);
+}
+#endif
+static void _ZFP_ZFThreadImpl_default_parallelImpl(ZF_IN ZFFrameworkInitParallelTask task,
+                                                   ZF_IN void * const *taskDataList,
+                                                   ZF_IN zfindex taskCount)
+{
+    _ZFP_ZFThreadImpl_default_ParallelData d;
+    d.task = task;
+    d.taskDataList = taskDataList;
+    d.taskCount = taskCount;
+    d.taskIndex = 0;
+
+    // current thread also takes part in the tasks
+    zfindex workerCount = zfmMin(taskCount, _ZFP_ZFThreadImpl_default_cpuCount()) - 1;
+#if ZF_ENV_sys_Windows
+    ZFCoreArrayPOD<HANDLE> workers;
+    for(zfindex i = 0; i < workerCount; ++i)
+    {
+        HANDLE worker = CreateThread(NULL, 0, _ZFP_ZFThreadImpl_default_parallelCallback, &d, 0, NULL);
+        if(worker != NULL)
+        {
+            workers.add(worker);
+        }
+    }
+    _ZFP_ZFThreadImpl_default_parallelRun(&d);
+    for(zfindex i = 0; i < workers.count(); ++i)
+    {
+        WaitForSingleObject(workers[i], INFINITE);
+        CloseHandle(workers[i]);
+    }
+#elif ZF_ENV_sys_Posix || ZF_ENV_sys_unknown
+    ZFCoreArrayPOD<pthread_t> workers;
+    for(zfindex i = 0; i < workerCount; ++i)
+    {
+        pthread_t worker;
+        if(pthread_create(&worker, NULL, _ZFP_ZFThreadImpl_default_parallelCallback, &d) == 0)
+        {
+            workers.add(worker);
+        }
+    }
+    _ZFP_ZFThreadImpl_default_parallelRun(&d);
+    for(zfindex i = 0; i < workers.count(); ++i)
+    {
+        pthread_join(workers[i], NULL);
+    }
+#else
+    _ZFP_ZFThreadImpl_default_parallelRun(&d);
 #endif
+}
+static _ZFP_ZFThreadImpl_default_Lock &_ZFP_ZFThreadImpl_default_parallelLock(void)
+{
+    static _ZFP_ZFThreadImpl_default_Lock d;
+    return d;
+}
+static void _ZFP_ZFThreadImpl_default_parallelWait(ZF_IN zfatomicint &value,
+                                                   ZF_IN zfint expected)
+{
+    _ZFP_ZFThreadImpl_default_Lock &lock = _ZFP_ZFThreadImpl_default_parallelLock();
+    lock.lock();
+    while(zfAtomicLoad(value) == expected)
+    {
+        lock.wait();
+    }
+    lock.unlock();
+}
+static void _ZFP_ZFThreadImpl_default_parallelNotify(ZF_IN zfatomicint &value)
+{
+    _ZFP_ZFThreadImpl_default_Lock &lock = _ZFP_ZFThreadImpl_default_parallelLock();
+    lock.lock();
+    lock.notifyAll();
+    lock.unlock();
+}
+ZF_STATIC_REGISTER_INIT(ZFThreadImpl_default_parallelImpl)
+{
+    ZFFrameworkInitParallelImplSet(
+        _ZFP_ZFThreadImpl_default_parallelImpl,
+        _ZFP_ZFThreadImpl_default_parallelWait,
+        _ZFP_ZFThreadImpl_default_parallelNotify);
+}
+ZF_STATIC_REGISTER_DESTROY(ZFThreadImpl_default_parallelImpl)
+{
+    if(ZFFrameworkInitParallelImplGet() == _ZFP_ZFThreadImpl_default_parallelImpl)
+    {
+        ZFFrameworkInitParallelImplSet(zfnull, zfnull, zfnull);
+    }
+}
+ZF_STATIC_REGISTER_END(ZFThreadImpl_default_parallelImpl)
+
+// ============================================================
+// worker pool for executeInNewThread
+// -  workerCore workers are kept alive once started,
+//   extra workers are started on demand and exit after idle for a while
+// -  a new worker is started if no worker is idle, up to workerMax workers,
+//   further tasks would be queued until any worker available,
+//   workerMax is large since tasks (typically ZFThread::threadOnRun)
+//   may block for long time or wait for each other
+// -  shutdown waits until all running and queued tasks finished,
+//   so that no task would run after ZFFrameworkCleanup
+#define _ZFP_ZFThreadImpl_default_workerIdleTimeout ((zftimet)10000)
+#define _ZFP_ZFThreadImpl_default_workerMaxPerCpu 16
+#define _ZFP_ZFThreadImpl_default_workerMaxMin 256
+#define _ZFP_ZFThreadImpl_default_shutdownCheckInterval ((zftimet)10)
+zfclassNotPOD _ZFP_ZFThreadImpl_default_Pool
+{
+public:
+    _ZFP_ZFThreadImpl_default_Lock lock;
+    _ZFP_ZFThreadImpl_default_ExecuteData *queueHead;
+    _ZFP_ZFThreadImpl_default_ExecuteData *queueTail;
+    zfindex queueCount;
+    zfindex runningCount;
+    zfindex workerCount;
+    zfindex idleCount;
+    zfindex workerCore;
+    zfindex workerMax;
+    zfbool shutdown;
+
+public:
+    _ZFP_ZFThreadImpl_default_Pool(void)
+    : lock()
+    , queueHead(zfnull)
+    , queueTail(zfnull)
+    , queueCount(0)
+    , runningCount(0)
+    , workerCount(0)
+    , idleCount(0)
+    , workerCore(_ZFP_ZFThreadImpl_default_cpuCount())
+    , workerMax(zfmMax(_ZFP_ZFThreadImpl_default_cpuCount() * _ZFP_ZFThreadImpl_default_workerMaxPerCpu, (zfindex)_ZFP_ZFThreadImpl_default_workerMaxMin))
+    , shutdown(zffalse)
+    {
+    }
+};
+// workers may still be running during static destruction, so the pool is never freed
+static _ZFP_ZFThreadImpl_default_Pool &_ZFP_ZFThreadImpl_default_pool(void)
+{
+    static _ZFP_ZFThreadImpl_default_Pool *d = zfnew(_ZFP_ZFThreadImpl_default_Pool);
+    return *d;
+}
+static void _ZFP_ZFThreadImpl_default_threadCallback(_ZFP_ZFThreadImpl_default_ExecuteData *data);
+static void _ZFP_ZFThreadImpl_default_workerRun(void)
+{
+    _ZFP_ZFThreadImpl_default_Pool &pool = _ZFP_ZFThreadImpl_default_pool();
+    pool.lock.lock();
+    do
+    {
+        _ZFP_ZFThreadImpl_default_ExecuteData *data = pool.queueHead;
+        if(data == zfnull)
+        {
+            if(pool.shutdown)
+            {
+                break;
+            }
+            ++(pool.idleCount);
+            zfbool timeout = zffalse;
+            if(pool.workerCount > pool.workerCore)
+            {
+                timeout = !pool.lock.wait(_ZFP_ZFThreadImpl_default_workerIdleTimeout);
+            }
+            else
+            {
+                pool.lock.wait();
+            }
+            --(pool.idleCount);
+            if(timeout && pool.queueHead == zfnull && pool.workerCount > pool.workerCore)
+            {
+                break;
+            }
+            continue;
+        }
+
+        pool.queueHead = data->next;
+        if(pool.queueHead == zfnull)
+        {
+            pool.queueTail = zfnull;
+        }
+        --(pool.queueCount);
+        ++(pool.runningCount);
+        pool.lock.unlock();
+        _ZFP_ZFThreadImpl_default_threadCallback(data);
+        pool.lock.lock();
+        --(pool.runningCount);
+        if(pool.shutdown && pool.runningCount == 0 && pool.queueCount == 0)
+        {
+            pool.lock.notifyAll();
+        }
+    } while(zftrue);
+    --(pool.workerCount);
+    pool.lock.unlock();
+}
+static void _ZFP_ZFThreadImpl_default_poolAdd(ZF_IN _ZFP_ZFThreadImpl_default_ExecuteData *data)
+{
+    _ZFP_ZFThreadImpl_default_Pool &pool = _ZFP_ZFThreadImpl_default_pool();
+    pool.lock.lock();
+    if(pool.queueTail == zfnull)
+    {
+        pool.queueHead = data;
+    }
+    else
+    {
+        pool.queueTail->next = data;
+    }
+    pool.queueTail = data;
+    ++(pool.queueCount);
+    if(pool.queueCount <= pool.idleCount)
+    {
+        // shutdown waiter shares the same condition
+        if(pool.shutdown)
+        {
+            pool.lock.notifyAll();
+        }
+        else
+        {
+            pool.lock.notifyOne();
+        }
+    }
+    else if(pool.workerCount < pool.workerMax && _ZFP_ZFThreadImpl_default_startNativeThread())
+    {
+        ++(pool.workerCount);
+    }
+    pool.lock.unlock();
+}
+static void _ZFP_ZFThreadImpl_default_poolCancel(ZF_IN zfidentity taskId)
+{
+    _ZFP_ZFThreadImpl_default_Pool &pool = _ZFP_ZFThreadImpl_default_pool();
+    _ZFP_ZFThreadImpl_default_ExecuteData *data = zfnull;
+    pool.lock.lock();
+    for(_ZFP_ZFThreadImpl_default_ExecuteData *prev = zfnull, *p = pool.queueHead; p != zfnull; prev = p, p = p->next)
+    {
+        if(p->taskId == taskId)
+        {
+            data = p;
+            if(prev == zfnull)
+            {
+                pool.queueHead = p->next;
+            }
+            else
+            {
+                prev->next = p->next;
+            }
+            if(pool.queueTail == p)
+            {
+                pool.queueTail = prev;
+            }
+            --(pool.queueCount);
+            break;
+        }
+    }
+    pool.lock.unlock();
+    if(data != zfnull)
+    {
+        zfdelete(data);
+    }
+}
+static zfbool _ZFP_ZFThreadImpl_default_isMainThread(void);
+static void _ZFP_ZFThreadImpl_default_poolShutdown(ZF_IN zfbool shutdown)
+{
+    _ZFP_ZFThreadImpl_default_Pool &pool = _ZFP_ZFThreadImpl_default_pool();
+    pool.lock.lock();
+    pool.shutdown = shutdown;
+    if(shutdown)
+    {
+        pool.lock.notifyAll();
+        // tasks may wait for main thread, keep main thread tasks running while waiting
+        zfbool isMainThread = _ZFP_ZFThreadImpl_default_isMainThread();
+        while(pool.runningCount > 0 || pool.queueCount > 0)
+        {
+            pool.lock.wait(_ZFP_ZFThreadImpl_default_shutdownCheckInterval);
+            if(isMainThread && (pool.runningCount > 0 || pool.queueCount > 0))
+            {
+                pool.lock.unlock();
+                ZFImpl_default_mainThreadRunOnce(0);
+                pool.lock.lock();
+            }
+        }
+    }
+    pool.lock.unlock();
+}
+
+// ============================================================
+// main thread run loop, driven by ZFImpl_default_mainThreadRunOnce
+// -  tasks without delay are queued in FIFO order
+// -  delayed tasks are kept in a binary heap sorted by fire time,
+//   tasks with same fire time are run in queued order
+// -  each step moves all ready tasks out as one batch,
+//   and runs them without holding the lock
+#define _ZFP_ZFThreadImpl_default_MainTaskPending 0
+#define _ZFP_ZFThreadImpl_default_MainTaskRunning 1
+#define _ZFP_ZFThreadImpl_default_MainTaskCanceled 2
+zfclassNotPOD _ZFP_ZFThreadImpl_default_MainTask
+{
+public:
+    _ZFP_ZFThreadImpl_default_MainTask *next; // next task in FIFO queue or batch
+    zftimet fireTime;
+    zfindex seq;
+    zfindex heapIndex; // zfindexMax() if not in delay queue
+    zfatomicint state;
+    ZFListener runnable;
+    ZFObject *param0;
+    ZFObject *param1;
+
+public:
+    _ZFP_ZFThreadImpl_default_MainTask(ZF_IN const ZFListener &runnable,
+                                       ZF_IN ZFObject *param0,
+                                       ZF_IN ZFObject *param1)
+    : next(zfnull)
+    , fireTime(0)
+    , seq(0)
+    , heapIndex(zfindexMax())
+    , state(_ZFP_ZFThreadImpl_default_MainTaskPending)
+    , runnable(runnable)
+    , param0(param0)
+    , param1(param1)
+    {
+    }
+};
+typedef ZFCoreArrayPOD<_ZFP_ZFThreadImpl_default_MainTask *> _ZFP_ZFThreadImpl_default_MainTaskHeap;
+zfclassNotPOD _ZFP_ZFThreadImpl_default_MainLoop
+{
+public:
+    _ZFP_ZFThreadImpl_default_Lock lock;
+    _ZFP_ZFThreadImpl_default_NativeThreadIdType mainThreadId;
+    _ZFP_ZFThreadImpl_default_MainTask *queueHead;
+    _ZFP_ZFThreadImpl_default_MainTask *queueTail;
+    _ZFP_ZFThreadImpl_default_MainTaskHeap delayQueue;
+    zfindex seqNext;
+    zfbool waiting;
+    zfbool wakeupFlag;
+    zfbool quitFlag;
+    ZFImpl_default_MainThreadWakeupCallback wakeupCallback;
+
+public:
+    _ZFP_ZFThreadImpl_default_MainLoop(void)
+    : lock()
+    , mainThreadId()
+    , queueHead(zfnull)
+    , queueTail(zfnull)
+    , delayQueue()
+    , seqNext(0)
+    , waiting(zffalse)
+    , wakeupFlag(zffalse)
+    , quitFlag(zffalse)
+    , wakeupCallback(zfnull)
+    {
+    }
+};
+// other threads may still queue tasks during static destruction, so it's never freed
+static _ZFP_ZFThreadImpl_default_MainLoop &_ZFP_ZFThreadImpl_default_mainLoop(void)
+{
+    static _ZFP_ZFThreadImpl_default_MainLoop *d = zfnew(_ZFP_ZFThreadImpl_default_MainLoop);
+    return *d;
+}
+static zfbool _ZFP_ZFThreadImpl_default_isMainThread(void)
+{
+    return (_ZFP_ZFThreadImpl_default_mainLoop().mainThreadId == _ZFP_ZFThreadImpl_default_getNativeThreadId());
+}
+
+static inline zfbool _ZFP_ZFThreadImpl_default_mainTaskLess(ZF_IN _ZFP_ZFThreadImpl_default_MainTask *t0,
+                                                            ZF_IN _ZFP_ZFThreadImpl_default_MainTask *t1)
+{
+    return (t0->fireTime < t1->fireTime || (t0->fireTime == t1->fireTime && t0->seq < t1->seq));
+}
+static inline void _ZFP_ZFThreadImpl_default_heapSet(ZF_IN_OUT _ZFP_ZFThreadImpl_default_MainTaskHeap &heap,
+                                                     ZF_IN zfindex index,
+                                                     ZF_IN _ZFP_ZFThreadImpl_default_MainTask *task)
+{
+    heap[index] = task;
+    task->heapIndex = index;
+}
+static void _ZFP_ZFThreadImpl_default_heapUp(ZF_IN_OUT _ZFP_ZFThreadImpl_default_MainTaskHeap &heap,
+                                             ZF_IN zfindex index)
+{
+    _ZFP_ZFThreadImpl_default_MainTask *task = heap[index];
+    while(index > 0)
+    {
+        zfindex parent = (index - 1) / 2;
+        if(!_ZFP_ZFThreadImpl_default_mainTaskLess(task, heap[parent]))
+        {
+            break;
+        }
+        _ZFP_ZFThreadImpl_default_heapSet(heap, index, heap[parent]);
+        index = parent;
+    }
+    _ZFP_ZFThreadImpl_default_heapSet(heap, index, task);
+}
+static void _ZFP_ZFThreadImpl_default_heapDown(ZF_IN_OUT _ZFP_ZFThreadImpl_default_MainTaskHeap &heap,
+                                               ZF_IN zfindex index)
+{
+    _ZFP_ZFThreadImpl_default_MainTask *task = heap[index];
+    zfindex count = heap.count();
+    do
+    {
+        zfindex child = index * 2 + 1;
+        if(child >= count)
+        {
+            break;
+        }
+        if(child + 1 < count && _ZFP_ZFThreadImpl_default_mainTaskLess(heap[child + 1], heap[child]))
+        {
+            ++child;
+        }
+        if(!_ZFP_ZFThreadImpl_default_mainTaskLess(heap[child], task))
+        {
+            break;
+        }
+        _ZFP_ZFThreadImpl_default_heapSet(heap, index, heap[child]);
+        index = child;
+    } while(zftrue);
+    _ZFP_ZFThreadImpl_default_heapSet(heap, index, task);
+}
+static void _ZFP_ZFThreadImpl_default_heapRemove(ZF_IN_OUT _ZFP_ZFThreadImpl_default_MainTaskHeap &heap,
+                                                 ZF_IN _ZFP_ZFThreadImpl_default_MainTask *task)
+{
+    zfindex index = task->heapIndex;
+    _ZFP_ZFThreadImpl_default_MainTask *last = heap.removeLastAndGet();
+    task->heapIndex = zfindexMax();
+    if(last != task)
+    {
+        _ZFP_ZFThreadImpl_default_heapSet(heap, index, last);
+        _ZFP_ZFThreadImpl_default_heapUp(heap, index);
+        _ZFP_ZFThreadImpl_default_heapDown(heap, last->heapIndex);
+    }
+}
+
+static void _ZFP_ZFThreadImpl_default_mainLoopAdd(ZF_IN _ZFP_ZFThreadImpl_default_MainTask *task,
+                                                  ZF_IN zftimet delay)
+{
+    _ZFP_ZFThreadImpl_default_MainLoop &d = _ZFP_ZFThreadImpl_default_mainLoop();
+    zfbool notify = zffalse;
+    d.lock.lock();
+    task->seq = d.seqNext++;
+    if(delay <= 0)
+    {
+        if(d.queueTail == zfnull)
+        {
+            d.queueHead = task;
+            notify = zftrue;
+        }
+        else
+        {
+            d.queueTail->next = task;
+        }
+        d.queueTail = task;
+    }
+    else
+    {
+        task->fireTime = _ZFP_ZFThreadImpl_default_timestamp() + delay;
+        task->heapIndex = d.delayQueue.count();
+        d.delayQueue.add(task);
+        _ZFP_ZFThreadImpl_default_heapUp(d.delayQueue, task->heapIndex);
+        // only wake up if next fire time changed
+        notify = (task->heapIndex == 0 && d.queueHead == zfnull);
+    }
+    if(notify && d.waiting)
+    {
+        d.lock.notifyOne();
+    }
+    ZFImpl_default_MainThreadWakeupCallback wakeupCallback = (notify ? d.wakeupCallback : zfnull);
+    d.lock.unlock();
+    if(wakeupCallback != zfnull)
+    {
+        wakeupCallback();
+    }
+}
+static void _ZFP_ZFThreadImpl_default_mainLoopCancel(ZF_IN _ZFP_ZFThreadImpl_default_MainTask *task)
+{
+    _ZFP_ZFThreadImpl_default_MainLoop &d = _ZFP_ZFThreadImpl_default_mainLoop();
+    d.lock.lock();
+    if(task->heapIndex != zfindexMax())
+    {
+        _ZFP_ZFThreadImpl_default_heapRemove(d.delayQueue, task);
+        d.lock.unlock();
+        zfpoolDelete(task);
+        return ;
+    }
+    // in FIFO queue or being run as batch, the runner would skip and delete it
+    zfAtomicCompareAndSwap(task->state, _ZFP_ZFThreadImpl_default_MainTaskPending, _ZFP_ZFThreadImpl_default_MainTaskCanceled);
+    d.lock.unlock();
+}
+static void _ZFP_ZFThreadImpl_default_mainLoopCleanup(void)
+{
+    _ZFP_ZFThreadImpl_default_MainLoop &d = _ZFP_ZFThreadImpl_default_mainLoop();
+    d.lock.lock();
+    _ZFP_ZFThreadImpl_default_MainTask *queueHead = d.queueHead;
+    d.queueHead = zfnull;
+    d.queueTail = zfnull;
+    for(zfindex i = 0; i < d.delayQueue.count(); ++i)
+    {
+        zfpoolDelete(d.delayQueue[i]);
+    }
+    d.delayQueue.removeAll();
+    d.lock.unlock();
+
+    while(queueHead != zfnull)
+    {
+        _ZFP_ZFThreadImpl_default_MainTask *task = queueHead;
+        queueHead = task->next;
+        zfpoolDelete(task);
+    }
+}
+
+zfindex ZFImpl_default_mainThreadRunOnce(ZF_IN_OPT zftimet timeout /* = 0 */)
+{
+    _ZFP_ZFThreadImpl_default_MainLoop &d = _ZFP_ZFThreadImpl_default_mainLoop();
+    zfCoreAssertWithMessageTrim(d.mainThreadId == _ZFP_ZFThreadImpl_default_getNativeThreadId(),
+        "[ZFThread] main thread run loop must be run in main thread");
+
+    _ZFP_ZFThreadImpl_default_MainTask *batchHead = zfnull;
+    _ZFP_ZFThreadImpl_default_MainTask *batchTail = zfnull;
+    d.lock.lock();
+    zftimet now = _ZFP_ZFThreadImpl_default_timestamp();
+    zftimet deadline = now + timeout;
+    do
+    {
+        batchHead = d.queueHead;
+        batchTail = d.queueTail;
+        d.queueHead = zfnull;
+        d.queueTail = zfnull;
+        while(!d.delayQueue.isEmpty() && d.delayQueue[0]->fireTime <= now)
+        {
+            _ZFP_ZFThreadImpl_default_MainTask *task = d.delayQueue[0];
+            _ZFP_ZFThreadImpl_default_heapRemove(d.delayQueue, task);
+            if(batchTail == zfnull)
+            {
+                batchHead = task;
+            }
+            else
+            {
+                batchTail->next = task;
+            }
+            batchTail = task;
+        }
+        if(batchHead != zfnull || d.wakeupFlag || (timeout >= 0 && now >= deadline))
+        {
+            break;
+        }
+
+        zftimet waitTime = ((timeout >= 0) ? (zftimet)(deadline - now) : (zftimet)-1);
+        if(!d.delayQueue.isEmpty())
+        {
+            zftimet fireWait = d.delayQueue[0]->fireTime - now;
+            if(waitTime < 0 || fireWait < waitTime)
+            {
+                waitTime = fireWait;
+            }
+        }
+        d.waiting = zftrue;
+        if(waitTime < 0)
+        {
+            d.lock.wait();
+        }
+        else
+        {
+            d.lock.wait(waitTime);
+        }
+        d.waiting = zffalse;
+        now = _ZFP_ZFThreadImpl_default_timestamp();
+    } while(zftrue);
+    d.wakeupFlag = zffalse;
+    d.lock.unlock();
+
+    zfindex ret = 0;
+    while(batchHead != zfnull)
+    {
+        _ZFP_ZFThreadImpl_default_MainTask *task = batchHead;
+        batchHead = task->next;
+        if(zfAtomicCompareAndSwap(task->state, _ZFP_ZFThreadImpl_default_MainTaskPending, _ZFP_ZFThreadImpl_default_MainTaskRunning))
+        {
+            ++ret;
+            task->runnable.execute(ZFListenerData().param0(task->param0).param1(task->param1));
+        }
+        zfpoolDelete(task);
+    }
+    return ret;
+}
+void ZFImpl_default_mainThreadRun(void)
+{
+    _ZFP_ZFThreadImpl_default_MainLoop &d = _ZFP_ZFThreadImpl_default_mainLoop();
+    do
+    {
+        ZFImpl_default_mainThreadRunOnce(-1);
+        d.lock.lock();
+        zfbool quit = d.quitFlag;
+        d.quitFlag = zffalse;
+        d.lock.unlock();
+        if(quit)
+        {
+            break;
+        }
+    } while(zftrue);
+}
+void ZFImpl_default_mainThreadQuit(void)
+{
+    _ZFP_ZFThreadImpl_default_MainLoop &d = _ZFP_ZFThreadImpl_default_mainLoop();
+    d.lock.lock();
+    d.quitFlag = zftrue;
+    d.lock.unlock();
+    ZFImpl_default_mainThreadWakeup();
+}
+void ZFImpl_default_mainThreadWakeup(void)
+{
+    _ZFP_ZFThreadImpl_default_MainLoop &d = _ZFP_ZFThreadImpl_default_mainLoop();
+    d.lock.lock();
+    d.wakeupFlag = zftrue;
+    if(d.waiting)
+    {
+        d.lock.notifyOne();
+    }
+    ZFImpl_default_MainThreadWakeupCallback wakeupCallback = d.wakeupCallback;
+    d.lock.unlock();
+    if(wakeupCallback != zfnull)
+    {
+        wakeupCallback();
+    }
+}
+zftimet ZFImpl_default_mainThreadNextTimeout(void)
+{
+    _ZFP_ZFThreadImpl_default_MainLoop &d = _ZFP_ZFThreadImpl_default_mainLoop();
+    zftimet ret = -1;
+    d.lock.lock();
+    if(d.queueHead != zfnull || d.wakeupFlag)
+    {
+        ret = 0;
+    }
+    else if(!d.delayQueue.isEmpty())
+    {
+        ret = zfmMax((zftimet)(d.delayQueue[0]->fireTime - _ZFP_ZFThreadImpl_default_timestamp()), (zftimet)0);
+    }
+    d.lock.unlock();
+    return ret;
+}
+void ZFImpl_default_mainThreadWakeupCallback(ZF_IN ZFImpl_default_MainThreadWakeupCallback callback)
+{
+    _ZFP_ZFThreadImpl_default_MainLoop &d = _ZFP_ZFThreadImpl_default_mainLoop();
+    d.lock.lock();
+    d.wakeupCallback = callback;
+    d.lock.unlock();
+}
 
 // ============================================================
 // global data
 typedef zfstlmap<_ZFP_ZFThreadImpl_default_NativeThreadIdType, ZFThread *> _ZFP_ZFThreadImpl_default_ThreadMapType;
+zfclassNotPOD _ZFP_ZFThreadImpl_default_ThreadMapHolder
+{
+public:
+    _ZFP_ZFThreadImpl_default_Lock lock;
+    _ZFP_ZFThreadImpl_default_ThreadMapType threadMap;
+};
+// workers may still access it after ZFFrameworkCleanup, so it's never freed
+static _ZFP_ZFThreadImpl_default_ThreadMapHolder &_ZFP_ZFThreadImpl_default_threadMapHolder(void)
+{
+    static _ZFP_ZFThreadImpl_default_ThreadMapHolder *d = zfnew(_ZFP_ZFThreadImpl_default_ThreadMapHolder);
+    return *d;
+}
+#define _ZFP_ZFThreadImpl_default_threadMapLock (_ZFP_ZFThreadImpl_default_threadMapHolder().lock)
+#define _ZFP_ZFThreadImpl_default_threadMap (_ZFP_ZFThreadImpl_default_threadMapHolder().threadMap)
+
 ZF_GLOBAL_INITIALIZER_INIT_WITH_LEVEL(ZFThreadImpl_default_DataHolder, ZFLevelZFFrameworkHigh)
 {
     mainThread = zfAlloc(ZFThreadMainThread);
-    syncObj = zfAlloc(ZFObject);
-    threadMap[_ZFP_ZFThreadImpl_default_getNativeThreadId()] = mainThread;
+    _ZFP_ZFThreadImpl_default_mainLoop().mainThreadId = _ZFP_ZFThreadImpl_default_getNativeThreadId();
+    _ZFP_ZFThreadImpl_default_threadMapLock.lock();
+    _ZFP_ZFThreadImpl_default_threadMap[_ZFP_ZFThreadImpl_default_getNativeThreadId()] = mainThread;
+    _ZFP_ZFThreadImpl_default_threadMapLock.unlock();
+    _ZFP_ZFThreadImpl_default_poolShutdown(zffalse);
 }
 ZF_GLOBAL_INITIALIZER_DESTROY(ZFThreadImpl_default_DataHolder)
 {
-    zfRelease(syncObj);
+    _ZFP_ZFThreadImpl_default_poolShutdown(zftrue);
+    _ZFP_ZFThreadImpl_default_mainLoopCleanup();
+    _ZFP_ZFThreadImpl_default_threadMapLock.lock();
+    _ZFP_ZFThreadImpl_default_threadMap.erase(_ZFP_ZFThreadImpl_default_getNativeThreadId());
+    _ZFP_ZFThreadImpl_default_threadMapLock.unlock();
     zfRelease(mainThread);
 }
 public:
     ZFThread *mainThread;
-    ZFObject *syncObj;
-    _ZFP_ZFThreadImpl_default_ThreadMapType threadMap;
 ZF_GLOBAL_INITIALIZER_END(ZFThreadImpl_default_DataHolder)
-#define _ZFP_ZFThreadImpl_default_syncObj (ZF_GLOBAL_INITIALIZER_INSTANCE(ZFThreadImpl_default_DataHolder)->syncObj)
 #define _ZFP_ZFThreadImpl_default_mainThread (ZF_GLOBAL_INITIALIZER_INSTANCE(ZFThreadImpl_default_DataHolder)->mainThread)
-#define _ZFP_ZFThreadImpl_default_threadMap (ZF_GLOBAL_INITIALIZER_INSTANCE(ZFThreadImpl_default_DataHolder)->threadMap)
 
 void _ZFP_ZFThreadImpl_default_threadCallback(_ZFP_ZFThreadImpl_default_ExecuteData *data)
 {
     _ZFP_ZFThreadImpl_default_NativeThreadIdType nativeCurrentThreadId = _ZFP_ZFThreadImpl_default_getNativeThreadId();
-    zfsynchronizeLock(_ZFP_ZFThreadImpl_default_syncObj);
+    _ZFP_ZFThreadImpl_default_threadMapLock.lock();
     _ZFP_ZFThreadImpl_default_threadMap[nativeCurrentThreadId] = data->ownerZFThread;
-    zfsynchronizeUnlock(_ZFP_ZFThreadImpl_default_syncObj);
+    _ZFP_ZFThreadImpl_default_threadMapLock.unlock();
 
     data->runnable.execute(ZFListenerData().param0(data->param0).param1(data->param1));
 
-    zfsynchronizeLock(_ZFP_ZFThreadImpl_default_syncObj);
+    _ZFP_ZFThreadImpl_default_threadMapLock.lock();
     _ZFP_ZFThreadImpl_default_threadMap.erase(nativeCurrentThreadId);
-    zfsynchronizeUnlock(_ZFP_ZFThreadImpl_default_syncObj);
+    _ZFP_ZFThreadImpl_default_threadMapLock.unlock();
 
     zfdelete(data);
 }
@@ -121,29 +915,49 @@ void _ZFP_ZFThreadImpl_default_threadCallback(_ZFP_ZFThreadImpl_default_ExecuteD
 // ============================================================
 ZFPROTOCOL_IMPLEMENTATION_BEGIN(ZFThreadImpl_default, ZFThread, ZFProtocolLevel::e_Default)
 public:
+    zfoverride
+    virtual void protocolOnInit(void)
+    {
+        zfsuper::protocolOnInit();
+        // let the default main entry drive the main thread run loop
+        ZFImpl_default_mainLoopImplSet(ZFImpl_default_mainThreadRun, ZFImpl_default_mainThreadQuit);
+    }
+    zfoverride
+    virtual void protocolOnDealloc(void)
+    {
+        ZFImpl_default_mainLoopImplSet(zfnull, zfnull);
+        zfsuper::protocolOnDealloc();
+    }
     virtual void *nativeThreadRegister(ZF_IN ZFThread *ownerZFThread)
     {
         _ZFP_ZFThreadImpl_default_NativeThreadIdType *token = zfnew(_ZFP_ZFThreadImpl_default_NativeThreadIdType);
         *token = _ZFP_ZFThreadImpl_default_getNativeThreadId();
-        zfCoreAssertWithMessage(_ZFP_ZFThreadImpl_default_threadMap.find(*token) == _ZFP_ZFThreadImpl_default_threadMap.end(),
+        _ZFP_ZFThreadImpl_default_threadMapLock.lock();
+        zfbool exist = (_ZFP_ZFThreadImpl_default_threadMap.find(*token) != _ZFP_ZFThreadImpl_default_threadMap.end());
+        if(!exist)
+        {
+            _ZFP_ZFThreadImpl_default_threadMap[*token] = ownerZFThread;
+        }
+        _ZFP_ZFThreadImpl_default_threadMapLock.unlock();
+        zfCoreAssertWithMessage(!exist,
             "thread already registered: %s", ownerZFThread->objectInfo().cString());
-        _ZFP_ZFThreadImpl_default_threadMap[*token] = ownerZFThread;
         return ZFCastStatic(void *, token);
     }
     virtual void nativeThreadUnregister(ZF_IN void *token)
     {
+        _ZFP_ZFThreadImpl_default_threadMapLock.lock();
         _ZFP_ZFThreadImpl_default_threadMap.erase(_ZFP_ZFThreadImpl_default_getNativeThreadId());
+        _ZFP_ZFThreadImpl_default_threadMapLock.unlock();
         zfdelete(ZFCastStatic(_ZFP_ZFThreadImpl_default_NativeThreadIdType *, token));
     }
     virtual ZFThread *threadForToken(ZF_IN void *token)
     {
+        _ZFP_ZFThreadImpl_default_threadMapLock.lock();
         _ZFP_ZFThreadImpl_default_ThreadMapType::iterator it = _ZFP_ZFThreadImpl_default_threadMap.find(
             *ZFCastStatic(_ZFP_ZFThreadImpl_default_NativeThreadIdType *, token));
-        if(it != _ZFP_ZFThreadImpl_default_threadMap.end())
-        {
-            return it->second;
-        }
-        return zfnull;
+        ZFThread *ret = ((it != _ZFP_ZFThreadImpl_default_threadMap.end()) ? it->second : zfnull);
+        _ZFP_ZFThreadImpl_default_threadMapLock.unlock();
+        return ret;
     }
     virtual ZFThread *mainThread(void)
     {
@@ -153,33 +967,42 @@ public:
     {
         _ZFP_ZFThreadImpl_default_NativeThreadIdType nativeCurrentThread = _ZFP_ZFThreadImpl_default_getNativeThreadId();
 
-        zfsynchronize(_ZFP_ZFThreadImpl_default_syncObj);
+        _ZFP_ZFThreadImpl_default_threadMapLock.lock();
         _ZFP_ZFThreadImpl_default_ThreadMapType::const_iterator it = _ZFP_ZFThreadImpl_default_threadMap.find(nativeCurrentThread);
-        if(it == _ZFP_ZFThreadImpl_default_threadMap.end())
+        ZFThread *ret = ((it != _ZFP_ZFThreadImpl_default_threadMap.end()) ? it->second : zfnull);
+        _ZFP_ZFThreadImpl_default_threadMapLock.unlock();
+        if(ret == zfnull)
         {
             zfCoreLogTrim("current thread is null, make sure the thread is started or registered by ZFThread");
-            return zfnull;
         }
-        return it->second;
+        return ret;
     }
 
     virtual void sleep(ZF_IN zftimet miliSecs)
     {
         _ZFP_ZFThreadImpl_default_sleep(miliSecs);
     }
+    virtual zfindex processorCount(void)
+    {
+        return _ZFP_ZFThreadImpl_default_cpuCount();
+    }
 
     virtual void *executeInMainThread(ZF_IN zfidentity taskId,
                                       ZF_IN const ZFListener &runnable,
                                       ZF_IN ZFObject *param0,
                                       ZF_IN ZFObject *param1)
     {
-        zfCoreCriticalMessageTrim("[ZFThread] executeInMainThread not available");
-        return zfnull;
+        _ZFP_ZFThreadImpl_default_MainTask *task = zfpoolNew(_ZFP_ZFThreadImpl_default_MainTask, runnable, param0, param1);
+        _ZFP_ZFThreadImpl_default_mainLoopAdd(task, 0);
+        return task;
     }
     virtual void executeInMainThreadCancel(ZF_IN zfidentity taskId,
                                            ZF_IN void *nativeToken)
     {
-        // nothing to do
+        if(nativeToken != zfnull)
+        {
+            _ZFP_ZFThreadImpl_default_mainLoopCancel(ZFCastStatic(_ZFP_ZFThreadImpl_default_MainTask *, nativeToken));
+        }
     }
 
     virtual void *executeInNewThread(ZF_IN zfidentity taskId,
@@ -188,14 +1011,15 @@ public:
                                      ZF_IN ZFObject *param0,
                                      ZF_IN ZFObject *param1)
     {
-        _ZFP_ZFThreadImpl_default_ExecuteData *data = zfnew(_ZFP_ZFThreadImpl_default_ExecuteData, ownerZFThread, runnable, param0, param1);
-        _ZFP_ZFThreadImpl_default_startNativeThread(data);
+        _ZFP_ZFThreadImpl_default_ExecuteData *data = zfnew(_ZFP_ZFThreadImpl_default_ExecuteData, taskId, ownerZFThread, runnable, param0, param1);
+        _ZFP_ZFThreadImpl_default_poolAdd(data);
         return zfnull;
     }
     virtual void executeInNewThreadCancel(ZF_IN zfidentity taskId,
                                           ZF_IN void *nativeToken)
     {
-        // nothing to do
+        // remove from pool if not started
+        _ZFP_ZFThreadImpl_default_poolCancel(taskId);
     }
 
     virtual void *executeInMainThreadAfterDelay(ZF_IN zfidentity taskId,
@@ -204,13 +1028,17 @@ public:
                                                 ZF_IN ZFObject *param0,
                                                 ZF_IN ZFObject *param1)
     {
-        zfCoreCriticalMessageTrim("[ZFThread] executeInMainThreadAfterDelay not available");
-        return zfnull;
+        _ZFP_ZFThreadImpl_default_MainTask *task = zfpoolNew(_ZFP_ZFThreadImpl_default_MainTask, runnable, param0, param1);
+        _ZFP_ZFThreadImpl_default_mainLoopAdd(task, delay);
+        return task;
     }
     virtual void executeInMainThreadAfterDelayCancel(ZF_IN zfidentity taskId,
                                                      ZF_IN void *nativeToken)
     {
-        zfCoreCriticalMessageTrim("[ZFThread] executeInMainThreadAfterDelay not available");
+        if(nativeToken != zfnull)
+        {
+            _ZFP_ZFThreadImpl_default_mainLoopCancel(ZFCastStatic(_ZFP_ZFThreadImpl_default_MainTask *, nativeToken));
+        }
     }
 ZFPROTOCOL_IMPLEMENTATION_END(ZFThreadImpl_default)
 ZFPROTOCOL_IMPLEMENTATION_REGISTER(ZFThreadImpl_default)
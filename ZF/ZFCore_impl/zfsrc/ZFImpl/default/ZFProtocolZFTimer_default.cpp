@@ -1,129 +1,448 @@
 #include "ZFImpl_default_ZFCore_impl.h"
 #include "ZFCore/protocol/ZFProtocolZFTimer.h"
 #include "ZFCore/ZFThread.h"
+#include "ZFCore/ZFTime.h"
+#include "ZFCore/ZFSemaphore.h"
 
 ZF_NAMESPACE_GLOBAL_BEGIN
 
-zfclass _ZFP_ZFTimerImpl_default_Timer : zfextends ZFObject
-{
-    ZFOBJECT_DECLARE_WITH_CUSTOM_CTOR(_ZFP_ZFTimerImpl_default_Timer, ZFObject)
+// ============================================================
+// all timers are driven by one service thread with a hierarchical timing wheel:
+// -  level 0 has 256 slots of 1 mili second,
+//   level 1 ~ 4 have 64 slots each, and each slot covers a whole lower level,
+//   timers in higher level are cascaded to lower level when lower level wraps
+// -  timers are scheduled against absolute deadline of ZFTime::timestamp,
+//   next deadline is always previous deadline plus interval,
+//   so that timer events never drift
+// -  start and stop only link or unlink the timer from its slot, which is O(1)
+#define _ZFP_ZFTimerImpl_default_Level0Bits 8
+#define _ZFP_ZFTimerImpl_default_LevelNBits 6
+#define _ZFP_ZFTimerImpl_default_Level0Size (1 << _ZFP_ZFTimerImpl_default_Level0Bits)
+#define _ZFP_ZFTimerImpl_default_LevelNSize (1 << _ZFP_ZFTimerImpl_default_LevelNBits)
+#define _ZFP_ZFTimerImpl_default_LevelNCount 4
+// max delta that can be held by the wheel, further deadline would be clamped and re-scheduled when expired
+#define _ZFP_ZFTimerImpl_default_DeltaMax (((zft_zfint64)1 << (_ZFP_ZFTimerImpl_default_Level0Bits + _ZFP_ZFTimerImpl_default_LevelNBits * _ZFP_ZFTimerImpl_default_LevelNCount)) - 1)
 
+zfclassNotPOD _ZFP_ZFTimerImpl_default_Timer
+{
 public:
     ZFPROTOCOL_INTERFACE_CLASS(ZFTimer) *impl;
     ZFTimer *timer;
-private:
-    zfbool timerThreadStarted;
-    zfidentity threadCallbackTaskId;
-    zfidentity threadCallbackId;
-    zfidentity mainThreadCallbackTaskId;
-    zfidentity mainThreadCallbackId;
-protected:
+
+    // guarded by wheel's lock
+    _ZFP_ZFTimerImpl_default_Timer *prev;
+    _ZFP_ZFTimerImpl_default_Timer *next;
+    _ZFP_ZFTimerImpl_default_Timer **slot; // null if not scheduled
+    zft_zfint64 deadline; // absolute time of next timer event
+    zft_zfint64 expires; // deadline clamped to the wheel's range
+    zft_zfint64 interval;
+    zfbool activateInMainThread;
+    zfbool timerStartNotified;
+    zfindex generation; // changed each time the timer started or stopped, to ignore outdated events
+    zfbool mainThreadPending; // whether there's an event queued to main thread
+    zfindex mainThreadGeneration;
+
+public:
     _ZFP_ZFTimerImpl_default_Timer(void)
     : impl(zfnull)
     , timer(zfnull)
-    , timerThreadStarted(zffalse)
-    , threadCallbackTaskId(zfidentityInvalid())
-    , threadCallbackId(zfidentityInvalid())
-    , mainThreadCallbackTaskId(zfidentityInvalid())
-    , mainThreadCallbackId(zfidentityInvalid())
+    , prev(zfnull)
+    , next(zfnull)
+    , slot(zfnull)
+    , deadline(0)
+    , expires(0)
+    , interval(0)
+    , activateInMainThread(zffalse)
+    , timerStartNotified(zffalse)
+    , generation(0)
+    , mainThreadPending(zffalse)
+    , mainThreadGeneration(0)
     {
     }
+};
 
+zfclassPOD _ZFP_ZFTimerImpl_default_FireItem
+{
+public:
+    _ZFP_ZFTimerImpl_default_Timer *t;
+    zfindex generation;
+    zfbool activateInMainThread;
+};
+
+zfclassNotPOD _ZFP_ZFTimerImpl_default_Wheel
+{
 public:
-    zffinal void timerStart(void)
-    {
-        ++(this->threadCallbackTaskId);
-        this->threadCallbackId = ZFThreadExecuteInNewThread(
-            ZFCallbackForMemberMethod(this, ZFMethodAccess(zfself, threadCallback)),
-            this /* pass this as dummy param to keep retain count */,
-            ZFListenerData().param0(zflineAlloc(v_zfidentity, this->threadCallbackTaskId))
-            );
-    }
-    zffinal void timerStop(void)
-    {
-        ++(this->threadCallbackTaskId);
-        ++(this->mainThreadCallbackTaskId);
-        ZFThreadExecuteCancel(this->threadCallbackId);
-        ZFThreadExecuteCancel(this->mainThreadCallbackId);
-        if(this->timerThreadStarted)
+    ZFSemaphore *sema;
+    zfbool shutdown;
+    zfidentity serviceTaskId;
+    zfbool serviceWaiting;
+    zft_zfint64 serviceWakeTime; // -1 if waiting until any timer started
+    zft_zfint64 wheelTime; // next tick to process
+    zfindex timerCount; // number of scheduled timers
+    _ZFP_ZFTimerImpl_default_Timer *level0[_ZFP_ZFTimerImpl_default_Level0Size];
+    _ZFP_ZFTimerImpl_default_Timer *levelN[_ZFP_ZFTimerImpl_default_LevelNCount][_ZFP_ZFTimerImpl_default_LevelNSize];
+    ZFCoreArrayPOD<_ZFP_ZFTimerImpl_default_FireItem> fireList; // accessed by service thread only
+};
+// service thread would access it until it exits, so not accessed by ZF_GLOBAL_INITIALIZER_INSTANCE
+static _ZFP_ZFTimerImpl_default_Wheel *_ZFP_ZFTimerImpl_default_wheel = zfnull;
+
+static inline zft_zfint64 _ZFP_ZFTimerImpl_default_timestamp(void)
+{
+    return (zft_zfint64)ZFTime::timestamp();
+}
+
+static void _ZFP_ZFTimerImpl_default_wheelAdd(ZF_IN _ZFP_ZFTimerImpl_default_Wheel *w,
+                                              ZF_IN _ZFP_ZFTimerImpl_default_Timer *t)
+{
+    zft_zfint64 expires = t->deadline;
+    if(expires < w->wheelTime)
+    {
+        expires = w->wheelTime;
+    }
+    zft_zfint64 delta = expires - w->wheelTime;
+    if(delta > _ZFP_ZFTimerImpl_default_DeltaMax)
+    {
+        delta = _ZFP_ZFTimerImpl_default_DeltaMax;
+        expires = w->wheelTime + delta;
+    }
+    t->expires = expires;
+
+    _ZFP_ZFTimerImpl_default_Timer **slot = zfnull;
+    if(delta < _ZFP_ZFTimerImpl_default_Level0Size)
+    {
+        slot = &(w->level0[expires & (_ZFP_ZFTimerImpl_default_Level0Size - 1)]);
+    }
+    else
+    {
+        zfindex level = 0;
+        while(level + 1 < _ZFP_ZFTimerImpl_default_LevelNCount
+            && (delta >> (_ZFP_ZFTimerImpl_default_Level0Bits + _ZFP_ZFTimerImpl_default_LevelNBits * (level + 1))) != 0)
         {
-            this->timerThreadStarted = zffalse;
-            this->impl->notifyTimerStop(this->timer);
+            ++level;
         }
+        zfindex index = (zfindex)((expires >> (_ZFP_ZFTimerImpl_default_Level0Bits + _ZFP_ZFTimerImpl_default_LevelNBits * level))
+            & (_ZFP_ZFTimerImpl_default_LevelNSize - 1));
+        slot = &(w->levelN[level][index]);
     }
 
-public:
-    ZFLISTENER_INLINE(threadCallback)
+    t->slot = slot;
+    t->prev = zfnull;
+    t->next = *slot;
+    if(*slot != zfnull)
+    {
+        (*slot)->prev = t;
+    }
+    *slot = t;
+    ++(w->timerCount);
+}
+static void _ZFP_ZFTimerImpl_default_wheelRemove(ZF_IN _ZFP_ZFTimerImpl_default_Wheel *w,
+                                                 ZF_IN _ZFP_ZFTimerImpl_default_Timer *t)
+{
+    if(t->prev != zfnull)
+    {
+        t->prev->next = t->next;
+    }
+    else
+    {
+        *(t->slot) = t->next;
+    }
+    if(t->next != zfnull)
+    {
+        t->next->prev = t->prev;
+    }
+    t->prev = zfnull;
+    t->next = zfnull;
+    t->slot = zfnull;
+    --(w->timerCount);
+}
+// move timers in the slot to lower level, return the slot index
+static zfindex _ZFP_ZFTimerImpl_default_wheelCascade(ZF_IN _ZFP_ZFTimerImpl_default_Wheel *w,
+                                                     ZF_IN zfindex level)
+{
+    zfindex index = (zfindex)((w->wheelTime >> (_ZFP_ZFTimerImpl_default_Level0Bits + _ZFP_ZFTimerImpl_default_LevelNBits * level))
+        & (_ZFP_ZFTimerImpl_default_LevelNSize - 1));
+    _ZFP_ZFTimerImpl_default_Timer *t = w->levelN[level][index];
+    w->levelN[level][index] = zfnull;
+    while(t != zfnull)
+    {
+        _ZFP_ZFTimerImpl_default_Timer *next = t->next;
+        --(w->timerCount);
+        _ZFP_ZFTimerImpl_default_wheelAdd(w, t);
+        t = next;
+    }
+    return index;
+}
+// process ticks until now, expired timers are rescheduled and stored to fireList
+static void _ZFP_ZFTimerImpl_default_wheelAdvance(ZF_IN _ZFP_ZFTimerImpl_default_Wheel *w,
+                                                  ZF_IN zft_zfint64 now)
+{
+    if(w->timerCount == 0)
+    {
+        w->wheelTime = zfmMax(w->wheelTime, now);
+        return ;
+    }
+    while(w->wheelTime <= now)
     {
-        zfidentity curId = listenerData.param0<v_zfidentity *>()->zfv;
+        zfindex index = (zfindex)(w->wheelTime & (_ZFP_ZFTimerImpl_default_Level0Size - 1));
+        if(index == 0)
+        {
+            for(zfindex level = 0; level < _ZFP_ZFTimerImpl_default_LevelNCount; ++level)
+            {
+                if(_ZFP_ZFTimerImpl_default_wheelCascade(w, level) != 0)
+                {
+                    break;
+                }
+            }
+        }
+
+        _ZFP_ZFTimerImpl_default_Timer *t = w->level0[index];
+        w->level0[index] = zfnull;
+        ++(w->wheelTime);
+        while(t != zfnull)
+        {
+            _ZFP_ZFTimerImpl_default_Timer *next = t->next;
+            t->prev = zfnull;
+            t->next = zfnull;
+            t->slot = zfnull;
+            --(w->timerCount);
+
+            if(t->expires >= t->deadline)
+            {
+                _ZFP_ZFTimerImpl_default_FireItem item;
+                item.t = t;
+                item.generation = t->generation;
+                item.activateInMainThread = t->activateInMainThread;
+                if(!item.activateInMainThread || !t->mainThreadPending)
+                {
+                    if(item.activateInMainThread)
+                    {
+                        t->mainThreadPending = zftrue;
+                        t->mainThreadGeneration = t->generation;
+                    }
+                    zfRetain(t->timer);
+                    w->fireList.add(item);
+                }
 
-        // delay
-        if(curId != this->threadCallbackTaskId) {return ;}
-        if(this->timer->timerDelay() > 0)
+                // schedule next by absolute deadline, skip events that already missed
+                t->deadline += t->interval;
+                if(t->deadline <= now)
+                {
+                    t->deadline += ((now - t->deadline) / t->interval + 1) * t->interval;
+                }
+            }
+            _ZFP_ZFTimerImpl_default_wheelAdd(w, t);
+            t = next;
+        }
+    }
+}
+// time of next tick that may have timer to fire, or -1 if no timer scheduled
+static zft_zfint64 _ZFP_ZFTimerImpl_default_wheelNext(ZF_IN _ZFP_ZFTimerImpl_default_Wheel *w)
+{
+    if(w->timerCount == 0)
+    {
+        return -1;
+    }
+    zfindex index = (zfindex)(w->wheelTime & (_ZFP_ZFTimerImpl_default_Level0Size - 1));
+    for(zfindex i = index; i < _ZFP_ZFTimerImpl_default_Level0Size; ++i)
+    {
+        if(w->level0[i] != zfnull)
         {
-            ZFThread::sleep(this->timer->timerDelay());
+            return w->wheelTime + (i - index);
         }
+    }
+    // wake up when level 0 wraps, to cascade higher levels
+    return w->wheelTime + (_ZFP_ZFTimerImpl_default_Level0Size - index);
+}
 
-        // start
-        if(curId != this->threadCallbackTaskId) {return ;}
-        this->timerThreadStarted = zftrue;
-        this->impl->notifyTimerStart(this->timer);
-        if(curId != this->threadCallbackTaskId) {return ;}
+static void _ZFP_ZFTimerImpl_default_timerFire(ZF_IN _ZFP_ZFTimerImpl_default_Wheel *w,
+                                               ZF_IN _ZFP_ZFTimerImpl_default_Timer *t,
+                                               ZF_IN zfindex generation)
+{
+    w->sema->semaphoreLock();
+    zfbool valid = (t->generation == generation);
+    zfbool notifyStart = (valid && !t->timerStartNotified);
+    if(notifyStart)
+    {
+        t->timerStartNotified = zftrue;
+    }
+    w->sema->semaphoreUnlock();
+    if(valid)
+    {
+        if(notifyStart)
+        {
+            t->impl->notifyTimerStart(t->timer);
+        }
+        t->impl->notifyTimerActivate(t->timer);
+    }
+}
+static ZFLISTENER_PROTOTYPE_EXPAND(_ZFP_ZFTimerImpl_default_mainThreadFire)
+{
+    _ZFP_ZFTimerImpl_default_Wheel *w = _ZFP_ZFTimerImpl_default_wheel;
+    if(w == zfnull)
+    {
+        return ;
+    }
+    ZFTimer *timer = ZFCastZFObjectUnchecked(ZFTimer *, userData);
+    _ZFP_ZFTimerImpl_default_Timer *t = ZFCastStatic(_ZFP_ZFTimerImpl_default_Timer *, timer->nativeTimer());
+    w->sema->semaphoreLock();
+    t->mainThreadPending = zffalse;
+    zfindex generation = t->mainThreadGeneration;
+    w->sema->semaphoreUnlock();
+    _ZFP_ZFTimerImpl_default_timerFire(w, t, generation);
+}
+static ZFLISTENER_PROTOTYPE_EXPAND(_ZFP_ZFTimerImpl_default_serviceRun)
+{
+    _ZFP_ZFTimerImpl_default_Wheel *w = _ZFP_ZFTimerImpl_default_wheel;
+    ZFSemaphore *sema = w->sema;
+    ZFCoreArrayPOD<_ZFP_ZFTimerImpl_default_FireItem> &fireList = w->fireList;
+    sema->semaphoreLock();
+    while(!w->shutdown)
+    {
+        zft_zfint64 now = _ZFP_ZFTimerImpl_default_timestamp();
+        _ZFP_ZFTimerImpl_default_wheelAdvance(w, now);
+        if(fireList.isEmpty())
+        {
+            w->serviceWakeTime = _ZFP_ZFTimerImpl_default_wheelNext(w);
+            w->serviceWaiting = zftrue;
+            if(w->serviceWakeTime < 0)
+            {
+                sema->semaphoreWait();
+            }
+            else if(w->serviceWakeTime > now)
+            {
+                sema->semaphoreWait((zftimet)(w->serviceWakeTime - now));
+            }
+            w->serviceWaiting = zffalse;
+            continue;
+        }
+        sema->semaphoreUnlock();
 
-        // timer
-        while(curId == this->threadCallbackTaskId)
+        for(zfindex i = 0; i < fireList.count(); ++i)
         {
-            if(this->timer->timerActivateInMainThread())
+            const _ZFP_ZFTimerImpl_default_FireItem &item = fireList[i];
+            if(item.activateInMainThread)
             {
-                ++(this->mainThreadCallbackTaskId);
-                this->mainThreadCallbackId = ZFThreadExecuteInNewThread(
-                    ZFCallbackForMemberMethod(this, ZFMethodAccess(zfself, mainThreadCallback)),
-                    zfnull,
-                    ZFListenerData().param0(zflineAlloc(v_zfidentity, this->mainThreadCallbackTaskId))
-                    );
+                ZFThreadExecuteInMainThread(ZFCallbackForFunc(_ZFP_ZFTimerImpl_default_mainThreadFire), item.t->timer);
             }
             else
             {
-                this->impl->notifyTimerActivate(this->timer);
+                _ZFP_ZFTimerImpl_default_timerFire(w, item.t, item.generation);
             }
-            ZFThread::sleep(this->timer->timerInterval());
         }
+        // release outside of lock, since timer may be deallocated
+        for(zfindex i = 0; i < fireList.count(); ++i)
+        {
+            zfRelease(fireList[i].t->timer);
+        }
+        fireList.removeAll();
+
+        sema->semaphoreLock();
     }
-    ZFLISTENER_INLINE(mainThreadCallback)
+    sema->semaphoreUnlock();
+}
+
+ZF_GLOBAL_INITIALIZER_INIT_WITH_LEVEL(ZFTimerImpl_default_DataHolder, ZFLevelZFFrameworkNormal)
+{
+    _ZFP_ZFTimerImpl_default_Wheel *w = zfnew(_ZFP_ZFTimerImpl_default_Wheel);
+    w->sema = zfAlloc(ZFSemaphore);
+    w->shutdown = zffalse;
+    w->serviceTaskId = zfidentityInvalid();
+    w->serviceWaiting = zffalse;
+    w->serviceWakeTime = -1;
+    w->wheelTime = _ZFP_ZFTimerImpl_default_timestamp();
+    w->timerCount = 0;
+    zfmemset(w->level0, 0, sizeof(w->level0));
+    zfmemset(w->levelN, 0, sizeof(w->levelN));
+    _ZFP_ZFTimerImpl_default_wheel = w;
+}
+ZF_GLOBAL_INITIALIZER_DESTROY(ZFTimerImpl_default_DataHolder)
+{
+    _ZFP_ZFTimerImpl_default_Wheel *w = _ZFP_ZFTimerImpl_default_wheel;
+    w->sema->semaphoreLock();
+    w->shutdown = zftrue;
+    w->sema->semaphoreBroadcast();
+    w->sema->semaphoreUnlock();
+    if(w->serviceTaskId != zfidentityInvalid())
     {
-        zfidentity curId = listenerData.param0<v_zfidentity *>()->zfv;
-        if(curId != this->mainThreadCallbackTaskId) {return ;}
-        this->impl->notifyTimerActivate(this->timer);
+        ZFThreadExecuteWait(w->serviceTaskId);
     }
-};
+    _ZFP_ZFTimerImpl_default_wheel = zfnull;
+    zfRelease(w->sema);
+    zfdelete(w);
+}
+ZF_GLOBAL_INITIALIZER_END(ZFTimerImpl_default_DataHolder)
 
+// ============================================================
 ZFPROTOCOL_IMPLEMENTATION_BEGIN(ZFTimerImpl_default, ZFTimer, ZFProtocolLevel::e_Default)
     ZFPROTOCOL_IMPLEMENTATION_PLATFORM_HINT("ZFFramework:ZFThread")
 public:
     virtual void *nativeTimerCreate(ZF_IN ZFTimer *timer)
     {
-        _ZFP_ZFTimerImpl_default_Timer *token = zfAlloc(_ZFP_ZFTimerImpl_default_Timer);
-        token->impl = this;
-        token->timer = timer;
-        return token;
+        _ZFP_ZFTimerImpl_default_Timer *t = zfnew(_ZFP_ZFTimerImpl_default_Timer);
+        t->impl = this;
+        t->timer = timer;
+        return t;
     }
     virtual void nativeTimerDestroy(ZF_IN ZFTimer *timer,
                                     ZF_IN void *nativeTimer)
     {
-        _ZFP_ZFTimerImpl_default_Timer *token = ZFCastStatic(_ZFP_ZFTimerImpl_default_Timer *, nativeTimer);
-        zfRelease(token);
+        _ZFP_ZFTimerImpl_default_Timer *t = ZFCastStatic(_ZFP_ZFTimerImpl_default_Timer *, nativeTimer);
+        zfdelete(t);
     }
     virtual void timerStart(ZF_IN ZFTimer *timer)
     {
-        _ZFP_ZFTimerImpl_default_Timer *token = ZFCastStatic(_ZFP_ZFTimerImpl_default_Timer *, timer->nativeTimer());
-        token->impl = this;
-        token->timer = timer;
-        token->timerStart();
+        _ZFP_ZFTimerImpl_default_Wheel *w = _ZFP_ZFTimerImpl_default_wheel;
+        if(w == zfnull)
+        {
+            return ;
+        }
+        _ZFP_ZFTimerImpl_default_Timer *t = ZFCastStatic(_ZFP_ZFTimerImpl_default_Timer *, timer->nativeTimer());
+        zft_zfint64 delay = (zft_zfint64)timer->timerDelay();
+        if(delay < 10)
+        {
+            delay = 0;
+        }
+
+        w->sema->semaphoreLock();
+        t->impl = this;
+        t->timer = timer;
+        t->interval = zfmMax((zft_zfint64)timer->timerInterval(), (zft_zfint64)1);
+        t->activateInMainThread = timer->timerActivateInMainThread();
+        t->timerStartNotified = zffalse;
+        ++(t->generation);
+        zft_zfint64 now = _ZFP_ZFTimerImpl_default_timestamp();
+        if(w->timerCount == 0)
+        {
+            // wheel may be out of date if no timer scheduled
+            w->wheelTime = zfmMax(w->wheelTime, now);
+        }
+        t->deadline = now + delay + t->interval;
+        _ZFP_ZFTimerImpl_default_wheelAdd(w, t);
+        if(w->serviceTaskId == zfidentityInvalid())
+        {
+            w->serviceTaskId = ZFThreadExecuteInNewThread(ZFCallbackForFunc(_ZFP_ZFTimerImpl_default_serviceRun));
+        }
+        else if(w->serviceWaiting && (w->serviceWakeTime < 0 || t->expires < w->serviceWakeTime))
+        {
+            w->sema->semaphoreSignal();
+        }
+        w->sema->semaphoreUnlock();
     }
     virtual void timerStop(ZF_IN ZFTimer *timer)
     {
-        _ZFP_ZFTimerImpl_default_Timer *token = ZFCastStatic(_ZFP_ZFTimerImpl_default_Timer *, timer->nativeTimer());
-        token->timerStop();
+        _ZFP_ZFTimerImpl_default_Wheel *w = _ZFP_ZFTimerImpl_default_wheel;
+        _ZFP_ZFTimerImpl_default_Timer *t = ZFCastStatic(_ZFP_ZFTimerImpl_default_Timer *, timer->nativeTimer());
+        if(w != zfnull)
+        {
+            w->sema->semaphoreLock();
+            ++(t->generation);
+            if(t->slot != zfnull)
+            {
+                _ZFP_ZFTimerImpl_default_wheelRemove(w, t);
+            }
+            w->sema->semaphoreUnlock();
+        }
+        this->notifyTimerStop(timer);
     }
 ZFPROTOCOL_IMPLEMENTATION_END(ZFTimerImpl_default)
 ZFPROTOCOL_IMPLEMENTATION_REGISTER(ZFTimerImpl_default)
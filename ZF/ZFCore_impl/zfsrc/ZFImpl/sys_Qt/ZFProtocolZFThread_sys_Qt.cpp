@@ -215,6 +215,11 @@ public:
     {
         QThread::msleep(miliSecs);
     }
+    virtual zfindex processorCount(void)
+    {
+        int n = QThread::idealThreadCount();
+        return (n > 0 ? (zfindex)n : 1);
+    }
 
     virtual void *executeInMainThread(ZF_IN zfidentity taskId,
                                       ZF_IN const ZFListener &runnable,
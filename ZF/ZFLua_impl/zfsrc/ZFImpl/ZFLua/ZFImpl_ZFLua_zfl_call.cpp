@@ -24,6 +24,54 @@ ZFImpl_ZFLua_implSetupCallback_DEFINE(zfl_call, {
     })
 
 // ============================================================
+// numbers, booleans and strings are passed as unboxed values,
+// return false if any param can only be passed as boxed object
+static zfbool _ZFP_ZFImpl_ZFLua_zfl_call_paramUnbox(ZF_OUT ZFMethodGenericValue *paramList,
+                                                    ZF_IN lua_State *L,
+                                                    ZF_IN int paramCount,
+                                                    ZF_IN int luaParamOffset)
+{
+    for(int i = 0; i < paramCount; ++i)
+    {
+        int luaStackOffset = luaParamOffset + i;
+        ZFMethodGenericValue &param = paramList[i];
+        switch(lua_type(L, luaStackOffset))
+        {
+            case LUA_TNUMBER:
+                param.type = ZFMethodGenericValueTypeDouble;
+                param.v.vDouble = (zft_zfdouble)lua_tonumber(L, luaStackOffset);
+                break;
+            case LUA_TBOOLEAN:
+                param.type = ZFMethodGenericValueTypeBool;
+                param.v.vBool = (zfbool)lua_toboolean(L, luaStackOffset);
+                break;
+            case LUA_TSTRING:
+                param.type = ZFMethodGenericValueTypeString;
+                param.v.vString = lua_tostring(L, luaStackOffset);
+                break;
+            case LUA_TUSERDATA:
+            {
+                ZFObject *obj = ZFImpl_ZFLua_luaGet(L, luaStackOffset);
+                ZFDI_WrapperBase *wrapper = ZFCastZFObject(ZFDI_WrapperBase *, obj);
+                if(wrapper != zfnull)
+                {
+                    param.type = ZFMethodGenericValueTypeString;
+                    param.v.vString = wrapper->zfv();
+                }
+                else
+                {
+                    param.type = ZFMethodGenericValueTypeObject;
+                    param.v.vObject = obj;
+                }
+                break;
+            }
+            default:
+                return zffalse;
+        }
+    }
+    return zftrue;
+}
+
 /*
  * type can be:
  * -  string type
@@ -38,6 +86,17 @@ static int _ZFP_ZFImpl_ZFLua_zfl_call_impl(ZF_IN lua_State *L,
                                            ZF_IN int paramCount,
                                            ZF_IN int luaParamOffset)
 {
+    {
+        ZFMethodGenericValue paramUnboxed[ZFMETHOD_MAX_PARAM];
+        zfautoObject ret;
+        if(_ZFP_ZFImpl_ZFLua_zfl_call_paramUnbox(paramUnboxed, L, paramCount, luaParamOffset)
+            && ZFDI_invokeUnboxed(ret, obj, NS, type, (zfindex)paramCount, paramUnboxed))
+        {
+            ZFImpl_ZFLua_luaPush(L, ret);
+            return 1;
+        }
+    }
+
     zfautoObject paramList[ZFMETHOD_MAX_PARAM];
     for(zfindex i = 0; i < ZFMETHOD_MAX_PARAM; ++i)
     {
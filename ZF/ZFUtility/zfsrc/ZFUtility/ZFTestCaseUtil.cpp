@@ -43,7 +43,7 @@ zfbool ZFTestCaseRun(ZF_IN const zfchar *classNameFull,
 
 // ============================================================
 static ZFLISTENER_PROTOTYPE_EXPAND(_ZFP_ZFTestCaseRunAllHolder_testCaseOnFinish);
-ZF_GLOBAL_INITIALIZER_INIT_WITH_LEVEL(ZFTestCaseRunAllHolder, ZFLevelZFFrameworkEssential)
+ZF_GLOBAL_INITIALIZER_INIT_WITH_LEVEL_AND_FLAGS(ZFTestCaseRunAllHolder, ZFLevelZFFrameworkEssential, ZFGlobalInitializerFlagLazy)
 {
     this->running = zffalse;
     this->testCaseRunning = zfnull;
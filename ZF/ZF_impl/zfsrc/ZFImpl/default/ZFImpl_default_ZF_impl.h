@@ -6,6 +6,22 @@
 
 ZF_NAMESPACE_GLOBAL_BEGIN
 
+// ============================================================
+// main loop for default main entry
+/** @brief see #ZFImpl_default_mainLoopImplSet */
+typedef void (*ZFImpl_default_MainLoopCallback)(void);
+/**
+ * @brief set the main thread run loop driven by the default main entry
+ *
+ * the default main entry would call run after #ZFMainExecute returned 0,
+ * and quit would be called when #ZFFrameworkCleanup
+ * (e.g. by #ZFApp::appExit), to stop run\n
+ * typically set by the default #ZFThread implementation,
+ * set null to remove
+ */
+extern ZF_ENV_EXPORT void ZFImpl_default_mainLoopImplSet(ZF_IN ZFImpl_default_MainLoopCallback run,
+                                                         ZF_IN ZFImpl_default_MainLoopCallback quit);
+
 ZF_NAMESPACE_GLOBAL_END
 #endif // #ifndef _ZFI_ZFImpl_default_ZF_impl_h_
 
@@ -1,8 +1,43 @@
 #include "ZFImpl_default_ZF_impl.h"
 #include "ZFCore.h"
 
+ZF_NAMESPACE_GLOBAL_BEGIN
+
+static ZFImpl_default_MainLoopCallback _ZFP_ZFImpl_default_mainLoopRun = zfnull;
+static ZFImpl_default_MainLoopCallback _ZFP_ZFImpl_default_mainLoopQuit = zfnull;
+void ZFImpl_default_mainLoopImplSet(ZF_IN ZFImpl_default_MainLoopCallback run,
+                                    ZF_IN ZFImpl_default_MainLoopCallback quit)
+{
+    _ZFP_ZFImpl_default_mainLoopRun = run;
+    _ZFP_ZFImpl_default_mainLoopQuit = quit;
+}
+
+ZF_NAMESPACE_GLOBAL_END
+
 #if !ZF_ENV_sys_Android && !ZF_ENV_sys_iOS && !ZF_ENV_sys_Qt
 
+ZF_NAMESPACE_GLOBAL_BEGIN
+static void _ZFP_ZFImpl_default_mainLoopOnCleanup(void)
+{
+    if(_ZFP_ZFImpl_default_mainLoopQuit != zfnull)
+    {
+        _ZFP_ZFImpl_default_mainLoopQuit();
+    }
+}
+// run until ZFFrameworkCleanup
+static void _ZFP_ZFImpl_default_mainLoop(ZF_IN zfint mainResult)
+{
+    // access ZFThread so that its impl has chance to set the main loop
+    if(mainResult != 0 || !ZFProtocolIsAvailable("ZFThread") || _ZFP_ZFImpl_default_mainLoopRun == zfnull)
+    {
+        return ;
+    }
+    ZFFrameworkCleanupPrepareCallbacks.add(_ZFP_ZFImpl_default_mainLoopOnCleanup);
+    _ZFP_ZFImpl_default_mainLoopRun();
+    ZFFrameworkCleanupPrepareCallbacks.removeElement(_ZFP_ZFImpl_default_mainLoopOnCleanup);
+}
+ZF_NAMESPACE_GLOBAL_END
+
 #if !ZF_ENV_sys_WindowsCE
 int main(int argc, char **argv)
 #else // #if ZF_ENV_sys_WindowsCE
@@ -11,7 +46,16 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPWSTR lpCmdLin
 {
 
 #if !ZF_ENV_sys_WindowsCE
-    return ZFMainCommonEntry(argc, argv);
+    ZFFrameworkInit();
+    ZFCoreArray<zfstring> params;
+    for(int i = 0; i < argc; ++i)
+    {
+        params.add(argv[i]);
+    }
+    zfint result = ZFMainExecute(params);
+    _ZFP_ZFImpl_default_mainLoop(result);
+    ZFFrameworkCleanup();
+    return result;
 #else
     ZFFrameworkInit();
     ZFArrayEditable *params = zfAlloc(ZFArrayEditable);
@@ -27,6 +71,7 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPWSTR lpCmdLin
 
     zfint result = ZFMainExecute(params);
     zfRelease(params);
+    _ZFP_ZFImpl_default_mainLoop(result);
     ZFFrameworkCleanup();
     return result;
 #endif // #if ZF_ENV_sys_WindowsCE #else
@@ -0,0 +1,92 @@
+#include "ZFAlgorithm_test.h"
+
+ZF_NAMESPACE_GLOBAL_BEGIN
+
+#define _ZFP_ZFAlgorithm_ZFJsonIterator_test_itemCount 5
+
+zfclass ZFAlgorithm_ZFJsonIterator_test : zfextends ZFFramework_test_TestCase
+{
+    ZFOBJECT_DECLARE(ZFAlgorithm_ZFJsonIterator_test, ZFFramework_test_TestCase)
+
+protected:
+    zfoverride
+    virtual void testCaseOnStart(void)
+    {
+        zfsuper::testCaseOnStart();
+
+        ZFJsonItem json(ZFJsonType::e_JsonObject);
+        for(zfindex i = 0; i < _ZFP_ZFAlgorithm_ZFJsonIterator_test_itemCount; ++i)
+        {
+            json.jsonItemValue(zfstringWithFormat("k%zi", i), zfstringWithFormat("v%zi", i));
+        }
+
+        this->testCaseOutputSeparator();
+        this->testCaseOutput("copy keeps position, and moves independently");
+        {
+            zfiterator it = json.jsonItemIterator();
+            json.jsonItemIteratorNextKey(it);
+            zfiterator copied(it);
+            ZFTestCaseAssert(json.jsonItemIteratorIsEqual(it, copied));
+            ZFTestCaseAssert(zfscmpTheSame(json.jsonItemIteratorKey(copied), "k1"));
+            ZFTestCaseAssert(this->remainCount(json, copied) == 4);
+            ZFTestCaseAssert(!json.jsonItemIteratorIsValid(copied));
+            ZFTestCaseAssert(zfscmpTheSame(json.jsonItemIteratorKey(it), "k1"));
+        }
+
+        this->testCaseOutputSeparator();
+        this->testCaseOutput("assign");
+        {
+            zfiterator it = json.jsonItemIteratorForKey("k2");
+            zfiterator assigned = json.jsonItemIterator();
+            assigned = it;
+            ZFTestCaseAssert(json.jsonItemIteratorIsEqual(it, assigned));
+            assigned = assigned;
+            ZFTestCaseAssert(json.jsonItemIteratorIsEqual(it, assigned));
+            ZFTestCaseAssert(zfscmpTheSame(json.jsonItemIteratorNextKey(assigned), "k2"));
+            ZFTestCaseAssert(zfscmpTheSame(json.jsonItemIteratorKey(assigned), "k3"));
+            ZFTestCaseAssert(zfscmpTheSame(json.jsonItemIteratorKey(it), "k2"));
+
+            // from and to an iterator that holds no data
+            zfiterator empty;
+            assigned = empty;
+            ZFTestCaseAssert(!json.jsonItemIteratorIsValid(assigned));
+            empty = it;
+            ZFTestCaseAssert(json.jsonItemIteratorIsEqual(it, empty));
+            ZFTestCaseAssert(this->remainCount(json, empty) == 3);
+
+            ZFTestCaseAssert(!json.jsonItemIteratorIsValid(json.jsonItemIteratorForKey("notExist")));
+        }
+
+        this->testCaseOutputSeparator();
+        this->testCaseOutput("remove by copy");
+        {
+            zfiterator it = json.jsonItemIteratorForKey("k3");
+            zfiterator copied = it;
+            json.jsonItemIteratorRemove(copied);
+            ZFTestCaseAssert(json.jsonItemCount() == _ZFP_ZFAlgorithm_ZFJsonIterator_test_itemCount - 1);
+            ZFTestCaseAssert(json.jsonItem("k3").jsonIsNull());
+            // both point to the item after the removed one
+            ZFTestCaseAssert(zfscmpTheSame(json.jsonItemIteratorKey(it), "k4"));
+            ZFTestCaseAssert(zfscmpTheSame(json.jsonItemIteratorKey(copied), "k4"));
+        }
+
+        this->testCaseStop();
+    }
+
+private:
+    zfindex remainCount(ZF_IN const ZFJsonItem &json,
+                        ZF_IN_OUT zfiterator &it)
+    {
+        zfindex ret = 0;
+        while(json.jsonItemIteratorIsValid(it))
+        {
+            json.jsonItemIteratorNextKey(it);
+            ++ret;
+        }
+        return ret;
+    }
+};
+ZFOBJECT_REGISTER(ZFAlgorithm_ZFJsonIterator_test)
+
+ZF_NAMESPACE_GLOBAL_END
+
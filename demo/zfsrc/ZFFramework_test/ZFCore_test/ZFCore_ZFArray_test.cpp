@@ -0,0 +1,197 @@
+#include "ZFCore_test.h"
+
+ZF_NAMESPACE_GLOBAL_BEGIN
+
+// content events in order, "a" for add, "r" for remove, "c" for change
+static zfstring _ZFP_ZFCore_ZFArray_test_events;
+static ZFLISTENER_PROTOTYPE_EXPAND(_ZFP_ZFCore_ZFArray_test_onEvent)
+{
+    if(listenerData.eventId() == ZFContainer::EventContentOnAdd())
+    {
+        _ZFP_ZFCore_ZFArray_test_events += "a";
+    }
+    else if(listenerData.eventId() == ZFContainer::EventContentOnRemove())
+    {
+        _ZFP_ZFCore_ZFArray_test_events += "r";
+    }
+    else if(listenerData.eventId() == ZFContainer::EventContentOnChange())
+    {
+        _ZFP_ZFCore_ZFArray_test_events += "c";
+    }
+}
+
+zfclass ZFCore_ZFArray_test : zfextends ZFFramework_test_TestCase
+{
+    ZFOBJECT_DECLARE(ZFCore_ZFArray_test, ZFFramework_test_TestCase)
+
+protected:
+    zfoverride
+    virtual void testCaseOnStart(void)
+    {
+        zfsuper::testCaseOnStart();
+
+        zfblockedAlloc(ZFArrayEditable, array);
+        array->observerAdd(ZFContainer::EventContentOnAdd(), ZFCallbackForFunc(_ZFP_ZFCore_ZFArray_test_onEvent));
+        array->observerAdd(ZFContainer::EventContentOnRemove(), ZFCallbackForFunc(_ZFP_ZFCore_ZFArray_test_onEvent));
+        array->observerAdd(ZFContainer::EventContentOnChange(), ZFCallbackForFunc(_ZFP_ZFCore_ZFArray_test_onEvent));
+
+        this->testCaseOutputSeparator();
+        this->testCaseOutput("capacity");
+        {
+            array->capacity(100);
+            ZFTestCaseAssert(array->capacity() >= 100);
+            ZFTestCaseAssert(array->count() == 0);
+            ZFTestCaseAssert(_ZFP_ZFCore_ZFArray_test_events.isEmpty());
+        }
+
+        this->testCaseOutputSeparator();
+        this->testCaseOutput("addFromRange");
+        {
+            this->arrayReset(array, "0 1 2 3");
+            zfblockedAlloc(ZFArrayEditable, another);
+            this->arrayReset(another, "4 5 6");
+            array->addFromRange(another, 1);
+            ZFTestCaseAssert(this->arrayInfo(array) == "0 1 2 3 5 6");
+            ZFTestCaseAssert(_ZFP_ZFCore_ZFArray_test_events == "aac");
+            ZFTestCaseAssert(array->get(4) == another->get(1));
+
+            _ZFP_ZFCore_ZFArray_test_events.removeAll();
+            array->addFromRange(another, 3);
+            array->addFromRange(another, 0, 0);
+            ZFTestCaseAssert(this->arrayInfo(array) == "0 1 2 3 5 6");
+            ZFTestCaseAssert(_ZFP_ZFCore_ZFArray_test_events.isEmpty());
+        }
+
+        this->testCaseOutputSeparator();
+        this->testCaseOutput("addFromRange from self");
+        {
+            this->arrayReset(array, "0 1 2 3");
+            ZFObject *first = array->get(1);
+            array->addFromRange(array, 1, 2);
+            ZFTestCaseAssert(this->arrayInfo(array) == "0 1 2 3 1 2");
+            ZFTestCaseAssert(array->get(4) == first);
+            ZFTestCaseAssert(_ZFP_ZFCore_ZFArray_test_events == "aac");
+
+            // whole array, larger than reserved capacity
+            _ZFP_ZFCore_ZFArray_test_events.removeAll();
+            array->addFromRange(array, 0);
+            ZFTestCaseAssert(this->arrayInfo(array) == "0 1 2 3 1 2 0 1 2 3 1 2");
+            ZFTestCaseAssert(_ZFP_ZFCore_ZFArray_test_events == "aaaaaac");
+        }
+
+        this->testCaseOutputSeparator();
+        this->testCaseOutput("addFrom");
+        {
+            this->arrayReset(array, "0");
+            zfblockedAlloc(ZFArrayEditable, another);
+            this->arrayReset(another, "1 2");
+            array->addFrom(another);
+            ZFTestCaseAssert(this->arrayInfo(array) == "0 1 2");
+            ZFTestCaseAssert(_ZFP_ZFCore_ZFArray_test_events == "aac");
+        }
+
+        this->testCaseOutputSeparator();
+        this->testCaseOutput("remove range");
+        {
+            this->arrayReset(array, "0 1 2 3 4 5");
+            array->remove(1, 3);
+            ZFTestCaseAssert(this->arrayInfo(array) == "0 4 5");
+            ZFTestCaseAssert(_ZFP_ZFCore_ZFArray_test_events == "rrrc");
+
+            // count exceeds the end
+            _ZFP_ZFCore_ZFArray_test_events.removeAll();
+            array->remove(1, 100);
+            ZFTestCaseAssert(this->arrayInfo(array) == "0");
+            ZFTestCaseAssert(_ZFP_ZFCore_ZFArray_test_events == "rrc");
+        }
+
+        this->testCaseOutputSeparator();
+        this->testCaseOutput("removeElementAll notifies remove before change");
+        {
+            this->arrayReset(array, "1 2 1 3 1");
+            zfblockedAlloc(v_zfint, toRemove, 1);
+            ZFTestCaseAssert(array->removeElementAll(toRemove) == 3);
+            ZFTestCaseAssert(this->arrayInfo(array) == "2 3");
+            ZFTestCaseAssert(_ZFP_ZFCore_ZFArray_test_events == "rrrc");
+
+            _ZFP_ZFCore_ZFArray_test_events.removeAll();
+            ZFTestCaseAssert(array->removeElementAll(toRemove) == 0);
+            ZFTestCaseAssert(_ZFP_ZFCore_ZFArray_test_events.isEmpty());
+        }
+
+        this->testCaseOutputSeparator();
+        this->testCaseOutput("sort is stable");
+        {
+            this->arrayReset(array, "3 1 2 1 0");
+            ZFObject *firstOne = array->get(1);
+            ZFObject *secondOne = array->get(3);
+
+            array->sort(zftrue, 0, zfindexMax(), ZFComparerForZFObject);
+            ZFTestCaseAssert(this->arrayInfo(array) == "0 1 1 2 3");
+            ZFTestCaseAssert(array->get(1) == firstOne && array->get(2) == secondOne);
+            ZFTestCaseAssert(_ZFP_ZFCore_ZFArray_test_events == "c");
+
+            _ZFP_ZFCore_ZFArray_test_events.removeAll();
+            array->sort(zffalse, 0, zfindexMax(), ZFComparerForZFObject);
+            ZFTestCaseAssert(this->arrayInfo(array) == "3 2 1 1 0");
+            ZFTestCaseAssert(array->get(2) == firstOne && array->get(3) == secondOne);
+            ZFTestCaseAssert(_ZFP_ZFCore_ZFArray_test_events == "c");
+
+            // sub range only
+            _ZFP_ZFCore_ZFArray_test_events.removeAll();
+            array->sort(zftrue, 1, 3, ZFComparerForZFObject);
+            ZFTestCaseAssert(this->arrayInfo(array) == "3 1 1 2 0");
+            ZFTestCaseAssert(array->get(1) == firstOne && array->get(2) == secondOne);
+            ZFTestCaseAssert(_ZFP_ZFCore_ZFArray_test_events == "c");
+        }
+
+        this->testCaseOutputSeparator();
+        this->testCaseOutput("removeAll");
+        {
+            this->arrayReset(array, "0 1 2");
+            array->removeAll();
+            ZFTestCaseAssert(array->count() == 0);
+            ZFTestCaseAssert(_ZFP_ZFCore_ZFArray_test_events == "crrr");
+        }
+
+        array->observerRemoveAll(ZFContainer::EventContentOnAdd());
+        array->observerRemoveAll(ZFContainer::EventContentOnRemove());
+        array->observerRemoveAll(ZFContainer::EventContentOnChange());
+        _ZFP_ZFCore_ZFArray_test_events.removeAll();
+
+        this->testCaseStop();
+    }
+
+private:
+    // reset content to space separated single digits, and clear recorded events
+    void arrayReset(ZF_IN ZFArrayEditable *array, ZF_IN const zfchar *content)
+    {
+        array->removeAll();
+        for(const zfchar *p = content; *p != '\0'; ++p)
+        {
+            if(*p >= '0' && *p <= '9')
+            {
+                zfblockedAlloc(v_zfint, element, (zfint)(*p - '0'));
+                array->add(element);
+            }
+        }
+        _ZFP_ZFCore_ZFArray_test_events.removeAll();
+    }
+    zfstring arrayInfo(ZF_IN ZFArray *array)
+    {
+        zfstring ret;
+        for(zfindex i = 0; i < array->count(); ++i)
+        {
+            if(i != 0)
+            {
+                ret += " ";
+            }
+            zfsFromIntT(ret, array->get(i)->to<v_zfint *>()->zfv);
+        }
+        return ret;
+    }
+};
+ZFOBJECT_REGISTER(ZFCore_ZFArray_test)
+
+ZF_NAMESPACE_GLOBAL_END
+
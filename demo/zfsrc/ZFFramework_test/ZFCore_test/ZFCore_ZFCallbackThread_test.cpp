@@ -0,0 +1,169 @@
+#include "ZFCore_test.h"
+
+ZF_NAMESPACE_GLOBAL_BEGIN
+
+#define _ZFP_ZFCore_ZFCallbackThread_test_threadCount 4
+#define _ZFP_ZFCore_ZFCallbackThread_test_loopCount 10000
+
+static zfatomicint _ZFP_ZFCore_ZFCallbackThread_test_executeCount = 0;
+// copies that lost the callback id or tag
+static zfatomicint _ZFP_ZFCore_ZFCallbackThread_test_errorCount = 0;
+static zfatomicint _ZFP_ZFCore_ZFCallbackThread_test_deallocCount = 0;
+static zfatomicint _ZFP_ZFCore_ZFCallbackThread_test_nextIndex = 0;
+
+// ============================================================
+// held by the callback's tag, dealloc when the last copy of the callback destroyed
+zfclass _ZFP_ZFCore_ZFCallbackThread_test_Tag : zfextends ZFObject
+{
+    ZFOBJECT_DECLARE(_ZFP_ZFCore_ZFCallbackThread_test_Tag, ZFObject)
+
+protected:
+    zfoverride
+    virtual void objectOnDealloc(void)
+    {
+        zfAtomicIncrease(_ZFP_ZFCore_ZFCallbackThread_test_deallocCount);
+        zfsuper::objectOnDealloc();
+    }
+};
+ZFOBJECT_REGISTER(_ZFP_ZFCore_ZFCallbackThread_test_Tag)
+
+static void _ZFP_ZFCore_ZFCallbackThread_test_func(void)
+{
+    zfAtomicIncrease(_ZFP_ZFCore_ZFCallbackThread_test_executeCount);
+}
+
+static ZFCallback *_ZFP_ZFCore_ZFCallbackThread_test_shared = zfnull;
+// one copy for each thread, deleted by the thread
+static ZFCallback *_ZFP_ZFCore_ZFCallbackThread_test_copies[_ZFP_ZFCore_ZFCallbackThread_test_threadCount];
+
+static void _ZFP_ZFCore_ZFCallbackThread_test_check(ZF_IN const ZFCallback &callback)
+{
+    if(!zfscmpTheSame(callback.callbackId(), "ZFCallbackThreadTest")
+        || callback.callbackTag("tag") == zfnull)
+    {
+        zfAtomicIncrease(_ZFP_ZFCore_ZFCallbackThread_test_errorCount);
+    }
+}
+
+static ZFLISTENER_PROTOTYPE_EXPAND(_ZFP_ZFCore_ZFCallbackThread_test_copyAndAssign)
+{
+    const ZFCallback &shared = *_ZFP_ZFCore_ZFCallbackThread_test_shared;
+    ZFCallback assigned;
+    for(zfindex i = 0; i < _ZFP_ZFCore_ZFCallbackThread_test_loopCount; ++i)
+    {
+        ZFCallback copied(shared);
+        assigned = copied;
+        _ZFP_ZFCore_ZFCallbackThread_test_check(assigned);
+        assigned.executeExact<void>();
+        assigned = ZFCallback();
+    }
+}
+static ZFLISTENER_PROTOTYPE_EXPAND(_ZFP_ZFCore_ZFCallbackThread_test_copyThenDelete)
+{
+    zfindex index = (zfindex)zfAtomicIncrease(_ZFP_ZFCore_ZFCallbackThread_test_nextIndex) - 1;
+    ZFCallback *own = _ZFP_ZFCore_ZFCallbackThread_test_copies[index];
+    for(zfindex i = 0; i < _ZFP_ZFCore_ZFCallbackThread_test_loopCount; ++i)
+    {
+        ZFCallback copied(*own);
+        copied.executeExact<void>();
+    }
+    _ZFP_ZFCore_ZFCallbackThread_test_check(*own);
+    zfdelete(own);
+}
+
+zfclass ZFCore_ZFCallbackThread_test : zfextends ZFFramework_test_TestCase
+{
+    ZFOBJECT_DECLARE(ZFCore_ZFCallbackThread_test, ZFFramework_test_TestCase)
+
+protected:
+    zfoverride
+    virtual void testCaseOnStart(void)
+    {
+        zfsuper::testCaseOnStart();
+        ZFFramework_test_protocolCheck(ZFThread);
+
+        zfidentity taskIds[_ZFP_ZFCore_ZFCallbackThread_test_threadCount];
+        zfint total = _ZFP_ZFCore_ZFCallbackThread_test_threadCount * _ZFP_ZFCore_ZFCallbackThread_test_loopCount;
+
+        this->testCaseOutputSeparator();
+        this->testCaseOutput("copy and assign a shared callback concurrently");
+        {
+            this->counterReset();
+            this->sharedCreate();
+            for(zfindex i = 0; i < _ZFP_ZFCore_ZFCallbackThread_test_threadCount; ++i)
+            {
+                taskIds[i] = ZFThreadExecuteInNewThread(ZFCallbackForFunc(_ZFP_ZFCore_ZFCallbackThread_test_copyAndAssign));
+            }
+            for(zfindex i = 0; i < _ZFP_ZFCore_ZFCallbackThread_test_threadCount; ++i)
+            {
+                ZFThreadExecuteWait(taskIds[i]);
+            }
+            this->counterOutput();
+            ZFTestCaseAssert(_ZFP_ZFCore_ZFCallbackThread_test_shared->objectRetainCount() == 1);
+            ZFTestCaseAssert(zfAtomicLoad(_ZFP_ZFCore_ZFCallbackThread_test_executeCount) == total);
+            ZFTestCaseAssert(zfAtomicLoad(_ZFP_ZFCore_ZFCallbackThread_test_errorCount) == 0);
+            ZFTestCaseAssert(zfAtomicLoad(_ZFP_ZFCore_ZFCallbackThread_test_deallocCount) == 0);
+
+            zfdelete(_ZFP_ZFCore_ZFCallbackThread_test_shared);
+            _ZFP_ZFCore_ZFCallbackThread_test_shared = zfnull;
+            ZFTestCaseAssert(zfAtomicLoad(_ZFP_ZFCore_ZFCallbackThread_test_deallocCount) == 1);
+        }
+
+        this->testCaseOutputSeparator();
+        this->testCaseOutput("last copy destroyed in other thread");
+        {
+            this->counterReset();
+            this->sharedCreate();
+            for(zfindex i = 0; i < _ZFP_ZFCore_ZFCallbackThread_test_threadCount; ++i)
+            {
+                _ZFP_ZFCore_ZFCallbackThread_test_copies[i] = zfnew(ZFCallback, *_ZFP_ZFCore_ZFCallbackThread_test_shared);
+            }
+            zfdelete(_ZFP_ZFCore_ZFCallbackThread_test_shared);
+            _ZFP_ZFCore_ZFCallbackThread_test_shared = zfnull;
+            ZFTestCaseAssert(_ZFP_ZFCore_ZFCallbackThread_test_copies[0]->objectRetainCount() == _ZFP_ZFCore_ZFCallbackThread_test_threadCount);
+
+            for(zfindex i = 0; i < _ZFP_ZFCore_ZFCallbackThread_test_threadCount; ++i)
+            {
+                taskIds[i] = ZFThreadExecuteInNewThread(ZFCallbackForFunc(_ZFP_ZFCore_ZFCallbackThread_test_copyThenDelete));
+            }
+            for(zfindex i = 0; i < _ZFP_ZFCore_ZFCallbackThread_test_threadCount; ++i)
+            {
+                ZFThreadExecuteWait(taskIds[i]);
+            }
+            this->counterOutput();
+            ZFTestCaseAssert(zfAtomicLoad(_ZFP_ZFCore_ZFCallbackThread_test_executeCount) == total);
+            ZFTestCaseAssert(zfAtomicLoad(_ZFP_ZFCore_ZFCallbackThread_test_errorCount) == 0);
+            ZFTestCaseAssert(zfAtomicLoad(_ZFP_ZFCore_ZFCallbackThread_test_deallocCount) == 1);
+        }
+
+        this->testCaseStop();
+    }
+
+private:
+    void sharedCreate(void)
+    {
+        _ZFP_ZFCore_ZFCallbackThread_test_shared = zfnew(ZFCallback,
+            ZFCallbackForFunc(_ZFP_ZFCore_ZFCallbackThread_test_func));
+        _ZFP_ZFCore_ZFCallbackThread_test_shared->callbackId("ZFCallbackThreadTest");
+        _ZFP_ZFCore_ZFCallbackThread_test_shared->callbackTag("tag",
+            zflineAlloc(_ZFP_ZFCore_ZFCallbackThread_test_Tag));
+    }
+    void counterReset(void)
+    {
+        zfAtomicStore(_ZFP_ZFCore_ZFCallbackThread_test_executeCount, 0);
+        zfAtomicStore(_ZFP_ZFCore_ZFCallbackThread_test_errorCount, 0);
+        zfAtomicStore(_ZFP_ZFCore_ZFCallbackThread_test_deallocCount, 0);
+        zfAtomicStore(_ZFP_ZFCore_ZFCallbackThread_test_nextIndex, 0);
+    }
+    void counterOutput(void)
+    {
+        this->testCaseOutput("execute: %d, error: %d, dealloc: %d",
+            (zfint)zfAtomicLoad(_ZFP_ZFCore_ZFCallbackThread_test_executeCount),
+            (zfint)zfAtomicLoad(_ZFP_ZFCore_ZFCallbackThread_test_errorCount),
+            (zfint)zfAtomicLoad(_ZFP_ZFCore_ZFCallbackThread_test_deallocCount));
+    }
+};
+ZFOBJECT_REGISTER(ZFCore_ZFCallbackThread_test)
+
+ZF_NAMESPACE_GLOBAL_END
+
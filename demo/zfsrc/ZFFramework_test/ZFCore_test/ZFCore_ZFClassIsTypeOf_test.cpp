@@ -0,0 +1,113 @@
+#include "ZFCore_test.h"
+
+ZF_NAMESPACE_GLOBAL_BEGIN
+
+#define _ZFP_ZFCore_ZFClassIsTypeOf_test_chainDepth 24
+
+// ============================================================
+// not registered by ZFOBJECT_REGISTER,
+// so that they are registered lazily when first accessed during the test
+zfinterface _ZFP_ZFCore_ZFClassIsTypeOf_test_LateInterface : zfextends ZFInterface
+{
+    ZFINTERFACE_DECLARE(_ZFP_ZFCore_ZFClassIsTypeOf_test_LateInterface, ZFInterface)
+};
+zfinterface _ZFP_ZFCore_ZFClassIsTypeOf_test_LateInterfaceChild : zfextends _ZFP_ZFCore_ZFClassIsTypeOf_test_LateInterface
+{
+    ZFINTERFACE_DECLARE(_ZFP_ZFCore_ZFClassIsTypeOf_test_LateInterfaceChild, _ZFP_ZFCore_ZFClassIsTypeOf_test_LateInterface)
+};
+zfclass _ZFP_ZFCore_ZFClassIsTypeOf_test_LateImpl : zfextends ZFObject, zfimplements _ZFP_ZFCore_ZFClassIsTypeOf_test_LateInterfaceChild
+{
+    ZFOBJECT_DECLARE(_ZFP_ZFCore_ZFClassIsTypeOf_test_LateImpl, ZFObject)
+    ZFIMPLEMENTS_DECLARE(_ZFP_ZFCore_ZFClassIsTypeOf_test_LateInterfaceChild)
+};
+
+zfclass ZFCore_ZFClassIsTypeOf_test : zfextends ZFFramework_test_TestCase
+{
+    ZFOBJECT_DECLARE(ZFCore_ZFClassIsTypeOf_test, ZFFramework_test_TestCase)
+
+protected:
+    zfoverride
+    virtual void testCaseOnStart(void)
+    {
+        zfsuper::testCaseOnStart();
+
+        this->testCaseOutputSeparator();
+        this->testCaseOutput("deep class chain");
+        {
+            const ZFClass *chain[_ZFP_ZFCore_ZFClassIsTypeOf_test_chainDepth];
+            const ZFClass *sibling[_ZFP_ZFCore_ZFClassIsTypeOf_test_chainDepth];
+            const ZFClass *parent = ZFObject::ClassData();
+            for(zfindex i = 0; i < _ZFP_ZFCore_ZFClassIsTypeOf_test_chainDepth; ++i)
+            {
+                chain[i] = ZFClassDynamicRegister(zfstringWithFormat("_ZFP_ZFCore_ZFClassIsTypeOf_test_Chain%zi", i), parent);
+                sibling[i] = ZFClassDynamicRegister(zfstringWithFormat("_ZFP_ZFCore_ZFClassIsTypeOf_test_Sibling%zi", i), parent);
+                ZFTestCaseAssert(chain[i] != zfnull && sibling[i] != zfnull);
+                parent = chain[i];
+            }
+
+            for(zfindex i = 0; i < _ZFP_ZFCore_ZFClassIsTypeOf_test_chainDepth; ++i)
+            {
+                ZFTestCaseAssert(chain[i]->classIsTypeOf(ZFObject::ClassData()));
+                ZFTestCaseAssert(!ZFObject::ClassData()->classIsTypeOf(chain[i]));
+                for(zfindex j = 0; j < _ZFP_ZFCore_ZFClassIsTypeOf_test_chainDepth; ++j)
+                {
+                    ZFTestCaseAssert(chain[i]->classIsTypeOf(chain[j]) == (i >= j));
+                    // sibling[j] has same depth as chain[j], but is not a parent of any chain class
+                    ZFTestCaseAssert(!chain[i]->classIsTypeOf(sibling[j]));
+                    ZFTestCaseAssert(sibling[i]->classIsTypeOf(chain[j]) == (i > j));
+                }
+            }
+
+            for(zfindex i = _ZFP_ZFCore_ZFClassIsTypeOf_test_chainDepth - 1; i != zfindexMax(); --i)
+            {
+                ZFClassDynamicUnregister(sibling[i]);
+                ZFClassDynamicUnregister(chain[i]);
+            }
+        }
+
+        this->testCaseOutputSeparator();
+        this->testCaseOutput("interface registered after other classes");
+        {
+            // registered before the interfaces exist
+            const ZFClass *early = ZFClassDynamicRegister("_ZFP_ZFCore_ZFClassIsTypeOf_test_Early", ZFObject::ClassData());
+            ZFTestCaseAssert(early != zfnull);
+
+            // first access registers the interfaces
+            const ZFClass *impl = _ZFP_ZFCore_ZFClassIsTypeOf_test_LateImpl::ClassData();
+            const ZFClass *interfaceParent = _ZFP_ZFCore_ZFClassIsTypeOf_test_LateInterface::ClassData();
+            const ZFClass *interfaceChild = _ZFP_ZFCore_ZFClassIsTypeOf_test_LateInterfaceChild::ClassData();
+
+            ZFTestCaseAssert(impl->classIsTypeOf(interfaceParent));
+            ZFTestCaseAssert(impl->classIsTypeOf(interfaceChild));
+            ZFTestCaseAssert(interfaceChild->classIsTypeOf(interfaceParent));
+            ZFTestCaseAssert(!interfaceParent->classIsTypeOf(interfaceChild));
+            ZFTestCaseAssert(!early->classIsTypeOf(interfaceParent));
+            ZFTestCaseAssert(!early->classIsTypeOf(interfaceChild));
+            ZFTestCaseAssert(!ZFObject::ClassData()->classIsTypeOf(interfaceParent));
+            ZFTestCaseAssert(!interfaceParent->classIsTypeOf(impl));
+
+            // dynamic subclass of the implementer, registered after the interfaces
+            const ZFClass *implChild = ZFClassDynamicRegister("_ZFP_ZFCore_ZFClassIsTypeOf_test_ImplChild", impl);
+            ZFTestCaseAssert(implChild != zfnull);
+            ZFTestCaseAssert(implChild->classIsTypeOf(impl));
+            ZFTestCaseAssert(implChild->classIsTypeOf(interfaceParent));
+            ZFTestCaseAssert(implChild->classIsTypeOf(interfaceChild));
+            ZFTestCaseAssert(!implChild->classIsTypeOf(early));
+
+            zfautoObject obj = implChild->newInstance();
+            ZFTestCaseAssert(obj != zfnull);
+            ZFTestCaseAssert(obj.toObject()->classData()->classIsTypeOf(interfaceParent));
+            ZFTestCaseAssert(ZFCastZFObject(_ZFP_ZFCore_ZFClassIsTypeOf_test_LateInterfaceChild *, obj) != zfnull);
+            obj = zfnull;
+
+            ZFClassDynamicUnregister(implChild);
+            ZFClassDynamicUnregister(early);
+        }
+
+        this->testCaseStop();
+    }
+};
+ZFOBJECT_REGISTER(ZFCore_ZFClassIsTypeOf_test)
+
+ZF_NAMESPACE_GLOBAL_END
+
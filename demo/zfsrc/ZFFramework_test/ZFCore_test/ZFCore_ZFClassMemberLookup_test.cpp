@@ -0,0 +1,165 @@
+#include "ZFCore_test.h"
+
+ZF_NAMESPACE_GLOBAL_BEGIN
+
+// ============================================================
+zfclass _ZFP_ZFCore_ZFClassMemberLookup_test_Parent : zfextends ZFObject
+{
+    ZFOBJECT_DECLARE(_ZFP_ZFCore_ZFClassMemberLookup_test_Parent, ZFObject)
+};
+ZFOBJECT_REGISTER(_ZFP_ZFCore_ZFClassMemberLookup_test_Parent)
+
+zfclass _ZFP_ZFCore_ZFClassMemberLookup_test_Child : zfextends _ZFP_ZFCore_ZFClassMemberLookup_test_Parent
+{
+    ZFOBJECT_DECLARE(_ZFP_ZFCore_ZFClassMemberLookup_test_Child, _ZFP_ZFCore_ZFClassMemberLookup_test_Parent)
+};
+ZFOBJECT_REGISTER(_ZFP_ZFCore_ZFClassMemberLookup_test_Child)
+
+zfclass ZFCore_ZFClassMemberLookup_test : zfextends ZFFramework_test_TestCase
+{
+    ZFOBJECT_DECLARE(ZFCore_ZFClassMemberLookup_test, ZFFramework_test_TestCase)
+
+protected:
+    zfoverride
+    virtual void testCaseOnStart(void)
+    {
+        zfsuper::testCaseOnStart();
+
+        const ZFClass *parentCls = _ZFP_ZFCore_ZFClassMemberLookup_test_Parent::ClassData();
+        const ZFClass *childCls = _ZFP_ZFCore_ZFClassMemberLookup_test_Child::ClassData();
+
+        this->testCaseOutputSeparator();
+        this->testCaseOutput("method lookup after register and unregister");
+        {
+            // lookup tables must not keep pointers to the caller's name string
+            zfstring name = "lookupFunc";
+
+            ZFMethodUserRegister_0(parentMethod0, {
+                    return 0;
+                }, parentCls,
+                zfint, name.cString()
+                );
+            ZFMethodUserRegister_1(parentMethod1, {
+                    return param0;
+                }, parentCls,
+                zfint, name.cString()
+                , ZFMP_IN(zfint, param0)
+                );
+            name = "modified";
+
+            ZFTestCaseAssert(parentCls->methodForName("lookupFunc") != zfnull);
+            ZFTestCaseAssert(parentCls->methodForName("lookupFunc", ZFTypeId_zfint()) == parentMethod1);
+            ZFTestCaseAssert(parentCls->methodForNameGetAll("lookupFunc").count() == 2);
+            ZFTestCaseAssert(parentCls->methodForName("modified") == zfnull);
+            ZFTestCaseAssert(childCls->methodForName("lookupFunc", ZFTypeId_zfint()) == parentMethod1);
+            ZFTestCaseAssert(childCls->methodForNameIgnoreParent("lookupFunc") == zfnull);
+
+            ZFMethodUserRegister_0(childMethod0, {
+                    return 1;
+                }, childCls,
+                zfint, "lookupFunc"
+                );
+            // subclass first
+            ZFTestCaseAssert(childCls->methodForName("lookupFunc") == childMethod0);
+            ZFTestCaseAssert(childCls->methodForNameIgnoreParent("lookupFunc") == childMethod0);
+            ZFTestCaseAssert(parentCls->methodForName("lookupFunc") != childMethod0);
+
+            ZFMethodUserUnregister(childMethod0);
+            ZFTestCaseAssert(childCls->methodForNameIgnoreParent("lookupFunc") == zfnull);
+            ZFTestCaseAssert(childCls->methodForName("lookupFunc") == parentMethod0);
+
+            // remove the overload whose name was used as the key first
+            ZFMethodUserUnregister(parentMethod0);
+            ZFTestCaseAssert(parentCls->methodForName("lookupFunc") == parentMethod1);
+            ZFTestCaseAssert(childCls->methodForName("lookupFunc") == parentMethod1);
+            ZFTestCaseAssert(parentCls->methodForNameGetAll("lookupFunc").count() == 1);
+
+            ZFMethodUserUnregister(parentMethod1);
+            ZFTestCaseAssert(parentCls->methodForName("lookupFunc") == zfnull);
+            ZFTestCaseAssert(childCls->methodForName("lookupFunc") == zfnull);
+            ZFTestCaseAssert(parentCls->methodForNameGetAll("lookupFunc").isEmpty());
+        }
+
+        this->testCaseOutputSeparator();
+        this->testCaseOutput("property lookup after register and unregister");
+        {
+            zfstring name = "lookupProp";
+            ZFPropertyUserRegisterAssign(property, parentCls,
+                zfint, name.cString(), ZFPropertyNoInitValue,
+                public, public);
+            name = "modified";
+
+            ZFTestCaseAssert(parentCls->propertyForName("lookupProp") == property);
+            ZFTestCaseAssert(childCls->propertyForName("lookupProp") == property);
+            ZFTestCaseAssert(childCls->propertyForNameIgnoreParent("lookupProp") == zfnull);
+            // setter and getter
+            ZFTestCaseAssert(parentCls->methodForNameGetAll("lookupProp").count() == 2);
+
+            ZFPropertyUserUnregister(property);
+            ZFTestCaseAssert(parentCls->propertyForName("lookupProp") == zfnull);
+            ZFTestCaseAssert(childCls->propertyForName("lookupProp") == zfnull);
+            ZFTestCaseAssert(parentCls->methodForNameGetAll("lookupProp").isEmpty());
+
+            ZFPropertyUserRegisterAssign(propertyNew, childCls,
+                zfint, "lookupProp", ZFPropertyNoInitValue,
+                public, public);
+            ZFTestCaseAssert(childCls->propertyForName("lookupProp") == propertyNew);
+            ZFTestCaseAssert(parentCls->propertyForName("lookupProp") == zfnull);
+            ZFPropertyUserUnregister(propertyNew);
+            ZFTestCaseAssert(childCls->propertyForName("lookupProp") == zfnull);
+        }
+
+        this->testCaseOutputSeparator();
+        this->testCaseOutput("lookup while members change between queries");
+        {
+            zfindex methodCountSaved = parentCls->methodCount();
+            ZFCoreArrayPOD<const ZFMethod *> methods;
+            for(zfindex i = 0; i < 64; ++i)
+            {
+                zfstring name = zfstringWithFormat("rebuildFunc%zi", 63 - i);
+                ZFMethodUserRegister_0(method, {
+                        return 0;
+                    }, parentCls,
+                    zfint, name.cString()
+                    );
+                methods.add(method);
+                // each query after a change rebuilds the tables of the class and its children
+                ZFTestCaseAssert(childCls->methodForName(name) == method);
+                ZFTestCaseAssert(parentCls->methodForName(zfstringWithFormat("rebuildFunc%zi", 64 - i)) == (i == 0 ? zfnull : methods[i - 1]));
+            }
+            for(zfindex i = 0; i < methods.count(); ++i)
+            {
+                ZFTestCaseAssert(parentCls->methodForName(methods[i]->methodName()) == methods[i]);
+            }
+
+            // sorted by name
+            ZFTestCaseAssert(parentCls->methodCount() == methodCountSaved + methods.count());
+            ZFCoreArrayPOD<const ZFMethod *> all = parentCls->methodGetAll();
+            for(zfindex i = 1; i < all.count(); ++i)
+            {
+                ZFTestCaseAssert(zfscmp(all[i - 1]->methodName(), all[i]->methodName()) <= 0);
+            }
+
+            for(zfindex i = 0; i < methods.count(); i += 2)
+            {
+                ZFMethodUserUnregister(methods[i]);
+            }
+            for(zfindex i = 0; i < methods.count(); ++i)
+            {
+                ZFTestCaseAssert(childCls->methodForName(zfstringWithFormat("rebuildFunc%zi", 63 - i)) == (i % 2 == 0 ? zfnull : methods[i]));
+            }
+            for(zfindex i = 1; i < methods.count(); i += 2)
+            {
+                ZFMethodUserUnregister(methods[i]);
+            }
+            ZFTestCaseAssert(parentCls->methodForName("rebuildFunc1") == zfnull);
+            ZFTestCaseAssert(parentCls->methodCount() == methodCountSaved);
+        }
+
+        this->testCaseStop();
+    }
+};
+ZFOBJECT_REGISTER(ZFCore_ZFClassMemberLookup_test)
+
+ZF_NAMESPACE_GLOBAL_END
+
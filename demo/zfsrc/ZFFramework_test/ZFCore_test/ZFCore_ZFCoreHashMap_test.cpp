@@ -0,0 +1,190 @@
+#include "ZFCore_test.h"
+
+ZF_NAMESPACE_GLOBAL_BEGIN
+
+zfclass ZFCore_ZFCoreHashMap_test : zfextends ZFFramework_test_TestCase
+{
+    ZFOBJECT_DECLARE(ZFCore_ZFCoreHashMap_test, ZFFramework_test_TestCase)
+
+protected:
+    zfoverride
+    virtual void testCaseOnStart(void)
+    {
+        zfsuper::testCaseOnStart();
+
+        this->testCaseOutputSeparator();
+        this->testCaseOutput("set, get and remove");
+        {
+            ZFCoreHashMap<zfindex> m;
+            ZFTestCaseAssert(m.isEmpty() && m.get("k0") == zfnull && !m.remove("k0"));
+            ZFTestCaseAssert(m.indexFirst() == zfindexMax() && m.indexLast() == zfindexMax());
+            for(zfindex i = 0; i < 100; ++i)
+            {
+                m.set(zfstringWithFormat("k%zi", i), i);
+            }
+            ZFTestCaseAssert(m.count() == 100);
+            for(zfindex i = 0; i < 100; ++i)
+            {
+                zfindex *v = m.get(zfstringWithFormat("k%zi", i));
+                ZFTestCaseAssert(v != zfnull && *v == i);
+            }
+            for(zfindex i = 0; i < 100; i += 2)
+            {
+                ZFTestCaseAssert(m.remove(zfstringWithFormat("k%zi", i)));
+            }
+            ZFTestCaseAssert(m.count() == 50);
+            for(zfindex i = 0; i < 100; ++i)
+            {
+                // removed slots must not break probing of keys after them
+                ZFTestCaseAssert(m.isContain(zfstringWithFormat("k%zi", i)) == (i % 2 != 0));
+            }
+
+            // null key same as empty string
+            m.set(zfnull, 1);
+            ZFTestCaseAssert(m.get("") != zfnull && *m.get("") == 1);
+            ZFTestCaseAssert(m.remove(zfnull) && !m.isContain(""));
+
+            // key is copied
+            zfstring key = "copied";
+            m.set(key, 2);
+            key = "modified";
+            ZFTestCaseAssert(m.isContain("copied") && !m.isContain("modified"));
+
+            m.removeAll();
+            ZFTestCaseAssert(m.isEmpty() && m.indexFirst() == zfindexMax());
+        }
+
+        this->testCaseOutputSeparator();
+        this->testCaseOutput("removed slots are reused");
+        {
+            ZFCoreHashMap<zfindex> m;
+            for(zfindex i = 0; i < 8; ++i)
+            {
+                m.set(zfstringWithFormat("stay%zi", i), i);
+            }
+            zfindex indexMax = 0;
+            for(zfindex i = 0; i < 10000; ++i)
+            {
+                zfstring keyTmp = zfstringWithFormat("tmp%zi", i);
+                zfbool isNew = zffalse;
+                zfindex index = m.indexForAdd(keyTmp, &isNew);
+                ZFTestCaseAssert(isNew);
+                if(index > indexMax)
+                {
+                    indexMax = index;
+                }
+                m.removeAt(index);
+            }
+            this->testCaseOutput("max slot index: %zi", indexMax);
+            // capacity must not grow with the total number of keys ever added
+            ZFTestCaseAssert(indexMax < 64);
+            ZFTestCaseAssert(m.count() == 8);
+            for(zfindex i = 0; i < 8; ++i)
+            {
+                zfindex *v = m.get(zfstringWithFormat("stay%zi", i));
+                ZFTestCaseAssert(v != zfnull && *v == i);
+            }
+        }
+
+        this->testCaseOutputSeparator();
+        this->testCaseOutput("change and remove while iterating");
+        {
+            ZFCoreHashMap<zfindex> m;
+            // exactly reach the load factor, so that creating any new key would rehash
+            for(zfindex i = 0; i < 12; ++i)
+            {
+                m.set(zfstringWithFormat("k%zi", i), i);
+            }
+
+            zfindex visited = 0;
+            for(zfindex i = m.indexFirst(); i != zfindexMax(); i = m.indexNext(i))
+            {
+                zfstring key = m.keyAt(i);
+                // existing key never rehash
+                zfbool isNew = zftrue;
+                ZFTestCaseAssert(m.indexForAdd(key, &isNew) == i && !isNew);
+                m.set(key, m.valueAt(i) + 100);
+                ZFTestCaseAssert(m.keyAt(i) != zfnull && zfscmpTheSame(m.keyAt(i), key));
+                ++visited;
+            }
+            ZFTestCaseAssert(visited == 12 && m.count() == 12);
+            for(zfindex i = 0; i < 12; ++i)
+            {
+                ZFTestCaseAssert(*m.get(zfstringWithFormat("k%zi", i)) == i + 100);
+            }
+
+            // removeAt keeps other slot index
+            visited = 0;
+            for(zfindex i = m.indexFirst(); i != zfindexMax(); i = m.indexNext(i))
+            {
+                if(m.valueAt(i) % 2 == 0)
+                {
+                    m.removeAt(i);
+                }
+                ++visited;
+            }
+            ZFTestCaseAssert(visited == 12 && m.count() == 6);
+
+            // reverse
+            visited = 0;
+            for(zfindex i = m.indexLast(); i != zfindexMax(); i = m.indexPrev(i))
+            {
+                ZFTestCaseAssert(m.valueAt(i) % 2 == 1);
+                ++visited;
+            }
+            ZFTestCaseAssert(visited == 6);
+        }
+
+        this->testCaseOutputSeparator();
+        this->testCaseOutput("add while iterating, restart after rehash");
+        {
+            ZFCoreHashMap<zfindex> m;
+            for(zfindex i = 0; i < 12; ++i)
+            {
+                m.set(zfstringWithFormat("k%zi", i), 0);
+            }
+            // creating new keys invalidates slot index,
+            // iterate again until no new key created
+            zfindex added = 0;
+            zfbool changed = zftrue;
+            while(changed)
+            {
+                changed = zffalse;
+                for(zfindex i = m.indexFirst(); i != zfindexMax(); i = m.indexNext(i))
+                {
+                    if(m.valueAt(i) != 0)
+                    {
+                        continue;
+                    }
+                    m.valueAt(i) = 1;
+                    if(added < 100)
+                    {
+                        zfbool isNew = zffalse;
+                        m.indexForAdd(zfstringWithFormat("new%zi", added++), &isNew);
+                        ZFTestCaseAssert(isNew);
+                        changed = zftrue;
+                        break;
+                    }
+                }
+            }
+            ZFTestCaseAssert(m.count() == 112);
+            zfindex visited = 0;
+            for(zfindex i = m.indexFirst(); i != zfindexMax(); i = m.indexNext(i))
+            {
+                ZFTestCaseAssert(m.valueAt(i) == 1);
+                ++visited;
+            }
+            ZFTestCaseAssert(visited == 112);
+            for(zfindex i = 0; i < 100; ++i)
+            {
+                ZFTestCaseAssert(m.isContain(zfstringWithFormat("new%zi", i)));
+            }
+        }
+
+        this->testCaseStop();
+    }
+};
+ZFOBJECT_REGISTER(ZFCore_ZFCoreHashMap_test)
+
+ZF_NAMESPACE_GLOBAL_END
+
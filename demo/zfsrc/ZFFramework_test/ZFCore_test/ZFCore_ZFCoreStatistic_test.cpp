@@ -0,0 +1,166 @@
+#include "ZFCore_test.h"
+
+ZF_NAMESPACE_GLOBAL_BEGIN
+
+#define _ZFP_ZFCore_ZFCoreStatistic_test_threadCount 4
+#define _ZFP_ZFCore_ZFCoreStatistic_test_loopCount 10000
+
+static zfindex _ZFP_ZFCore_ZFCoreStatistic_test_counter = zfindexMax();
+static zfatomicint _ZFP_ZFCore_ZFCoreStatistic_test_running = 0;
+static ZFLISTENER_PROTOTYPE_EXPAND(_ZFP_ZFCore_ZFCoreStatistic_test_worker)
+{
+    for(zfindex i = 0; i < _ZFP_ZFCore_ZFCoreStatistic_test_loopCount; ++i)
+    {
+        ZFCoreStatistic::counterAdd(_ZFP_ZFCore_ZFCoreStatistic_test_counter);
+        ZFCoreStatistic::invokeTimeLogBegin("_ZFP_ZFCore_ZFCoreStatistic_test_thread");
+        ZFCoreStatistic::invokeTimeLogEnd("_ZFP_ZFCore_ZFCoreStatistic_test_thread");
+    }
+    zfAtomicDecrease(_ZFP_ZFCore_ZFCoreStatistic_test_running);
+}
+
+zfclass ZFCore_ZFCoreStatistic_test : zfextends ZFFramework_test_TestCase
+{
+    ZFOBJECT_DECLARE(ZFCore_ZFCoreStatistic_test, ZFFramework_test_TestCase)
+
+protected:
+    zfoverride
+    virtual void testCaseOnStart(void)
+    {
+        zfsuper::testCaseOnStart();
+
+        this->testCaseOutputSeparator();
+        this->testCaseOutput("invoke time and invoke count use different keys");
+        {
+            const zfchar *key = "_ZFP_ZFCore_ZFCoreStatistic_test_key";
+            ZFCoreStatistic::invokeCountLog(key);
+            ZFCoreStatistic::invokeTimeLogBegin(key);
+            ZFCoreStatistic::invokeTimeLogEnd(key);
+            ZFCoreStatistic::invokeTimeLogBegin(key);
+            ZFCoreStatistic::invokeTimeLogEnd(key);
+            ZFTestCaseAssert(ZFCoreStatistic::invokeCountGet(key) == 1);
+            ZFTestCaseAssert(ZFCoreStatistic::invokeTimeGetInvokeCount(key) == 2);
+            ZFTestCaseAssert(ZFCoreStatistic::histogramFind(key) == zfindexMax());
+
+            ZFCoreStatistic::invokeTimeRemove(key);
+            ZFTestCaseAssert(ZFCoreStatistic::invokeTimeGetInvokeCount(key) == 0);
+            ZFTestCaseAssert(ZFCoreStatistic::invokeCountGet(key) == 1);
+            ZFCoreStatistic::invokeCountRemove(key);
+            ZFTestCaseAssert(ZFCoreStatistic::invokeCountGet(key) == 0);
+        }
+
+        this->testCaseOutputSeparator();
+        this->testCaseOutput("invokeTimeRemoveAll resets invoke time only");
+        {
+            zfindex counter = ZFCoreStatistic::counterRegister("_ZFP_ZFCore_ZFCoreStatistic_test_counter");
+            zfindex histogram = ZFCoreStatistic::histogramRegister("_ZFP_ZFCore_ZFCoreStatistic_test_histogram");
+            ZFCoreStatistic::counterReset(counter);
+            ZFCoreStatistic::histogramReset(histogram);
+            ZFCoreStatistic::counterAdd(counter, 3);
+            ZFCoreStatistic::histogramRecord(histogram, 5);
+            ZFCoreStatistic::invokeTimeLogBegin("_ZFP_ZFCore_ZFCoreStatistic_test_removeAll");
+            ZFCoreStatistic::invokeTimeLogEnd("_ZFP_ZFCore_ZFCoreStatistic_test_removeAll");
+            ZFTestCaseAssert(ZFCoreStatistic::invokeTimeGetInvokeCount("_ZFP_ZFCore_ZFCoreStatistic_test_removeAll") == 1);
+
+            ZFCoreStatistic::invokeTimeRemoveAll();
+            ZFTestCaseAssert(ZFCoreStatistic::invokeTimeGetInvokeCount("_ZFP_ZFCore_ZFCoreStatistic_test_removeAll") == 0);
+            ZFTestCaseAssert(ZFCoreStatistic::counterGet(counter) == 3);
+            ZFCoreStatistic::HistogramState state = ZFCoreStatistic::histogramGet(histogram);
+            ZFTestCaseAssert(state.count == 1 && state.sum == 5 && state.min == 5 && state.max == 5);
+        }
+
+        this->testCaseOutputSeparator();
+        this->testCaseOutput("reset and update again");
+        {
+            zfindex counter = ZFCoreStatistic::counterRegister("_ZFP_ZFCore_ZFCoreStatistic_test_counter");
+            zfindex histogram = ZFCoreStatistic::histogramRegister("_ZFP_ZFCore_ZFCoreStatistic_test_histogram");
+            ZFCoreStatistic::counterReset(counter);
+            ZFCoreStatistic::histogramReset(histogram);
+            ZFTestCaseAssert(ZFCoreStatistic::counterGet(counter) == 0);
+            ZFTestCaseAssert(ZFCoreStatistic::histogramGet(histogram).count == 0);
+
+            // values before reset must not come back
+            ZFCoreStatistic::counterAdd(counter, 2);
+            ZFCoreStatistic::histogramRecord(histogram, 7);
+            ZFTestCaseAssert(ZFCoreStatistic::counterGet(counter) == 2);
+            ZFCoreStatistic::HistogramState state = ZFCoreStatistic::histogramGet(histogram);
+            ZFTestCaseAssert(state.count == 1 && state.sum == 7 && state.min == 7 && state.max == 7);
+        }
+
+        this->testCaseOutputSeparator();
+        this->testCaseOutput("reentrant begin and end");
+        {
+            const zfchar *key = "_ZFP_ZFCore_ZFCoreStatistic_test_reentrant";
+            ZFCoreStatistic::invokeTimeLogBegin(key);
+            ZFCoreStatistic::invokeTimeLogBegin(key);
+            ZFCoreStatistic::invokeTimeLogEnd(key);
+            ZFCoreStatistic::invokeTimeLogEnd(key);
+            // end without begin is ignored
+            ZFCoreStatistic::invokeTimeLogEnd(key);
+            ZFTestCaseAssert(ZFCoreStatistic::invokeTimeGetInvokeCount(key) == 2);
+
+            zfstring exported = ZFCoreStatistic::statisticExport();
+            this->testCaseOutput("export:\n%s", exported.cString());
+            ZFTestCaseAssert(zfstringFind(exported, "\"_ZFP_ZFCore_ZFCoreStatistic_test_reentrant\": {\"invokeCount\": 2, \"count\": 1,") != zfindexMax());
+            ZFTestCaseAssert(zfstringFind(exported, "\"_ZFP_ZFCore_ZFCoreStatistic_test_counter\": 2") != zfindexMax());
+            ZFCoreStatistic::invokeTimeRemove(key);
+        }
+
+        if(ZFProtocolIsAvailable("ZFThread"))
+        {
+            this->testCaseOutputSeparator();
+            this->testCaseOutput("update in %d threads, and reset during update",
+                (zfint)_ZFP_ZFCore_ZFCoreStatistic_test_threadCount);
+            _ZFP_ZFCore_ZFCoreStatistic_test_counter = ZFCoreStatistic::counterRegister("_ZFP_ZFCore_ZFCoreStatistic_test_thread");
+            zfindex total = _ZFP_ZFCore_ZFCoreStatistic_test_threadCount * _ZFP_ZFCore_ZFCoreStatistic_test_loopCount;
+
+            for(zfindex round = 0; round < 2; ++round)
+            {
+                ZFCoreStatistic::counterReset(_ZFP_ZFCore_ZFCoreStatistic_test_counter);
+                ZFCoreStatistic::invokeTimeRemove("_ZFP_ZFCore_ZFCoreStatistic_test_thread");
+                zfAtomicStore(_ZFP_ZFCore_ZFCoreStatistic_test_running, _ZFP_ZFCore_ZFCoreStatistic_test_threadCount);
+                zfidentity taskIdList[_ZFP_ZFCore_ZFCoreStatistic_test_threadCount];
+                for(zfindex i = 0; i < _ZFP_ZFCore_ZFCoreStatistic_test_threadCount; ++i)
+                {
+                    taskIdList[i] = ZFThreadExecuteInNewThread(ZFCallbackForFunc(_ZFP_ZFCore_ZFCoreStatistic_test_worker));
+                }
+                if(round == 0)
+                {
+                    // reset while other threads are updating, value must never exceed total
+                    while(zfAtomicLoad(_ZFP_ZFCore_ZFCoreStatistic_test_running) > 0)
+                    {
+                        ZFCoreStatistic::counterReset(_ZFP_ZFCore_ZFCoreStatistic_test_counter);
+                        ZFCoreStatistic::invokeTimeRemoveAll();
+                        ZFTestCaseAssert(ZFCoreStatistic::counterGet(_ZFP_ZFCore_ZFCoreStatistic_test_counter) <= total);
+                        ZFThread::sleep((zftimet)1);
+                    }
+                }
+                for(zfindex i = 0; i < _ZFP_ZFCore_ZFCoreStatistic_test_threadCount; ++i)
+                {
+                    ZFThreadExecuteWait(taskIdList[i]);
+                }
+                if(round == 0)
+                {
+                    ZFTestCaseAssert(ZFCoreStatistic::counterGet(_ZFP_ZFCore_ZFCoreStatistic_test_counter) <= total);
+                }
+                else
+                {
+                    ZFTestCaseAssert(ZFCoreStatistic::counterGet(_ZFP_ZFCore_ZFCoreStatistic_test_counter) == total);
+                    ZFTestCaseAssert(ZFCoreStatistic::invokeTimeGetInvokeCount("_ZFP_ZFCore_ZFCoreStatistic_test_thread") == total);
+                }
+            }
+
+            // reset after threads finished, old values of each thread must be dropped
+            ZFCoreStatistic::counterReset(_ZFP_ZFCore_ZFCoreStatistic_test_counter);
+            ZFCoreStatistic::counterAdd(_ZFP_ZFCore_ZFCoreStatistic_test_counter);
+            ZFTestCaseAssert(ZFCoreStatistic::counterGet(_ZFP_ZFCore_ZFCoreStatistic_test_counter) == 1);
+            ZFCoreStatistic::invokeTimeRemove("_ZFP_ZFCore_ZFCoreStatistic_test_thread");
+            ZFTestCaseAssert(ZFCoreStatistic::invokeTimeGetInvokeCount("_ZFP_ZFCore_ZFCoreStatistic_test_thread") == 0);
+        }
+
+        this->testCaseStop();
+    }
+};
+ZFOBJECT_REGISTER(ZFCore_ZFCoreStatistic_test)
+
+ZF_NAMESPACE_GLOBAL_END
+
@@ -0,0 +1,128 @@
+#include "ZFCore_test.h"
+
+ZF_NAMESPACE_GLOBAL_BEGIN
+
+// ============================================================
+zfclass _ZFP_ZFCore_ZFDynamicInvoker_test_Object : zfextends ZFObject
+{
+    ZFOBJECT_DECLARE(_ZFP_ZFCore_ZFDynamicInvoker_test_Object, ZFObject)
+
+public:
+    // same param count, chosen by whether the param value can be converted
+    ZFMETHOD_INLINE_1(zfstring, overloaded,
+                      ZFMP_IN(zfint, param0))
+    {
+        return "zfint";
+    }
+    ZFMETHOD_INLINE_1(zfstring, overloaded,
+                      ZFMP_IN(zfbool, param0))
+    {
+        return "zfbool";
+    }
+    // the only one accepts 2 params
+    ZFMETHOD_INLINE_2(zfstring, overloaded,
+                      ZFMP_IN(zfint, param0),
+                      ZFMP_IN(zfint, param1))
+    {
+        return zfstringWithFormat("%d", param0 + param1);
+    }
+};
+ZFOBJECT_REGISTER(_ZFP_ZFCore_ZFDynamicInvoker_test_Object)
+
+// result of the overloaded method, or "<fail>"
+static zfstring _ZFP_ZFCore_ZFDynamicInvoker_test_result(ZF_IN zfbool success, ZF_IN const zfautoObject &ret)
+{
+    v_zfstring *t = ret;
+    if(!success || t == zfnull)
+    {
+        return "<fail>";
+    }
+    return t->zfv;
+}
+static zfstring _ZFP_ZFCore_ZFDynamicInvoker_test_byCache(ZF_IN ZFDI_Cache &cache,
+                                                          ZF_IN ZFObject *obj,
+                                                          ZF_IN const zfchar *param0,
+                                                          ZF_IN_OPT const zfchar *param1 = zfnull)
+{
+    zfautoObject paramList[ZFMETHOD_MAX_PARAM];
+    for(zfindex i = 0; i < ZFMETHOD_MAX_PARAM; ++i)
+    {
+        paramList[i] = ZFMethodGenericInvokerDefaultParam();
+    }
+    paramList[0] = zflineAlloc(ZFDI_Wrapper, param0);
+    if(param1 != zfnull)
+    {
+        paramList[1] = zflineAlloc(ZFDI_Wrapper, param1);
+    }
+    zfautoObject ret;
+    zfbool success = cache.invoke(ret, zfnull, obj, zfindexMax(), paramList);
+    return _ZFP_ZFCore_ZFDynamicInvoker_test_result(success, ret);
+}
+static zfstring _ZFP_ZFCore_ZFDynamicInvoker_test_byName(ZF_IN ZFObject *obj,
+                                                         ZF_IN const zfchar *param0,
+                                                         ZF_IN_OPT const zfchar *param1 = zfnull)
+{
+    zfbool success = zffalse;
+    zfautoObject ret = obj->invoke("overloaded", param0, param1,
+        zfnull, zfnull, zfnull, zfnull, zfnull, zfnull, &success);
+    return _ZFP_ZFCore_ZFDynamicInvoker_test_result(success, ret);
+}
+
+zfclass ZFCore_ZFDynamicInvoker_test : zfextends ZFFramework_test_TestCase
+{
+    ZFOBJECT_DECLARE(ZFCore_ZFDynamicInvoker_test, ZFFramework_test_TestCase)
+
+protected:
+    zfoverride
+    virtual void testCaseOnStart(void)
+    {
+        zfsuper::testCaseOnStart();
+
+        zfblockedAlloc(_ZFP_ZFCore_ZFDynamicInvoker_test_Object, obj);
+
+        // call several times with the same param types but different values,
+        // the cached method must never be reused for another value
+        this->testCaseOutputSeparator();
+        this->testCaseOutput("overloaded methods by ZFDI_Cache");
+        {
+            ZFDI_Cache cache("overloaded");
+            for(zfindex i = 0; i < 3; ++i)
+            {
+                ZFTestCaseAssert(_ZFP_ZFCore_ZFDynamicInvoker_test_byCache(cache, obj, "1") == "zfint");
+                ZFTestCaseAssert(_ZFP_ZFCore_ZFDynamicInvoker_test_byCache(cache, obj, ZFTOKEN_zfbool_zftrue) == "zfbool");
+                ZFTestCaseAssert(_ZFP_ZFCore_ZFDynamicInvoker_test_byCache(cache, obj, "x") == "<fail>");
+                ZFTestCaseAssert(_ZFP_ZFCore_ZFDynamicInvoker_test_byCache(cache, obj, "1", "2") == "3");
+                ZFTestCaseAssert(_ZFP_ZFCore_ZFDynamicInvoker_test_byCache(cache, obj, "1", "x") == "<fail>");
+            }
+        }
+
+        this->testCaseOutputSeparator();
+        this->testCaseOutput("overloaded methods by ZFObject::invoke");
+        {
+            for(zfindex i = 0; i < 3; ++i)
+            {
+                ZFTestCaseAssert(_ZFP_ZFCore_ZFDynamicInvoker_test_byName(obj, "1") == "zfint");
+                ZFTestCaseAssert(_ZFP_ZFCore_ZFDynamicInvoker_test_byName(obj, ZFTOKEN_zfbool_zftrue) == "zfbool");
+                ZFTestCaseAssert(_ZFP_ZFCore_ZFDynamicInvoker_test_byName(obj, "x") == "<fail>");
+                ZFTestCaseAssert(_ZFP_ZFCore_ZFDynamicInvoker_test_byName(obj, "1", "2") == "3");
+                ZFTestCaseAssert(_ZFP_ZFCore_ZFDynamicInvoker_test_byName(obj, "1", "x") == "<fail>");
+            }
+        }
+
+        this->testCaseOutputSeparator();
+        this->testCaseOutput("overloaded methods by typed params");
+        {
+            for(zfindex i = 0; i < 3; ++i)
+            {
+                ZFTestCaseAssert(obj->invoke("overloaded", zflineAlloc(v_zfint, 1)).to<v_zfstring *>()->zfv == "zfint");
+                ZFTestCaseAssert(obj->invoke("overloaded", zflineAlloc(v_zfbool, zftrue)).to<v_zfstring *>()->zfv == "zfbool");
+            }
+        }
+
+        this->testCaseStop();
+    }
+};
+ZFOBJECT_REGISTER(ZFCore_ZFDynamicInvoker_test)
+
+ZF_NAMESPACE_GLOBAL_END
+
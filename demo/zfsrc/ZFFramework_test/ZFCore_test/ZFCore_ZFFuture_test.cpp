@@ -0,0 +1,226 @@
+#include "ZFCore_test.h"
+
+ZF_NAMESPACE_GLOBAL_BEGIN
+
+// ============================================================
+// resolve with userData, or null if no userData
+static ZFLISTENER_PROTOTYPE_EXPAND(_ZFP_ZFCore_ZFFuture_test_resolve)
+{
+    ZFThread::sleep((zftimet)10);
+    listenerData.param0<ZFFuture *>()->futureResolve(userData);
+}
+static ZFLISTENER_PROTOTYPE_EXPAND(_ZFP_ZFCore_ZFFuture_test_reject)
+{
+    listenerData.param0<ZFFuture *>()->futureReject(userData);
+}
+// resolve with result of source + 1, and record the thread
+static zfatomicint _ZFP_ZFCore_ZFFuture_test_inMainThread = 0;
+static ZFLISTENER_PROTOTYPE_EXPAND(_ZFP_ZFCore_ZFFuture_test_increase)
+{
+    ZFFuture *future = listenerData.param0<ZFFuture *>();
+    ZFFuture *source = listenerData.param1<ZFFuture *>();
+    zfAtomicStore(_ZFP_ZFCore_ZFFuture_test_inMainThread, ZFThread::currentThread()->isMainThread() ? 1 : 0);
+    future->futureResolve(zflineAlloc(v_zfint, source->futureResult()->to<v_zfint *>()->zfv + 1));
+}
+// settle by another async task
+static ZFLISTENER_PROTOTYPE_EXPAND(_ZFP_ZFCore_ZFFuture_test_resolveByAsync)
+{
+    listenerData.param0<ZFFuture *>()->futureResolveBy(
+        ZFFutureExecute(ZFCallbackForFunc(_ZFP_ZFCore_ZFFuture_test_resolve), ZFFutureExecutor::e_NewThread, userData));
+}
+static zfatomicint _ZFP_ZFCore_ZFFuture_test_calledCount = 0;
+static ZFLISTENER_PROTOTYPE_EXPAND(_ZFP_ZFCore_ZFFuture_test_called)
+{
+    zfAtomicIncrease(_ZFP_ZFCore_ZFFuture_test_calledCount);
+}
+
+// ============================================================
+zfclass ZFCore_ZFFuture_test : zfextends ZFFramework_test_TestCase
+{
+    ZFOBJECT_DECLARE(ZFCore_ZFFuture_test, ZFFramework_test_TestCase)
+
+protected:
+    zfoverride
+    virtual void testCaseOnStart(void)
+    {
+        zfsuper::testCaseOnStart();
+        ZFFramework_test_protocolCheck(ZFThread);
+        zfAtomicStore(_ZFP_ZFCore_ZFFuture_test_calledCount, 0);
+
+        this->testCaseOutputSeparator();
+        this->testCaseOutput("futureThen by Inline and NewThread");
+        {
+            zfautoObject f1 = ZFFutureExecute(ZFCallbackForFunc(_ZFP_ZFCore_ZFFuture_test_resolve),
+                ZFFutureExecutor::e_NewThread, zflineAlloc(v_zfint, 1));
+            zfautoObject f2 = f1.to<ZFFuture *>()->futureThen(ZFCallbackForFunc(_ZFP_ZFCore_ZFFuture_test_increase));
+            zfautoObject f3 = f2.to<ZFFuture *>()->futureThen(ZFCallbackForFunc(_ZFP_ZFCore_ZFFuture_test_increase), ZFFutureExecutor::e_NewThread);
+            ZFTestCaseAssert(f3.to<ZFFuture *>()->futureWait(5000));
+            ZFTestCaseAssert(f3.to<ZFFuture *>()->futureState() == ZFFutureState::e_Resolved);
+            ZFTestCaseAssert(f3.to<ZFFuture *>()->futureResult()->to<v_zfint *>()->zfv == 3);
+            ZFTestCaseAssert(zfAtomicLoad(_ZFP_ZFCore_ZFFuture_test_inMainThread) == 0);
+
+            // already resolved, inline callback runs in current thread before return
+            zfautoObject f4 = f3.to<ZFFuture *>()->futureThen(ZFCallbackForFunc(_ZFP_ZFCore_ZFFuture_test_increase));
+            ZFTestCaseAssert(f4.to<ZFFuture *>()->futureIsDone());
+            ZFTestCaseAssert(f4.to<ZFFuture *>()->futureResult()->to<v_zfint *>()->zfv == 4);
+            ZFTestCaseAssert(zfAtomicLoad(_ZFP_ZFCore_ZFFuture_test_inMainThread) == 1);
+
+            // can only be settled once
+            ZFTestCaseAssert(!f4.to<ZFFuture *>()->futureResolve());
+            ZFTestCaseAssert(!f4.to<ZFFuture *>()->futureReject());
+            ZFTestCaseAssert(!f4.to<ZFFuture *>()->futureCancel());
+            ZFTestCaseAssert(f4.to<ZFFuture *>()->futureResult()->to<v_zfint *>()->zfv == 4);
+        }
+
+        this->testCaseOutputSeparator();
+        this->testCaseOutput("reject and cancel propagation");
+        {
+            zfblockedAlloc(v_zfstring, error, "error");
+            zfautoObject rejected = ZFFutureExecute(ZFCallbackForFunc(_ZFP_ZFCore_ZFFuture_test_reject),
+                ZFFutureExecutor::e_NewThread, error);
+            zfautoObject rejectedThen = rejected.to<ZFFuture *>()->futureThen(ZFCallbackForFunc(_ZFP_ZFCore_ZFFuture_test_called), ZFFutureExecutor::e_NewThread);
+            zfautoObject rejectedThen2 = rejectedThen.to<ZFFuture *>()->futureThen(ZFCallbackForFunc(_ZFP_ZFCore_ZFFuture_test_called));
+            ZFTestCaseAssert(rejectedThen2.to<ZFFuture *>()->futureWait(5000));
+            ZFTestCaseAssert(rejectedThen2.to<ZFFuture *>()->futureState() == ZFFutureState::e_Rejected);
+            ZFTestCaseAssert(rejectedThen2.to<ZFFuture *>()->futureError() == error);
+            ZFTestCaseAssert(rejectedThen2.to<ZFFuture *>()->futureResult() == zfnull);
+
+            zfblockedAlloc(ZFFuture, canceled);
+            zfautoObject canceledThen = canceled->futureThen(ZFCallbackForFunc(_ZFP_ZFCore_ZFFuture_test_called));
+            ZFTestCaseAssert(canceled->futureCancel());
+            ZFTestCaseAssert(canceledThen.to<ZFFuture *>()->futureState() == ZFFutureState::e_Canceled);
+
+            // chained future canceled before its source resolved
+            zfblockedAlloc(ZFFuture, source);
+            zfautoObject chained = source->futureThen(ZFCallbackForFunc(_ZFP_ZFCore_ZFFuture_test_called));
+            ZFTestCaseAssert(chained.to<ZFFuture *>()->futureCancel());
+            source->futureResolve();
+            ZFTestCaseAssert(chained.to<ZFFuture *>()->futureState() == ZFFutureState::e_Canceled);
+
+            ZFTestCaseAssert(zfAtomicLoad(_ZFP_ZFCore_ZFFuture_test_calledCount) == 0);
+        }
+
+        this->testCaseOutputSeparator();
+        this->testCaseOutput("cancel on dealloc");
+        {
+            zfautoObject chained;
+            zfautoObject bound;
+            zfautoObject all;
+            zfautoObject observed;
+            {
+                zfblockedAlloc(ZFFuture, source);
+                chained = source->futureThen(ZFCallbackForFunc(_ZFP_ZFCore_ZFFuture_test_called));
+                observed = chained.to<ZFFuture *>()->futureThen(ZFCallbackForFunc(_ZFP_ZFCore_ZFFuture_test_called));
+                zfblockedAlloc(ZFFuture, boundTmp);
+                boundTmp->futureResolveBy(source);
+                bound = boundTmp;
+                zfblockedAlloc(ZFArrayEditable, futures);
+                futures->add(source);
+                all = ZFFutureWhenAll(futures);
+                ZFTestCaseAssert(chained.to<ZFFuture *>()->futureState() == ZFFutureState::e_Pending);
+            }
+            ZFTestCaseAssert(chained.to<ZFFuture *>()->futureState() == ZFFutureState::e_Canceled);
+            ZFTestCaseAssert(observed.to<ZFFuture *>()->futureState() == ZFFutureState::e_Canceled);
+            ZFTestCaseAssert(bound.to<ZFFuture *>()->futureState() == ZFFutureState::e_Canceled);
+            ZFTestCaseAssert(all.to<ZFFuture *>()->futureState() == ZFFutureState::e_Canceled);
+            ZFTestCaseAssert(zfAtomicLoad(_ZFP_ZFCore_ZFFuture_test_calledCount) == 0);
+        }
+
+        this->testCaseOutputSeparator();
+        this->testCaseOutput("futureResolveBy");
+        {
+            zfblockedAlloc(ZFFuture, source);
+            zfblockedAlloc(ZFFuture, target);
+            target->futureResolveBy(source);
+            ZFTestCaseAssert(!target->futureIsDone());
+            zfblockedAlloc(v_zfint, result, 5);
+            source->futureResolve(result);
+            ZFTestCaseAssert(target->futureResult() == result);
+
+            // source already done
+            zfblockedAlloc(ZFFuture, target2);
+            target2->futureResolveBy(target);
+            ZFTestCaseAssert(target2->futureResult() == result);
+
+            // settled by another async task in callback
+            zfautoObject async = target->futureThen(ZFCallbackForFunc(_ZFP_ZFCore_ZFFuture_test_resolveByAsync),
+                ZFFutureExecutor::e_Inline, zflineAlloc(v_zfint, 6));
+            ZFTestCaseAssert(async.to<ZFFuture *>()->futureWait(5000));
+            ZFTestCaseAssert(async.to<ZFFuture *>()->futureResult()->to<v_zfint *>()->zfv == 6);
+        }
+
+        this->testCaseOutputSeparator();
+        this->testCaseOutput("ZFFutureWhenAll and ZFFutureWhenAny");
+        {
+            zfblockedAlloc(ZFArrayEditable, futures);
+            futures->add(ZFFutureExecute(ZFCallbackForFunc(_ZFP_ZFCore_ZFFuture_test_resolve), ZFFutureExecutor::e_NewThread, zflineAlloc(v_zfint, 1)));
+            futures->add(ZFFutureExecute(ZFCallbackForFunc(_ZFP_ZFCore_ZFFuture_test_resolve), ZFFutureExecutor::e_NewThread));
+            futures->add(ZFFutureExecute(ZFCallbackForFunc(_ZFP_ZFCore_ZFFuture_test_resolve), ZFFutureExecutor::e_NewThread, zflineAlloc(v_zfint, 3)));
+            zfautoObject all = ZFFutureWhenAll(futures);
+            ZFTestCaseAssert(all.to<ZFFuture *>()->futureWait(5000));
+            ZFArray *results = all.to<ZFFuture *>()->futureResult()->to<ZFArray *>();
+            ZFTestCaseAssert(results != zfnull && results->count() == 3);
+            ZFTestCaseAssert(results->get<v_zfint *>(0)->zfv == 1);
+            ZFTestCaseAssert(results->get(1) == zfnullObject());
+            ZFTestCaseAssert(results->get<v_zfint *>(2)->zfv == 3);
+
+            zfblockedAlloc(ZFFuture, pending);
+            zfblockedAlloc(ZFFuture, rejected);
+            zfblockedAlloc(ZFArrayEditable, futuresFail);
+            futuresFail->add(pending);
+            futuresFail->add(rejected);
+            zfautoObject allFail = ZFFutureWhenAll(futuresFail);
+            zfautoObject any = ZFFutureWhenAny(futuresFail);
+            ZFTestCaseAssert(!any.to<ZFFuture *>()->futureIsDone());
+            rejected->futureReject();
+            ZFTestCaseAssert(allFail.to<ZFFuture *>()->futureState() == ZFFutureState::e_Rejected);
+            ZFTestCaseAssert(any.to<ZFFuture *>()->futureResult() == rejected);
+            pending->futureResolve();
+            ZFTestCaseAssert(any.to<ZFFuture *>()->futureResult() == rejected);
+
+            ZFTestCaseAssert(ZFFutureWhenAll(zfnull).to<ZFFuture *>()->futureResult()->to<ZFArray *>()->count() == 0);
+            ZFTestCaseAssert(ZFFutureWhenAny(zfnull).to<ZFFuture *>()->futureState() == ZFFutureState::e_Resolved);
+        }
+
+        this->testCaseOutputSeparator();
+        this->testCaseOutput("futureWait with timeout");
+        {
+            zfblockedAlloc(ZFFuture, pending);
+            zftimet startTime = ZFTime::timestamp();
+            ZFTestCaseAssert(!pending->futureWait((zftimet)30));
+            ZFTestCaseAssert(ZFTime::timestamp() - startTime >= 20);
+            ZFTestCaseAssert(pending->futureState() == ZFFutureState::e_Pending);
+
+            zfautoObject later = ZFFutureExecute(ZFCallbackForFunc(_ZFP_ZFCore_ZFFuture_test_resolve));
+            ZFTestCaseAssert(later.to<ZFFuture *>()->futureWait((zftimet)5000));
+            ZFTestCaseAssert(later.to<ZFFuture *>()->futureWait((zftimet)0));
+        }
+
+        // callbacks by MainThread would be run after this method returned
+        this->testCaseOutputSeparator();
+        this->testCaseOutput("futureThen by MainThread");
+        {
+            zfAtomicStore(_ZFP_ZFCore_ZFFuture_test_inMainThread, 0);
+            zfautoObject f1 = ZFFutureExecute(ZFCallbackForFunc(_ZFP_ZFCore_ZFFuture_test_resolve),
+                ZFFutureExecutor::e_NewThread, zflineAlloc(v_zfint, 1));
+            zfautoObject f2 = f1.to<ZFFuture *>()->futureThen(ZFCallbackForFunc(_ZFP_ZFCore_ZFFuture_test_increase), ZFFutureExecutor::e_MainThread);
+            ZFLISTENER_LOCAL(onDone, {
+                userData->to<ZFCore_ZFFuture_test *>()->mainThreadOnDone(listenerData.param0<ZFFuture *>());
+            })
+            f2.to<ZFFuture *>()->futureOnDone(onDone, ZFFutureExecutor::e_MainThread, this);
+        }
+    }
+
+public:
+    void mainThreadOnDone(ZF_IN ZFFuture *future)
+    {
+        ZFTestCaseAssert(ZFThread::currentThread()->isMainThread());
+        ZFTestCaseAssert(zfAtomicLoad(_ZFP_ZFCore_ZFFuture_test_inMainThread) == 1);
+        ZFTestCaseAssert(future->futureResult()->to<v_zfint *>()->zfv == 2);
+        this->testCaseStop();
+    }
+};
+ZFOBJECT_REGISTER(ZFCore_ZFFuture_test)
+
+ZF_NAMESPACE_GLOBAL_END
+
@@ -0,0 +1,193 @@
+#include "ZFCore_test.h"
+
+ZF_NAMESPACE_GLOBAL_BEGIN
+
+#define _ZFP_ZFCore_ZFGlobalInitializer_test_threadCount 4
+
+// create order of the test initializers, separated by space
+static zfatomicint _ZFP_ZFCore_ZFGlobalInitializer_test_lock = 0;
+static zfstring &_ZFP_ZFCore_ZFGlobalInitializer_test_order(void)
+{
+    static zfstring d;
+    return d;
+}
+static void _ZFP_ZFCore_ZFGlobalInitializer_test_record(ZF_IN const zfchar *name)
+{
+    zfAtomicSpinLocker(_ZFP_ZFCore_ZFGlobalInitializer_test_lock);
+    _ZFP_ZFCore_ZFGlobalInitializer_test_order() += name;
+    _ZFP_ZFCore_ZFGlobalInitializer_test_order() += " ";
+}
+// index of name in create order, or zfindexMax if not created
+static zfindex _ZFP_ZFCore_ZFGlobalInitializer_test_index(ZF_IN const zfchar *name)
+{
+    zfstring token = zfstringWithFormat(" %s ", name);
+    zfstring order;
+    {
+        zfAtomicSpinLocker(_ZFP_ZFCore_ZFGlobalInitializer_test_lock);
+        order = " ";
+        order += _ZFP_ZFCore_ZFGlobalInitializer_test_order();
+    }
+    zfindex pos = zfstringFind(order, token);
+    if(pos == zfindexMax() || zfstringFind(zfstring(order.cString() + pos + 1), token) != zfindexMax())
+    {
+        // not created, or created more than once
+        return zfindexMax();
+    }
+    return pos;
+}
+
+// ============================================================
+// parallel initializers, A and S must be created before D, B accesses C without declaring it
+ZF_GLOBAL_INITIALIZER_INIT_WITH_LEVEL_AND_FLAGS(ZFCore_ZFGlobalInitializer_test_A, ZFLevelAppLow, ZFGlobalInitializerFlagParallel)
+{
+    _ZFP_ZFCore_ZFGlobalInitializer_test_record("A");
+}
+ZF_GLOBAL_INITIALIZER_END(ZFCore_ZFGlobalInitializer_test_A)
+
+ZF_GLOBAL_INITIALIZER_INIT_WITH_LEVEL_AND_FLAGS(ZFCore_ZFGlobalInitializer_test_C, ZFLevelAppLow, ZFGlobalInitializerFlagParallel)
+: value(1)
+{
+    _ZFP_ZFCore_ZFGlobalInitializer_test_record("C");
+}
+public:
+    zfint value;
+ZF_GLOBAL_INITIALIZER_END(ZFCore_ZFGlobalInitializer_test_C)
+
+ZF_GLOBAL_INITIALIZER_INIT_WITH_LEVEL_AND_FLAGS(ZFCore_ZFGlobalInitializer_test_B, ZFLevelAppLow, ZFGlobalInitializerFlagParallel)
+: valueOfC(0)
+{
+    // C may not be started, being created by other thread, or already created,
+    // either way it must be available without deadlock
+    this->valueOfC = ZF_GLOBAL_INITIALIZER_INSTANCE(ZFCore_ZFGlobalInitializer_test_C)->value;
+    _ZFP_ZFCore_ZFGlobalInitializer_test_record("B");
+}
+public:
+    zfint valueOfC;
+ZF_GLOBAL_INITIALIZER_END(ZFCore_ZFGlobalInitializer_test_B)
+
+ZF_GLOBAL_INITIALIZER_INIT_WITH_LEVEL(ZFCore_ZFGlobalInitializer_test_S, ZFLevelAppLow)
+{
+    _ZFP_ZFCore_ZFGlobalInitializer_test_record("S");
+}
+ZF_GLOBAL_INITIALIZER_END(ZFCore_ZFGlobalInitializer_test_S)
+
+ZF_GLOBAL_INITIALIZER_INIT_WITH_LEVEL_AND_FLAGS(ZFCore_ZFGlobalInitializer_test_D, ZFLevelAppLow, ZFGlobalInitializerFlagParallel)
+{
+    _ZFP_ZFCore_ZFGlobalInitializer_test_record("D");
+}
+ZF_GLOBAL_INITIALIZER_END(ZFCore_ZFGlobalInitializer_test_D)
+ZF_GLOBAL_INITIALIZER_DEPENDENCY(ZFCore_ZFGlobalInitializer_test_D, ZFCore_ZFGlobalInitializer_test_A)
+ZF_GLOBAL_INITIALIZER_DEPENDENCY(ZFCore_ZFGlobalInitializer_test_D, ZFCore_ZFGlobalInitializer_test_S)
+
+// ============================================================
+// lazy initializers, created on first access only
+ZF_GLOBAL_INITIALIZER_INIT_WITH_LEVEL_AND_FLAGS(ZFCore_ZFGlobalInitializer_test_LazyDep, ZFLevelAppLow, ZFGlobalInitializerFlagLazy)
+{
+    _ZFP_ZFCore_ZFGlobalInitializer_test_record("LazyDep");
+}
+ZF_GLOBAL_INITIALIZER_END(ZFCore_ZFGlobalInitializer_test_LazyDep)
+
+ZF_GLOBAL_INITIALIZER_INIT_WITH_LEVEL_AND_FLAGS(ZFCore_ZFGlobalInitializer_test_Lazy, ZFLevelAppLow, ZFGlobalInitializerFlagLazy)
+{
+    _ZFP_ZFCore_ZFGlobalInitializer_test_record("Lazy");
+}
+ZF_GLOBAL_INITIALIZER_END(ZFCore_ZFGlobalInitializer_test_Lazy)
+ZF_GLOBAL_INITIALIZER_DEPENDENCY(ZFCore_ZFGlobalInitializer_test_Lazy, ZFCore_ZFGlobalInitializer_test_LazyDep)
+
+ZF_GLOBAL_INITIALIZER_INIT_WITH_LEVEL_AND_FLAGS(ZFCore_ZFGlobalInitializer_test_LazyThread, ZFLevelAppLow, ZFGlobalInitializerFlagLazy)
+{
+    // slow enough to let other threads access it during creation
+    ZFThread::sleep((zftimet)50);
+    _ZFP_ZFCore_ZFGlobalInitializer_test_record("LazyThread");
+}
+ZF_GLOBAL_INITIALIZER_END(ZFCore_ZFGlobalInitializer_test_LazyThread)
+
+static void *_ZFP_ZFCore_ZFGlobalInitializer_test_result[_ZFP_ZFCore_ZFGlobalInitializer_test_threadCount];
+static ZFLISTENER_PROTOTYPE_EXPAND(_ZFP_ZFCore_ZFGlobalInitializer_test_worker)
+{
+    zfindex threadIndex = (zfindex)userData->to<v_zfindex *>()->zfv;
+    _ZFP_ZFCore_ZFGlobalInitializer_test_result[threadIndex] =
+        ZF_GLOBAL_INITIALIZER_INSTANCE(ZFCore_ZFGlobalInitializer_test_LazyThread);
+}
+
+zfclass ZFCore_ZFGlobalInitializer_test : zfextends ZFFramework_test_TestCase
+{
+    ZFOBJECT_DECLARE(ZFCore_ZFGlobalInitializer_test, ZFFramework_test_TestCase)
+
+protected:
+    zfoverride
+    virtual void testCaseOnStart(void)
+    {
+        zfsuper::testCaseOnStart();
+
+        this->testCaseOutputSeparator();
+        this->testCaseOutput("create order: %s", _ZFP_ZFCore_ZFGlobalInitializer_test_order().cString());
+        this->testCaseOutput("parallel initializers are created once, after their dependencies");
+        {
+            zfindex a = _ZFP_ZFCore_ZFGlobalInitializer_test_index("A");
+            zfindex b = _ZFP_ZFCore_ZFGlobalInitializer_test_index("B");
+            zfindex c = _ZFP_ZFCore_ZFGlobalInitializer_test_index("C");
+            zfindex d = _ZFP_ZFCore_ZFGlobalInitializer_test_index("D");
+            zfindex s = _ZFP_ZFCore_ZFGlobalInitializer_test_index("S");
+            ZFTestCaseAssert(a != zfindexMax());
+            ZFTestCaseAssert(b != zfindexMax());
+            ZFTestCaseAssert(c != zfindexMax());
+            ZFTestCaseAssert(d != zfindexMax());
+            ZFTestCaseAssert(s != zfindexMax());
+            ZFTestCaseAssert(a < d);
+            ZFTestCaseAssert(s < d);
+            ZFTestCaseAssert(c < b);
+            ZFTestCaseAssert(ZF_GLOBAL_INITIALIZER_INSTANCE(ZFCore_ZFGlobalInitializer_test_B)->valueOfC == 1);
+        }
+
+        this->testCaseOutputSeparator();
+        this->testCaseOutput("lazy initializer is created on first access, after its dependency");
+        {
+            ZFTestCaseAssert(_ZFP_ZFCore_ZFGlobalInitializer_test_index("Lazy") == zfindexMax());
+            ZFTestCaseAssert(_ZFP_ZFCore_ZFGlobalInitializer_test_index("LazyDep") == zfindexMax());
+
+            void *instance = ZF_GLOBAL_INITIALIZER_INSTANCE(ZFCore_ZFGlobalInitializer_test_Lazy);
+            ZFTestCaseAssert(instance != zfnull);
+            zfindex lazy = _ZFP_ZFCore_ZFGlobalInitializer_test_index("Lazy");
+            zfindex lazyDep = _ZFP_ZFCore_ZFGlobalInitializer_test_index("LazyDep");
+            ZFTestCaseAssert(lazy != zfindexMax());
+            ZFTestCaseAssert(lazyDep != zfindexMax());
+            ZFTestCaseAssert(lazyDep < lazy);
+
+            // access again, must not be created again
+            ZFTestCaseAssert(ZF_GLOBAL_INITIALIZER_INSTANCE(ZFCore_ZFGlobalInitializer_test_Lazy) == instance);
+            ZFTestCaseAssert(_ZFP_ZFCore_ZFGlobalInitializer_test_index("Lazy") == lazy);
+        }
+
+        if(ZFProtocolIsAvailable("ZFThread"))
+        {
+            this->testCaseOutputSeparator();
+            this->testCaseOutput("lazy initializer accessed by %d threads at the same time",
+                (zfint)_ZFP_ZFCore_ZFGlobalInitializer_test_threadCount);
+            zfidentity taskIdList[_ZFP_ZFCore_ZFGlobalInitializer_test_threadCount];
+            for(zfindex i = 0; i < _ZFP_ZFCore_ZFGlobalInitializer_test_threadCount; ++i)
+            {
+                zfblockedAlloc(v_zfindex, threadIndex, i);
+                taskIdList[i] = ZFThreadExecuteInNewThread(ZFCallbackForFunc(_ZFP_ZFCore_ZFGlobalInitializer_test_worker), threadIndex);
+            }
+            for(zfindex i = 0; i < _ZFP_ZFCore_ZFGlobalInitializer_test_threadCount; ++i)
+            {
+                ZFThreadExecuteWait(taskIdList[i]);
+            }
+            // each thread got the same instance, and it's created only once,
+            // accessing from other thread is never treated as cyclic dependency
+            ZFTestCaseAssert(_ZFP_ZFCore_ZFGlobalInitializer_test_index("LazyThread") != zfindexMax());
+            for(zfindex i = 0; i < _ZFP_ZFCore_ZFGlobalInitializer_test_threadCount; ++i)
+            {
+                ZFTestCaseAssert(_ZFP_ZFCore_ZFGlobalInitializer_test_result[i] != zfnull);
+                ZFTestCaseAssert(_ZFP_ZFCore_ZFGlobalInitializer_test_result[i] == _ZFP_ZFCore_ZFGlobalInitializer_test_result[0]);
+            }
+        }
+
+        this->testCaseStop();
+    }
+};
+ZFOBJECT_REGISTER(ZFCore_ZFGlobalInitializer_test)
+
+ZF_NAMESPACE_GLOBAL_END
+
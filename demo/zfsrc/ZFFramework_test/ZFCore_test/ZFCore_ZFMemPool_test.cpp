@@ -0,0 +1,206 @@
+#include "ZFCore_test.h"
+
+ZF_NAMESPACE_GLOBAL_BEGIN
+
+// size class that no other type would use
+zfclassPOD _ZFP_ZFCore_ZFMemPool_test_Block
+{
+public:
+    zfindex index;
+    zfbyte data[1000];
+};
+#define _ZFP_ZFCore_ZFMemPool_test_blockSize _ZFP_zfpoolSizeAlign(sizeof(_ZFP_ZFCore_ZFMemPool_test_Block))
+#define _ZFP_ZFCore_ZFMemPool_test_threadCount 4
+#define _ZFP_ZFCore_ZFMemPool_test_loopCount 2000
+
+static zfatomicint _ZFP_ZFCore_ZFMemPool_test_lock = 0;
+static ZFCoreArrayPOD<_ZFP_ZFCore_ZFMemPool_test_Block *> _ZFP_ZFCore_ZFMemPool_test_shared;
+static zfatomicint _ZFP_ZFCore_ZFMemPool_test_errorCount = 0;
+
+static void _ZFP_ZFCore_ZFMemPool_test_fill(ZF_IN _ZFP_ZFCore_ZFMemPool_test_Block *block, ZF_IN zfindex index)
+{
+    block->index = index;
+    zfmemset(block->data, (zfbyte)index, sizeof(block->data));
+}
+static zfbool _ZFP_ZFCore_ZFMemPool_test_check(ZF_IN _ZFP_ZFCore_ZFMemPool_test_Block *block)
+{
+    for(zfindex i = 0; i < sizeof(block->data); ++i)
+    {
+        if(block->data[i] != (zfbyte)block->index)
+        {
+            return zffalse;
+        }
+    }
+    return zftrue;
+}
+// in use count of the test size class, or zfindexMax if never used
+static zfindex _ZFP_ZFCore_ZFMemPool_test_inUse(void)
+{
+    zfpoolState stateList[ZF_ENV_ZFMEMPOOL_SIZE_MAX / _ZFP_zfpoolSizeAlignMin];
+    zfindex count = zfpoolStateGet(stateList, ZFM_ARRAY_SIZE(stateList));
+    for(zfindex i = 0; i < count; ++i)
+    {
+        if(stateList[i].blockSize == _ZFP_ZFCore_ZFMemPool_test_blockSize)
+        {
+            return stateList[i].blockTotal - stateList[i].blockAvailable - stateList[i].blockCached;
+        }
+    }
+    return zfindexMax();
+}
+
+static ZFLISTENER_PROTOTYPE_EXPAND(_ZFP_ZFCore_ZFMemPool_test_worker)
+{
+    zfindex seed = (zfindex)userData->to<v_zfindex *>()->zfv;
+    for(zfindex i = 0; i < _ZFP_ZFCore_ZFMemPool_test_loopCount; ++i)
+    {
+        // alloc and free in current thread
+        _ZFP_ZFCore_ZFMemPool_test_Block *local = zfpoolNew(_ZFP_ZFCore_ZFMemPool_test_Block);
+        _ZFP_ZFCore_ZFMemPool_test_fill(local, seed + i);
+
+        // free blocks allocated by other threads
+        _ZFP_ZFCore_ZFMemPool_test_Block *shared = zfpoolNew(_ZFP_ZFCore_ZFMemPool_test_Block);
+        _ZFP_ZFCore_ZFMemPool_test_fill(shared, seed + i);
+        _ZFP_ZFCore_ZFMemPool_test_Block *another = zfnull;
+        zfAtomicSpinLock(_ZFP_ZFCore_ZFMemPool_test_lock);
+        _ZFP_ZFCore_ZFMemPool_test_shared.add(shared);
+        if((i % 2) == 0)
+        {
+            another = _ZFP_ZFCore_ZFMemPool_test_shared.removeFirstAndGet();
+        }
+        zfAtomicSpinUnlock(_ZFP_ZFCore_ZFMemPool_test_lock);
+        if(another != zfnull)
+        {
+            if(!_ZFP_ZFCore_ZFMemPool_test_check(another))
+            {
+                zfAtomicIncrease(_ZFP_ZFCore_ZFMemPool_test_errorCount);
+            }
+            zfpoolDelete(another);
+        }
+
+        if(!_ZFP_ZFCore_ZFMemPool_test_check(local))
+        {
+            zfAtomicIncrease(_ZFP_ZFCore_ZFMemPool_test_errorCount);
+        }
+        zfpoolDelete(local);
+    }
+}
+
+zfclass ZFCore_ZFMemPool_test : zfextends ZFFramework_test_TestCase
+{
+    ZFOBJECT_DECLARE(ZFCore_ZFMemPool_test, ZFFramework_test_TestCase)
+
+protected:
+    zfoverride
+    virtual void testCaseOnStart(void)
+    {
+        zfsuper::testCaseOnStart();
+
+        this->testCaseOutputSeparator();
+        this->testCaseOutput("alloc and free in one thread");
+        {
+            ZFCoreArrayPOD<_ZFP_ZFCore_ZFMemPool_test_Block *> blocks;
+            for(zfindex i = 0; i < 500; ++i)
+            {
+                _ZFP_ZFCore_ZFMemPool_test_Block *block = zfpoolNew(_ZFP_ZFCore_ZFMemPool_test_Block);
+                _ZFP_ZFCore_ZFMemPool_test_fill(block, i);
+                blocks.add(block);
+            }
+            ZFTestCaseAssert(_ZFP_ZFCore_ZFMemPool_test_inUse() == 500);
+            for(zfindex i = 0; i < blocks.count(); ++i)
+            {
+                // blocks must not overlap
+                ZFTestCaseAssert(blocks[i]->index == i);
+                ZFTestCaseAssert(_ZFP_ZFCore_ZFMemPool_test_check(blocks[i]));
+                zfpoolDelete(blocks[i]);
+            }
+            ZFTestCaseAssert(_ZFP_ZFCore_ZFMemPool_test_inUse() == 0);
+
+            // freed blocks must be reused instead of reserving new slabs
+            zfpoolState stateList[ZF_ENV_ZFMEMPOOL_SIZE_MAX / _ZFP_zfpoolSizeAlignMin];
+            zfindex count = zfpoolStateGet(stateList, ZFM_ARRAY_SIZE(stateList));
+            zfindex slabCount = 0;
+            for(zfindex i = 0; i < count; ++i)
+            {
+                if(stateList[i].blockSize == _ZFP_ZFCore_ZFMemPool_test_blockSize)
+                {
+                    slabCount = stateList[i].slabCount;
+                }
+            }
+            for(zfindex i = 0; i < 500; ++i)
+            {
+                blocks[i] = zfpoolNew(_ZFP_ZFCore_ZFMemPool_test_Block);
+            }
+            for(zfindex i = 0; i < 500; ++i)
+            {
+                zfpoolDelete(blocks[i]);
+            }
+            count = zfpoolStateGet(stateList, ZFM_ARRAY_SIZE(stateList));
+            for(zfindex i = 0; i < count; ++i)
+            {
+                if(stateList[i].blockSize == _ZFP_ZFCore_ZFMemPool_test_blockSize)
+                {
+                    ZFTestCaseAssert(stateList[i].slabCount == slabCount);
+                }
+            }
+        }
+
+        this->testCaseOutputSeparator();
+        this->testCaseOutput("cache cleanup");
+        {
+            zfpoolCacheCleanup();
+            zfpoolState stateList[ZF_ENV_ZFMEMPOOL_SIZE_MAX / _ZFP_zfpoolSizeAlignMin];
+            zfindex count = zfpoolStateGet(stateList, ZFM_ARRAY_SIZE(stateList));
+            for(zfindex i = 0; i < count; ++i)
+            {
+                if(stateList[i].blockSize == _ZFP_ZFCore_ZFMemPool_test_blockSize)
+                {
+                    ZFTestCaseAssert(stateList[i].blockCached == 0);
+                    ZFTestCaseAssert(stateList[i].blockAvailable == stateList[i].blockTotal);
+                }
+            }
+        }
+
+        if(ZFProtocolIsAvailable("ZFThread"))
+        {
+            this->testCaseOutputSeparator();
+            this->testCaseOutput("alloc and free across %d threads", (zfint)_ZFP_ZFCore_ZFMemPool_test_threadCount);
+            zfidentity taskIdList[_ZFP_ZFCore_ZFMemPool_test_threadCount];
+            for(zfindex i = 0; i < _ZFP_ZFCore_ZFMemPool_test_threadCount; ++i)
+            {
+                zfblockedAlloc(v_zfindex, seed, i * _ZFP_ZFCore_ZFMemPool_test_loopCount);
+                taskIdList[i] = ZFThreadExecuteInNewThread(ZFCallbackForFunc(_ZFP_ZFCore_ZFMemPool_test_worker), seed);
+            }
+            for(zfindex i = 0; i < _ZFP_ZFCore_ZFMemPool_test_threadCount; ++i)
+            {
+                ZFThreadExecuteWait(taskIdList[i]);
+            }
+            ZFTestCaseAssert(zfAtomicLoad(_ZFP_ZFCore_ZFMemPool_test_errorCount) == 0);
+            for(zfindex i = 0; i < _ZFP_ZFCore_ZFMemPool_test_shared.count(); ++i)
+            {
+                ZFTestCaseAssert(_ZFP_ZFCore_ZFMemPool_test_check(_ZFP_ZFCore_ZFMemPool_test_shared[i]));
+                zfpoolDelete(_ZFP_ZFCore_ZFMemPool_test_shared[i]);
+            }
+            _ZFP_ZFCore_ZFMemPool_test_shared.removeAll();
+            zfpoolCacheCleanup();
+
+            // worker threads must have returned their cache when task finished,
+            // which happens right after ZFThreadExecuteWait returned
+            zfindex inUse = zfindexMax();
+            for(zfindex i = 0; i < 100 && inUse != 0; ++i)
+            {
+                inUse = _ZFP_ZFCore_ZFMemPool_test_inUse();
+                if(inUse != 0)
+                {
+                    ZFThread::sleep((zftimet)10);
+                }
+            }
+            ZFTestCaseAssert(inUse == 0);
+        }
+
+        this->testCaseStop();
+    }
+};
+ZFOBJECT_REGISTER(ZFCore_ZFMemPool_test)
+
+ZF_NAMESPACE_GLOBAL_END
+
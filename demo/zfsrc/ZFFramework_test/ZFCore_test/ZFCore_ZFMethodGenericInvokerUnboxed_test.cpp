@@ -0,0 +1,224 @@
+#include "ZFCore_test.h"
+
+ZF_NAMESPACE_GLOBAL_BEGIN
+
+zfclass _ZFP_ZFCore_ZFMethodGenericInvokerUnboxed_test_Object : zfextends ZFObject
+{
+    ZFOBJECT_DECLARE(_ZFP_ZFCore_ZFMethodGenericInvokerUnboxed_test_Object, ZFObject)
+
+public:
+    ZFMETHOD_INLINE_2(zfint, add,
+                      ZFMP_IN(zfint, param0),
+                      ZFMP_IN(zfint, param1))
+    {
+        return param0 + param1;
+    }
+    ZFMETHOD_INLINE_1(zfuint, toUInt,
+                      ZFMP_IN(zfuint, param0))
+    {
+        return param0;
+    }
+    ZFMETHOD_INLINE_1(zfindex, length,
+                      ZFMP_IN(const zfchar *, param0))
+    {
+        return zfslen(param0);
+    }
+    ZFMETHOD_INLINE_1(zfbool, isPositive,
+                      ZFMP_IN(zffloat, param0))
+    {
+        return param0 > 0;
+    }
+    // zfstring can not be returned unboxed
+    ZFMETHOD_INLINE_1(zfstring, name,
+                      ZFMP_IN(zfint, param0))
+    {
+        return zfintToString(param0);
+    }
+};
+ZFOBJECT_REGISTER(_ZFP_ZFCore_ZFMethodGenericInvokerUnboxed_test_Object)
+
+// wrapper objects allocated since last ZFObjectAllocTrackReset, including cache hit
+static zfindex _ZFP_ZFCore_ZFMethodGenericInvokerUnboxed_test_wrapperAllocCount(void)
+{
+    zfindex ret = 0;
+    ZFCoreArrayPOD<ZFObjectAllocTrackState> states = ZFObjectAllocTrackStateGetAll();
+    for(zfindex i = 0; i < states.count(); ++i)
+    {
+        const ZFObjectAllocTrackState &state = states[i];
+        if(state.cls->classIsTypeOf(ZFTypeIdWrapper::ClassData())
+            || state.cls->classIsTypeOf(ZFDI_WrapperBase::ClassData()))
+        {
+            ret += state.allocCount + state.cacheHitCount;
+        }
+    }
+    return ret;
+}
+
+zfclass ZFCore_ZFMethodGenericInvokerUnboxed_test : zfextends ZFFramework_test_TestCase
+{
+    ZFOBJECT_DECLARE(ZFCore_ZFMethodGenericInvokerUnboxed_test, ZFFramework_test_TestCase)
+
+protected:
+    zfoverride
+    virtual void testCaseOnStart(void)
+    {
+        zfsuper::testCaseOnStart();
+
+        typedef _ZFP_ZFCore_ZFMethodGenericInvokerUnboxed_test_Object TestObject;
+        zfblockedAlloc(TestObject, obj);
+        const ZFMethod *methodAdd = ZFMethodAccess(TestObject, add);
+        const ZFMethod *methodToUInt = ZFMethodAccess(TestObject, toUInt);
+        const ZFMethod *methodLength = ZFMethodAccess(TestObject, length);
+        const ZFMethod *methodIsPositive = ZFMethodAccess(TestObject, isPositive);
+        const ZFMethod *methodName = ZFMethodAccess(TestObject, name);
+
+        this->testCaseOutputSeparator();
+        this->testCaseOutput("availability");
+        {
+            ZFTestCaseAssert(methodAdd->methodGenericInvokerUnboxed() != zfnull);
+            ZFTestCaseAssert(methodToUInt->methodGenericInvokerUnboxed() != zfnull);
+            ZFTestCaseAssert(methodLength->methodGenericInvokerUnboxed() != zfnull);
+            ZFTestCaseAssert(methodIsPositive->methodGenericInvokerUnboxed() != zfnull);
+            ZFTestCaseAssert(methodName->methodGenericInvokerUnboxed() == zfnull);
+        }
+
+        this->testCaseOutputSeparator();
+        this->testCaseOutput("param conversion");
+        {
+            ZFMethodGenericValue ret;
+            ZFMethodGenericValue params[ZFMETHOD_MAX_PARAM];
+
+            params[0].type = ZFMethodGenericValueTypeInt;
+            params[0].v.vInt = 1;
+            params[1].type = ZFMethodGenericValueTypeDouble;
+            params[1].v.vDouble = 2;
+            ZFTestCaseAssert(methodAdd->methodGenericInvokeUnboxed(obj, ret, 2, params));
+            ZFTestCaseAssert(ret.type == ZFMethodGenericValueTypeInt && ret.v.vInt == 3);
+
+            params[1].type = ZFMethodGenericValueTypeString;
+            params[1].v.vString = "5";
+            ZFTestCaseAssert(methodAdd->methodGenericInvokeUnboxed(obj, ret, 2, params));
+            ZFTestCaseAssert(ret.type == ZFMethodGenericValueTypeInt && ret.v.vInt == 6);
+
+            // not supplied, or not able to convert
+            ZFTestCaseAssert(!methodAdd->methodGenericInvokeUnboxed(obj, ret, 1, params));
+            params[1].type = ZFMethodGenericValueTypeDouble;
+            params[1].v.vDouble = 1.5;
+            ZFTestCaseAssert(!methodAdd->methodGenericInvokeUnboxed(obj, ret, 2, params));
+            params[1].type = ZFMethodGenericValueTypeString;
+            params[1].v.vString = "abc";
+            ZFTestCaseAssert(!methodAdd->methodGenericInvokeUnboxed(obj, ret, 2, params));
+            params[0].type = ZFMethodGenericValueTypeInt;
+            params[0].v.vInt = -1;
+            ZFTestCaseAssert(!methodToUInt->methodGenericInvokeUnboxed(obj, ret, 1, params));
+
+            params[0].type = ZFMethodGenericValueTypeString;
+            params[0].v.vString = "abc";
+            ZFTestCaseAssert(methodLength->methodGenericInvokeUnboxed(obj, ret, 1, params));
+            ZFTestCaseAssert(ret.type == ZFMethodGenericValueTypeIndex && ret.v.vIndex == 3);
+
+            params[0].type = ZFMethodGenericValueTypeDouble;
+            params[0].v.vDouble = 0.5;
+            ZFTestCaseAssert(methodIsPositive->methodGenericInvokeUnboxed(obj, ret, 1, params));
+            ZFTestCaseAssert(ret.type == ZFMethodGenericValueTypeBool && ret.v.vBool);
+
+            zfautoObject retBoxed;
+            ZFTestCaseAssert(methodIsPositive->methodGenericInvokeUnboxed(obj, ret, 1, params, zfnull, &retBoxed));
+            ZFTestCaseAssert(ret.type == ZFMethodGenericValueTypeDefault);
+            v_zfbool *retWrapper = retBoxed;
+            ZFTestCaseAssert(retWrapper != zfnull && retWrapper->zfv);
+        }
+
+        zfbool enabledSaved = ZFObjectAllocTrackEnabled();
+        ZFObjectAllocTrackEnable(zftrue);
+
+        this->testCaseOutputSeparator();
+        this->testCaseOutput("no wrapper allocated by unboxed invoke");
+        {
+            ZFMethodGenericValue ret;
+            ZFMethodGenericValue params[ZFMETHOD_MAX_PARAM];
+            params[0].type = ZFMethodGenericValueTypeInt;
+            params[0].v.vInt = 1;
+            params[1].type = ZFMethodGenericValueTypeString;
+            params[1].v.vString = "2";
+
+            ZFObjectAllocTrackReset();
+            zfint sum = 0;
+            for(zfindex i = 0; i < 100; ++i)
+            {
+                ZFTestCaseAssert(methodAdd->methodGenericInvokeUnboxed(obj, ret, 2, params));
+                sum += ret.v.vInt;
+            }
+            // output may alloc objects, take the count first
+            zfindex wrapperAllocCount = _ZFP_ZFCore_ZFMethodGenericInvokerUnboxed_test_wrapperAllocCount();
+            this->testCaseOutput("sum: %d, wrapper allocated: %zi", sum, wrapperAllocCount);
+            ZFTestCaseAssert(sum == 300);
+            ZFTestCaseAssert(wrapperAllocCount == 0);
+        }
+
+        this->testCaseOutputSeparator();
+        this->testCaseOutput("ZFDI_invoke converts string params without wrapper, only the return value is boxed");
+        {
+            zfblockedAlloc(ZFDI_Wrapper, type, "add");
+            zfautoObject paramList[ZFMETHOD_MAX_PARAM];
+            for(zfindex i = 0; i < ZFMETHOD_MAX_PARAM; ++i)
+            {
+                paramList[i] = ZFMethodGenericInvokerDefaultParam();
+            }
+            paramList[0] = zflineAlloc(ZFDI_Wrapper, "1");
+            paramList[1] = zflineAlloc(ZFDI_Wrapper, "2");
+
+            ZFObjectAllocTrackReset();
+            zfautoObject ret;
+            ZFTestCaseAssert(ZFDI_invoke(ret, zfnull, obj, zfnull, type, 2, paramList));
+            zfindex wrapperAllocCount = _ZFP_ZFCore_ZFMethodGenericInvokerUnboxed_test_wrapperAllocCount();
+            v_zfint *retWrapper = ret;
+            ZFTestCaseAssert(retWrapper != zfnull && retWrapper->zfv == 3);
+            this->testCaseOutput("wrapper allocated: %zi", wrapperAllocCount);
+            // only the return value, which may be reused from alloc cache without being tracked
+            ZFTestCaseAssert(wrapperAllocCount <= 1);
+            // params are not converted in place
+            ZFTestCaseAssert(ZFCastZFObject(ZFDI_Wrapper *, paramList[0]) != zfnull);
+
+            ZFMethodGenericValue params[ZFMETHOD_MAX_PARAM];
+            params[0].type = ZFMethodGenericValueTypeDouble;
+            params[0].v.vDouble = 3;
+            params[1].type = ZFMethodGenericValueTypeDouble;
+            params[1].v.vDouble = 4;
+            ZFObjectAllocTrackReset();
+            ZFTestCaseAssert(ZFDI_invokeUnboxed(ret, obj, zfnull, type, 2, params));
+            retWrapper = ret;
+            ZFTestCaseAssert(retWrapper != zfnull && retWrapper->zfv == 7);
+            ZFTestCaseAssert(_ZFP_ZFCore_ZFMethodGenericInvokerUnboxed_test_wrapperAllocCount() <= 1);
+        }
+
+        this->testCaseOutputSeparator();
+        this->testCaseOutput("fallback to boxed invoke");
+        {
+            zfblockedAlloc(ZFDI_Wrapper, type, "name");
+            ZFMethodGenericValue params[ZFMETHOD_MAX_PARAM];
+            params[0].type = ZFMethodGenericValueTypeInt;
+            params[0].v.vInt = 1;
+            zfautoObject ret;
+            ZFTestCaseAssert(!ZFDI_invokeUnboxed(ret, obj, zfnull, type, 1, params));
+            ZFTestCaseAssert(ret == zfnull);
+
+            zfautoObject paramList[ZFMETHOD_MAX_PARAM];
+            for(zfindex i = 0; i < ZFMETHOD_MAX_PARAM; ++i)
+            {
+                paramList[i] = ZFMethodGenericInvokerDefaultParam();
+            }
+            paramList[0] = zflineAlloc(ZFDI_Wrapper, "1");
+            ZFTestCaseAssert(ZFDI_invoke(ret, zfnull, obj, zfnull, type, 1, paramList));
+            v_zfstring *retWrapper = ret;
+            ZFTestCaseAssert(retWrapper != zfnull && zfscmpTheSame(retWrapper->zfv.cString(), "1"));
+        }
+
+        ZFObjectAllocTrackEnable(enabledSaved);
+        this->testCaseStop();
+    }
+};
+ZFOBJECT_REGISTER(ZFCore_ZFMethodGenericInvokerUnboxed_test)
+
+ZF_NAMESPACE_GLOBAL_END
+
@@ -0,0 +1,82 @@
+#include "ZFCore_test.h"
+
+ZF_NAMESPACE_GLOBAL_BEGIN
+
+zfclass ZFCore_ZFMethodProfile_test : zfextends ZFFramework_test_TestCase
+{
+    ZFOBJECT_DECLARE(ZFCore_ZFMethodProfile_test, ZFFramework_test_TestCase)
+
+protected:
+    zfoverride
+    virtual void testCaseOnStart(void)
+    {
+        zfsuper::testCaseOnStart();
+
+        const ZFMethod *method = ZFObject::ClassData()->methodForName("objectHash");
+        zfblockedAlloc(ZFObject, obj);
+
+        this->testCaseOutputSeparator();
+        this->testCaseOutput("execute and generic invoke");
+        {
+            ZFMethodProfileReset();
+            ZFMethodProfileEnable(zftrue, 10);
+            for(zfindex i = 0; i < 100; ++i)
+            {
+                method->execute<zfidentity>(obj);
+            }
+            for(zfindex i = 0; i < 10; ++i)
+            {
+                method->methodGenericInvoke(obj);
+            }
+            ZFMethodProfileEnable(zffalse);
+            method->execute<zfidentity>(obj);
+
+            ZFMethodProfileState state;
+            ZFTestCaseAssert(ZFMethodProfileStateGet(state, method));
+            ZFTestCaseAssert(state.callCount == 110);
+            ZFTestCaseAssert(ZFMethodProfileTraceEventCount() == 10);
+        }
+
+        this->testCaseOutputSeparator();
+        this->testCaseOutput("profile result");
+        {
+            zfstring s;
+            ZFMethodProfilePrint(ZFOutputForString(s), 10);
+            this->testCaseOutput("%s", s.cString());
+        }
+
+        this->testCaseOutputSeparator();
+        this->testCaseOutput("trace event");
+        {
+            zfstring s;
+            ZFMethodProfileTraceOutput(ZFOutputForString(s));
+            this->testCaseOutput("%s", s.cString());
+        }
+
+        this->testCaseOutputSeparator();
+        this->testCaseOutput("output while profiling");
+        {
+            // output callbacks are reflective methods which would be profiled
+            ZFMethodProfileReset();
+            ZFMethodProfileEnable(zftrue, 1000);
+            method->execute<zfidentity>(obj);
+            zfstring s;
+            ZFMethodProfilePrint(ZFOutputForString(s), 10);
+            ZFTestCaseAssert(!s.isEmpty());
+            zfindex eventCount = ZFMethodProfileTraceEventCount();
+            s.removeAll();
+            ZFMethodProfileTraceOutput(ZFOutputForString(s));
+            ZFTestCaseAssert(zfstringFind(s, "ZFObject::objectHash") != zfindexMax());
+            // calls made by output are recorded after events copied
+            ZFTestCaseAssert(ZFMethodProfileTraceEventCount() > eventCount);
+            ZFMethodProfileEnable(zffalse);
+        }
+
+        ZFMethodProfileReset();
+        this->testCaseStop();
+    }
+};
+ZFOBJECT_REGISTER(ZFCore_ZFMethodProfile_test)
+
+ZF_NAMESPACE_GLOBAL_END
+
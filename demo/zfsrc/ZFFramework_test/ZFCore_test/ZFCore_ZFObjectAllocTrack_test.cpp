@@ -0,0 +1,85 @@
+#include "ZFCore_test.h"
+
+ZF_NAMESPACE_GLOBAL_BEGIN
+
+zfclass _ZFP_ZFCore_ZFObjectAllocTrack_test_Object : zfextends ZFObject
+{
+    ZFOBJECT_DECLARE(_ZFP_ZFCore_ZFObjectAllocTrack_test_Object, ZFObject)
+    ZFALLOC_CACHE_RELEASE({
+    })
+};
+
+zfclass ZFCore_ZFObjectAllocTrack_test : zfextends ZFFramework_test_TestCase
+{
+    ZFOBJECT_DECLARE(ZFCore_ZFObjectAllocTrack_test, ZFFramework_test_TestCase)
+
+protected:
+    zfoverride
+    virtual void testCaseOnStart(void)
+    {
+        zfsuper::testCaseOnStart();
+
+        zfbool enabledSaved = ZFObjectAllocTrackEnabled();
+        ZFObjectAllocTrackEnable(zftrue);
+        ZFObjectAllocTrackReset();
+        const ZFClass *cls = _ZFP_ZFCore_ZFObjectAllocTrack_test_Object::ClassData();
+
+        this->testCaseOutputSeparator();
+        this->testCaseOutput("alloc and release");
+        {
+            ZFCoreArrayPOD<ZFObject *> objs;
+            for(zfindex i = 0; i < 100; ++i)
+            {
+                objs.add(zfAlloc(_ZFP_ZFCore_ZFObjectAllocTrack_test_Object));
+            }
+            ZFObjectAllocTrackState state;
+            ZFTestCaseAssert(ZFObjectAllocTrackStateGet(state, cls));
+            ZFTestCaseAssert(state.allocCount == 100);
+            ZFTestCaseAssert(state.liveCount == 100);
+            ZFTestCaseAssert(state.peakCount == 100);
+            ZFTestCaseAssert(state.objectSize == sizeof(_ZFP_ZFCore_ZFObjectAllocTrack_test_Object));
+            ZFTestCaseAssert(state.liveBytes == 100 * state.objectSize);
+            for(zfindex i = 0; i < objs.count(); ++i)
+            {
+                zfRelease(objs[i]);
+            }
+            ZFTestCaseAssert(ZFObjectAllocTrackStateGet(state, cls));
+            ZFTestCaseAssert(state.deallocCount == 100);
+            ZFTestCaseAssert(state.liveCount == 0);
+            ZFTestCaseAssert(state.peakCount == 100);
+            ZFTestCaseAssert(state.liveBytes == 0);
+            ZFTestCaseAssert(state.peakBytes == 100 * state.objectSize);
+        }
+
+        this->testCaseOutputSeparator();
+        this->testCaseOutput("alloc with cache");
+        {
+            ZFObjectAllocTrackReset();
+            for(zfindex i = 0; i < 100; ++i)
+            {
+                zfRelease(zfAllocWithCache(_ZFP_ZFCore_ZFObjectAllocTrack_test_Object));
+            }
+            ZFObjectAllocTrackState state;
+            ZFTestCaseAssert(ZFObjectAllocTrackStateGet(state, cls));
+            ZFTestCaseAssert(state.allocCount + state.cacheHitCount == 100);
+            ZFTestCaseAssert(state.cacheHitCount > 0);
+            ZFTestCaseAssert(state.liveCount <= 1);
+            zfAllocCacheRemoveAll();
+        }
+
+        this->testCaseOutputSeparator();
+        this->testCaseOutput("top allocated classes");
+        {
+            zfstring s;
+            ZFObjectAllocTrackPrint(ZFOutputForString(s), 10);
+            this->testCaseOutput("%s", s.cString());
+        }
+
+        ZFObjectAllocTrackEnable(enabledSaved);
+        this->testCaseStop();
+    }
+};
+ZFOBJECT_REGISTER(ZFCore_ZFObjectAllocTrack_test)
+
+ZF_NAMESPACE_GLOBAL_END
+
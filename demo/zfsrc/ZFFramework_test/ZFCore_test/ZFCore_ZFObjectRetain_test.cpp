@@ -0,0 +1,176 @@
+#include "ZFCore_test.h"
+
+ZF_NAMESPACE_GLOBAL_BEGIN
+
+#define _ZFP_ZFCore_ZFObjectRetain_test_threadCount 4
+#define _ZFP_ZFCore_ZFObjectRetain_test_loopCount 10000
+
+static zfatomicint _ZFP_ZFCore_ZFObjectRetain_test_retainCount = 0;
+static zfatomicint _ZFP_ZFCore_ZFObjectRetain_test_releaseCount = 0;
+// hooks called while the object is not properly held
+static zfatomicint _ZFP_ZFCore_ZFObjectRetain_test_errorCount = 0;
+static zfatomicint _ZFP_ZFCore_ZFObjectRetain_test_deallocCount = 0;
+static zfatomicint _ZFP_ZFCore_ZFObjectRetain_test_beforeDeallocCount = 0;
+
+// ============================================================
+zfclass _ZFP_ZFCore_ZFObjectRetain_test_Object : zfextends ZFObject
+{
+    ZFOBJECT_DECLARE(_ZFP_ZFCore_ZFObjectRetain_test_Object, ZFObject)
+
+protected:
+    zfoverride
+    virtual void objectOnDealloc(void)
+    {
+        // all hooks must have been finished before dealloc
+        if(zfAtomicLoad(_ZFP_ZFCore_ZFObjectRetain_test_retainCount) + 1
+            != zfAtomicLoad(_ZFP_ZFCore_ZFObjectRetain_test_releaseCount))
+        {
+            zfAtomicIncrease(_ZFP_ZFCore_ZFObjectRetain_test_errorCount);
+        }
+        zfAtomicIncrease(_ZFP_ZFCore_ZFObjectRetain_test_deallocCount);
+        zfsuper::objectOnDealloc();
+    }
+    // the retain count has been increased, and the caller holds at least one other reference
+    zfoverride
+    virtual void objectOnRetain(void)
+    {
+        zfsuper::objectOnRetain();
+        if(this->objectRetainCount() < 2)
+        {
+            zfAtomicIncrease(_ZFP_ZFCore_ZFObjectRetain_test_errorCount);
+        }
+        zfAtomicIncrease(_ZFP_ZFCore_ZFObjectRetain_test_retainCount);
+    }
+    // the retain count has not been decreased yet
+    zfoverride
+    virtual void objectOnRelease(void)
+    {
+        if(this->objectRetainCount() < 1)
+        {
+            zfAtomicIncrease(_ZFP_ZFCore_ZFObjectRetain_test_errorCount);
+        }
+        zfAtomicIncrease(_ZFP_ZFCore_ZFObjectRetain_test_releaseCount);
+        zfsuper::objectOnRelease();
+    }
+};
+ZFOBJECT_REGISTER(_ZFP_ZFCore_ZFObjectRetain_test_Object)
+
+// not passed as userData, which would be retained by the thread task itself
+static _ZFP_ZFCore_ZFObjectRetain_test_Object *_ZFP_ZFCore_ZFObjectRetain_test_obj = zfnull;
+
+static ZFLISTENER_PROTOTYPE_EXPAND(_ZFP_ZFCore_ZFObjectRetain_test_retainRelease)
+{
+    _ZFP_ZFCore_ZFObjectRetain_test_Object *obj = _ZFP_ZFCore_ZFObjectRetain_test_obj;
+    for(zfindex i = 0; i < _ZFP_ZFCore_ZFObjectRetain_test_loopCount; ++i)
+    {
+        zfRetain(obj);
+        zfRelease(obj);
+    }
+}
+// release the reference retained for this thread, the last one would dealloc the object
+static ZFLISTENER_PROTOTYPE_EXPAND(_ZFP_ZFCore_ZFObjectRetain_test_retainReleaseThenRelease)
+{
+    _ZFP_ZFCore_ZFObjectRetain_test_Object *obj = _ZFP_ZFCore_ZFObjectRetain_test_obj;
+    for(zfindex i = 0; i < _ZFP_ZFCore_ZFObjectRetain_test_loopCount; ++i)
+    {
+        zfRetain(obj);
+        zfRelease(obj);
+    }
+    zfRelease(obj);
+}
+static ZFLISTENER_PROTOTYPE_EXPAND(_ZFP_ZFCore_ZFObjectRetain_test_beforeDealloc)
+{
+    zfAtomicIncrease(_ZFP_ZFCore_ZFObjectRetain_test_beforeDeallocCount);
+}
+
+zfclass ZFCore_ZFObjectRetain_test : zfextends ZFFramework_test_TestCase
+{
+    ZFOBJECT_DECLARE(ZFCore_ZFObjectRetain_test, ZFFramework_test_TestCase)
+
+protected:
+    zfoverride
+    virtual void testCaseOnStart(void)
+    {
+        zfsuper::testCaseOnStart();
+        ZFFramework_test_protocolCheck(ZFThread);
+
+        zfidentity taskIds[_ZFP_ZFCore_ZFObjectRetain_test_threadCount];
+        zfint total = _ZFP_ZFCore_ZFObjectRetain_test_threadCount * _ZFP_ZFCore_ZFObjectRetain_test_loopCount;
+
+        this->testCaseOutputSeparator();
+        this->testCaseOutput("concurrent retain and release");
+        {
+            this->counterReset();
+            _ZFP_ZFCore_ZFObjectRetain_test_obj = zfAlloc(_ZFP_ZFCore_ZFObjectRetain_test_Object);
+            for(zfindex i = 0; i < _ZFP_ZFCore_ZFObjectRetain_test_threadCount; ++i)
+            {
+                taskIds[i] = ZFThreadExecuteInNewThread(ZFCallbackForFunc(_ZFP_ZFCore_ZFObjectRetain_test_retainRelease));
+            }
+            for(zfindex i = 0; i < _ZFP_ZFCore_ZFObjectRetain_test_threadCount; ++i)
+            {
+                ZFThreadExecuteWait(taskIds[i]);
+            }
+            this->counterOutput();
+            ZFTestCaseAssert(_ZFP_ZFCore_ZFObjectRetain_test_obj->objectRetainCount() == 1);
+            ZFTestCaseAssert(zfAtomicLoad(_ZFP_ZFCore_ZFObjectRetain_test_retainCount) == total);
+            ZFTestCaseAssert(zfAtomicLoad(_ZFP_ZFCore_ZFObjectRetain_test_releaseCount) == total);
+            ZFTestCaseAssert(zfAtomicLoad(_ZFP_ZFCore_ZFObjectRetain_test_errorCount) == 0);
+            ZFTestCaseAssert(zfAtomicLoad(_ZFP_ZFCore_ZFObjectRetain_test_deallocCount) == 0);
+
+            zfRelease(_ZFP_ZFCore_ZFObjectRetain_test_obj);
+            _ZFP_ZFCore_ZFObjectRetain_test_obj = zfnull;
+            ZFTestCaseAssert(zfAtomicLoad(_ZFP_ZFCore_ZFObjectRetain_test_deallocCount) == 1);
+            ZFTestCaseAssert(zfAtomicLoad(_ZFP_ZFCore_ZFObjectRetain_test_errorCount) == 0);
+        }
+
+        this->testCaseOutputSeparator();
+        this->testCaseOutput("last release from other thread");
+        {
+            this->counterReset();
+            _ZFP_ZFCore_ZFObjectRetain_test_obj = zfAlloc(_ZFP_ZFCore_ZFObjectRetain_test_Object);
+            _ZFP_ZFCore_ZFObjectRetain_test_obj->observerAdd(ZFObject::EventObjectBeforeDealloc(),
+                ZFCallbackForFunc(_ZFP_ZFCore_ZFObjectRetain_test_beforeDealloc));
+            for(zfindex i = 0; i < _ZFP_ZFCore_ZFObjectRetain_test_threadCount; ++i)
+            {
+                zfRetain(_ZFP_ZFCore_ZFObjectRetain_test_obj);
+                taskIds[i] = ZFThreadExecuteInNewThread(ZFCallbackForFunc(_ZFP_ZFCore_ZFObjectRetain_test_retainReleaseThenRelease));
+            }
+            zfRelease(_ZFP_ZFCore_ZFObjectRetain_test_obj);
+            for(zfindex i = 0; i < _ZFP_ZFCore_ZFObjectRetain_test_threadCount; ++i)
+            {
+                ZFThreadExecuteWait(taskIds[i]);
+            }
+            _ZFP_ZFCore_ZFObjectRetain_test_obj = zfnull;
+            this->counterOutput();
+            ZFTestCaseAssert(zfAtomicLoad(_ZFP_ZFCore_ZFObjectRetain_test_retainCount) == total + _ZFP_ZFCore_ZFObjectRetain_test_threadCount);
+            ZFTestCaseAssert(zfAtomicLoad(_ZFP_ZFCore_ZFObjectRetain_test_releaseCount) == total + _ZFP_ZFCore_ZFObjectRetain_test_threadCount + 1);
+            ZFTestCaseAssert(zfAtomicLoad(_ZFP_ZFCore_ZFObjectRetain_test_errorCount) == 0);
+            ZFTestCaseAssert(zfAtomicLoad(_ZFP_ZFCore_ZFObjectRetain_test_deallocCount) == 1);
+            ZFTestCaseAssert(zfAtomicLoad(_ZFP_ZFCore_ZFObjectRetain_test_beforeDeallocCount) == 1);
+        }
+
+        this->testCaseStop();
+    }
+
+private:
+    void counterReset(void)
+    {
+        zfAtomicStore(_ZFP_ZFCore_ZFObjectRetain_test_retainCount, 0);
+        zfAtomicStore(_ZFP_ZFCore_ZFObjectRetain_test_releaseCount, 0);
+        zfAtomicStore(_ZFP_ZFCore_ZFObjectRetain_test_errorCount, 0);
+        zfAtomicStore(_ZFP_ZFCore_ZFObjectRetain_test_deallocCount, 0);
+        zfAtomicStore(_ZFP_ZFCore_ZFObjectRetain_test_beforeDeallocCount, 0);
+    }
+    void counterOutput(void)
+    {
+        this->testCaseOutput("retain: %d, release: %d, error: %d, dealloc: %d",
+            (zfint)zfAtomicLoad(_ZFP_ZFCore_ZFObjectRetain_test_retainCount),
+            (zfint)zfAtomicLoad(_ZFP_ZFCore_ZFObjectRetain_test_releaseCount),
+            (zfint)zfAtomicLoad(_ZFP_ZFCore_ZFObjectRetain_test_errorCount),
+            (zfint)zfAtomicLoad(_ZFP_ZFCore_ZFObjectRetain_test_deallocCount));
+    }
+};
+ZFOBJECT_REGISTER(ZFCore_ZFObjectRetain_test)
+
+ZF_NAMESPACE_GLOBAL_END
+
@@ -0,0 +1,161 @@
+#include "ZFCore_test.h"
+
+ZF_NAMESPACE_GLOBAL_BEGIN
+
+#define _ZFP_ZFCore_ZFObjectTag_test_tagCount 6
+
+zfclass ZFCore_ZFObjectTag_test : zfextends ZFFramework_test_TestCase
+{
+    ZFOBJECT_DECLARE(ZFCore_ZFObjectTag_test, ZFFramework_test_TestCase)
+
+protected:
+    zfoverride
+    virtual void testCaseOnStart(void)
+    {
+        zfsuper::testCaseOnStart();
+
+        zfblockedAlloc(ZFObject, obj);
+        ZFObject *values[_ZFP_ZFCore_ZFObjectTag_test_tagCount];
+        for(zfindex i = 0; i < _ZFP_ZFCore_ZFObjectTag_test_tagCount; ++i)
+        {
+            values[i] = zfAlloc(ZFObject);
+        }
+
+        this->testCaseOutputSeparator();
+        this->testCaseOutput("set and get, more than inline slots");
+        {
+            ZFTestCaseAssert(!obj->objectTagExist());
+            ZFTestCaseAssert(obj->objectTag("tag0") == zfnull);
+            // removing from an object without tag must not create tag storage
+            obj->objectTagRemove("tag0");
+            ZFTestCaseAssert(!obj->objectTagExist());
+
+            for(zfindex i = 0; i < _ZFP_ZFCore_ZFObjectTag_test_tagCount; ++i)
+            {
+                obj->objectTag(zfstringWithFormat("tag%zi", i), values[i]);
+            }
+            ZFTestCaseAssert(obj->objectTagExist());
+            for(zfindex i = 0; i < _ZFP_ZFCore_ZFObjectTag_test_tagCount; ++i)
+            {
+                ZFTestCaseAssert(obj->objectTag(zfstringWithFormat("tag%zi", i)) == values[i]);
+                ZFTestCaseAssert(values[i]->objectRetainCount() == 2);
+            }
+            this->checkOrder(obj, "tag0 tag1 tag2 tag3 tag4 tag5");
+        }
+
+        this->testCaseOutputSeparator();
+        this->testCaseOutput("replace inline and heap tags");
+        {
+            // inline slot
+            obj->objectTag("tag1", values[5]);
+            ZFTestCaseAssert(obj->objectTag("tag1") == values[5]);
+            ZFTestCaseAssert(values[1]->objectRetainCount() == 1);
+            // heap slot
+            obj->objectTag("tag4", values[1]);
+            ZFTestCaseAssert(obj->objectTag("tag4") == values[1]);
+            ZFTestCaseAssert(values[4]->objectRetainCount() == 1);
+            // replace keeps position
+            this->checkOrder(obj, "tag0 tag1 tag2 tag3 tag4 tag5");
+
+            obj->objectTag("tag1", values[1]);
+            obj->objectTag("tag4", values[4]);
+            ZFTestCaseAssert(values[5]->objectRetainCount() == 2);
+        }
+
+        this->testCaseOutputSeparator();
+        this->testCaseOutput("remove, last tag moves to the removed position");
+        {
+            // inline slot, refilled from heap
+            obj->objectTagRemove("tag0");
+            ZFTestCaseAssert(obj->objectTag("tag0") == zfnull);
+            ZFTestCaseAssert(values[0]->objectRetainCount() == 1);
+            this->checkOrder(obj, "tag5 tag1 tag2 tag3 tag4");
+
+            // heap slot
+            zfautoObject removed = obj->objectTagRemoveAndGet("tag2");
+            ZFTestCaseAssert(removed == values[2]);
+            ZFTestCaseAssert(values[2]->objectRetainCount() == 2);
+            removed = zfnull;
+            ZFTestCaseAssert(values[2]->objectRetainCount() == 1);
+            ZFTestCaseAssert(obj->objectTagRemoveAndGet("tag2") == zfnull);
+            this->checkOrder(obj, "tag5 tag1 tag4 tag3");
+
+            // last one
+            obj->objectTagRemove("tag3");
+            this->checkOrder(obj, "tag5 tag1 tag4");
+
+            // add after remove reuses the freed tail
+            obj->objectTag("tag0", values[0]);
+            this->checkOrder(obj, "tag5 tag1 tag4 tag0");
+
+            obj->objectTagRemove("tag4");
+            obj->objectTagRemove("tag0");
+            obj->objectTagRemove("tag5");
+            this->checkOrder(obj, "tag1");
+            obj->objectTagRemove("tag1");
+            ZFTestCaseAssert(!obj->objectTagExist());
+        }
+
+        this->testCaseOutputSeparator();
+        this->testCaseOutput("remove all");
+        {
+            for(zfindex i = 0; i < _ZFP_ZFCore_ZFObjectTag_test_tagCount; ++i)
+            {
+                obj->objectTag(zfstringWithFormat("tag%zi", i), values[i]);
+            }
+            obj->objectTagRemoveAll();
+            ZFTestCaseAssert(!obj->objectTagExist());
+            for(zfindex i = 0; i < _ZFP_ZFCore_ZFObjectTag_test_tagCount; ++i)
+            {
+                ZFTestCaseAssert(obj->objectTag(zfstringWithFormat("tag%zi", i)) == zfnull);
+                ZFTestCaseAssert(values[i]->objectRetainCount() == 1);
+            }
+        }
+
+        this->testCaseOutputSeparator();
+        this->testCaseOutput("tags released with owner");
+        {
+            ZFObject *owner = zfAlloc(ZFObject);
+            for(zfindex i = 0; i < _ZFP_ZFCore_ZFObjectTag_test_tagCount; ++i)
+            {
+                owner->objectTag(zfstringWithFormat("tag%zi", i), values[i]);
+            }
+            zfRelease(owner);
+            for(zfindex i = 0; i < _ZFP_ZFCore_ZFObjectTag_test_tagCount; ++i)
+            {
+                ZFTestCaseAssert(values[i]->objectRetainCount() == 1);
+            }
+        }
+
+        for(zfindex i = 0; i < _ZFP_ZFCore_ZFObjectTag_test_tagCount; ++i)
+        {
+            zfRelease(values[i]);
+        }
+        this->testCaseStop();
+    }
+
+private:
+    void checkOrder(ZF_IN ZFObject *obj,
+                    ZF_IN const zfchar *expected)
+    {
+        ZFCoreArrayPOD<const zfchar *> allKey;
+        ZFCoreArrayPOD<ZFObject *> allValue;
+        obj->objectTagGetAllKeyValue(allKey, allValue);
+        zfstring keys;
+        for(zfindex i = 0; i < allKey.count(); ++i)
+        {
+            if(i != 0)
+            {
+                keys += " ";
+            }
+            keys += allKey[i];
+            ZFTestCaseAssert(obj->objectTag(allKey[i]) == allValue[i]);
+        }
+        this->testCaseOutput("tags: %s", keys.cString());
+        ZFTestCaseAssert(zfscmpTheSame(keys.cString(), expected));
+    }
+};
+ZFOBJECT_REGISTER(ZFCore_ZFObjectTag_test)
+
+ZF_NAMESPACE_GLOBAL_END
+
@@ -0,0 +1,82 @@
+#include "ZFCore_test.h"
+
+ZF_NAMESPACE_GLOBAL_BEGIN
+
+#define _ZFP_ZFCore_ZFObserverThread_test_threadCount 4
+#define _ZFP_ZFCore_ZFObserverThread_test_loopCount 1000
+#define _ZFP_ZFCore_ZFObserverThread_test_roundCount 20
+
+static ZFObject *_ZFP_ZFCore_ZFObserverThread_test_target = zfnull;
+static zfatomicint _ZFP_ZFCore_ZFObserverThread_test_notifyCount = 0;
+
+static ZFLISTENER_PROTOTYPE_EXPAND(_ZFP_ZFCore_ZFObserverThread_test_dummy)
+{
+}
+static ZFLISTENER_PROTOTYPE_EXPAND(_ZFP_ZFCore_ZFObserverThread_test_beforeDealloc)
+{
+    zfAtomicIncrease(_ZFP_ZFCore_ZFObserverThread_test_notifyCount);
+}
+static ZFLISTENER_PROTOTYPE_EXPAND(_ZFP_ZFCore_ZFObserverThread_test_worker)
+{
+    zfindex threadIndex = (zfindex)userData->to<v_zfindex *>()->zfv;
+    ZFObject *target = _ZFP_ZFCore_ZFObserverThread_test_target;
+    for(zfindex i = 0; i < _ZFP_ZFCore_ZFObserverThread_test_loopCount; ++i)
+    {
+        // the event goes empty and non-empty repeatedly,
+        // which causes observerOnAdd and observerOnRemove run concurrently
+        zfidentity taskId = target->observerAdd(
+            ZFObject::EventObjectBeforeDealloc(),
+            ZFCallbackForFunc(_ZFP_ZFCore_ZFObserverThread_test_dummy));
+        target->observerRemoveByTaskId(taskId);
+
+        if(threadIndex == 0 && i == _ZFP_ZFCore_ZFObserverThread_test_loopCount / 2)
+        {
+            target->observerAdd(
+                ZFObject::EventObjectBeforeDealloc(),
+                ZFCallbackForFunc(_ZFP_ZFCore_ZFObserverThread_test_beforeDealloc));
+        }
+    }
+}
+
+zfclass ZFCore_ZFObserverThread_test : zfextends ZFFramework_test_TestCase
+{
+    ZFOBJECT_DECLARE(ZFCore_ZFObserverThread_test, ZFFramework_test_TestCase)
+
+protected:
+    zfoverride
+    virtual void testCaseOnStart(void)
+    {
+        zfsuper::testCaseOnStart();
+        ZFFramework_test_protocolCheck(ZFThread);
+
+        this->testCaseOutputSeparator();
+        this->testCaseOutput("add and remove observers of one object in %d threads",
+            (zfint)_ZFP_ZFCore_ZFObserverThread_test_threadCount);
+        zfAtomicStore(_ZFP_ZFCore_ZFObserverThread_test_notifyCount, 0);
+        for(zfindex round = 0; round < _ZFP_ZFCore_ZFObserverThread_test_roundCount; ++round)
+        {
+            _ZFP_ZFCore_ZFObserverThread_test_target = zfAlloc(ZFObject);
+            zfidentity taskIdList[_ZFP_ZFCore_ZFObserverThread_test_threadCount];
+            for(zfindex i = 0; i < _ZFP_ZFCore_ZFObserverThread_test_threadCount; ++i)
+            {
+                zfblockedAlloc(v_zfindex, threadIndex, i);
+                taskIdList[i] = ZFThreadExecuteInNewThread(ZFCallbackForFunc(_ZFP_ZFCore_ZFObserverThread_test_worker), threadIndex);
+            }
+            for(zfindex i = 0; i < _ZFP_ZFCore_ZFObserverThread_test_threadCount; ++i)
+            {
+                ZFThreadExecuteWait(taskIdList[i]);
+            }
+
+            // the observer that remains must still be notified
+            zfRelease(_ZFP_ZFCore_ZFObserverThread_test_target);
+            _ZFP_ZFCore_ZFObserverThread_test_target = zfnull;
+            ZFTestCaseAssert(zfAtomicLoad(_ZFP_ZFCore_ZFObserverThread_test_notifyCount) == (zfint)(round + 1));
+        }
+
+        this->testCaseStop();
+    }
+};
+ZFOBJECT_REGISTER(ZFCore_ZFObserverThread_test)
+
+ZF_NAMESPACE_GLOBAL_END
+
@@ -0,0 +1,161 @@
+#include "ZFCore_test.h"
+#include "ZFImpl/default/ZFImpl_default_ZFCore_impl.h"
+
+ZF_NAMESPACE_GLOBAL_BEGIN
+
+// run order of the test tasks, separated by space
+static zfstring _ZFP_ZFCore_ZFThreadMainLoop_test_order;
+static ZFLISTENER_PROTOTYPE_EXPAND(_ZFP_ZFCore_ZFThreadMainLoop_test_task)
+{
+    _ZFP_ZFCore_ZFThreadMainLoop_test_order += userData->to<v_zfstring *>()->zfv;
+    _ZFP_ZFCore_ZFThreadMainLoop_test_order += " ";
+}
+static zfidentity _ZFP_ZFCore_ZFThreadMainLoop_test_taskToCancel = zfidentityInvalid();
+static ZFLISTENER_PROTOTYPE_EXPAND(_ZFP_ZFCore_ZFThreadMainLoop_test_cancelTask)
+{
+    _ZFP_ZFCore_ZFThreadMainLoop_test_order += "cancel ";
+    ZFThreadExecuteCancel(_ZFP_ZFCore_ZFThreadMainLoop_test_taskToCancel);
+}
+static ZFLISTENER_PROTOTYPE_EXPAND(_ZFP_ZFCore_ZFThreadMainLoop_test_quitTask)
+{
+    _ZFP_ZFCore_ZFThreadMainLoop_test_order += "quit ";
+    ZFImpl_default_mainThreadQuit();
+}
+static ZFLISTENER_PROTOTYPE_EXPAND(_ZFP_ZFCore_ZFThreadMainLoop_test_quitFromThread)
+{
+    ZFThread::sleep((zftimet)50);
+    ZFImpl_default_mainThreadQuit();
+}
+
+zfclass ZFCore_ZFThreadMainLoop_test : zfextends ZFFramework_test_TestCase
+{
+    ZFOBJECT_DECLARE(ZFCore_ZFThreadMainLoop_test, ZFFramework_test_TestCase)
+
+protected:
+    zfoverride
+    virtual void testCaseOnStart(void)
+    {
+        zfsuper::testCaseOnStart();
+        ZFFramework_test_protocolCheck(ZFThread);
+        ZFProtocol *impl = ZFProtocolForName("ZFThread");
+        if(!zfscmpTheSame(impl->protocolImplementationName(), "ZFThreadImpl_default"))
+        {
+            this->testCaseOutput("ZFThread impl is %s, skip test case", impl->protocolImplementationName());
+            this->testCaseStop();
+            return ;
+        }
+        // run tasks queued by others, so that only test tasks would be run below
+        while(ZFImpl_default_mainThreadRunOnce(0) > 0) {}
+
+        this->testCaseOutputSeparator();
+        this->testCaseOutput("FIFO and delayed order");
+        {
+            _ZFP_ZFCore_ZFThreadMainLoop_test_order.removeAll();
+            zfstring expected = "A B E ";
+            // queued in a row, most of them would have the same fire time
+            for(zfindex i = 0; i < 20; ++i)
+            {
+                zfstring name = zfstringWithFormat("D%zi", i);
+                expected += name;
+                expected += " ";
+                this->taskAdd(name, 50);
+            }
+            this->taskAdd("E", 10);
+            this->taskAdd("A");
+            this->taskAdd("B");
+
+            ZFTestCaseAssert(ZFImpl_default_mainThreadNextTimeout() == 0);
+            ZFTestCaseAssert(ZFImpl_default_mainThreadRunOnce(0) == 2);
+            ZFTestCaseAssert(_ZFP_ZFCore_ZFThreadMainLoop_test_order == "A B ");
+
+            zftimet nextTimeout = ZFImpl_default_mainThreadNextTimeout();
+            ZFTestCaseAssert(nextTimeout >= 0 && nextTimeout <= 10);
+            this->runUntil(21);
+            this->testCaseOutput("order: %s", _ZFP_ZFCore_ZFThreadMainLoop_test_order.cString());
+            ZFTestCaseAssert(_ZFP_ZFCore_ZFThreadMainLoop_test_order == expected);
+            ZFTestCaseAssert(ZFImpl_default_mainThreadNextTimeout() == -1);
+        }
+
+        this->testCaseOutputSeparator();
+        this->testCaseOutput("cancel queued and delayed tasks");
+        {
+            _ZFP_ZFCore_ZFThreadMainLoop_test_order.removeAll();
+            zfidentity queued = this->taskAdd("queued");
+            zfidentity delayed = this->taskAdd("delayed", 10);
+            this->taskAdd("A");
+            ZFThreadExecuteCancel(queued);
+            ZFThreadExecuteCancel(delayed);
+            ZFTestCaseAssert(ZFImpl_default_mainThreadRunOnce(0) == 1);
+            ZFTestCaseAssert(ZFImpl_default_mainThreadNextTimeout() == -1);
+
+            // cancel a task in the same batch
+            ZFThreadExecuteInMainThread(ZFCallbackForFunc(_ZFP_ZFCore_ZFThreadMainLoop_test_cancelTask));
+            _ZFP_ZFCore_ZFThreadMainLoop_test_taskToCancel = this->taskAdd("sameBatch");
+            this->taskAdd("B");
+            ZFTestCaseAssert(ZFImpl_default_mainThreadRunOnce(0) == 2);
+
+            ZFThread::sleep((zftimet)20);
+            ZFTestCaseAssert(ZFImpl_default_mainThreadRunOnce(0) == 0);
+            this->testCaseOutput("order: %s", _ZFP_ZFCore_ZFThreadMainLoop_test_order.cString());
+            ZFTestCaseAssert(_ZFP_ZFCore_ZFThreadMainLoop_test_order == "A cancel B ");
+        }
+
+        this->testCaseOutputSeparator();
+        this->testCaseOutput("wakeup and timeout");
+        {
+            ZFImpl_default_mainThreadWakeup();
+            ZFTestCaseAssert(ZFImpl_default_mainThreadNextTimeout() == 0);
+            ZFTestCaseAssert(ZFImpl_default_mainThreadRunOnce(-1) == 0);
+            ZFTestCaseAssert(ZFImpl_default_mainThreadNextTimeout() == -1);
+
+            zftimet startTime = ZFTime::timestamp();
+            ZFTestCaseAssert(ZFImpl_default_mainThreadRunOnce(30) == 0);
+            ZFTestCaseAssert(ZFTime::timestamp() - startTime >= 20);
+        }
+
+        this->testCaseOutputSeparator();
+        this->testCaseOutput("mainThreadQuit");
+        {
+            _ZFP_ZFCore_ZFThreadMainLoop_test_order.removeAll();
+            this->taskAdd("A");
+            ZFThreadExecuteInMainThread(ZFCallbackForFunc(_ZFP_ZFCore_ZFThreadMainLoop_test_quitTask));
+            ZFImpl_default_mainThreadRun();
+            ZFTestCaseAssert(_ZFP_ZFCore_ZFThreadMainLoop_test_order == "A quit ");
+
+            // quit from other thread while blocking
+            zfidentity taskId = ZFThreadExecuteInNewThread(ZFCallbackForFunc(_ZFP_ZFCore_ZFThreadMainLoop_test_quitFromThread));
+            ZFImpl_default_mainThreadRun();
+            ZFThreadExecuteWait(taskId);
+        }
+
+        _ZFP_ZFCore_ZFThreadMainLoop_test_order.removeAll();
+        this->testCaseStop();
+    }
+
+private:
+    zfidentity taskAdd(ZF_IN const zfchar *name, ZF_IN_OPT zftimet delay = 0)
+    {
+        zfblockedAlloc(v_zfstring, userData, name);
+        if(delay > 0)
+        {
+            return ZFThreadExecuteInMainThreadAfterDelay(delay, ZFCallbackForFunc(_ZFP_ZFCore_ZFThreadMainLoop_test_task), userData);
+        }
+        else
+        {
+            return ZFThreadExecuteInMainThread(ZFCallbackForFunc(_ZFP_ZFCore_ZFThreadMainLoop_test_task), userData);
+        }
+    }
+    void runUntil(ZF_IN zfindex taskCount)
+    {
+        zftimet startTime = ZFTime::timestamp();
+        zfindex ran = 0;
+        while(ran < taskCount && ZFTime::timestamp() - startTime < 1000)
+        {
+            ran += ZFImpl_default_mainThreadRunOnce(100);
+        }
+    }
+};
+ZFOBJECT_REGISTER(ZFCore_ZFThreadMainLoop_test)
+
+ZF_NAMESPACE_GLOBAL_END
+
@@ -0,0 +1,189 @@
+#include "ZFCore_test.h"
+
+ZF_NAMESPACE_GLOBAL_BEGIN
+
+#define _ZFP_ZFCore_ZFThreadParallel_test_count 20000
+#define _ZFP_ZFCore_ZFThreadParallel_test_nestedCount 16
+
+// how many times each index has been processed
+static zfatomicint *_ZFP_ZFCore_ZFThreadParallel_test_hits = zfnull;
+
+// first few indexes are much more expensive than others,
+// so that the worker owning them must be helped by others
+static zfindex _ZFP_ZFCore_ZFThreadParallel_test_process(ZF_IN zfindex index)
+{
+    zfindex cost = (index < _ZFP_ZFCore_ZFThreadParallel_test_count / 16 ? 2000 : 10);
+    volatile zfindex dummy = 0;
+    for(zfindex i = 0; i < cost; ++i)
+    {
+        dummy = dummy + i;
+    }
+    zfAtomicIncrease(_ZFP_ZFCore_ZFThreadParallel_test_hits[index]);
+    return index;
+}
+
+zfclassNotPOD _ZFP_ZFCore_ZFThreadParallel_test_For
+{
+public:
+    void operator () (ZF_IN zfindex start, ZF_IN zfindex count) const
+    {
+        for(zfindex i = start; i < start + count; ++i)
+        {
+            _ZFP_ZFCore_ZFThreadParallel_test_process(i);
+        }
+    }
+};
+zfclassNotPOD _ZFP_ZFCore_ZFThreadParallel_test_Map
+{
+public:
+    zfindex operator () (ZF_IN zfindex start, ZF_IN zfindex count) const
+    {
+        zfindex sum = 0;
+        for(zfindex i = start; i < start + count; ++i)
+        {
+            sum += _ZFP_ZFCore_ZFThreadParallel_test_process(i);
+        }
+        return sum;
+    }
+};
+zfclassNotPOD _ZFP_ZFCore_ZFThreadParallel_test_Reduce
+{
+public:
+    zfindex operator () (ZF_IN zfindex const &v0, ZF_IN zfindex const &v1) const
+    {
+        return v0 + v1;
+    }
+};
+
+// each outer index starts a nested parallel for of its own sub range
+static ZFLISTENER_PROTOTYPE_EXPAND(_ZFP_ZFCore_ZFThreadParallel_test_nested)
+{
+    ZFThreadParallelData *data = listenerData.param0()->to<ZFThreadParallelData *>();
+    zfindex each = _ZFP_ZFCore_ZFThreadParallel_test_count / _ZFP_ZFCore_ZFThreadParallel_test_nestedCount;
+    for(zfindex i = data->rangeStart(); i < data->rangeStart() + data->rangeCount(); ++i)
+    {
+        ZFThreadParallelForT(i * each, each, _ZFP_ZFCore_ZFThreadParallel_test_For(), 16);
+    }
+}
+static ZFLISTENER_PROTOTYPE_EXPAND(_ZFP_ZFCore_ZFThreadParallel_test_map)
+{
+    ZFThreadParallelData *data = listenerData.param0()->to<ZFThreadParallelData *>();
+    zfindex sum = _ZFP_ZFCore_ZFThreadParallel_test_Map()(data->rangeStart(), data->rangeCount());
+    data->result(zflineAlloc(v_zfindex, sum));
+}
+static ZFLISTENER_PROTOTYPE_EXPAND(_ZFP_ZFCore_ZFThreadParallel_test_reduce)
+{
+    ZFThreadParallelData *data = listenerData.param0()->to<ZFThreadParallelData *>();
+    data->result(zflineAlloc(v_zfindex,
+        data->reduceValue0()->to<v_zfindex *>()->zfv + data->reduceValue1()->to<v_zfindex *>()->zfv));
+}
+
+zfclass ZFCore_ZFThreadParallel_test : zfextends ZFFramework_test_TestCase
+{
+    ZFOBJECT_DECLARE(ZFCore_ZFThreadParallel_test, ZFFramework_test_TestCase)
+
+protected:
+    zfoverride
+    virtual void testCaseOnStart(void)
+    {
+        zfsuper::testCaseOnStart();
+        ZFFramework_test_protocolCheck(ZFThread);
+
+        _ZFP_ZFCore_ZFThreadParallel_test_hits = (zfatomicint *)zfmalloc(sizeof(zfatomicint) * _ZFP_ZFCore_ZFThreadParallel_test_count);
+        zfindex sumExpected = (zfindex)_ZFP_ZFCore_ZFThreadParallel_test_count * (_ZFP_ZFCore_ZFThreadParallel_test_count - 1) / 2;
+        this->testCaseOutput("concurrency: %zi", ZFThreadParallelConcurrency());
+
+        this->testCaseOutputSeparator();
+        this->testCaseOutput("ZFThreadParallelForT with uneven cost");
+        {
+            this->hitsReset();
+            ZFThreadParallelForT(0, _ZFP_ZFCore_ZFThreadParallel_test_count, _ZFP_ZFCore_ZFThreadParallel_test_For(), 16);
+            ZFTestCaseAssert(this->hitsCheck());
+
+            // automatic grain size
+            this->hitsReset();
+            ZFThreadParallelForT(0, _ZFP_ZFCore_ZFThreadParallel_test_count, _ZFP_ZFCore_ZFThreadParallel_test_For());
+            ZFTestCaseAssert(this->hitsCheck());
+
+            // not starting from 0, and count not divisible by grain size
+            this->hitsReset();
+            ZFThreadParallelForT(7, _ZFP_ZFCore_ZFThreadParallel_test_count - 7, _ZFP_ZFCore_ZFThreadParallel_test_For(), 13);
+            for(zfindex i = 0; i < 7; ++i)
+            {
+                zfAtomicIncrease(_ZFP_ZFCore_ZFThreadParallel_test_hits[i]);
+            }
+            ZFTestCaseAssert(this->hitsCheck());
+        }
+
+        this->testCaseOutputSeparator();
+        this->testCaseOutput("nested ZFThreadParallelFor");
+        {
+            this->hitsReset();
+            ZFThreadParallelFor(0, _ZFP_ZFCore_ZFThreadParallel_test_nestedCount,
+                ZFCallbackForFunc(_ZFP_ZFCore_ZFThreadParallel_test_nested), 1);
+            ZFTestCaseAssert(this->hitsCheck());
+        }
+
+        this->testCaseOutputSeparator();
+        this->testCaseOutput("ZFThreadParallelReduceT");
+        {
+            this->hitsReset();
+            zfindex sum = ZFThreadParallelReduceT(0, _ZFP_ZFCore_ZFThreadParallel_test_count, (zfindex)0,
+                _ZFP_ZFCore_ZFThreadParallel_test_Map(), _ZFP_ZFCore_ZFThreadParallel_test_Reduce(), 16);
+            this->testCaseOutput("sum: %zi, expected: %zi", sum, sumExpected);
+            ZFTestCaseAssert(sum == sumExpected);
+            ZFTestCaseAssert(this->hitsCheck());
+
+            ZFTestCaseAssert(ZFThreadParallelReduceT(0, 0, (zfindex)0,
+                _ZFP_ZFCore_ZFThreadParallel_test_Map(), _ZFP_ZFCore_ZFThreadParallel_test_Reduce()) == 0);
+        }
+
+        this->testCaseOutputSeparator();
+        this->testCaseOutput("ZFThreadParallelReduce");
+        {
+            this->hitsReset();
+            zfautoObject sum = ZFThreadParallelReduce(0, _ZFP_ZFCore_ZFThreadParallel_test_count,
+                ZFCallbackForFunc(_ZFP_ZFCore_ZFThreadParallel_test_map),
+                ZFCallbackForFunc(_ZFP_ZFCore_ZFThreadParallel_test_reduce),
+                16);
+            ZFTestCaseAssert(sum != zfnull);
+            ZFTestCaseAssert(sum.to<v_zfindex *>()->zfv == sumExpected);
+            ZFTestCaseAssert(this->hitsCheck());
+
+            ZFTestCaseAssert(ZFThreadParallelReduce(0, 0,
+                ZFCallbackForFunc(_ZFP_ZFCore_ZFThreadParallel_test_map),
+                ZFCallbackForFunc(_ZFP_ZFCore_ZFThreadParallel_test_reduce)) == zfnull);
+        }
+
+        zffree((void *)_ZFP_ZFCore_ZFThreadParallel_test_hits);
+        _ZFP_ZFCore_ZFThreadParallel_test_hits = zfnull;
+        this->testCaseStop();
+    }
+
+private:
+    void hitsReset(void)
+    {
+        for(zfindex i = 0; i < _ZFP_ZFCore_ZFThreadParallel_test_count; ++i)
+        {
+            zfAtomicStore(_ZFP_ZFCore_ZFThreadParallel_test_hits[i], 0);
+        }
+    }
+    // each index must be processed exactly once, no gap or overlap
+    zfbool hitsCheck(void)
+    {
+        for(zfindex i = 0; i < _ZFP_ZFCore_ZFThreadParallel_test_count; ++i)
+        {
+            zfint hits = zfAtomicLoad(_ZFP_ZFCore_ZFThreadParallel_test_hits[i]);
+            if(hits != 1)
+            {
+                this->testCaseOutput("index %zi processed %d times", i, (zfint)hits);
+                return zffalse;
+            }
+        }
+        return zftrue;
+    }
+};
+ZFOBJECT_REGISTER(ZFCore_ZFThreadParallel_test)
+
+ZF_NAMESPACE_GLOBAL_END
+
@@ -0,0 +1,96 @@
+#include "ZFCore_test.h"
+
+ZF_NAMESPACE_GLOBAL_BEGIN
+
+// more than the cpu count based limit of old thread pool
+#define _ZFP_ZFCore_ZFThreadPool_test_threadCount 64
+#define _ZFP_ZFCore_ZFThreadPool_test_timeout ((zftimet)10000)
+
+static zfatomicint _ZFP_ZFCore_ZFThreadPool_test_started = 0;
+static zfatomicint _ZFP_ZFCore_ZFThreadPool_test_finished = 0;
+static zfatomicint _ZFP_ZFCore_ZFThreadPool_test_timeoutCount = 0;
+
+// block until all of the threads are running,
+// which would never happen if any of them is queued
+static ZFLISTENER_PROTOTYPE_EXPAND(_ZFP_ZFCore_ZFThreadPool_test_blockingTask)
+{
+    zfAtomicIncrease(_ZFP_ZFCore_ZFThreadPool_test_started);
+    zftimet startTime = ZFTime::timestamp();
+    while(zfAtomicLoad(_ZFP_ZFCore_ZFThreadPool_test_started) < _ZFP_ZFCore_ZFThreadPool_test_threadCount)
+    {
+        if(ZFTime::timestamp() - startTime >= _ZFP_ZFCore_ZFThreadPool_test_timeout)
+        {
+            zfAtomicIncrease(_ZFP_ZFCore_ZFThreadPool_test_timeoutCount);
+            break;
+        }
+        ZFThread::sleep((zftimet)5);
+    }
+    zfAtomicIncrease(_ZFP_ZFCore_ZFThreadPool_test_finished);
+}
+
+zfclass ZFCore_ZFThreadPool_test : zfextends ZFFramework_test_TestCase
+{
+    ZFOBJECT_DECLARE(ZFCore_ZFThreadPool_test, ZFFramework_test_TestCase)
+
+protected:
+    zfoverride
+    virtual void testCaseOnStart(void)
+    {
+        zfsuper::testCaseOnStart();
+        ZFFramework_test_protocolCheck(ZFThread);
+
+        this->testCaseOutputSeparator();
+        this->testCaseOutput("start %d threads that block until all of them are running",
+            (zfint)_ZFP_ZFCore_ZFThreadPool_test_threadCount);
+        zfAtomicStore(_ZFP_ZFCore_ZFThreadPool_test_started, 0);
+        zfAtomicStore(_ZFP_ZFCore_ZFThreadPool_test_finished, 0);
+        zfAtomicStore(_ZFP_ZFCore_ZFThreadPool_test_timeoutCount, 0);
+
+        // half by ZFThread, half by ZFThreadExecuteInNewThread
+        ZFCoreArrayPOD<ZFThread *> threads;
+        ZFCoreArrayPOD<zfidentity> taskIdList;
+        for(zfindex i = 0; i < _ZFP_ZFCore_ZFThreadPool_test_threadCount; ++i)
+        {
+            if(i % 2 == 0)
+            {
+                ZFThread *thread = zfAlloc(ZFThread);
+                thread->threadRunnable(ZFCallbackForFunc(_ZFP_ZFCore_ZFThreadPool_test_blockingTask));
+                thread->threadStart();
+                threads.add(thread);
+            }
+            else
+            {
+                taskIdList.add(ZFThreadExecuteInNewThread(ZFCallbackForFunc(_ZFP_ZFCore_ZFThreadPool_test_blockingTask)));
+            }
+        }
+
+        zftimet startTime = ZFTime::timestamp();
+        while(zfAtomicLoad(_ZFP_ZFCore_ZFThreadPool_test_finished) < _ZFP_ZFCore_ZFThreadPool_test_threadCount
+            && ZFTime::timestamp() - startTime < _ZFP_ZFCore_ZFThreadPool_test_timeout * 2)
+        {
+            ZFThread::sleep((zftimet)10);
+        }
+        for(zfindex i = 0; i < threads.count(); ++i)
+        {
+            threads[i]->threadWait();
+            zfRelease(threads[i]);
+        }
+        for(zfindex i = 0; i < taskIdList.count(); ++i)
+        {
+            ZFThreadExecuteWait(taskIdList[i]);
+        }
+
+        this->testCaseOutput("started: %d, timeout: %d",
+            (zfint)zfAtomicLoad(_ZFP_ZFCore_ZFThreadPool_test_started),
+            (zfint)zfAtomicLoad(_ZFP_ZFCore_ZFThreadPool_test_timeoutCount));
+        ZFTestCaseAssert(zfAtomicLoad(_ZFP_ZFCore_ZFThreadPool_test_started) == _ZFP_ZFCore_ZFThreadPool_test_threadCount);
+        ZFTestCaseAssert(zfAtomicLoad(_ZFP_ZFCore_ZFThreadPool_test_finished) == _ZFP_ZFCore_ZFThreadPool_test_threadCount);
+        ZFTestCaseAssert(zfAtomicLoad(_ZFP_ZFCore_ZFThreadPool_test_timeoutCount) == 0);
+
+        this->testCaseStop();
+    }
+};
+ZFOBJECT_REGISTER(ZFCore_ZFThreadPool_test)
+
+ZF_NAMESPACE_GLOBAL_END
+
@@ -0,0 +1,123 @@
+#include "ZFCore_test.h"
+
+ZF_NAMESPACE_GLOBAL_BEGIN
+
+// whether actual ticks is close to expected ticks,
+// missed ticks are skipped instead of fired later, so allow fewer ticks on busy machines
+static zfbool _ZFP_ZFCore_ZFTimerSchedule_test_countCheck(ZF_IN zfindex actual, ZF_IN zfindex expected)
+{
+    zfindex tolerance = zfmMax<zfindex>(2, expected / 5);
+    return (actual <= expected + 1 && actual + tolerance >= expected);
+}
+
+zfclass ZFCore_ZFTimerSchedule_test : zfextends ZFFramework_test_TestCase
+{
+    ZFOBJECT_DECLARE(ZFCore_ZFTimerSchedule_test, ZFFramework_test_TestCase)
+
+protected:
+    zfoverride
+    virtual void testCaseOnStart(void)
+    {
+        zfsuper::testCaseOnStart();
+        ZFFramework_test_protocolCheck(ZFTimer);
+
+        // 300 is longer than the finest level of timer wheel, which would be cascaded
+        zftimet intervalList[] = {20, 70, 300};
+        zfindex timerCount = ZFM_ARRAY_SIZE(intervalList);
+        ZFCoreArrayPOD<ZFTimer *> &timers = this->timers;
+        for(zfindex i = 0; i < timerCount; ++i)
+        {
+            ZFTimer *timer = zfAlloc(ZFTimer);
+            timer->timerInterval(intervalList[i]);
+            timers.add(timer);
+        }
+
+        this->testCaseOutputSeparator();
+        this->testCaseOutput("timers with different intervals");
+        for(zfindex i = 0; i < timerCount; ++i)
+        {
+            timers[i]->timerStart();
+        }
+        this->mainThreadTimer->timerStart();
+        ZFThread::sleep((zftimet)1050);
+        for(zfindex i = 0; i < timerCount; ++i)
+        {
+            zfindex expected = (zfindex)(1050 / intervalList[i]);
+            zfindex actual = timers[i]->timerActivatedCount();
+            this->testCaseOutput("interval %d, ticks %d, expected %d",
+                (zfint)intervalList[i], (zfint)actual, (zfint)expected);
+            ZFTestCaseAssert(_ZFP_ZFCore_ZFTimerSchedule_test_countCheck(actual, expected));
+        }
+
+        this->testCaseOutputSeparator();
+        this->testCaseOutput("stopped timer must not tick");
+        timers[0]->timerStop();
+        ZFTestCaseAssert(!timers[0]->timerStarted());
+        ZFThread::sleep((zftimet)30);
+        zfindex stoppedCount = timers[0]->timerActivatedCount();
+        ZFThread::sleep((zftimet)100);
+        ZFTestCaseAssert(timers[0]->timerActivatedCount() == stoppedCount);
+
+        this->testCaseOutputSeparator();
+        this->testCaseOutput("restart timer");
+        timers[0]->timerStart();
+        ZFTestCaseAssert(timers[0]->timerStarted());
+        ZFTestCaseAssert(timers[0]->timerActivatedCount() <= 1);
+        ZFThread::sleep((zftimet)210);
+        ZFTestCaseAssert(_ZFP_ZFCore_ZFTimerSchedule_test_countCheck(
+            timers[0]->timerActivatedCount(), 210 / (zfindex)intervalList[0]));
+
+        for(zfindex i = 0; i < timerCount; ++i)
+        {
+            timers[i]->timerStop();
+        }
+
+        this->testCaseOutputSeparator();
+        this->testCaseOutput("ticks for blocked main thread would be merged");
+        // main thread has been blocked all the time,
+        // all pending ticks should have been merged into one,
+        // which is queued before the check task
+        ZFLISTENER_LOCAL(check, {
+            userData->to<ZFCore_ZFTimerSchedule_test *>()->mainThreadTimerCheck();
+        })
+        ZFThreadExecuteInMainThread(check, this);
+    }
+    zfoverride
+    virtual void objectOnInit(void)
+    {
+        zfsuper::objectOnInit();
+        this->mainThreadTimer = zfAlloc(ZFTimer);
+        this->mainThreadTimer->timerInterval((zftimet)10);
+        this->mainThreadTimer->timerActivateInMainThread(zftrue);
+    }
+    zfoverride
+    virtual void objectOnDealloc(void)
+    {
+        for(zfindex i = 0; i < this->timers.count(); ++i)
+        {
+            this->timers[i]->timerStop();
+            zfRelease(this->timers[i]);
+        }
+        this->mainThreadTimer->timerStop();
+        zfRelease(this->mainThreadTimer);
+        zfsuper::objectOnDealloc();
+    }
+
+public:
+    void mainThreadTimerCheck(void)
+    {
+        zfindex actual = this->mainThreadTimer->timerActivatedCount();
+        this->testCaseOutput("main thread ticks: %d", (zfint)actual);
+        ZFTestCaseAssert(actual >= 1 && actual <= 2);
+        this->mainThreadTimer->timerStop();
+        this->testCaseStop();
+    }
+
+private:
+    ZFCoreArrayPOD<ZFTimer *> timers;
+    ZFTimer *mainThreadTimer;
+};
+ZFOBJECT_REGISTER(ZFCore_ZFTimerSchedule_test)
+
+ZF_NAMESPACE_GLOBAL_END
+
@@ -0,0 +1,183 @@
+#include "ZFCore_test.h"
+
+ZF_NAMESPACE_GLOBAL_BEGIN
+
+static zfint _ZFP_ZFCore_zfiterator_test_aliveCount = 0;
+
+// stored inline
+zfclassNotPOD _ZFP_ZFCore_zfiterator_test_Small
+{
+public:
+    zfindex v;
+public:
+    _ZFP_ZFCore_zfiterator_test_Small(ZF_IN zfindex v)
+    : v(v)
+    {
+        ++_ZFP_ZFCore_zfiterator_test_aliveCount;
+    }
+    _ZFP_ZFCore_zfiterator_test_Small(ZF_IN const _ZFP_ZFCore_zfiterator_test_Small &ref)
+    : v(ref.v)
+    {
+        ++_ZFP_ZFCore_zfiterator_test_aliveCount;
+    }
+    ~_ZFP_ZFCore_zfiterator_test_Small(void)
+    {
+        --_ZFP_ZFCore_zfiterator_test_aliveCount;
+    }
+};
+// larger than ZFIteratorInlineSize, stored in heap
+zfclassNotPOD _ZFP_ZFCore_zfiterator_test_Large : zfextends _ZFP_ZFCore_zfiterator_test_Small
+{
+public:
+    zfbyte pad[ZFIteratorInlineSize];
+public:
+    _ZFP_ZFCore_zfiterator_test_Large(ZF_IN zfindex v)
+    : _ZFP_ZFCore_zfiterator_test_Small(v)
+    {
+    }
+};
+
+zfclass ZFCore_zfiterator_test : zfextends ZFFramework_test_TestCase
+{
+    ZFOBJECT_DECLARE(ZFCore_zfiterator_test, ZFFramework_test_TestCase)
+
+protected:
+    zfoverride
+    virtual void testCaseOnStart(void)
+    {
+        zfsuper::testCaseOnStart();
+
+        this->testCaseOutputSeparator();
+        this->testCaseOutput("copy and assign inline and heap data");
+        {
+            typedef _ZFP_ZFCore_zfiterator_test_Small Small;
+            typedef _ZFP_ZFCore_zfiterator_test_Large Large;
+            _ZFP_ZFCore_zfiterator_test_aliveCount = 0;
+            {
+                zfiterator small = zfiterator::iteratorCreate(Small(1));
+                zfiterator large = zfiterator::iteratorCreate(Large(2));
+                // inline data stored in the iterator itself
+                ZFTestCaseAssert((const void *)small.data() >= (const void *)&small
+                    && (const void *)small.data() < (const void *)(&small + 1));
+                ZFTestCaseAssert((const void *)large.data() < (const void *)&large
+                    || (const void *)large.data() >= (const void *)(&large + 1));
+                ZFTestCaseAssert(_ZFP_ZFCore_zfiterator_test_aliveCount == 2);
+
+                // copies are independent
+                zfiterator smallCopy(small);
+                zfiterator largeCopy(large);
+                ZFTestCaseAssert(_ZFP_ZFCore_zfiterator_test_aliveCount == 4);
+                smallCopy.data<Small *>()->v = 10;
+                largeCopy.data<Large *>()->v = 20;
+                ZFTestCaseAssert(small.data<Small *>()->v == 1 && large.data<Large *>()->v == 2);
+
+                // assign between inline and heap
+                zfiterator tmp = small;
+                ZFTestCaseAssert(tmp.data<Small *>()->v == 1);
+                tmp = large;
+                ZFTestCaseAssert(tmp.data<Large *>()->v == 2 && tmp.data() != large.data());
+                tmp = smallCopy;
+                ZFTestCaseAssert(tmp.data<Small *>()->v == 10);
+                tmp = tmp;
+                ZFTestCaseAssert(tmp.data<Small *>()->v == 10);
+                ZFTestCaseAssert(_ZFP_ZFCore_zfiterator_test_aliveCount == 5);
+
+                // assign to and from empty iterator
+                tmp = zfiterator();
+                ZFTestCaseAssert(tmp.data() == zfnull);
+                ZFTestCaseAssert(_ZFP_ZFCore_zfiterator_test_aliveCount == 4);
+                zfiterator empty;
+                largeCopy = empty;
+                smallCopy = empty;
+                ZFTestCaseAssert(largeCopy.data() == zfnull && smallCopy.data() == zfnull);
+                ZFTestCaseAssert(_ZFP_ZFCore_zfiterator_test_aliveCount == 2);
+            }
+            ZFTestCaseAssert(_ZFP_ZFCore_zfiterator_test_aliveCount == 0);
+        }
+
+        this->testCaseOutputSeparator();
+        this->testCaseOutput("ZFMap");
+        this->mapTest(zflineAlloc(ZFMapEditable));
+
+        this->testCaseOutputSeparator();
+        this->testCaseOutput("ZFHashMap");
+        this->mapTest(zflineAlloc(ZFHashMapEditable));
+
+        this->testCaseStop();
+    }
+
+private:
+    template<typename T_Map>
+    void mapTest(ZF_IN T_Map *m)
+    {
+        // ZFHashMap compares keys by objectHash, keep the key objects for lookup
+        ZFObject *keys[5];
+        for(zfint i = 0; i < 5; ++i)
+        {
+            keys[i] = zfAlloc(v_zfint, i);
+            m->set(keys[i], zflineAlloc(v_zfint, i * 10));
+        }
+
+        zfiterator it = m->iterator();
+        m->iteratorNextKey(it);
+
+        // copy keeps position, and moves independently
+        zfiterator copied(it);
+        ZFTestCaseAssert(m->iteratorIsValid(copied));
+        ZFTestCaseAssert(m->iteratorIsEqual(it, copied));
+        ZFTestCaseAssert(m->iteratorKey(copied) == m->iteratorKey(it));
+        ZFTestCaseAssert(this->remainCount(m, copied) == 4);
+        ZFTestCaseAssert(!m->iteratorIsValid(copied));
+        ZFTestCaseAssert(m->iteratorIsValid(it));
+
+        // assign
+        zfiterator assigned = m->iterator();
+        assigned = it;
+        ZFTestCaseAssert(m->iteratorIsEqual(it, assigned));
+        assigned = assigned;
+        ZFTestCaseAssert(m->iteratorIsEqual(it, assigned));
+        // from iterator with heap data and back
+        zfiterator other = zfiterator::iteratorCreate(_ZFP_ZFCore_zfiterator_test_Large(0));
+        other = it;
+        ZFTestCaseAssert(m->iteratorIsEqual(it, other));
+        ZFTestCaseAssert(this->remainCount(m, other) == 4);
+        assigned = zfiterator::iteratorCreate(_ZFP_ZFCore_zfiterator_test_Large(0));
+        assigned = it;
+        ZFTestCaseAssert(this->remainCount(m, assigned) == 4);
+        ZFTestCaseAssert(this->remainCount(m, it) == 4);
+
+        // iteratorForKey
+        zfiterator found = m->iteratorForKey(keys[3]);
+        zfiterator foundCopy = found;
+        ZFTestCaseAssert(m->iteratorIsValid(foundCopy));
+        ZFTestCaseAssert(ZFCastZFObject(v_zfint *, m->iteratorNextValue(foundCopy))->zfv == 30);
+        ZFTestCaseAssert(!m->iteratorIsEqual(found, foundCopy));
+        ZFTestCaseAssert(!m->iteratorIsValid(m->iteratorForKey(zflineAlloc(v_zfint, 100))));
+
+        // original still points to the found key
+        m->iteratorRemove(found);
+        ZFTestCaseAssert(m->count() == 4);
+        ZFTestCaseAssert(!m->isContain(keys[3]));
+
+        for(zfindex i = 0; i < 5; ++i)
+        {
+            zfRelease(keys[i]);
+        }
+    }
+    template<typename T_Map>
+    zfindex remainCount(ZF_IN T_Map *m,
+                        ZF_IN_OUT zfiterator &it)
+    {
+        zfindex ret = 0;
+        while(m->iteratorIsValid(it))
+        {
+            m->iteratorNextKey(it);
+            ++ret;
+        }
+        return ret;
+    }
+};
+ZFOBJECT_REGISTER(ZFCore_zfiterator_test)
+
+ZF_NAMESPACE_GLOBAL_END
+
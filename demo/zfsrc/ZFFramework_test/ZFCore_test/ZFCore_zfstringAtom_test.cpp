@@ -0,0 +1,128 @@
+#include "ZFCore_test.h"
+
+ZF_NAMESPACE_GLOBAL_BEGIN
+
+#define _ZFP_ZFCore_zfstringAtom_test_threadCount 4
+#define _ZFP_ZFCore_zfstringAtom_test_nameCount 200
+
+static zfstring _ZFP_ZFCore_zfstringAtom_test_name(ZF_IN zfindex index)
+{
+    return zfstringWithFormat("_ZFP_ZFCore_zfstringAtom_test_name_%zi", index);
+}
+static zfstringAtom _ZFP_ZFCore_zfstringAtom_test_result[_ZFP_ZFCore_zfstringAtom_test_threadCount][_ZFP_ZFCore_zfstringAtom_test_nameCount];
+static ZFLISTENER_PROTOTYPE_EXPAND(_ZFP_ZFCore_zfstringAtom_test_worker)
+{
+    zfindex threadIndex = (zfindex)userData->to<v_zfindex *>()->zfv;
+    for(zfindex i = 0; i < _ZFP_ZFCore_zfstringAtom_test_nameCount; ++i)
+    {
+        // each thread interns in different order
+        zfindex index = (threadIndex % 2 == 0) ? i : (_ZFP_ZFCore_zfstringAtom_test_nameCount - 1 - i);
+        _ZFP_ZFCore_zfstringAtom_test_result[threadIndex][index] =
+            zfstringAtomFor(_ZFP_ZFCore_zfstringAtom_test_name(index));
+    }
+}
+
+zfclass ZFCore_zfstringAtom_test : zfextends ZFFramework_test_TestCase
+{
+    ZFOBJECT_DECLARE(ZFCore_zfstringAtom_test, ZFFramework_test_TestCase)
+
+protected:
+    zfoverride
+    virtual void testCaseOnStart(void)
+    {
+        zfsuper::testCaseOnStart();
+
+        this->testCaseOutputSeparator();
+        this->testCaseOutput("intern and find");
+        {
+            ZFTestCaseAssert(zfstringAtomFor(zfnull).isNull());
+            ZFTestCaseAssert(zfstringAtomFind(zfnull).isNull());
+
+            zfindex countSaved = zfstringAtomCount();
+            ZFTestCaseAssert(zfstringAtomFind("_ZFP_ZFCore_zfstringAtom_test_find").isNull());
+            ZFTestCaseAssert(zfstringAtomCount() == countSaved);
+
+            zfstring src = "_ZFP_ZFCore_zfstringAtom_test_find";
+            zfstringAtom atom = zfstringAtomFor(src);
+            ZFTestCaseAssert(zfstringAtomCount() == countSaved + 1);
+            ZFTestCaseAssert(!atom.isNull());
+            ZFTestCaseAssert(atom.cString() != src.cString());
+            ZFTestCaseAssert(zfscmpTheSame(atom.cString(), src.cString()));
+            ZFTestCaseAssert(atom.length() == src.length());
+            ZFTestCaseAssert(atom.hash() == zfidentityCalcString(src.cString()));
+
+            // same content results the same atom, no matter where it comes from
+            ZFTestCaseAssert(zfstringAtomFor("_ZFP_ZFCore_zfstringAtom_test_find") == atom);
+            ZFTestCaseAssert(zfstringAtomFor("_ZFP_ZFCore_zfstringAtom_test_find_suffix", src.length()) == atom);
+            ZFTestCaseAssert(zfstringAtomFind(src) == atom);
+            ZFTestCaseAssert(zfstringAtomFor("_ZFP_ZFCore_zfstringAtom_test_find2") != atom);
+            ZFTestCaseAssert(zfstringAtomCount() == countSaved + 2);
+        }
+
+        this->testCaseOutputSeparator();
+        this->testCaseOutput("attribute names of ZFSerializableData are never interned");
+        {
+            zfindex countSaved = zfstringAtomCount();
+            ZFSerializableData data;
+            for(zfindex i = 0; i < 100; ++i)
+            {
+                zfstring name = zfstringWithFormat("_ZFP_ZFCore_zfstringAtom_test_attr_%zi", i);
+                data.attributeForName(name, zfsFromInt(i));
+            }
+            ZFTestCaseAssert(zfstringAtomCount() == countSaved);
+            ZFTestCaseAssert(data.attributeCount() == 100);
+            for(zfindex i = 0; i < 100; ++i)
+            {
+                zfstring name = zfstringWithFormat("_ZFP_ZFCore_zfstringAtom_test_attr_%zi", i);
+                ZFTestCaseAssert(zfscmpTheSame(data.attributeForName(name), zfsFromInt(i).cString()));
+            }
+
+            // interned after stored as owned string
+            zfstringAtomFor("_ZFP_ZFCore_zfstringAtom_test_attr_0");
+            ZFTestCaseAssert(zfscmpTheSame(data.attributeForName("_ZFP_ZFCore_zfstringAtom_test_attr_0"), "0"));
+            data.attributeForName("_ZFP_ZFCore_zfstringAtom_test_attr_0", "zero");
+            ZFTestCaseAssert(data.attributeCount() == 100);
+            ZFTestCaseAssert(zfscmpTheSame(data.attributeForName("_ZFP_ZFCore_zfstringAtom_test_attr_0"), "zero"));
+
+            // interned names and owned names work together
+            data.attributeForName("_ZFP_ZFCore_zfstringAtom_test_find", "atom");
+            ZFTestCaseAssert(data.attributeCount() == 101);
+            ZFTestCaseAssert(zfscmpTheSame(data.attributeForName("_ZFP_ZFCore_zfstringAtom_test_find"), "atom"));
+            data.attributeRemove("_ZFP_ZFCore_zfstringAtom_test_find");
+            data.attributeRemove("_ZFP_ZFCore_zfstringAtom_test_attr_1");
+            ZFTestCaseAssert(data.attributeCount() == 99);
+            ZFTestCaseAssert(data.attributeForName("_ZFP_ZFCore_zfstringAtom_test_attr_1") == zfnull);
+        }
+
+        if(ZFProtocolIsAvailable("ZFThread"))
+        {
+            this->testCaseOutputSeparator();
+            this->testCaseOutput("intern in %d threads", (zfint)_ZFP_ZFCore_zfstringAtom_test_threadCount);
+            zfidentity taskIdList[_ZFP_ZFCore_zfstringAtom_test_threadCount];
+            for(zfindex i = 0; i < _ZFP_ZFCore_zfstringAtom_test_threadCount; ++i)
+            {
+                zfblockedAlloc(v_zfindex, threadIndex, i);
+                taskIdList[i] = ZFThreadExecuteInNewThread(ZFCallbackForFunc(_ZFP_ZFCore_zfstringAtom_test_worker), threadIndex);
+            }
+            for(zfindex i = 0; i < _ZFP_ZFCore_zfstringAtom_test_threadCount; ++i)
+            {
+                ZFThreadExecuteWait(taskIdList[i]);
+            }
+            for(zfindex i = 0; i < _ZFP_ZFCore_zfstringAtom_test_nameCount; ++i)
+            {
+                zfstringAtom atom = zfstringAtomFind(_ZFP_ZFCore_zfstringAtom_test_name(i));
+                ZFTestCaseAssert(!atom.isNull());
+                for(zfindex t = 0; t < _ZFP_ZFCore_zfstringAtom_test_threadCount; ++t)
+                {
+                    ZFTestCaseAssert(_ZFP_ZFCore_zfstringAtom_test_result[t][i] == atom);
+                }
+            }
+        }
+
+        this->testCaseStop();
+    }
+};
+ZFOBJECT_REGISTER(ZFCore_zfstringAtom_test)
+
+ZF_NAMESPACE_GLOBAL_END
+
@@ -0,0 +1,154 @@
+#include "ZFCore_test.h"
+
+ZF_NAMESPACE_GLOBAL_BEGIN
+
+#define _ZFP_ZFCore_zfstringShared_test_threadCount 4
+#define _ZFP_ZFCore_zfstringShared_test_loopCount 10000
+
+static zfstringShared *_ZFP_ZFCore_zfstringShared_test_shared = zfnull;
+static zfatomicint _ZFP_ZFCore_zfstringShared_test_errorCount = 0;
+
+static ZFLISTENER_PROTOTYPE_EXPAND(_ZFP_ZFCore_zfstringShared_test_copy)
+{
+    zfstringShared assigned;
+    for(zfindex i = 0; i < _ZFP_ZFCore_zfstringShared_test_loopCount; ++i)
+    {
+        zfstringShared copied(*_ZFP_ZFCore_zfstringShared_test_shared);
+        assigned = copied;
+        if(assigned.cString() != _ZFP_ZFCore_zfstringShared_test_shared->cString())
+        {
+            zfAtomicIncrease(_ZFP_ZFCore_zfstringShared_test_errorCount);
+        }
+        assigned = zfstringShared();
+    }
+}
+
+zfclass ZFCore_zfstringShared_test : zfextends ZFFramework_test_TestCase
+{
+    ZFOBJECT_DECLARE(ZFCore_zfstringShared_test, ZFFramework_test_TestCase)
+
+protected:
+    zfoverride
+    virtual void testCaseOnStart(void)
+    {
+        zfsuper::testCaseOnStart();
+
+        this->testCaseOutputSeparator();
+        this->testCaseOutput("zfstringView");
+        {
+            const zfchar *buf = "abc=123";
+            zfstringView empty;
+            zfstringView nullView((const zfchar *)zfnull);
+            ZFTestCaseAssert(empty.isEmpty() && nullView.isEmpty());
+            ZFTestCaseAssert(empty == nullView);
+            ZFTestCaseAssert(empty == zfstringView(""));
+
+            zfstringView all(buf);
+            ZFTestCaseAssert(all.length() == 7 && all.data() == buf);
+
+            // part of a string, not null-terminated
+            zfstringView key(buf, 3);
+            zfstringView value = all.subView(all.find('=') + 1);
+            ZFTestCaseAssert(key.length() == 3 && key.data() == buf);
+            ZFTestCaseAssert(value.data() == buf + 4);
+            ZFTestCaseAssert(key == zfstringView("abc"));
+            ZFTestCaseAssert(value == zfstringView("123"));
+            ZFTestCaseAssert(key != zfstringView("ab"));
+            ZFTestCaseAssert(key != zfstringView("abcd"));
+            ZFTestCaseAssert(zfstringView("ab").compare(key) < 0);
+            ZFTestCaseAssert(zfstringView("abd").compare(key) > 0);
+            ZFTestCaseAssert(zfstringView("ab") < key);
+
+            ZFTestCaseAssert(all.subView(7).isEmpty());
+            ZFTestCaseAssert(all.subView(100).isEmpty());
+            ZFTestCaseAssert(all.subView(4, 100) == value);
+            ZFTestCaseAssert(all.find('=') == 3);
+            ZFTestCaseAssert(all.find('x') == zfindexMax());
+            ZFTestCaseAssert(all.find('a', 1) == zfindexMax());
+            ZFTestCaseAssert(all.beginWith(key) && all.endWith(value));
+            ZFTestCaseAssert(all.beginWith(zfstringView()) && all.endWith(zfstringView()));
+            ZFTestCaseAssert(!key.beginWith(all) && !key.endWith(all));
+
+            // zfstring from view copies only the viewed part
+            zfstring s(key);
+            ZFTestCaseAssert(zfscmpTheSame(s.cString(), "abc"));
+            s.append(zfstringView("-"));
+            s.append(value);
+            ZFTestCaseAssert(zfscmpTheSame(s.cString(), "abc-123"));
+            s.assign(value);
+            ZFTestCaseAssert(zfscmpTheSame(s.cString(), "123") && s.length() == 3);
+            zfstringView sView(s);
+            ZFTestCaseAssert(sView.data() == s.cString() && sView.length() == 3);
+        }
+
+        this->testCaseOutputSeparator();
+        this->testCaseOutput("zfstringShared");
+        {
+            zfstringShared empty;
+            ZFTestCaseAssert(empty.isEmpty() && empty.length() == 0 && empty.refCount() == 0);
+            ZFTestCaseAssert(empty.cString() != zfnull && empty.cString()[0] == '\0');
+            ZFTestCaseAssert(zfstringShared("").isEmpty());
+            ZFTestCaseAssert(zfstringShared((const zfchar *)zfnull).isEmpty());
+            ZFTestCaseAssert(empty == zfstringShared(""));
+
+            zfstring src = "value";
+            zfstringShared a(src);
+            ZFTestCaseAssert(a.cString() != src.cString());
+            src = "modified";
+            ZFTestCaseAssert(a == "value" && a.length() == 5 && a.refCount() == 1);
+
+            // copy and assign share the content
+            {
+                zfstringShared b(a);
+                ZFTestCaseAssert(b.cString() == a.cString() && a.refCount() == 2);
+                zfstringShared c;
+                c = b;
+                ZFTestCaseAssert(c.cString() == a.cString() && a.refCount() == 3);
+                c = c;
+                ZFTestCaseAssert(c.cString() == a.cString() && a.refCount() == 3);
+                c = "other";
+                ZFTestCaseAssert(c == "other" && a.refCount() == 2);
+            }
+            ZFTestCaseAssert(a.refCount() == 1);
+
+            // equal content, different storage
+            zfstringShared d(zfstringView("value=1", 5));
+            ZFTestCaseAssert(d.cString() != a.cString());
+            ZFTestCaseAssert(d == a && !(d != a));
+            ZFTestCaseAssert(d.compare(zfstringView("valuf")) < 0);
+            ZFTestCaseAssert(d.view() == zfstringView("value"));
+            ZFTestCaseAssert(zfstringShared("value", 3) == "val");
+
+            // usable as plain string
+            ZFTestCaseAssert(zfslen(a) == 5);
+            ZFTestCaseAssert(zfscmpTheSame(a, "value"));
+        }
+
+        this->testCaseOutputSeparator();
+        this->testCaseOutput("zfstringShared copied from multiple threads");
+        if(ZFProtocolIsAvailable("ZFThread"))
+        {
+            zfAtomicStore(_ZFP_ZFCore_zfstringShared_test_errorCount, 0);
+            _ZFP_ZFCore_zfstringShared_test_shared = zfnew(zfstringShared, "shared value");
+            zfidentity taskIds[_ZFP_ZFCore_zfstringShared_test_threadCount];
+            for(zfindex i = 0; i < _ZFP_ZFCore_zfstringShared_test_threadCount; ++i)
+            {
+                taskIds[i] = ZFThreadExecuteInNewThread(ZFCallbackForFunc(_ZFP_ZFCore_zfstringShared_test_copy));
+            }
+            for(zfindex i = 0; i < _ZFP_ZFCore_zfstringShared_test_threadCount; ++i)
+            {
+                ZFThreadExecuteWait(taskIds[i]);
+            }
+            ZFTestCaseAssert(_ZFP_ZFCore_zfstringShared_test_shared->refCount() == 1);
+            ZFTestCaseAssert(zfAtomicLoad(_ZFP_ZFCore_zfstringShared_test_errorCount) == 0);
+            zfdelete(_ZFP_ZFCore_zfstringShared_test_shared);
+            _ZFP_ZFCore_zfstringShared_test_shared = zfnull;
+        }
+
+        this->testCaseStop();
+    }
+};
+ZFOBJECT_REGISTER(ZFCore_zfstringShared_test)
+
+ZF_NAMESPACE_GLOBAL_END
+